@@ -29,12 +29,13 @@ EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezAnimationClipAssetProperties, 2, ezRTTIDefault
     EZ_MEMBER_PROPERTY("RootMotionVelocity", m_vCustomRootMotion),
     EZ_MEMBER_PROPERTY("Joint1", m_sJoint1),
     EZ_MEMBER_PROPERTY("Joint2", m_sJoint2),
+    EZ_MEMBER_PROPERTY("Compress", m_bCompress)->AddAttributes(new ezDefaultValueAttribute(true)),
   }
   EZ_END_PROPERTIES;
 }
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 
-EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezAnimationClipAssetDocument, 2, ezRTTINoAllocator);
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezAnimationClipAssetDocument, 3, ezRTTINoAllocator);
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
@@ -132,6 +133,11 @@ ezStatus ezAnimationClipAssetDocument::InternalTransformAsset(ezStreamWriter& st
     }
   }
 
+  if (pProp->m_bCompress)
+  {
+    anim.Compress(ezAnimationClipCompressionSettings());
+  }
+
   anim.Save(stream);
 
   return ezStatus(EZ_SUCCESS);
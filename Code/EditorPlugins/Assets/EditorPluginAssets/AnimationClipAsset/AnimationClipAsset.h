@@ -37,6 +37,7 @@ public:
   ezVec3 m_vCustomRootMotion;
   ezString m_sJoint1;
   ezString m_sJoint2;
+  bool m_bCompress = true;
 };
 
 //////////////////////////////////////////////////////////////////////////
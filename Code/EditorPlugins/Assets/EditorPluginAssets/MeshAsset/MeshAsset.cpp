@@ -11,7 +11,7 @@
 #include <RendererCore/Meshes/MeshResourceDescriptor.h>
 
 // clang-format off
-EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMeshAssetDocument, 9, ezRTTINoAllocator)
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMeshAssetDocument, 10, ezRTTINoAllocator)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
@@ -45,6 +45,14 @@ ezStatus ezMeshAssetDocument::InternalTransformAsset(ezStreamWriter& stream, con
   if (pProp->m_PrimitiveType == ezMeshPrimitive::File)
   {
     EZ_SUCCEED_OR_RETURN(CreateMeshFromFile(pProp, desc));
+
+    // the properties may have been reallocated while the material slots were updated
+    pProp = GetProperties();
+
+    if (pProp->m_uiLodCount > 0)
+    {
+      ezMeshImportUtils::GenerateLods(desc, pProp->m_uiLodCount, pProp->m_fLodTriangleRatio, pProp->m_fLodScreenSize);
+    }
   }
   else
   {
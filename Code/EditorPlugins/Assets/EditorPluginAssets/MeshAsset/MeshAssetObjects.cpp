@@ -31,6 +31,9 @@ EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMeshAssetProperties, 3, ezRTTIDefaultAllocator
     EZ_MEMBER_PROPERTY("ImportMaterials", m_bImportMaterials)->AddAttributes(new ezDefaultValueAttribute(true)),
     EZ_MEMBER_PROPERTY("UseSubfolderForMaterialImport", m_bUseSubFolderForImportedMaterials)->AddAttributes(new ezDefaultValueAttribute(true)),
     EZ_ARRAY_MEMBER_PROPERTY("Materials", m_Slots)->AddAttributes(new ezContainerAttribute(false, true, true)),
+    EZ_MEMBER_PROPERTY("LodCount", m_uiLodCount)->AddAttributes(new ezDefaultValueAttribute(0), new ezClampValueAttribute(0, 4)),
+    EZ_MEMBER_PROPERTY("LodTriangleRatio", m_fLodTriangleRatio)->AddAttributes(new ezDefaultValueAttribute(0.5f), new ezClampValueAttribute(0.05f, 0.95f)),
+    EZ_MEMBER_PROPERTY("LodScreenSize", m_fLodScreenSize)->AddAttributes(new ezDefaultValueAttribute(0.5f), new ezClampValueAttribute(0.01f, 1.0f)),
   }
   EZ_END_PROPERTIES;
 }
@@ -94,6 +97,9 @@ ezMeshAssetProperties::ezMeshAssetProperties()
   m_bCap2 = true;
   m_Angle = ezAngle::Degree(360.0f);
   m_bImportMaterials = true;
+  m_uiLodCount = 0;
+  m_fLodTriangleRatio = 0.5f;
+  m_fLodScreenSize = 0.5f;
 }
 
 
@@ -115,12 +121,18 @@ void ezMeshAssetProperties::PropertyMetaStateEventHandler(ezPropertyMetaStateEve
     props["Cap2"].m_Visibility = ezPropertyUiState::Invisible;
     props["Angle"].m_Visibility = ezPropertyUiState::Invisible;
     props["ImportMaterials"].m_Visibility = ezPropertyUiState::Invisible;
+    props["LodCount"].m_Visibility = ezPropertyUiState::Invisible;
+    props["LodTriangleRatio"].m_Visibility = ezPropertyUiState::Invisible;
+    props["LodScreenSize"].m_Visibility = ezPropertyUiState::Invisible;
 
     switch (primType)
     {
     case ezMeshPrimitive::File:
       props["MeshFile"].m_Visibility = ezPropertyUiState::Default;
       props["ImportMaterials"].m_Visibility = ezPropertyUiState::Default;
+      props["LodCount"].m_Visibility = ezPropertyUiState::Default;
+      props["LodTriangleRatio"].m_Visibility = ezPropertyUiState::Default;
+      props["LodScreenSize"].m_Visibility = ezPropertyUiState::Default;
       break;
 
     case ezMeshPrimitive::Box:
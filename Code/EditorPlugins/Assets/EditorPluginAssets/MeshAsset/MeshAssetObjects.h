@@ -65,6 +65,10 @@ public:
   bool m_bUseSubFolderForImportedMaterials;
   ezHybridArray<ezMaterialResourceSlot, 8> m_Slots;
 
+  ezUInt8 m_uiLodCount;
+  float m_fLodTriangleRatio;
+  float m_fLodScreenSize;
+
   ezUInt32 m_uiVertices;
   ezUInt32 m_uiTriangles;
 
@@ -10,6 +10,7 @@
 #include <Foundation/Utilities/Progress.h>
 #include <ModelImporter/Material.h>
 #include <ModelImporter/Mesh.h>
+#include <ModelImporter/MeshSimplifier.h>
 #include <ModelImporter/ModelImporter.h>
 #include <ModelImporter/Scene.h>
 #include <RendererCore/Meshes/MeshResourceDescriptor.h>
@@ -826,6 +827,115 @@ namespace ezMeshImportUtils
     return ezStatus(EZ_SUCCESS);
   }
 
+  void GenerateLods(ezMeshResourceDescriptor& meshDescriptor, ezUInt32 uiNumLods, float fTriangleRatio, float fLod1ScreenSize)
+  {
+    EZ_PROFILE_SCOPE("GenerateLods");
+
+    ezMeshBufferResourceDescriptor& mbd = meshDescriptor.MeshBufferDesc();
+    if (uiNumLods == 0 || !mbd.HasIndexBuffer() || mbd.GetTopology() != ezGALPrimitiveTopology::Triangles)
+      return;
+
+    ezDynamicArray<ezVec3> positions;
+    {
+      const ezVertexStreamInfo* pPositionStream = nullptr;
+      for (const ezVertexStreamInfo& si : mbd.GetVertexDeclaration().m_VertexStreams)
+      {
+        if (si.m_Semantic == ezGALVertexAttributeSemantic::Position && si.m_Format == ezGALResourceFormat::XYZFloat)
+          pPositionStream = &si;
+      }
+
+      if (pPositionStream == nullptr)
+        return;
+
+      positions.SetCountUninitialized(mbd.GetVertexCount());
+
+      const ezUInt8* pVertexData = mbd.GetVertexBufferData().GetData() + pPositionStream->m_uiOffset;
+      for (ezUInt32 v = 0; v < positions.GetCount(); ++v)
+      {
+        ezMemoryUtils::Copy(&positions[v], reinterpret_cast<const ezVec3*>(pVertexData + v * mbd.GetVertexDataSize()), 1);
+      }
+    }
+
+    // LOD 1 and following are appended to the existing index buffer, all LODs share the vertices of LOD 0
+    const bool b32BitIndices = mbd.Uses32BitIndices();
+    ezDynamicArray<ezUInt32> allIndices;
+    {
+      ezDynamicArray<ezUInt8>& indexData = mbd.GetIndexBufferData();
+      allIndices.SetCountUninitialized(indexData.GetCount() / (b32BitIndices ? sizeof(ezUInt32) : sizeof(ezUInt16)));
+
+      for (ezUInt32 i = 0; i < allIndices.GetCount(); ++i)
+      {
+        allIndices[i] = b32BitIndices ? reinterpret_cast<const ezUInt32*>(indexData.GetData())[i]
+                                      : reinterpret_cast<const ezUInt16*>(indexData.GetData())[i];
+      }
+    }
+
+    // copy the LOD 0 sub-meshes, adding new sub-meshes may reallocate the array
+    ezHybridArray<ezMeshResourceDescriptor::SubMesh, 8> lod0SubMeshes;
+    lod0SubMeshes = meshDescriptor.GetSubMeshes();
+
+    ezDynamicArray<ezDynamicArray<ezUInt32>> previousLodIndices;
+    previousLodIndices.SetCount(lod0SubMeshes.GetCount());
+    for (ezUInt32 s = 0; s < lod0SubMeshes.GetCount(); ++s)
+    {
+      const ezMeshResourceDescriptor::SubMesh& subMesh = lod0SubMeshes[s];
+      previousLodIndices[s] = allIndices.GetArrayPtr().GetSubArray(subMesh.m_uiFirstPrimitive * 3, subMesh.m_uiPrimitiveCount * 3);
+    }
+
+    ezDynamicArray<ezDynamicArray<ezUInt32>> lodIndices;
+    lodIndices.SetCount(lod0SubMeshes.GetCount());
+
+    float fScreenSize = fLod1ScreenSize;
+    for (ezUInt32 uiLod = 1; uiLod <= uiNumLods; ++uiLod)
+    {
+      ezUInt32 uiPreviousTriangleCount = 0;
+      ezUInt32 uiTriangleCount = 0;
+
+      for (ezUInt32 s = 0; s < lod0SubMeshes.GetCount(); ++s)
+      {
+        const ezUInt32 uiPreviousCount = previousLodIndices[s].GetCount() / 3;
+        const ezUInt32 uiTargetCount = static_cast<ezUInt32>(uiPreviousCount * fTriangleRatio);
+
+        ezModelImporter::MeshSimplifier::Simplify(
+          positions, previousLodIndices[s], uiTargetCount, ezMath::MaxValue<float>(), lodIndices[s]);
+
+        uiPreviousTriangleCount += uiPreviousCount;
+        uiTriangleCount += lodIndices[s].GetCount() / 3;
+      }
+
+      if (uiTriangleCount >= uiPreviousTriangleCount)
+      {
+        ezLog::Warning("Mesh can't be simplified any further, only {0} LODs are generated", uiLod);
+        break;
+      }
+
+      meshDescriptor.AddLod(fScreenSize);
+
+      for (ezUInt32 s = 0; s < lod0SubMeshes.GetCount(); ++s)
+      {
+        meshDescriptor.AddSubMesh(lodIndices[s].GetCount() / 3, allIndices.GetCount() / 3, lod0SubMeshes[s].m_uiMaterialIndex);
+        allIndices.PushBackRange(lodIndices[s]);
+
+        previousLodIndices[s].Swap(lodIndices[s]);
+      }
+
+      ezLog::Info("Number of Triangles in LOD {0}: {1}", uiLod, uiTriangleCount);
+
+      fScreenSize *= 0.5f;
+    }
+
+    ezDynamicArray<ezUInt8>& indexData = mbd.GetIndexBufferData();
+    indexData.SetCountUninitialized(allIndices.GetCount() * (b32BitIndices ? sizeof(ezUInt32) : sizeof(ezUInt16)));
+
+    for (ezUInt32 i = 0; i < allIndices.GetCount(); ++i)
+    {
+      if (b32BitIndices)
+        reinterpret_cast<ezUInt32*>(indexData.GetData())[i] = allIndices[i];
+      else
+        reinterpret_cast<ezUInt16*>(indexData.GetData())[i] = static_cast<ezUInt16>(allIndices[i]);
+    }
+  }
+
   ezStatus TryImportMesh(ezSharedPtr<ezModelImporter::Scene>& out_pScene, ezModelImporter::Mesh*& out_pMesh, const char* szMeshFile,
     const char* szSubMeshName, const ezMat3& mMeshTransform, bool bRecalculateNormals, bool bInvertNormals, ezProgressRange& range,
     ezMeshResourceDescriptor& meshDescriptor, bool bSkinnedMesh)
@@ -44,6 +44,13 @@ namespace ezMeshImportUtils
   EZ_EDITORPLUGINASSETS_DLL ezStatus GenerateMeshBuffer(const ezModelImporter::Mesh& mesh, ezMeshResourceDescriptor& meshDescriptor,
                                                         const ezMat3& mTransformation, bool bInvertNormals, bool bSkinnedMesh);
 
+  /// \brief Appends uiNumLods simplified LODs of all sub-meshes to the mesh buffer of the descriptor.
+  ///
+  /// Each LOD keeps fTriangleRatio of the triangles of the previous one and shares the vertex buffer with LOD 0.
+  /// LOD 1 is used below fLod1ScreenSize, every further LOD at half the screen size of the previous one.
+  EZ_EDITORPLUGINASSETS_DLL void GenerateLods(ezMeshResourceDescriptor& meshDescriptor, ezUInt32 uiNumLods, float fTriangleRatio,
+                                              float fLod1ScreenSize);
+
   EZ_EDITORPLUGINASSETS_DLL ezStatus TryImportMesh(ezSharedPtr<ezModelImporter::Scene>& out_pScene, ezModelImporter::Mesh*& out_pMesh,
                                                    const char* szMeshFile, const char* szSubMeshName, const ezMat3& mMeshTransform,
                                                    bool bRecalculateNormals, bool bInvertNormals, ezProgressRange& range,
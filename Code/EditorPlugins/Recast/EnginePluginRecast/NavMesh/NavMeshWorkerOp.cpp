@@ -4,6 +4,7 @@
 
 #include <Core/Assets/AssetFileHeader.h>
 #include <EditorEngineProcessFramework/EngineProcess/EngineProcessDocumentContext.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/FileSystem/FileWriter.h>
 #include <Foundation/Utilities/Progress.h>
 #include <ToolsFoundation/Document/DocumentManager.h>
@@ -44,7 +45,27 @@ ezResult ezLongOpWorker_BuildNavMesh::Execute(ezProgress& progress, ezStreamWrit
   if (!pgRange.BeginNextStep("Building NavMesh"))
     return EZ_FAILURE;
 
-  EZ_SUCCEED_OR_RETURN(NavMeshBuilder.Build(m_NavMeshConfig, m_ExtractedWorldGeometry, desc, progress));
+  if (m_NavMeshConfig.m_fTileSize > 0.0f)
+  {
+    // start from the previous result, so that only the tiles whose geometry changed need to be rebuilt
+    ezFileReader prevFile;
+    if (prevFile.Open(m_sOutputPath).Succeeded())
+    {
+      ezAssetFileHeader header;
+      header.Read(prevFile);
+
+      if (desc.Deserialize(prevFile).Failed())
+      {
+        desc.Clear();
+      }
+    }
+
+    EZ_SUCCEED_OR_RETURN(NavMeshBuilder.BuildTiled(m_NavMeshConfig, m_ExtractedWorldGeometry, desc, progress));
+  }
+  else
+  {
+    EZ_SUCCEED_OR_RETURN(NavMeshBuilder.Build(m_NavMeshConfig, m_ExtractedWorldGeometry, desc, progress));
+  }
 
   if (!pgRange.BeginNextStep("Writing Result"))
     return EZ_FAILURE;
@@ -36,6 +36,7 @@ EZ_STATICLINK_LIBRARY(Core)
   EZ_STATICLINK_REFERENCE(Core_WorldSerializer_Implementation_ResourceHandleReader);
   EZ_STATICLINK_REFERENCE(Core_WorldSerializer_Implementation_ResourceHandleWriter);
   EZ_STATICLINK_REFERENCE(Core_WorldSerializer_Implementation_WorldReader);
+  EZ_STATICLINK_REFERENCE(Core_WorldSerializer_Implementation_WorldSnapshot);
   EZ_STATICLINK_REFERENCE(Core_WorldSerializer_Implementation_WorldWriter);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_ComponentManager);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_Declarations);
@@ -44,8 +45,10 @@ EZ_STATICLINK_LIBRARY(Core)
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_SettingsComponent);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_SpatialSystem);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_SpatialSystem_RegularGrid);
+  EZ_STATICLINK_REFERENCE(Core_World_Implementation_TransformHierarchySoA);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_World);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_WorldData);
+  EZ_STATICLINK_REFERENCE(Core_World_Implementation_WorldGroup);
   EZ_STATICLINK_REFERENCE(Core_World_Implementation_WorldModule);
 }
 
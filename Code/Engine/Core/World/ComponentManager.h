@@ -64,6 +64,7 @@ private:
   // internal methods
   friend class ezWorld;
   friend class ezInternal::WorldData;
+  friend class ezWorldSnapshot;
 
   void DeinitializeInternal() override;
 
@@ -75,6 +76,12 @@ protected:
   virtual ezComponent* CreateComponentStorage() = 0;
   virtual void DeleteComponentStorage(ezComponent* pComponent, ezComponent*& out_pMovedComponent) = 0;
 
+  virtual void CopyRawComponentData(ezDynamicArrayBase<ezUInt8>& out_Data) const = 0;
+  virtual void RestoreRawComponentStorage(ezArrayPtr<const ezUInt8> data) = 0;
+
+  // Restores data from CopyRawComponentData() but keeps the ezComponent part of the given components (in storage order) as it is.
+  void RestoreRawComponentData(ezArrayPtr<const ezUInt8> data, ezArrayPtr<ezComponent* const> components);
+
   /// \endcond
 
   ezIdTable<ezGenericComponentId, ezComponent*> m_Components;
@@ -115,6 +122,9 @@ protected:
   virtual ezComponent* CreateComponentStorage() override;
   virtual void DeleteComponentStorage(ezComponent* pComponent, ezComponent*& out_pMovedComponent) override;
 
+  virtual void CopyRawComponentData(ezDynamicArrayBase<ezUInt8>& out_Data) const override;
+  virtual void RestoreRawComponentStorage(ezArrayPtr<const ezUInt8> data) override;
+
   void RegisterUpdateFunction(UpdateFunctionDesc& desc);
 
   ezBlockStorage<ComponentType, ezInternal::DEFAULT_BLOCK_SIZE, StorageType> m_ComponentStorage;
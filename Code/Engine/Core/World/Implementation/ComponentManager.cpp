@@ -88,5 +88,52 @@ void ezComponentManagerBase::PatchIdTable(ezComponent* pComponent)
     m_Components[id] = pComponent;
 }
 
+void ezComponentManagerBase::RestoreRawComponentData(ezArrayPtr<const ezUInt8> data, ezArrayPtr<ezComponent* const> components)
+{
+  // The base part must not be restored. The owner objects may have moved in memory since the data was copied and
+  // changing the active or initialized state would skip the corresponding callbacks.
+  struct BaseState
+  {
+    ezBitflags<ezObjectFlags> m_ComponentFlags;
+    ezGenericComponentId m_InternalId;
+    ezUInt32 m_uiUniqueID;
+    ezComponentManagerBase* m_pManager;
+    ezGameObject* m_pOwner;
+    const ezRTTI* m_pMessageDispatchType;
+  };
+
+  EZ_CHECK_AT_COMPILETIME_MSG(sizeof(ezComponent) == sizeof(ezReflectedClass) + sizeof(BaseState),
+    "ezComponent has changed, all of its members must be preserved in BaseState");
+
+  ezDynamicArray<BaseState> baseStates;
+  baseStates.SetCount(components.GetCount());
+
+  for (ezUInt32 i = 0; i < components.GetCount(); ++i)
+  {
+    const ezComponent* pComponent = components[i];
+    BaseState& state = baseStates[i];
+    state.m_ComponentFlags = pComponent->m_ComponentFlags;
+    state.m_InternalId = pComponent->m_InternalId;
+    state.m_uiUniqueID = pComponent->m_uiUniqueID;
+    state.m_pManager = pComponent->m_pManager;
+    state.m_pOwner = pComponent->m_pOwner;
+    state.m_pMessageDispatchType = pComponent->m_pMessageDispatchType;
+  }
+
+  RestoreRawComponentStorage(data);
+
+  for (ezUInt32 i = 0; i < components.GetCount(); ++i)
+  {
+    ezComponent* pComponent = components[i];
+    const BaseState& state = baseStates[i];
+    pComponent->m_ComponentFlags = state.m_ComponentFlags;
+    pComponent->m_InternalId = state.m_InternalId;
+    pComponent->m_uiUniqueID = state.m_uiUniqueID;
+    pComponent->m_pManager = state.m_pManager;
+    pComponent->m_pOwner = state.m_pOwner;
+    pComponent->m_pMessageDispatchType = state.m_pMessageDispatchType;
+  }
+}
+
 EZ_STATICLINK_FILE(Core, Core_World_Implementation_ComponentManager);
 
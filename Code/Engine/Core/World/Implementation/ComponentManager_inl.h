@@ -155,6 +155,18 @@ EZ_FORCE_INLINE void ezComponentManager<T, StorageType>::DeleteComponentStorage(
   out_pMovedComponent = pMovedComponent;
 }
 
+template <typename T, ezBlockStorageType::Enum StorageType>
+void ezComponentManager<T, StorageType>::CopyRawComponentData(ezDynamicArrayBase<ezUInt8>& out_Data) const
+{
+  m_ComponentStorage.CopyRawData(out_Data);
+}
+
+template <typename T, ezBlockStorageType::Enum StorageType>
+void ezComponentManager<T, StorageType>::RestoreRawComponentStorage(ezArrayPtr<const ezUInt8> data)
+{
+  m_ComponentStorage.RestoreRawData(data);
+}
+
 template <typename T, ezBlockStorageType::Enum StorageType>
 EZ_FORCE_INLINE void ezComponentManager<T, StorageType>::RegisterUpdateFunction(UpdateFunctionDesc& desc)
 {
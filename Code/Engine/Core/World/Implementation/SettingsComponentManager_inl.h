@@ -94,3 +94,25 @@ void ezSettingsComponentManager<ComponentType>::DeleteComponentStorage(ezCompone
     }
   }
 }
+
+template <typename ComponentType>
+void ezSettingsComponentManager<ComponentType>::CopyRawComponentData(ezDynamicArrayBase<ezUInt8>& out_Data) const
+{
+  for (auto& pComponent : m_Components)
+  {
+    const ezUInt32 uiOffset = out_Data.GetCount();
+    out_Data.SetCountUninitialized(uiOffset + sizeof(ComponentType));
+    ezMemoryUtils::RawByteCopy(out_Data.GetData() + uiOffset, pComponent.Borrow(), sizeof(ComponentType));
+  }
+}
+
+template <typename ComponentType>
+void ezSettingsComponentManager<ComponentType>::RestoreRawComponentStorage(ezArrayPtr<const ezUInt8> data)
+{
+  EZ_ASSERT_DEV(data.GetCount() == m_Components.GetCount() * sizeof(ComponentType), "Raw component data does not match the current components");
+
+  for (ezUInt32 i = 0; i < m_Components.GetCount(); ++i)
+  {
+    ezMemoryUtils::RawByteCopy(m_Components[i].Borrow(), data.GetPtr() + i * sizeof(ComponentType), sizeof(ComponentType));
+  }
+}
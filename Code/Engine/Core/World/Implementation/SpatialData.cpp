@@ -49,3 +49,4 @@ ezSpatialData::Category ezSpatialData::FindCategory(const char* szCategoryName)
 
 ezSpatialData::Category ezDefaultSpatialDataCategories::RenderStatic = ezSpatialData::RegisterCategory("RenderStatic");
 ezSpatialData::Category ezDefaultSpatialDataCategories::RenderDynamic = ezSpatialData::RegisterCategory("RenderDynamic");
+ezSpatialData::Category ezDefaultSpatialDataCategories::Occluder = ezSpatialData::RegisterCategory("Occluder");
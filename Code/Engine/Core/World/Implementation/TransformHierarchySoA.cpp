@@ -0,0 +1,289 @@
+#include <CorePCH.h>
+
+#include <Core/World/TransformHierarchySoA.h>
+
+namespace
+{
+  EZ_ALWAYS_INLINE float& GetLane(ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper>& packets, ezUInt32 uiIndex)
+  {
+    return reinterpret_cast<float*>(packets.GetData())[uiIndex];
+  }
+
+  EZ_ALWAYS_INLINE float GetLane(const ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper>& packets, ezUInt32 uiIndex)
+  {
+    return reinterpret_cast<const float*>(packets.GetData())[uiIndex];
+  }
+
+  EZ_ALWAYS_INLINE ezSimdVec4f Gather(const float* pValues, const ezUInt32* pIndices)
+  {
+    ezSimdVec4f v;
+    v.Set(pValues[pIndices[0]], pValues[pIndices[1]], pValues[pIndices[2]], pValues[pIndices[3]]);
+    return v;
+  }
+
+  EZ_ALWAYS_INLINE ezSimdVec4f Gather(const ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper>& packets, const ezUInt32* pIndices)
+  {
+    return Gather(reinterpret_cast<const float*>(packets.GetData()), pIndices);
+  }
+
+  /// \brief Cross product of four vectors at once, each component of the vectors is passed in its own register.
+  EZ_ALWAYS_INLINE void Cross4(const ezSimdVec4f& ax, const ezSimdVec4f& ay, const ezSimdVec4f& az, const ezSimdVec4f& bx,
+    const ezSimdVec4f& by, const ezSimdVec4f& bz, ezSimdVec4f& out_x, ezSimdVec4f& out_y, ezSimdVec4f& out_z)
+  {
+    out_x = ezSimdVec4f::MulSub(ay, bz, az.CompMul(by));
+    out_y = ezSimdVec4f::MulSub(az, bx, ax.CompMul(bz));
+    out_z = ezSimdVec4f::MulSub(ax, by, ay.CompMul(bx));
+  }
+} // namespace
+
+void ezTransformHierarchySoA::TransformStreams::SetPacketCount(ezUInt32 uiCount)
+{
+  // new packets hold the identity transform, so the unused lanes of the last packet never feed garbage (NaNs, denormals) into the kernel
+  const ezSimdVec4f vZero = ezSimdVec4f::ZeroVector();
+  const ezSimdVec4f vOne(1.0f);
+
+  m_PosX.SetCount(uiCount, vZero);
+  m_PosY.SetCount(uiCount, vZero);
+  m_PosZ.SetCount(uiCount, vZero);
+  m_RotX.SetCount(uiCount, vZero);
+  m_RotY.SetCount(uiCount, vZero);
+  m_RotZ.SetCount(uiCount, vZero);
+  m_RotW.SetCount(uiCount, vOne);
+  m_ScaleX.SetCount(uiCount, vOne);
+  m_ScaleY.SetCount(uiCount, vOne);
+  m_ScaleZ.SetCount(uiCount, vOne);
+}
+
+void ezTransformHierarchySoA::TransformStreams::Set(ezUInt32 uiIndex, const ezSimdTransform& transform)
+{
+  float values[4];
+
+  transform.m_Position.Store<3>(values);
+  GetLane(m_PosX, uiIndex) = values[0];
+  GetLane(m_PosY, uiIndex) = values[1];
+  GetLane(m_PosZ, uiIndex) = values[2];
+
+  transform.m_Rotation.m_v.Store<4>(values);
+  GetLane(m_RotX, uiIndex) = values[0];
+  GetLane(m_RotY, uiIndex) = values[1];
+  GetLane(m_RotZ, uiIndex) = values[2];
+  GetLane(m_RotW, uiIndex) = values[3];
+
+  transform.m_Scale.Store<3>(values);
+  GetLane(m_ScaleX, uiIndex) = values[0];
+  GetLane(m_ScaleY, uiIndex) = values[1];
+  GetLane(m_ScaleZ, uiIndex) = values[2];
+}
+
+ezSimdTransform ezTransformHierarchySoA::TransformStreams::Get(ezUInt32 uiIndex) const
+{
+  ezSimdTransform t;
+  t.m_Position.Set(GetLane(m_PosX, uiIndex), GetLane(m_PosY, uiIndex), GetLane(m_PosZ, uiIndex), 0.0f);
+  t.m_Rotation.m_v.Set(GetLane(m_RotX, uiIndex), GetLane(m_RotY, uiIndex), GetLane(m_RotZ, uiIndex), GetLane(m_RotW, uiIndex));
+  t.m_Scale.Set(GetLane(m_ScaleX, uiIndex), GetLane(m_ScaleY, uiIndex), GetLane(m_ScaleZ, uiIndex), 1.0f);
+  return t;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezTransformHierarchySoA::ezTransformHierarchySoA() = default;
+ezTransformHierarchySoA::~ezTransformHierarchySoA() = default;
+
+void ezTransformHierarchySoA::Clear()
+{
+  m_HierarchyLevels.Clear();
+}
+
+ezUInt32 ezTransformHierarchySoA::AddObject(ezUInt32 uiHierarchyLevel, ezUInt32 uiParentIndex, const ezSimdVec4f& vLocalPosition,
+  const ezSimdQuat& qLocalRotation, const ezSimdVec4f& vLocalScaling)
+{
+  EZ_ASSERT_DEV(uiHierarchyLevel <= m_HierarchyLevels.GetCount(), "Hierarchy level {0} can't be added before level {1}", uiHierarchyLevel,
+    m_HierarchyLevels.GetCount());
+  EZ_ASSERT_DEV(uiHierarchyLevel == 0 || uiParentIndex < m_HierarchyLevels[uiHierarchyLevel - 1].m_uiCount, "Invalid parent index {0}",
+    uiParentIndex);
+
+  if (uiHierarchyLevel == m_HierarchyLevels.GetCount())
+  {
+    m_HierarchyLevels.ExpandAndGetRef();
+  }
+
+  HierarchyLevel& level = m_HierarchyLevels[uiHierarchyLevel];
+  const ezUInt32 uiIndex = level.m_uiCount++;
+
+  // always keep whole packets, unused lanes point to the first parent so that the kernel can process them like any other object
+  const ezUInt32 uiPacketCount = (level.m_uiCount + 3) / 4;
+  if (uiPacketCount > level.m_Local.m_PosX.GetCount())
+  {
+    level.m_Local.SetPacketCount(uiPacketCount);
+    level.m_Global.SetPacketCount(uiPacketCount);
+    level.m_ParentIndices.SetCount(uiPacketCount * 4);
+  }
+
+  level.m_ParentIndices[uiIndex] = uiHierarchyLevel > 0 ? uiParentIndex : 0;
+
+  SetLocalTransform(uiHierarchyLevel, uiIndex, vLocalPosition, qLocalRotation, vLocalScaling);
+  level.m_Global.Set(uiIndex, level.m_Local.Get(uiIndex));
+
+  return uiIndex;
+}
+
+void ezTransformHierarchySoA::SetLocalTransform(ezUInt32 uiHierarchyLevel, ezUInt32 uiIndex, const ezSimdVec4f& vLocalPosition,
+  const ezSimdQuat& qLocalRotation, const ezSimdVec4f& vLocalScaling)
+{
+  HierarchyLevel& level = m_HierarchyLevels[uiHierarchyLevel];
+  EZ_ASSERT_DEV(uiIndex < level.m_uiCount, "Out of bounds access");
+
+  // the uniform scale is folded into the scale streams, the kernel doesn't need to know about it
+  level.m_Local.Set(uiIndex, ezSimdTransform(vLocalPosition, qLocalRotation, vLocalScaling * vLocalScaling.w()));
+}
+
+ezSimdTransform ezTransformHierarchySoA::GetLocalTransform(ezUInt32 uiHierarchyLevel, ezUInt32 uiIndex) const
+{
+  const HierarchyLevel& level = m_HierarchyLevels[uiHierarchyLevel];
+  EZ_ASSERT_DEV(uiIndex < level.m_uiCount, "Out of bounds access");
+
+  return level.m_Local.Get(uiIndex);
+}
+
+ezSimdTransform ezTransformHierarchySoA::GetGlobalTransform(ezUInt32 uiHierarchyLevel, ezUInt32 uiIndex) const
+{
+  const HierarchyLevel& level = m_HierarchyLevels[uiHierarchyLevel];
+  EZ_ASSERT_DEV(uiIndex < level.m_uiCount, "Out of bounds access");
+
+  return level.m_Global.Get(uiIndex);
+}
+
+ezUInt32 ezTransformHierarchySoA::GetObjectCount() const
+{
+  ezUInt32 uiCount = 0;
+  for (const HierarchyLevel& level : m_HierarchyLevels)
+  {
+    uiCount += level.m_uiCount;
+  }
+  return uiCount;
+}
+
+void ezTransformHierarchySoA::UpdateGlobalTransforms()
+{
+  if (m_HierarchyLevels.IsEmpty())
+    return;
+
+  CopyLocalToGlobal(m_HierarchyLevels[0]);
+
+  for (ezUInt32 i = 1; i < m_HierarchyLevels.GetCount(); ++i)
+  {
+    UpdateLevelWithParent(m_HierarchyLevels[i], m_HierarchyLevels[i - 1]);
+  }
+}
+
+void ezTransformHierarchySoA::UpdateGlobalTransformsScalar()
+{
+  for (ezUInt32 uiLevel = 0; uiLevel < m_HierarchyLevels.GetCount(); ++uiLevel)
+  {
+    HierarchyLevel& level = m_HierarchyLevels[uiLevel];
+
+    for (ezUInt32 i = 0; i < level.m_uiCount; ++i)
+    {
+      const ezSimdTransform localTransform = level.m_Local.Get(i);
+
+      if (uiLevel == 0)
+      {
+        level.m_Global.Set(i, localTransform);
+      }
+      else
+      {
+        ezSimdTransform globalTransform;
+        globalTransform.SetGlobalTransform(m_HierarchyLevels[uiLevel - 1].m_Global.Get(level.m_ParentIndices[i]), localTransform);
+        level.m_Global.Set(i, globalTransform);
+      }
+    }
+  }
+}
+
+// static
+void ezTransformHierarchySoA::CopyLocalToGlobal(HierarchyLevel& level)
+{
+  level.m_Global.m_PosX = level.m_Local.m_PosX;
+  level.m_Global.m_PosY = level.m_Local.m_PosY;
+  level.m_Global.m_PosZ = level.m_Local.m_PosZ;
+  level.m_Global.m_RotX = level.m_Local.m_RotX;
+  level.m_Global.m_RotY = level.m_Local.m_RotY;
+  level.m_Global.m_RotZ = level.m_Local.m_RotZ;
+  level.m_Global.m_RotW = level.m_Local.m_RotW;
+  level.m_Global.m_ScaleX = level.m_Local.m_ScaleX;
+  level.m_Global.m_ScaleY = level.m_Local.m_ScaleY;
+  level.m_Global.m_ScaleZ = level.m_Local.m_ScaleZ;
+}
+
+// static
+void ezTransformHierarchySoA::UpdateLevelWithParent(HierarchyLevel& level, const HierarchyLevel& parentLevel)
+{
+  const TransformStreams& local = level.m_Local;
+  TransformStreams& global = level.m_Global;
+  const TransformStreams& parent = parentLevel.m_Global;
+
+  const ezSimdVec4f two(2.0f);
+  const ezUInt32 uiPacketCount = local.m_PosX.GetCount();
+
+  for (ezUInt32 p = 0; p < uiPacketCount; ++p)
+  {
+    const ezUInt32* pParentIndices = level.m_ParentIndices.GetData() + p * 4;
+
+    // parents are not sorted, so their transforms have to be gathered lane by lane
+    const ezSimdVec4f ppx = Gather(parent.m_PosX, pParentIndices);
+    const ezSimdVec4f ppy = Gather(parent.m_PosY, pParentIndices);
+    const ezSimdVec4f ppz = Gather(parent.m_PosZ, pParentIndices);
+    const ezSimdVec4f prx = Gather(parent.m_RotX, pParentIndices);
+    const ezSimdVec4f pry = Gather(parent.m_RotY, pParentIndices);
+    const ezSimdVec4f prz = Gather(parent.m_RotZ, pParentIndices);
+    const ezSimdVec4f prw = Gather(parent.m_RotW, pParentIndices);
+    const ezSimdVec4f psx = Gather(parent.m_ScaleX, pParentIndices);
+    const ezSimdVec4f psy = Gather(parent.m_ScaleY, pParentIndices);
+    const ezSimdVec4f psz = Gather(parent.m_ScaleZ, pParentIndices);
+
+    const ezSimdVec4f lrx = local.m_RotX[p];
+    const ezSimdVec4f lry = local.m_RotY[p];
+    const ezSimdVec4f lrz = local.m_RotZ[p];
+    const ezSimdVec4f lrw = local.m_RotW[p];
+
+    // position = parentRotation * (localPosition * parentScale) + parentPosition
+    {
+      const ezSimdVec4f vx = local.m_PosX[p].CompMul(psx);
+      const ezSimdVec4f vy = local.m_PosY[p].CompMul(psy);
+      const ezSimdVec4f vz = local.m_PosZ[p].CompMul(psz);
+
+      ezSimdVec4f tx, ty, tz;
+      Cross4(prx, pry, prz, vx, vy, vz, tx, ty, tz);
+      tx = tx.CompMul(two);
+      ty = ty.CompMul(two);
+      tz = tz.CompMul(two);
+
+      ezSimdVec4f cx, cy, cz;
+      Cross4(prx, pry, prz, tx, ty, tz, cx, cy, cz);
+
+      global.m_PosX[p] = ezSimdVec4f::MulAdd(tx, prw, vx + cx) + ppx;
+      global.m_PosY[p] = ezSimdVec4f::MulAdd(ty, prw, vy + cy) + ppy;
+      global.m_PosZ[p] = ezSimdVec4f::MulAdd(tz, prw, vz + cz) + ppz;
+    }
+
+    // rotation = parentRotation * localRotation
+    {
+      ezSimdVec4f cx, cy, cz;
+      Cross4(prx, pry, prz, lrx, lry, lrz, cx, cy, cz);
+
+      global.m_RotX[p] = ezSimdVec4f::MulAdd(lrx, prw, ezSimdVec4f::MulAdd(prx, lrw, cx));
+      global.m_RotY[p] = ezSimdVec4f::MulAdd(lry, prw, ezSimdVec4f::MulAdd(pry, lrw, cy));
+      global.m_RotZ[p] = ezSimdVec4f::MulAdd(lrz, prw, ezSimdVec4f::MulAdd(prz, lrw, cz));
+
+      const ezSimdVec4f dot = ezSimdVec4f::MulAdd(prx, lrx, ezSimdVec4f::MulAdd(pry, lry, prz.CompMul(lrz)));
+      global.m_RotW[p] = ezSimdVec4f::MulSub(prw, lrw, dot);
+    }
+
+    // scale = parentScale * localScale
+    global.m_ScaleX[p] = psx.CompMul(local.m_ScaleX[p]);
+    global.m_ScaleY[p] = psy.CompMul(local.m_ScaleY[p]);
+    global.m_ScaleZ[p] = psz.CompMul(local.m_ScaleZ[p]);
+  }
+}
+
+EZ_STATICLINK_FILE(Core, Core_World_Implementation_TransformHierarchySoA);
@@ -7,10 +7,14 @@
 #include <Core/World/WorldModule.h>
 #include <Foundation/Memory/FrameAllocator.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/Lock.h>
 #include <Foundation/Utilities/Stats.h>
 
 ezStaticArray<ezWorld*, 64> ezWorld::s_Worlds;
 
+// worlds may be created and destroyed on different threads, e.g. when independent worlds are updated through an ezWorldGroup
+static ezMutex s_WorldsMutex;
+
 const ezUInt16 c_InvalidWorldIndex = 0xFFFFu;
 
 static ezGameObjectHandle DefaultGameObjectReferenceResolver(const void* pData, ezComponentHandle hThis, const char* szProperty)
@@ -48,6 +52,8 @@ ezWorld::ezWorld(ezWorldDesc& desc)
 
   m_uiIndex = c_InvalidWorldIndex;
 
+  EZ_LOCK(s_WorldsMutex);
+
   // find a free world slot
   for (ezUInt16 i = 0; i < static_cast<ezUInt16>(s_Worlds.GetCount()); i++)
   {
@@ -99,6 +105,7 @@ ezWorld::~ezWorld()
   }
   m_Data.m_Modules.Clear();
 
+  EZ_LOCK(s_WorldsMutex);
   s_Worlds[m_uiIndex] = nullptr;
   m_uiIndex = c_InvalidWorldIndex;
 }
@@ -141,15 +148,103 @@ ezGameObjectHandle ezWorld::CreateObject(const ezGameObjectDesc& desc, ezGameObj
   CheckForWriteAccess();
 
   ezGameObject* pParentObject = nullptr;
+  TryGetObject(desc.m_hParent, pParentObject);
+
+  out_pObject = CreateObjectInternal(desc, pParentObject);
+  return out_pObject->GetHandle();
+}
+
+void ezWorld::CreateObjects(ezArrayPtr<const ezGameObjectDesc> descs, ezArrayPtr<const ezUInt32> parentIndices, ezArrayPtr<ezGameObject*> out_objects)
+{
+  CheckForWriteAccess();
+  EZ_ASSERT_DEV(parentIndices.IsEmpty() || parentIndices.GetCount() == descs.GetCount(), "Either no or one parent index per object must be given");
+  EZ_ASSERT_DEV(out_objects.GetCount() == descs.GetCount(), "The output array must have the same size as the object descriptions");
+
+  const ezUInt32 uiNumObjects = descs.GetCount();
+  if (uiNumObjects == 0)
+    return;
+
+  EZ_PROFILE_SCOPE("CreateObjects");
+
+  struct ObjectInfo
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezGameObject* m_pParentObject;
+    ezUInt16 m_uiHierarchyLevel;
+    bool m_bDynamic;
+  };
+
+  ezDynamicArray<ObjectInfo> objectInfos;
+  objectInfos.SetCountUninitialized(uiNumObjects);
+
+  ezHybridArray<ezUInt32, 16> numObjectsPerLevel[ezInternal::WorldData::HierarchyType::COUNT];
+
+  // determine the hierarchy level of all objects first, so the storage can be reserved upfront
+  for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+  {
+    const ezGameObjectDesc& desc = descs[i];
+    ObjectInfo& info = objectInfos[i];
+    info.m_pParentObject = nullptr;
+    info.m_uiHierarchyLevel = 0;
+    info.m_bDynamic = desc.m_bDynamic;
+
+    const ezUInt32 uiParentIndex = parentIndices.IsEmpty() ? ezInvalidIndex : parentIndices[i];
+    if (uiParentIndex != ezInvalidIndex)
+    {
+      EZ_ASSERT_DEV(uiParentIndex < i, "Parent objects have to be created before their children");
+
+      const ObjectInfo& parentInfo = objectInfos[uiParentIndex];
+      info.m_uiHierarchyLevel = parentInfo.m_uiHierarchyLevel + 1;
+      info.m_bDynamic |= parentInfo.m_bDynamic;
+    }
+    else if (TryGetObject(desc.m_hParent, info.m_pParentObject))
+    {
+      info.m_uiHierarchyLevel = info.m_pParentObject->m_uiHierarchyLevel + 1;
+      info.m_bDynamic |= info.m_pParentObject->IsDynamic();
+    }
+
+    auto& numObjects = numObjectsPerLevel[ezInternal::WorldData::GetHierarchyType(info.m_bDynamic)];
+    if (info.m_uiHierarchyLevel >= numObjects.GetCount())
+    {
+      numObjects.SetCount(info.m_uiHierarchyLevel + 1);
+    }
+
+    ++numObjects[info.m_uiHierarchyLevel];
+  }
+
+  m_Data.m_Objects.Reserve(m_Data.m_Objects.GetCount() + uiNumObjects);
+
+  for (ezUInt32 uiType = 0; uiType < ezInternal::WorldData::HierarchyType::COUNT; ++uiType)
+  {
+    const bool bDynamic = (uiType == ezInternal::WorldData::HierarchyType::Dynamic);
+
+    for (ezUInt32 uiLevel = 0; uiLevel < numObjectsPerLevel[uiType].GetCount(); ++uiLevel)
+    {
+      m_Data.ReserveTransformationData(bDynamic, uiLevel, numObjectsPerLevel[uiType][uiLevel]);
+    }
+  }
+
+  for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+  {
+    const ezUInt32 uiParentIndex = parentIndices.IsEmpty() ? ezInvalidIndex : parentIndices[i];
+    ezGameObject* pParentObject = uiParentIndex != ezInvalidIndex ? out_objects[uiParentIndex] : objectInfos[i].m_pParentObject;
+
+    out_objects[i] = CreateObjectInternal(descs[i], pParentObject);
+  }
+}
+
+ezGameObject* ezWorld::CreateObjectInternal(const ezGameObjectDesc& desc, ezGameObject* pParentObject)
+{
   ezGameObject::TransformationData* pParentData = nullptr;
   ezUInt32 uiParentIndex = 0;
   ezUInt16 uiHierarchyLevel = 0;
   bool bDynamic = desc.m_bDynamic;
 
-  if (TryGetObject(desc.m_hParent, pParentObject))
+  if (pParentObject != nullptr)
   {
     pParentData = pParentObject->m_pTransformationData;
-    uiParentIndex = desc.m_hParent.m_InternalId.m_InstanceIndex;
+    uiParentIndex = pParentObject->m_InternalId.m_InstanceIndex;
     uiHierarchyLevel = pParentObject->m_uiHierarchyLevel + 1; // if there is a parent hierarchy level is parent level + 1
     EZ_ASSERT_DEV(uiHierarchyLevel < (1 << 12), "Max hierarchy level reached");
     bDynamic |= pParentObject->IsDynamic();
@@ -215,8 +310,7 @@ ezGameObjectHandle ezWorld::CreateObject(const ezGameObjectDesc& desc, ezGameObj
 
   pNewObject->UpdateActiveState(pParentObject == nullptr ? true : pParentObject->IsActive());
 
-  out_pObject = pNewObject;
-  return ezGameObjectHandle(newId);
+  return pNewObject;
 }
 
 void ezWorld::DeleteObjectNow(const ezGameObjectHandle& object)
@@ -372,6 +466,79 @@ void ezWorld::Update()
     ezStats::SetStat(sStatName, GetObjectCount());
   }
 
+  if (!m_Data.m_FixedTimeStep.IsPositive())
+  {
+    UpdateStep();
+    return;
+  }
+
+  // fixed step mode: run as many steps as fit into the real time that has passed since the last update
+  const ezTime tNow = ezTime::Now();
+  if (m_Data.m_LastFixedStepUpdate.IsPositive())
+  {
+    m_Data.m_FixedStepAccumulator += tNow - m_Data.m_LastFixedStepUpdate;
+  }
+  else
+  {
+    // the very first update always runs one step
+    m_Data.m_FixedStepAccumulator = m_Data.m_FixedTimeStep;
+  }
+  m_Data.m_LastFixedStepUpdate = tNow;
+
+  ezUInt32 uiNumSteps = static_cast<ezUInt32>(m_Data.m_FixedStepAccumulator.GetSeconds() / m_Data.m_FixedTimeStep.GetSeconds());
+  if (uiNumSteps > m_Data.m_uiMaxFixedStepsPerUpdate)
+  {
+    // we can't catch up, drop the time that we can't simulate
+    uiNumSteps = m_Data.m_uiMaxFixedStepsPerUpdate;
+    m_Data.m_FixedStepAccumulator = ezTime::Zero();
+  }
+  else
+  {
+    m_Data.m_FixedStepAccumulator -= m_Data.m_FixedTimeStep * uiNumSteps;
+  }
+
+  for (ezUInt32 i = 0; i < uiNumSteps; ++i)
+  {
+    UpdateStep();
+  }
+}
+
+void ezWorld::UpdateFixedSteps(ezUInt32 uiNumSteps)
+{
+  CheckForWriteAccess();
+
+  EZ_ASSERT_DEV(m_Data.m_FixedTimeStep.IsPositive(), "Fixed step mode is not enabled for world '{0}'", m_Data.m_sName);
+
+  EZ_LOG_BLOCK(m_Data.m_sName.GetData());
+
+  for (ezUInt32 i = 0; i < uiNumSteps; ++i)
+  {
+    UpdateStep();
+  }
+}
+
+void ezWorld::SetFixedTimeStep(ezTime tStep, ezUInt32 uiMaxStepsPerUpdate)
+{
+  CheckForWriteAccess();
+
+  m_Data.m_FixedTimeStep = tStep;
+  m_Data.m_uiMaxFixedStepsPerUpdate = uiMaxStepsPerUpdate;
+  m_Data.m_FixedStepAccumulator = ezTime::Zero();
+  m_Data.m_LastFixedStepUpdate = ezTime::Zero();
+
+  m_Data.m_Clock.SetFixedTimeStep(tStep);
+}
+
+float ezWorld::GetFixedStepInterpolation() const
+{
+  if (!m_Data.m_FixedTimeStep.IsPositive())
+    return 0.0f;
+
+  return static_cast<float>(m_Data.m_FixedStepAccumulator.GetSeconds() / m_Data.m_FixedTimeStep.GetSeconds());
+}
+
+void ezWorld::UpdateStep()
+{
   m_Data.m_Clock.SetPaused(!m_Data.m_bSimulateWorld);
   m_Data.m_Clock.Update();
 
@@ -388,7 +555,7 @@ void ezWorld::Update()
   {
     EZ_PROFILE_SCOPE("Pre-Async Phase");
     ProcessQueuedMessages(ezObjectMsgQueueType::NextFrame);
-    UpdateSynchronous(m_Data.m_UpdateFunctions[ezComponentManagerBase::UpdateFunctionDesc::Phase::PreAsync]);
+    UpdateSynchronous(ezComponentManagerBase::UpdateFunctionDesc::Phase::PreAsync);
   }
 
   // async phase
@@ -407,7 +574,7 @@ void ezWorld::Update()
   {
     EZ_PROFILE_SCOPE("Post-Async Phase");
     ProcessQueuedMessages(ezObjectMsgQueueType::PostAsync);
-    UpdateSynchronous(m_Data.m_UpdateFunctions[ezComponentManagerBase::UpdateFunctionDesc::Phase::PostAsync]);
+    UpdateSynchronous(ezComponentManagerBase::UpdateFunctionDesc::Phase::PostAsync);
   }
 
   // delete dead objects and update the object hierarchy
@@ -434,7 +601,7 @@ void ezWorld::Update()
   {
     EZ_PROFILE_SCOPE("Post-Transform Phase");
     ProcessQueuedMessages(ezObjectMsgQueueType::PostTransform);
-    UpdateSynchronous(m_Data.m_UpdateFunctions[ezComponentManagerBase::UpdateFunctionDesc::Phase::PostTransform]);
+    UpdateSynchronous(ezComponentManagerBase::UpdateFunctionDesc::Phase::PostTransform);
   }
 
   // Process again so new component can receive render messages, otherwise we introduce a frame delay.
@@ -514,7 +681,18 @@ const ezWorldModule* ezWorld::GetModule(const ezRTTI* pRtti) const
   const ezUInt16 uiTypeId = ezWorldModuleFactory::GetInstance()->GetTypeId(pRtti);
   if (uiTypeId < m_Data.m_Modules.GetCount())
   {
-    return m_Data.m_Modules[uiTypeId];
+    const ezWorldModule* pModule = m_Data.m_Modules[uiTypeId];
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    // concurrent update functions have to declare read access to other modules by their type name
+    const ezInternal::WorldData::RegisteredUpdateFunction* pCurrentFunction = ezInternal::WorldData::GetCurrentConcurrentUpdateFunction();
+    if (pModule != nullptr && pCurrentFunction != nullptr && pCurrentFunction->m_Function.GetClassInstance() != pModule)
+    {
+      CheckForDataAccess(ezTempHashedString(pRtti->GetTypeName()), false);
+    }
+#endif
+
+    return pModule;
   }
 
   return nullptr;
@@ -720,6 +898,141 @@ void ezWorld::ProcessQueuedMessage(const ezInternal::WorldData::MessageQueue::En
   }
 }
 
+bool ezWorld::IsParallelDispatchMessage(const ezInternal::WorldData::MessageQueue::Entry& entry)
+{
+  // recursive messages are delivered to the entire subtree of an object, so they cannot be partitioned by receiver object
+  if (!entry.m_MetaData.m_uiReceiverIsComponent && entry.m_MetaData.m_uiRecursive)
+    return false;
+
+  const ezMessageId msgId = entry.m_pMessage->GetId();
+  if (msgId >= m_Data.m_ParallelMessageTypes.GetCount())
+  {
+    m_Data.m_ParallelMessageTypes.SetCount(msgId + 1);
+  }
+
+  ezUInt8& uiState = m_Data.m_ParallelMessageTypes[msgId];
+  if (uiState == 0)
+  {
+    const bool bParallel = entry.m_pMessage->GetDynamicRTTI()->GetAttributeByType<ezParallelMessageDispatchAttribute>() != nullptr;
+    uiState = bParallel ? 2 : 1;
+  }
+
+  return uiState == 2;
+}
+
+void ezWorld::DispatchMessagesInParallel()
+{
+  EZ_PROFILE_SCOPE("Dispatch Messages In Parallel");
+
+  auto& parallelMessages = m_Data.m_ParallelMessages;
+  auto& partitions = m_Data.m_ParallelMessagePartitions;
+
+  // resolve the object that each message is delivered to
+  for (auto& parallelMessage : parallelMessages)
+  {
+    const auto& entry = parallelMessage.m_Entry;
+    parallelMessage.m_pReceiverObject = nullptr;
+
+    if (entry.m_MetaData.m_uiReceiverIsComponent)
+    {
+      ezUInt64 uiReceiverComponent = entry.m_MetaData.m_uiReceiverComponent;
+      ezComponentHandle hComponent(*reinterpret_cast<ezComponentId*>(&uiReceiverComponent));
+
+      ezComponent* pReceiverComponent = nullptr;
+      if (TryGetComponent(hComponent, pReceiverComponent))
+      {
+        ezGameObject* pOwner = pReceiverComponent->GetOwner();
+        parallelMessage.m_pReceiverObject = pOwner != nullptr ? static_cast<const void*>(pOwner) : pReceiverComponent;
+      }
+    }
+    else
+    {
+      ezGameObjectHandle hObject(ezGameObjectId(entry.m_MetaData.m_uiReceiverObject));
+
+      ezGameObject* pReceiverObject = nullptr;
+      if (TryGetObject(hObject, pReceiverObject))
+      {
+        parallelMessage.m_pReceiverObject = pReceiverObject;
+      }
+    }
+  }
+
+  // group the messages by receiver object, but keep the sorted order within each group
+  parallelMessages.Sort([](const ezInternal::WorldData::ParallelMessage& a, const ezInternal::WorldData::ParallelMessage& b) {
+    if (a.m_pReceiverObject != b.m_pReceiverObject)
+      return a.m_pReceiverObject < b.m_pReceiverObject;
+
+    return a.m_uiIndex < b.m_uiIndex;
+  });
+
+  partitions.Clear();
+  ezUInt32 uiPartitionStart = 0;
+  for (ezUInt32 i = 1; i <= parallelMessages.GetCount(); ++i)
+  {
+    if (i == parallelMessages.GetCount() || parallelMessages[i].m_pReceiverObject != parallelMessages[uiPartitionStart].m_pReceiverObject)
+    {
+      partitions.PushBack(parallelMessages.GetArrayPtr().GetSubArray(uiPartitionStart, i - uiPartitionStart));
+      uiPartitionStart = i;
+    }
+  }
+
+  ezTaskSystem::ParallelForSingle(partitions.GetArrayPtr(),
+    [this](const ezArrayPtr<const ezInternal::WorldData::ParallelMessage>& partition) {
+      for (const auto& parallelMessage : partition)
+      {
+        ProcessQueuedMessage(parallelMessage.m_Entry);
+      }
+    },
+    "DispatchQueuedMessages");
+
+  partitions.Clear();
+  parallelMessages.Clear();
+}
+
+template <typename Container>
+void ezWorld::DispatchSortedMessages(const Container& messages)
+{
+  // runs shorter than this are not worth the overhead of partitioning and spawning tasks
+  const ezUInt32 uiMinParallelMessages = 32;
+
+  auto& parallelMessages = m_Data.m_ParallelMessages;
+
+  // the count is re-evaluated in every iteration since handlers may post new messages into the queue that is currently processed
+  ezUInt32 i = 0;
+  while (i < messages.GetCount())
+  {
+    if (!m_Data.m_bParallelMessageDispatch || !IsParallelDispatchMessage(messages[i]))
+    {
+      ProcessQueuedMessage(messages[i]);
+      ++i;
+      continue;
+    }
+
+    parallelMessages.Clear();
+    while (i < messages.GetCount() && IsParallelDispatchMessage(messages[i]))
+    {
+      auto& parallelMessage = parallelMessages.ExpandAndGetRef();
+      parallelMessage.m_Entry = messages[i];
+      parallelMessage.m_uiIndex = parallelMessages.GetCount() - 1;
+      ++i;
+    }
+
+    if (parallelMessages.GetCount() < uiMinParallelMessages)
+    {
+      for (const auto& parallelMessage : parallelMessages)
+      {
+        ProcessQueuedMessage(parallelMessage.m_Entry);
+      }
+
+      parallelMessages.Clear();
+    }
+    else
+    {
+      DispatchMessagesInParallel();
+    }
+  }
+}
+
 void ezWorld::ProcessQueuedMessages(ezObjectMsgQueueType::Enum queueType)
 {
   EZ_PROFILE_SCOPE("Process Queued Messages");
@@ -752,35 +1065,44 @@ void ezWorld::ProcessQueuedMessages(ezObjectMsgQueueType::Enum queueType)
     ezInternal::WorldData::MessageQueue& queue = m_Data.m_MessageQueues[queueType];
     queue.Sort(MessageComparer());
 
-    for (ezUInt32 i = 0; i < queue.GetCount(); ++i)
-    {
-      ProcessQueuedMessage(queue[i]);
-
-      // no need to deallocate these messages, they are allocated through a frame allocator
-    }
+    // no need to deallocate these messages, they are allocated through a frame allocator
+    DispatchSortedMessages(queue);
 
     queue.Clear();
   }
 
   // timed messages
   {
-    ezInternal::WorldData::MessageQueue& queue = m_Data.m_TimedMessageQueues[queueType];
-    queue.Sort(MessageComparer());
+    ezInternal::WorldData::MessageQueue& newMessages = m_Data.m_TimedMessageQueues[queueType];
+    ezInternal::WorldData::TimedMessageHeap& pendingMessages = m_Data.m_TimedMessageHeaps[queueType];
+
+    for (ezUInt32 i = 0; i < newMessages.GetCount(); ++i)
+    {
+      pendingMessages.Push(newMessages[i]);
+    }
+
+    newMessages.Clear();
 
     const ezTime now = m_Data.m_Clock.GetAccumulatedTime();
 
-    while (!queue.IsEmpty())
+    // only the messages that are due are sorted, which gives the same deterministic order as sorting all pending messages
+    ezDynamicArrayBase<ezInternal::WorldData::MessageQueue::Entry>& dueMessages = m_Data.m_DueTimedMessages;
+
+    while (!pendingMessages.IsEmpty() && pendingMessages.Peek().m_MetaData.m_Due <= now)
     {
-      auto& entry = queue.Peek();
-      if (entry.m_MetaData.m_Due > now)
-        break;
+      dueMessages.PushBack(pendingMessages.Pop());
+    }
 
-      ProcessQueuedMessage(entry);
+    dueMessages.Sort(MessageComparer());
 
-      EZ_DELETE(&m_Data.m_Allocator, entry.m_pMessage);
+    DispatchSortedMessages(dueMessages);
 
-      queue.Dequeue();
+    for (auto& entry : dueMessages)
+    {
+      EZ_DELETE(&m_Data.m_Allocator, entry.m_pMessage);
     }
+
+    dueMessages.Clear();
   }
 }
 
@@ -796,6 +1118,9 @@ void ezWorld::RegisterUpdateFunction(const ezComponentManagerBase::UpdateFunctio
     "Asynchronous update functions must not have dependencies");
   EZ_ASSERT_DEV(desc.m_Function.IsComparable(), "Delegates with captures are not allowed as ezWorld update functions.");
 
+  EZ_ASSERT_DEV(!desc.m_bConcurrent || desc.m_Phase != ezComponentManagerBase::UpdateFunctionDesc::Phase::Async,
+    "Asynchronous update functions are always executed concurrently and must not be flagged as concurrent");
+
   m_Data.m_UpdateFunctionsToRegister.PushBack(desc);
 }
 
@@ -810,6 +1135,7 @@ void ezWorld::DeregisterUpdateFunction(const ezComponentManagerBase::UpdateFunct
     if (updateFunctions[i].m_Function.IsEqualIfComparable(desc.m_Function))
     {
       updateFunctions.RemoveAtAndCopy(i);
+      m_Data.m_UpdateSchedules[desc.m_Phase.GetValue()].m_bIsValid = false;
     }
   }
 }
@@ -828,6 +1154,7 @@ void ezWorld::DeregisterUpdateFunctions(ezWorldModule* pModule)
       if (updateFunctions[i].m_Function.GetClassInstance() == pModule)
       {
         updateFunctions.RemoveAtAndCopy(i);
+        m_Data.m_UpdateSchedules[phase].m_bIsValid = false;
       }
     }
   }
@@ -835,7 +1162,31 @@ void ezWorld::DeregisterUpdateFunctions(ezWorldModule* pModule)
 
 void ezWorld::AddComponentToInitialize(ezComponentHandle hComponent)
 {
-  m_Data.m_ComponentsToInitialize.PushBack(hComponent);
+  if (m_Data.m_pComponentsToInitializeTarget != nullptr)
+  {
+    m_Data.m_pComponentsToInitializeTarget->PushBack(hComponent);
+  }
+  else
+  {
+    m_Data.m_ComponentsToInitialize.PushBack(hComponent);
+  }
+}
+
+void ezWorld::SetComponentsToInitializeTarget(ezDynamicArray<ezComponentHandle>* pComponentsToInitialize)
+{
+  CheckForWriteAccess();
+
+  m_Data.m_pComponentsToInitializeTarget = pComponentsToInitialize;
+}
+
+void ezWorld::InitializeComponents(ezArrayPtr<const ezComponentHandle> components)
+{
+  CheckForWriteAccess();
+
+  for (const ezComponentHandle& hComponent : components)
+  {
+    InitializeComponent(hComponent);
+  }
 }
 
 void ezWorld::UpdateFromThread()
@@ -845,20 +1196,102 @@ void ezWorld::UpdateFromThread()
   Update();
 }
 
-void ezWorld::UpdateSynchronous(const ezArrayPtr<ezInternal::WorldData::RegisteredUpdateFunction>& updateFunctions)
+void ezWorld::CheckForDataAccess(const ezTempHashedString& sDataName, bool bWrite) const
+{
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  const ezInternal::WorldData::RegisteredUpdateFunction* pCurrentFunction = ezInternal::WorldData::GetCurrentConcurrentUpdateFunction();
+  if (pCurrentFunction == nullptr)
+    return;
+
+  EZ_ASSERT_DEV(pCurrentFunction->HasDeclaredDataAccess(sDataName, bWrite),
+    "Concurrent update function '{0}' accesses shared data for {1} without declaring it in its update function description.",
+    pCurrentFunction->m_sFunctionName, bWrite ? "writing" : "reading");
+#endif
+}
+
+void ezWorld::UpdateSynchronous(ezWorldModule::UpdateFunctionDesc::Phase::Enum phase)
 {
   ezWorldModule::UpdateContext context;
   context.m_uiFirstComponentIndex = 0;
   context.m_uiComponentCount = ezInvalidIndex;
 
-  for (auto& updateFunction : updateFunctions)
+  const ezDynamicArrayBase<ezInternal::WorldData::RegisteredUpdateFunction>& updateFunctions = m_Data.m_UpdateFunctions[phase];
+  ezInternal::WorldData::UpdateSchedule& schedule = m_Data.m_UpdateSchedules[phase];
+
+  if (!schedule.m_bIsValid)
   {
-    if (updateFunction.m_bOnlyUpdateWhenSimulating && !m_Data.m_bSimulateWorld)
-      continue;
+    m_Data.BuildUpdateSchedule(phase);
+  }
+
+  ezHybridArray<const ezInternal::WorldData::RegisteredUpdateFunction*, 16> batch;
+
+  ezUInt32 uiBatchStart = 0;
+  for (ezUInt32 uiBatchEnd : schedule.m_BatchEnds)
+  {
+    // one of the update functions has deregistered update functions, the schedule is outdated
+    if (!schedule.m_bIsValid)
+      break;
+
+    batch.Clear();
+    for (ezUInt32 i = uiBatchStart; i < uiBatchEnd; ++i)
+    {
+      const auto& updateFunction = updateFunctions[schedule.m_FunctionIndices[i]];
 
+      if (updateFunction.m_bOnlyUpdateWhenSimulating && !m_Data.m_bSimulateWorld)
+        continue;
+
+      batch.PushBack(&updateFunction);
+    }
+
+    uiBatchStart = uiBatchEnd;
+
+    if (batch.GetCount() == 1)
+    {
+      const auto& updateFunction = *batch[0];
+
+      // concurrent functions are validated the same way, no matter whether they actually run on another thread or not
+      const bool bValidate = m_Data.m_bValidateUpdateFunctionAccess && updateFunction.m_bConcurrent;
+      const ezInternal::WorldData::RegisteredUpdateFunction* pPrevFunction = nullptr;
+      if (bValidate)
+      {
+        pPrevFunction = ezInternal::WorldData::SetCurrentConcurrentUpdateFunction(&updateFunction);
+      }
+
+      {
+        EZ_PROFILE_SCOPE(updateFunction.m_sFunctionName);
+        updateFunction.m_Function(context);
+      }
+
+      if (bValidate)
+      {
+        ezInternal::WorldData::SetCurrentConcurrentUpdateFunction(pPrevFunction);
+      }
+    }
+    else if (batch.GetCount() > 1)
     {
-      EZ_PROFILE_SCOPE(updateFunction.m_sFunctionName);
-      updateFunction.m_Function(context);
+      ezTaskGroupID taskGroupId = ezTaskSystem::CreateTaskGroup(ezTaskPriority::EarlyThisFrame);
+
+      for (ezUInt32 i = 0; i < batch.GetCount(); ++i)
+      {
+        ezInternal::WorldData::ConcurrentUpdateTask* pTask;
+        if (i < m_Data.m_ConcurrentUpdateTasks.GetCount())
+        {
+          pTask = m_Data.m_ConcurrentUpdateTasks[i];
+        }
+        else
+        {
+          pTask = EZ_NEW(&m_Data.m_Allocator, ezInternal::WorldData::ConcurrentUpdateTask);
+          m_Data.m_ConcurrentUpdateTasks.PushBack(pTask);
+        }
+
+        pTask->SetTaskName(batch[i]->m_sFunctionName);
+        pTask->m_pFunction = batch[i];
+        pTask->m_bValidateDataAccess = m_Data.m_bValidateUpdateFunctionAccess;
+        ezTaskSystem::AddTaskToGroup(taskGroupId, pTask);
+      }
+
+      ezTaskSystem::StartTaskGroup(taskGroupId);
+      ezTaskSystem::WaitForGroup(taskGroupId);
     }
   }
 }
@@ -920,27 +1353,7 @@ void ezWorld::ProcessComponentsToInitialize()
   // Can't use foreach here because the array might be resized during iteration.
   for (ezUInt32 i = 0; i < m_Data.m_ComponentsToInitialize.GetCount(); ++i)
   {
-    ezComponentHandle hComponent = m_Data.m_ComponentsToInitialize[i];
-
-    ezComponent* pComponent = nullptr;
-    if (!TryGetComponent(hComponent, pComponent)) // if it is in the editor, the component might have been added and already deleted,
-                                                  // without ever running the simulation
-      continue;
-
-    // make sure the object's transform is up to date before the component is initialized
-    if (pComponent->GetOwner())
-    {
-      pComponent->GetOwner()->UpdateGlobalTransform();
-    }
-
-    pComponent->EnsureInitialized();
-
-    if (pComponent->IsActive())
-    {
-      pComponent->OnActivated();
-
-      m_Data.m_ComponentsToStartSimulation.PushBack(hComponent);
-    }
+    InitializeComponent(m_Data.m_ComponentsToInitialize[i]);
   }
 
   m_Data.m_ComponentsToInitialize.Clear();
@@ -975,6 +1388,29 @@ void ezWorld::ProcessComponentsToInitialize()
   }
 }
 
+void ezWorld::InitializeComponent(const ezComponentHandle& hComponent)
+{
+  ezComponent* pComponent = nullptr;
+  if (!TryGetComponent(hComponent, pComponent)) // if it is in the editor, the component might have been added and already deleted,
+                                                // without ever running the simulation
+    return;
+
+  // make sure the object's transform is up to date before the component is initialized
+  if (pComponent->GetOwner())
+  {
+    pComponent->GetOwner()->UpdateGlobalTransform();
+  }
+
+  pComponent->EnsureInitialized();
+
+  if (pComponent->IsActive())
+  {
+    pComponent->OnActivated();
+
+    m_Data.m_ComponentsToStartSimulation.PushBack(hComponent);
+  }
+}
+
 void ezWorld::ProcessUpdateFunctionsToRegister()
 {
   CheckForWriteAccess();
@@ -1044,6 +1480,7 @@ ezResult ezWorld::RegisterUpdateFunctionInternal(const ezWorldModule::UpdateFunc
   }
 
   updateFunctions.Insert(newFunction, uiInsertionIndex);
+  m_Data.m_UpdateSchedules[desc.m_Phase.GetValue()].m_bIsValid = false;
 
   return EZ_SUCCESS;
 }
@@ -34,6 +34,139 @@ namespace ezInternal
     m_Function(context);
   }
 
+  void WorldData::ConcurrentUpdateTask::Execute()
+  {
+    ezWorldModule::UpdateContext context;
+    context.m_uiFirstComponentIndex = 0;
+    context.m_uiComponentCount = ezInvalidIndex;
+
+    const RegisteredUpdateFunction* pPrevFunction = nullptr;
+    if (m_bValidateDataAccess)
+    {
+      pPrevFunction = SetCurrentConcurrentUpdateFunction(m_pFunction);
+    }
+
+    m_pFunction->m_Function(context);
+
+    if (m_bValidateDataAccess)
+    {
+      SetCurrentConcurrentUpdateFunction(pPrevFunction);
+    }
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////////////////////////
+
+  bool WorldData::RegisteredUpdateFunction::MustRunAfter(const RegisteredUpdateFunction& other) const
+  {
+    if (!m_bConcurrent || !other.m_bConcurrent)
+      return true;
+
+    // functions of the same module always share data
+    if (m_Function.GetClassInstance() == other.m_Function.GetClassInstance())
+      return true;
+
+    if (m_DependsOn.Contains(other.m_sFunctionName))
+      return true;
+
+    for (const ezHashedString& sWrite : m_WriteAccess)
+    {
+      if (other.m_WriteAccess.Contains(sWrite) || other.m_ReadAccess.Contains(sWrite))
+        return true;
+    }
+
+    for (const ezHashedString& sRead : m_ReadAccess)
+    {
+      if (other.m_WriteAccess.Contains(sRead))
+        return true;
+    }
+
+    return false;
+  }
+
+  bool WorldData::RegisteredUpdateFunction::HasDeclaredDataAccess(const ezTempHashedString& sDataName, bool bWrite) const
+  {
+    for (const ezHashedString& sWrite : m_WriteAccess)
+    {
+      if (sWrite == sDataName)
+        return true;
+    }
+
+    if (!bWrite)
+    {
+      for (const ezHashedString& sRead : m_ReadAccess)
+      {
+        if (sRead == sDataName)
+          return true;
+      }
+    }
+
+    return false;
+  }
+
+  void WorldData::BuildUpdateSchedule(ezUInt32 uiPhase)
+  {
+    const ezDynamicArray<RegisteredUpdateFunction, ezLocalAllocatorWrapper>& updateFunctions = m_UpdateFunctions[uiPhase];
+    UpdateSchedule& schedule = m_UpdateSchedules[uiPhase];
+
+    const ezUInt32 uiNumFunctions = updateFunctions.GetCount();
+
+    // The functions are already sorted by dependencies and priority. Every function goes into the first batch after all the
+    // batches of the preceding functions that it depends on or shares data with. Thus conflicting functions are still executed
+    // in the registered order and the result is deterministic.
+    ezHybridArray<ezUInt32, 64> batchOfFunction;
+    batchOfFunction.SetCountUninitialized(uiNumFunctions);
+
+    ezUInt32 uiNumBatches = 0;
+    for (ezUInt32 i = 0; i < uiNumFunctions; ++i)
+    {
+      ezUInt32 uiBatch = 0;
+      for (ezUInt32 j = 0; j < i; ++j)
+      {
+        if (batchOfFunction[j] >= uiBatch && updateFunctions[i].MustRunAfter(updateFunctions[j]))
+        {
+          uiBatch = batchOfFunction[j] + 1;
+        }
+      }
+
+      batchOfFunction[i] = uiBatch;
+      uiNumBatches = ezMath::Max(uiNumBatches, uiBatch + 1);
+    }
+
+    schedule.m_FunctionIndices.Clear();
+    schedule.m_BatchEnds.Clear();
+
+    for (ezUInt32 uiBatch = 0; uiBatch < uiNumBatches; ++uiBatch)
+    {
+      for (ezUInt32 i = 0; i < uiNumFunctions; ++i)
+      {
+        if (batchOfFunction[i] == uiBatch)
+        {
+          schedule.m_FunctionIndices.PushBack(i);
+        }
+      }
+
+      schedule.m_BatchEnds.PushBack(schedule.m_FunctionIndices.GetCount());
+    }
+
+    schedule.m_bIsValid = true;
+  }
+
+  static thread_local const void* s_pCurrentConcurrentUpdateFunction = nullptr;
+
+  // static
+  const WorldData::RegisteredUpdateFunction* WorldData::GetCurrentConcurrentUpdateFunction()
+  {
+    return static_cast<const RegisteredUpdateFunction*>(s_pCurrentConcurrentUpdateFunction);
+  }
+
+  // static
+  const WorldData::RegisteredUpdateFunction* WorldData::SetCurrentConcurrentUpdateFunction(const RegisteredUpdateFunction* pFunction)
+  {
+    const RegisteredUpdateFunction* pPrevFunction = GetCurrentConcurrentUpdateFunction();
+    s_pCurrentConcurrentUpdateFunction = pFunction;
+    return pPrevFunction;
+  }
+
   ////////////////////////////////////////////////////////////////////////////////////////////////////
 
   WorldData::WorldData(ezWorldDesc& desc)
@@ -48,6 +181,8 @@ namespace ezInternal
     , m_iWriteCounter(0)
     , m_bSimulateWorld(true)
     , m_bReportErrorWhenStaticObjectMoves(desc.m_bReportErrorWhenStaticObjectMoves)
+    , m_bValidateUpdateFunctionAccess(desc.m_bValidateUpdateFunctionAccess)
+    , m_bParallelMessageDispatch(desc.m_bParallelMessageDispatch)
     , m_ReadMarker(*this)
     , m_WriteMarker(*this)
     , m_pUserData(nullptr)
@@ -94,6 +229,10 @@ namespace ezInternal
     }
 
     m_Clock.SetTimeStepSmoothing(m_pTimeStepSmoothing.Borrow());
+
+    m_FixedTimeStep = desc.m_FixedTimeStep;
+    m_uiMaxFixedStepsPerUpdate = desc.m_uiMaxFixedStepsPerUpdate;
+    m_Clock.SetFixedTimeStep(m_FixedTimeStep);
   }
 
   WorldData::~WorldData()
@@ -122,6 +261,11 @@ namespace ezInternal
       EZ_DELETE(&m_Allocator, m_UpdateTasks[i]);
     }
 
+    for (ezUInt32 i = 0; i < m_ConcurrentUpdateTasks.GetCount(); ++i)
+    {
+      EZ_DELETE(&m_Allocator, m_ConcurrentUpdateTasks[i]);
+    }
+
     // delete queued messages
     for (ezUInt32 i = 0; i < ezObjectMsgQueueType::COUNT; ++i)
     {
@@ -142,7 +286,67 @@ namespace ezInternal
           queue.Dequeue();
         }
       }
+
+      {
+        for (MessageQueue::Entry& entry : m_TimedMessageHeaps[i].m_Entries)
+        {
+          EZ_DELETE(&m_Allocator, entry.m_pMessage);
+        }
+
+        m_TimedMessageHeaps[i].m_Entries.Clear();
+      }
+    }
+  }
+
+  void WorldData::TimedMessageHeap::Push(const MessageQueue::Entry& entry)
+  {
+    ezUInt32 uiIndex = m_Entries.GetCount();
+    m_Entries.PushBack(entry);
+
+    // sift up
+    while (uiIndex > 0)
+    {
+      const ezUInt32 uiParent = (uiIndex - 1) / 2;
+      if (m_Entries[uiParent].m_MetaData.m_Due <= entry.m_MetaData.m_Due)
+        break;
+
+      m_Entries[uiIndex] = m_Entries[uiParent];
+      uiIndex = uiParent;
+    }
+
+    m_Entries[uiIndex] = entry;
+  }
+
+  WorldData::MessageQueue::Entry WorldData::TimedMessageHeap::Pop()
+  {
+    const MessageQueue::Entry result = m_Entries[0];
+    const MessageQueue::Entry last = m_Entries.PeekBack();
+    m_Entries.PopBack();
+
+    const ezUInt32 uiCount = m_Entries.GetCount();
+    if (uiCount == 0)
+      return result;
+
+    // sift down
+    ezUInt32 uiIndex = 0;
+    while (true)
+    {
+      ezUInt32 uiChild = uiIndex * 2 + 1;
+      if (uiChild >= uiCount)
+        break;
+
+      if (uiChild + 1 < uiCount && m_Entries[uiChild + 1].m_MetaData.m_Due < m_Entries[uiChild].m_MetaData.m_Due)
+        ++uiChild;
+
+      if (last.m_MetaData.m_Due <= m_Entries[uiChild].m_MetaData.m_Due)
+        break;
+
+      m_Entries[uiIndex] = m_Entries[uiChild];
+      uiIndex = uiChild;
     }
+
+    m_Entries[uiIndex] = last;
+    return result;
   }
 
   ezGameObject::TransformationData* WorldData::CreateTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel)
@@ -171,6 +375,30 @@ namespace ezInternal
     return pBlock->ReserveBack();
   }
 
+  void WorldData::ReserveTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel, ezUInt32 uiCount)
+  {
+    Hierarchy& hierarchy = m_Hierarchies[GetHierarchyType(bDynamic)];
+
+    while (uiHierarchyLevel >= hierarchy.m_Data.GetCount())
+    {
+      hierarchy.m_Data.PushBack(EZ_NEW(&m_Allocator, Hierarchy::DataBlockArray, &m_Allocator));
+    }
+
+    Hierarchy::DataBlockArray& blocks = *hierarchy.m_Data[uiHierarchyLevel];
+
+    ezUInt32 uiFreeInLastBlock = 0;
+    if (!blocks.IsEmpty())
+    {
+      uiFreeInLastBlock = Hierarchy::DataBlock::CAPACITY - blocks.PeekBack().m_uiCount;
+    }
+
+    if (uiCount > uiFreeInLastBlock)
+    {
+      const ezUInt32 uiNumNewBlocks = (uiCount - uiFreeInLastBlock + Hierarchy::DataBlock::CAPACITY - 1) / Hierarchy::DataBlock::CAPACITY;
+      blocks.Reserve(blocks.GetCount() + uiNumNewBlocks);
+    }
+  }
+
   void WorldData::DeleteTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel, ezGameObject::TransformationData* pData)
   {
     Hierarchy& hierarchy = m_Hierarchies[GetHierarchyType(bDynamic)];
@@ -65,6 +65,9 @@ namespace ezInternal
 
     ezGameObject::TransformationData* CreateTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel);
 
+    /// \brief Makes sure that the given number of transformation data entries can be created without reallocating the block array.
+    void ReserveTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel, ezUInt32 uiCount);
+
     void DeleteTransformationData(bool bDynamic, ezUInt32 uiHierarchyLevel, ezGameObject::TransformationData* pData);
 
     template <typename VISITOR>
@@ -97,6 +100,7 @@ namespace ezInternal
     ezSet<ezComponent*, ezCompareHelper<ezComponent*>, ezLocalAllocatorWrapper> m_DeadComponents;
 
     ezDynamicArray<ezComponentHandle, ezLocalAllocatorWrapper> m_ComponentsToInitialize;
+    ezDynamicArray<ezComponentHandle>* m_pComponentsToInitializeTarget = nullptr;
     ezDynamicArray<ezComponentHandle, ezLocalAllocatorWrapper> m_ComponentsToStartSimulation;
 
     struct RegisteredUpdateFunction
@@ -106,9 +110,19 @@ namespace ezInternal
       float m_fPriority;
       ezUInt16 m_uiGranularity;
       bool m_bOnlyUpdateWhenSimulating;
+      bool m_bConcurrent;
+      ezHybridArray<ezHashedString, 4> m_DependsOn;
+      ezHybridArray<ezHashedString, 2> m_ReadAccess;
+      ezHybridArray<ezHashedString, 2> m_WriteAccess;
 
       void FillFromDesc(const ezWorldModule::UpdateFunctionDesc& desc);
       bool operator<(const RegisteredUpdateFunction& other) const;
+
+      /// \brief Whether this function has to run after \a other, because it depends on it or because both access the same data.
+      bool MustRunAfter(const RegisteredUpdateFunction& other) const;
+
+      /// \brief Whether the given data access has been declared for this function.
+      bool HasDeclaredDataAccess(const ezTempHashedString& sDataName, bool bWrite) const;
     };
 
     struct UpdateTask : public ezTask
@@ -120,16 +134,47 @@ namespace ezInternal
       ezUInt32 m_uiCount;
     };
 
+    struct ConcurrentUpdateTask : public ezTask
+    {
+      virtual void Execute() override;
+
+      const RegisteredUpdateFunction* m_pFunction;
+      bool m_bValidateDataAccess;
+    };
+
+    /// \brief The order in which the update functions of a synchronous phase are executed.
+    ///
+    /// The functions are grouped into batches. All functions within one batch can run concurrently,
+    /// the batches are executed one after another.
+    struct UpdateSchedule
+    {
+      ezDynamicArray<ezUInt32, ezLocalAllocatorWrapper> m_FunctionIndices;
+      ezDynamicArray<ezUInt32, ezLocalAllocatorWrapper> m_BatchEnds; ///< End of each batch in m_FunctionIndices (exclusive).
+      bool m_bIsValid = false;
+    };
+
+    void BuildUpdateSchedule(ezUInt32 uiPhase);
+
+    /// \brief Returns the concurrent update function that is currently executed by this thread, if access validation is enabled.
+    static const RegisteredUpdateFunction* GetCurrentConcurrentUpdateFunction();
+    static const RegisteredUpdateFunction* SetCurrentConcurrentUpdateFunction(const RegisteredUpdateFunction* pFunction);
+
     ezDynamicArray<RegisteredUpdateFunction, ezLocalAllocatorWrapper> m_UpdateFunctions[ezWorldModule::UpdateFunctionDesc::Phase::COUNT];
     ezDynamicArray<ezWorldModule::UpdateFunctionDesc, ezLocalAllocatorWrapper> m_UpdateFunctionsToRegister;
+    UpdateSchedule m_UpdateSchedules[ezWorldModule::UpdateFunctionDesc::Phase::COUNT];
 
     ezDynamicArray<UpdateTask*, ezLocalAllocatorWrapper> m_UpdateTasks;
+    ezDynamicArray<ConcurrentUpdateTask*, ezLocalAllocatorWrapper> m_ConcurrentUpdateTasks;
 
     ezUniquePtr<ezSpatialSystem> m_pSpatialSystem;
     ezSharedPtr<ezCoordinateSystemProvider> m_pCoordinateSystemProvider;
     ezUniquePtr<ezTimeStepSmoothing> m_pTimeStepSmoothing;
 
     ezClock m_Clock;
+    ezTime m_FixedTimeStep;
+    ezUInt32 m_uiMaxFixedStepsPerUpdate = 4;
+    ezTime m_FixedStepAccumulator;
+    ezTime m_LastFixedStepUpdate;
     ezRandom m_Random;
 
     struct QueuedMsgMetaData
@@ -159,14 +204,51 @@ namespace ezInternal
 
     typedef ezMessageQueue<QueuedMsgMetaData, ezLocalAllocatorWrapper> MessageQueue;
     mutable MessageQueue m_MessageQueues[ezObjectMsgQueueType::COUNT];
+
+    /// \brief Messages that have been posted with a delay since the last time the corresponding queue was processed.
     mutable MessageQueue m_TimedMessageQueues[ezObjectMsgQueueType::COUNT];
 
+    /// \brief Binary min-heap of timed messages, ordered by due time only.
+    ///
+    /// Thus each frame only the messages that are due have to be touched, instead of sorting all pending messages.
+    struct TimedMessageHeap
+    {
+      void Push(const MessageQueue::Entry& entry);
+      MessageQueue::Entry Pop();
+
+      const MessageQueue::Entry& Peek() const { return m_Entries[0]; }
+      bool IsEmpty() const { return m_Entries.IsEmpty(); }
+
+      ezDynamicArray<MessageQueue::Entry, ezLocalAllocatorWrapper> m_Entries;
+    };
+
+    TimedMessageHeap m_TimedMessageHeaps[ezObjectMsgQueueType::COUNT];
+    ezDynamicArray<MessageQueue::Entry, ezLocalAllocatorWrapper> m_DueTimedMessages;
+
+    /// \brief A queued message together with the object it is delivered to, used to partition messages for parallel dispatch.
+    struct ParallelMessage
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      const void* m_pReceiverObject;
+      ezUInt32 m_uiIndex;
+      MessageQueue::Entry m_Entry;
+    };
+
+    ezDynamicArray<ParallelMessage, ezLocalAllocatorWrapper> m_ParallelMessages;
+    ezDynamicArray<ezArrayPtr<const ParallelMessage>, ezLocalAllocatorWrapper> m_ParallelMessagePartitions;
+
+    /// \brief Caches for each message id whether its type has the ezParallelMessageDispatchAttribute. 0 = unknown, 1 = no, 2 = yes.
+    ezDynamicArray<ezUInt8, ezLocalAllocatorWrapper> m_ParallelMessageTypes;
+
     ezThreadID m_WriteThreadID;
     ezInt32 m_iWriteCounter;
     mutable ezAtomicInteger32 m_iReadCounter;
 
     bool m_bSimulateWorld;
     bool m_bReportErrorWhenStaticObjectMoves;
+    bool m_bValidateUpdateFunctionAccess;
+    bool m_bParallelMessageDispatch;
 
     /// \brief Maps some data (given as void*) to an ezGameObjectHandle. Only available in special situations (e.g. editor use cases).
     ezDelegate<ezGameObjectHandle(const void*, ezComponentHandle, const char*)> m_GameObjectReferenceResolver;
@@ -101,6 +101,10 @@ namespace ezInternal
     m_fPriority = desc.m_fPriority;
     m_uiGranularity = desc.m_uiGranularity;
     m_bOnlyUpdateWhenSimulating = desc.m_bOnlyUpdateWhenSimulating;
+    m_bConcurrent = desc.m_bConcurrent;
+    m_DependsOn = desc.m_DependsOn;
+    m_ReadAccess = desc.m_ReadAccess;
+    m_WriteAccess = desc.m_WriteAccess;
   }
 
   EZ_FORCE_INLINE bool WorldData::RegisteredUpdateFunction::operator<(const RegisteredUpdateFunction& other) const
@@ -0,0 +1,73 @@
+#include <CorePCH.h>
+
+#include <Core/World/World.h>
+#include <Core/World/WorldGroup.h>
+#include <Foundation/Profiling/Profiling.h>
+
+ezWorldGroup::ezWorldGroup() = default;
+
+ezWorldGroup::~ezWorldGroup()
+{
+  WaitForUpdate();
+}
+
+void ezWorldGroup::AddWorld(ezWorld* pWorld)
+{
+  EZ_ASSERT_DEV(!IsUpdateInProgress(), "Worlds can't be added while the group is updating");
+  EZ_ASSERT_DEV(pWorld != nullptr, "Invalid world");
+
+  if (!m_Worlds.Contains(pWorld))
+  {
+    m_Worlds.PushBack(pWorld);
+  }
+}
+
+void ezWorldGroup::RemoveWorld(ezWorld* pWorld)
+{
+  EZ_ASSERT_DEV(!IsUpdateInProgress(), "Worlds can't be removed while the group is updating");
+
+  m_Worlds.RemoveAndCopy(pWorld);
+}
+
+void ezWorldGroup::Clear()
+{
+  EZ_ASSERT_DEV(!IsUpdateInProgress(), "Worlds can't be removed while the group is updating");
+
+  m_Worlds.Clear();
+}
+
+void ezWorldGroup::StartUpdate(ezTaskPriority::Enum priority)
+{
+  EZ_ASSERT_DEV(!IsUpdateInProgress(), "The previous update has not been waited for");
+
+  if (m_Worlds.IsEmpty())
+    return;
+
+  m_UpdateTaskGroup = ezTaskSystem::CreateTaskGroup(priority);
+
+  for (ezWorld* pWorld : m_Worlds)
+  {
+    ezTaskSystem::AddTaskToGroup(m_UpdateTaskGroup, pWorld->GetUpdateTask());
+  }
+
+  ezTaskSystem::StartTaskGroup(m_UpdateTaskGroup);
+}
+
+void ezWorldGroup::WaitForUpdate()
+{
+  if (!IsUpdateInProgress())
+    return;
+
+  ezTaskSystem::WaitForGroup(m_UpdateTaskGroup);
+  m_UpdateTaskGroup.Invalidate();
+}
+
+void ezWorldGroup::Update()
+{
+  EZ_PROFILE_SCOPE("World Group Update");
+
+  StartUpdate();
+  WaitForUpdate();
+}
+
+EZ_STATICLINK_FILE(Core, Core_World_Implementation_WorldGroup);
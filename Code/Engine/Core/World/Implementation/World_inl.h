@@ -381,6 +381,11 @@ EZ_ALWAYS_INLINE ezTask* ezWorld::GetUpdateTask()
   return &m_UpdateTask;
 }
 
+EZ_ALWAYS_INLINE ezTime ezWorld::GetFixedTimeStep() const
+{
+  return m_Data.m_FixedTimeStep;
+}
+
 EZ_FORCE_INLINE ezSpatialSystem* ezWorld::GetSpatialSystem()
 {
   CheckForWriteAccess();
@@ -485,6 +490,9 @@ EZ_ALWAYS_INLINE void ezWorld::CheckForWriteAccess() const
 {
   EZ_ASSERT_DEV(m_Data.m_WriteThreadID == ezThreadUtils::GetCurrentThreadID(),
                 "Trying to write to World '{0}', but it is not marked for writing.", GetName());
+  EZ_ASSERT_DEV(ezInternal::WorldData::GetCurrentConcurrentUpdateFunction() == nullptr,
+                "Concurrent update function '{0}' is not allowed to modify World '{1}'.",
+                ezInternal::WorldData::GetCurrentConcurrentUpdateFunction()->m_sFunctionName, GetName());
 }
 
 EZ_ALWAYS_INLINE ezGameObject* ezWorld::GetObjectUnchecked(ezUInt32 uiIndex) const
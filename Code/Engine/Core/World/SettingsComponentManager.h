@@ -32,6 +32,9 @@ private:
   virtual ezComponent* CreateComponentStorage() override;
   virtual void DeleteComponentStorage(ezComponent* pComponent, ezComponent*& out_pMovedComponent) override;
 
+  virtual void CopyRawComponentData(ezDynamicArrayBase<ezUInt8>& out_Data) const override;
+  virtual void RestoreRawComponentStorage(ezArrayPtr<const ezUInt8> data) override;
+
   ezHybridArray<ezUniquePtr<ComponentType>, 2> m_Components;
 };
 
@@ -68,6 +68,7 @@ struct EZ_CORE_DLL ezDefaultSpatialDataCategories
 {
   static ezSpatialData::Category RenderStatic;
   static ezSpatialData::Category RenderDynamic;
+  static ezSpatialData::Category Occluder;
 };
 
 #define ezInvalidSpatialDataCategory ezSpatialData::Category()
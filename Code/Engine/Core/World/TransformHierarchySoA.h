@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Core/CoreDLL.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/SimdMath/SimdTransform.h>
+
+/// \brief Experimental structure-of-arrays storage for the data that is needed to propagate transforms through an object hierarchy.
+///
+/// ezGameObject::TransformationData keeps the hot transform fields interleaved with bounds, velocity and spatial data,
+/// so the transform update touches a lot of memory that it does not need. This class only stores the hot fields
+/// (local position, rotation, scale, the parent index and the resulting global transform), split into one array per
+/// component and grouped by hierarchy level. All cold data stays with the owner of the objects, which maps its objects to
+/// (level, index) pairs.
+///
+/// Every array element holds the same component of four consecutive objects, which allows UpdateGlobalTransforms() to
+/// concatenate the transforms of four objects at once with plain SIMD arithmetic. Only the parent transforms have to be gathered.
+class EZ_CORE_DLL ezTransformHierarchySoA
+{
+public:
+  ezTransformHierarchySoA();
+  ~ezTransformHierarchySoA();
+
+  /// \brief Removes all objects.
+  void Clear();
+
+  /// \brief Adds an object to the given hierarchy level and returns its index within that level.
+  ///
+  /// Objects on level 0 have no parent, \a uiParentIndex is ignored for them. For all other levels \a uiParentIndex is the
+  /// index of the parent on the level above. The local scale may have a uniform scale in w, like ezGameObject's local scaling.
+  ezUInt32 AddObject(ezUInt32 uiHierarchyLevel, ezUInt32 uiParentIndex, const ezSimdVec4f& vLocalPosition, const ezSimdQuat& qLocalRotation,
+    const ezSimdVec4f& vLocalScaling);
+
+  void SetLocalTransform(ezUInt32 uiHierarchyLevel, ezUInt32 uiIndex, const ezSimdVec4f& vLocalPosition, const ezSimdQuat& qLocalRotation,
+    const ezSimdVec4f& vLocalScaling);
+
+  ezSimdTransform GetLocalTransform(ezUInt32 uiHierarchyLevel, ezUInt32 uiIndex) const;
+  ezSimdTransform GetGlobalTransform(ezUInt32 uiHierarchyLevel, ezUInt32 uiIndex) const;
+
+  ezUInt32 GetHierarchyLevelCount() const { return m_HierarchyLevels.GetCount(); }
+  ezUInt32 GetObjectCount(ezUInt32 uiHierarchyLevel) const { return m_HierarchyLevels[uiHierarchyLevel].m_uiCount; }
+  ezUInt32 GetObjectCount() const;
+
+  /// \brief Recomputes the global transforms of all objects, level by level.
+  void UpdateGlobalTransforms();
+
+  /// \brief Recomputes the global transforms of all objects with the same scalar code path that ezGameObject uses.
+  ///
+  /// Only meant for validation and comparison of the SIMD kernel.
+  void UpdateGlobalTransformsScalar();
+
+private:
+  typedef ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper> PacketArray;
+
+  /// Position, rotation and scale of four objects, one array per component.
+  struct TransformStreams
+  {
+    PacketArray m_PosX, m_PosY, m_PosZ;
+    PacketArray m_RotX, m_RotY, m_RotZ, m_RotW;
+    PacketArray m_ScaleX, m_ScaleY, m_ScaleZ;
+
+    void SetPacketCount(ezUInt32 uiCount);
+    void Set(ezUInt32 uiIndex, const ezSimdTransform& transform);
+    ezSimdTransform Get(ezUInt32 uiIndex) const;
+  };
+
+  struct HierarchyLevel
+  {
+    ezUInt32 m_uiCount = 0;
+    TransformStreams m_Local;
+    TransformStreams m_Global;
+    ezDynamicArray<ezUInt32> m_ParentIndices;
+  };
+
+  static void CopyLocalToGlobal(HierarchyLevel& level);
+  static void UpdateLevelWithParent(HierarchyLevel& level, const HierarchyLevel& parentLevel);
+
+  ezDynamicArray<HierarchyLevel> m_HierarchyLevels;
+};
@@ -11,6 +11,8 @@ class ezEventMessageHandlerComponent;
 /// in memory. Thus it is not allowed to store pointers to objects. They should be referenced by handles.\n The world has a multi-phase
 /// update mechanism which is divided in the following phases:\n
 /// * Pre-async phase: The corresponding component manager update functions are called synchronously in the order of their dependencies.
+///   Update functions that are flagged as concurrent and declare which shared data they access are executed in parallel on worker threads,
+///   if they neither depend on each other nor access the same data (see ezWorldModule::UpdateFunctionDesc::m_bConcurrent).
 /// * Async phase: The update functions are called in batches asynchronously on multiple threads. There is absolutely no guarantee in which
 /// order the functions are called.
 ///   Thus it is not allowed to access any data other than the components own data during that phase.
@@ -43,6 +45,13 @@ public:
   /// \brief Create a new game object from the given description, writes a pointer to it to out_pObject and returns a handle to it.
   ezGameObjectHandle CreateObject(const ezGameObjectDesc& desc, ezGameObject*& out_pObject);
 
+  /// \brief Creates multiple game objects at once, which is considerably faster than creating them one by one.
+  ///
+  /// \a parentIndices is either empty or contains one entry per object description. An entry that is not ezInvalidIndex is the index
+  /// of the parent object within \a descs, otherwise the parent is taken from ezGameObjectDesc::m_hParent. Parents have to come before
+  /// their children. Pointers to the new objects are written to \a out_objects, which must have the same size as \a descs.
+  void CreateObjects(ezArrayPtr<const ezGameObjectDesc> descs, ezArrayPtr<const ezUInt32> parentIndices, ezArrayPtr<ezGameObject*> out_objects);
+
   /// \brief Deletes the given object, its children and all components.
   /// \note This function deletes the object immediately! It is unsafe to use this during a game update loop, as other objects
   /// may rely on this object staying valid for the rest of the frame.
@@ -153,6 +162,17 @@ public:
   template <typename ComponentType>
   bool TryGetComponent(const ezComponentHandle& component, const ComponentType*& out_pComponent) const;
 
+  /// \brief Redirects all components that are created from now on into the given array, instead of initializing them during the next update.
+  ///
+  /// This allows to spread the initialization of many components over multiple frames, by passing them to InitializeComponents() piece by
+  /// piece. Pass nullptr to restore the default behavior. Every redirected component must be passed to InitializeComponents() eventually.
+  void SetComponentsToInitializeTarget(ezDynamicArray<ezComponentHandle>* pComponentsToInitialize);
+
+  /// \brief Initializes the given components immediately. Components that are active also get activated.
+  ///
+  /// \sa SetComponentsToInitializeTarget()
+  void InitializeComponents(ezArrayPtr<const ezComponentHandle> components);
+
   ///@}
   /// \name Message Functions
   ///@{
@@ -200,6 +220,28 @@ public:
   /// \brief Returns a task implementation that calls Update on this world.
   ezTask* GetUpdateTask();
 
+  /// \brief Switches the world to fixed step simulation. Pass a zero time step to go back to variable time steps.
+  ///
+  /// In fixed step mode every simulation step advances the world clock by exactly \a tStep (scaled by the clock speed).
+  /// Update() accumulates the real time that has passed and runs as many steps as fit into it, at most \a uiMaxStepsPerUpdate.
+  /// If more time has passed, the remainder is dropped, so a slow frame does not lead to ever more steps in the following frames.
+  /// Frames in which not enough time has accumulated for a single step don't update the world at all.
+  void SetFixedTimeStep(ezTime tStep, ezUInt32 uiMaxStepsPerUpdate = 4);
+
+  /// \brief Returns the fixed time step or zero if the world uses variable time steps.
+  ezTime GetFixedTimeStep() const;
+
+  /// \brief Runs exactly \a uiNumSteps fixed simulation steps, independent of how much real time has passed.
+  ///
+  /// Together with ezWorldSnapshot this allows to roll the simulation back and re-simulate it deterministically.
+  /// Fixed step mode must be enabled.
+  void UpdateFixedSteps(ezUInt32 uiNumSteps);
+
+  /// \brief Returns how far the accumulated real time has progressed into the next fixed step, in the range [0; 1).
+  ///
+  /// Can be used to interpolate between the last two simulation states for rendering.
+  float GetFixedStepInterpolation() const;
+
 
   /// \brief Returns the spatial system that is associated with this world.
   ezSpatialSystem* GetSpatialSystem();
@@ -250,6 +292,12 @@ public:
   /// \brief Mark the world for writing by using EZ_LOCK(world.GetWriteMarker()). Only one thread can write at a time.
   ezInternal::WorldData::WriteMarker& GetWriteMarker();
 
+  /// \brief Asserts that the concurrent update function which is currently executed on this thread has declared access to the given data.
+  ///
+  /// Modules call this wherever they access data that is shared with other update functions, e.g. a physics scene. It only has an effect
+  /// while a concurrent update function is running and ezWorldDesc::m_bValidateUpdateFunctionAccess is enabled.
+  void CheckForDataAccess(const ezTempHashedString& sDataName, bool bWrite) const;
+
 
   /// \brief Associates the given user data with the world. The user is responsible for the life time of user data.
   void SetUserData(void* pUserData);
@@ -269,6 +317,8 @@ public:
 
 public:
   /// \brief Returns the number of active worlds.
+  ///
+  /// Not synchronized with worlds that are created or destroyed on other threads at the same time.
   static ezUInt32 GetWorldCount();
 
   /// \brief Returns the world with the given index.
@@ -279,6 +329,7 @@ private:
   friend class ezWorldModule;
   friend class ezComponentManagerBase;
   friend class ezComponent;
+  friend class ezWorldSnapshot;
 
   void CheckForReadAccess() const;
   void CheckForWriteAccess() const;
@@ -297,10 +348,17 @@ private:
   void SetObjectGlobalKey(ezGameObject* pObject, const ezHashedString& sGlobalKey);
   const char* GetObjectGlobalKey(const ezGameObject* pObject) const;
 
+  ezGameObject* CreateObjectInternal(const ezGameObjectDesc& desc, ezGameObject* pParentObject);
+
   void PostMessage(const ezGameObjectHandle& receiverObject, const ezMessage& msg, ezObjectMsgQueueType::Enum queueType, ezTime delay, bool bRecursive) const;
   void ProcessQueuedMessage(const ezInternal::WorldData::MessageQueue::Entry& entry);
   void ProcessQueuedMessages(ezObjectMsgQueueType::Enum queueType);
 
+  template <typename Container>
+  void DispatchSortedMessages(const Container& messages);
+  void DispatchMessagesInParallel();
+  bool IsParallelDispatchMessage(const ezInternal::WorldData::MessageQueue::Entry& entry);
+
   void RegisterUpdateFunction(const ezWorldModule::UpdateFunctionDesc& desc);
   void DeregisterUpdateFunction(const ezWorldModule::UpdateFunctionDesc& desc);
   void DeregisterUpdateFunctions(ezWorldModule* pModule);
@@ -309,10 +367,12 @@ private:
   void AddComponentToInitialize(ezComponentHandle hComponent);
 
   void UpdateFromThread();
-  void UpdateSynchronous(const ezArrayPtr<ezInternal::WorldData::RegisteredUpdateFunction>& updateFunctions);
+  void UpdateStep();
+  void UpdateSynchronous(ezWorldModule::UpdateFunctionDesc::Phase::Enum phase);
   void UpdateAsynchronous();
 
   void ProcessComponentsToInitialize();
+  void InitializeComponent(const ezComponentHandle& hComponent);
   void ProcessUpdateFunctionsToRegister();
   ezResult RegisterUpdateFunctionInternal(const ezWorldModule::UpdateFunctionDesc& desc);
 
@@ -2,6 +2,7 @@
 
 #include <Foundation/Strings/HashedString.h>
 #include <Foundation/Types/SharedPtr.h>
+#include <Foundation/Time/Time.h>
 #include <Foundation/Types/UniquePtr.h>
 
 #include <Core/World/CoordinateSystem.h>
@@ -29,4 +30,18 @@ struct ezWorldDesc
   ezUniquePtr<ezTimeStepSmoothing> m_pTimeStepSmoothing; ///< if nullptr, ezDefaultTimeStepSmoothing will be used
 
   bool m_bReportErrorWhenStaticObjectMoves = true;
+
+  /// \brief Checks that concurrent update functions only access the world and shared data as declared in their update function description.
+  /// See ezWorldModule::UpdateFunctionDesc::m_bConcurrent and ezWorld::CheckForDataAccess().
+  bool m_bValidateUpdateFunctionAccess = EZ_ENABLED(EZ_COMPILE_FOR_DEBUG);
+
+  /// \brief Dispatches queued messages whose type has the ezParallelMessageDispatchAttribute on multiple threads, partitioned by receiver
+  /// object. Messages of all other types are still dispatched on the main thread in the usual order.
+  bool m_bParallelMessageDispatch = false;
+
+  /// \brief If not zero, the world is simulated in steps of exactly this length, see ezWorld::SetFixedTimeStep().
+  ezTime m_FixedTimeStep;
+
+  /// \brief The maximum number of fixed steps that a single ezWorld::Update() runs to catch up with real time.
+  ezUInt32 m_uiMaxFixedStepsPerUpdate = 4;
 };
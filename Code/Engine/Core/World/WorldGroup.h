@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Core/CoreDLL.h>
+#include <Foundation/Containers/HybridArray.h>
+#include <Foundation/Threading/TaskSystem.h>
+
+class ezWorld;
+
+/// \brief Updates a set of independent worlds concurrently, each world as its own task.
+///
+/// Every world only runs its own update, under its own write marker, so worlds in the same group must not access each other during
+/// their update. Any other state that components of different worlds share has to be thread-safe:
+///  * Resources are loaded through ezResourceManager, which is thread-safe. ezResourceManager::PerFrameUpdate() however is not part of the
+///    world update and has to be called once per frame, outside of the group update.
+///  * The same goes for ezFrameAllocator::Swap() and ezRenderWorld view extraction. Extraction takes the read marker of the worlds and
+///    therefore has to happen after WaitForUpdate() has returned.
+///  * Allocations from ezFrameAllocator and stats are thread-safe.
+///  * Creating and destroying worlds is synchronized, but ezWorld::GetWorldCount() and ezWorld::GetWorld() are not. Don't iterate over
+///    all worlds while a group update is in progress.
+///  * Every instantiation of an ezPrefabResource uses its own ezWorldReader, so the same prefab can be instantiated in several worlds
+///    at once. A single ezWorldReader however must only be used by one thread at a time.
+///  * Custom component managers and resources that keep global state have to protect it themselves.
+///
+/// The group does not take ownership of the worlds. A world has to be removed from the group before it is destroyed.
+class EZ_CORE_DLL ezWorldGroup
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezWorldGroup);
+
+public:
+  ezWorldGroup();
+  ~ezWorldGroup();
+
+  /// \brief Adds the given world to the group. Does nothing if the world is already part of the group.
+  void AddWorld(ezWorld* pWorld);
+
+  /// \brief Removes the given world from the group. Must not be called while an update is in progress.
+  void RemoveWorld(ezWorld* pWorld);
+
+  /// \brief Removes all worlds from the group.
+  void Clear();
+
+  ezUInt32 GetWorldCount() const { return m_Worlds.GetCount(); }
+  ezWorld* GetWorld(ezUInt32 uiIndex) const { return m_Worlds[uiIndex]; }
+
+  /// \brief Starts updating all worlds as parallel tasks and returns immediately.
+  ///
+  /// The worlds must not be accessed by anyone else until WaitForUpdate() has returned. Each world task acquires the write marker of its
+  /// world, so no other thread may hold a read or write marker of any world in the group at this point.
+  void StartUpdate(ezTaskPriority::Enum priority = ezTaskPriority::EarlyThisFrame);
+
+  /// \brief Waits until all world updates that have been started by StartUpdate() are finished.
+  void WaitForUpdate();
+
+  /// \brief Updates all worlds in parallel and waits for them to finish.
+  void Update();
+
+  /// \brief Whether StartUpdate() was called without a matching WaitForUpdate().
+  bool IsUpdateInProgress() const { return m_UpdateTaskGroup.IsValid(); }
+
+private:
+  ezHybridArray<ezWorld*, 16> m_Worlds;
+  ezTaskGroupID m_UpdateTaskGroup;
+};
@@ -65,6 +65,7 @@ protected:
       m_bOnlyUpdateWhenSimulating = false;
       m_uiGranularity = 0;
       m_fPriority = 0.0f;
+      m_bConcurrent = false;
     }
 
     UpdateFunction m_Function;      ///< Delegate to the actual update function.
@@ -78,6 +79,14 @@ protected:
     ezUInt16 m_uiGranularity; ///< The granularity in which batch updates should happen during the asynchronous phase. Has to be 0 for
                               ///< synchronous functions.
     float m_fPriority; ///< Higher priority (higher number) means that this function is called earlier than a function with lower priority.
+
+    bool m_bConcurrent; ///< Opt-in for synchronous phases: The function may run on a worker thread, concurrently with other concurrent functions
+                        ///< of the same phase, as long as neither depends on the other and their declared data access does not conflict.
+                        ///< Such a function must not modify the world itself (create or delete objects etc.). The data of the own module is
+                        ///< always treated as written.
+    ezHybridArray<ezHashedString, 2> m_ReadAccess;  ///< Names of the shared data that a concurrent function reads, e.g. the type name of
+                                                    ///< another module. See ezWorld::CheckForDataAccess().
+    ezHybridArray<ezHashedString, 2> m_WriteAccess; ///< Names of the shared data that a concurrent function modifies.
   };
 
   /// \brief Registers the given update function at the world.
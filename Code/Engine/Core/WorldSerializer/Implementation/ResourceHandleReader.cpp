@@ -2,6 +2,7 @@
 
 #include <Core/ResourceManager/ResourceManager.h>
 #include <Core/WorldSerializer/ResourceHandleReader.h>
+#include <Foundation/Threading/Lock.h>
 
 static thread_local ezResourceHandleReadContext* s_pActiveReadContext = nullptr;
 
@@ -19,6 +20,7 @@ void ezResourceHandleReadContext::Reset()
 {
   m_uiVersion = 0;
   m_bReadData = false;
+  m_pPreviousActiveContext = nullptr;
   m_StoredHandles.Clear();
   m_AllResources.Clear();
 }
@@ -48,6 +50,8 @@ void ezResourceHandleReadContext::ReadResourceReference(ezStreamReader* pStream,
 
   if (uiID != 0xFFFFFFFF)
   {
+    EZ_LOCK(m_StoredHandlesMutex);
+
     auto& hd = m_StoredHandles.ExpandAndGetRef();
     hd.m_pHandle = pResourceHandle;
     hd.m_uiResourceID = uiID;
@@ -60,7 +64,10 @@ void ezResourceHandleReadContext::ReadResourceReference(ezStreamReader* pStream,
 
 void ezResourceHandleReadContext::BeginRestoringHandles(ezStreamReader* pStream)
 {
-  EZ_ASSERT_DEV(s_pActiveReadContext == nullptr, "Instances of ezResourceHandleReadContext cannot be nested on the callstack");
+  EZ_ASSERT_DEV(s_pActiveReadContext != this, "ezResourceHandleReadContext::BeginRestoringHandles() cannot be called twice");
+
+  // a worker thread may pick up a task that reads another world while it is waiting for its own tasks
+  m_pPreviousActiveContext = s_pActiveReadContext;
   s_pActiveReadContext = this;
 
   EZ_ASSERT_DEV(
@@ -84,7 +91,24 @@ void ezResourceHandleReadContext::EndRestoringHandles()
 
   m_StoredHandles.Clear();
 
-  s_pActiveReadContext = nullptr;
+  s_pActiveReadContext = m_pPreviousActiveContext;
+  m_pPreviousActiveContext = nullptr;
+}
+
+ezResourceHandleReadContext* ezResourceHandleReadContext::ActivateOnThisThread()
+{
+  EZ_ASSERT_DEV(m_bReadData, "ezResourceHandleReadContext::ActivateOnThisThread must be called after ezResourceHandleReadContext::EndReadingFromStream");
+
+  ezResourceHandleReadContext* pPreviousContext = s_pActiveReadContext;
+  s_pActiveReadContext = this;
+  return pPreviousContext;
+}
+
+void ezResourceHandleReadContext::DeactivateOnThisThread(ezResourceHandleReadContext* pPreviousContext)
+{
+  EZ_ASSERT_DEV(s_pActiveReadContext == this, "Incorrect usage of ezResourceHandleReadContext::ActivateOnThisThread / DeactivateOnThisThread");
+
+  s_pActiveReadContext = pPreviousContext;
 }
 
 void ezResourceHandleReadContext::BeginReadingFromStream(ezStreamReader* pStream)
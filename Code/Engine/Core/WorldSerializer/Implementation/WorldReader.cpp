@@ -1,6 +1,13 @@
 #include <CorePCH.h>
 
 #include <Core/WorldSerializer/WorldReader.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/Lock.h>
+#include <Foundation/Threading/TaskSystem.h>
+
+// set while a worker thread deserializes components, see ezWorldReader::DeserializeComponentsInParallel()
+static thread_local const ezWorldReader* s_pWorkerReader = nullptr;
+static thread_local ezStreamReader* s_pWorkerStream = nullptr;
 
 ezWorldReader::ezWorldReader()
 {
@@ -8,6 +15,7 @@ ezWorldReader::ezWorldReader()
   m_pWorld = nullptr;
   m_uiMaxComponents = 0;
   m_uiVersion = 0;
+  m_bReadRawHandles = false;
 }
 
 void ezWorldReader::ReadWorldDescription(ezStreamReader& stream)
@@ -19,7 +27,7 @@ void ezWorldReader::ReadWorldDescription(ezStreamReader& stream)
   m_uiVersion = 0;
   stream >> m_uiVersion;
 
-  EZ_ASSERT_DEV(m_uiVersion <= 7, "Invalid version {0}", m_uiVersion);
+  EZ_ASSERT_DEV(m_uiVersion <= 8, "Invalid version {0}", m_uiVersion);
 
   if (m_uiVersion >= 3)
   {
@@ -116,16 +124,20 @@ void ezWorldReader::Instantiate(ezWorld& world, bool bUseTransform, const ezTran
 
   EZ_LOCK(m_pWorld->GetWriteMarker());
 
-  if (bUseTransform)
-  {
-    CreateGameObjects(m_RootObjectsToCreate, rootTransform, hParent, out_CreatedRootObjects, pOverrideTeamID, bForceDynamic);
-  }
-  else
   {
-    CreateGameObjects(m_RootObjectsToCreate, hParent, out_CreatedRootObjects, pOverrideTeamID, bForceDynamic);
-  }
+    EZ_PROFILE_SCOPE("Create Game Objects");
 
-  CreateGameObjects(m_ChildObjectsToCreate, ezGameObjectHandle(), out_CreatedChildObjects, pOverrideTeamID, bForceDynamic);
+    if (bUseTransform)
+    {
+      CreateGameObjects(m_RootObjectsToCreate, rootTransform, hParent, out_CreatedRootObjects, pOverrideTeamID, bForceDynamic);
+    }
+    else
+    {
+      CreateGameObjects(m_RootObjectsToCreate, hParent, out_CreatedRootObjects, pOverrideTeamID, bForceDynamic);
+    }
+
+    CreateGameObjects(m_ChildObjectsToCreate, ezGameObjectHandle(), out_CreatedChildObjects, pOverrideTeamID, bForceDynamic);
+  }
 
   // read component data from copied memory stream
   if (m_ComponentStream.GetStorageSize() > 0)
@@ -136,37 +148,84 @@ void ezWorldReader::Instantiate(ezWorld& world, bool bUseTransform, const ezTran
 
     m_HandleReadContext.BeginRestoringHandles(m_pStream);
 
-    for (ezUInt32 i = 0; i < m_ComponentTypes.GetCount(); ++i)
     {
-      ReadComponentsOfType(i);
+      EZ_PROFILE_SCOPE("Create Components");
+
+      for (ezUInt32 i = 0; i < m_ComponentTypes.GetCount(); ++i)
+      {
+        ReadComponentsOfType(memReader, i);
+      }
     }
 
+    DeserializeComponentsInParallel();
+
     m_HandleReadContext.EndRestoringHandles();
 
     m_pStream = pPrevReader;
   }
 
-  FulfillComponentHandleRequets();
+  {
+    EZ_PROFILE_SCOPE("Fulfill Component Handles");
+
+    FulfillComponentHandleRequets();
+  }
+}
+
+ezUniquePtr<ezWorldReader::InstantiationContext> ezWorldReader::InstantiateWorldTimeSliced(ezWorld& world, const ezUInt16* pOverrideTeamID, ezTime maxStepTime)
+{
+  return EZ_DEFAULT_NEW(InstantiationContext, *this, world, false, ezTransform(), ezGameObjectHandle(), pOverrideTeamID, false, maxStepTime);
+}
+
+ezUniquePtr<ezWorldReader::InstantiationContext> ezWorldReader::InstantiatePrefabTimeSliced(ezWorld& world, const ezTransform& rootTransform,
+  ezGameObjectHandle hParent, const ezUInt16* pOverrideTeamID, bool bForceDynamic, ezTime maxStepTime)
+{
+  return EZ_DEFAULT_NEW(InstantiationContext, *this, world, true, rootTransform, hParent, pOverrideTeamID, bForceDynamic, maxStepTime);
+}
+
+ezStreamReader& ezWorldReader::GetStream() const
+{
+  if (s_pWorkerReader == this)
+    return *s_pWorkerStream;
+
+  return *m_pStream;
 }
 
 
 ezGameObjectHandle ezWorldReader::ReadGameObjectHandle()
 {
+  if (m_bReadRawHandles)
+  {
+    ezGameObjectId id;
+    GetStream() >> id.m_Data;
+    return ezGameObjectHandle(id);
+  }
+
   ezUInt32 idx = 0;
-  *m_pStream >> idx;
+  GetStream() >> idx;
 
   return m_IndexToGameObjectHandle[idx];
 }
 
 void ezWorldReader::ReadComponentHandle(ezComponentHandle* out_hComponent)
 {
+  if (m_bReadRawHandles)
+  {
+    ezComponentId id;
+    GetStream() >> id.m_Data;
+    GetStream() >> id.m_TypeId;
+    GetStream() >> id.m_WorldIndex;
+    *out_hComponent = ezComponentHandle(id);
+    return;
+  }
+
   ezUInt32 idx = 0;
-  *m_pStream >> idx;
+  GetStream() >> idx;
 
   CompRequest r;
   r.m_pWriteToComponent = out_hComponent;
   r.m_uiComponentIndex = idx;
 
+  EZ_LOCK(m_ComponentHandleRequestsMutex);
   m_ComponentHandleRequests.PushBack(r);
 }
 
@@ -197,6 +256,9 @@ void ezWorldReader::ClearAndCompact()
   m_ComponentHandleRequests.Clear();
   m_ComponentHandleRequests.Compact();
 
+  m_ComponentsToDeserialize.Clear();
+  m_ComponentsToDeserialize.Compact();
+
   m_ComponentTypes.Clear();
   m_ComponentTypes.Compact();
 
@@ -212,7 +274,7 @@ ezUInt64 ezWorldReader::GetHeapMemoryUsage() const
 {
   return m_IndexToGameObjectHandle.GetHeapMemoryUsage() + m_IndexToComponentHandle.GetHeapMemoryUsage() +
          m_RootObjectsToCreate.GetHeapMemoryUsage() + m_ChildObjectsToCreate.GetHeapMemoryUsage() +
-         m_ComponentHandleRequests.GetHeapMemoryUsage() + m_ComponentTypes.GetHeapMemoryUsage() +
+         m_ComponentHandleRequests.GetHeapMemoryUsage() + m_ComponentsToDeserialize.GetHeapMemoryUsage() + m_ComponentTypes.GetHeapMemoryUsage() +
          m_ComponentTypeVersions.GetHeapMemoryUsage() + m_ComponentStream.GetHeapMemoryUsage();
 }
 
@@ -271,85 +333,170 @@ void ezWorldReader::ReadComponentInfo(ezUInt32 uiComponentTypeIdx)
   m_ComponentTypeVersions[pRtti] = uiRttiVersion;
 }
 
-void ezWorldReader::ReadComponentsOfType(ezUInt32 uiComponentTypeIdx)
+ezComponentManagerBase* ezWorldReader::ReadComponentTypeHeader(ezUInt32 uiComponentTypeIdx, ezUInt32& out_uiNumComponents)
 {
   ezStreamReader& s = *m_pStream;
 
+  out_uiNumComponents = 0;
+
   ezUInt32 uiAllComponentsSize = 0;
   s >> uiAllComponentsSize;
 
-  bool bSkip = false;
-
-  ezComponentManagerBase* pManager = nullptr;
   const ezRTTI* pRtti = m_ComponentTypes[uiComponentTypeIdx];
 
   if (pRtti == nullptr)
   {
-    bSkip = true;
     ezLog::Warning("Skipping components of unknown type");
+
+    m_pStream->SkipBytes(uiAllComponentsSize);
+    return nullptr;
   }
-  else
+
+  ezComponentManagerBase* pManager = m_pWorld->GetOrCreateManagerForComponentType(pRtti);
+
+  s >> out_uiNumComponents;
+
+  // will be the case for all abstract component types
+  if (out_uiNumComponents == 0)
+    return nullptr;
+
+  // only check this after we know that we actually need to create any of this type
+  EZ_ASSERT_DEV(pManager != nullptr, "Cannot create components of type '{0}', manager is not available.", pRtti->GetTypeName());
+
+  return pManager;
+}
+
+ezComponent* ezWorldReader::ReadAndCreateComponent(ezComponentManagerBase* pManager, ezUInt32& out_uiDataSize)
+{
+  const ezGameObjectHandle hOwner = ReadGameObjectHandle();
+
+  ezUInt32 uiComponentIdx = 0;
+  *m_pStream >> uiComponentIdx;
+
+  bool bActive = true;
+  *m_pStream >> bActive;
+
+  if (m_uiVersion <= 4)
   {
-    pManager = m_pWorld->GetOrCreateManagerForComponentType(pRtti);
+    bool bDynamic = true;
+    *m_pStream >> bDynamic;
   }
 
-  if (bSkip)
+  ezUInt8 userFlags = 0;
+  if (m_uiVersion >= 7)
   {
-    m_pStream->SkipBytes(uiAllComponentsSize);
+    *m_pStream >> userFlags;
   }
-  else
+
+  out_uiDataSize = 0;
+  if (m_uiVersion >= 8)
   {
-    ezUInt32 uiNumComponents = 0;
-    s >> uiNumComponents;
+    *m_pStream >> out_uiDataSize;
+  }
 
-    // will be the case for all abstract component types
-    if (uiNumComponents == 0)
-      return;
+  ezGameObject* pParentObject = nullptr;
+  m_pWorld->TryGetObject(hOwner, pParentObject);
 
-    // only check this after we know that we actually need to create any of this type
-    EZ_ASSERT_DEV(pManager != nullptr, "Cannot create components of type '{0}', manager is not available.", pRtti->GetTypeName());
+  ezComponent* pComponent = nullptr;
+  auto hComponent = pManager->CreateComponent(pParentObject, pComponent);
+  m_IndexToComponentHandle[uiComponentIdx] = hComponent;
 
-    for (ezUInt32 i = 0; i < uiNumComponents; ++i)
-    {
-      const ezGameObjectHandle hOwner = ReadGameObjectHandle();
+  pComponent->SetActiveFlag(bActive);
+
+  for (ezUInt8 j = 0; j < 8; ++j)
+  {
+    pComponent->SetUserFlag(j, (userFlags & EZ_BIT(j)) != 0);
+  }
 
-      ezUInt32 uiComponentIdx = 0;
-      *m_pStream >> uiComponentIdx;
+  return pComponent;
+}
 
-      bool bActive = true;
-      *m_pStream >> bActive;
+void ezWorldReader::ReadComponentsOfType(ezMemoryStreamReader& memReader, ezUInt32 uiComponentTypeIdx)
+{
+  ezUInt32 uiNumComponents = 0;
+  ezComponentManagerBase* pManager = ReadComponentTypeHeader(uiComponentTypeIdx, uiNumComponents);
 
-      if (m_uiVersion <= 4)
-      {
-        bool bDynamic = true;
-        *m_pStream >> bDynamic;
-      }
+  if (pManager == nullptr)
+    return;
 
-      ezUInt8 userFlags = 0;
-      if (m_uiVersion >= 7)
+  // since version 8 the size of each component is known, which allows to deserialize the component data later on another thread
+  const ezRTTI* pRtti = m_ComponentTypes[uiComponentTypeIdx];
+  // only the attributes of the type itself are checked, a derived type may access the world in its DeserializeComponent()
+  bool bDeserializeInParallel = false;
+  if (m_uiVersion >= 8)
+  {
+    for (const ezPropertyAttribute* pAttribute : pRtti->GetAttributes())
+    {
+      if (pAttribute->IsInstanceOf<ezParallelDeserializationAttribute>())
       {
-        *m_pStream >> userFlags;
+        bDeserializeInParallel = true;
+        break;
       }
+    }
+  }
 
-      ezGameObject* pParentObject = nullptr;
-      m_pWorld->TryGetObject(hOwner, pParentObject);
-
-      ezComponent* pComponent = nullptr;
-      auto hComponent = pManager->CreateComponent(pParentObject, pComponent);
-      m_IndexToComponentHandle[uiComponentIdx] = hComponent;
+  for (ezUInt32 i = 0; i < uiNumComponents; ++i)
+  {
+    ezUInt32 uiComponentSize = 0;
+    ezComponent* pComponent = ReadAndCreateComponent(pManager, uiComponentSize);
 
-      pComponent->SetActiveFlag(bActive);
-
-      for (ezUInt8 j = 0; j < 8; ++j)
-      {
-        pComponent->SetUserFlag(j, (userFlags & EZ_BIT(j)) != 0);
-      }
+    const ezUInt32 uiDataOffset = memReader.GetReadPosition();
 
+    if (bDeserializeInParallel)
+    {
+      auto& componentToDeserialize = m_ComponentsToDeserialize.ExpandAndGetRef();
+      componentToDeserialize.m_pComponent = pComponent;
+      componentToDeserialize.m_uiDataOffset = uiDataOffset;
+      componentToDeserialize.m_uiDataSize = uiComponentSize;
+    }
+    else
+    {
       pComponent->DeserializeComponent(*this);
     }
+
+    if (m_uiVersion >= 8)
+    {
+      // also skips data that an older version of the component did not read
+      memReader.SetReadPosition(uiDataOffset + uiComponentSize);
+    }
   }
 }
 
+void ezWorldReader::DeserializeComponentsInParallel()
+{
+  if (m_ComponentsToDeserialize.IsEmpty())
+    return;
+
+  EZ_PROFILE_SCOPE("Deserialize Components");
+
+  const ezUInt8* pComponentData = m_ComponentStream.GetData();
+
+  ezTaskSystem::ParallelFor(m_ComponentsToDeserialize.GetArrayPtr(), [this, pComponentData](ezArrayPtr<ComponentToDeserialize> components) {
+    // the calling thread already has the handle context activated, all other threads need to do it themselves
+    ezResourceHandleReadContext* pPrevHandleContext = m_HandleReadContext.ActivateOnThisThread();
+
+    ezRawMemoryStreamReader componentReader;
+
+    const ezWorldReader* pPrevWorkerReader = s_pWorkerReader;
+    ezStreamReader* pPrevWorkerStream = s_pWorkerStream;
+    s_pWorkerReader = this;
+    s_pWorkerStream = &componentReader;
+
+    for (const auto& componentToDeserialize : components)
+    {
+      componentReader.Reset(pComponentData + componentToDeserialize.m_uiDataOffset, componentToDeserialize.m_uiDataSize);
+      componentToDeserialize.m_pComponent->DeserializeComponent(*this);
+    }
+
+    s_pWorkerReader = pPrevWorkerReader;
+    s_pWorkerStream = pPrevWorkerStream;
+
+    m_HandleReadContext.DeactivateOnThisThread(pPrevHandleContext);
+  }, "DeserializeComponents");
+
+  m_ComponentsToDeserialize.Clear();
+}
+
 void ezWorldReader::FulfillComponentHandleRequets()
 {
   for (const auto& req : m_ComponentHandleRequests)
@@ -360,56 +507,67 @@ void ezWorldReader::FulfillComponentHandleRequets()
   m_ComponentHandleRequests.Clear();
 }
 
-void ezWorldReader::CreateGameObjects(const ezDynamicArray<GameObjectToCreate>& objects, ezGameObjectHandle hParent,
+void ezWorldReader::CreateGameObjects(ezArrayPtr<const GameObjectToCreate> objects, ezGameObjectHandle hParent,
   ezHybridArray<ezGameObject*, 8>* out_CreatedObjects, const ezUInt16* pOverrideTeamID, bool bForceDynamic)
 {
-  if (hParent.IsInvalidated())
+  const ezUInt32 uiNumObjects = objects.GetCount();
+  const ezUInt32 uiFirstHandleIdx = m_IndexToGameObjectHandle.GetCount();
+
+  ezDynamicArray<ezGameObjectDesc> descs;
+  descs.SetCount(uiNumObjects);
+
+  ezDynamicArray<ezUInt32> parentIndices;
+  parentIndices.SetCountUninitialized(uiNumObjects);
+
+  for (ezUInt32 i = 0; i < uiNumObjects; ++i)
   {
-    for (const auto& godesc : objects)
-    {
-      ezGameObjectDesc desc = godesc.m_Desc; // make a copy
-      desc.m_hParent = m_IndexToGameObjectHandle[godesc.m_uiParentHandleIdx];
-      desc.m_bDynamic |= bForceDynamic;
+    const auto& godesc = objects[i];
 
-      if (pOverrideTeamID != nullptr)
-        desc.m_uiTeamID = *pOverrideTeamID;
+    ezGameObjectDesc& desc = descs[i];
+    desc = godesc.m_Desc; // make a copy
+    desc.m_bDynamic |= bForceDynamic;
 
-      ezGameObject* pObject;
-      m_IndexToGameObjectHandle.PushBack(m_pWorld->CreateObject(desc, pObject));
+    parentIndices[i] = ezInvalidIndex;
 
-      if (!godesc.m_sGlobalKey.IsEmpty())
-      {
-        pObject->SetGlobalKey(godesc.m_sGlobalKey);
-      }
+    if (hParent.IsInvalidated())
+    {
+      // parents that are created in the same batch are referenced by index, since they don't have a handle yet
+      if (godesc.m_uiParentHandleIdx >= uiFirstHandleIdx)
+        parentIndices[i] = godesc.m_uiParentHandleIdx - uiFirstHandleIdx;
+      else
+        desc.m_hParent = m_IndexToGameObjectHandle[godesc.m_uiParentHandleIdx];
 
-      if (out_CreatedObjects)
-        out_CreatedObjects->PushBack(pObject);
+      if (pOverrideTeamID != nullptr)
+        desc.m_uiTeamID = *pOverrideTeamID;
     }
-  }
-  else
-  {
-    for (const auto& godesc : objects)
+    else
     {
-      ezGameObjectDesc desc = godesc.m_Desc; // make a copy
       desc.m_hParent = hParent;
-      desc.m_bDynamic |= bForceDynamic;
+    }
+  }
 
-      ezGameObject* pObject;
-      m_IndexToGameObjectHandle.PushBack(m_pWorld->CreateObject(desc, pObject));
+  ezDynamicArray<ezGameObject*> createdObjects;
+  createdObjects.SetCountUninitialized(uiNumObjects);
 
-      if (!godesc.m_sGlobalKey.IsEmpty())
-      {
-        pObject->SetGlobalKey(godesc.m_sGlobalKey);
-      }
+  m_pWorld->CreateObjects(descs, parentIndices, createdObjects);
+
+  for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+  {
+    ezGameObject* pObject = createdObjects[i];
+    m_IndexToGameObjectHandle.PushBack(pObject->GetHandle());
 
-      if (out_CreatedObjects)
-        out_CreatedObjects->PushBack(pObject);
+    if (!objects[i].m_sGlobalKey.IsEmpty())
+    {
+      pObject->SetGlobalKey(objects[i].m_sGlobalKey);
     }
+
+    if (out_CreatedObjects)
+      out_CreatedObjects->PushBack(pObject);
   }
 }
 
 
-void ezWorldReader::CreateGameObjects(const ezDynamicArray<GameObjectToCreate>& objects, const ezTransform& rootTransform,
+void ezWorldReader::CreateGameObjects(ezArrayPtr<const GameObjectToCreate> objects, const ezTransform& rootTransform,
   ezGameObjectHandle hParent, ezHybridArray<ezGameObject*, 8>* out_CreatedRootObjects,
   const ezUInt16* pOverrideTeamID, bool bForceDynamic)
 {
@@ -444,4 +602,390 @@ void ezWorldReader::CreateGameObjects(const ezDynamicArray<GameObjectToCreate>&
   }
 }
 
+//////////////////////////////////////////////////////////////////////////
+
+namespace
+{
+  // the time budget is checked after each chunk
+  constexpr ezUInt32 RootObjectsPerChunk = 8;
+  constexpr ezUInt32 ChildObjectsPerChunk = 32;
+  constexpr ezUInt32 ComponentsPerChunk = 8;
+} // namespace
+
+ezWorldReader::InstantiationContext::InstantiationContext(ezWorldReader& worldReader, ezWorld& world, bool bUseTransform,
+  const ezTransform& rootTransform, ezGameObjectHandle hParent, const ezUInt16* pOverrideTeamID, bool bForceDynamic, ezTime maxStepTime)
+  : m_WorldReader(worldReader)
+  , m_World(world)
+  , m_bUseTransform(bUseTransform)
+  , m_bOverrideTeamID(pOverrideTeamID != nullptr)
+  , m_bForceDynamic(bForceDynamic)
+  , m_uiOverrideTeamID(pOverrideTeamID != nullptr ? *pOverrideTeamID : 0)
+  , m_RootTransform(rootTransform)
+  , m_hParent(hParent)
+  , m_MaxStepTime(maxStepTime)
+{
+  const ezUInt32 uiNumObjects = worldReader.m_RootObjectsToCreate.GetCount() + worldReader.m_ChildObjectsToCreate.GetCount();
+
+  // components are created, deserialized and initialized
+  m_uiTotalWork = uiNumObjects + worldReader.m_uiMaxComponents * 3;
+
+  m_IndexToGameObjectHandle.Reserve(uiNumObjects + 1);
+  m_IndexToGameObjectHandle.PushBack(ezGameObjectHandle());
+  m_IndexToComponentHandle.SetCount(worldReader.m_uiMaxComponents + 1); // initialize with 'invalid' handles to be able to skip unknown components
+}
+
+ezWorldReader::InstantiationContext::~InstantiationContext() = default;
+
+void ezWorldReader::InstantiationContext::TakeOwnershipOfWorldReader(ezUniquePtr<ezWorldReader>&& pWorldReader)
+{
+  EZ_ASSERT_DEV(pWorldReader.Borrow() == &m_WorldReader, "The context can only own the world reader that it instantiates from");
+
+  m_pOwnedWorldReader = std::move(pWorldReader);
+}
+
+bool ezWorldReader::InstantiationContext::Step()
+{
+  if (m_Phase == Phase::Finished)
+    return true;
+
+  EZ_PROFILE_SCOPE("Instantiate Time Sliced");
+
+  const ezTime endTime = ezTime::Now() + m_MaxStepTime;
+
+  EZ_LOCK(m_World.GetWriteMarker());
+
+  // the world reader looks up handles in these arrays while components are created and deserialized
+  ezWorldReader& reader = m_WorldReader;
+  reader.m_pWorld = &m_World;
+  reader.m_IndexToGameObjectHandle.Swap(m_IndexToGameObjectHandle);
+  reader.m_IndexToComponentHandle.Swap(m_IndexToComponentHandle);
+
+  do
+  {
+    switch (m_Phase)
+    {
+      case Phase::CreateRootObjects:
+        CreateRootObjects(endTime);
+        break;
+      case Phase::CreateChildObjects:
+        CreateChildObjects(endTime);
+        break;
+      case Phase::CreateComponents:
+        CreateComponents(endTime);
+        break;
+      case Phase::DeserializeComponents:
+        DeserializeComponents(endTime);
+        break;
+      case Phase::InitializeComponents:
+        InitializeComponents(endTime);
+        break;
+      default:
+        EZ_ASSERT_NOT_IMPLEMENTED;
+        break;
+    }
+  } while (m_Phase != Phase::Finished && !IsOutOfTime(endTime));
+
+  reader.m_IndexToGameObjectHandle.Swap(m_IndexToGameObjectHandle);
+  reader.m_IndexToComponentHandle.Swap(m_IndexToComponentHandle);
+
+  if (m_Phase == Phase::Finished)
+  {
+    m_IndexToGameObjectHandle.Clear();
+    m_IndexToComponentHandle.Clear();
+    return true;
+  }
+
+  return false;
+}
+
+void ezWorldReader::InstantiationContext::Cancel()
+{
+  if (m_Phase == Phase::Finished)
+    return;
+
+  EZ_LOCK(m_World.GetWriteMarker());
+
+  // deleting the root objects also deletes all children and their not yet initialized components
+  for (const ezGameObjectHandle& hObject : m_CreatedRootObjects)
+  {
+    m_World.DeleteObjectDelayed(hObject);
+  }
+
+  m_CreatedRootObjects.Clear();
+  m_RootObjectActiveFlags.Clear();
+  m_ComponentsToDeserialize.Clear();
+  m_ComponentsToInitialize.Clear();
+  m_IndexToGameObjectHandle.Clear();
+  m_IndexToComponentHandle.Clear();
+
+  m_Phase = Phase::Finished;
+}
+
+float ezWorldReader::InstantiationContext::GetProgress() const
+{
+  if (m_Phase == Phase::Finished || m_uiTotalWork == 0)
+    return 1.0f;
+
+  return ezMath::Min((float)m_uiWorkDone / (float)m_uiTotalWork, 1.0f);
+}
+
+bool ezWorldReader::InstantiationContext::IsOutOfTime(ezTime endTime) const
+{
+  return m_MaxStepTime.IsPositive() && ezTime::Now() >= endTime;
+}
+
+void ezWorldReader::InstantiationContext::CreateRootObjects(ezTime endTime)
+{
+  ezWorldReader& reader = m_WorldReader;
+  const ezUInt16* pOverrideTeamID = m_bOverrideTeamID ? &m_uiOverrideTeamID : nullptr;
+  const ezUInt32 uiNumObjects = reader.m_RootObjectsToCreate.GetCount();
+
+  while (m_uiCurrentIndex < uiNumObjects)
+  {
+    const ezUInt32 uiCount = ezMath::Min(RootObjectsPerChunk, uiNumObjects - m_uiCurrentIndex);
+    ezArrayPtr<const GameObjectToCreate> objects = reader.m_RootObjectsToCreate.GetArrayPtr().GetSubArray(m_uiCurrentIndex, uiCount);
+
+    ezHybridArray<ezGameObject*, 8> createdObjects;
+
+    if (m_bUseTransform)
+    {
+      reader.CreateGameObjects(objects, m_RootTransform, m_hParent, &createdObjects, pOverrideTeamID, m_bForceDynamic);
+    }
+    else
+    {
+      reader.CreateGameObjects(objects, m_hParent, &createdObjects, pOverrideTeamID, m_bForceDynamic);
+    }
+
+    for (ezGameObject* pObject : createdObjects)
+    {
+      m_CreatedRootObjects.PushBack(pObject->GetHandle());
+      m_RootObjectActiveFlags.PushBack(pObject->GetActiveFlag());
+
+      // keep the whole hierarchy inactive until all components are initialized
+      pObject->SetActiveFlag(false);
+    }
+
+    m_uiCurrentIndex += uiCount;
+    m_uiWorkDone += uiCount;
+
+    if (IsOutOfTime(endTime))
+      return;
+  }
+
+  m_uiCurrentIndex = 0;
+  m_Phase = Phase::CreateChildObjects;
+}
+
+void ezWorldReader::InstantiationContext::CreateChildObjects(ezTime endTime)
+{
+  ezWorldReader& reader = m_WorldReader;
+  const ezUInt16* pOverrideTeamID = m_bOverrideTeamID ? &m_uiOverrideTeamID : nullptr;
+  const ezUInt32 uiNumObjects = reader.m_ChildObjectsToCreate.GetCount();
+
+  while (m_uiCurrentIndex < uiNumObjects)
+  {
+    const ezUInt32 uiCount = ezMath::Min(ChildObjectsPerChunk, uiNumObjects - m_uiCurrentIndex);
+    ezArrayPtr<const GameObjectToCreate> objects = reader.m_ChildObjectsToCreate.GetArrayPtr().GetSubArray(m_uiCurrentIndex, uiCount);
+
+    reader.CreateGameObjects(objects, ezGameObjectHandle(), nullptr, pOverrideTeamID, m_bForceDynamic);
+
+    m_uiCurrentIndex += uiCount;
+    m_uiWorkDone += uiCount;
+
+    if (IsOutOfTime(endTime))
+      return;
+  }
+
+  m_uiCurrentIndex = 0;
+  m_Phase = Phase::CreateComponents;
+}
+
+void ezWorldReader::InstantiationContext::CreateComponents(ezTime endTime)
+{
+  ezWorldReader& reader = m_WorldReader;
+  const ezUInt32 uiNumComponentTypes = reader.m_ComponentTypes.GetCount();
+
+  if (reader.m_ComponentStream.GetStorageSize() == 0)
+  {
+    m_uiCurrentComponentType = uiNumComponentTypes;
+  }
+
+  if (m_uiCurrentComponentType < uiNumComponentTypes)
+  {
+    ezMemoryStreamReader memReader(&reader.m_ComponentStream);
+    memReader.SetReadPosition(m_uiComponentReadPosition);
+
+    ezStreamReader* pPrevReader = reader.m_pStream;
+    reader.m_pStream = &memReader;
+
+    // the components are initialized piece by piece in the last phase
+    m_World.SetComponentsToInitializeTarget(&m_ComponentsToInitialize);
+
+    if (reader.m_uiVersion < 8)
+    {
+      // without the size of each component, the data can only be read in one go
+      reader.m_HandleReadContext.BeginRestoringHandles(&memReader);
+
+      for (ezUInt32 i = 0; i < uiNumComponentTypes; ++i)
+      {
+        reader.ReadComponentsOfType(memReader, i);
+      }
+
+      reader.m_HandleReadContext.EndRestoringHandles();
+      reader.FulfillComponentHandleRequets();
+
+      m_uiCurrentComponentType = uiNumComponentTypes;
+      m_uiWorkDone += reader.m_uiMaxComponents * 2;
+    }
+    else
+    {
+      ezUInt32 uiComponentsInChunk = 0;
+
+      while (m_uiCurrentComponentType < uiNumComponentTypes)
+      {
+        if (m_uiComponentsLeftOfType == 0)
+        {
+          m_pCurrentManager = reader.ReadComponentTypeHeader(m_uiCurrentComponentType, m_uiComponentsLeftOfType);
+
+          if (m_pCurrentManager == nullptr)
+          {
+            m_uiComponentsLeftOfType = 0;
+            ++m_uiCurrentComponentType;
+            continue;
+          }
+        }
+
+        ezUInt32 uiDataSize = 0;
+        ezComponent* pComponent = reader.ReadAndCreateComponent(m_pCurrentManager, uiDataSize);
+
+        // the data is deserialized in the next phase, once all component handles are known
+        auto& componentData = m_ComponentsToDeserialize.ExpandAndGetRef();
+        componentData.m_hComponent = pComponent->GetHandle();
+        componentData.m_uiDataOffset = memReader.GetReadPosition();
+        componentData.m_uiDataSize = uiDataSize;
+
+        memReader.SkipBytes(uiDataSize);
+
+        ++m_uiWorkDone;
+
+        if (--m_uiComponentsLeftOfType == 0)
+        {
+          ++m_uiCurrentComponentType;
+        }
+
+        if (++uiComponentsInChunk == ComponentsPerChunk)
+        {
+          uiComponentsInChunk = 0;
+
+          if (IsOutOfTime(endTime))
+            break;
+        }
+      }
+    }
+
+    m_World.SetComponentsToInitializeTarget(nullptr);
+
+    m_uiComponentReadPosition = memReader.GetReadPosition();
+    reader.m_pStream = pPrevReader;
+  }
+
+  if (m_uiCurrentComponentType == uiNumComponentTypes)
+  {
+    m_uiCurrentIndex = 0;
+    m_Phase = Phase::DeserializeComponents;
+  }
+}
+
+void ezWorldReader::InstantiationContext::DeserializeComponents(ezTime endTime)
+{
+  ezWorldReader& reader = m_WorldReader;
+  const ezUInt32 uiNumComponents = m_ComponentsToDeserialize.GetCount();
+
+  if (m_uiCurrentIndex < uiNumComponents)
+  {
+    ezRawMemoryStreamReader componentReader;
+
+    ezStreamReader* pPrevReader = reader.m_pStream;
+    reader.m_pStream = &componentReader;
+
+    reader.m_HandleReadContext.BeginRestoringHandles(&componentReader);
+
+    while (m_uiCurrentIndex < uiNumComponents)
+    {
+      const ezUInt32 uiEnd = ezMath::Min(m_uiCurrentIndex + ComponentsPerChunk, uiNumComponents);
+
+      for (; m_uiCurrentIndex < uiEnd; ++m_uiCurrentIndex)
+      {
+        const ComponentData& componentData = m_ComponentsToDeserialize[m_uiCurrentIndex];
+
+        // the component may have been deleted in the meantime
+        ezComponent* pComponent = nullptr;
+        if (m_World.TryGetComponent(componentData.m_hComponent, pComponent))
+        {
+          componentReader.Reset(reader.m_ComponentStream.GetData() + componentData.m_uiDataOffset, componentData.m_uiDataSize);
+          pComponent->DeserializeComponent(reader);
+        }
+
+        ++m_uiWorkDone;
+      }
+
+      if (IsOutOfTime(endTime))
+        break;
+    }
+
+    // all component handles are known at this point, so requests can be fulfilled right away
+    reader.m_HandleReadContext.EndRestoringHandles();
+    reader.FulfillComponentHandleRequets();
+
+    reader.m_pStream = pPrevReader;
+  }
+
+  if (m_uiCurrentIndex == uiNumComponents)
+  {
+    m_ComponentsToDeserialize.Clear();
+
+    m_uiCurrentIndex = 0;
+    m_Phase = Phase::InitializeComponents;
+  }
+}
+
+void ezWorldReader::InstantiationContext::InitializeComponents(ezTime endTime)
+{
+  const ezUInt32 uiNumComponents = m_ComponentsToInitialize.GetCount();
+
+  while (m_uiCurrentIndex < uiNumComponents)
+  {
+    const ezUInt32 uiCount = ezMath::Min(ComponentsPerChunk, uiNumComponents - m_uiCurrentIndex);
+
+    m_World.InitializeComponents(m_ComponentsToInitialize.GetArrayPtr().GetSubArray(m_uiCurrentIndex, uiCount));
+
+    m_uiCurrentIndex += uiCount;
+    m_uiWorkDone += uiCount;
+
+    if (IsOutOfTime(endTime))
+      return;
+  }
+
+  Finish();
+}
+
+void ezWorldReader::InstantiationContext::Finish()
+{
+  for (ezUInt32 i = 0; i < m_CreatedRootObjects.GetCount(); ++i)
+  {
+    ezGameObject* pObject = nullptr;
+    if (m_World.TryGetObject(m_CreatedRootObjects[i], pObject))
+    {
+      // activates all components that have been initialized in the previous steps
+      pObject->SetActiveFlag(m_RootObjectActiveFlags[i]);
+    }
+  }
+
+  m_RootObjectActiveFlags.Clear();
+  m_ComponentsToInitialize.Clear();
+
+  m_uiWorkDone = m_uiTotalWork;
+  m_Phase = Phase::Finished;
+}
+
 EZ_STATICLINK_FILE(Core, Core_WorldSerializer_Implementation_WorldReader);
@@ -0,0 +1,206 @@
+#include <CorePCH.h>
+
+#include <Core/WorldSerializer/WorldSnapshot.h>
+
+ezWorldSnapshot::ezWorldSnapshot()
+{
+  m_Writer.m_bWriteRawHandles = true;
+  m_Reader.m_bReadRawHandles = true;
+}
+
+ezWorldSnapshot::~ezWorldSnapshot() = default;
+
+void ezWorldSnapshot::Capture(ezWorld& world)
+{
+  world.CheckForReadAccess();
+
+  Clear();
+
+  m_uiWorldIndex = world.GetIndex();
+
+  {
+    ezMemoryStreamWriter writer(&m_ClockAndRandomState);
+    world.GetClock().Save(writer);
+    world.GetRandomNumberGenerator().Save(writer);
+  }
+
+  ezMemoryStreamWriter tableWriter(&m_ResourceTable);
+  ezResourceHandleWriteContext resHandleWriter;
+  resHandleWriter.BeginWritingToStream(&tableWriter);
+
+  ezDynamicArray<ezComponent*> components;
+
+  for (const ezRTTI* pRtti = ezRTTI::GetFirstInstance(); pRtti != nullptr; pRtti = pRtti->GetNextInstance())
+  {
+    if (!pRtti->IsDerivedFrom<ezComponent>())
+      continue;
+
+    const ezComponentSnapshotAttribute* pAttribute = pRtti->GetAttributeByType<ezComponentSnapshotAttribute>();
+    if (pAttribute == nullptr)
+      continue;
+
+    ezComponentManagerBase* pManager = world.GetManagerForComponentType(pRtti);
+    if (pManager == nullptr)
+      continue;
+
+    ManagerState& state = m_Managers.ExpandAndGetRef();
+    state.m_pComponentType = pRtti;
+    state.m_bCopyMemory = pAttribute->GetCopyMemory();
+
+    components.Clear();
+    pManager->CollectAllComponents(components, false);
+
+    state.m_Components.SetCountUninitialized(components.GetCount());
+    for (ezUInt32 i = 0; i < components.GetCount(); ++i)
+    {
+      state.m_Components[i] = components[i]->GetHandle();
+    }
+
+    if (state.m_bCopyMemory)
+    {
+      pManager->CopyRawComponentData(state.m_Data);
+    }
+    else
+    {
+      ezMemoryStreamContainerWrapperStorage<ezDynamicArray<ezUInt8>> storage(&state.m_Data);
+      ezMemoryStreamWriter writer(&storage);
+      m_Writer.m_pStream = &writer;
+
+      for (const ezComponent* pComponent : components)
+      {
+        // the size is patched once the component has been written
+        const ezUInt32 uiSizeOffset = writer.GetByteCount();
+        const ezUInt32 uiPlaceholder = 0;
+        writer << uiPlaceholder;
+
+        pComponent->SerializeComponent(m_Writer);
+
+        const ezUInt32 uiComponentSize = writer.GetByteCount() - uiSizeOffset - sizeof(ezUInt32);
+        ezMemoryUtils::RawByteCopy(state.m_Data.GetData() + uiSizeOffset, &uiComponentSize, sizeof(ezUInt32));
+      }
+
+      m_Writer.m_pStream = nullptr;
+    }
+  }
+
+  resHandleWriter.EndWritingToStream(&tableWriter);
+
+  // resolve the resource table right away, restoring the snapshot only has to patch the handles afterwards
+  {
+    ezMemoryStreamReader tableReader(&m_ResourceTable);
+
+    m_Reader.m_HandleReadContext.Reset();
+    m_Reader.m_HandleReadContext.BeginReadingFromStream(&tableReader);
+    m_Reader.m_HandleReadContext.EndReadingFromStream(&tableReader);
+  }
+}
+
+ezResult ezWorldSnapshot::Restore(ezWorld& world)
+{
+  world.CheckForWriteAccess();
+
+  if (IsEmpty() || m_uiWorldIndex != world.GetIndex())
+    return EZ_FAILURE;
+
+  // validate everything first, so that a failed restore doesn't leave the world in a half restored state
+  ezDynamicArray<ezComponent*> components;
+
+  for (const ManagerState& state : m_Managers)
+  {
+    ezComponentManagerBase* pManager = world.GetManagerForComponentType(state.m_pComponentType);
+    if (pManager == nullptr)
+      return EZ_FAILURE;
+
+    const ezUInt32 uiFirstComponent = components.GetCount();
+    pManager->CollectAllComponents(components, false);
+
+    if (components.GetCount() - uiFirstComponent != state.m_Components.GetCount())
+      return EZ_FAILURE;
+
+    for (ezUInt32 i = 0; i < state.m_Components.GetCount(); ++i)
+    {
+      if (components[uiFirstComponent + i]->GetHandle() != state.m_Components[i])
+        return EZ_FAILURE;
+    }
+  }
+
+  {
+    ezRawMemoryStreamReader reader(m_ClockAndRandomState.GetData(), m_ClockAndRandomState.GetStorageSize());
+    world.GetClock().Load(reader);
+    world.GetRandomNumberGenerator().Load(reader);
+  }
+
+  ezUInt32 uiFirstComponent = 0;
+  for (const ManagerState& state : m_Managers)
+  {
+    if (state.m_bCopyMemory)
+    {
+      ezComponentManagerBase* pManager = world.GetManagerForComponentType(state.m_pComponentType);
+      pManager->RestoreRawComponentData(state.m_Data, components.GetArrayPtr().GetSubArray(uiFirstComponent, state.m_Components.GetCount()));
+    }
+    else
+    {
+      m_Reader.m_pWorld = &world;
+      m_Reader.m_ComponentTypeVersions[state.m_pComponentType] = state.m_pComponentType->GetTypeVersion();
+
+      ezRawMemoryStreamReader reader(state.m_Data);
+      m_Reader.m_pStream = &reader;
+      m_Reader.m_HandleReadContext.BeginRestoringHandles(&reader);
+
+      ezUInt64 uiReadPosition = 0;
+      for (ezUInt32 i = 0; i < state.m_Components.GetCount(); ++i)
+      {
+        ezUInt32 uiComponentSize = 0;
+        reader >> uiComponentSize;
+
+        components[uiFirstComponent + i]->DeserializeComponent(m_Reader);
+
+        // make sure the next component is read from the right position, even if the deserialization didn't read everything
+        uiReadPosition += sizeof(ezUInt32) + uiComponentSize;
+        reader.SetReadPosition(uiReadPosition);
+      }
+
+      m_Reader.m_HandleReadContext.EndRestoringHandles();
+      m_Reader.m_pStream = nullptr;
+      m_Reader.m_pWorld = nullptr;
+    }
+
+    uiFirstComponent += state.m_Components.GetCount();
+  }
+
+  return EZ_SUCCESS;
+}
+
+void ezWorldSnapshot::Clear()
+{
+  m_uiWorldIndex = ezInvalidIndex;
+  m_Managers.Clear();
+  m_ClockAndRandomState.Clear();
+  m_ResourceTable.Clear();
+  m_Reader.m_HandleReadContext.Reset();
+  m_Reader.m_ComponentTypeVersions.Clear();
+}
+
+ezUInt32 ezWorldSnapshot::GetComponentCount() const
+{
+  ezUInt32 uiCount = 0;
+  for (const ManagerState& state : m_Managers)
+  {
+    uiCount += state.m_Components.GetCount();
+  }
+
+  return uiCount;
+}
+
+ezUInt64 ezWorldSnapshot::GetHeapMemoryUsage() const
+{
+  ezUInt64 uiMemory = m_Managers.GetHeapMemoryUsage() + m_ClockAndRandomState.GetHeapMemoryUsage() + m_ResourceTable.GetHeapMemoryUsage();
+  for (const ManagerState& state : m_Managers)
+  {
+    uiMemory += state.m_Components.GetHeapMemoryUsage() + state.m_Data.GetHeapMemoryUsage();
+  }
+
+  return uiMemory;
+}
+
+EZ_STATICLINK_FILE(Core, Core_WorldSerializer_Implementation_WorldSnapshot);
@@ -72,7 +72,7 @@ void ezWorldWriter::WriteToStream()
 {
   auto& stream = *m_pStream;
 
-  const ezUInt8 uiVersion = 7;
+  const ezUInt8 uiVersion = 8;
   stream << uiVersion;
 
   IncludeAllComponentBaseTypes();
@@ -190,6 +190,12 @@ void ezWorldWriter::Traverse(ezGameObject* pObject)
 
 void ezWorldWriter::WriteGameObjectHandle(const ezGameObjectHandle& hObject)
 {
+  if (m_bWriteRawHandles)
+  {
+    *m_pStream << hObject.GetInternalID().m_Data;
+    return;
+  }
+
   auto it = m_WrittenGameObjectHandles.Find(hObject);
 
   ezUInt32 uiIndex = 0;
@@ -204,6 +210,15 @@ void ezWorldWriter::WriteGameObjectHandle(const ezGameObjectHandle& hObject)
 
 void ezWorldWriter::WriteComponentHandle(const ezComponentHandle& hComponent)
 {
+  if (m_bWriteRawHandles)
+  {
+    const ezComponentId id = hComponent.GetInternalID();
+    *m_pStream << id.m_Data;
+    *m_pStream << id.m_TypeId;
+    *m_pStream << id.m_WorldIndex;
+    return;
+  }
+
   auto it = m_WrittenComponentHandles.Find(hComponent);
 
   EZ_ASSERT_DEBUG(it.IsValid(), "Handle should always be in the written map at this point");
@@ -277,6 +292,10 @@ void ezWorldWriter::WriteComponentsOfType(const ezRTTI* pRtti, const ezDeque<con
   ezMemoryStreamStorage storage;
   ezMemoryStreamWriter memWriter(&storage);
 
+  // every component is serialized into a separate buffer first, so that its size can be written in front of it
+  ezMemoryStreamStorage componentStorage;
+  ezMemoryStreamWriter componentWriter(&componentStorage);
+
   ezStreamWriter* pPrevStream = m_pStream;
   m_pStream = &memWriter;
 
@@ -303,7 +322,22 @@ void ezWorldWriter::WriteComponentsOfType(const ezRTTI* pRtti, const ezDeque<con
         s << userFlags;
       }
 
-      pComp->SerializeComponent(*this);
+      // version 8
+      {
+        componentWriter.SetWritePosition(0);
+
+        m_pStream = &componentWriter;
+        pComp->SerializeComponent(*this);
+        m_pStream = &memWriter;
+
+        const ezUInt32 uiComponentSize = componentWriter.GetByteCount();
+        s << uiComponentSize;
+
+        if (uiComponentSize > 0)
+        {
+          s.WriteBytes(componentStorage.GetData(), uiComponentSize);
+        }
+      }
     }
   }
 
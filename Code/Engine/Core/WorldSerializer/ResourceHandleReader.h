@@ -4,14 +4,16 @@
 #include <Core/ResourceManager/ResourceHandle.h>
 #include <Foundation/Containers/Deque.h>
 #include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Threading/Mutex.h>
 
 class ezResource;
 class ezStreamReader;
 
 /// \brief Used in conjunction with ezResoruceHandleWriteContext to restore serialized resource handles
 ///
-/// Only one instance can be 'active' on each thread, ie. BeginRestoringHandles() can only have been called on one instance recently.
-/// However, multiple instances can be used to do parallel loading on multiple threads.
+/// Only one instance can be 'active' on each thread, ie. the one on which BeginRestoringHandles() was called most recently.
+/// Nested calls restore the previously active instance in EndRestoringHandles(). Multiple instances can be used to do parallel loading
+/// on multiple threads.
 ///
 /// Reading the vital information for restoring handles, and actually restoring handles is separated into two operations
 /// which can be done interleaved (standard sequential reading from a file), or in separate steps, to allow to apply the handle
@@ -58,6 +60,16 @@ public:
   /// Note: This must be called AFTER EndReadingFromStream() was called, as it requires the data read by that function.
   void EndRestoringHandles();
 
+  /// \brief Makes this context active on the calling thread as well, so that handles can be read on multiple threads in parallel.
+  ///
+  /// May only be called between BeginRestoringHandles() and EndRestoringHandles(). Returns the context that was active on this thread
+  /// before, which has to be passed to DeactivateOnThisThread() once the thread is done reading handles. Calls may be nested, e.g. when
+  /// a thread reads handles for another context while it waits for its own tasks.
+  ezResourceHandleReadContext* ActivateOnThisThread();
+
+  /// \brief Makes the context that was returned by ActivateOnThisThread() active again.
+  void DeactivateOnThisThread(ezResourceHandleReadContext* pPreviousContext);
+
   /// \brief Resets all internal state such that the reader can be reused.
   void Reset();
 
@@ -73,8 +85,10 @@ private:
     ezUInt32 m_uiResourceID;
   };
 
+  ezMutex m_StoredHandlesMutex;
   ezDeque<HandleData> m_StoredHandles;
   ezDynamicArray<ezTypelessResourceHandle> m_AllResources;
+  ezResourceHandleReadContext* m_pPreviousActiveContext;
   ezUInt8 m_uiVersion;
   bool m_bReadData;
 };
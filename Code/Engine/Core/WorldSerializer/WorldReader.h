@@ -4,14 +4,120 @@
 #include <Core/WorldSerializer/ResourceHandleReader.h>
 #include <Foundation/IO/MemoryStream.h>
 #include <Foundation/IO/Stream.h>
+#include <Foundation/Threading/Mutex.h>
+#include <Foundation/Types/UniquePtr.h>
 
 /// \brief Reads a world description from a stream. Allows to instantiate that world multiple times
 ///        in different locations and different ezWorld's.
 ///
 /// The reader will ignore unknown component types and skip them during instantiation.
+///
+/// Components whose type itself is flagged with ezParallelDeserializationAttribute are created on the main thread, but their
+/// DeserializeComponent() function is executed on multiple threads afterwards. All other components are deserialized right
+/// after creation, in the order in which they were written.
 class EZ_CORE_DLL ezWorldReader
 {
 public:
+  /// \brief Instantiates a world or prefab over multiple frames. See InstantiateWorldTimeSliced() and InstantiatePrefabTimeSliced().
+  ///
+  /// Every call to Step() does as much work as fits into the time budget, but at least one small piece of work.
+  /// First all game objects are created, then all components are created, deserialized and finally initialized.
+  /// Until the instantiation is finished, all root objects are inactive, so none of the new components get activated
+  /// and nothing is visible. The root objects get their original active flag back in the very last step.
+  ///
+  /// The ezWorldReader must not be modified or destroyed until the context is finished or destroyed, unless the context owns it,
+  /// see TakeOwnershipOfWorldReader(). It may be used for other instantiations between two steps, but not concurrently.
+  /// Destroying an unfinished context leaves the partially instantiated objects in the world, use Cancel() to remove them.
+  class EZ_CORE_DLL InstantiationContext
+  {
+  public:
+    ~InstantiationContext();
+
+    /// \brief Continues the instantiation. Returns true once the instantiation is finished.
+    bool Step();
+
+    /// \brief Deletes all objects that have been created so far. The context is finished afterwards.
+    void Cancel();
+
+    /// \brief Whether all objects have been created and initialized.
+    bool IsFinished() const { return m_Phase == Phase::Finished; }
+
+    /// \brief Returns the progress of the instantiation in the range [0; 1].
+    float GetProgress() const;
+
+    /// \brief Returns the handles of all root objects that have been created so far.
+    ezArrayPtr<const ezGameObjectHandle> GetCreatedRootObjects() const { return m_CreatedRootObjects; }
+
+    /// \brief Makes the context the owner of the world reader that it instantiates from. The reader is destroyed together with the context.
+    void TakeOwnershipOfWorldReader(ezUniquePtr<ezWorldReader>&& pWorldReader);
+
+  private:
+    friend class ezWorldReader;
+
+    struct Phase
+    {
+      enum Enum
+      {
+        CreateRootObjects,
+        CreateChildObjects,
+        CreateComponents,
+        DeserializeComponents,
+        InitializeComponents,
+        Finished
+      };
+    };
+
+    struct ComponentData
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      ezComponentHandle m_hComponent;
+      ezUInt32 m_uiDataOffset;
+      ezUInt32 m_uiDataSize;
+    };
+
+    InstantiationContext(ezWorldReader& worldReader, ezWorld& world, bool bUseTransform, const ezTransform& rootTransform,
+                         ezGameObjectHandle hParent, const ezUInt16* pOverrideTeamID, bool bForceDynamic, ezTime maxStepTime);
+
+    bool IsOutOfTime(ezTime endTime) const;
+
+    void CreateRootObjects(ezTime endTime);
+    void CreateChildObjects(ezTime endTime);
+    void CreateComponents(ezTime endTime);
+    void DeserializeComponents(ezTime endTime);
+    void InitializeComponents(ezTime endTime);
+    void Finish();
+
+    ezUniquePtr<ezWorldReader> m_pOwnedWorldReader;
+    ezWorldReader& m_WorldReader;
+    ezWorld& m_World;
+
+    bool m_bUseTransform;
+    bool m_bOverrideTeamID;
+    bool m_bForceDynamic;
+    ezUInt16 m_uiOverrideTeamID;
+    ezTransform m_RootTransform;
+    ezGameObjectHandle m_hParent;
+    ezTime m_MaxStepTime;
+
+    Phase::Enum m_Phase = Phase::CreateRootObjects;
+    ezUInt32 m_uiCurrentIndex = 0;
+    ezUInt32 m_uiCurrentComponentType = 0;
+    ezUInt32 m_uiComponentsLeftOfType = 0;
+    ezComponentManagerBase* m_pCurrentManager = nullptr;
+    ezUInt32 m_uiComponentReadPosition = 0;
+    ezUInt32 m_uiWorkDone = 0;
+    ezUInt32 m_uiTotalWork = 0;
+
+    ezDynamicArray<ezGameObjectHandle> m_IndexToGameObjectHandle;
+    ezDynamicArray<ezComponentHandle> m_IndexToComponentHandle;
+
+    ezDynamicArray<ezGameObjectHandle> m_CreatedRootObjects;
+    ezDynamicArray<bool> m_RootObjectActiveFlags;
+    ezDynamicArray<ComponentData> m_ComponentsToDeserialize;
+    ezDynamicArray<ezComponentHandle> m_ComponentsToInitialize;
+  };
+
   ezWorldReader();
 
   /// \brief Reads all information about the world from the given stream.
@@ -43,8 +149,20 @@ public:
                          ezHybridArray<ezGameObject*, 8>* out_CreatedRootObjects, ezHybridArray<ezGameObject*, 8>* out_CreatedChildObjects,
                          const ezUInt16* pOverrideTeamID, bool bForceDynamic);
 
+  /// \brief Like InstantiateWorld(), but spreads the work over multiple frames. Each call to InstantiationContext::Step() takes roughly
+  /// \a maxStepTime. A zero time does all the work in the first step.
+  ezUniquePtr<InstantiationContext> InstantiateWorldTimeSliced(ezWorld& world, const ezUInt16* pOverrideTeamID, ezTime maxStepTime);
+
+  /// \brief Like InstantiatePrefab(), but spreads the work over multiple frames. Each call to InstantiationContext::Step() takes roughly
+  /// \a maxStepTime. A zero time does all the work in the first step.
+  ezUniquePtr<InstantiationContext> InstantiatePrefabTimeSliced(ezWorld& world, const ezTransform& rootTransform, ezGameObjectHandle hParent,
+                                                                const ezUInt16* pOverrideTeamID, bool bForceDynamic, ezTime maxStepTime);
+
   /// \brief Gives access to the stream of data. Use this inside component deserialization functions to read data.
-  ezStreamReader& GetStream() const { return *m_pStream; }
+  ///
+  /// During parallel deserialization this returns a stream that only contains the data of the component that is currently
+  /// deserialized on the calling thread.
+  ezStreamReader& GetStream() const;
 
   /// \brief Used during component deserialization to read a handle to a game object.
   ezGameObjectHandle ReadGameObjectHandle();
@@ -68,6 +186,8 @@ public:
   ezUInt64 GetHeapMemoryUsage() const;
 
 private:
+  friend class ezWorldSnapshot;
+
   struct GameObjectToCreate
   {
     ezGameObjectDesc m_Desc;
@@ -77,15 +197,18 @@ private:
 
   void ReadGameObjectDesc(GameObjectToCreate& godesc);
   void ReadComponentInfo(ezUInt32 uiComponentTypeIdx);
-  void ReadComponentsOfType(ezUInt32 uiComponentTypeIdx);
+  ezComponentManagerBase* ReadComponentTypeHeader(ezUInt32 uiComponentTypeIdx, ezUInt32& out_uiNumComponents);
+  ezComponent* ReadAndCreateComponent(ezComponentManagerBase* pManager, ezUInt32& out_uiDataSize);
+  void ReadComponentsOfType(ezMemoryStreamReader& memReader, ezUInt32 uiComponentTypeIdx);
+  void DeserializeComponentsInParallel();
   void FulfillComponentHandleRequets();
   void Instantiate(ezWorld& world, bool bUseTransform, const ezTransform& rootTransform, ezGameObjectHandle hParent,
                    ezHybridArray<ezGameObject*, 8>* out_CreatedRootObjects, ezHybridArray<ezGameObject*, 8>* out_CreatedChildObjects,
                    const ezUInt16* pOverrideTeamID, bool bForceDynamic);
 
-  void CreateGameObjects(const ezDynamicArray<GameObjectToCreate>& objects, ezGameObjectHandle hParent,
+  void CreateGameObjects(ezArrayPtr<const GameObjectToCreate> objects, ezGameObjectHandle hParent,
                          ezHybridArray<ezGameObject*, 8>* out_CreatedRootObjects, const ezUInt16* pOverrideTeamID, bool bForceDynamic);
-  void CreateGameObjects(const ezDynamicArray<GameObjectToCreate>& objects, const ezTransform& rootTransform, ezGameObjectHandle hParent,
+  void CreateGameObjects(ezArrayPtr<const GameObjectToCreate> objects, const ezTransform& rootTransform, ezGameObjectHandle hParent,
                          ezHybridArray<ezGameObject*, 8>* out_CreatedRootObjects, const ezUInt16* pOverrideTeamID, bool bForceDynamic);
 
   ezStreamReader* m_pStream;
@@ -93,6 +216,9 @@ private:
 
   ezUInt8 m_uiVersion;
   ezUInt32 m_uiMaxComponents;
+
+  // used by ezWorldSnapshot, handles are read back exactly as they were written, see ezWorldWriter::m_bWriteRawHandles
+  bool m_bReadRawHandles;
   ezDynamicArray<ezGameObjectHandle> m_IndexToGameObjectHandle;
   ezDynamicArray<ezComponentHandle> m_IndexToComponentHandle;
 
@@ -108,7 +234,18 @@ private:
   ezDynamicArray<GameObjectToCreate> m_RootObjectsToCreate;
   ezDynamicArray<GameObjectToCreate> m_ChildObjectsToCreate;
 
+  struct ComponentToDeserialize
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezComponent* m_pComponent;
+    ezUInt32 m_uiDataOffset;
+    ezUInt32 m_uiDataSize;
+  };
+
+  ezMutex m_ComponentHandleRequestsMutex;
   ezHybridArray<CompRequest, 64> m_ComponentHandleRequests;
+  ezDynamicArray<ComponentToDeserialize> m_ComponentsToDeserialize;
   ezDynamicArray<const ezRTTI*> m_ComponentTypes;
   ezHashTable<const ezRTTI*, ezUInt32> m_ComponentTypeVersions;
   ezMemoryStreamStorage m_ComponentStream;
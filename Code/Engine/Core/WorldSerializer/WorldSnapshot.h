@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Core/WorldSerializer/WorldReader.h>
+#include <Core/WorldSerializer/WorldWriter.h>
+
+/// \brief Stores the simulation state of a world in memory, so that it can be restored later, e.g. for rollback or replays.
+///
+/// Only component types that are flagged with ezComponentSnapshotAttribute are stored, plus the world clock and the random number
+/// generator state. Game objects and their transforms are not part of the snapshot, neither are components of any other type.
+///
+/// Components that allow to copy their memory are stored with one memcpy per storage block. All other components are stored through
+/// SerializeComponent() and restored through DeserializeComponent() on the existing component. Handles that are written
+/// during serialization are stored as they are, so they stay valid as long as the referenced objects and components exist.
+/// The ezComponent part of a memory copied component, i.e. its owner, id and active state, is never restored.
+///
+/// A snapshot can only be restored into the same world and only as long as exactly the same components of the snapshot types exist,
+/// i.e. no such component has been created or deleted since the snapshot was captured. Restore() fails otherwise and doesn't change anything.
+/// A snapshot can be restored any number of times.
+class EZ_CORE_DLL ezWorldSnapshot
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezWorldSnapshot);
+
+public:
+  ezWorldSnapshot();
+  ~ezWorldSnapshot();
+
+  /// \brief Stores the state of the given world. Any previously captured state is discarded.
+  ///
+  /// Requires read access to the world.
+  void Capture(ezWorld& world);
+
+  /// \brief Restores the state that was previously captured from \a world.
+  ///
+  /// Requires write access to the world. Fails if the snapshot is empty, was captured from a different world
+  /// or if the components of the snapshot types have changed since.
+  ezResult Restore(ezWorld& world);
+
+  /// \brief Discards the captured state.
+  void Clear();
+
+  /// \brief Whether any state has been captured.
+  bool IsEmpty() const { return m_uiWorldIndex == ezInvalidIndex; }
+
+  /// \brief Returns the number of components that are stored in the snapshot.
+  ezUInt32 GetComponentCount() const;
+
+  /// \brief Returns the amount of bytes that are currently allocated on the heap.
+  ezUInt64 GetHeapMemoryUsage() const;
+
+private:
+  struct ManagerState
+  {
+    const ezRTTI* m_pComponentType = nullptr;
+    bool m_bCopyMemory = false;
+
+    /// All components of the manager in storage order.
+    ezDynamicArray<ezComponentHandle> m_Components;
+
+    /// Either the raw storage memory or the size prefixed serialized data of all components.
+    ezDynamicArray<ezUInt8> m_Data;
+  };
+
+  ezUInt32 m_uiWorldIndex = ezInvalidIndex;
+  ezDynamicArray<ManagerState> m_Managers;
+  ezMemoryStreamStorage m_ClockAndRandomState;
+
+  // The writer and reader are only used for their raw handle modes and resource handle serialization
+  ezWorldWriter m_Writer;
+  ezWorldReader m_Reader;
+  ezMemoryStreamStorage m_ResourceTable;
+};
@@ -49,6 +49,8 @@ public:
   const ezDeque<const ezGameObject*>& GetAllWrittenChildObjects() const { return m_AllChildObjects; }
 
 private:
+  friend class ezWorldSnapshot;
+
   void Clear();
   void WriteToStream();
   void AssignGameObjectIndices();
@@ -66,6 +68,9 @@ private:
   ezStreamWriter* m_pStream = nullptr;
   const ezTagSet* m_pExclude = nullptr;
 
+  // used by ezWorldSnapshot, which restores components into the same world, so handles don't need to be remapped
+  bool m_bWriteRawHandles = false;
+
   ezDeque<const ezGameObject*> m_AllRootObjects;
   ezDeque<const ezGameObject*> m_AllChildObjects;
   ezHashTable<const ezRTTI*, ezDeque<const ezComponent*>> m_AllComponents;
@@ -38,7 +38,7 @@ ezResult ezPreprocessor::CopyTokensAndEvaluateDefined(const TokenStream& Source,
 
         ezToken* pReplacement = nullptr;
 
-        const bool bDefined = m_Macros.Find(Source[uiIdentifier]->m_DataView).IsValid();
+        const bool bDefined = m_Macros.Contains(GetMacroKey(Source[uiIdentifier]->m_DataView));
 
         // broadcast that 'defined' is being evaluated
         {
@@ -6,15 +6,7 @@ using namespace ezTokenParseUtils;
 
 bool ezPreprocessor::RemoveDefine(const char* szName)
 {
-  auto it = m_Macros.Find(szName);
-
-  if (it.IsValid())
-  {
-    m_Macros.Remove(it);
-    return true;
-  }
-
-  return false;
+  return m_Macros.Remove(GetMacroKey(szName));
 }
 
 
@@ -54,8 +46,8 @@ ezResult ezPreprocessor::StoreDefine(const ezToken* pMacroNameToken, const Token
     md.m_Replacement.PushBack(AddCustomToken(&Whitespace, ""));
   }*/
 
-  bool bExisted = false;
-  auto it = m_Macros.FindOrAdd(pMacroNameToken->m_DataView, &bExisted);
+  const MacroKey macroKey = GetMacroKey(pMacroNameToken->m_DataView);
+  const bool bExisted = m_Macros.Contains(macroKey);
 
   ProcessingEvent pe;
   pe.m_Type = bExisted ? ProcessingEvent::Redefine : ProcessingEvent::Define;
@@ -68,7 +60,8 @@ ezResult ezPreprocessor::StoreDefine(const ezToken* pMacroNameToken, const Token
     //return EZ_FAILURE;
   }
 
-  it.Value() = md;
+  // a redefinition keeps the key of the first definition, which references the same name
+  m_Macros[macroKey] = md;
   return EZ_SUCCESS;
 }
 
@@ -156,12 +149,6 @@ ezResult ezPreprocessor::AddCustomDefine(const char* szDefinition)
   ezMemoryUtils::Copy(&m_CustomDefines.PeekBack().m_Content[0], (ezUInt8*)szDefinition, m_CustomDefines.PeekBack().m_Content.GetCount());
   m_CustomDefines.PeekBack().m_Tokenized.Tokenize(m_CustomDefines.PeekBack().m_Content, m_pLog);
 
-  ezUInt32 uiFirstToken = 0;
-  ezHybridArray<const ezToken*, 32> Tokens;
-
-  if (m_CustomDefines.PeekBack().m_Tokenized.GetNextLine(uiFirstToken, Tokens).Failed())
-    return EZ_FAILURE;
-
   ezDeque<ezToken>& NewTokens = m_CustomDefines.PeekBack().m_Tokenized.GetTokens();
 
   ezHashedString sFile;
@@ -177,6 +164,17 @@ ezResult ezPreprocessor::AddCustomDefine(const char* szDefinition)
     uiColumn += ezStringUtils::GetCharacterCount(NewTokens[t].m_DataView.GetStartPointer(), NewTokens[t].m_DataView.GetEndPointer());
   }
 
+  return ApplyCustomDefine(m_CustomDefines.PeekBack());
+}
+
+ezResult ezPreprocessor::ApplyCustomDefine(const CustomDefine& define)
+{
+  ezUInt32 uiFirstToken = 0;
+  ezHybridArray<const ezToken*, 32> Tokens;
+
+  if (define.m_Tokenized.GetNextLine(uiFirstToken, Tokens).Failed())
+    return EZ_FAILURE;
+
   ezUInt32 uiCurToken = 0;
   return HandleDefine(Tokens, uiCurToken);
 }
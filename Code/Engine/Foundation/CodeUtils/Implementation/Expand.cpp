@@ -80,7 +80,7 @@ ezResult ezPreprocessor::ExpandOnce(const TokenStream& Tokens, TokenStream& Outp
 
     const ezUInt32 uiIdentifierToken = uiCurToken;
 
-    auto itMacro = m_Macros.Find(Tokens[uiIdentifierToken]->m_DataView);
+    auto itMacro = m_Macros.Find(GetMacroKey(Tokens[uiIdentifierToken]->m_DataView));
 
     // no known macro name, or flagged as not to be expanded further -> pass through
     if (!itMacro.IsValid() || ((Tokens[uiCurToken]->m_uiCustomFlags & TokenFlags::NoFurtherExpansion) != 0))
@@ -7,11 +7,13 @@
 
 using namespace ezTokenParseUtils;
 
-ezMap<ezString, ezTokenizedFileCache::FileData>::ConstIterator ezTokenizedFileCache::Lookup(const ezString& sFileName) const
+ezSharedPtr<const ezTokenizedFileCache::FileData> ezTokenizedFileCache::Lookup(const ezString& sFileName) const
 {
   EZ_LOCK(m_Mutex);
-  auto it = m_Cache.Find(sFileName);
-  return it;
+
+  ezSharedPtr<const FileData> pData;
+  m_Cache.TryGetValue(sFileName, pData);
+  return pData;
 }
 
 void ezTokenizedFileCache::Remove(const ezString& sFileName)
@@ -20,10 +22,25 @@ void ezTokenizedFileCache::Remove(const ezString& sFileName)
   m_Cache.Remove(sFileName);
 }
 
+bool ezTokenizedFileCache::RemoveOutdated(const ezString& sFileName, const ezTimestamp& FileTimeStamp)
+{
+  EZ_LOCK(m_Mutex);
+
+  const ezSharedPtr<const FileData>* pData = nullptr;
+  if (m_Cache.TryGetValue(sFileName, pData) && !(*pData)->m_Timestamp.Compare(FileTimeStamp, ezTimestamp::CompareMode::Identical))
+  {
+    m_Cache.Remove(sFileName);
+    return true;
+  }
+
+  return false;
+}
+
 void ezTokenizedFileCache::Clear()
 {
   EZ_LOCK(m_Mutex);
   m_Cache.Clear();
+  m_Cache.Compact();
 }
 
 void ezTokenizedFileCache::SkipWhitespace(ezDeque<ezToken>& Tokens, ezUInt32& uiCurToken)
@@ -36,14 +53,13 @@ void ezTokenizedFileCache::SkipWhitespace(ezDeque<ezToken>& Tokens, ezUInt32& ui
     ++uiCurToken;
 }
 
-const ezTokenizer* ezTokenizedFileCache::Tokenize(const ezString& sFileName, ezArrayPtr<const ezUInt8> FileContent, const ezTimestamp& FileTimeStamp, ezLogInterface* pLog)
+ezSharedPtr<const ezTokenizedFileCache::FileData> ezTokenizedFileCache::Tokenize(const ezString& sFileName, ezArrayPtr<const ezUInt8> FileContent, const ezTimestamp& FileTimeStamp, ezLogInterface* pLog)
 {
-  EZ_LOCK(m_Mutex);
+  // tokenize without holding the lock, so that other threads can use the cache in the mean time
+  ezSharedPtr<FileData> pData = EZ_DEFAULT_NEW(FileData);
 
-  auto& data = m_Cache[sFileName];
-
-  data.m_Timestamp = FileTimeStamp;
-  ezTokenizer* pTokenizer = &data.m_Tokens;
+  pData->m_Timestamp = FileTimeStamp;
+  ezTokenizer* pTokenizer = &pData->m_Tokens;
   pTokenizer->Tokenize(FileContent, pLog);
 
   ezDeque<ezToken>& Tokens = pTokenizer->GetTokens();
@@ -103,7 +119,18 @@ const ezTokenizer* ezTokenizedFileCache::Tokenize(const ezString& sFileName, ezA
     }
   }
 
-  return pTokenizer;
+  EZ_LOCK(m_Mutex);
+
+  // another thread might have tokenized the same file in the mean time, prefer the data that might already be in use
+  const ezSharedPtr<const FileData>* pExistingData = nullptr;
+  if (m_Cache.TryGetValue(sFileName, pExistingData) && (*pExistingData)->m_Timestamp.Compare(FileTimeStamp, ezTimestamp::CompareMode::Identical))
+  {
+    return *pExistingData;
+  }
+
+  // data that is replaced stays alive as long as a preprocessor still references it
+  m_Cache[sFileName] = pData;
+  return pData;
 }
 
 
@@ -171,11 +198,16 @@ ezResult ezPreprocessor::OpenFile(const char* szFile, const ezTokenizer** pToken
 
   *pTokenizer = nullptr;
 
-  auto it = m_pUsedFileCache->Lookup(szFile);
+  ezSharedPtr<const ezTokenizedFileCache::FileData> pCachedData = m_pUsedFileCache->Lookup(szFile);
 
-  if (it.IsValid())
+  if (pCachedData != nullptr)
   {
-    *pTokenizer = &it.Value().m_Tokens;
+    *pTokenizer = &pCachedData->m_Tokens;
+
+    // files with include guards are opened many times
+    if (!m_UsedFiles.Contains(pCachedData))
+      m_UsedFiles.PushBack(pCachedData);
+
     return EZ_SUCCESS;
   }
 
@@ -202,7 +234,10 @@ ezResult ezPreprocessor::OpenFile(const char* szFile, const ezTokenizer** pToken
     }
   }
 
-  *pTokenizer = m_pUsedFileCache->Tokenize(szFile, ContentView, stamp, m_pLog);
+  pCachedData = m_pUsedFileCache->Tokenize(szFile, ContentView, stamp, m_pLog);
+
+  *pTokenizer = &pCachedData->m_Tokens;
+  m_UsedFiles.PushBack(pCachedData);
 
   return EZ_SUCCESS;
 }
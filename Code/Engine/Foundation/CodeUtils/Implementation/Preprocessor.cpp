@@ -11,7 +11,7 @@ ezPreprocessor::ezPreprocessor()
   , m_sCurrentFileStack(&m_ClassAllocator)
   , m_CustomDefines(&m_ClassAllocator)
   , m_IfdefActiveStack(&m_ClassAllocator)
-  , m_Macros(ezCompareHelper<ezString256>(), &m_ClassAllocator)
+  , m_Macros(&m_ClassAllocator)
   , m_MacroParamStack(&m_ClassAllocator)
   , m_MacroParamStackExpanded(&m_ClassAllocator)
   , m_CustomTokens(&m_ClassAllocator)
@@ -25,12 +25,20 @@ ezPreprocessor::ezPreprocessor()
   m_FileLocatorCallback = DefaultFileLocator;
   m_FileOpenCallback = DefaultFileOpen;
 
-  ezStringBuilder s;
+  // the parameter names are shared by all instances, which may be created on several threads at the same time
+  static bool s_bParamNamesInitialized = []() {
+    ezStringBuilder s;
+    for (ezUInt32 i = 0; i < 32; ++i)
+    {
+      s.Format("__Param{0}__", i);
+      s_ParamNames[i] = s;
+    }
+    return true;
+  }();
+  EZ_IGNORE_UNUSED(s_bParamNamesInitialized);
+
   for (ezUInt32 i = 0; i < 32; ++i)
   {
-    s.Format("__Param{0}__", i);
-    s_ParamNames[i] = s;
-
     m_ParameterTokens[i].m_iType = s_MacroParameter0 + i;
     m_ParameterTokens[i].m_DataView = s_ParamNames[i].GetView();
   }
@@ -43,6 +51,16 @@ ezPreprocessor::ezPreprocessor()
   m_TokenComma = AddCustomToken(&dummy, ",");
 }
 
+// static
+ezPreprocessor::MacroKey ezPreprocessor::GetMacroKey(const ezStringView& sMacroName)
+{
+  // hashes the token data directly, without copying it into a zero-terminated string
+  MacroKey key;
+  key.m_uiHash = ezHashingUtils::MurmurHash32(sMacroName.GetStartPointer(), sMacroName.GetElementCount());
+  key.m_sName = sMacroName;
+  return key;
+}
+
 void ezPreprocessor::SetCustomFileCache(ezTokenizedFileCache* pFileCache)
 {
   m_pUsedFileCache = &m_InternalFileCache;
@@ -130,6 +148,17 @@ ezResult ezPreprocessor::Process(const char* szMainFile, TokenStream& TokenOutpu
 
   TokenOutput.Clear();
 
+  // the macros of the previous run reference the tokens of its files, which are released here
+  m_Macros.Clear();
+  m_PragmaOnce.Clear();
+  m_UsedFiles.Clear();
+
+  for (const CustomDefine& define : m_CustomDefines)
+  {
+    // errors have already been reported by AddCustomDefine()
+    ApplyCustomDefine(define);
+  }
+
   // Add a custom define for the __FILE__ macro
   {
     m_TokenFile.m_DataView = ezStringView("__FILE__");
@@ -141,7 +170,7 @@ ezResult ezPreprocessor::Process(const char* szMainFile, TokenStream& TokenOutpu
     md.m_iNumParameters = 0;
     md.m_bHasVarArgs = false;
 
-    m_Macros.Insert("__FILE__", md);
+    m_Macros.Insert(GetMacroKey(m_TokenFile.m_DataView), md);
   }
 
   // Add a custom define for the __LINE__ macro
@@ -155,7 +184,7 @@ ezResult ezPreprocessor::Process(const char* szMainFile, TokenStream& TokenOutpu
     md.m_iNumParameters = 0;
     md.m_bHasVarArgs = false;
 
-    m_Macros.Insert("__LINE__", md);
+    m_Macros.Insert(GetMacroKey(m_TokenLine.m_DataView), md);
   }
 
   m_IfdefActiveStack.Clear();
@@ -374,7 +403,7 @@ ezResult ezPreprocessor::HandleIfdef(const TokenStream& Tokens, ezUInt32 uiCurTo
   if (Expect(Tokens, uiCurToken, ezTokenType::Identifier, &uiIdentifier).Failed())
     return EZ_FAILURE;
 
-  const bool bDefined = m_Macros.Find(Tokens[uiIdentifier]->m_DataView).IsValid();
+  const bool bDefined = m_Macros.Contains(GetMacroKey(Tokens[uiIdentifier]->m_DataView));
 
   // broadcast that '#ifdef' is being evaluated
   {
@@ -3,44 +3,57 @@
 #include <Foundation/Basics.h>
 #include <Foundation/CodeUtils/TokenParseUtils.h>
 #include <Foundation/CodeUtils/Tokenizer.h>
+#include <Foundation/Containers/HashTable.h>
 #include <Foundation/Containers/Map.h>
 #include <Foundation/Containers/Set.h>
 #include <Foundation/IO/Stream.h>
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Time/Timestamp.h>
 #include <Foundation/Memory/CommonAllocators.h>
+#include <Foundation/Types/SharedPtr.h>
 
 /// \brief This object caches files in a tokenized state. It can be shared among ezPreprocessor instances to improve performance when
 /// they access the same files.
+///
+/// The cache is thread-safe, so it can also be shared by preprocessors that run on different threads at the same time.
 class EZ_FOUNDATION_DLL ezTokenizedFileCache
 {
 public:
-  struct FileData
+  /// \brief The tokenized content of a file. Once it has been stored in the cache it is never modified again.
+  struct FileData : public ezRefCounted
   {
     ezTokenizer m_Tokens;
     ezTimestamp m_Timestamp;
   };
 
-  /// \brief Checks whether \a sFileName is already in the cache, returns an iterator to it. If the iterator is invalid, the file is not cached yet.
-  ezMap<ezString, FileData>::ConstIterator Lookup(const ezString& sFileName) const;
+  /// \brief Checks whether \a sFileName is already in the cache and returns its data. If the pointer is empty, the file is not cached yet.
+  ///
+  /// The returned data stays valid as long as it is referenced, even when the file gets removed from the cache in the mean time.
+  ezSharedPtr<const FileData> Lookup(const ezString& sFileName) const;
 
   /// \brief Removes the cached content for \a sFileName from the cache. Should be used when the file content has changed and needs to be re-read.
   void Remove(const ezString& sFileName);
 
-  /// \brief Removes all files from the cache to ensure that they will be re-read.
+  /// \brief Removes the cached content for \a sFileName, if it was stored with a different timestamp than \a FileTimeStamp.
+  ///
+  /// Returns true if the content was removed.
+  bool RemoveOutdated(const ezString& sFileName, const ezTimestamp& FileTimeStamp);
+
+  /// \brief Removes all files from the cache to ensure that they will be re-read. Also releases the memory of the cache itself.
   void Clear();
 
   /// \brief Stores \a FileContent for the file \a sFileName as the new cached data.
   ///
   //// The file content is tokenized first and all #line directives are evaluated, to update the line number and file origin for each token.
   /// Any errors are written to the given log.
-  const ezTokenizer* Tokenize(const ezString& sFileName, ezArrayPtr<const ezUInt8> FileContent, const ezTimestamp& FileTimeStamp, ezLogInterface* pLog);
+  /// If another thread has stored the same file with the same timestamp in the mean time, its data is returned instead.
+  ezSharedPtr<const FileData> Tokenize(const ezString& sFileName, ezArrayPtr<const ezUInt8> FileContent, const ezTimestamp& FileTimeStamp, ezLogInterface* pLog);
 
 private:
-  void SkipWhitespace(ezDeque<ezToken>& Tokens, ezUInt32& uiCurToken);
+  static void SkipWhitespace(ezDeque<ezToken>& Tokens, ezUInt32& uiCurToken);
 
   mutable ezMutex m_Mutex;
-  ezMap<ezString, FileData> m_Cache;
+  ezHashTable<ezString, ezSharedPtr<const FileData>> m_Cache;
 };
 
 /// \brief ezPreprocessor implements a standard C preprocessor. It can be used to pre-process files to get the output after macro expansion and #ifdef handling.
@@ -161,6 +174,9 @@ public:
   /// Files #included in "" will be appended as relative paths to the path of the file they appeared in.
   void SetFileLocatorFunction(FileLocatorCB LocateAbsFileCB);
 
+  /// \brief The file locator that is used when no custom one is set. Custom locators can forward to it, e.g. to only track which files are included.
+  static ezResult DefaultFileLocator(const char* szCurAbsoluteFile, const char* szIncludeFile, ezPreprocessor::IncludeType IncType, ezStringBuilder& out_sAbsoluteFilePath);
+
   /// \brief Adds a #define to the preprocessor, even before any file is processed.
   ///
   /// This allows to have global macros that are always defined for all processed files, such as the current platform etc.
@@ -174,6 +190,7 @@ public:
   /// \brief Processes the given file and returns the result as a stream of tokens.
   ///
   /// This function is useful when you want to further process the output afterwards and thus need it in a tokenized form anyway.
+  /// The output tokens stay valid until the next call. Every call starts with only the custom defines being defined.
   ezResult Process(const char* szMainFile, ezTokenParseUtils::TokenStream& TokenOutput);
 
   /// \brief Processes the given file and returns the result as a string.
@@ -228,6 +245,10 @@ private:
   // pointer to the file cache that is in use
   ezTokenizedFileCache* m_pUsedFileCache;
 
+  // keeps the tokens of all files opened by the current Process() call alive, since the output and the macros reference them,
+  // even if they are removed from the cache
+  ezDynamicArray<ezSharedPtr<const ezTokenizedFileCache::FileData>> m_UsedFiles;
+
   ezDeque<FileData> m_sCurrentFileStack;
 
   ezLogInterface* m_pLog;
@@ -249,7 +270,6 @@ private:
 
 private: // *** File Handling ***
   ezResult OpenFile(const char* szFile, const ezTokenizer** pTokenizer);
-  static ezResult DefaultFileLocator(const char* szCurAbsoluteFile, const char* szIncludeFile, ezPreprocessor::IncludeType IncType, ezStringBuilder& out_sAbsoluteFilePath);
   static ezResult DefaultFileOpen(const char* szAbsoluteFile, ezDynamicArray<ezUInt8>& FileContent, ezTimestamp& out_FileModification);
 
   FileOpenCB m_FileOpenCallback;
@@ -259,6 +279,7 @@ private: // *** File Handling ***
 private: // *** Macro Definition ***
   bool RemoveDefine(const char* szName);
   ezResult HandleDefine(const ezTokenParseUtils::TokenStream& Tokens, ezUInt32& uiCurToken);
+  ezResult ApplyCustomDefine(const CustomDefine& define);
 
   struct MacroDefinition
   {
@@ -275,7 +296,25 @@ private: // *** Macro Definition ***
   ezResult StoreDefine(const ezToken* pMacroNameToken, const ezTokenParseUtils::TokenStream* pReplacementTokens, ezUInt32 uiFirstReplacementToken, ezInt32 iNumParameters, bool bUsesVarArgs);
   ezResult ExtractParameterName(const ezTokenParseUtils::TokenStream& Tokens, ezUInt32& uiCurToken, ezString& sIdentifierName);
 
-  ezMap<ezString256, MacroDefinition> m_Macros;
+  /// \brief Macros are looked up for every identifier, so the key stores the hash of the name next to a view of the name.
+  ///
+  /// The hash is only used for bucketing, two keys are only equal if the names are equal, so colliding names stay separate macros.
+  /// The name of a stored key points to the data of the macro identifier token.
+  struct MacroKey
+  {
+    ezUInt32 m_uiHash;
+    ezStringView m_sName;
+  };
+
+  struct MacroKeyHashHelper
+  {
+    static ezUInt32 Hash(const MacroKey& key) { return key.m_uiHash; }
+    static bool Equal(const MacroKey& a, const MacroKey& b) { return a.m_uiHash == b.m_uiHash && a.m_sName.IsEqual(b.m_sName); }
+  };
+
+  static MacroKey GetMacroKey(const ezStringView& sMacroName);
+
+  ezHashTable<MacroKey, MacroDefinition, MacroKeyHashHelper> m_Macros;
 
   static const ezInt32 s_MacroParameter0 = ezTokenType::ENUM_COUNT + 2;
   static ezString s_ParamNames[32];
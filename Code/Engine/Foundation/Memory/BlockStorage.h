@@ -66,6 +66,18 @@ public:
   Iterator GetIterator(ezUInt32 uiStartIndex = 0, ezUInt32 uiCount = ezInvalidIndex);
   ConstIterator GetIterator(ezUInt32 uiStartIndex = 0, ezUInt32 uiCount = ezInvalidIndex) const;
 
+  /// \brief Appends the raw memory of all blocks to \a out_Data, one memcpy per block.
+  ///
+  /// Together with RestoreRawData() this allows to save and restore the state of all objects with plain memory copies,
+  /// which is only valid for types that don't own any memory.
+  void CopyRawData(ezDynamicArrayBase<ezUInt8>& out_Data) const;
+
+  /// \brief Overwrites all objects with data that was previously retrieved through CopyRawData().
+  ///
+  /// The storage must contain the same objects at the same places as when the data was copied. For free list storage the memory of
+  /// unused entries is not touched, since it holds the free list.
+  void RestoreRawData(ezArrayPtr<const ezUInt8> data);
+
 private:
   void Delete(T* pObject, T*& out_pMovedObject, ezTraitInt<ezBlockStorageType::Compact>);
   void Delete(T* pObject, T*& out_pMovedObject, ezTraitInt<ezBlockStorageType::FreeList>);
@@ -215,6 +215,63 @@ EZ_ALWAYS_INLINE typename ezBlockStorage<T, BlockSize, StorageType>::ConstIterat
   return ConstIterator(*this, uiStartIndex, uiCount);
 }
 
+template <typename T, ezUInt32 BlockSize, ezBlockStorageType::Enum StorageType>
+void ezBlockStorage<T, BlockSize, StorageType>::CopyRawData(ezDynamicArrayBase<ezUInt8>& out_Data) const
+{
+  ezUInt32 uiOffset = out_Data.GetCount();
+  out_Data.SetCountUninitialized(uiOffset + m_uiCount * sizeof(T));
+
+  for (const ezDataBlock<T, BlockSize>& block : m_Blocks)
+  {
+    const ezUInt32 uiBlockSize = block.m_uiCount * sizeof(T);
+    ezMemoryUtils::RawByteCopy(out_Data.GetData() + uiOffset, block.m_pData, uiBlockSize);
+    uiOffset += uiBlockSize;
+  }
+}
+
+template <typename T, ezUInt32 BlockSize, ezBlockStorageType::Enum StorageType>
+void ezBlockStorage<T, BlockSize, StorageType>::RestoreRawData(ezArrayPtr<const ezUInt8> data)
+{
+  EZ_ASSERT_DEV(data.GetCount() == m_uiCount * sizeof(T), "Raw data size does not match, the storage has changed since the data was copied");
+
+  const ezUInt8* pSource = data.GetPtr();
+
+  for (ezUInt32 uiBlockIndex = 0; uiBlockIndex < m_Blocks.GetCount(); ++uiBlockIndex)
+  {
+    ezDataBlock<T, BlockSize>& block = m_Blocks[uiBlockIndex];
+
+    if (StorageType == ezBlockStorageType::Compact)
+    {
+      ezMemoryUtils::RawByteCopy(block.m_pData, pSource, block.m_uiCount * sizeof(T));
+    }
+    else
+    {
+      // copy consecutive runs of used entries
+      const ezUInt32 uiFirstIndex = uiBlockIndex * ezDataBlock<T, BlockSize>::CAPACITY;
+      ezUInt32 uiInnerIndex = 0;
+      while (uiInnerIndex < block.m_uiCount)
+      {
+        if (!m_UsedEntries.IsBitSet(uiFirstIndex + uiInnerIndex))
+        {
+          ++uiInnerIndex;
+          continue;
+        }
+
+        ezUInt32 uiRunEnd = uiInnerIndex + 1;
+        while (uiRunEnd < block.m_uiCount && m_UsedEntries.IsBitSet(uiFirstIndex + uiRunEnd))
+        {
+          ++uiRunEnd;
+        }
+
+        ezMemoryUtils::RawByteCopy(block.m_pData + uiInnerIndex, pSource + uiInnerIndex * sizeof(T), (uiRunEnd - uiInnerIndex) * sizeof(T));
+        uiInnerIndex = uiRunEnd;
+      }
+    }
+
+    pSource += block.m_uiCount * sizeof(T);
+  }
+}
+
 template <typename T, ezUInt32 BlockSize, ezBlockStorageType::Enum StorageType>
 EZ_FORCE_INLINE void ezBlockStorage<T, BlockSize, StorageType>::Delete(T* pObject, T*& out_pMovedObject, ezTraitInt<ezBlockStorageType::Compact>)
 {
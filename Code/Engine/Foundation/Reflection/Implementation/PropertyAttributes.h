@@ -740,6 +740,46 @@ class EZ_FOUNDATION_DLL ezAutoGenVisScriptMsgHandler : public ezPropertyAttribut
   EZ_ADD_DYNAMIC_REFLECTION(ezAutoGenVisScriptMsgHandler, ezPropertyAttribute);
 };
 
+/// \brief Attribute for ezMessages to allow ezWorld to dispatch queued messages of this type in parallel.
+///
+/// Messages of such a type that are queued for different game objects are delivered from multiple threads at the same time,
+/// messages for the same game object are still delivered in order on one thread. Thus the message handlers may only modify the
+/// receiving object and its components and may only read other parts of the world. Posting messages is allowed.
+/// This only has an effect if parallel message dispatch is enabled for the world, see ezWorldDesc::m_bParallelMessageDispatch.
+class EZ_FOUNDATION_DLL ezParallelMessageDispatchAttribute : public ezPropertyAttribute
+{
+  EZ_ADD_DYNAMIC_REFLECTION(ezParallelMessageDispatchAttribute, ezPropertyAttribute);
+};
+
+/// \brief Attribute for component types to allow ezWorldReader to deserialize components of this type on multiple threads.
+///
+/// DeserializeComponent() of such a type may only read from the given ezWorldReader and modify the component itself.
+/// It must not access the world or any other component, since those may be modified at the same time.
+/// The attribute is not inherited, derived component types have to add it again if their DeserializeComponent() follows these rules as well.
+class EZ_FOUNDATION_DLL ezParallelDeserializationAttribute : public ezPropertyAttribute
+{
+  EZ_ADD_DYNAMIC_REFLECTION(ezParallelDeserializationAttribute, ezPropertyAttribute);
+};
+
+/// \brief Attribute for component types whose state should be stored in an ezWorldSnapshot.
+///
+/// By default the components are stored through SerializeComponent() and restored through DeserializeComponent().
+/// If \a bCopyMemory is set, the component memory is copied as is instead, which is much faster. This is only allowed for component types
+/// that don't own any memory or other resources, i.e. all members must be trivially copyable (handles, numbers, vectors etc.).
+class EZ_FOUNDATION_DLL ezComponentSnapshotAttribute : public ezPropertyAttribute
+{
+  EZ_ADD_DYNAMIC_REFLECTION(ezComponentSnapshotAttribute, ezPropertyAttribute);
+
+public:
+  ezComponentSnapshotAttribute() {}
+  ezComponentSnapshotAttribute(bool bCopyMemory) { m_bCopyMemory = bCopyMemory; }
+
+  bool GetCopyMemory() const { return m_bCopyMemory; }
+
+private:
+  bool m_bCopyMemory = false;
+};
+
 /// \brief Attribute to mark a function up to be exposed to the scripting system. Arguments specify the names of the function parameters.
 class EZ_FOUNDATION_DLL ezScriptableFunctionAttribute : public ezPropertyAttribute
 {
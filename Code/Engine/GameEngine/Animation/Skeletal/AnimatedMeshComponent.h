@@ -2,6 +2,7 @@
 
 #include <GameEngine/GameEngineDLL.h>
 #include <RendererCore/AnimationSystem/AnimationGraph/AnimationClipSampler.h>
+#include <RendererCore/AnimationSystem/AnimationLocalPose.h>
 #include <RendererCore/AnimationSystem/AnimationPose.h>
 #include <RendererCore/Meshes/SkinnedMeshComponent.h>
 
@@ -9,7 +10,27 @@ struct ezSkeletonResourceDescriptor;
 typedef ezTypedResourceHandle<class ezAnimationClipResource> ezAnimationClipResourceHandle;
 typedef ezTypedResourceHandle<class ezSkeletonResource> ezSkeletonResourceHandle;
 
-typedef ezComponentManagerSimple<class ezAnimatedMeshComponent, ezComponentUpdateType::WhenSimulating> ezAnimatedMeshComponentManager;
+/// \brief Updates all animated meshes in two steps.
+///
+/// Sampling the animation and computing the object space pose and the skinning matrices only touches data of the component itself,
+/// so this step runs in parallel for all components. Afterwards everything that modifies the world (messages, root motion, debug
+/// visualization) is done serially.
+///
+/// Components are kept in free list storage like ezComponentManagerSimple does, so deleting a component doesn't move others in memory.
+class EZ_GAMEENGINE_DLL ezAnimatedMeshComponentManager : public ezComponentManager<class ezAnimatedMeshComponent, ezBlockStorageType::FreeList>
+{
+  typedef ezComponentManager<ezAnimatedMeshComponent, ezBlockStorageType::FreeList> SUPER;
+
+public:
+  ezAnimatedMeshComponentManager(ezWorld* pWorld);
+
+  virtual void Initialize() override;
+
+private:
+  void Update(const ezWorldModule::UpdateContext& context);
+
+  ezDynamicArray<ezAnimatedMeshComponent*> m_ComponentsToUpdate;
+};
 
 class EZ_GAMEENGINE_DLL ezAnimatedMeshComponent : public ezSkinnedMeshComponent
 {
@@ -48,14 +69,23 @@ public:
 
 
 protected:
-  void Update();
+  friend class ezAnimatedMeshComponentManager;
+
+  /// \brief Samples the animation and computes the new pose and skinning matrices. Does not modify anything outside of this component.
+  bool EvaluatePose();
+
+  /// \brief Sends the pose update message, applies root motion and draws the debug visualization. Called after EvaluatePose().
+  void ApplyPose();
+
   void CreatePhysicsShapes(const ezSkeletonResourceDescriptor& skeleton, const ezAnimationPose& pose);
 
   void* m_pRagdoll = nullptr;
 
   bool m_bApplyRootMotion = false;
   bool m_bVisualizeSkeleton = false;
+  ezAnimationLocalPose m_LocalPose;
   ezAnimationPose m_AnimationPose;
+  ezTransform m_RootMotion;
   ezSkeletonResourceHandle m_hSkeleton;
   ezAnimationClipSampler m_AnimationClipSampler;
 };
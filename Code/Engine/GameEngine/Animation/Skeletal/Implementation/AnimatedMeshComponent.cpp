@@ -2,6 +2,7 @@
 
 #include <Core/WorldSerializer/WorldReader.h>
 #include <Core/WorldSerializer/WorldWriter.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <GameEngine/Animation/Skeletal/AnimatedMeshComponent.h>
 #include <Interfaces/PhysicsWorldModule.h>
 #include <RendererCore/AnimationSystem/AnimationClipResource.h>
@@ -77,6 +78,7 @@ void ezAnimatedMeshComponent::OnSimulationStarted()
     ezResourceLock<ezSkeletonResource> pSkeleton(m_hSkeleton, ezResourceAcquireMode::BlockTillLoaded);
 
     const ezSkeleton& skeleton = pSkeleton->GetDescriptor().m_Skeleton;
+    m_LocalPose.Configure(skeleton);
     m_AnimationPose.Configure(skeleton);
     m_AnimationPose.ConvertFromLocalSpaceToObjectSpace(skeleton);
 
@@ -153,22 +155,36 @@ void ezAnimatedMeshComponent::SetAnimationSpeed(float speed)
   m_AnimationClipSampler.SetPlaybackSpeed(speed);
 }
 
-void ezAnimatedMeshComponent::Update()
+bool ezAnimatedMeshComponent::EvaluatePose()
 {
   if (!m_AnimationClipSampler.GetAnimationClip().IsValid() || !m_hSkeleton.IsValid())
-    return;
+    return false;
 
   ezResourceLock<ezSkeletonResource> pSkeleton(m_hSkeleton, ezResourceAcquireMode::AllowLoadingFallback);
   const ezSkeleton& skeleton = pSkeleton->GetDescriptor().m_Skeleton;
 
-  ezTransform rootMotion;
-  rootMotion.SetIdentity();
+  m_RootMotion.SetIdentity();
 
-  m_AnimationPose.SetToBindPoseInLocalSpace(skeleton);
+  // sample and concatenate in the SoA local pose, only the object space result is stored as matrices
+  m_LocalPose.SetToBindPose(skeleton);
   m_AnimationClipSampler.Step(GetWorld()->GetClock().GetTimeDiff());
-  m_AnimationClipSampler.Execute(skeleton, m_AnimationPose, &rootMotion);
+  m_AnimationClipSampler.Execute(skeleton, m_LocalPose, &m_RootMotion);
+
+  m_LocalPose.ConvertToObjectSpace(skeleton, m_AnimationPose);
+
+  // write the skinning matrices directly into the frame allocated render data, the pose itself stays in object space
+  ezArrayPtr<ezMat4> pRenderMatrices = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), ezMat4, m_AnimationPose.GetTransformCount());
+  m_AnimationPose.ConvertFromObjectSpaceToSkinningSpace(skeleton, pRenderMatrices);
+
+  m_SkinningMatrices = pRenderMatrices;
 
-  m_AnimationPose.ConvertFromLocalSpaceToObjectSpace(skeleton);
+  return true;
+}
+
+void ezAnimatedMeshComponent::ApplyPose()
+{
+  ezResourceLock<ezSkeletonResource> pSkeleton(m_hSkeleton, ezResourceAcquireMode::AllowLoadingFallback);
+  const ezSkeleton& skeleton = pSkeleton->GetDescriptor().m_Skeleton;
 
   if (m_bVisualizeSkeleton)
   {
@@ -176,7 +192,6 @@ void ezAnimatedMeshComponent::Update()
   }
 
   // inform child nodes/components that a new skinning pose is available
-  // do this before the pose is transformed into skinning space
   {
     ezMsgAnimationPoseUpdated msg;
     msg.m_pSkeleton = &skeleton;
@@ -185,20 +200,13 @@ void ezAnimatedMeshComponent::Update()
     GetOwner()->SendMessageRecursive(msg);
   }
 
-  m_AnimationPose.ConvertFromObjectSpaceToSkinningSpace(skeleton);
-
-  ezArrayPtr<ezMat4> pRenderMatrices = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), ezMat4, m_AnimationPose.GetTransformCount());
-  ezMemoryUtils::Copy(pRenderMatrices.GetPtr(), m_AnimationPose.GetAllTransforms().GetPtr(), m_AnimationPose.GetTransformCount());
-
-  m_SkinningMatrices = pRenderMatrices;
-
   if (m_bApplyRootMotion)
   {
     auto* pOwner = GetOwner();
 
     const ezQuat qOldRot = pOwner->GetLocalRotation();
-    const ezVec3 vNewPos = qOldRot * (rootMotion.m_vPosition * pOwner->GetGlobalScaling().x) + pOwner->GetLocalPosition();
-    const ezQuat qNewRot = rootMotion.m_qRotation * qOldRot;
+    const ezVec3 vNewPos = qOldRot * (m_RootMotion.m_vPosition * pOwner->GetGlobalScaling().x) + pOwner->GetLocalPosition();
+    const ezQuat qNewRot = m_RootMotion.m_qRotation * qOldRot;
 
     pOwner->SetLocalPosition(vNewPos);
     pOwner->SetLocalRotation(qNewRot);
@@ -235,5 +243,54 @@ public:
 ezAnimatedMeshComponentPatch_4_5 g_ezAnimatedMeshComponentPatch_4_5;
 
 
+//////////////////////////////////////////////////////////////////////////
+
+ezAnimatedMeshComponentManager::ezAnimatedMeshComponentManager(ezWorld* pWorld)
+  : SUPER(pWorld)
+{
+}
+
+void ezAnimatedMeshComponentManager::Initialize()
+{
+  SUPER::Initialize();
+
+  auto desc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ezAnimatedMeshComponentManager::Update, this);
+  desc.m_bOnlyUpdateWhenSimulating = true;
+
+  RegisterUpdateFunction(desc);
+}
+
+void ezAnimatedMeshComponentManager::Update(const ezWorldModule::UpdateContext& context)
+{
+  m_ComponentsToUpdate.Clear();
+
+  for (auto it = this->m_ComponentStorage.GetIterator(context.m_uiFirstComponentIndex, context.m_uiComponentCount); it.IsValid(); ++it)
+  {
+    ezAnimatedMeshComponent* pComponent = it;
+    if (pComponent->IsActiveAndInitialized())
+    {
+      m_ComponentsToUpdate.PushBack(pComponent);
+    }
+  }
+
+  ezTaskSystem::ParallelForSingle(m_ComponentsToUpdate.GetArrayPtr(),
+    [](ezAnimatedMeshComponent*& pComponent) {
+      if (!pComponent->EvaluatePose())
+      {
+        pComponent = nullptr;
+      }
+    },
+    "EvaluateAnimationPoses");
+
+  for (ezAnimatedMeshComponent* pComponent : m_ComponentsToUpdate)
+  {
+    if (pComponent != nullptr)
+    {
+      pComponent->ApplyPose();
+    }
+  }
+}
+
+
 
 EZ_STATICLINK_FILE(GameEngine, GameEngine_Animation_Implementation_AnimatedMeshComponent);
@@ -229,11 +229,8 @@ void ezMotionMatchingComponent::Update()
       const ezUInt16 uiSkeletonJointIdx = skeleton.FindJointByName(sJointName);
       if (uiSkeletonJointIdx != ezInvalidJointIndex)
       {
-        ezArrayPtr<const ezTransform> pTransforms0 = animDesc0.GetJointKeyframes(uiAnimJointIdx0);
-        ezArrayPtr<const ezTransform> pTransforms1 = animDesc1.GetJointKeyframes(uiAnimJointIdx1);
-
-        const ezTransform jointTransform1 = pTransforms0[m_Keyframe0.m_uiKeyframe];
-        const ezTransform jointTransform2 = pTransforms1[m_Keyframe1.m_uiKeyframe];
+        const ezTransform jointTransform1 = animDesc0.GetJointKeyframe(uiAnimJointIdx0, m_Keyframe0.m_uiKeyframe);
+        const ezTransform jointTransform2 = animDesc1.GetJointKeyframe(uiAnimJointIdx1, m_Keyframe1.m_uiKeyframe);
 
         ezTransform res;
         res.m_vPosition = ezMath::Lerp(jointTransform1.m_vPosition, jointTransform2.m_vPosition, m_fKeyframeLerp);
@@ -253,9 +250,9 @@ void ezMotionMatchingComponent::Update()
       vRootMotion1.SetZero();
 
       if (animDesc0.HasRootMotion())
-        vRootMotion0 = animDesc0.GetJointKeyframes(animDesc0.GetRootMotionJoint())[m_Keyframe0.m_uiKeyframe].m_vPosition;
+        vRootMotion0 = animDesc0.GetJointKeyframe(animDesc0.GetRootMotionJoint(), m_Keyframe0.m_uiKeyframe).m_vPosition;
       if (animDesc1.HasRootMotion())
-        vRootMotion1 = animDesc1.GetJointKeyframes(animDesc1.GetRootMotionJoint())[m_Keyframe1.m_uiKeyframe].m_vPosition;
+        vRootMotion1 = animDesc1.GetJointKeyframe(animDesc1.GetRootMotionJoint(), m_Keyframe1.m_uiKeyframe).m_vPosition;
 
       const ezVec3 vRootMotion =
         ezMath::Lerp(vRootMotion0, vRootMotion1, m_fKeyframeLerp) * fKeyframeFraction * pOwner->GetGlobalScaling().x;
@@ -295,10 +292,9 @@ void ezMotionMatchingComponent::Update()
     m_vRightFootPos = tRight.m_vPosition;
   }
 
-  m_AnimationPose.ConvertFromObjectSpaceToSkinningSpace(skeleton);
-
+  // write the skinning matrices directly into the frame allocated render data, the pose itself stays in object space
   ezArrayPtr<ezMat4> pRenderMatrices = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), ezMat4, m_AnimationPose.GetTransformCount());
-  ezMemoryUtils::Copy(pRenderMatrices.GetPtr(), m_AnimationPose.GetAllTransforms().GetPtr(), m_AnimationPose.GetTransformCount());
+  m_AnimationPose.ConvertFromObjectSpaceToSkinningSpace(skeleton, pRenderMatrices);
 
   m_SkinningMatrices = pRenderMatrices;
 }
@@ -431,7 +427,7 @@ void ezMotionMatchingComponent::PrecomputeMotion(ezDynamicArray<MotionData>& mot
       const ezUInt16 uiJointIndexInPose = skeleton.FindJointByName(jointNamesToIndices.GetKey(b));
       if (uiJointIndexInPose != ezInvalidJointIndex)
       {
-        const ezTransform jointTransform = animClip.GetJointKeyframes(jointNamesToIndices.GetValue(b))[uiFrameIdx];
+        const ezTransform jointTransform = animClip.GetJointKeyframe(jointNamesToIndices.GetValue(b), uiFrameIdx);
 
         pose.SetTransform(uiJointIndexInPose, jointTransform.GetAsMat4());
       }
@@ -446,7 +442,7 @@ void ezMotionMatchingComponent::PrecomputeMotion(ezDynamicArray<MotionData>& mot
     md.m_uiKeyframeIndex = uiFrameIdx;
     md.m_vLeftFootVelocity.SetZero();
     md.m_vRightFootVelocity.SetZero();
-    md.m_vRootVelocity = animClip.HasRootMotion() ? fRootMotionToVelocity * animClip.GetJointKeyframes(uiRootJoint)[uiFrameIdx].m_vPosition
+    md.m_vRootVelocity = animClip.HasRootMotion() ? fRootMotionToVelocity * animClip.GetJointKeyframe(uiRootJoint, uiFrameIdx).m_vPosition
                                                   : ezVec3::ZeroVector();
   }
 
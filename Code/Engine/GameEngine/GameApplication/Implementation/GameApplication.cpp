@@ -3,6 +3,7 @@
 #include <Core/Input/InputManager.h>
 #include <Core/ResourceManager/ResourceManager.h>
 #include <Core/World/World.h>
+#include <Core/World/WorldGroup.h>
 #include <Foundation/Communication/GlobalEvent.h>
 #include <Foundation/Communication/Telemetry.h>
 #include <Foundation/Configuration/Startup.h>
@@ -192,7 +193,7 @@ void ezGameApplication::UpdateWorldsAndExtractViews()
 
   Run_BeforeWorldUpdate();
 
-  static ezHybridArray<ezWorld*, 16> worldsToUpdate;
+  static ezWorldGroup worldsToUpdate;
   worldsToUpdate.Clear();
 
   auto mainViews = ezRenderWorld::GetMainViews();
@@ -203,28 +204,22 @@ void ezGameApplication::UpdateWorldsAndExtractViews()
     {
       ezWorld* pWorld = pView->GetWorld();
 
-      if (pWorld != nullptr && !worldsToUpdate.Contains(pWorld))
+      if (pWorld != nullptr)
       {
-        worldsToUpdate.PushBack(pWorld);
+        worldsToUpdate.AddWorld(pWorld);
       }
     }
   }
 
   if (ezRenderWorld::GetUseMultithreadedRendering())
   {
-    ezTaskGroupID updateWorldsTaskID = ezTaskSystem::CreateTaskGroup(ezTaskPriority::EarlyThisFrame);
-    for (ezUInt32 i = 0; i < worldsToUpdate.GetCount(); ++i)
-    {
-      ezTaskSystem::AddTaskToGroup(updateWorldsTaskID, worldsToUpdate[i]->GetUpdateTask());
-    }
-    ezTaskSystem::StartTaskGroup(updateWorldsTaskID);
-    ezTaskSystem::WaitForGroup(updateWorldsTaskID);
+    worldsToUpdate.Update();
   }
   else
   {
-    for (ezUInt32 i = 0; i < worldsToUpdate.GetCount(); ++i)
+    for (ezUInt32 i = 0; i < worldsToUpdate.GetWorldCount(); ++i)
     {
-      ezWorld* pWorld = worldsToUpdate[i];
+      ezWorld* pWorld = worldsToUpdate.GetWorld(i);
       EZ_LOCK(pWorld->GetWriteMarker());
 
       pWorld->Update();
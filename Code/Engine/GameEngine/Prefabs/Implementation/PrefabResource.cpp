@@ -24,6 +24,8 @@ void ezPrefabResource::InstantiatePrefab(ezWorld& world, const ezTransform& root
   if (GetLoadingState() != ezResourceState::Loaded)
     return;
 
+  ezUniquePtr<ezWorldReader> pWorldReader = AcquireWorldReader();
+
   if (pExposedParamValues != nullptr && !pExposedParamValues->IsEmpty())
   {
     ezHybridArray<ezGameObject*, 8> createdRootObjects;
@@ -32,14 +34,61 @@ void ezPrefabResource::InstantiatePrefab(ezWorld& world, const ezTransform& root
     if (out_CreatedRootObjects == nullptr)
       out_CreatedRootObjects = &createdRootObjects;
 
-    m_WorldReader.InstantiatePrefab(world, rootTransform, hParent, out_CreatedRootObjects, &createdChildObjects, pOverrideTeamID, bForceDynamic);
+    pWorldReader->InstantiatePrefab(world, rootTransform, hParent, out_CreatedRootObjects, &createdChildObjects, pOverrideTeamID, bForceDynamic);
 
     ApplyExposedParameterValues(pExposedParamValues, createdChildObjects, *out_CreatedRootObjects);
   }
   else
   {
-    m_WorldReader.InstantiatePrefab(world, rootTransform, hParent, out_CreatedRootObjects, nullptr, pOverrideTeamID, bForceDynamic);
+    pWorldReader->InstantiatePrefab(world, rootTransform, hParent, out_CreatedRootObjects, nullptr, pOverrideTeamID, bForceDynamic);
   }
+
+  ReleaseWorldReader(std::move(pWorldReader));
+}
+
+ezUniquePtr<ezWorldReader::InstantiationContext> ezPrefabResource::InstantiatePrefabTimeSliced(ezWorld& world, const ezTransform& rootTransform,
+                                                                                                ezGameObjectHandle hParent, const ezUInt16* pOverrideTeamID,
+                                                                                                bool bForceDynamic, ezTime maxStepTime)
+{
+  if (GetLoadingState() != ezResourceState::Loaded)
+    return nullptr;
+
+  ezUniquePtr<ezWorldReader> pWorldReader = AcquireWorldReader();
+  ezUniquePtr<ezWorldReader::InstantiationContext> pContext =
+    pWorldReader->InstantiatePrefabTimeSliced(world, rootTransform, hParent, pOverrideTeamID, bForceDynamic, maxStepTime);
+
+  // the context uses the reader in every step, which can happen in parallel to other instantiations
+  pContext->TakeOwnershipOfWorldReader(std::move(pWorldReader));
+  return pContext;
+}
+
+ezUniquePtr<ezWorldReader> ezPrefabResource::AcquireWorldReader()
+{
+  {
+    EZ_LOCK(m_WorldReaderMutex);
+
+    if (!m_FreeWorldReaders.IsEmpty())
+    {
+      ezUniquePtr<ezWorldReader> pWorldReader = std::move(m_FreeWorldReaders.PeekBack());
+      m_FreeWorldReaders.PopBack();
+      return pWorldReader;
+    }
+  }
+
+  // the world description is not modified while the resource is loaded, so it can be read without the lock
+  ezUniquePtr<ezWorldReader> pWorldReader = EZ_DEFAULT_NEW(ezWorldReader);
+
+  ezMemoryStreamReader reader(&m_WorldDescription);
+  pWorldReader->ReadWorldDescription(reader);
+
+  return pWorldReader;
+}
+
+void ezPrefabResource::ReleaseWorldReader(ezUniquePtr<ezWorldReader>&& pWorldReader)
+{
+  EZ_LOCK(m_WorldReaderMutex);
+
+  m_FreeWorldReaders.PushBack(std::move(pWorldReader));
 }
 
 void ezPrefabResource::ApplyExposedParameterValues(const ezArrayMap<ezHashedString, ezVariant>* pExposedParamValues,
@@ -100,7 +149,11 @@ ezResourceLoadDesc ezPrefabResource::UnloadData(Unload WhatToUnload)
 
   if (WhatToUnload == ezResource::Unload::AllQualityLevels)
   {
-    m_WorldReader.ClearAndCompact();
+    EZ_LOCK(m_WorldReaderMutex);
+
+    m_FreeWorldReaders.Clear();
+    m_WorldDescription.Clear();
+    m_WorldDescription.Compact();
   }
 
   return res;
@@ -141,13 +194,25 @@ ezResourceLoadDesc ezPrefabResource::UpdateContent(ezStreamReader* Stream)
     return res;
   }
 
-  m_WorldReader.ReadWorldDescription(s);
+  // keep the world description, so that instantiations that happen at the same time can each read it into their own world reader
+  m_WorldDescription.ReadAll(s);
+
+  ezMemoryStreamReader reader(&m_WorldDescription);
+
+  {
+    ezUniquePtr<ezWorldReader> pWorldReader = EZ_DEFAULT_NEW(ezWorldReader);
+    pWorldReader->ReadWorldDescription(reader);
+
+    EZ_LOCK(m_WorldReaderMutex);
+    m_FreeWorldReaders.Clear();
+    m_FreeWorldReaders.PushBack(std::move(pWorldReader));
+  }
 
   if (AssetHash.GetFileVersion() >= 4)
   {
     ezUInt32 uiExposedParams = 0;
 
-    s >> uiExposedParams;
+    reader >> uiExposedParams;
 
     m_PrefabParamDescs.SetCount(uiExposedParams);
 
@@ -155,7 +220,7 @@ ezResourceLoadDesc ezPrefabResource::UpdateContent(ezStreamReader* Stream)
     {
       auto& ppd = m_PrefabParamDescs[i];
 
-      ppd.Load(s);
+      ppd.Load(reader);
 
       // initialize the cached property path here once
       // so we can only apply it later as often as needed
@@ -189,7 +254,15 @@ ezResourceLoadDesc ezPrefabResource::UpdateContent(ezStreamReader* Stream)
 void ezPrefabResource::UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage)
 {
   out_NewMemoryUsage.m_uiMemoryGPU = 0;
-  out_NewMemoryUsage.m_uiMemoryCPU = (ezUInt32)(m_WorldReader.GetHeapMemoryUsage() + sizeof(this));
+  EZ_LOCK(m_WorldReaderMutex);
+
+  ezUInt64 uiMemory = m_WorldDescription.GetHeapMemoryUsage() + m_FreeWorldReaders.GetHeapMemoryUsage() + sizeof(this);
+  for (const auto& pWorldReader : m_FreeWorldReaders)
+  {
+    uiMemory += sizeof(ezWorldReader) + pWorldReader->GetHeapMemoryUsage();
+  }
+
+  out_NewMemoryUsage.m_uiMemoryCPU = (ezUInt32)uiMemory;
 }
 
 EZ_RESOURCE_IMPLEMENT_CREATEABLE(ezPrefabResource, ezPrefabResourceDescriptor)
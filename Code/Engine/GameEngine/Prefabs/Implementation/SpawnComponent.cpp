@@ -8,7 +8,7 @@
 //////////////////////////////////////////////////////////////////////////
 
 // clang-format off
-EZ_BEGIN_COMPONENT_TYPE(ezSpawnComponent, 2, ezComponentMode::Static)
+EZ_BEGIN_COMPONENT_TYPE(ezSpawnComponent, 3, ezComponentMode::Static)
 {
   EZ_BEGIN_PROPERTIES
   {
@@ -19,6 +19,7 @@ EZ_BEGIN_COMPONENT_TYPE(ezSpawnComponent, 2, ezComponentMode::Static)
     EZ_MEMBER_PROPERTY("MinDelay", m_MinDelay)->AddAttributes(new ezClampValueAttribute(ezTime(), ezVariant()), new ezDefaultValueAttribute(ezTime::Seconds(1.0))),
     EZ_MEMBER_PROPERTY("DelayRange", m_DelayRange)->AddAttributes(new ezClampValueAttribute(ezTime(), ezVariant())),
     EZ_MEMBER_PROPERTY("Deviation", m_MaxDeviation)->AddAttributes(new ezClampValueAttribute(ezAngle(), ezAngle::Degree(179.0))),
+    EZ_MEMBER_PROPERTY("InstantiationTimeBudget", m_InstantiationTimeBudget)->AddAttributes(new ezClampValueAttribute(ezTime(), ezVariant())),
   }
   EZ_END_PROPERTIES;
   EZ_BEGIN_ATTRIBUTES
@@ -58,6 +59,14 @@ void ezSpawnComponent::OnSimulationStarted()
   }
 }
 
+void ezSpawnComponent::OnDeactivated()
+{
+  // remove everything that has not been fully spawned yet
+  CancelPendingInstantiations();
+
+  SUPER::OnDeactivated();
+}
+
 
 bool ezSpawnComponent::SpawnOnce(const ezVec3& vLocalOffset)
 {
@@ -98,16 +107,90 @@ void ezSpawnComponent::DoSpawn(const ezTransform& tLocalSpawn)
 {
   ezResourceLock<ezPrefabResource> pResource(m_hPrefab, ezResourceAcquireMode::AllowLoadingFallback);
 
+  ezTransform tSpawn = tLocalSpawn;
+  ezGameObjectHandle hParent;
+
   if (m_SpawnFlags.IsAnySet(ezSpawnComponentFlags::AttachAsChild))
   {
-    pResource->InstantiatePrefab(*GetWorld(), tLocalSpawn, GetOwner()->GetHandle(), nullptr, &GetOwner()->GetTeamID(), nullptr, false);
+    hParent = GetOwner()->GetHandle();
   }
   else
   {
-    ezTransform tGlobalSpawn;
-    tGlobalSpawn.SetGlobalTransform(GetOwner()->GetGlobalTransform(), tLocalSpawn);
+    tSpawn.SetGlobalTransform(GetOwner()->GetGlobalTransform(), tLocalSpawn);
+  }
+
+  if (m_InstantiationTimeBudget.IsPositive())
+  {
+    AddPendingInstantiation(
+      pResource->InstantiatePrefabTimeSliced(*GetWorld(), tSpawn, hParent, &GetOwner()->GetTeamID(), false, m_InstantiationTimeBudget),
+      pResource->GetCurrentResourceChangeCounter());
+  }
+  else
+  {
+    pResource->InstantiatePrefab(*GetWorld(), tSpawn, hParent, nullptr, &GetOwner()->GetTeamID(), nullptr, false);
+  }
+}
+
+void ezSpawnComponent::AddPendingInstantiation(ezUniquePtr<ezWorldReader::InstantiationContext>&& pContext, ezUInt32 uiPrefabChangeCounter)
+{
+  if (pContext == nullptr)
+    return;
+
+  // the first step is done right away
+  if (pContext->Step())
+    return;
+
+  auto& pending = m_PendingInstantiations.ExpandAndGetRef();
+  pending.m_pContext = std::move(pContext);
+  pending.m_uiPrefabChangeCounter = uiPrefabChangeCounter;
+
+  if (m_PendingInstantiations.GetCount() == 1)
+  {
+    ezMsgComponentInternalTrigger msg;
+    msg.m_uiUsageStringHash = ezTempHashedString::ComputeHash("instantiation_step");
 
-    pResource->InstantiatePrefab(*GetWorld(), tGlobalSpawn, ezGameObjectHandle(), nullptr, &GetOwner()->GetTeamID(), nullptr, false);
+    PostMessage(msg, ezObjectMsgQueueType::NextFrame);
+  }
+}
+
+void ezSpawnComponent::StepPendingInstantiations()
+{
+  ezUInt32 uiPrefabChangeCounter = ezInvalidIndex;
+
+  if (m_hPrefab.IsValid())
+  {
+    ezResourceLock<ezPrefabResource> pResource(m_hPrefab, ezResourceAcquireMode::PointerOnly);
+
+    if (pResource->GetLoadingState() == ezResourceState::Loaded)
+    {
+      uiPrefabChangeCounter = pResource->GetCurrentResourceChangeCounter();
+    }
+  }
+
+  for (ezUInt32 i = m_PendingInstantiations.GetCount(); i-- > 0;)
+  {
+    auto& pending = m_PendingInstantiations[i];
+
+    // the prefab has been reloaded or unloaded since, the context would read from data that doesn't exist anymore
+    if (pending.m_uiPrefabChangeCounter != uiPrefabChangeCounter)
+    {
+      pending.m_pContext->Cancel();
+      m_PendingInstantiations.RemoveAtAndCopy(i);
+      continue;
+    }
+
+    if (pending.m_pContext->Step())
+    {
+      m_PendingInstantiations.RemoveAtAndCopy(i);
+    }
+  }
+
+  if (!m_PendingInstantiations.IsEmpty())
+  {
+    ezMsgComponentInternalTrigger msg;
+    msg.m_uiUsageStringHash = ezTempHashedString::ComputeHash("instantiation_step");
+
+    PostMessage(msg, ezObjectMsgQueueType::NextFrame);
   }
 }
 
@@ -141,12 +224,15 @@ void ezSpawnComponent::SerializeComponent(ezWorldWriter& stream) const
   s << m_DelayRange;
   s << m_MaxDeviation;
   s << m_LastManualSpawn;
+
+  // version 3
+  s << m_InstantiationTimeBudget;
 }
 
 void ezSpawnComponent::DeserializeComponent(ezWorldReader& stream)
 {
   SUPER::DeserializeComponent(stream);
-  // const ezUInt32 uiVersion = stream.GetComponentTypeVersion(GetStaticRTTI());
+  const ezUInt32 uiVersion = stream.GetComponentTypeVersion(GetStaticRTTI());
 
   auto& s = stream.GetStream();
 
@@ -160,6 +246,11 @@ void ezSpawnComponent::DeserializeComponent(ezWorldReader& stream)
   s >> m_DelayRange;
   s >> m_MaxDeviation;
   s >> m_LastManualSpawn;
+
+  if (uiVersion >= 3)
+  {
+    s >> m_InstantiationTimeBudget;
+  }
 }
 
 bool ezSpawnComponent::CanTriggerManualSpawn() const
@@ -232,9 +323,25 @@ void ezSpawnComponent::SetAttachAsChild(bool b)
 
 void ezSpawnComponent::SetPrefab(const ezPrefabResourceHandle& hPrefab)
 {
+  if (m_hPrefab == hPrefab)
+    return;
+
+  // the pending instantiations read from the data of the previous prefab, which is not kept alive by anything
+  CancelPendingInstantiations();
+
   m_hPrefab = hPrefab;
 }
 
+void ezSpawnComponent::CancelPendingInstantiations()
+{
+  for (auto& pending : m_PendingInstantiations)
+  {
+    pending.m_pContext->Cancel();
+  }
+
+  m_PendingInstantiations.Clear();
+}
+
 void ezSpawnComponent::OnTriggered(ezMsgComponentInternalTrigger& msg)
 {
   if (msg.m_uiUsageStringHash == ezTempHashedString::ComputeHash("scheduled_spawn"))
@@ -253,6 +360,10 @@ void ezSpawnComponent::OnTriggered(ezMsgComponentInternalTrigger& msg)
   {
     TriggerManualSpawn();
   }
+  else if (msg.m_uiUsageStringHash == ezTempHashedString::ComputeHash("instantiation_step"))
+  {
+    StepPendingInstantiations();
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////
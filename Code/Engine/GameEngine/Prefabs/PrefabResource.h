@@ -3,7 +3,9 @@
 #include <Core/ResourceManager/Resource.h>
 #include <Core/WorldSerializer/WorldReader.h>
 #include <Foundation/Containers/ArrayMap.h>
+#include <Foundation/IO/MemoryStream.h>
 #include <Foundation/Reflection/PropertyPath.h>
+#include <Foundation/Threading/Mutex.h>
 #include <GameEngine/GameEngineDLL.h>
 
 typedef ezTypedResourceHandle<class ezPrefabResource> ezPrefabResourceHandle;
@@ -35,10 +37,21 @@ public:
   ezPrefabResource();
 
   /// \brief Creates an instance of this prefab in the given world.
+  ///
+  /// May be called for several worlds at the same time, e.g. from worlds that are updated in parallel through an ezWorldGroup.
   void InstantiatePrefab(ezWorld& world, const ezTransform& rootTransform, ezGameObjectHandle hParent,
                          ezHybridArray<ezGameObject*, 8>* out_CreatedRootObjects, const ezUInt16* pOverrideTeamID,
                          const ezArrayMap<ezHashedString, ezVariant>* pExposedParamValues, bool bForceDynamic);
 
+  /// \brief Creates an instance of this prefab in the given world, spread over multiple frames.
+  ///
+  /// Call ezWorldReader::InstantiationContext::Step() on the returned context once per frame, until it returns true.
+  /// Exposed parameters are not supported. Returns nullptr if the prefab is not loaded.
+  /// The returned context uses its own world reader, so it stays valid when this resource gets unloaded.
+  ezUniquePtr<ezWorldReader::InstantiationContext> InstantiatePrefabTimeSliced(ezWorld& world, const ezTransform& rootTransform,
+                                                                                ezGameObjectHandle hParent, const ezUInt16* pOverrideTeamID,
+                                                                                bool bForceDynamic, ezTime maxStepTime);
+
   void ApplyExposedParameterValues(const ezArrayMap<ezHashedString, ezVariant>* pExposedParamValues,
                                    const ezHybridArray<ezGameObject*, 8>& createdChildObjects,
                                    const ezHybridArray<ezGameObject*, 8>& createdRootObjects) const;
@@ -51,7 +64,14 @@ private:
 private:
   ezUInt32 FindFirstParamWithName(ezUInt32 uiNameHash) const;
 
-  ezWorldReader m_WorldReader;
+  ezUniquePtr<ezWorldReader> AcquireWorldReader();
+  void ReleaseWorldReader(ezUniquePtr<ezWorldReader>&& pWorldReader);
+
+  // An ezWorldReader keeps the state of the instantiation that it currently does, so every instantiation uses its own reader.
+  // Additional readers are created from the stored world description on demand and reused afterwards.
+  ezMutex m_WorldReaderMutex;
+  ezMemoryStreamStorage m_WorldDescription;
+  ezDynamicArray<ezUniquePtr<ezWorldReader>> m_FreeWorldReaders;
   ezDynamicArray<ezExposedPrefabParameterDesc> m_PrefabParamDescs;
 };
 
@@ -31,7 +31,8 @@ struct ezSpawnComponentFlags
 
 EZ_DECLARE_FLAGS_OPERATORS(ezSpawnComponentFlags);
 
-typedef ezComponentManager<class ezSpawnComponent, ezBlockStorageType::Compact> ezSpawnComponentManager;
+// uses a free list, since pending instantiations cannot be copied when components get compacted
+typedef ezComponentManager<class ezSpawnComponent, ezBlockStorageType::FreeList> ezSpawnComponentManager;
 
 class EZ_GAMEENGINE_DLL ezSpawnComponent : public ezComponent
 {
@@ -46,6 +47,7 @@ public:
 
 protected:
   virtual void OnSimulationStarted() override;
+  virtual void OnDeactivated() override;
 
 
   //////////////////////////////////////////////////////////////////////////
@@ -83,9 +85,13 @@ public:
   bool GetAttachAsChild() const; // [ property ]
   void SetAttachAsChild(bool b); // [ property ]
 
+  /// \brief Sets the prefab to spawn. Cancels all spawns of a different prefab that are still in progress.
   void SetPrefab(const ezPrefabResourceHandle& hPrefab);
   EZ_ALWAYS_INLINE const ezPrefabResourceHandle& GetPrefab() const { return m_hPrefab; }
 
+  /// \brief Whether a spawned prefab is still being instantiated. Only happens with a non-zero instantiation time budget.
+  bool IsSpawnInProgress() const { return !m_PendingInstantiations.IsEmpty(); }
+
   /// The minimum delay between spawning objects. This is also enforced for manually spawning things.
   ezTime m_MinDelay; // [ property ]
 
@@ -95,6 +101,10 @@ public:
   /// The spawned object's orientation may deviate by this amount around the X axis. 180° is completely random orientation.
   ezAngle m_MaxDeviation; // [ property ]
 
+  /// If non-zero, the spawned prefab is instantiated over multiple frames, spending roughly this much time per frame.
+  /// The spawned objects become active once the instantiation is finished.
+  ezTime m_InstantiationTimeBudget; // [ property ]
+
 
 protected:
   ezBitflags<ezSpawnComponentFlags> m_SpawnFlags;
@@ -103,6 +113,20 @@ protected:
   bool SpawnOnce(const ezVec3& vLocalOffset);
   void OnTriggered(ezMsgComponentInternalTrigger& msg);
 
+  void AddPendingInstantiation(ezUniquePtr<ezWorldReader::InstantiationContext>&& pContext, ezUInt32 uiPrefabChangeCounter);
+  void StepPendingInstantiations();
+  void CancelPendingInstantiations();
+
   ezTime m_LastManualSpawn;
   ezPrefabResourceHandle m_hPrefab;
+
+  struct PendingInstantiation
+  {
+    ezUniquePtr<ezWorldReader::InstantiationContext> m_pContext;
+
+    /// The context reads from the data of the prefab resource, so it has to be canceled once the prefab gets reloaded.
+    ezUInt32 m_uiPrefabChangeCounter = 0;
+  };
+
+  ezHybridArray<PendingInstantiation, 1> m_PendingInstantiations;
 };
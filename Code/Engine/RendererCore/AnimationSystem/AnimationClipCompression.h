@@ -0,0 +1,100 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Math/Transform.h>
+#include <Foundation/SimdMath/SimdTransform.h>
+#include <RendererCore/RendererCoreDLL.h>
+
+class ezStreamWriter;
+class ezStreamReader;
+
+/// \brief The error tolerances that are used when compressing an animation clip.
+struct EZ_RENDERERCORE_DLL ezAnimationClipCompressionSettings
+{
+  /// \brief How far (in object units) a reconstructed joint position may deviate from the source data.
+  float m_fMaxPositionError = 0.0005f;
+
+  /// \brief How much (in radians) a reconstructed joint rotation may deviate from the source data.
+  float m_fMaxRotationError = 0.001f;
+
+  /// \brief How much a reconstructed joint scale may deviate from the source data.
+  float m_fMaxScaleError = 0.0005f;
+};
+
+/// \brief Stores the keyframes of an animation clip in a compressed format and decompresses them on the fly during sampling.
+///
+/// Every joint has one track for its rotation, position and scale. Each track is compressed individually:
+///  * Tracks whose value does not change (within the error tolerance) are reduced to a single key.
+///  * Keys that can be reconstructed from their neighbors through linear interpolation are removed.
+///  * Rotations are quantized to 48 bits using the 'smallest three' encoding.
+///  * Positions and scales are quantized to 16 bits per component, relative to the value range of their track.
+///
+/// Each remaining key takes 8 bytes (6 bytes value, 2 bytes frame index), compared to 40 bytes for an uncompressed ezTransform.
+/// Note that the 16 bit quantization error is not affected by the tolerances, tracks with very large value ranges may therefore exceed
+/// the position or scale tolerance slightly.
+class EZ_RENDERERCORE_DLL ezCompressedAnimationClip
+{
+public:
+  /// \brief Compresses the given keyframes. \a jointTransforms must contain \a uiNumFrames transforms for each joint, stored joint by joint.
+  void Compress(ezUInt16 uiNumFrames, ezArrayPtr<const ezTransform> jointTransforms, const ezAnimationClipCompressionSettings& settings);
+
+  /// \brief Removes all data.
+  void Clear();
+
+  /// \brief Whether any data has been compressed.
+  bool IsEmpty() const { return m_Tracks.IsEmpty(); }
+
+  ezUInt16 GetNumJoints() const { return static_cast<ezUInt16>(m_Tracks.GetCount() / TrackType::Count); }
+  ezUInt16 GetNumFrames() const { return m_uiNumFrames; }
+
+  /// \brief Returns the number of keys that remained after compression, over all tracks.
+  ezUInt32 GetNumKeys() const { return m_KeyFrames.GetCount(); }
+
+  /// \brief Reconstructs the transform of a joint between \a uiKeyframe0 and the next keyframe.
+  ezSimdTransform SampleJoint(ezUInt16 uiJoint, ezUInt16 uiKeyframe0, float fLerp) const;
+
+  void Save(ezStreamWriter& stream) const;
+
+  /// \brief Fails and leaves the clip empty if the data was written by an unknown version.
+  ezResult Load(ezStreamReader& stream);
+
+  ezUInt64 GetHeapMemoryUsage() const;
+
+private:
+  struct TrackType
+  {
+    enum Enum
+    {
+      Rotation,
+      Position,
+      Scale,
+
+      Count
+    };
+  };
+
+  struct Track
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    /// For position and scale tracks, the smallest value in the track and the size of one quantization step. Unused for rotations.
+    ezVec3 m_vRangeMin;
+    ezVec3 m_vRangeStep;
+    ezUInt32 m_uiFirstKey;
+    ezUInt32 m_uiNumKeys;
+  };
+
+  void CompressTrack(TrackType::Enum type, ezArrayPtr<const ezTransform> frames, float fMaxError);
+  ezSimdVec4f SampleTrack(const Track& track, bool bRotation, ezUInt16 uiKeyframe0, float fLerp) const;
+
+  ezUInt16 m_uiNumFrames = 0;
+
+  /// Three tracks per joint: rotation, position, scale.
+  ezDynamicArray<Track> m_Tracks;
+
+  /// The frame index of each key, sorted per track.
+  ezDynamicArray<ezUInt16> m_KeyFrames;
+
+  /// Three quantized values per key.
+  ezDynamicArray<ezUInt16> m_KeyValues;
+};
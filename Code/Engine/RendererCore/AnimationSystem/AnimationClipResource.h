@@ -3,9 +3,11 @@
 #include <Core/ResourceManager/Resource.h>
 #include <Foundation/Containers/ArrayMap.h>
 #include <Foundation/Strings/HashedString.h>
+#include <RendererCore/AnimationSystem/AnimationClipCompression.h>
 #include <RendererCore/RendererCoreDLL.h>
 
 class ezAnimationPose;
+class ezAnimationLocalPose;
 class ezSkeleton;
 
 struct EZ_RENDERERCORE_DLL ezAnimationClipResourceDescriptor
@@ -25,11 +27,22 @@ public:
   /// \brief returns ezInvalidJointIndex if no joint with the given name is known
   ezUInt16 FindJointIndexByName(const ezTempHashedString& sJointName) const;
 
+  /// \brief Gives direct access to the uncompressed keyframes of a joint. Must not be called once the clip is compressed.
   ezArrayPtr<const ezTransform> GetJointKeyframes(ezUInt16 uiJoint) const;
   ezArrayPtr<ezTransform> GetJointKeyframes(ezUInt16 uiJoint);
 
+  /// \brief Returns the transform of a joint at the given keyframe. Works for compressed and uncompressed clips.
+  ezTransform GetJointKeyframe(ezUInt16 uiJoint, ezUInt16 uiKeyframe) const;
+
+  /// \brief Compresses the keyframes with the given error tolerances and discards the uncompressed data.
+  ///
+  /// Afterwards GetJointKeyframes() cannot be used anymore, all sampling goes through the compressed representation.
+  void Compress(const ezAnimationClipCompressionSettings& settings);
+
+  bool IsCompressed() const { return !m_CompressedClip.IsEmpty(); }
+
   void Save(ezStreamWriter& stream) const;
-  void Load(ezStreamReader& stream);
+  ezResult Load(ezStreamReader& stream);
 
   ezUInt64 GetHeapMemoryUsage() const;
 
@@ -42,6 +55,9 @@ public:
   void SetPoseToKeyframe(ezAnimationPose& pose, const ezSkeleton& skeleton, ezUInt16 uiKeyframe) const;
   void SetPoseToBlendedKeyframe(ezAnimationPose& pose, const ezSkeleton& skeleton, ezUInt16 uiKeyframe0, float fBlendToKeyframe1) const;
 
+  /// \brief Same as SetPoseToBlendedKeyframe(), but samples into a local space SoA pose, which can then be blended with other poses.
+  void SetLocalPoseToBlendedKeyframe(ezAnimationLocalPose& pose, const ezSkeleton& skeleton, ezUInt16 uiKeyframe0, float fBlendToKeyframe1) const;
+
 private:
   ezUInt16 m_uiNumJoints = 0;
   ezUInt16 m_uiNumFrames = 0;
@@ -50,6 +66,7 @@ private:
   ezTime m_Duration;
 
   ezDynamicArray<ezTransform> m_JointTransforms;
+  ezCompressedAnimationClip m_CompressedClip;
   ezArrayMap<ezHashedString, ezUInt16> m_JointNameToIndex;
 };
 
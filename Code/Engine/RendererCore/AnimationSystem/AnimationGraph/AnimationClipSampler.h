@@ -3,6 +3,7 @@
 #include <RendererCore/AnimationSystem/AnimationGraph/AnimationGraphNode.h>
 
 struct ezAnimationClipResourceDescriptor;
+class ezAnimationLocalPose;
 class ezStreamWriter;
 class ezStreamReader;
 
@@ -22,6 +23,9 @@ public:
   virtual void Step(ezTime tDiff) override;
   virtual bool Execute(const ezSkeleton& skeleton, ezAnimationPose& currentPose, ezTransform* pRootMotion) override;
 
+  /// \brief Same as Execute(), but samples the clip into a local space SoA pose.
+  bool Execute(const ezSkeleton& skeleton, ezAnimationLocalPose& currentPose, ezTransform* pRootMotion);
+
   void Save(ezStreamWriter& stream) const;
   void Load(ezStreamReader& stream);
 
@@ -45,6 +49,7 @@ public:
 
 private:
   void AdjustSampleTime();
+  bool PrepareSampling(const ezAnimationClipResourceDescriptor& animDesc, ezUInt16& out_uiFirstFrame, float& out_fLerp, ezTransform* pRootMotion);
   ezTransform ComputeRootMotion(const ezAnimationClipResourceDescriptor& animDesc, ezTime tPrev, ezTime tNow) const;
 
   ezAnimationClipSamplerState m_State = ezAnimationClipSamplerState::Stopped;
@@ -2,6 +2,7 @@
 
 #include <Core/ResourceManager/ResourceManager.h>
 #include <RendererCore/AnimationSystem/AnimationClipResource.h>
+#include <RendererCore/AnimationSystem/AnimationLocalPose.h>
 #include <RendererCore/AnimationSystem/AnimationGraph/AnimationClipSampler.h>
 #include <RendererCore/AnimationSystem/Skeleton.h>
 #include <RendererCore/AnimationSystem/SkeletonResource.h>
@@ -33,8 +34,46 @@ bool ezAnimationClipSampler::Execute(const ezSkeleton& skeleton, ezAnimationPose
   if (pAnimClip.GetAcquireResult() != ezResourceAcquireResult::Final)
     return false;
 
+  const auto& animDesc = pAnimClip->GetDescriptor();
+
+  ezUInt16 uiFirstFrame = 0;
+  float fAnimLerp = 0.0f;
+  if (!PrepareSampling(animDesc, uiFirstFrame, fAnimLerp, pRootMotion))
+    return false;
+
+  animDesc.SetPoseToBlendedKeyframe(currentPose, skeleton, uiFirstFrame, fAnimLerp);
+
+  return true;
+}
+
+bool ezAnimationClipSampler::Execute(const ezSkeleton& skeleton, ezAnimationLocalPose& currentPose, ezTransform* pRootMotion)
+{
+  // early out, when this is already known
+  if (m_State == ezAnimationClipSamplerState::Stopped)
+    return false;
+
+  // allow animation streaming, don't block
+  ezResourceLock<ezAnimationClipResource> pAnimClip(m_hAnimationClip, ezResourceAcquireMode::AllowLoadingFallback);
+  if (pAnimClip.GetAcquireResult() != ezResourceAcquireResult::Final)
+    return false;
+
+  const auto& animDesc = pAnimClip->GetDescriptor();
+
+  ezUInt16 uiFirstFrame = 0;
+  float fAnimLerp = 0.0f;
+  if (!PrepareSampling(animDesc, uiFirstFrame, fAnimLerp, pRootMotion))
+    return false;
+
+  animDesc.SetLocalPoseToBlendedKeyframe(currentPose, skeleton, uiFirstFrame, fAnimLerp);
+
+  return true;
+}
+
+bool ezAnimationClipSampler::PrepareSampling(
+  const ezAnimationClipResourceDescriptor& animDesc, ezUInt16& out_uiFirstFrame, float& out_fLerp, ezTransform* pRootMotion)
+{
   // make sure we now know the animation clip length
-  m_ClipDuration = pAnimClip->GetDescriptor().GetDuration();
+  m_ClipDuration = animDesc.GetDuration();
 
   AdjustSampleTime();
 
@@ -42,10 +81,9 @@ bool ezAnimationClipSampler::Execute(const ezSkeleton& skeleton, ezAnimationPose
   if (m_State == ezAnimationClipSamplerState::Stopped)
     return false;
 
-  const auto& animDesc = pAnimClip->GetDescriptor();
-
   double fAnimLerp = 0;
-  const ezUInt32 uiFirstFrame = animDesc.GetFrameAt(m_SampleTime, fAnimLerp);
+  out_uiFirstFrame = animDesc.GetFrameAt(m_SampleTime, fAnimLerp);
+  out_fLerp = (float)fAnimLerp;
 
   if (pRootMotion)
   {
@@ -59,8 +97,6 @@ bool ezAnimationClipSampler::Execute(const ezSkeleton& skeleton, ezAnimationPose
     }
   }
 
-  animDesc.SetPoseToBlendedKeyframe(currentPose, skeleton, uiFirstFrame, (float)fAnimLerp);
-
   return true;
 }
 
@@ -175,14 +211,12 @@ ezTransform ezAnimationClipSampler::ComputeRootMotion(const ezAnimationClipResou
   double fAnimLerpLast = 0;
   const ezUInt32 uiLastFrame = animDesc.GetFrameAt(tNow, fAnimLerpLast);
 
-  ezArrayPtr<const ezTransform> pKeyframes = animDesc.GetJointKeyframes(uiRootMotionJoint);
-
   ezTransform res;
   res.SetIdentity();
 
   if (uiFirstFrame == uiLastFrame)
   {
-    const ezTransform rm = pKeyframes[uiFirstFrame];
+    const ezTransform rm = animDesc.GetJointKeyframe(uiRootMotionJoint, uiFirstFrame);
 
     const float fFraction = (float)(fAnimLerpLast - fAnimLerpFirst);
 
@@ -192,7 +226,7 @@ ezTransform ezAnimationClipSampler::ComputeRootMotion(const ezAnimationClipResou
   else
   {
     {
-      const ezTransform rm = pKeyframes[uiFirstFrame];
+      const ezTransform rm = animDesc.GetJointKeyframe(uiRootMotionJoint, uiFirstFrame);
 
       const float fFraction = (float)(1.0 - fAnimLerpFirst);
 
@@ -202,7 +236,7 @@ ezTransform ezAnimationClipSampler::ComputeRootMotion(const ezAnimationClipResou
 
     for (ezUInt32 i = uiFirstFrame + 1; i < uiLastFrame; ++i)
     {
-      const ezTransform rm = pKeyframes[i];
+      const ezTransform rm = animDesc.GetJointKeyframe(uiRootMotionJoint, i);
 
       res.m_vPosition += rm.m_vPosition;
       // rotation
@@ -210,7 +244,7 @@ ezTransform ezAnimationClipSampler::ComputeRootMotion(const ezAnimationClipResou
 
 
     {
-      const ezTransform rm = pKeyframes[uiLastFrame];
+      const ezTransform rm = animDesc.GetJointKeyframe(uiRootMotionJoint, uiLastFrame);
 
       const float fFraction = (float)fAnimLerpLast;
 
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <RendererCore/AnimationSystem/Declarations.h>
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/SimdMath/SimdTransform.h>
+
+/// \brief Stores the local space transform of every joint of a skeleton in a structure-of-arrays layout.
+///
+/// Animation clips are sampled and blended in local space. Keeping positions, rotations and scales in separate, aligned arrays allows
+/// to process all joints with SIMD instructions and blend any number of poses in a single pass.
+/// ConvertToObjectSpace() then produces the ezAnimationPose that is used for visualization and skinning.
+class EZ_RENDERERCORE_DLL ezAnimationLocalPose
+{
+public:
+  ezAnimationLocalPose();
+  ~ezAnimationLocalPose();
+
+  /// \brief Allocates storage for all joints of the skeleton and sets the pose to the bind pose.
+  void Configure(const ezSkeleton& skeleton);
+
+  /// \brief Sets all transforms to the local bind pose of the skeleton.
+  void SetToBindPose(const ezSkeleton& skeleton);
+
+  /// \brief Returns the number of joints in the pose.
+  ezUInt16 GetJointCount() const { return static_cast<ezUInt16>(m_Rotations.GetCount()); }
+
+  void SetTransform(ezUInt16 uiJoint, const ezSimdTransform& transform);
+  ezSimdTransform GetTransform(ezUInt16 uiJoint) const;
+
+  /// \brief Blends all given poses into this pose, in one pass over all joints.
+  ///
+  /// The weights are normalized, so they don't need to add up to one. Rotations are blended with a normalized lerp,
+  /// each rotation is flipped into the hemisphere of the rotation of the first pose before it is accumulated.
+  /// All poses must have the same joint count. This pose may be one of the input poses.
+  void SetToBlendedPoses(ezArrayPtr<const ezAnimationLocalPose* const> poses, ezArrayPtr<const float> weights);
+
+  /// \brief Concatenates the parent transforms in hierarchy order and writes the resulting object space transforms into \a out_Pose.
+  ///
+  /// \a out_Pose must have been configured for the same skeleton. All its transforms are marked as valid.
+  void ConvertToObjectSpace(const ezSkeleton& skeleton, ezAnimationPose& out_Pose) const;
+
+private:
+  ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper> m_Positions;
+  ezDynamicArray<ezSimdQuat, ezAlignedAllocatorWrapper> m_Rotations;
+  ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper> m_Scales;
+};
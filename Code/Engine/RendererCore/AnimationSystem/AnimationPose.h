@@ -36,6 +36,12 @@ public:
   /// This is typically the very last operation done on a pose before it is sent to the GPU for skinning.
   void ConvertFromObjectSpaceToSkinningSpace(const ezSkeleton& skeleton);
 
+  /// \brief Same as ConvertFromObjectSpaceToSkinningSpace(), but writes the skinning matrices into \a out_SkinningMatrices and leaves this
+  /// pose in object space.
+  ///
+  /// This allows to write the result directly into the buffer that is passed to the renderer, instead of copying it afterwards.
+  void ConvertFromObjectSpaceToSkinningSpace(const ezSkeleton& skeleton, ezArrayPtr<ezMat4> out_SkinningMatrices) const;
+
   const ezMat4& GetTransform(ezUInt16 uiJointIndex) const { return m_Transforms[uiJointIndex]; }
 
   ezArrayPtr<const ezMat4> GetAllTransforms() const { return m_Transforms.GetArrayPtr(); }
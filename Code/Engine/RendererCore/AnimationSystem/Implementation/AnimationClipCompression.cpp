@@ -0,0 +1,406 @@
+#include <RendererCorePCH.h>
+
+#include <Foundation/IO/Stream.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/SimdMath/SimdVec4i.h>
+#include <RendererCore/AnimationSystem/AnimationClipCompression.h>
+
+namespace
+{
+  // the three smallest components of a normalized quaternion are always within [-1/sqrt(2); +1/sqrt(2)]
+  constexpr float s_fSmallestThreeRange = 0.70710678f;
+  constexpr float s_fRotationQuantize = 32767.0f / (2.0f * s_fSmallestThreeRange);
+  constexpr float s_fRotationDequantize = (2.0f * s_fSmallestThreeRange) / 32767.0f;
+
+  void EncodeRotation(const ezSimdVec4f& vQuat, ezUInt16* pOut)
+  {
+    float c[4];
+    vQuat.Store<4>(c);
+
+    ezUInt32 uiLargest = 0;
+    for (ezUInt32 i = 1; i < 4; ++i)
+    {
+      if (ezMath::Abs(c[i]) > ezMath::Abs(c[uiLargest]))
+        uiLargest = i;
+    }
+
+    // q and -q are the same rotation, make sure the dropped component is positive, so that it can be reconstructed
+    const float fSign = c[uiLargest] < 0.0f ? -1.0f : 1.0f;
+
+    ezUInt32 uiOut = 0;
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      if (i == uiLargest)
+        continue;
+
+      const float fValue = (c[i] * fSign + s_fSmallestThreeRange) * s_fRotationQuantize;
+      pOut[uiOut++] = static_cast<ezUInt16>(ezMath::Clamp(ezMath::Round(fValue), 0.0f, 32767.0f));
+    }
+
+    // the index of the dropped component is stored in the top bits of the first two values
+    pOut[0] |= static_cast<ezUInt16>((uiLargest >> 1) << 15);
+    pOut[1] |= static_cast<ezUInt16>((uiLargest & 1) << 15);
+  }
+
+  EZ_ALWAYS_INLINE ezSimdVec4f DecodeRotation(const ezUInt16* pKey)
+  {
+    const ezUInt32 uiLargest = ((pKey[0] >> 15) << 1) | (pKey[1] >> 15);
+
+    ezSimdVec4f vSmallest = ezSimdVec4i(pKey[0] & 0x7FFF, pKey[1] & 0x7FFF, pKey[2] & 0x7FFF, 0).ToFloat();
+    vSmallest = ezSimdVec4f::MulAdd(vSmallest, ezSimdFloat(s_fRotationDequantize), ezSimdVec4f(-s_fSmallestThreeRange));
+
+    const float fLargest = ezMath::Sqrt(ezMath::Max(0.0f, 1.0f - (float)vSmallest.GetLengthSquared<3>()));
+
+    float s[4];
+    vSmallest.Store<4>(s);
+
+    float c[4];
+    ezUInt32 uiIn = 0;
+    for (ezUInt32 i = 0; i < 4; ++i)
+    {
+      c[i] = (i == uiLargest) ? fLargest : s[uiIn++];
+    }
+
+    ezSimdVec4f vResult;
+    vResult.Load<4>(c);
+    return vResult;
+  }
+
+  EZ_ALWAYS_INLINE ezSimdVec4f DecodeVec3(const ezUInt16* pKey, const ezSimdVec4f& vRangeMin, const ezSimdVec4f& vRangeStep)
+  {
+    return ezSimdVec4f::MulAdd(ezSimdVec4i(pKey[0], pKey[1], pKey[2], 0).ToFloat(), vRangeStep, vRangeMin);
+  }
+
+  EZ_ALWAYS_INLINE ezSimdVec4f InterpolateRotation(const ezSimdVec4f& vQuat0, ezSimdVec4f vQuat1, const ezSimdFloat& fLerp)
+  {
+    // take the shorter way, the encoding does not preserve the sign of the quaternion
+    if (vQuat0.Dot<4>(vQuat1) < 0.0f)
+      vQuat1 = -vQuat1;
+
+    // normalized lerp is close enough to a slerp between neighboring keys and much cheaper
+    return ezSimdVec4f::Lerp(vQuat0, vQuat1, ezSimdVec4f(fLerp)).GetNormalized<4>();
+  }
+
+  EZ_ALWAYS_INLINE ezSimdVec4f InterpolateVec3(const ezSimdVec4f& v0, const ezSimdVec4f& v1, const ezSimdFloat& fLerp)
+  {
+    return ezSimdVec4f::Lerp(v0, v1, ezSimdVec4f(fLerp));
+  }
+} // namespace
+
+void ezCompressedAnimationClip::Compress(ezUInt16 uiNumFrames, ezArrayPtr<const ezTransform> jointTransforms,
+                                         const ezAnimationClipCompressionSettings& settings)
+{
+  EZ_ASSERT_DEV(uiNumFrames > 0 && jointTransforms.GetCount() % uiNumFrames == 0, "Invalid number of joint transforms");
+
+  Clear();
+
+  m_uiNumFrames = uiNumFrames;
+
+  const ezUInt32 uiNumJoints = jointTransforms.GetCount() / uiNumFrames;
+  m_Tracks.Reserve(uiNumJoints * TrackType::Count);
+
+  for (ezUInt32 uiJoint = 0; uiJoint < uiNumJoints; ++uiJoint)
+  {
+    ezArrayPtr<const ezTransform> frames = jointTransforms.GetSubArray(uiJoint * uiNumFrames, uiNumFrames);
+
+    CompressTrack(TrackType::Rotation, frames, settings.m_fMaxRotationError);
+    CompressTrack(TrackType::Position, frames, settings.m_fMaxPositionError);
+    CompressTrack(TrackType::Scale, frames, settings.m_fMaxScaleError);
+  }
+
+  m_KeyFrames.Compact();
+  m_KeyValues.Compact();
+}
+
+void ezCompressedAnimationClip::Clear()
+{
+  m_uiNumFrames = 0;
+  m_Tracks.Clear();
+  m_KeyFrames.Clear();
+  m_KeyValues.Clear();
+}
+
+void ezCompressedAnimationClip::CompressTrack(TrackType::Enum type, ezArrayPtr<const ezTransform> frames, float fMaxError)
+{
+  const bool bRotation = (type == TrackType::Rotation);
+  const ezUInt32 uiNumFrames = frames.GetCount();
+
+  // gather the source values of this track
+  ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper> values;
+  values.SetCountUninitialized(uiNumFrames);
+
+  for (ezUInt32 f = 0; f < uiNumFrames; ++f)
+  {
+    switch (type)
+    {
+      case TrackType::Rotation:
+      {
+        ezSimdVec4f q = ezSimdConversion::ToQuat(frames[f].m_qRotation).m_v.GetNormalized<4>();
+
+        // keep all keys in the same hemisphere, so that the error computation below compares the right values
+        if (f > 0 && values[f - 1].Dot<4>(q) < 0.0f)
+          q = -q;
+
+        values[f] = q;
+        break;
+      }
+
+      case TrackType::Position:
+        values[f] = ezSimdConversion::ToVec3(frames[f].m_vPosition);
+        break;
+
+      case TrackType::Scale:
+        values[f] = ezSimdConversion::ToVec3(frames[f].m_vScale);
+        break;
+
+      default:
+        EZ_ASSERT_NOT_IMPLEMENTED;
+    }
+  }
+
+  auto IsWithinError = [&](const ezSimdVec4f& vReconstructed, const ezSimdVec4f& vSource) -> bool {
+    if (bRotation)
+    {
+      const float fDot = ezMath::Min(ezMath::Abs((float)vReconstructed.Dot<4>(vSource)), 1.0f);
+      return 2.0f * ezMath::ACos(fDot).GetRadian() <= fMaxError;
+    }
+
+    return (vReconstructed - vSource).GetLength<3>() <= fMaxError;
+  };
+
+  Track& track = m_Tracks.ExpandAndGetRef();
+  track.m_uiFirstKey = m_KeyFrames.GetCount();
+  track.m_uiNumKeys = 0;
+  track.m_vRangeMin.SetZero();
+  track.m_vRangeStep.SetZero();
+
+  bool bConstant = true;
+  for (ezUInt32 f = 1; f < uiNumFrames && bConstant; ++f)
+  {
+    bConstant = IsWithinError(values[0], values[f]);
+  }
+
+  if (!bRotation)
+  {
+    if (bConstant)
+    {
+      // stored exactly, all keys quantize to zero
+      track.m_vRangeMin = ezSimdConversion::ToVec3(values[0]);
+    }
+    else
+    {
+      ezSimdVec4f vMin = values[0];
+      ezSimdVec4f vMax = values[0];
+
+      for (ezUInt32 f = 1; f < uiNumFrames; ++f)
+      {
+        vMin = vMin.CompMin(values[f]);
+        vMax = vMax.CompMax(values[f]);
+      }
+
+      track.m_vRangeMin = ezSimdConversion::ToVec3(vMin);
+      track.m_vRangeStep = ezSimdConversion::ToVec3((vMax - vMin) * ezSimdFloat(1.0f / 65535.0f));
+    }
+  }
+
+  // quantize all frames, the key elimination has to work with the values that the sampler will actually reconstruct
+  ezDynamicArray<ezUInt16> quantized;
+  quantized.SetCountUninitialized(uiNumFrames * 3);
+
+  ezDynamicArray<ezSimdVec4f, ezAlignedAllocatorWrapper> decoded;
+  decoded.SetCountUninitialized(uiNumFrames);
+
+  const ezSimdVec4f vRangeMin = ezSimdConversion::ToVec3(track.m_vRangeMin);
+  const ezSimdVec4f vRangeStep = ezSimdConversion::ToVec3(track.m_vRangeStep);
+  const ezUInt32 uiNumFramesToQuantize = bConstant ? 1 : uiNumFrames;
+
+  for (ezUInt32 f = 0; f < uiNumFramesToQuantize; ++f)
+  {
+    ezUInt16* pKey = &quantized[f * 3];
+
+    if (bRotation)
+    {
+      EncodeRotation(values[f], pKey);
+      decoded[f] = DecodeRotation(pKey);
+    }
+    else
+    {
+      const ezVec3 vValue = ezSimdConversion::ToVec3(values[f]);
+      const float* fValue = vValue.GetData();
+      const float* fMin = track.m_vRangeMin.GetData();
+      const float* fStep = track.m_vRangeStep.GetData();
+
+      for (ezUInt32 c = 0; c < 3; ++c)
+      {
+        const float fQuantized = fStep[c] > 0.0f ? ezMath::Round((fValue[c] - fMin[c]) / fStep[c]) : 0.0f;
+        pKey[c] = static_cast<ezUInt16>(ezMath::Clamp(fQuantized, 0.0f, 65535.0f));
+      }
+
+      decoded[f] = DecodeVec3(pKey, vRangeMin, vRangeStep);
+    }
+  }
+
+  auto AddKey = [&](ezUInt32 uiFrame) {
+    m_KeyFrames.PushBack(static_cast<ezUInt16>(uiFrame));
+    m_KeyValues.PushBack(quantized[uiFrame * 3 + 0]);
+    m_KeyValues.PushBack(quantized[uiFrame * 3 + 1]);
+    m_KeyValues.PushBack(quantized[uiFrame * 3 + 2]);
+    ++track.m_uiNumKeys;
+  };
+
+  AddKey(0);
+
+  if (bConstant)
+    return;
+
+  // checks whether all frames between the two keys can be reconstructed through interpolation
+  auto CanInterpolate = [&](ezUInt32 uiKey0, ezUInt32 uiKey1) -> bool {
+    const float fInvRange = 1.0f / (uiKey1 - uiKey0);
+
+    for (ezUInt32 f = uiKey0 + 1; f < uiKey1; ++f)
+    {
+      const ezSimdFloat fLerp = (f - uiKey0) * fInvRange;
+      const ezSimdVec4f vValue =
+        bRotation ? InterpolateRotation(decoded[uiKey0], decoded[uiKey1], fLerp) : InterpolateVec3(decoded[uiKey0], decoded[uiKey1], fLerp);
+
+      if (!IsWithinError(vValue, values[f]))
+        return false;
+    }
+
+    return true;
+  };
+
+  // greedily extend each segment as far as the error tolerance allows
+  ezUInt32 uiSegmentStart = 0;
+  while (uiSegmentStart + 1 < uiNumFrames)
+  {
+    ezUInt32 uiSegmentEnd = uiSegmentStart + 1;
+
+    while (uiSegmentEnd + 1 < uiNumFrames && CanInterpolate(uiSegmentStart, uiSegmentEnd + 1))
+    {
+      ++uiSegmentEnd;
+    }
+
+    AddKey(uiSegmentEnd);
+    uiSegmentStart = uiSegmentEnd;
+  }
+}
+
+ezSimdVec4f ezCompressedAnimationClip::SampleTrack(const Track& track, bool bRotation, ezUInt16 uiKeyframe0, float fLerp) const
+{
+  const ezUInt16* pFrames = m_KeyFrames.GetData() + track.m_uiFirstKey;
+  const ezUInt16* pValues = m_KeyValues.GetData() + track.m_uiFirstKey * 3;
+
+  if (track.m_uiNumKeys == 1)
+  {
+    if (bRotation)
+      return DecodeRotation(pValues);
+
+    return ezSimdConversion::ToVec3(track.m_vRangeMin);
+  }
+
+  // find the last key at or before the requested frame
+  ezUInt32 uiLow = 0;
+  ezUInt32 uiHigh = track.m_uiNumKeys - 1;
+  while (uiLow + 1 < uiHigh)
+  {
+    const ezUInt32 uiMid = (uiLow + uiHigh) / 2;
+
+    if (pFrames[uiMid] <= uiKeyframe0)
+      uiLow = uiMid;
+    else
+      uiHigh = uiMid;
+  }
+
+  const ezUInt32 uiKey0 = uiLow;
+  const ezUInt32 uiKey1 = uiLow + 1;
+
+  const float fSegmentLerp = ((float)(uiKeyframe0 - pFrames[uiKey0]) + fLerp) / (float)(pFrames[uiKey1] - pFrames[uiKey0]);
+  const ezSimdFloat fSimdLerp = ezMath::Clamp(fSegmentLerp, 0.0f, 1.0f);
+
+  if (bRotation)
+  {
+    return InterpolateRotation(DecodeRotation(pValues + uiKey0 * 3), DecodeRotation(pValues + uiKey1 * 3), fSimdLerp);
+  }
+
+  const ezSimdVec4f vRangeMin = ezSimdConversion::ToVec3(track.m_vRangeMin);
+  const ezSimdVec4f vRangeStep = ezSimdConversion::ToVec3(track.m_vRangeStep);
+
+  return InterpolateVec3(DecodeVec3(pValues + uiKey0 * 3, vRangeMin, vRangeStep), DecodeVec3(pValues + uiKey1 * 3, vRangeMin, vRangeStep), fSimdLerp);
+}
+
+ezSimdTransform ezCompressedAnimationClip::SampleJoint(ezUInt16 uiJoint, ezUInt16 uiKeyframe0, float fLerp) const
+{
+  const Track* pTracks = &m_Tracks[uiJoint * TrackType::Count];
+
+  ezSimdTransform result;
+  result.m_Rotation.m_v = SampleTrack(pTracks[TrackType::Rotation], true, uiKeyframe0, fLerp);
+  result.m_Position = SampleTrack(pTracks[TrackType::Position], false, uiKeyframe0, fLerp);
+  result.m_Scale = SampleTrack(pTracks[TrackType::Scale], false, uiKeyframe0, fLerp);
+  return result;
+}
+
+void ezCompressedAnimationClip::Save(ezStreamWriter& stream) const
+{
+  const ezUInt8 uiVersion = 1;
+  stream << uiVersion;
+
+  stream << m_uiNumFrames;
+
+  const ezUInt32 uiNumTracks = m_Tracks.GetCount();
+  stream << uiNumTracks;
+
+  for (const Track& track : m_Tracks)
+  {
+    stream << track.m_vRangeMin;
+    stream << track.m_vRangeStep;
+    stream << track.m_uiFirstKey;
+    stream << track.m_uiNumKeys;
+  }
+
+  stream.WriteArray(m_KeyFrames);
+  stream.WriteArray(m_KeyValues);
+}
+
+ezResult ezCompressedAnimationClip::Load(ezStreamReader& stream)
+{
+  Clear();
+
+  ezUInt8 uiVersion = 0;
+  stream >> uiVersion;
+
+  if (uiVersion != 1)
+  {
+    ezLog::Error("Invalid compressed animation clip version {0}", uiVersion);
+    return EZ_FAILURE;
+  }
+
+  stream >> m_uiNumFrames;
+
+  ezUInt32 uiNumTracks = 0;
+  stream >> uiNumTracks;
+
+  m_Tracks.SetCountUninitialized(uiNumTracks);
+
+  for (Track& track : m_Tracks)
+  {
+    stream >> track.m_vRangeMin;
+    stream >> track.m_vRangeStep;
+    stream >> track.m_uiFirstKey;
+    stream >> track.m_uiNumKeys;
+  }
+
+  stream.ReadArray(m_KeyFrames);
+  stream.ReadArray(m_KeyValues);
+
+  return EZ_SUCCESS;
+}
+
+ezUInt64 ezCompressedAnimationClip::GetHeapMemoryUsage() const
+{
+  return m_Tracks.GetHeapMemoryUsage() + m_KeyFrames.GetHeapMemoryUsage() + m_KeyValues.GetHeapMemoryUsage();
+}
+
+
+
+EZ_STATICLINK_FILE(RendererCore, RendererCore_AnimationSystem_Implementation_AnimationClipCompression);
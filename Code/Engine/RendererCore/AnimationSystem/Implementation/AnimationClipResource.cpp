@@ -1,9 +1,11 @@
 #include <RendererCorePCH.h>
 
 #include <Core/Assets/AssetFileHeader.h>
+#include <Foundation/SimdMath/SimdConversion.h>
 #include <RendererCore/AnimationSystem/AnimationClipResource.h>
-#include <RendererCore/AnimationSystem/Skeleton.h>
+#include <RendererCore/AnimationSystem/AnimationLocalPose.h>
 #include <RendererCore/AnimationSystem/AnimationPose.h>
+#include <RendererCore/AnimationSystem/Skeleton.h>
 
 // clang-format off
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezAnimationClipResource, 1, ezRTTIDefaultAllocator<ezAnimationClipResource>)
@@ -63,7 +65,11 @@ ezResourceLoadDesc ezAnimationClipResource::UpdateContent(ezStreamReader* Stream
   ezAssetFileHeader AssetHash;
   AssetHash.Read(*Stream);
 
-  m_Descriptor.Load(*Stream);
+  if (m_Descriptor.Load(*Stream).Failed())
+  {
+    res.m_State = ezResourceState::LoadedResourceMissing;
+    return res;
+  }
 
   res.m_State = ezResourceState::Loaded;
   return res;
@@ -98,6 +104,7 @@ void ezAnimationClipResourceDescriptor::Configure(ezUInt16 uiNumJoints, ezUInt16
     AddJointName(name);
   }
 
+  m_CompressedClip.Clear();
   m_JointTransforms.SetCount(uiNumTransforms);
 }
 
@@ -137,17 +144,39 @@ ezUInt16 ezAnimationClipResourceDescriptor::FindJointIndexByName(const ezTempHas
 
 ezArrayPtr<const ezTransform> ezAnimationClipResourceDescriptor::GetJointKeyframes(ezUInt16 uiJoint) const
 {
+  EZ_ASSERT_DEV(!IsCompressed(), "The keyframes of a compressed animation clip cannot be accessed directly.");
   return ezArrayPtr<const ezTransform>(&m_JointTransforms[uiJoint * m_uiNumFrames], m_uiNumFrames);
 }
 
 ezArrayPtr<ezTransform> ezAnimationClipResourceDescriptor::GetJointKeyframes(ezUInt16 uiJoint)
 {
+  EZ_ASSERT_DEV(!IsCompressed(), "The keyframes of a compressed animation clip cannot be accessed directly.");
   return ezArrayPtr<ezTransform>(&m_JointTransforms[uiJoint * m_uiNumFrames], m_uiNumFrames);
 }
 
+ezTransform ezAnimationClipResourceDescriptor::GetJointKeyframe(ezUInt16 uiJoint, ezUInt16 uiKeyframe) const
+{
+  if (IsCompressed())
+  {
+    return ezSimdConversion::ToTransform(m_CompressedClip.SampleJoint(uiJoint, uiKeyframe, 0.0f));
+  }
+
+  return m_JointTransforms[uiJoint * m_uiNumFrames + uiKeyframe];
+}
+
+void ezAnimationClipResourceDescriptor::Compress(const ezAnimationClipCompressionSettings& settings)
+{
+  EZ_ASSERT_DEV(!IsCompressed(), "Animation clip is already compressed");
+
+  m_CompressedClip.Compress(m_uiNumFrames, m_JointTransforms, settings);
+
+  m_JointTransforms.Clear();
+  m_JointTransforms.Compact();
+}
+
 void ezAnimationClipResourceDescriptor::Save(ezStreamWriter& stream) const
 {
-  const ezUInt8 uiVersion = 2;
+  const ezUInt8 uiVersion = 3;
   stream << uiVersion;
 
   stream << m_uiNumJoints;
@@ -167,13 +196,30 @@ void ezAnimationClipResourceDescriptor::Save(ezStreamWriter& stream) const
       stream << m_JointNameToIndex.GetValue(b);
     }
   }
+
+  // version 3
+  {
+    const bool bCompressed = IsCompressed();
+    stream << bCompressed;
+
+    if (bCompressed)
+    {
+      m_CompressedClip.Save(stream);
+    }
+  }
 }
 
-void ezAnimationClipResourceDescriptor::Load(ezStreamReader& stream)
+ezResult ezAnimationClipResourceDescriptor::Load(ezStreamReader& stream)
 {
   ezUInt8 uiVersion = 0;
   stream >> uiVersion;
 
+  if (uiVersion > 3)
+  {
+    ezLog::Error("Invalid animation clip version {0}", uiVersion);
+    return EZ_FAILURE;
+  }
+
   stream >> m_uiNumJoints;
   stream >> m_uiNumFrames;
   stream >> m_uiFramesPerSecond;
@@ -203,12 +249,28 @@ void ezAnimationClipResourceDescriptor::Load(ezStreamReader& stream)
     // should do nothing
     m_JointNameToIndex.Sort();
   }
+
+  m_CompressedClip.Clear();
+
+  // version 3
+  if (uiVersion >= 3)
+  {
+    bool bCompressed = false;
+    stream >> bCompressed;
+
+    if (bCompressed)
+    {
+      EZ_SUCCEED_OR_RETURN(m_CompressedClip.Load(stream));
+    }
+  }
+
+  return EZ_SUCCESS;
 }
 
 
 ezUInt64 ezAnimationClipResourceDescriptor::GetHeapMemoryUsage() const
 {
-  return m_JointTransforms.GetHeapMemoryUsage();
+  return m_JointTransforms.GetHeapMemoryUsage() + m_CompressedClip.GetHeapMemoryUsage();
 }
 
 bool ezAnimationClipResourceDescriptor::HasRootMotion() const
@@ -242,9 +304,7 @@ void ezAnimationClipResourceDescriptor::SetPoseToKeyframe(ezAnimationPose& pose,
     const ezUInt16 uiSkeletonJointIdx = skeleton.FindJointByName(sJointName);
     if (uiSkeletonJointIdx != ezInvalidJointIndex)
     {
-      ezArrayPtr<const ezTransform> pTransforms = GetJointKeyframes(uiAnimJointIdx);
-
-      pose.SetTransform(uiSkeletonJointIdx, pTransforms[uiKeyframe].GetAsMat4());
+      pose.SetTransform(uiSkeletonJointIdx, GetJointKeyframe(uiAnimJointIdx, uiKeyframe).GetAsMat4());
     }
   }
 }
@@ -259,7 +319,16 @@ void ezAnimationClipResourceDescriptor::SetPoseToBlendedKeyframe(ezAnimationPose
     const ezUInt32 uiAnimJointIdx = m_JointNameToIndex.GetValue(b);
 
     const ezUInt16 uiSkeletonJointIdx = skeleton.FindJointByName(sJointName);
-    if (uiSkeletonJointIdx != ezInvalidJointIndex)
+    if (uiSkeletonJointIdx == ezInvalidJointIndex)
+      continue;
+
+    if (IsCompressed())
+    {
+      const ezSimdTransform res = m_CompressedClip.SampleJoint(uiAnimJointIdx, uiKeyframe0, fBlendToKeyframe1);
+
+      pose.SetTransform(uiSkeletonJointIdx, ezSimdConversion::ToMat4(res.GetAsMat4()));
+    }
+    else
     {
       ezArrayPtr<const ezTransform> pTransforms = GetJointKeyframes(uiAnimJointIdx);
       const ezTransform jointTransform1 = pTransforms[uiKeyframe0];
@@ -275,6 +344,39 @@ void ezAnimationClipResourceDescriptor::SetPoseToBlendedKeyframe(ezAnimationPose
   }
 }
 
+void ezAnimationClipResourceDescriptor::SetLocalPoseToBlendedKeyframe(ezAnimationLocalPose& pose, const ezSkeleton& skeleton,
+                                                                      ezUInt16 uiKeyframe0, float fBlendToKeyframe1) const
+{
+  for (ezUInt32 b = 0; b < m_JointNameToIndex.GetCount(); ++b)
+  {
+    const ezHashedString& sJointName = m_JointNameToIndex.GetKey(b);
+    const ezUInt32 uiAnimJointIdx = m_JointNameToIndex.GetValue(b);
+
+    const ezUInt16 uiSkeletonJointIdx = skeleton.FindJointByName(sJointName);
+    if (uiSkeletonJointIdx == ezInvalidJointIndex)
+      continue;
+
+    if (IsCompressed())
+    {
+      pose.SetTransform(uiSkeletonJointIdx, m_CompressedClip.SampleJoint(uiAnimJointIdx, uiKeyframe0, fBlendToKeyframe1));
+    }
+    else
+    {
+      ezArrayPtr<const ezTransform> pTransforms = GetJointKeyframes(uiAnimJointIdx);
+      const ezSimdTransform jointTransform1 = ezSimdConversion::ToTransform(pTransforms[uiKeyframe0]);
+      const ezSimdTransform jointTransform2 = ezSimdConversion::ToTransform(pTransforms[uiKeyframe0 + 1]);
+      const ezSimdFloat fLerp = fBlendToKeyframe1;
+
+      ezSimdTransform res;
+      res.m_Position = ezSimdVec4f::Lerp(jointTransform1.m_Position, jointTransform2.m_Position, ezSimdVec4f(fLerp));
+      res.m_Rotation.SetSlerp(jointTransform1.m_Rotation, jointTransform2.m_Rotation, fLerp);
+      res.m_Scale = ezSimdVec4f::Lerp(jointTransform1.m_Scale, jointTransform2.m_Scale, ezSimdVec4f(fLerp));
+
+      pose.SetTransform(uiSkeletonJointIdx, res);
+    }
+  }
+}
+
 ezTime ezAnimationClipResourceDescriptor::GetDuration() const
 {
   return m_Duration;
@@ -0,0 +1,125 @@
+#include <RendererCorePCH.h>
+
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <RendererCore/AnimationSystem/AnimationLocalPose.h>
+#include <RendererCore/AnimationSystem/AnimationPose.h>
+#include <RendererCore/AnimationSystem/Skeleton.h>
+
+ezAnimationLocalPose::ezAnimationLocalPose() = default;
+ezAnimationLocalPose::~ezAnimationLocalPose() = default;
+
+void ezAnimationLocalPose::Configure(const ezSkeleton& skeleton)
+{
+  EZ_ASSERT_DEV(skeleton.GetJointCount() > 0, "Animation pose needs a valid skeleton which also has at least one joint!");
+
+  const ezUInt32 uiNumJoints = skeleton.GetJointCount();
+  m_Positions.SetCountUninitialized(uiNumJoints);
+  m_Rotations.SetCountUninitialized(uiNumJoints);
+  m_Scales.SetCountUninitialized(uiNumJoints);
+
+  SetToBindPose(skeleton);
+}
+
+void ezAnimationLocalPose::SetToBindPose(const ezSkeleton& skeleton)
+{
+  EZ_ASSERT_DEV(skeleton.GetJointCount() == GetJointCount(), "Pose and skeleton have different joint count!");
+
+  const ezUInt16 uiNumJoints = GetJointCount();
+  for (ezUInt16 i = 0; i < uiNumJoints; ++i)
+  {
+    SetTransform(i, ezSimdConversion::ToTransform(skeleton.GetJointByIndex(i).GetBindPoseLocalTransform()));
+  }
+}
+
+void ezAnimationLocalPose::SetTransform(ezUInt16 uiJoint, const ezSimdTransform& transform)
+{
+  m_Positions[uiJoint] = transform.m_Position;
+  m_Rotations[uiJoint] = transform.m_Rotation;
+  m_Scales[uiJoint] = transform.m_Scale;
+}
+
+ezSimdTransform ezAnimationLocalPose::GetTransform(ezUInt16 uiJoint) const
+{
+  return ezSimdTransform(m_Positions[uiJoint], m_Rotations[uiJoint], m_Scales[uiJoint]);
+}
+
+void ezAnimationLocalPose::SetToBlendedPoses(ezArrayPtr<const ezAnimationLocalPose* const> poses, ezArrayPtr<const float> weights)
+{
+  EZ_ASSERT_DEV(!poses.IsEmpty(), "At least one pose is required for blending");
+  EZ_ASSERT_DEV(poses.GetCount() == weights.GetCount(), "Every pose needs exactly one weight");
+
+  const ezUInt32 uiNumPoses = poses.GetCount();
+  const ezUInt16 uiNumJoints = poses[0]->GetJointCount();
+
+  float fTotalWeight = 0.0f;
+  for (ezUInt32 p = 0; p < uiNumPoses; ++p)
+  {
+    EZ_ASSERT_DEV(poses[p]->GetJointCount() == uiNumJoints, "Blended poses have different joint count");
+    fTotalWeight += weights[p];
+  }
+
+  EZ_ASSERT_DEV(fTotalWeight > 0.0f, "The sum of all blend weights must be positive");
+  const float fWeightNormalization = 1.0f / fTotalWeight;
+
+  m_Positions.SetCountUninitialized(uiNumJoints);
+  m_Rotations.SetCountUninitialized(uiNumJoints);
+  m_Scales.SetCountUninitialized(uiNumJoints);
+
+  for (ezUInt16 j = 0; j < uiNumJoints; ++j)
+  {
+    const ezSimdVec4f vReferenceRotation = poses[0]->m_Rotations[j].m_v;
+
+    ezSimdVec4f vPosition = ezSimdVec4f::ZeroVector();
+    ezSimdVec4f vRotation = ezSimdVec4f::ZeroVector();
+    ezSimdVec4f vScale = ezSimdVec4f::ZeroVector();
+
+    for (ezUInt32 p = 0; p < uiNumPoses; ++p)
+    {
+      const ezAnimationLocalPose& pose = *poses[p];
+      const float fPoseWeight = weights[p] * fWeightNormalization;
+      const ezSimdFloat fWeight = fPoseWeight;
+      const ezSimdVec4f vPoseRotation = pose.m_Rotations[j].m_v;
+
+      // q and -q represent the same rotation, accumulate all rotations along the shortest arc
+      const ezSimdFloat fRotationWeight = vReferenceRotation.Dot<4>(vPoseRotation) < 0.0f ? -fPoseWeight : fPoseWeight;
+
+      vPosition += pose.m_Positions[j] * fWeight;
+      vRotation += vPoseRotation * fRotationWeight;
+      vScale += pose.m_Scales[j] * fWeight;
+    }
+
+    m_Positions[j] = vPosition;
+    m_Rotations[j].m_v = vRotation.GetNormalized<4>();
+    m_Scales[j] = vScale;
+  }
+}
+
+void ezAnimationLocalPose::ConvertToObjectSpace(const ezSkeleton& skeleton, ezAnimationPose& out_Pose) const
+{
+  const ezUInt16 uiNumJoints = GetJointCount();
+
+  EZ_ASSERT_DEV(skeleton.GetJointCount() == uiNumJoints, "Pose and skeleton have different joint count!");
+  EZ_ASSERT_DEV(out_Pose.GetTransformCount() == uiNumJoints, "Output pose has a different joint count!");
+
+  // the joints are sorted such that every parent comes before its children,
+  // so the object space transform of the parent is always available in the output pose already
+  for (ezUInt16 i = 0; i < uiNumJoints; ++i)
+  {
+    const ezSimdMat4f localTransform = ezSimdTransform(m_Positions[i], m_Rotations[i], m_Scales[i]).GetAsMat4();
+    const ezUInt16 uiParentIndex = skeleton.GetJointByIndex(i).GetParentIndex();
+
+    if (uiParentIndex == ezInvalidJointIndex)
+    {
+      out_Pose.SetTransform(i, ezSimdConversion::ToMat4(localTransform));
+    }
+    else
+    {
+      const ezSimdMat4f parentTransform = ezSimdConversion::ToMat4(out_Pose.GetTransform(uiParentIndex));
+      out_Pose.SetTransform(i, ezSimdConversion::ToMat4(parentTransform * localTransform));
+    }
+  }
+}
+
+
+
+EZ_STATICLINK_FILE(RendererCore, RendererCore_AnimationSystem_Implementation_AnimationLocalPose);
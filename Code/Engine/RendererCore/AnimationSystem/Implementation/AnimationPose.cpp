@@ -1,5 +1,6 @@
 #include <RendererCorePCH.h>
 
+#include <Foundation/SimdMath/SimdConversion.h>
 #include <RendererCore/AnimationSystem/AnimationPose.h>
 #include <RendererCore/AnimationSystem/Skeleton.h>
 #include <RendererCore/Debug/DebugRenderer.h>
@@ -51,31 +52,45 @@ void ezAnimationPose::ConvertFromLocalSpaceToObjectSpace(const ezSkeleton& skele
   // Since the joints are sorted (at least no child joint comes before it's parent joint)
   // we can simply grab the already stored parent transform from the pose to get the multiplied
   // transforms up to the child joint we currently work on.
+  ezMat4* pTransforms = m_Transforms.GetData();
+
   for (ezUInt32 i = 0; i < numTransforms; ++i)
   {
-    const ezSkeletonJoint& joint = skeleton.GetJointByIndex(i);
+    const ezUInt16 uiParentIndex = skeleton.GetJointByIndex(i).GetParentIndex();
 
     // If it is a root joint the transform is already final.
-    if (!joint.IsRootJoint())
+    if (uiParentIndex != ezInvalidJointIndex)
     {
       // else grab transform of parent joint and use it to make the final transform for this joint
-      m_Transforms[i] = m_Transforms[joint.GetParentIndex()] * m_Transforms[i];
+      const ezSimdMat4f parentTransform = ezSimdConversion::ToMat4(pTransforms[uiParentIndex]);
+      pTransforms[i] = ezSimdConversion::ToMat4(parentTransform * ezSimdConversion::ToMat4(pTransforms[i]));
     }
   }
 }
 
 void ezAnimationPose::ConvertFromObjectSpaceToSkinningSpace(const ezSkeleton& skeleton)
+{
+  ConvertFromObjectSpaceToSkinningSpace(skeleton, m_Transforms.GetArrayPtr());
+}
+
+void ezAnimationPose::ConvertFromObjectSpaceToSkinningSpace(const ezSkeleton& skeleton, ezArrayPtr<ezMat4> out_SkinningMatrices) const
 {
   // TODO: store current space and assert that it is correct ?
 
   // STEP 2: multiply each joint's individual inverse-global-pose matrix into the result
 
   const ezUInt32 numTransforms = GetTransformCount();
+  ezArrayPtr<const ezSimdMat4f> inverseBindPose = skeleton.GetInverseBindPoseMatrices();
+
+  EZ_ASSERT_DEV(inverseBindPose.GetCount() == numTransforms, "Pose and skeleton have different joint count!");
+  EZ_ASSERT_DEV(out_SkinningMatrices.GetCount() >= numTransforms, "Output array is too small");
+
+  const ezMat4* pTransforms = m_Transforms.GetData();
+  ezMat4* pOutput = out_SkinningMatrices.GetPtr();
 
   for (ezUInt32 i = 0; i < numTransforms; ++i)
   {
-    const ezSkeletonJoint& joint = skeleton.GetJointByIndex(i);
-    m_Transforms[i] = m_Transforms[i] * joint.GetInverseBindPoseGlobalTransform().GetAsMat4();
+    pOutput[i] = ezSimdConversion::ToMat4(ezSimdConversion::ToMat4(pTransforms[i]) * inverseBindPose[i]);
   }
 }
 
@@ -1,5 +1,6 @@
 #include <RendererCorePCH.h>
 
+#include <Foundation/SimdMath/SimdConversion.h>
 #include <RendererCore/AnimationSystem/Skeleton.h>
 
 ezSkeleton::ezSkeleton() = default;
@@ -106,6 +107,19 @@ void ezSkeleton::Load(ezStreamReader& stream)
       stream >> joint.m_InverseBindPoseGlobal;
     }
   }
+
+  UpdateCachedData();
+}
+
+void ezSkeleton::UpdateCachedData()
+{
+  const ezUInt32 uiNumJoints = m_Joints.GetCount();
+  m_InverseBindPoseMatrices.SetCountUninitialized(uiNumJoints);
+
+  for (ezUInt32 i = 0; i < uiNumJoints; ++i)
+  {
+    m_InverseBindPoseMatrices[i] = ezSimdConversion::ToTransform(m_Joints[i].m_InverseBindPoseGlobal).GetAsMat4();
+  }
 }
 
 bool ezSkeleton::IsJointDescendantOf(ezUInt16 uiJoint, ezUInt16 uiExpectedParent) const
@@ -4,6 +4,7 @@
 
 #include <Foundation/Math/Mat3.h>
 #include <Foundation/Reflection/Reflection.h>
+#include <Foundation/SimdMath/SimdMat4f.h>
 #include <Foundation/Strings/HashedString.h>
 #include <Foundation/Types/UniquePtr.h>
 #include <RendererCore/AnimationSystem/Declarations.h>
@@ -66,12 +67,19 @@ public:
 
   bool IsJointDescendantOf(ezUInt16 uiJoint, ezUInt16 uiExpectedParent) const;
 
+  /// \brief Returns the inverse global bind pose matrix of every joint, as used to convert a pose from object space to skinning space.
+  ezArrayPtr<const ezSimdMat4f> GetInverseBindPoseMatrices() const { return m_InverseBindPoseMatrices.GetArrayPtr(); }
+
   /// \brief Applies a global transform to the skeleton (used by the importer to correct scale and up-axis)
   // void ApplyGlobalTransform(const ezMat3& transform);
 
 protected:
   friend ezSkeletonBuilder;
 
+  /// \brief Fills the cached SIMD data from m_Joints. Must be called whenever the joints have been modified.
+  void UpdateCachedData();
+
   ezDynamicArray<ezSkeletonJoint> m_Joints;
+  ezDynamicArray<ezSimdMat4f, ezAlignedAllocatorWrapper> m_InverseBindPoseMatrices;
 };
 
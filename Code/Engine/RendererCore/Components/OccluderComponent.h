@@ -0,0 +1,46 @@
+#pragma once
+
+#include <Core/World/World.h>
+#include <RendererCore/RendererCoreDLL.h>
+
+struct ezMsgUpdateLocalBounds;
+
+typedef ezComponentManager<class ezOccluderComponent, ezBlockStorageType::Compact> ezOccluderComponentManager;
+
+/// \brief Marks the owner game object as an occluder for the software occlusion culling.
+///
+/// The occluder is a solid box that is centered at the owner and must lie completely inside of the visible geometry that it represents,
+/// otherwise objects that are actually visible may get culled.
+class EZ_RENDERERCORE_DLL ezOccluderComponent : public ezComponent
+{
+  EZ_DECLARE_COMPONENT_TYPE(ezOccluderComponent, ezComponent, ezOccluderComponentManager);
+
+  //////////////////////////////////////////////////////////////////////////
+  // ezComponent
+
+public:
+  virtual void SerializeComponent(ezWorldWriter& stream) const override;
+  virtual void DeserializeComponent(ezWorldReader& stream) override;
+
+protected:
+  virtual void OnActivated() override;
+  virtual void OnDeactivated() override;
+
+  //////////////////////////////////////////////////////////////////////////
+  // ezOccluderComponent
+
+public:
+  ezOccluderComponent();
+  ~ezOccluderComponent();
+
+  void SetExtents(const ezVec3& vExtents); // [ property ]
+  const ezVec3& GetExtents() const;        // [ property ]
+
+  /// \brief Returns the occluder box in the local space of the owner.
+  ezBoundingBox GetLocalOccluderBox() const;
+
+protected:
+  void OnUpdateLocalBounds(ezMsgUpdateLocalBounds& msg) const;
+
+  ezVec3 m_vExtents = ezVec3(1.0f);
+};
@@ -6,6 +6,8 @@
 struct ezPerLightData;
 struct ezPerDecalData;
 struct ezPerClusterData;
+class ezLightRenderData;
+class ezDecalRenderData;
 
 class ezClusteredDataCPU : public ezRenderData
 {
@@ -47,6 +49,18 @@ public:
     ezExtractedRenderData& extractedRenderData) override;
 
 private:
+  /// \brief Computes the cluster range and intersection data of the given lights. Called in parallel for disjoint light ranges.
+  void PrepareLights(ezUInt32 uiStartIndex, ezUInt32 uiEndIndex, const ezSimdMat4f& viewMatrix, const ezSimdMat4f& projectionMatrix);
+
+  /// \brief Computes the cluster range and intersection data of the given decals. Called in parallel for disjoint decal ranges.
+  void PrepareDecals(ezUInt32 uiStartIndex, ezUInt32 uiEndIndex, const ezSimdMat4f& viewProjectionMatrix);
+
+  /// \brief Clears and fills the light and decal clusters of the given depth slices. Called in parallel for disjoint slice ranges.
+  void RasterizeSlices(ezUInt32 uiStartSlice, ezUInt32 uiEndSlice);
+
+  /// \brief Writes the item list of a single depth slice. Cluster offsets are relative to the start of the slice's list.
+  void FillSliceItemList(ezUInt32 uiSlice, ezArrayPtr<ezPerClusterData> clusterData);
+
   void FillItemListAndClusterData(ezClusteredDataCPU* pData);
 
   template <ezUInt32 MaxData>
@@ -61,7 +75,14 @@ private:
   ezDynamicArray<ezPerDecalData, ezAlignedAllocatorWrapper> m_TempDecalData;
   ezDynamicArray<TempCluster<ezClusteredDataCPU::MAX_LIGHT_DATA>> m_TempLightsClusters;
   ezDynamicArray<TempCluster<ezClusteredDataCPU::MAX_DECAL_DATA>> m_TempDecalsClusters;
-  ezDynamicArray<ezUInt32> m_TempClusterItemList;
+  ezDynamicArray<const ezLightRenderData*> m_TempLightsToRasterize;
+  ezDynamicArray<const ezDecalRenderData*> m_TempDecalsToRasterize;
+
+  struct LightBounds;
+  struct DecalBounds;
+  ezDynamicArray<LightBounds, ezAlignedAllocatorWrapper> m_TempLightBounds;
+  ezDynamicArray<DecalBounds, ezAlignedAllocatorWrapper> m_TempDecalBounds;
+  ezDynamicArray<ezDynamicArray<ezUInt32>> m_TempSliceItemLists;
 
   ezDynamicArray<ezSimdBSphere, ezAlignedAllocatorWrapper> m_ClusterBoundingSpheres;
 };
@@ -3,6 +3,7 @@
 #include <Core/Graphics/Camera.h>
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <RendererCore/Components/FogComponent.h>
 #include <RendererCore/Debug/DebugRenderer.h>
 #include <RendererCore/Lights/AmbientLightComponent.h>
@@ -143,6 +144,21 @@ ezClusteredDataCPU::~ezClusteredDataCPU() = default;
 
 //////////////////////////////////////////////////////////////////////////
 
+struct ezClusteredDataExtractor::LightBounds
+{
+  ClusterRange m_Range;
+  ezUInt32 m_uiType; // LIGHT_TYPE_*
+  ezSimdBSphere m_PointLightSphere;
+  BoundingCone m_SpotLightCone;
+};
+
+struct ezClusteredDataExtractor::DecalBounds
+{
+  ClusterRange m_Range;
+  ezSimdTransform m_WorldToDecal;
+  ezSimdBBox m_LocalBounds;
+};
+
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezClusteredDataExtractor, 1, ezRTTIDefaultAllocator<ezClusteredDataExtractor>)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 
@@ -153,6 +169,7 @@ ezClusteredDataExtractor::ezClusteredDataExtractor(const char* szName)
 
   m_TempLightsClusters.SetCountUninitialized(NUM_CLUSTERS);
   m_TempDecalsClusters.SetCountUninitialized(NUM_CLUSTERS);
+  m_TempSliceItemLists.SetCount(NUM_CLUSTERS_Z);
   m_ClusterBoundingSpheres.SetCountUninitialized(NUM_CLUSTERS);
 }
 
@@ -179,7 +196,7 @@ void ezClusteredDataExtractor::PostSortAndBatch(const ezView& view, const ezDyna
   // Lights
   {
     m_TempLightData.Clear();
-    ezMemoryUtils::ZeroFill(m_TempLightsClusters.GetData(), NUM_CLUSTERS);
+    m_TempLightsToRasterize.Clear();
 
     auto batchList = extractedRenderData.GetRenderDataBatchesWithCategory(ezDefaultRenderDataCategories::Light);
     const ezUInt32 uiBatchCount = batchList.GetBatchCount();
@@ -200,14 +217,12 @@ void ezClusteredDataExtractor::PostSortAndBatch(const ezView& view, const ezDyna
         if (auto pPointLightRenderData = ezDynamicCast<const ezPointLightRenderData*>(it))
         {
           FillPointLightData(m_TempLightData.ExpandAndGetRef(), pPointLightRenderData);
-
-          ezSimdBSphere pointLightSphere = ezSimdBSphere(ezSimdConversion::ToVec3(pPointLightRenderData->m_GlobalTransform.m_vPosition),
-                                                         pPointLightRenderData->m_fRange);
-          RasterizePointLight(pointLightSphere, uiLightIndex, viewMatrix, projectionMatrix, m_TempLightsClusters.GetData(),
-                              m_ClusterBoundingSpheres.GetData());
+          m_TempLightsToRasterize.PushBack(pPointLightRenderData);
 
           if (false)
           {
+            ezSimdBSphere pointLightSphere = ezSimdBSphere(ezSimdConversion::ToVec3(pPointLightRenderData->m_GlobalTransform.m_vPosition),
+                                                           pPointLightRenderData->m_fRange);
             ezSimdBBox ssb = GetScreenSpaceBounds(pointLightSphere, viewMatrix, projectionMatrix);
             float minX = ((float)ssb.m_Min.x() * 0.5f + 0.5f) * view.GetViewport().width;
             float maxX = ((float)ssb.m_Max.x() * 0.5f + 0.5f) * view.GetViewport().width;
@@ -221,22 +236,12 @@ void ezClusteredDataExtractor::PostSortAndBatch(const ezView& view, const ezDyna
         else if (auto pSpotLightRenderData = ezDynamicCast<const ezSpotLightRenderData*>(it))
         {
           FillSpotLightData(m_TempLightData.ExpandAndGetRef(), pSpotLightRenderData);
-
-          ezAngle halfAngle = pSpotLightRenderData->m_OuterSpotAngle / 2.0f;
-
-          BoundingCone cone;
-          cone.m_PositionAndRange = ezSimdConversion::ToVec3(pSpotLightRenderData->m_GlobalTransform.m_vPosition);
-          cone.m_PositionAndRange.SetW(pSpotLightRenderData->m_fRange);
-          cone.m_ForwardDir = ezSimdConversion::ToVec3(pSpotLightRenderData->m_GlobalTransform.m_qRotation * ezVec3(1.0f, 0.0f, 0.0f));
-          cone.m_SinCosAngle = ezSimdVec4f(ezMath::Sin(halfAngle), ezMath::Cos(halfAngle), 0.0f);
-          RasterizeSpotLight(cone, uiLightIndex, viewMatrix, projectionMatrix, m_TempLightsClusters.GetData(),
-                             m_ClusterBoundingSpheres.GetData());
+          m_TempLightsToRasterize.PushBack(pSpotLightRenderData);
         }
         else if (auto pDirLightRenderData = ezDynamicCast<const ezDirectionalLightRenderData*>(it))
         {
           FillDirLightData(m_TempLightData.ExpandAndGetRef(), pDirLightRenderData);
-
-          RasterizeDirLight(pDirLightRenderData, uiLightIndex, m_TempLightsClusters.GetArrayPtr());
+          m_TempLightsToRasterize.PushBack(pDirLightRenderData);
         }
         else if (auto pFogRenderData = ezDynamicCast<const ezFogRenderData*>(it))
         {
@@ -272,7 +277,7 @@ void ezClusteredDataExtractor::PostSortAndBatch(const ezView& view, const ezDyna
   // Decals
   {
     m_TempDecalData.Clear();
-    ezMemoryUtils::ZeroFill(m_TempDecalsClusters.GetData(), NUM_CLUSTERS);
+    m_TempDecalsToRasterize.Clear();
 
     auto batchList = extractedRenderData.GetRenderDataBatchesWithCategory(ezDefaultRenderDataCategories::Decal);
     const ezUInt32 uiBatchCount = batchList.GetBatchCount();
@@ -293,9 +298,7 @@ void ezClusteredDataExtractor::PostSortAndBatch(const ezView& view, const ezDyna
         if (auto pDecalRenderData = ezDynamicCast<const ezDecalRenderData*>(it))
         {
           FillDecalData(m_TempDecalData.ExpandAndGetRef(), pDecalRenderData);
-
-          RasterizeDecal(pDecalRenderData, uiDecalIndex, viewProjectionMatrix, m_TempDecalsClusters.GetData(),
-                         m_ClusterBoundingSpheres.GetData());
+          m_TempDecalsToRasterize.PushBack(pDecalRenderData);
         }
         else
         {
@@ -308,6 +311,21 @@ void ezClusteredDataExtractor::PostSortAndBatch(const ezView& view, const ezDyna
     pData->m_DecalData.CopyFrom(m_TempDecalData);
   }
 
+  // the bounds only depend on the light or decal, so they are computed once instead of once per depth slice task
+  m_TempLightBounds.SetCount(m_TempLightsToRasterize.GetCount());
+  ezTaskSystem::ParallelForIndexed(0, m_TempLightsToRasterize.GetCount(),
+    [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) { PrepareLights(uiStartIndex, uiEndIndex, viewMatrix, projectionMatrix); },
+    "Clustered Data Light Bounds");
+
+  m_TempDecalBounds.SetCount(m_TempDecalsToRasterize.GetCount());
+  ezTaskSystem::ParallelForIndexed(0, m_TempDecalsToRasterize.GetCount(),
+    [&](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) { PrepareDecals(uiStartIndex, uiEndIndex, viewProjectionMatrix); },
+    "Clustered Data Decal Bounds");
+
+  // every task only writes the clusters of its own depth slices, so no synchronization between the tasks is necessary
+  ezTaskSystem::ParallelForIndexed(0, NUM_CLUSTERS_Z,
+    [this](ezUInt32 uiStartSlice, ezUInt32 uiEndSlice) { RasterizeSlices(uiStartSlice, uiEndSlice); }, "Clustered Data Rasterization");
+
   FillItemListAndClusterData(pData);
 
   extractedRenderData.AddFrameData(pData);
@@ -317,14 +335,103 @@ void ezClusteredDataExtractor::PostSortAndBatch(const ezView& view, const ezDyna
 #endif
 }
 
+void ezClusteredDataExtractor::PrepareLights(ezUInt32 uiStartIndex, ezUInt32 uiEndIndex, const ezSimdMat4f& viewMatrix,
+                                            const ezSimdMat4f& projectionMatrix)
+{
+  for (ezUInt32 uiLightIndex = uiStartIndex; uiLightIndex < uiEndIndex; ++uiLightIndex)
+  {
+    const ezLightRenderData* pLightRenderData = m_TempLightsToRasterize[uiLightIndex];
+    LightBounds& bounds = m_TempLightBounds[uiLightIndex];
+
+    if (auto pPointLightRenderData = ezDynamicCast<const ezPointLightRenderData*>(pLightRenderData))
+    {
+      bounds.m_uiType = LIGHT_TYPE_POINT;
+      bounds.m_PointLightSphere = ezSimdBSphere(ezSimdConversion::ToVec3(pPointLightRenderData->m_GlobalTransform.m_vPosition),
+                                                pPointLightRenderData->m_fRange);
+      bounds.m_Range = GetPointLightClusterRange(bounds.m_PointLightSphere, viewMatrix, projectionMatrix);
+    }
+    else if (auto pSpotLightRenderData = ezDynamicCast<const ezSpotLightRenderData*>(pLightRenderData))
+    {
+      bounds.m_uiType = LIGHT_TYPE_SPOT;
+      FillBoundingCone(bounds.m_SpotLightCone, pSpotLightRenderData);
+      bounds.m_Range = GetSpotLightClusterRange(bounds.m_SpotLightCone, viewMatrix, projectionMatrix);
+    }
+    else
+    {
+      bounds.m_uiType = LIGHT_TYPE_DIR;
+    }
+  }
+}
+
+void ezClusteredDataExtractor::PrepareDecals(ezUInt32 uiStartIndex, ezUInt32 uiEndIndex, const ezSimdMat4f& viewProjectionMatrix)
+{
+  for (ezUInt32 uiDecalIndex = uiStartIndex; uiDecalIndex < uiEndIndex; ++uiDecalIndex)
+  {
+    const ezDecalRenderData* pDecalRenderData = m_TempDecalsToRasterize[uiDecalIndex];
+    DecalBounds& bounds = m_TempDecalBounds[uiDecalIndex];
+
+    ezSimdVec4f decalHalfExtents = ezSimdConversion::ToVec3(pDecalRenderData->m_vHalfExtents);
+
+    bounds.m_Range = GetDecalClusterRange(pDecalRenderData, viewProjectionMatrix);
+    bounds.m_WorldToDecal = ezSimdConversion::ToTransform(pDecalRenderData->m_GlobalTransform).GetInverse();
+    bounds.m_LocalBounds = ezSimdBBox(-decalHalfExtents, decalHalfExtents);
+  }
+}
+
+void ezClusteredDataExtractor::RasterizeSlices(ezUInt32 uiStartSlice, ezUInt32 uiEndSlice)
+{
+  const ezUInt32 uiStartCluster = uiStartSlice * NUM_CLUSTERS_XY;
+  const ezUInt32 uiClusterCount = (uiEndSlice - uiStartSlice) * NUM_CLUSTERS_XY;
+
+  // Lights
+  {
+    auto lightsClusters = m_TempLightsClusters.GetArrayPtr().GetSubArray(uiStartCluster, uiClusterCount);
+    ezMemoryUtils::ZeroFill(lightsClusters.GetPtr(), uiClusterCount);
+
+    for (ezUInt32 uiLightIndex = 0; uiLightIndex < m_TempLightBounds.GetCount(); ++uiLightIndex)
+    {
+      const LightBounds& bounds = m_TempLightBounds[uiLightIndex];
+
+      if (bounds.m_uiType == LIGHT_TYPE_POINT)
+      {
+        RasterizePointLight(bounds.m_PointLightSphere, bounds.m_Range, uiLightIndex, m_TempLightsClusters.GetData(),
+                            m_ClusterBoundingSpheres.GetData(), uiStartSlice, uiEndSlice);
+      }
+      else if (bounds.m_uiType == LIGHT_TYPE_SPOT)
+      {
+        RasterizeSpotLight(bounds.m_SpotLightCone, bounds.m_Range, uiLightIndex, m_TempLightsClusters.GetData(),
+                           m_ClusterBoundingSpheres.GetData(), uiStartSlice, uiEndSlice);
+      }
+      else
+      {
+        RasterizeDirLight(uiLightIndex, lightsClusters);
+      }
+    }
+  }
+
+  // Decals
+  {
+    ezMemoryUtils::ZeroFill(m_TempDecalsClusters.GetData() + uiStartCluster, uiClusterCount);
+
+    for (ezUInt32 uiDecalIndex = 0; uiDecalIndex < m_TempDecalBounds.GetCount(); ++uiDecalIndex)
+    {
+      const DecalBounds& bounds = m_TempDecalBounds[uiDecalIndex];
+
+      RasterizeDecal(bounds.m_WorldToDecal, bounds.m_LocalBounds, bounds.m_Range, uiDecalIndex, m_TempDecalsClusters.GetData(),
+                     m_ClusterBoundingSpheres.GetData(), uiStartSlice, uiEndSlice);
+    }
+  }
+}
+
 namespace
 {
   ezUInt32 PackIndex(ezUInt32 uiLightIndex, ezUInt32 uiDecalIndex) { return uiDecalIndex << 10 | uiLightIndex; }
 }
 
-void ezClusteredDataExtractor::FillItemListAndClusterData(ezClusteredDataCPU* pData)
+void ezClusteredDataExtractor::FillSliceItemList(ezUInt32 uiSlice, ezArrayPtr<ezPerClusterData> clusterData)
 {
-  m_TempClusterItemList.Clear();
+  ezDynamicArray<ezUInt32>& itemList = m_TempSliceItemLists[uiSlice];
+  itemList.Clear();
 
   const ezUInt32 uiNumLights = m_TempLightData.GetCount();
   const ezUInt32 uiMaxLightBlockIndex = (uiNumLights + 31) / 32;
@@ -332,9 +439,10 @@ void ezClusteredDataExtractor::FillItemListAndClusterData(ezClusteredDataCPU* pD
   const ezUInt32 uiNumDecals = m_TempDecalData.GetCount();
   const ezUInt32 uiMaxDecalBlockIndex = (uiNumDecals + 31) / 32;
 
-  for (ezUInt32 i = 0; i < NUM_CLUSTERS; ++i)
+  const ezUInt32 uiStartCluster = uiSlice * NUM_CLUSTERS_XY;
+  for (ezUInt32 i = uiStartCluster; i < uiStartCluster + NUM_CLUSTERS_XY; ++i)
   {
-    ezUInt32 uiOffset = m_TempClusterItemList.GetCount();
+    ezUInt32 uiOffset = itemList.GetCount();
     ezUInt32 uiLightCount = 0;
 
     // Lights
@@ -350,7 +458,7 @@ void ezClusteredDataExtractor::FillItemListAndClusterData(ezClusteredDataCPU* pD
           mask &= ~(1 << uiLightIndex);
 
           uiLightIndex += uiBlockIndex * 32;
-          m_TempClusterItemList.PushBack(uiLightIndex);
+          itemList.PushBack(uiLightIndex);
           ++uiLightCount;
         }
       }
@@ -374,12 +482,12 @@ void ezClusteredDataExtractor::FillItemListAndClusterData(ezClusteredDataCPU* pD
 
           if (uiDecalCount < uiLightCount)
           {
-            auto& item = m_TempClusterItemList[uiOffset + uiDecalCount];
+            auto& item = itemList[uiOffset + uiDecalCount];
             item = PackIndex(item, uiDecalIndex);
           }
           else
           {
-            auto& item = m_TempClusterItemList.ExpandAndGetRef();
+            auto& item = itemList.ExpandAndGetRef();
             item = PackIndex(0, uiDecalIndex);
           }
 
@@ -388,13 +496,51 @@ void ezClusteredDataExtractor::FillItemListAndClusterData(ezClusteredDataCPU* pD
       }
     }
 
-    auto& clusterData = pData->m_ClusterData[i];
-    clusterData.offset = uiOffset;
-    clusterData.counts = PackIndex(uiLightCount, uiDecalCount);
+    auto& cluster = clusterData[i];
+    cluster.offset = uiOffset;
+    cluster.counts = PackIndex(uiLightCount, uiDecalCount);
+  }
+}
+
+void ezClusteredDataExtractor::FillItemListAndClusterData(ezClusteredDataCPU* pData)
+{
+  ezTaskSystem::ParallelForIndexed(0, NUM_CLUSTERS_Z,
+    [this, pData](ezUInt32 uiStartSlice, ezUInt32 uiEndSlice) {
+      for (ezUInt32 uiSlice = uiStartSlice; uiSlice < uiEndSlice; ++uiSlice)
+      {
+        FillSliceItemList(uiSlice, pData->m_ClusterData);
+      }
+    },
+    "Clustered Data Item List");
+
+  // prefix sum over the slice item counts gives the start of every slice in the final item list
+  ezUInt32 sliceOffsets[NUM_CLUSTERS_Z];
+  ezUInt32 uiTotalItemCount = 0;
+  for (ezUInt32 uiSlice = 0; uiSlice < NUM_CLUSTERS_Z; ++uiSlice)
+  {
+    sliceOffsets[uiSlice] = uiTotalItemCount;
+    uiTotalItemCount += m_TempSliceItemLists[uiSlice].GetCount();
   }
 
-  pData->m_ClusterItemList = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), ezUInt32, m_TempClusterItemList.GetCount());
-  pData->m_ClusterItemList.CopyFrom(m_TempClusterItemList);
+  pData->m_ClusterItemList = EZ_NEW_ARRAY(ezFrameAllocator::GetCurrentAllocator(), ezUInt32, uiTotalItemCount);
+
+  ezTaskSystem::ParallelForIndexed(0, NUM_CLUSTERS_Z,
+    [this, pData, &sliceOffsets](ezUInt32 uiStartSlice, ezUInt32 uiEndSlice) {
+      for (ezUInt32 uiSlice = uiStartSlice; uiSlice < uiEndSlice; ++uiSlice)
+      {
+        const ezDynamicArray<ezUInt32>& itemList = m_TempSliceItemLists[uiSlice];
+        const ezUInt32 uiSliceOffset = sliceOffsets[uiSlice];
+
+        pData->m_ClusterItemList.GetSubArray(uiSliceOffset, itemList.GetCount()).CopyFrom(itemList);
+
+        const ezUInt32 uiStartCluster = uiSlice * NUM_CLUSTERS_XY;
+        for (ezUInt32 i = uiStartCluster; i < uiStartCluster + NUM_CLUSTERS_XY; ++i)
+        {
+          pData->m_ClusterData[i].offset += uiSliceOffset;
+        }
+      }
+    },
+    "Clustered Data Item List Merge");
 }
 
 
@@ -248,9 +248,18 @@ namespace
     return ezSimdBBox(mi, ma);
   }
 
-  template <typename Cluster, typename IntersectionFunc>
-  EZ_FORCE_INLINE void FillCluster(const ezSimdBBox& screenSpaceBounds, ezUInt32 uiBlockIndex, ezUInt32 uiMask, Cluster* clusters,
-    IntersectionFunc func)
+  /// \brief The clusters that a light or decal may overlap. All bounds are inclusive.
+  struct ClusterRange
+  {
+    ezUInt32 m_uiMinX;
+    ezUInt32 m_uiMaxX;
+    ezUInt32 m_uiMinY;
+    ezUInt32 m_uiMaxY;
+    ezUInt32 m_uiMinZ;
+    ezUInt32 m_uiMaxZ;
+  };
+
+  EZ_FORCE_INLINE ClusterRange GetClusterRange(const ezSimdBBox& screenSpaceBounds)
   {
     ezSimdVec4f scale = ezSimdVec4f(0.5f * NUM_CLUSTERS_X, -0.5f * NUM_CLUSTERS_Y, 1.0f, 1.0f);
     ezSimdVec4f bias = ezSimdVec4f(0.5f * NUM_CLUSTERS_X, 0.5f * NUM_CLUSTERS_Y, 0.0f, 0.0f);
@@ -264,20 +273,35 @@ namespace
     minXY_maxXY = minXY_maxXY.CompMin(maxClusterIndex - ezSimdVec4i(1));
     minXY_maxXY = minXY_maxXY.CompMax(ezSimdVec4i::ZeroVector());
 
-    ezUInt32 xMin = minXY_maxXY.x();
-    ezUInt32 yMin = minXY_maxXY.w();
+    ClusterRange range;
+    range.m_uiMinX = minXY_maxXY.x();
+    range.m_uiMinY = minXY_maxXY.w();
+
+    range.m_uiMaxX = minXY_maxXY.z();
+    range.m_uiMaxY = minXY_maxXY.y();
 
-    ezUInt32 xMax = minXY_maxXY.z();
-    ezUInt32 yMax = minXY_maxXY.y();
+    range.m_uiMinZ = GetSliceIndexFromDepth(screenSpaceBounds.m_Min.z());
+    range.m_uiMaxZ = GetSliceIndexFromDepth(screenSpaceBounds.m_Max.z());
 
-    ezUInt32 zMin = GetSliceIndexFromDepth(screenSpaceBounds.m_Min.z());
-    ezUInt32 zMax = GetSliceIndexFromDepth(screenSpaceBounds.m_Max.z());
+    return range;
+  }
+
+  /// \brief Sets the given bit in all clusters of the range that pass the intersection test.
+  ///
+  /// Only the depth slices from uiStartSlice (inclusive) to uiEndSlice (exclusive) are touched,
+  /// so different depth slice ranges can be filled in parallel.
+  template <typename Cluster, typename IntersectionFunc>
+  EZ_FORCE_INLINE void FillCluster(const ClusterRange& range, ezUInt32 uiBlockIndex, ezUInt32 uiMask, Cluster* clusters, ezUInt32 uiStartSlice,
+    ezUInt32 uiEndSlice, IntersectionFunc func)
+  {
+    const ezUInt32 zMin = ezMath::Max(range.m_uiMinZ, uiStartSlice);
+    const ezUInt32 zMax = ezMath::Min(range.m_uiMaxZ, uiEndSlice - 1);
 
     for (ezUInt32 z = zMin; z <= zMax; ++z)
     {
-      for (ezUInt32 y = yMin; y <= yMax; ++y)
+      for (ezUInt32 y = range.m_uiMinY; y <= range.m_uiMaxY; ++y)
       {
-        for (ezUInt32 x = xMin; x <= xMax; ++x)
+        for (ezUInt32 x = range.m_uiMinX; x <= range.m_uiMaxX; ++x)
         {
           ezUInt32 uiClusterIndex = GetClusterIndexFromCoord(x, y, z);
           if (func(uiClusterIndex))
@@ -289,16 +313,20 @@ namespace
     }
   }
 
-  template <typename Cluster>
-  void RasterizePointLight(const ezSimdBSphere& pointLightSphere, ezUInt32 uiLightIndex, const ezSimdMat4f& viewMatrix,
-    const ezSimdMat4f& projectionMatrix, Cluster* clusters, ezSimdBSphere* clusterBoundingSpheres)
+  EZ_FORCE_INLINE ClusterRange GetPointLightClusterRange(const ezSimdBSphere& pointLightSphere, const ezSimdMat4f& viewMatrix,
+    const ezSimdMat4f& projectionMatrix)
   {
-    ezSimdBBox screenSpaceBounds = GetScreenSpaceBounds(pointLightSphere, viewMatrix, projectionMatrix);
+    return GetClusterRange(GetScreenSpaceBounds(pointLightSphere, viewMatrix, projectionMatrix));
+  }
 
+  template <typename Cluster>
+  void RasterizePointLight(const ezSimdBSphere& pointLightSphere, const ClusterRange& range, ezUInt32 uiLightIndex, Cluster* clusters,
+    ezSimdBSphere* clusterBoundingSpheres, ezUInt32 uiStartSlice, ezUInt32 uiEndSlice)
+  {
     const ezUInt32 uiBlockIndex = uiLightIndex / 32;
     const ezUInt32 uiMask = 1 << (uiLightIndex - uiBlockIndex * 32);
 
-    FillCluster(screenSpaceBounds, uiBlockIndex, uiMask, clusters,
+    FillCluster(range, uiBlockIndex, uiMask, clusters, uiStartSlice, uiEndSlice,
       [&](ezUInt32 uiClusterIndex) { return pointLightSphere.Overlaps(clusterBoundingSpheres[uiClusterIndex]); });
   }
 
@@ -310,17 +338,22 @@ namespace
     ezSimdVec4f m_SinCosAngle;
   };
 
-  template <typename Cluster>
-  void RasterizeSpotLight(const BoundingCone& spotLightCone, ezUInt32 uiLightIndex, const ezSimdMat4f& viewMatrix,
-    const ezSimdMat4f& projectionMatrix, Cluster* clusters, ezSimdBSphere* clusterBoundingSpheres)
+  /// \brief Fills in the cone of the spot light, including a bounding sphere around it.
+  void FillBoundingCone(BoundingCone& cone, const ezSpotLightRenderData* pSpotLightRenderData)
   {
-    ezSimdVec4f position = spotLightCone.m_PositionAndRange;
-    ezSimdFloat range = spotLightCone.m_PositionAndRange.w();
-    ezSimdVec4f forwardDir = spotLightCone.m_ForwardDir;
-    ezSimdFloat sinAngle = spotLightCone.m_SinCosAngle.x();
-    ezSimdFloat cosAngle = spotLightCone.m_SinCosAngle.y();
+    ezAngle halfAngle = pSpotLightRenderData->m_OuterSpotAngle / 2.0f;
+
+    cone.m_PositionAndRange = ezSimdConversion::ToVec3(pSpotLightRenderData->m_GlobalTransform.m_vPosition);
+    cone.m_PositionAndRange.SetW(pSpotLightRenderData->m_fRange);
+    cone.m_ForwardDir = ezSimdConversion::ToVec3(pSpotLightRenderData->m_GlobalTransform.m_qRotation * ezVec3(1.0f, 0.0f, 0.0f));
+    cone.m_SinCosAngle = ezSimdVec4f(ezMath::Sin(halfAngle), ezMath::Cos(halfAngle), 0.0f);
+
+    ezSimdVec4f position = cone.m_PositionAndRange;
+    ezSimdFloat range = cone.m_PositionAndRange.w();
+    ezSimdVec4f forwardDir = cone.m_ForwardDir;
+    ezSimdFloat sinAngle = cone.m_SinCosAngle.x();
+    ezSimdFloat cosAngle = cone.m_SinCosAngle.y();
 
-    // First calculate a bounding sphere around the cone to get min and max bounds
     ezSimdVec4f bSphereCenter;
     ezSimdFloat bSphereRadius;
     if (sinAngle > 0.707107f) // sin(45)
@@ -334,13 +367,29 @@ namespace
       bSphereCenter = position + forwardDir * bSphereRadius;
     }
 
-    ezSimdBSphere spotLightSphere(bSphereCenter, bSphereRadius);
-    ezSimdBBox screenSpaceBounds = GetScreenSpaceBounds(spotLightSphere, viewMatrix, projectionMatrix);
+    cone.m_BoundingSphere = ezSimdBSphere(bSphereCenter, bSphereRadius);
+  }
+
+  EZ_FORCE_INLINE ClusterRange GetSpotLightClusterRange(const BoundingCone& spotLightCone, const ezSimdMat4f& viewMatrix,
+    const ezSimdMat4f& projectionMatrix)
+  {
+    return GetClusterRange(GetScreenSpaceBounds(spotLightCone.m_BoundingSphere, viewMatrix, projectionMatrix));
+  }
+
+  template <typename Cluster>
+  void RasterizeSpotLight(const BoundingCone& spotLightCone, const ClusterRange& range, ezUInt32 uiLightIndex, Cluster* clusters,
+    ezSimdBSphere* clusterBoundingSpheres, ezUInt32 uiStartSlice, ezUInt32 uiEndSlice)
+  {
+    ezSimdVec4f position = spotLightCone.m_PositionAndRange;
+    ezSimdFloat lightRange = spotLightCone.m_PositionAndRange.w();
+    ezSimdVec4f forwardDir = spotLightCone.m_ForwardDir;
+    ezSimdFloat sinAngle = spotLightCone.m_SinCosAngle.x();
+    ezSimdFloat cosAngle = spotLightCone.m_SinCosAngle.y();
 
     const ezUInt32 uiBlockIndex = uiLightIndex / 32;
     const ezUInt32 uiMask = 1 << (uiLightIndex - uiBlockIndex * 32);
 
-    FillCluster(screenSpaceBounds, uiBlockIndex, uiMask, clusters, [&](ezUInt32 uiClusterIndex) {
+    FillCluster(range, uiBlockIndex, uiMask, clusters, uiStartSlice, uiEndSlice, [&](ezUInt32 uiClusterIndex) {
       ezSimdBSphere clusterSphere = clusterBoundingSpheres[uiClusterIndex];
       ezSimdFloat clusterRadius = clusterSphere.GetRadius();
 
@@ -350,7 +399,7 @@ namespace
       ezSimdFloat distClosestP = cosAngle * (distToConeSq - projected * projected).GetSqrt() - projected * sinAngle;
 
       bool angleCull = distClosestP > clusterRadius;
-      bool frontCull = projected > clusterRadius + range;
+      bool frontCull = projected > clusterRadius + lightRange;
       bool backCull = projected < -clusterRadius;
 
       return !(angleCull || frontCull || backCull);
@@ -358,7 +407,7 @@ namespace
   }
 
   template <typename Cluster>
-  void RasterizeDirLight(const ezDirectionalLightRenderData* pDirLightRenderData, ezUInt32 uiLightIndex, ezArrayPtr<Cluster> clusters)
+  void RasterizeDirLight(ezUInt32 uiLightIndex, ezArrayPtr<Cluster> clusters)
   {
     const ezUInt32 uiBlockIndex = uiLightIndex / 32;
     const ezUInt32 uiMask = 1 << (uiLightIndex - uiBlockIndex * 32);
@@ -369,12 +418,9 @@ namespace
     }
   }
 
-  template <typename Cluster>
-  void RasterizeDecal(const ezDecalRenderData* pDecalRenderData, ezUInt32 uiDecalIndex, const ezSimdMat4f& viewProjectionMatrix,
-    Cluster* clusters, ezSimdBSphere* clusterBoundingSpheres)
+  ClusterRange GetDecalClusterRange(const ezDecalRenderData* pDecalRenderData, const ezSimdMat4f& viewProjectionMatrix)
   {
     ezSimdTransform decalToWorld = ezSimdConversion::ToTransform(pDecalRenderData->m_GlobalTransform);
-    ezSimdTransform worldToDecal = decalToWorld.GetInverse();
 
     ezVec3 corners[8];
     ezBoundingBox(-pDecalRenderData->m_vHalfExtents, pDecalRenderData->m_vHalfExtents).GetCorners(corners);
@@ -403,13 +449,17 @@ namespace
       screenSpaceBounds.m_Max = ezSimdVec4f(1.0f).GetCombined<ezSwizzle::XYZW>(screenSpaceBounds.m_Max);
     }
 
-    ezSimdVec4f decalHalfExtents = ezSimdConversion::ToVec3(pDecalRenderData->m_vHalfExtents);
-    ezSimdBBox localDecalBounds = ezSimdBBox(-decalHalfExtents, decalHalfExtents);
+    return GetClusterRange(screenSpaceBounds);
+  }
 
+  template <typename Cluster>
+  void RasterizeDecal(const ezSimdTransform& worldToDecal, const ezSimdBBox& localDecalBounds, const ClusterRange& range, ezUInt32 uiDecalIndex,
+    Cluster* clusters, ezSimdBSphere* clusterBoundingSpheres, ezUInt32 uiStartSlice, ezUInt32 uiEndSlice)
+  {
     const ezUInt32 uiBlockIndex = uiDecalIndex / 32;
     const ezUInt32 uiMask = 1 << (uiDecalIndex - uiBlockIndex * 32);
 
-    FillCluster(screenSpaceBounds, uiBlockIndex, uiMask, clusters, [&](ezUInt32 uiClusterIndex) {
+    FillCluster(range, uiBlockIndex, uiMask, clusters, uiStartSlice, uiEndSlice, [&](ezUInt32 uiClusterIndex) {
       ezSimdBSphere clusterSphere = clusterBoundingSpheres[uiClusterIndex];
       clusterSphere.Transform(worldToDecal);
 
@@ -869,6 +869,9 @@ void ezMaterialResource::UpdateConstantBuffer(ezShaderPermutationResource* pShad
   if (pLayout == nullptr)
     return;
 
+  // Render contexts that record in parallel can update the same material.
+  EZ_LOCK(m_UpdateCacheMutex);
+
   auto pCachedValues = GetOrUpdateCachedValues();
 
   m_iLastConstantsUpdated = m_iLastConstantsModified;
@@ -2,11 +2,17 @@
 
 #include <Core/WorldSerializer/WorldReader.h>
 #include <Core/WorldSerializer/WorldWriter.h>
+#include <Foundation/Configuration/CVar.h>
 #include <RendererCore/Meshes/MeshComponentBase.h>
 #include <RendererCore/Messages/SetColorMessage.h>
+#include <RendererCore/Pipeline/View.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 #include <RendererFoundation/Device/Device.h>
 
+ezCVarFloat CVarMeshLodHysteresis("r_MeshLodHysteresis", 0.1f, ezCVarFlags::Default,
+  "Relative amount by which the screen size of a mesh has to cross a LOD threshold before the LOD is switched");
+ezCVarInt CVarMeshLodForce("r_MeshLodForce", -1, ezCVarFlags::Default, "Forces all meshes to use the given LOD, -1 to disable");
+
 //////////////////////////////////////////////////////////////////////////
 
 // clang-format off
@@ -166,7 +172,13 @@ void ezMeshComponentBase::OnMsgExtractRenderData(ezMsgExtractRenderData& msg) co
     return;
 
   ezResourceLock<ezMeshResource> pMesh(m_hMesh, ezResourceAcquireMode::AllowLoadingFallback);
-  ezArrayPtr<const ezMeshResourceDescriptor::SubMesh> parts = pMesh->GetSubMeshes();
+
+  const ezUInt32 uiLod = SelectLod(pMesh.GetPointer(), msg.m_pView);
+  ezArrayPtr<const ezMeshResourceDescriptor::SubMesh> parts = pMesh->GetLodSubMeshes(uiLod);
+  const ezUInt32 uiFirstPartIndex = static_cast<ezUInt32>(parts.GetPtr() - pMesh->GetSubMeshes().GetPtr());
+
+  // the selected LOD depends on the view, so the render data can't be cached if there is more than one
+  const ezRenderData::Caching::Enum caching = pMesh->GetLodCount() > 1 ? ezRenderData::Caching::Never : ezRenderData::Caching::IfStatic;
 
   for (ezUInt32 uiPartIndex = 0; uiPartIndex < parts.GetCount(); ++uiPartIndex)
   {
@@ -186,7 +198,7 @@ void ezMeshComponentBase::OnMsgExtractRenderData(ezMsgExtractRenderData& msg) co
       pRenderData->m_hMesh = m_hMesh;
       pRenderData->m_hMaterial = hMaterial;
       pRenderData->m_Color = m_Color;
-      pRenderData->m_uiSubMeshIndex = uiPartIndex;
+      pRenderData->m_uiSubMeshIndex = uiFirstPartIndex + uiPartIndex;
       pRenderData->m_uiUniqueID = GetUniqueIdForRendering(uiMaterialIndex);
 
       pRenderData->FillBatchIdAndSortingKey();
@@ -219,10 +231,33 @@ void ezMeshComponentBase::OnMsgExtractRenderData(ezMsgExtractRenderData& msg) co
       }
     }
 
-    msg.AddRenderData(pRenderData, category, ezRenderData::Caching::IfStatic);
+    msg.AddRenderData(pRenderData, category, caching);
   }
 }
 
+ezUInt32 ezMeshComponentBase::SelectLod(const ezMeshResource* pMesh, const ezView* pView) const
+{
+  const ezUInt32 uiLodCount = pMesh->GetLodCount();
+  if (uiLodCount <= 1)
+    return 0;
+
+  if (CVarMeshLodForce >= 0)
+    return ezMath::Min<ezUInt32>(CVarMeshLodForce, uiLodCount - 1);
+
+  if (pView == nullptr)
+    return 0;
+
+  const float fScreenSize = pView->ComputeLodScreenSize(GetOwner()->GetGlobalBounds().GetSphere());
+
+  // without a previous selection there is nothing to apply the hysteresis to
+  const ezUInt32 uiPreviousLod = pView->GetPreviousLod(GetHandle());
+  const ezUInt32 uiLod = uiPreviousLod != ezInvalidIndex ? pMesh->SelectLod(fScreenSize, uiPreviousLod, CVarMeshLodHysteresis)
+                                                         : pMesh->SelectLod(fScreenSize, 0, 0.0f);
+
+  pView->StoreSelectedLod(GetHandle(), uiLod);
+  return uiLod;
+}
+
 void ezMeshComponentBase::SetMesh(const ezMeshResourceHandle& hMesh)
 {
   m_hMesh = hMesh;
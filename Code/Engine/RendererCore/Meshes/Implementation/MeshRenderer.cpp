@@ -1,5 +1,7 @@
 #include <RendererCorePCH.h>
 
+#include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/Configuration/CVar.h>
 #include <RendererCore/Debug/DebugRenderer.h>
 #include <RendererCore/Meshes/Implementation/MeshRendererUtils.h>
 #include <RendererCore/Meshes/InstancedMeshComponent.h>
@@ -14,6 +16,8 @@ EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMeshRenderer, 1, ezRTTIDefaultAllocator<ezMesh
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
+ezCVarBool CVarStaticInstanceData("r_StaticInstanceData", true, ezCVarFlags::Default, "Keep the instance data of cached render data in a persistent buffer across frames");
+
 ezMeshRenderer::ezMeshRenderer() = default;
 ezMeshRenderer::~ezMeshRenderer() = default;
 
@@ -60,11 +64,16 @@ void ezMeshRenderer::RenderBatch(
     return;
   }
 
-  ezInstanceData* pInstanceData = bHasExplicitInstanceData
-                                    ? static_cast<const ezInstancedMeshRenderData*>(pRenderData)->m_pExplicitInstanceData
-                                    : pPass->GetPipeline()->GetFrameDataProvider<ezInstanceDataProvider>()->GetData(renderViewContext);
+  const ezUInt32 uiStaticInstanceCount = bHasExplicitInstanceData ? 0 : PrepareStaticInstanceData(renderViewContext, pPass, batch);
 
-  pInstanceData->BindResources(pContext);
+  ezInstanceData* pInstanceData = nullptr;
+  if (uiStaticInstanceCount == 0)
+  {
+    pInstanceData = bHasExplicitInstanceData ? static_cast<const ezInstancedMeshRenderData*>(pRenderData)->m_pExplicitInstanceData
+                                             : pPass->GetPipeline()->GetFrameDataProvider<ezInstanceDataProvider>()->GetData(renderViewContext);
+
+    pInstanceData->BindResources(pContext);
+  }
 
   if (pRenderData->m_uiFlipWinding)
   {
@@ -80,7 +89,29 @@ void ezMeshRenderer::RenderBatch(
 
   SetAdditionalData(renderViewContext, pRenderData);
 
-  if (!bHasExplicitInstanceData)
+  if (uiStaticInstanceCount > 0)
+  {
+    const ezMeshResourceDescriptor::SubMesh& meshPart = subMeshes[uiPartIndex];
+
+    ezUInt32 uiRenderedInstances = uiStaticInstanceCount;
+    if (renderViewContext.m_pCamera->IsStereoscopic())
+      uiRenderedInstances *= 2;
+
+    if (pContext->DrawMeshBuffer(meshPart.m_uiPrimitiveCount, meshPart.m_uiFirstPrimitive, uiRenderedInstances).Failed())
+    {
+      for (auto it = batch.GetIterator<ezMeshRenderData>(); it.IsValid(); ++it)
+      {
+        pRenderData = it;
+
+        // draw bounding box instead
+        if (pRenderData->m_GlobalBounds.IsValid())
+        {
+          ezDebugRenderer::DrawLineBox(*renderViewContext.m_pViewDebugContext, pRenderData->m_GlobalBounds.GetBox(), ezColor::Magenta);
+        }
+      }
+    }
+  }
+  else if (!bHasExplicitInstanceData)
   {
     ezUInt32 uiStartIndex = 0;
     while (uiStartIndex < batch.GetCount())
@@ -135,6 +166,48 @@ void ezMeshRenderer::RenderBatch(
   }
 }
 
+void ezMeshRenderer::PrepareParallelRecording(const ezRenderViewContext& renderViewContext, const ezRenderDataBatch& batch) const
+{
+  // all render data in a batch use the same material
+  const ezMeshRenderData* pRenderData = batch.GetFirstData<ezMeshRenderData>();
+  renderViewContext.m_pRenderContext->UpdateMaterialConstants(pRenderData->m_hMaterial);
+}
+
+ezUInt32 ezMeshRenderer::PrepareStaticInstanceData(
+  const ezRenderViewContext& renderViewContext, const ezRenderPipelinePass* pPass, const ezRenderDataBatch& batch) const
+{
+  if (!CVarStaticInstanceData)
+    return 0;
+
+  // The batch state is kept in m_pStaticInstanceData between the calls, so batches that are recorded in parallel have to be serialized.
+  EZ_LOCK(m_StaticInstanceDataMutex);
+
+  if (m_pStaticInstanceData == nullptr)
+  {
+    m_pStaticInstanceData = EZ_DEFAULT_NEW(ezStaticInstanceData);
+  }
+
+  // The same batch can be rendered by several passes, e.g. the depth only and the forward pass, and every pass may filter it differently.
+  // Keying by pass keeps the instance data of each filtered version apart, instead of re-uploading whenever another pass renders the batch.
+  const ezUInt64 batchKeyData[] = {static_cast<ezUInt64>(reinterpret_cast<size_t>(pPass)), batch.GetFirstData<ezRenderData>()->m_uiBatchId};
+  const ezUInt64 uiBatchKey = ezHashingUtils::xxHash64(batchKeyData, sizeof(batchKeyData));
+
+  ezArrayPtr<ezPerInstanceData> instanceData;
+  if (m_pStaticInstanceData->BeginBatch(uiBatchKey, batch, instanceData).Failed())
+    return 0;
+
+  if (!instanceData.IsEmpty())
+  {
+    ezUInt32 uiFilteredCount = 0;
+    FillPerInstanceData(instanceData, batch, 0, uiFilteredCount);
+
+    if (m_pStaticInstanceData->UpdateInstanceData(renderViewContext.m_pRenderContext, uiFilteredCount).Failed())
+      return 0;
+  }
+
+  return m_pStaticInstanceData->BindBatch(renderViewContext.m_pRenderContext);
+}
+
 void ezMeshRenderer::SetAdditionalData(const ezRenderViewContext& renderViewContext, const ezMeshRenderData* pRenderData) const
 {
   renderViewContext.m_pRenderContext->SetShaderPermutationVariable("VERTEX_SKINNING", "FALSE");
@@ -30,6 +30,7 @@ ezResourceLoadDesc ezMeshResource::UnloadData(Unload WhatToUnload)
   // if (WhatToUnload == Unload::AllQualityLevels)
   {
     m_SubMeshes.Clear();
+    m_Lods.Clear();
     m_hMeshBuffer.Invalidate();
     m_Materials.Clear();
 
@@ -72,10 +73,40 @@ ezResourceLoadDesc ezMeshResource::UpdateContent(ezStreamReader* Stream)
   return CreateResource(std::move(desc));
 }
 
+ezArrayPtr<const ezMeshResourceDescriptor::SubMesh> ezMeshResource::GetLodSubMeshes(ezUInt32 uiLod) const
+{
+  if (uiLod >= m_Lods.GetCount())
+    return ezArrayPtr<const ezMeshResourceDescriptor::SubMesh>();
+
+  return m_SubMeshes.GetArrayPtr().GetSubArray(m_Lods[uiLod].m_uiFirstSubMesh, m_Lods[uiLod].m_uiSubMeshCount);
+}
+
+ezUInt32 ezMeshResource::SelectLod(float fScreenSize, ezUInt32 uiCurrentLod, float fHysteresis) const
+{
+  if (m_Lods.GetCount() <= 1)
+    return 0;
+
+  ezUInt32 uiLod = ezMath::Min(uiCurrentLod, m_Lods.GetCount() - 1);
+
+  // switch to less detailed LODs once the screen size is clearly below their threshold
+  while (uiLod + 1 < m_Lods.GetCount() && fScreenSize < m_Lods[uiLod + 1].m_fMaxScreenSize * (1.0f - fHysteresis))
+  {
+    ++uiLod;
+  }
+
+  // switch back to more detailed LODs once the screen size is clearly above the threshold of the current one
+  while (uiLod > 0 && fScreenSize > m_Lods[uiLod].m_fMaxScreenSize * (1.0f + fHysteresis))
+  {
+    --uiLod;
+  }
+
+  return uiLod;
+}
+
 void ezMeshResource::UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage)
 {
-  out_NewMemoryUsage.m_uiMemoryCPU =
-      sizeof(ezMeshResource) + (ezUInt32)m_SubMeshes.GetHeapMemoryUsage() + (ezUInt32)m_Materials.GetHeapMemoryUsage();
+  out_NewMemoryUsage.m_uiMemoryCPU = sizeof(ezMeshResource) + (ezUInt32)m_SubMeshes.GetHeapMemoryUsage() +
+                                     (ezUInt32)m_Lods.GetHeapMemoryUsage() + (ezUInt32)m_Materials.GetHeapMemoryUsage();
   out_NewMemoryUsage.m_uiMemoryGPU = 0;
 }
 
@@ -99,6 +130,15 @@ EZ_RESOURCE_IMPLEMENT_CREATEABLE(ezMeshResource, ezMeshResourceDescriptor)
 
   m_SubMeshes = descriptor.GetSubMeshes();
 
+  m_Lods = descriptor.GetLods();
+  if (m_Lods.IsEmpty())
+  {
+    ezMeshResourceDescriptor::Lod& lod0 = m_Lods.ExpandAndGetRef();
+    lod0.m_uiFirstSubMesh = 0;
+    lod0.m_uiSubMeshCount = m_SubMeshes.GetCount();
+    lod0.m_fMaxScreenSize = ezMath::MaxValue<float>();
+  }
+
   m_Materials.Clear();
   m_Materials.Reserve(descriptor.GetMaterials().GetCount());
 
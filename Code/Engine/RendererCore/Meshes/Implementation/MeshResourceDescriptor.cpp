@@ -23,6 +23,7 @@ void ezMeshResourceDescriptor::Clear()
   m_Materials.Clear();
   m_MeshBufferDescriptor.Clear();
   m_SubMeshes.Clear();
+  m_Lods.Clear();
 }
 
 ezMeshBufferResourceDescriptor& ezMeshResourceDescriptor::MeshBufferDesc()
@@ -55,6 +56,11 @@ ezArrayPtr<const ezMeshResourceDescriptor::SubMesh> ezMeshResourceDescriptor::Ge
   return m_SubMeshes;
 }
 
+ezArrayPtr<const ezMeshResourceDescriptor::Lod> ezMeshResourceDescriptor::GetLods() const
+{
+  return m_Lods;
+}
+
 const ezBoundingBoxSphere& ezMeshResourceDescriptor::GetBounds() const
 {
   return m_Bounds;
@@ -79,6 +85,29 @@ void ezMeshResourceDescriptor::AddSubMesh(ezUInt32 uiPrimitiveCount, ezUInt32 ui
   p.m_Bounds.SetInvalid();
 
   m_SubMeshes.PushBack(p);
+
+  if (!m_Lods.IsEmpty())
+  {
+    m_Lods.PeekBack().m_uiSubMeshCount++;
+  }
+}
+
+void ezMeshResourceDescriptor::AddLod(float fMaxScreenSize)
+{
+  if (m_Lods.IsEmpty())
+  {
+    Lod& lod0 = m_Lods.ExpandAndGetRef();
+    lod0.m_uiFirstSubMesh = 0;
+    lod0.m_uiSubMeshCount = m_SubMeshes.GetCount();
+    lod0.m_fMaxScreenSize = ezMath::MaxValue<float>();
+  }
+
+  EZ_ASSERT_DEV(fMaxScreenSize < m_Lods.PeekBack().m_fMaxScreenSize, "LOD screen sizes must be strictly decreasing");
+
+  Lod& lod = m_Lods.ExpandAndGetRef();
+  lod.m_uiFirstSubMesh = m_SubMeshes.GetCount();
+  lod.m_uiSubMeshCount = 0;
+  lod.m_fMaxScreenSize = fMaxScreenSize;
 }
 
 void ezMeshResourceDescriptor::SetMaterial(ezUInt32 uiMaterialIndex, const char* szPathToMaterial)
@@ -156,6 +185,23 @@ void ezMeshResourceDescriptor::Save(ezStreamWriter& stream)
     chunk.EndChunk();
   }
 
+  if (!m_Lods.IsEmpty())
+  {
+    chunk.BeginChunk("Lods", 1);
+
+    // number of LODs
+    chunk << m_Lods.GetCount();
+
+    for (ezUInt32 idx = 0; idx < m_Lods.GetCount(); ++idx)
+    {
+      chunk << m_Lods[idx].m_uiFirstSubMesh;
+      chunk << m_Lods[idx].m_uiSubMeshCount;
+      chunk << m_Lods[idx].m_fMaxScreenSize;
+    }
+
+    chunk.EndChunk();
+  }
+
   {
     chunk.BeginChunk("MeshInfo", 3);
 
@@ -360,6 +406,26 @@ ezResult ezMeshResourceDescriptor::Load(ezStreamReader& stream)
       }
     }
 
+    if (ci.m_sChunkName == "Lods")
+    {
+      if (ci.m_uiChunkVersion != 1)
+      {
+        ezLog::Error("Version of chunk '{0}' is invalid ({1})", ci.m_sChunkName, ci.m_uiChunkVersion);
+        return EZ_FAILURE;
+      }
+
+      // number of LODs
+      chunk >> count;
+      m_Lods.SetCount(count);
+
+      for (ezUInt32 i = 0; i < m_Lods.GetCount(); ++i)
+      {
+        chunk >> m_Lods[i].m_uiFirstSubMesh;
+        chunk >> m_Lods[i].m_uiSubMeshCount;
+        chunk >> m_Lods[i].m_fMaxScreenSize;
+      }
+    }
+
     if (ci.m_sChunkName == "MeshInfo")
     {
       if (ci.m_uiChunkVersion > 3)
@@ -479,6 +545,15 @@ ezResult ezMeshResourceDescriptor::Load(ezStreamReader& stream)
 
   chunk.EndStream();
 
+  for (const Lod& lod : m_Lods)
+  {
+    if (lod.m_uiFirstSubMesh + lod.m_uiSubMeshCount > m_SubMeshes.GetCount())
+    {
+      ezLog::Error("Mesh LOD references sub-meshes that don't exist");
+      return EZ_FAILURE;
+    }
+  }
+
   if (bCalculateBounds)
   {
     ComputeBounds();
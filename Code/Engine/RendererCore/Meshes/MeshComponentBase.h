@@ -110,6 +110,9 @@ protected:
 
   void OnMsgExtractRenderData(ezMsgExtractRenderData& msg) const;
 
+  /// \brief Selects the LOD of the mesh that should be rendered in the given view, based on the projected screen size of the owner's bounds.
+  ezUInt32 SelectLod(const ezMeshResource* pMesh, const ezView* pView) const;
+
   ezRenderData::Category m_RenderDataCategory = ezInvalidRenderDataCategory;
   ezMeshResourceHandle m_hMesh;
   ezDynamicArray<ezMaterialResourceHandle> m_Materials;
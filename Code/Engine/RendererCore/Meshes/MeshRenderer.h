@@ -1,8 +1,11 @@
 #pragma once
 
+#include <Foundation/Threading/Mutex.h>
+#include <Foundation/Types/UniquePtr.h>
 #include <RendererCore/Pipeline/Renderer.h>
 
 class ezMeshRenderData;
+class ezStaticInstanceData;
 struct ezPerInstanceData;
 
 /// \brief Implements rendering of static meshes
@@ -20,9 +23,21 @@ public:
   virtual void GetSupportedRenderDataCategories(ezHybridArray<ezRenderData::Category, 8>& categories) const override;
   virtual void RenderBatch(
     const ezRenderViewContext& renderContext, const ezRenderPipelinePass* pPass, const ezRenderDataBatch& batch) const override;
+  virtual bool SupportsParallelRecording() const override { return true; }
+  virtual void PrepareParallelRecording(const ezRenderViewContext& renderViewContext, const ezRenderDataBatch& batch) const override;
 
 protected:
   virtual void SetAdditionalData(const ezRenderViewContext& renderViewContext, const ezMeshRenderData* pRenderData) const;
   virtual void FillPerInstanceData(
     ezArrayPtr<ezPerInstanceData> instanceData, const ezRenderDataBatch& batch, ezUInt32 uiStartIndex, ezUInt32& out_uiFilteredCount) const;
+
+private:
+  /// \brief Uploads the instance data of a batch of cached render data to the persistent instance data buffer and binds it.
+  ///
+  /// Returns the number of instances to draw or 0 if the batch can't use the persistent buffer.
+  ezUInt32 PrepareStaticInstanceData(
+    const ezRenderViewContext& renderViewContext, const ezRenderPipelinePass* pPass, const ezRenderDataBatch& batch) const;
+
+  mutable ezMutex m_StaticInstanceDataMutex;
+  mutable ezUniquePtr<ezStaticInstanceData> m_pStaticInstanceData;
 };
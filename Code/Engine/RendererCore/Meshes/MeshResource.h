@@ -14,9 +14,21 @@ class EZ_RENDERERCORE_DLL ezMeshResource : public ezResource
 public:
   ezMeshResource();
 
-  /// \brief Returns the array of sub-meshes in this mesh.
+  /// \brief Returns the array of sub-meshes in this mesh. Contains the sub-meshes of all LODs, starting with LOD 0.
   ezArrayPtr<const ezMeshResourceDescriptor::SubMesh> GetSubMeshes() const { return m_SubMeshes; }
 
+  /// \brief Returns the number of LODs of this mesh. Always at least 1.
+  ezUInt32 GetLodCount() const { return m_Lods.GetCount(); }
+
+  /// \brief Returns the sub-meshes of the given LOD.
+  ezArrayPtr<const ezMeshResourceDescriptor::SubMesh> GetLodSubMeshes(ezUInt32 uiLod) const;
+
+  /// \brief Returns the LOD that should be used for the given projected screen size (fraction of the viewport height).
+  ///
+  /// uiCurrentLod is the LOD that was used previously. A switch to another LOD only happens once the screen size crosses the LOD threshold
+  /// by more than fHysteresis (relative to the threshold), which prevents popping back and forth around the threshold.
+  ezUInt32 SelectLod(float fScreenSize, ezUInt32 uiCurrentLod, float fHysteresis) const;
+
   /// \brief Returns the mesh buffer that is used by this resource.
   const ezMeshBufferResourceHandle& GetMeshBuffer() const { return m_hMeshBuffer; }
 
@@ -35,6 +47,7 @@ private:
   virtual void UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage) override;
 
   ezDynamicArray<ezMeshResourceDescriptor::SubMesh> m_SubMeshes;
+  ezHybridArray<ezMeshResourceDescriptor::Lod, 4> m_Lods;
   ezMeshBufferResourceHandle m_hMeshBuffer;
   ezDynamicArray<ezMaterialResourceHandle> m_Materials;
   ezSkeletonResourceHandle m_hSkeleton;
@@ -20,6 +20,18 @@ public:
     ezBoundingBoxSphere m_Bounds;
   };
 
+  /// \brief A range of sub-meshes that together form one level of detail of the mesh.
+  struct Lod
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiFirstSubMesh;
+    ezUInt32 m_uiSubMeshCount;
+
+    /// The LOD is used once the projected screen size of the mesh (fraction of the viewport height) drops below this value.
+    float m_fMaxScreenSize;
+  };
+
   struct Material
   {
     ezString m_sPath;
@@ -37,6 +49,12 @@ public:
 
   void AddSubMesh(ezUInt32 uiPrimitiveCount, ezUInt32 uiFirstPrimitive, ezUInt32 uiMaterialIndex);
 
+  /// \brief Starts a new level of detail. All sub-meshes that are added afterwards belong to this LOD.
+  ///
+  /// All sub-meshes that were added before the first call form LOD 0. The new LOD is used once the projected screen size of the mesh
+  /// drops below fMaxScreenSize, which has to be smaller than the threshold of the previous LOD.
+  void AddLod(float fMaxScreenSize);
+
   void SetMaterial(ezUInt32 uiMaterialIndex, const char* szPathToMaterial);
 
   void Save(ezStreamWriter& stream);
@@ -49,8 +67,12 @@ public:
 
   ezArrayPtr<const Material> GetMaterials() const;
 
+  /// \brief Returns the sub-meshes of all LODs, starting with LOD 0.
   ezArrayPtr<const SubMesh> GetSubMeshes() const;
 
+  /// \brief Returns the LODs that have been added through AddLod(), including LOD 0. Empty if the mesh only has a single LOD.
+  ezArrayPtr<const Lod> GetLods() const;
+
   void ComputeBounds();
   const ezBoundingBoxSphere& GetBounds() const;
 
@@ -61,6 +83,7 @@ private:
 
   ezHybridArray<Material, 8> m_Materials;
   ezHybridArray<SubMesh, 8> m_SubMeshes;
+  ezHybridArray<Lod, 4> m_Lods;
   ezMeshBufferResourceDescriptor m_MeshBufferDescriptor;
   ezMeshBufferResourceHandle m_hMeshBuffer;
   ezSkeletonResourceHandle m_hSkeleton;
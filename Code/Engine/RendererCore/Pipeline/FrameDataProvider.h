@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Foundation/Threading/Mutex.h>
 #include <RendererCore/Pipeline/Declarations.h>
 
 class EZ_RENDERERCORE_DLL ezFrameDataProviderBase : public ezReflectedClass
@@ -19,6 +20,7 @@ private:
   const ezRenderPipeline* m_pOwnerPipeline;
   void* m_pData;
   ezUInt64 m_uiLastUpdateFrame;
+  ezMutex m_Mutex; ///< Render passes can record batches on several threads that all request the data.
 };
 
 template <typename T>
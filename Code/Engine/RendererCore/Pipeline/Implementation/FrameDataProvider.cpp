@@ -16,6 +16,8 @@ ezFrameDataProviderBase::ezFrameDataProviderBase()
 
 void* ezFrameDataProviderBase::GetData(const ezRenderViewContext& renderViewContext)
 {
+  EZ_LOCK(m_Mutex);
+
   if (m_pData == nullptr || m_uiLastUpdateFrame != ezRenderWorld::GetFrameCounter())
   {
     m_pData = UpdateData(renderViewContext, m_pOwnerPipeline->GetRenderData());
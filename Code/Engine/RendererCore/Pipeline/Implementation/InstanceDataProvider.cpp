@@ -2,7 +2,9 @@
 
 #include <RendererCore/Pipeline/ExtractedRenderData.h>
 #include <RendererCore/Pipeline/InstanceDataProvider.h>
+#include <RendererCore/Pipeline/RenderDataBatch.h>
 #include <RendererCore/RenderContext/RenderContext.h>
+#include <RendererCore/RenderWorld/RenderWorld.h>
 #include <RendererFoundation/Profiling/Profiling.h>
 
 #include <RendererCore/../../../Data/Base/Shaders/Common/ObjectConstants.h>
@@ -94,14 +96,264 @@ ezInstanceDataProvider::ezInstanceDataProvider() {}
 
 ezInstanceDataProvider::~ezInstanceDataProvider() {}
 
+ezInstanceData* ezInstanceDataProvider::GetData(const ezRenderViewContext& renderViewContext)
+{
+  ezInstanceData* pData = ezFrameDataProvider<ezInstanceData>::GetData(renderViewContext);
+
+  const ezRenderContext* pRenderContext = renderViewContext.m_pRenderContext;
+  if (!pRenderContext->IsDeferred())
+    return pData;
+
+  EZ_LOCK(m_Mutex);
+
+  ezUniquePtr<ezInstanceData>& pDeferredData = m_DeferredData[pRenderContext];
+  if (pDeferredData == nullptr)
+  {
+    pDeferredData = EZ_DEFAULT_NEW(ezInstanceData);
+  }
+
+  return pDeferredData.Borrow();
+}
+
 void* ezInstanceDataProvider::UpdateData(const ezRenderViewContext& renderViewContext, const ezExtractedRenderData& extractedData)
 {
   m_Data.Reset();
 
+  {
+    EZ_LOCK(m_Mutex);
+
+    for (auto it = m_DeferredData.GetIterator(); it.IsValid(); ++it)
+    {
+      it.Value()->Reset();
+    }
+  }
+
   return &m_Data;
 }
 
+//////////////////////////////////////////////////////////////////////////
+
+ezStaticInstanceData::ezStaticInstanceData(ezUInt32 uiMaxInstanceCount /*= 16 * 1024*/)
+  : m_Data(uiMaxInstanceCount)
+{
+  Range& freeRange = m_FreeRanges.ExpandAndGetRef();
+  freeRange.m_uiOffset = 0;
+  freeRange.m_uiCount = uiMaxInstanceCount;
+}
+
+ezStaticInstanceData::~ezStaticInstanceData()
+{
+  for (auto it = m_DeferredObjectConstants.GetIterator(); it.IsValid(); ++it)
+  {
+    ezRenderContext::DeleteConstantBufferStorage(it.Value());
+  }
+}
+
+ezResult ezStaticInstanceData::BeginBatch(ezUInt64 uiBatchKey, const ezRenderDataBatch& batch, ezArrayPtr<ezPerInstanceData>& out_InstanceDataToFill)
+{
+  out_InstanceDataToFill = ezArrayPtr<ezPerInstanceData>();
+  m_pCurrentBatch = nullptr;
+
+  // the filling happens for the unfiltered batch, so the whole batch has to fit
+  const ezUInt32 uiMaxCount = batch.GetCount();
+  if (uiMaxCount > m_Data.m_uiBufferSize)
+    return EZ_FAILURE;
+
+  m_CurrentCacheIds.Clear();
+  for (auto it = batch.GetIterator<ezRenderData>(); it.IsValid(); ++it)
+  {
+    if (it->m_uiCacheId == 0)
+      return EZ_FAILURE;
+
+    m_CurrentCacheIds.PushBack(it->m_uiCacheId);
+  }
+
+  if (m_CurrentCacheIds.IsEmpty())
+    return EZ_FAILURE;
+
+  Batch* pBatch = nullptr;
+  if (!m_Batches.TryGetValue(uiBatchKey, pBatch))
+  {
+    pBatch = &m_Batches[uiBatchKey];
+  }
+
+  pBatch->m_uiLastUsedFrame = ezRenderWorld::GetFrameCounter();
+
+  if (pBatch->m_Range.m_uiCount < uiMaxCount)
+  {
+    FreeRange(pBatch->m_Range);
+    pBatch->m_Range = {0, 0};
+    pBatch->m_CacheIds.Clear();
+
+    // leave some room to grow, so that a few objects becoming visible don't require a new range right away
+    const ezUInt32 uiPreferredCount = ezMath::Min(uiMaxCount + uiMaxCount / 2, m_Data.m_uiBufferSize);
+    if (!AllocateRange(uiPreferredCount, pBatch->m_Range) && !AllocateRange(uiMaxCount, pBatch->m_Range))
+    {
+      EvictUnusedBatches();
+
+      if (!AllocateRange(uiMaxCount, pBatch->m_Range))
+      {
+        m_Batches.Remove(uiBatchKey);
+        return EZ_FAILURE;
+      }
+    }
+  }
+
+  m_uiCurrentBatchKey = uiBatchKey;
+  m_pCurrentBatch = pBatch;
+
+  if (pBatch->m_CacheIds != m_CurrentCacheIds)
+  {
+    out_InstanceDataToFill = m_Data.m_perInstanceData.GetArrayPtr().GetSubArray(pBatch->m_Range.m_uiOffset, uiMaxCount);
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezStaticInstanceData::UpdateInstanceData(ezRenderContext* pRenderContext, ezUInt32 uiFilledCount)
+{
+  EZ_ASSERT_DEV(m_pCurrentBatch != nullptr, "BeginBatch has to be called first");
+
+  Batch& batch = *m_pCurrentBatch;
+  const ezUInt32 uiCount = m_CurrentCacheIds.GetCount();
+
+  if (uiFilledCount != uiCount)
+  {
+    FreeRange(batch.m_Range);
+    m_Batches.Remove(m_uiCurrentBatchKey);
+    m_pCurrentBatch = nullptr;
+    return EZ_FAILURE;
+  }
 
+  ezGALContext* pGALContext = pRenderContext->GetGALContext();
+  const ezUInt32 uiPreviousCount = batch.m_CacheIds.GetCount();
+
+  // upload all consecutive runs of instances that differ from what is currently stored in the buffer
+  ezUInt32 uiIndex = 0;
+  while (uiIndex < uiCount)
+  {
+    if (uiIndex < uiPreviousCount && batch.m_CacheIds[uiIndex] == m_CurrentCacheIds[uiIndex])
+    {
+      ++uiIndex;
+      continue;
+    }
+
+    const ezUInt32 uiFirstDirtyIndex = uiIndex;
+    while (uiIndex < uiCount && (uiIndex >= uiPreviousCount || batch.m_CacheIds[uiIndex] != m_CurrentCacheIds[uiIndex]))
+    {
+      ++uiIndex;
+    }
+
+    const ezUInt32 uiOffset = batch.m_Range.m_uiOffset + uiFirstDirtyIndex;
+    auto pSourceData = m_Data.m_perInstanceData.GetArrayPtr().GetSubArray(uiOffset, uiIndex - uiFirstDirtyIndex);
+
+    pGALContext->UpdateBuffer(
+      m_Data.m_hInstanceDataBuffer, uiOffset * sizeof(ezPerInstanceData), pSourceData.ToByteArray(), ezGALUpdateMode::CopyToTempStorage);
+  }
+
+  batch.m_CacheIds = m_CurrentCacheIds;
+
+  return EZ_SUCCESS;
+}
+
+ezUInt32 ezStaticInstanceData::BindBatch(ezRenderContext* pRenderContext)
+{
+  EZ_ASSERT_DEV(m_pCurrentBatch != nullptr, "BeginBatch has to be called first");
+
+  const ezConstantBufferStorageHandle hObjectConstants = GetObjectConstants(pRenderContext);
+
+  pRenderContext->BindBuffer("perInstanceData", ezGALDevice::GetDefaultDevice()->GetDefaultResourceView(m_Data.m_hInstanceDataBuffer));
+  pRenderContext->BindConstantBuffer("ezObjectConstants", hObjectConstants);
+
+  ezObjectConstants* pConstants = pRenderContext->GetConstantBufferData<ezObjectConstants>(hObjectConstants);
+  pConstants->InstanceDataOffset = m_pCurrentBatch->m_Range.m_uiOffset;
+
+  return m_CurrentCacheIds.GetCount();
+}
+
+ezConstantBufferStorageHandle ezStaticInstanceData::GetObjectConstants(ezRenderContext* pRenderContext)
+{
+  if (!pRenderContext->IsDeferred())
+    return m_Data.m_hConstantBuffer;
+
+  ezConstantBufferStorageHandle& hObjectConstants = m_DeferredObjectConstants[pRenderContext];
+  if (hObjectConstants.IsInvalidated())
+  {
+    hObjectConstants = ezRenderContext::CreateConstantBufferStorage<ezObjectConstants>();
+  }
+
+  return hObjectConstants;
+}
+
+bool ezStaticInstanceData::AllocateRange(ezUInt32 uiCount, Range& out_Range)
+{
+  for (ezUInt32 i = 0; i < m_FreeRanges.GetCount(); ++i)
+  {
+    Range& freeRange = m_FreeRanges[i];
+    if (freeRange.m_uiCount < uiCount)
+      continue;
+
+    out_Range.m_uiOffset = freeRange.m_uiOffset;
+    out_Range.m_uiCount = uiCount;
+
+    freeRange.m_uiOffset += uiCount;
+    freeRange.m_uiCount -= uiCount;
+
+    if (freeRange.m_uiCount == 0)
+    {
+      m_FreeRanges.RemoveAtAndCopy(i);
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+void ezStaticInstanceData::FreeRange(const Range& range)
+{
+  if (range.m_uiCount == 0)
+    return;
+
+  ezUInt32 uiIndex = 0;
+  while (uiIndex < m_FreeRanges.GetCount() && m_FreeRanges[uiIndex].m_uiOffset < range.m_uiOffset)
+  {
+    ++uiIndex;
+  }
+
+  m_FreeRanges.Insert(range, uiIndex);
+
+  // merge with the next and the previous range
+  if (uiIndex + 1 < m_FreeRanges.GetCount() && range.m_uiOffset + range.m_uiCount == m_FreeRanges[uiIndex + 1].m_uiOffset)
+  {
+    m_FreeRanges[uiIndex].m_uiCount += m_FreeRanges[uiIndex + 1].m_uiCount;
+    m_FreeRanges.RemoveAtAndCopy(uiIndex + 1);
+  }
+
+  if (uiIndex > 0 && m_FreeRanges[uiIndex - 1].m_uiOffset + m_FreeRanges[uiIndex - 1].m_uiCount == range.m_uiOffset)
+  {
+    m_FreeRanges[uiIndex - 1].m_uiCount += m_FreeRanges[uiIndex].m_uiCount;
+    m_FreeRanges.RemoveAtAndCopy(uiIndex);
+  }
+}
+
+void ezStaticInstanceData::EvictUnusedBatches()
+{
+  const ezUInt64 uiFrameCounter = ezRenderWorld::GetFrameCounter();
+
+  for (auto it = m_Batches.GetIterator(); it.IsValid();)
+  {
+    if (it.Value().m_uiLastUsedFrame != uiFrameCounter)
+    {
+      FreeRange(it.Value().m_Range);
+      it = m_Batches.Remove(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
+}
 
 EZ_STATICLINK_FILE(RendererCore, RendererCore_Pipeline_Implementation_InstanceDataProvider);
 
@@ -0,0 +1,347 @@
+#include <RendererCorePCH.h>
+
+#include <Foundation/SimdMath/SimdVec4f.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <RendererCore/Pipeline/OcclusionBuffer.h>
+
+namespace
+{
+  // Clip space w below which geometry is considered to be behind the camera.
+  static const float s_fMinW = 0.001f;
+
+  // Relative tolerance for depth tests, so that objects that are flush with an occluder are not culled.
+  static const float s_fDepthTolerance = 0.001f;
+
+  // clang-format off
+  static const ezUInt32 s_BoxIndices[] =
+  {
+    0, 2, 6, 0, 6, 4, // -x
+    1, 3, 7, 1, 7, 5, // +x
+    0, 1, 5, 0, 5, 4, // -y
+    2, 3, 7, 2, 7, 6, // +y
+    0, 1, 3, 0, 3, 2, // -z
+    4, 5, 7, 4, 7, 6, // +z
+  };
+  // clang-format on
+} // namespace
+
+ezOcclusionBuffer::ezOcclusionBuffer()
+{
+  m_ViewProjectionMatrix.SetIdentity();
+}
+
+ezOcclusionBuffer::~ezOcclusionBuffer() = default;
+
+void ezOcclusionBuffer::Begin(const ezMat4& viewProjectionMatrix, ezUInt32 uiWidth, ezUInt32 uiHeight)
+{
+  m_ViewProjectionMatrix = viewProjectionMatrix;
+  m_uiWidth = ezMath::Max((uiWidth + TileSize - 1) / TileSize, 1u) * TileSize;
+  m_uiHeight = ezMath::Max((uiHeight + TileSize - 1) / TileSize, 1u) * TileSize;
+
+  m_Triangles.Clear();
+
+  m_Depth.SetCountUninitialized(m_uiWidth * m_uiHeight);
+  ezMemoryUtils::ZeroFill(m_Depth.GetData(), m_Depth.GetCount());
+
+  m_TileDepth.SetCountUninitialized(GetNumTilesX() * GetNumTilesY());
+  ezMemoryUtils::ZeroFill(m_TileDepth.GetData(), m_TileDepth.GetCount());
+}
+
+void ezOcclusionBuffer::AddOccluder(ezArrayPtr<const ezVec3> positions, ezArrayPtr<const ezUInt32> indices, const ezTransform& transform)
+{
+  EZ_ASSERT_DEV(indices.GetCount() % 3 == 0, "Occluders must be triangle lists");
+
+  const ezMat4 modelViewProjection = m_ViewProjectionMatrix * transform.GetAsMat4();
+
+  ezHybridArray<ezVec4, 64> clipSpacePositions;
+  clipSpacePositions.SetCountUninitialized(positions.GetCount());
+
+  for (ezUInt32 i = 0; i < positions.GetCount(); ++i)
+  {
+    clipSpacePositions[i] = modelViewProjection * positions[i].GetAsVec4(1.0f);
+  }
+
+  for (ezUInt32 i = 0; i < indices.GetCount(); i += 3)
+  {
+    AddClipSpaceTriangle(clipSpacePositions[indices[i + 0]], clipSpacePositions[indices[i + 1]], clipSpacePositions[indices[i + 2]]);
+  }
+}
+
+void ezOcclusionBuffer::AddOccluderBox(const ezBoundingBox& localBox, const ezTransform& transform)
+{
+  ezVec3 corners[8];
+  for (ezUInt32 i = 0; i < 8; ++i)
+  {
+    corners[i].x = (i & 1) ? localBox.m_vMax.x : localBox.m_vMin.x;
+    corners[i].y = (i & 2) ? localBox.m_vMax.y : localBox.m_vMin.y;
+    corners[i].z = (i & 4) ? localBox.m_vMax.z : localBox.m_vMin.z;
+  }
+
+  AddOccluder(ezMakeArrayPtr(corners), ezMakeArrayPtr(s_BoxIndices), transform);
+}
+
+void ezOcclusionBuffer::Rasterize()
+{
+  if (m_Triangles.IsEmpty())
+    return;
+
+  // every task rasterizes all triangles that overlap its rows of tiles, so no synchronization between the tasks is necessary
+  ezTaskSystem::ParallelForIndexed(0, GetNumTilesY(),
+    [this](ezUInt32 uiStartIndex, ezUInt32 uiEndIndex) { RasterizeTileRows(uiStartIndex, uiEndIndex); }, "Occlusion Buffer Rasterization");
+}
+
+bool ezOcclusionBuffer::IsVisible(const ezBoundingBox& globalBox) const
+{
+  ezVec3 corners[8];
+  globalBox.GetCorners(corners);
+
+  float fMinX = ezMath::MaxValue<float>();
+  float fMinY = ezMath::MaxValue<float>();
+  float fMaxX = -ezMath::MaxValue<float>();
+  float fMaxY = -ezMath::MaxValue<float>();
+  float fMaxDepth = 0.0f;
+
+  for (ezUInt32 i = 0; i < 8; ++i)
+  {
+    const ezVec4 clipSpacePos = m_ViewProjectionMatrix * corners[i].GetAsVec4(1.0f);
+    if (clipSpacePos.w < s_fMinW)
+      return true;
+
+    const float fInvW = 1.0f / clipSpacePos.w;
+    const float fScreenX = (clipSpacePos.x * fInvW * 0.5f + 0.5f) * m_uiWidth;
+    const float fScreenY = (0.5f - clipSpacePos.y * fInvW * 0.5f) * m_uiHeight;
+
+    fMinX = ezMath::Min(fMinX, fScreenX);
+    fMinY = ezMath::Min(fMinY, fScreenY);
+    fMaxX = ezMath::Max(fMaxX, fScreenX);
+    fMaxY = ezMath::Max(fMaxY, fScreenY);
+    fMaxDepth = ezMath::Max(fMaxDepth, fInvW);
+  }
+
+  // Occluders only cover pixels with the center inside, so only the pixels with the center inside of the rectangle can be tested.
+  // A rectangle that doesn't contain any pixel center falls through the buffer and is always visible.
+  const ezInt32 iMinX = ezMath::Max((ezInt32)ezMath::Ceil(fMinX - 0.5f), 0);
+  const ezInt32 iMinY = ezMath::Max((ezInt32)ezMath::Ceil(fMinY - 0.5f), 0);
+  const ezInt32 iMaxX = ezMath::Min((ezInt32)ezMath::Floor(fMaxX - 0.5f), (ezInt32)m_uiWidth - 1);
+  const ezInt32 iMaxY = ezMath::Min((ezInt32)ezMath::Floor(fMaxY - 0.5f), (ezInt32)m_uiHeight - 1);
+
+  if (iMinX > iMaxX || iMinY > iMaxY)
+    return true;
+
+  const float fDepth = fMaxDepth * (1.0f + s_fDepthTolerance);
+  const ezSimdVec4f depth(fDepth);
+  const ezSimdVec4f laneIndices(0.0f, 1.0f, 2.0f, 3.0f);
+  const ezUInt32 uiNumTilesX = GetNumTilesX();
+
+  for (ezInt32 iTileY = iMinY / TileSize; iTileY <= iMaxY / TileSize; ++iTileY)
+  {
+    for (ezInt32 iTileX = iMinX / TileSize; iTileX <= iMaxX / TileSize; ++iTileX)
+    {
+      // the whole tile is covered by occluders in front of the box
+      if (m_TileDepth[iTileY * uiNumTilesX + iTileX] > fDepth)
+        continue;
+
+      const ezInt32 iTileMinX = iTileX * TileSize;
+      const ezInt32 iTileMinY = iTileY * TileSize;
+      const ezInt32 iStartY = ezMath::Max(iMinY, iTileMinY);
+      const ezInt32 iEndY = ezMath::Min(iMaxY, iTileMinY + TileSize - 1);
+
+      const ezSimdVec4f minX((float)iMinX);
+      const ezSimdVec4f maxX((float)iMaxX);
+
+      for (ezInt32 iBlockX = iTileMinX; iBlockX < iTileMinX + TileSize; iBlockX += 4)
+      {
+        if (iBlockX + 3 < iMinX || iBlockX > iMaxX)
+          continue;
+
+        const ezSimdVec4f x = ezSimdVec4f((float)iBlockX) + laneIndices;
+        const ezSimdVec4b inside = (x >= minX) && (x <= maxX);
+
+        for (ezInt32 y = iStartY; y <= iEndY; ++y)
+        {
+          ezSimdVec4f occluderDepth;
+          occluderDepth.Load<4>(m_Depth.GetData() + y * m_uiWidth + iBlockX);
+
+          if (((occluderDepth <= depth) && inside).AnySet())
+            return true;
+        }
+      }
+    }
+  }
+
+  return false;
+}
+
+void ezOcclusionBuffer::AddClipSpaceTriangle(const ezVec4& v0, const ezVec4& v1, const ezVec4& v2)
+{
+  const ezVec4 input[3] = {v0, v1, v2};
+
+  // clipping a triangle against the near plane results in at most four vertices
+  ezVec4 clipped[4];
+  ezUInt32 uiNumClipped = 0;
+
+  for (ezUInt32 i = 0; i < 3; ++i)
+  {
+    const ezVec4& a = input[i];
+    const ezVec4& b = input[(i + 1) % 3];
+    const bool bInsideA = a.w >= s_fMinW;
+    const bool bInsideB = b.w >= s_fMinW;
+
+    if (bInsideA)
+    {
+      clipped[uiNumClipped++] = a;
+    }
+
+    if (bInsideA != bInsideB)
+    {
+      const float t = (s_fMinW - a.w) / (b.w - a.w);
+      clipped[uiNumClipped++] = a + (b - a) * t;
+    }
+  }
+
+  if (uiNumClipped < 3)
+    return;
+
+  ezVec3 screenSpace[4];
+  for (ezUInt32 i = 0; i < uiNumClipped; ++i)
+  {
+    const float fInvW = 1.0f / clipped[i].w;
+    screenSpace[i].x = (clipped[i].x * fInvW * 0.5f + 0.5f) * m_uiWidth;
+    screenSpace[i].y = (0.5f - clipped[i].y * fInvW * 0.5f) * m_uiHeight;
+    screenSpace[i].z = fInvW;
+  }
+
+  AddScreenSpaceTriangle(screenSpace[0], screenSpace[1], screenSpace[2]);
+
+  if (uiNumClipped == 4)
+  {
+    AddScreenSpaceTriangle(screenSpace[0], screenSpace[2], screenSpace[3]);
+  }
+}
+
+void ezOcclusionBuffer::AddScreenSpaceTriangle(const ezVec3& v0, const ezVec3& v1, const ezVec3& v2)
+{
+  ezVec3 v[3] = {v0, v1, v2};
+
+  float fArea = (v[1].x - v[0].x) * (v[2].y - v[0].y) - (v[2].x - v[0].x) * (v[1].y - v[0].y);
+  if (ezMath::Abs(fArea) < ezMath::DefaultEpsilon<float>())
+    return;
+
+  // occluders are double sided, bring all triangles into the same winding
+  if (fArea < 0.0f)
+  {
+    ezMath::Swap(v[1], v[2]);
+    fArea = -fArea;
+  }
+
+  const ezInt32 iMinX = ezMath::Max((ezInt32)ezMath::Floor(ezMath::Min(v[0].x, v[1].x, v[2].x)), 0);
+  const ezInt32 iMinY = ezMath::Max((ezInt32)ezMath::Floor(ezMath::Min(v[0].y, v[1].y, v[2].y)), 0);
+  const ezInt32 iMaxX = ezMath::Min((ezInt32)ezMath::Ceil(ezMath::Max(v[0].x, v[1].x, v[2].x)), (ezInt32)m_uiWidth - 1);
+  const ezInt32 iMaxY = ezMath::Min((ezInt32)ezMath::Ceil(ezMath::Max(v[0].y, v[1].y, v[2].y)), (ezInt32)m_uiHeight - 1);
+
+  if (iMinX > iMaxX || iMinY > iMaxY)
+    return;
+
+  Triangle& triangle = m_Triangles.ExpandAndGetRef();
+  triangle.m_iMinX = iMinX;
+  triangle.m_iMinY = iMinY;
+  triangle.m_iMaxX = iMaxX;
+  triangle.m_iMaxY = iMaxY;
+
+  for (ezUInt32 i = 0; i < 3; ++i)
+  {
+    const ezVec3& a = v[i];
+    const ezVec3& b = v[(i + 1) % 3];
+
+    triangle.m_fEdgeA[i] = a.y - b.y;
+    triangle.m_fEdgeB[i] = b.x - a.x;
+    triangle.m_fEdgeC[i] = -triangle.m_fEdgeA[i] * a.x - triangle.m_fEdgeB[i] * a.y;
+  }
+
+  const float fInvArea = 1.0f / fArea;
+  triangle.m_fDepthA = ((v[1].z - v[0].z) * (v[2].y - v[0].y) - (v[2].z - v[0].z) * (v[1].y - v[0].y)) * fInvArea;
+  triangle.m_fDepthB = ((v[2].z - v[0].z) * (v[1].x - v[0].x) - (v[1].z - v[0].z) * (v[2].x - v[0].x)) * fInvArea;
+  triangle.m_fDepthC = v[0].z - triangle.m_fDepthA * v[0].x - triangle.m_fDepthB * v[0].y;
+}
+
+void ezOcclusionBuffer::RasterizeTileRows(ezUInt32 uiFirstTileRow, ezUInt32 uiEndTileRow)
+{
+  const ezInt32 iFirstRow = uiFirstTileRow * TileSize;
+  const ezInt32 iLastRow = uiEndTileRow * TileSize - 1;
+
+  const ezSimdVec4f pixelCenters(0.5f, 1.5f, 2.5f, 3.5f);
+  const ezSimdVec4f zero = ezSimdVec4f::ZeroVector();
+
+  for (const Triangle& triangle : m_Triangles)
+  {
+    const ezInt32 iStartY = ezMath::Max(triangle.m_iMinY, iFirstRow);
+    const ezInt32 iEndY = ezMath::Min(triangle.m_iMaxY, iLastRow);
+    if (iStartY > iEndY)
+      continue;
+
+    // the buffer width is a multiple of four, so blocks of four pixels never cross the end of a row
+    const ezInt32 iStartX = triangle.m_iMinX & ~3;
+    const ezInt32 iEndX = triangle.m_iMaxX;
+
+    const ezSimdVec4f edgeA0(triangle.m_fEdgeA[0]);
+    const ezSimdVec4f edgeA1(triangle.m_fEdgeA[1]);
+    const ezSimdVec4f edgeA2(triangle.m_fEdgeA[2]);
+    const ezSimdVec4f depthA(triangle.m_fDepthA);
+
+    for (ezInt32 y = iStartY; y <= iEndY; ++y)
+    {
+      const float fCenterY = y + 0.5f;
+      const ezSimdVec4f rowEdge0(triangle.m_fEdgeB[0] * fCenterY + triangle.m_fEdgeC[0]);
+      const ezSimdVec4f rowEdge1(triangle.m_fEdgeB[1] * fCenterY + triangle.m_fEdgeC[1]);
+      const ezSimdVec4f rowEdge2(triangle.m_fEdgeB[2] * fCenterY + triangle.m_fEdgeC[2]);
+      const ezSimdVec4f rowDepth(triangle.m_fDepthB * fCenterY + triangle.m_fDepthC);
+
+      float* pRow = m_Depth.GetData() + y * m_uiWidth;
+
+      for (ezInt32 x = iStartX; x <= iEndX; x += 4)
+      {
+        const ezSimdVec4f centerX = ezSimdVec4f((float)x) + pixelCenters;
+
+        const ezSimdVec4f edge0 = ezSimdVec4f::MulAdd(centerX, edgeA0, rowEdge0);
+        const ezSimdVec4f edge1 = ezSimdVec4f::MulAdd(centerX, edgeA1, rowEdge1);
+        const ezSimdVec4f edge2 = ezSimdVec4f::MulAdd(centerX, edgeA2, rowEdge2);
+
+        const ezSimdVec4b covered = (edge0 >= zero) && (edge1 >= zero) && (edge2 >= zero);
+        if (!covered.AnySet())
+          continue;
+
+        const ezSimdVec4f depth = ezSimdVec4f::MulAdd(centerX, depthA, rowDepth);
+
+        ezSimdVec4f bufferDepth;
+        bufferDepth.Load<4>(pRow + x);
+        ezSimdVec4f::Select(covered, bufferDepth.CompMax(depth), bufferDepth).Store<4>(pRow + x);
+      }
+    }
+  }
+
+  // the farthest depth per tile allows to reject objects without looking at the individual pixels
+  const ezUInt32 uiNumTilesX = GetNumTilesX();
+  for (ezUInt32 uiTileY = uiFirstTileRow; uiTileY < uiEndTileRow; ++uiTileY)
+  {
+    for (ezUInt32 uiTileX = 0; uiTileX < uiNumTilesX; ++uiTileX)
+    {
+      ezSimdVec4f tileDepth(ezMath::MaxValue<float>());
+
+      for (ezUInt32 y = 0; y < TileSize; ++y)
+      {
+        const float* pPixels = m_Depth.GetData() + (uiTileY * TileSize + y) * m_uiWidth + uiTileX * TileSize;
+
+        for (ezUInt32 x = 0; x < TileSize; x += 4)
+        {
+          ezSimdVec4f pixelDepth;
+          pixelDepth.Load<4>(pPixels + x);
+          tileDepth = tileDepth.CompMin(pixelDepth);
+        }
+      }
+
+      m_TileDepth[uiTileY * uiNumTilesX + uiTileX] = tileDepth.HorizontalMin<4>();
+    }
+  }
+}
+
+EZ_STATICLINK_FILE(RendererCore, RendererCore_Pipeline_Implementation_OcclusionBuffer);
@@ -94,8 +94,8 @@ void ezOpaqueForwardRenderPass::SetupPermutationVars(const ezRenderViewContext&
 
 void ezOpaqueForwardRenderPass::RenderObjects(const ezRenderViewContext& renderViewContext)
 {
-  RenderDataWithCategory(renderViewContext, ezDefaultRenderDataCategories::LitOpaque);
-  RenderDataWithCategory(renderViewContext, ezDefaultRenderDataCategories::LitMasked);
+  RenderDataWithCategoryParallel(renderViewContext, ezDefaultRenderDataCategories::LitOpaque);
+  RenderDataWithCategoryParallel(renderViewContext, ezDefaultRenderDataCategories::LitMasked);
 }
 
 
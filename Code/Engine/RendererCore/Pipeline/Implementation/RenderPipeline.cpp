@@ -2,10 +2,12 @@
 
 #include <Core/World/World.h>
 #include <Foundation/Time/Clock.h>
+#include <RendererCore/Components/OccluderComponent.h>
 #include <RendererCore/Debug/DebugRenderer.h>
 #include <RendererCore/GPUResourcePool/GPUResourcePool.h>
 #include <RendererCore/Pipeline/Extractor.h>
 #include <RendererCore/Pipeline/FrameDataProvider.h>
+#include <RendererCore/Pipeline/OcclusionBuffer.h>
 #include <RendererCore/Pipeline/Passes/TargetPass.h>
 #include <RendererCore/Pipeline/RenderPipeline.h>
 #include <RendererCore/Pipeline/View.h>
@@ -18,8 +20,17 @@ ezCVarBool ezRenderPipeline::s_DebugCulling("r_DebugCulling", false, ezCVarFlags
   "Enables debug visualization of visibility culling");
 
 ezCVarBool CVarCullingStats("r_CullingStats", false, ezCVarFlags::Default, "Display some stats of the visibility culling");
+
+ezCVarBool CVarDebugOcclusion("r_DebugOcclusion", false, ezCVarFlags::Default,
+  "Displays the occlusion buffer and the bounds of all objects that are culled by occluders");
 #endif
 
+ezCVarBool CVarOcclusionCulling("r_OcclusionCulling", false, ezCVarFlags::Default,
+  "Enables software occlusion culling against the boxes of occluder components");
+
+ezCVarInt CVarOcclusionBufferWidth("r_OcclusionBufferWidth", 256, ezCVarFlags::Default,
+  "Width of the occlusion buffer in pixels, the height is derived from the aspect ratio of the view");
+
 ezRenderPipeline::ezRenderPipeline()
   : m_PipelineState(PipelineState::Uninitialized)
 {
@@ -851,6 +862,8 @@ bool ezRenderPipeline::ArePassThroughInputsDone(const ezRenderPipelinePass* pPas
 
 ezFrameDataProviderBase* ezRenderPipeline::GetFrameDataProvider(const ezRTTI* pRtti) const
 {
+  EZ_LOCK(m_DataProviderMutex);
+
   ezUInt32 uiIndex = 0;
   if (m_TypeToDataProviderIndex.TryGetValue(pRtti, uiIndex))
   {
@@ -943,6 +956,8 @@ void ezRenderPipeline::FindVisibleObjects(const ezView& view)
   ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
   view.GetWorld()->GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, m_visibleObjects, bRecordStats ? &stats : nullptr);
 
+  CullOccludedObjects(view, frustum);
+
   ezViewHandle hView = view.GetHandle();
 
   if (s_DebugCulling && bIsMainView)
@@ -970,9 +985,142 @@ void ezRenderPipeline::FindVisibleObjects(const ezView& view)
 
     sb.Format("Time Taken: {0}ms", m_AverageCullingTime.GetMilliseconds());
     ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 280), ezColor::LimeGreen);
+
+    if (CVarOcclusionCulling)
+    {
+      const ezView::OcclusionCullingStats& occlusionStats = view.GetOcclusionCullingStats();
+
+      sb.Format("Num Occluders: {0} ({1} triangles)", occlusionStats.m_uiNumOccluders, occlusionStats.m_uiNumOccluderTriangles);
+      ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 300), ezColor::LimeGreen);
+
+      sb.Format("Num Objects Occluded: {0} of {1}", occlusionStats.m_uiNumObjectsOccluded, occlusionStats.m_uiNumObjectsTested);
+      ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 320), ezColor::LimeGreen);
+
+      m_AverageOcclusionCullingTime = ezMath::Lerp(m_AverageOcclusionCullingTime, occlusionStats.m_TimeTaken, 0.05f);
+
+      sb.Format("Occlusion Time Taken: {0}ms", m_AverageOcclusionCullingTime.GetMilliseconds());
+      ezDebugRenderer::Draw2DText(hView, sb, ezVec2I32(10, 340), ezColor::LimeGreen);
+    }
   }
 #else
-  view.GetWorld()->GetSpatialSystem().FindVisibleObjects(frustum, m_visibleObjects, nullptr);
+  ezUInt32 uiCategoryBitmask = ezDefaultSpatialDataCategories::RenderStatic.GetBitmask() | ezDefaultSpatialDataCategories::RenderDynamic.GetBitmask();
+  view.GetWorld()->GetSpatialSystem()->FindVisibleObjects(frustum, uiCategoryBitmask, m_visibleObjects, nullptr);
+
+  CullOccludedObjects(view, frustum);
+#endif
+}
+
+void ezRenderPipeline::CullOccludedObjects(const ezView& view, const ezFrustum& frustum)
+{
+  ezView::OcclusionCullingStats& stats = view.m_OcclusionCullingStats;
+  stats = ezView::OcclusionCullingStats();
+
+  if (!CVarOcclusionCulling || m_visibleObjects.IsEmpty())
+    return;
+
+  EZ_PROFILE_SCOPE("Occlusion Culling");
+
+  const ezTime startTime = ezTime::Now();
+
+  m_Occluders.Clear();
+  view.GetWorld()->GetSpatialSystem()->FindVisibleObjects(frustum, ezDefaultSpatialDataCategories::Occluder.GetBitmask(), m_Occluders, nullptr);
+
+  if (m_Occluders.IsEmpty())
+    return;
+
+  if (m_pOcclusionBuffer == nullptr)
+  {
+    m_pOcclusionBuffer = EZ_DEFAULT_NEW(ezOcclusionBuffer);
+  }
+
+  ezMat4 viewProjectionMatrix;
+  view.ComputeCullingViewProjectionMatrix(viewProjectionMatrix);
+
+  const ezRectFloat& viewport = view.GetViewport();
+  const ezUInt32 uiWidth = ezMath::Clamp<ezInt32>(CVarOcclusionBufferWidth, ezOcclusionBuffer::TileSize, 2048);
+  const ezUInt32 uiHeight = ezMath::Clamp<ezUInt32>((ezUInt32)(uiWidth * viewport.height / viewport.width), ezOcclusionBuffer::TileSize, 2048);
+
+  m_pOcclusionBuffer->Begin(viewProjectionMatrix, uiWidth, uiHeight);
+
+  for (const ezGameObject* pOccluder : m_Occluders)
+  {
+    const ezTransform globalTransform = pOccluder->GetGlobalTransform();
+
+    for (const ezComponent* pComponent : pOccluder->GetComponents())
+    {
+      const ezOccluderComponent* pOccluderComponent = ezDynamicCast<const ezOccluderComponent*>(pComponent);
+      if (pOccluderComponent != nullptr && pOccluderComponent->IsActive())
+      {
+        m_pOcclusionBuffer->AddOccluderBox(pOccluderComponent->GetLocalOccluderBox(), globalTransform);
+        ++stats.m_uiNumOccluders;
+      }
+    }
+  }
+
+  m_pOcclusionBuffer->Rasterize();
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  const bool bDebugOcclusion =
+    CVarDebugOcclusion && (view.GetCameraUsageHint() == ezCameraUsageHint::MainView || view.GetCameraUsageHint() == ezCameraUsageHint::EditorView);
+#endif
+
+  // objects without valid bounds, e.g. always visible ones, are never culled
+  ezUInt32 uiNumVisibleObjects = 0;
+  for (const ezGameObject* pObject : m_visibleObjects)
+  {
+    const ezBoundingBoxSphere globalBounds = pObject->GetGlobalBounds();
+
+    if (!globalBounds.IsValid() || m_pOcclusionBuffer->IsVisible(globalBounds.GetBox()))
+    {
+      m_visibleObjects[uiNumVisibleObjects] = pObject;
+      ++uiNumVisibleObjects;
+    }
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+    else if (bDebugOcclusion)
+    {
+      ezDebugRenderer::DrawLineBox(view.GetWorld(), globalBounds.GetBox(), ezColor::Red);
+    }
+#endif
+  }
+
+  stats.m_uiNumOccluderTriangles = m_pOcclusionBuffer->GetNumOccluderTriangles();
+  stats.m_uiNumObjectsTested = m_visibleObjects.GetCount();
+  stats.m_uiNumObjectsOccluded = m_visibleObjects.GetCount() - uiNumVisibleObjects;
+  stats.m_TimeTaken = ezTime::Now() - startTime;
+
+  m_visibleObjects.SetCount(uiNumVisibleObjects);
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
+  if (bDebugOcclusion)
+  {
+    // draw the farthest depth of every tile, brighter means closer
+    const ezUInt32 uiNumTilesX = m_pOcclusionBuffer->GetNumTilesX();
+    const ezUInt32 uiNumTilesY = m_pOcclusionBuffer->GetNumTilesY();
+    const float fTileSize = 2.0f * ezOcclusionBuffer::TileSize;
+    const ezVec2 vOffset(viewport.width - uiNumTilesX * fTileSize - 10.0f, 10.0f);
+
+    float fMaxDepth = 0.0f;
+    for (ezUInt32 y = 0; y < uiNumTilesY; ++y)
+    {
+      for (ezUInt32 x = 0; x < uiNumTilesX; ++x)
+      {
+        fMaxDepth = ezMath::Max(fMaxDepth, m_pOcclusionBuffer->GetTileDepth(x, y));
+      }
+    }
+
+    const float fDepthScale = fMaxDepth > 0.0f ? 1.0f / fMaxDepth : 0.0f;
+
+    for (ezUInt32 y = 0; y < uiNumTilesY; ++y)
+    {
+      for (ezUInt32 x = 0; x < uiNumTilesX; ++x)
+      {
+        const float fBrightness = m_pOcclusionBuffer->GetTileDepth(x, y) * fDepthScale;
+        const ezRectFloat rect(vOffset.x + x * fTileSize, vOffset.y + y * fTileSize, fTileSize, fTileSize);
+
+        ezDebugRenderer::Draw2DRectangle(view.GetHandle(), rect, 0.0f, ezColor(fBrightness, fBrightness, fBrightness, 0.75f));
+      }
+    }
+  }
 #endif
 }
 
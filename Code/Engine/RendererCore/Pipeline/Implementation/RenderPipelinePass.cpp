@@ -1,5 +1,7 @@
 #include <RendererCorePCH.h>
 
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <RendererCore/Pipeline/RenderPipeline.h>
 #include <RendererCore/Pipeline/RenderPipelinePass.h>
 #include <RendererCore/Pipeline/Renderer.h>
@@ -25,6 +27,10 @@ EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezRenderPipelinePass, 1, ezRTTINoAllocator)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
+ezCVarBool CVarParallelRecording("r_ParallelRecording", true, ezCVarFlags::Default, "Record the batches of render passes on several threads if supported");
+ezCVarInt CVarParallelRecordingChunks("r_ParallelRecordingChunks", 8, ezCVarFlags::Default, "Maximum number of deferred render contexts that the batches of one category are recorded into");
+ezCVarInt CVarParallelRecordingMinBatches("r_ParallelRecordingMinBatches", 16, ezCVarFlags::Default, "Minimum number of batches that are recorded into one deferred render context");
+
 ezRenderPipelinePass::ezRenderPipelinePass(const char* szName, bool bIsStereoAware)
   : m_bActive(true)
   , m_bIsStereoAware(bIsStereoAware)
@@ -66,11 +72,148 @@ void ezRenderPipelinePass::RenderDataWithCategory(
   EZ_PROFILE_AND_MARKER(renderViewContext.m_pRenderContext->GetGALContext(), ezRenderData::GetCategoryName(category));
 
   auto batchList = m_pPipeline->GetRenderDataBatchesWithCategory(category, filter);
+  RenderBatches(renderViewContext, category, batchList, 0, batchList.GetBatchCount());
+}
+
+void ezRenderPipelinePass::RenderDataWithCategoryParallel(
+  const ezRenderViewContext& renderViewContext, ezRenderData::Category category, ezRenderDataBatch::Filter filter)
+{
+  EZ_PROFILE_AND_MARKER(renderViewContext.m_pRenderContext->GetGALContext(), ezRenderData::GetCategoryName(category));
+
+  auto batchList = m_pPipeline->GetRenderDataBatchesWithCategory(category, filter);
+  RenderBatchesParallel(renderViewContext, category, batchList);
+}
+
+void ezRenderPipelinePass::RenderBatchesParallel(
+  const ezRenderViewContext& renderViewContext, ezRenderData::Category category, const ezRenderDataBatchList& batchList)
+{
   const ezUInt32 uiBatchCount = batchList.GetBatchCount();
+
+  ezUInt32 uiChunkCount = 0;
+  if (CVarParallelRecording && !renderViewContext.m_pRenderContext->IsDeferred() &&
+      ezGALDevice::GetDefaultDevice()->GetCapabilities().m_bMultithreadedCommandRecording)
+  {
+    const ezUInt32 uiMaxChunkCount = static_cast<ezUInt32>(ezMath::Max(CVarParallelRecordingChunks.GetValue(), 0));
+    const ezUInt32 uiMinBatchesPerChunk = static_cast<ezUInt32>(ezMath::Max(CVarParallelRecordingMinBatches.GetValue(), 1));
+    uiChunkCount = ezMath::Min(uiMaxChunkCount, uiBatchCount / uiMinBatchesPerChunk);
+  }
+
+  // the chunks are balanced by the number of render data, so count it while checking whether all renderers can record in parallel
+  ezUInt64 uiRenderDataCount = 0;
+  for (ezUInt32 i = 0; i < uiBatchCount && uiChunkCount >= 2; ++i)
+  {
+    const ezRenderDataBatch& batch = batchList.GetBatch(i);
+
+    if (const ezRenderData* pRenderData = batch.GetFirstData<ezRenderData>())
+    {
+      const ezRenderer* pRenderer = ezRenderData::GetCategoryRenderer(category, pRenderData->GetDynamicRTTI());
+      if (pRenderer != nullptr && !pRenderer->SupportsParallelRecording())
+      {
+        uiChunkCount = 0;
+      }
+    }
+
+    uiRenderDataCount += batch.GetCount();
+  }
+
+  struct Chunk
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezRenderContext* m_pRenderContext;
+    ezUInt32 m_uiFirstBatch;
+    ezUInt32 m_uiBatchCount;
+  };
+
+  ezHybridArray<Chunk, 16> chunks;
+  for (ezUInt32 i = 0; i < uiChunkCount; ++i)
+  {
+    ezRenderContext* pDeferredContext = ezRenderContext::GetDeferredInstance(i);
+    if (pDeferredContext == nullptr)
+      break;
+
+    Chunk& chunk = chunks.ExpandAndGetRef();
+    chunk.m_pRenderContext = pDeferredContext;
+    chunk.m_uiFirstBatch = 0;
+    chunk.m_uiBatchCount = 0;
+  }
+
+  if (chunks.GetCount() < 2)
+  {
+    RenderBatches(renderViewContext, category, batchList, 0, uiBatchCount);
+    return;
+  }
+
+  // split the batches into consecutive ranges with roughly the same number of render data
+  {
+    const ezUInt64 uiActualChunkCount = chunks.GetCount();
+    ezUInt64 uiAccumulatedCount = 0;
+    ezUInt32 uiChunkIndex = 0;
+
+    for (ezUInt32 i = 0; i < uiBatchCount; ++i)
+    {
+      ++chunks[uiChunkIndex].m_uiBatchCount;
+      uiAccumulatedCount += batchList.GetBatch(i).GetCount();
+
+      if (uiChunkIndex + 1 < uiActualChunkCount && uiAccumulatedCount * uiActualChunkCount >= uiRenderDataCount * (uiChunkIndex + 1))
+      {
+        ++uiChunkIndex;
+        chunks[uiChunkIndex].m_uiFirstBatch = i + 1;
+      }
+    }
+  }
+
+  // shared resources have to be up to date before the first chunk executes, otherwise earlier chunks would use stale data
   for (ezUInt32 i = 0; i < uiBatchCount; ++i)
   {
     const ezRenderDataBatch& batch = batchList.GetBatch(i);
 
+    if (const ezRenderData* pRenderData = batch.GetFirstData<ezRenderData>())
+    {
+      if (const ezRenderer* pRenderer = ezRenderData::GetCategoryRenderer(category, pRenderData->GetDynamicRTTI()))
+      {
+        pRenderer->PrepareParallelRecording(renderViewContext, batch);
+      }
+    }
+  }
+
+  ezRenderContext* pRenderContext = renderViewContext.m_pRenderContext;
+  for (const Chunk& chunk : chunks)
+  {
+    chunk.m_pRenderContext->BeginRecording(*pRenderContext);
+  }
+
+  ezTaskSystem::ParallelForParams params;
+  params.uiMaxTasksPerThread = 1;
+
+  ezTaskSystem::ParallelForIndexed(0, chunks.GetCount(),
+    [&](ezUInt32 uiStartChunk, ezUInt32 uiEndChunk) {
+      for (ezUInt32 i = uiStartChunk; i < uiEndChunk; ++i)
+      {
+        EZ_PROFILE_SCOPE("RecordChunk");
+
+        ezRenderViewContext chunkViewContext = renderViewContext;
+        chunkViewContext.m_pRenderContext = chunks[i].m_pRenderContext;
+
+        RenderBatches(chunkViewContext, category, batchList, chunks[i].m_uiFirstBatch, chunks[i].m_uiBatchCount);
+      }
+    },
+    "Parallel Batch Recording", params);
+
+  // execute in batch order, so the result is the same as if all batches were rendered on the render context directly
+  for (const Chunk& chunk : chunks)
+  {
+    pRenderContext->ExecuteDeferredInstance(chunk.m_pRenderContext);
+  }
+}
+
+void ezRenderPipelinePass::RenderBatches(const ezRenderViewContext& renderViewContext, ezRenderData::Category category,
+  const ezRenderDataBatchList& batchList, ezUInt32 uiFirstBatch, ezUInt32 uiBatchCount)
+{
+  for (ezUInt32 i = uiFirstBatch; i < uiFirstBatch + uiBatchCount; ++i)
+  {
+    const ezRenderDataBatch& batch = batchList.GetBatch(i);
+
     if (const ezRenderData* pRenderData = batch.GetFirstData<ezRenderData>())
     {
       const ezRTTI* pType = pRenderData->GetDynamicRTTI();
@@ -83,6 +226,4 @@ void ezRenderPipelinePass::RenderDataWithCategory(
   }
 }
 
-
-
 EZ_STATICLINK_FILE(RendererCore, RendererCore_Pipeline_Implementation_RenderPipelinePass);
@@ -45,6 +45,9 @@ ezView::ezView()
   m_fLastViewportAspectRatio = 1.0f;
 
   m_uiRenderPipelineResourceDescriptionCounter = 0;
+
+  m_fLodBias = 0.0f;
+  m_fLodScreenSizeScale = 1.0f;
 }
 
 ezView::~ezView() {}
@@ -132,11 +135,21 @@ void ezView::ExtractData()
   m_pRenderPipeline->m_sName = m_sName;
   m_pRenderPipeline->ExtractData(*this);
 
+  RemoveOutdatedLodSelections();
+
   extractionEvent.m_Type = ezRenderWorldExtractionEvent::Type::AfterViewExtraction;
   ezRenderWorld::s_ExtractionEvent.Broadcast(extractionEvent);
 }
 
 void ezView::ComputeCullingFrustum(ezFrustum& out_Frustum) const
+{
+  ezMat4 viewProjectionMatrix;
+  ComputeCullingViewProjectionMatrix(viewProjectionMatrix);
+
+  out_Frustum.SetFrustum(viewProjectionMatrix);
+}
+
+void ezView::ComputeCullingViewProjectionMatrix(ezMat4& out_ViewProjectionMatrix) const
 {
   const ezCamera* pCamera = GetCullingCamera();
   const float fViewportAspectRatio = m_Data.m_ViewPortRect.width / m_Data.m_ViewPortRect.height;
@@ -146,7 +159,73 @@ void ezView::ComputeCullingFrustum(ezFrustum& out_Frustum) const
   ezMat4 projectionMatrix;
   pCamera->GetProjectionMatrix(fViewportAspectRatio, projectionMatrix);
 
-  out_Frustum.SetFrustum(projectionMatrix * viewMatrix);
+  out_ViewProjectionMatrix = projectionMatrix * viewMatrix;
+}
+
+void ezView::SetLodBias(float fBias)
+{
+  m_fLodBias = fBias;
+  m_fLodScreenSizeScale = ezMath::Pow(2.0f, -fBias);
+}
+
+float ezView::ComputeLodScreenSize(const ezBoundingSphere& globalSphere) const
+{
+  const ezCamera* pCamera = GetCullingCamera();
+  const float fViewportAspectRatio = m_Data.m_ViewPortRect.width / m_Data.m_ViewPortRect.height;
+
+  float fScreenSize = 0.0f;
+  if (pCamera->IsOrthographic())
+  {
+    fScreenSize = (2.0f * globalSphere.m_fRadius) / pCamera->GetDimensionY(fViewportAspectRatio);
+  }
+  else
+  {
+    const float fDistance = ezMath::Max((globalSphere.m_vCenter - pCamera->GetCenterPosition()).GetLength(), pCamera->GetNearPlane());
+    const float fTanHalfFov = ezMath::Tan(pCamera->GetFovY(fViewportAspectRatio) * 0.5f);
+
+    fScreenSize = globalSphere.m_fRadius / (fDistance * fTanHalfFov);
+  }
+
+  return fScreenSize * m_fLodScreenSizeScale;
+}
+
+ezUInt32 ezView::GetPreviousLod(const ezComponentHandle& hComponent) const
+{
+  LodSelection selection;
+  if (m_LodSelections.TryGetValue(hComponent, selection))
+  {
+    return selection.m_uiLod;
+  }
+
+  return ezInvalidIndex;
+}
+
+void ezView::StoreSelectedLod(const ezComponentHandle& hComponent, ezUInt32 uiLod) const
+{
+  LodSelection& selection = m_LodSelections[hComponent];
+  selection.m_uiLod = uiLod;
+  selection.m_uiLastFrame = ezRenderWorld::GetFrameCounter();
+}
+
+void ezView::RemoveOutdatedLodSelections()
+{
+  // Entries of objects that haven't been visible for a while are removed, so that the table doesn't grow with deleted components.
+  // The check is only done every couple of frames since it has to go through all entries.
+  const ezUInt64 uiFrameCounter = ezRenderWorld::GetFrameCounter();
+  if ((uiFrameCounter % 64) != 0)
+    return;
+
+  for (auto it = m_LodSelections.GetIterator(); it.IsValid();)
+  {
+    if (uiFrameCounter - it.Value().m_uiLastFrame > 64)
+    {
+      it = m_LodSelections.Remove(it);
+    }
+    else
+    {
+      ++it;
+    }
+  }
 }
 
 void ezView::SetRenderPassProperty(const char* szPassName, const char* szPropertyName, const ezVariant& value)
@@ -69,6 +69,16 @@ EZ_ALWAYS_INLINE const ezRectFloat& ezView::GetViewport() const
   return m_Data.m_ViewPortRect;
 }
 
+EZ_ALWAYS_INLINE float ezView::GetLodBias() const
+{
+  return m_fLodBias;
+}
+
+EZ_ALWAYS_INLINE const ezView::OcclusionCullingStats& ezView::GetOcclusionCullingStats() const
+{
+  return m_OcclusionCullingStats;
+}
+
 EZ_ALWAYS_INLINE const ezViewData& ezView::GetData() const
 {
   UpdateCachedMatrices();
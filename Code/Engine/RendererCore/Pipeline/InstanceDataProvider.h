@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Foundation/Types/UniquePtr.h>
 #include <RendererCore/Declarations.h>
 #include <RendererCore/Pipeline/FrameDataProvider.h>
 #include <RendererCore/Shader/ConstantBufferStorage.h>
@@ -7,6 +8,7 @@
 struct ezPerInstanceData;
 class ezInstanceDataProvider;
 class ezInstancedMeshComponent;
+class ezStaticInstanceData;
 
 struct EZ_RENDERERCORE_DLL ezInstanceData
 {
@@ -28,6 +30,7 @@ public:
 private:
   friend ezInstanceDataProvider;
   friend ezInstancedMeshComponent;
+  friend ezStaticInstanceData;
 
   void CreateBuffer(ezUInt32 uiSize);
   void Reset();
@@ -45,10 +48,90 @@ public:
   ezInstanceDataProvider();
   ~ezInstanceDataProvider();
 
+  /// \brief Returns the instance data for the render context of the given view context.
+  ///
+  /// Render contexts that record into a deferred GAL context get their own instance data, since their uploads and draws
+  /// are only executed later and must not interfere with each other.
+  ezInstanceData* GetData(const ezRenderViewContext& renderViewContext);
+
 private:
 
   virtual void* UpdateData(const ezRenderViewContext& renderViewContext, const ezExtractedRenderData& extractedData) override;
 
   ezInstanceData m_Data;
+
+  ezMutex m_Mutex;
+  ezHashTable<const ezRenderContext*, ezUniquePtr<ezInstanceData>> m_DeferredData;
 };
 
+/// \brief Keeps the instance data of batches that only consist of cached render data in a persistent buffer across frames.
+///
+/// Cached render data belongs to static objects and never changes while it is cached, see ezRenderData::m_uiCacheId. The instance data of
+/// such a batch therefore only has to be filled and uploaded again if the composition of the batch changes, e.g. because objects became
+/// visible or invisible. In that case only the ranges of instances that actually differ from the previous frame are uploaded.
+/// Batches are identified by a key that the renderer chooses, typically a combination of the render pipeline pass and the batch id.
+/// The key has to differ whenever the batch may be filtered differently, since only the filtered render data is stored.
+///
+/// Space in the buffer is handed out per batch. Batches that were not rendered in the current frame are evicted if the buffer is full.
+class EZ_RENDERERCORE_DLL ezStaticInstanceData
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezStaticInstanceData);
+
+public:
+  ezStaticInstanceData(ezUInt32 uiMaxInstanceCount = 16 * 1024);
+  ~ezStaticInstanceData();
+
+  /// \brief Looks up the persistent instance data of the given batch.
+  ///
+  /// Fails if the batch contains render data that isn't cached or if there is not enough space left in the buffer. The per frame
+  /// instance data has to be used in that case.
+  /// If the batch changed since it was rendered the last time, out_InstanceDataToFill is the range that has to be filled with the instance
+  /// data of the whole batch, followed by a call to UpdateInstanceData(). Otherwise it is empty and the batch can be drawn right away.
+  ezResult BeginBatch(ezUInt64 uiBatchKey, const ezRenderDataBatch& batch, ezArrayPtr<ezPerInstanceData>& out_InstanceDataToFill);
+
+  /// \brief Uploads all instances of the current batch that differ from the previous frame.
+  ///
+  /// Fails if the number of filled instances doesn't match the batch, in which case the per frame instance data has to be used.
+  ezResult UpdateInstanceData(ezRenderContext* pRenderContext, ezUInt32 uiFilledCount);
+
+  /// \brief Binds the buffer and sets up the instance offset for drawing the current batch. Returns the number of instances to draw.
+  ///
+  /// Each render context gets its own object constants, so batches can be bound on render contexts that record in parallel.
+  /// The calls from BeginBatch() to BindBatch() must not be interleaved with another batch though.
+  ezUInt32 BindBatch(ezRenderContext* pRenderContext);
+
+private:
+  struct Range
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiOffset;
+    ezUInt32 m_uiCount;
+  };
+
+  struct Batch
+  {
+    Range m_Range = {0, 0};
+    ezUInt64 m_uiLastUsedFrame = 0;
+
+    /// Cache ids of the render data whose instance data is currently stored in the buffer.
+    ezDynamicArray<ezUInt32> m_CacheIds;
+  };
+
+  bool AllocateRange(ezUInt32 uiCount, Range& out_Range);
+  void FreeRange(const Range& range);
+  void EvictUnusedBatches();
+
+  ezConstantBufferStorageHandle GetObjectConstants(ezRenderContext* pRenderContext);
+
+  ezInstanceData m_Data;
+  ezHashTable<ezUInt64, Batch> m_Batches;
+  ezHashTable<const ezRenderContext*, ezConstantBufferStorageHandle> m_DeferredObjectConstants;
+
+  /// Sorted by offset, adjacent ranges are always merged.
+  ezDynamicArray<Range> m_FreeRanges;
+
+  ezUInt64 m_uiCurrentBatchKey = 0;
+  Batch* m_pCurrentBatch = nullptr;
+  ezDynamicArray<ezUInt32> m_CurrentCacheIds;
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Math/BoundingBox.h>
+#include <Foundation/Math/Mat4.h>
+#include <Foundation/Math/Transform.h>
+#include <RendererCore/RendererCoreDLL.h>
+
+/// \brief A low resolution depth buffer that is rasterized on the CPU to cull objects that are hidden behind occluders.
+///
+/// Occluders are collected between Begin() and Rasterize() and are then rasterized in bands of tiles in parallel through the task system.
+/// Each task processes four pixels at a time with SIMD edge and depth functions. The buffer stores the reciprocal clip space w
+/// of the nearest occluder per pixel, which is linear in screen space and independent of the depth range of the projection.
+/// Empty pixels are 0, i.e. infinitely far away.
+///
+/// Occluders and objects are both sampled at pixel centers. A pixel is covered by an occluder if its center is inside of a triangle,
+/// and objects are tested with the nearest point of their bounding box at every pixel center inside of their screen space rectangle.
+/// So an object is only reported as hidden if it is hidden at the resolution of the buffer. This is not conservative below that
+/// resolution, an object can peek through a gap between occluders that is narrower than a pixel. Objects that don't contain
+/// any pixel center are always reported as visible.
+class EZ_RENDERERCORE_DLL ezOcclusionBuffer
+{
+  EZ_DISALLOW_COPY_AND_ASSIGN(ezOcclusionBuffer);
+
+public:
+  enum
+  {
+    TileSize = 8 ///< Width and height of a tile in pixels. The buffer dimensions are always a multiple of this.
+  };
+
+  ezOcclusionBuffer();
+  ~ezOcclusionBuffer();
+
+  /// \brief Clears the buffer and removes all occluders. The given view projection matrix is used for all following calls.
+  ///
+  /// The resolution is rounded up to a multiple of the tile size.
+  void Begin(const ezMat4& viewProjectionMatrix, ezUInt32 uiWidth, ezUInt32 uiHeight);
+
+  /// \brief Adds an indexed triangle list as occluder. Both sides of the triangles occlude.
+  ///
+  /// Triangles that intersect the near plane are clipped.
+  void AddOccluder(ezArrayPtr<const ezVec3> positions, ezArrayPtr<const ezUInt32> indices, const ezTransform& transform);
+
+  /// \brief Adds a solid box as occluder.
+  void AddOccluderBox(const ezBoundingBox& localBox, const ezTransform& transform);
+
+  /// \brief Rasterizes all occluders that were added since Begin().
+  void Rasterize();
+
+  /// \brief Returns false if the given box is hidden behind the rasterized occluders at every pixel center that it covers.
+  ///
+  /// Boxes that intersect the near plane, that are outside of the buffer or that don't cover any pixel center are always reported as visible.
+  bool IsVisible(const ezBoundingBox& globalBox) const;
+
+  ezUInt32 GetWidth() const { return m_uiWidth; }
+  ezUInt32 GetHeight() const { return m_uiHeight; }
+
+  ezUInt32 GetNumTilesX() const { return m_uiWidth / TileSize; }
+  ezUInt32 GetNumTilesY() const { return m_uiHeight / TileSize; }
+
+  /// \brief Returns the number of triangles that have been added as occluders after near plane clipping.
+  ezUInt32 GetNumOccluderTriangles() const { return m_Triangles.GetCount(); }
+
+  /// \brief Returns the reciprocal w of the nearest occluder at the given pixel or 0 if the pixel isn't covered.
+  ///
+  /// Pixel (0, 0) is the top left corner.
+  float GetDepth(ezUInt32 x, ezUInt32 y) const { return m_Depth[y * m_uiWidth + x]; }
+
+  /// \brief Returns the farthest depth of all pixels in the given tile, see GetDepth().
+  float GetTileDepth(ezUInt32 uiTileX, ezUInt32 uiTileY) const { return m_TileDepth[uiTileY * GetNumTilesX() + uiTileX]; }
+
+private:
+  struct Triangle
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    // edge functions, a pixel is covered if all three are >= 0 at its center
+    float m_fEdgeA[3];
+    float m_fEdgeB[3];
+    float m_fEdgeC[3];
+
+    // depth plane
+    float m_fDepthA;
+    float m_fDepthB;
+    float m_fDepthC;
+
+    // inclusive pixel bounds
+    ezInt32 m_iMinX;
+    ezInt32 m_iMinY;
+    ezInt32 m_iMaxX;
+    ezInt32 m_iMaxY;
+  };
+
+  void AddClipSpaceTriangle(const ezVec4& v0, const ezVec4& v1, const ezVec4& v2);
+  void AddScreenSpaceTriangle(const ezVec3& v0, const ezVec3& v1, const ezVec3& v2);
+  void RasterizeTileRows(ezUInt32 uiFirstTileRow, ezUInt32 uiEndTileRow);
+
+  ezMat4 m_ViewProjectionMatrix;
+  ezUInt32 m_uiWidth = 0;
+  ezUInt32 m_uiHeight = 0;
+
+  ezDynamicArray<Triangle> m_Triangles;
+  ezDynamicArray<float> m_Depth;
+  ezDynamicArray<float> m_TileDepth;
+};
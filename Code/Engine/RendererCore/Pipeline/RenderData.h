@@ -48,6 +48,10 @@ public:
   ezUInt32 m_uiBatchId = 0; ///< BatchId is used to group render data in batches.
   ezUInt32 m_uiSortingKey = 0;
 
+  /// \brief Unique id that is assigned when the render data is stored in the render data cache. Cached render data never changes,
+  /// so the id identifies its content for as long as it is cached. Always 0 for render data that is only valid for one frame.
+  ezUInt32 m_uiCacheId = 0;
+
   ezTransform m_GlobalTransform;
   ezBoundingBoxSphere m_GlobalBounds;
 
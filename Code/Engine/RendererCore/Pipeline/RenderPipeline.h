@@ -4,6 +4,7 @@
 #include <Foundation/Containers/DynamicArray.h>
 #include <Foundation/Containers/HybridArray.h>
 #include <Foundation/Strings/HashedString.h>
+#include <Foundation/Threading/Mutex.h>
 #include <Foundation/Types/UniquePtr.h>
 #include <RendererCore/Pipeline/ExtractedRenderData.h>
 
@@ -11,6 +12,8 @@ class ezProfilingId;
 class ezView;
 class ezRenderPipelinePass;
 class ezFrameDataProviderBase;
+class ezFrustum;
+class ezOcclusionBuffer;
 
 class EZ_RENDERERCORE_DLL ezRenderPipeline : public ezRefCounted
 {
@@ -79,6 +82,7 @@ private:
 
   void ExtractData(const ezView& view);
   void FindVisibleObjects(const ezView& view);
+  void CullOccludedObjects(const ezView& view, const ezFrustum& frustum);
 
   void Render(ezRenderContext* pRenderer);
 
@@ -91,8 +95,13 @@ private: // Member data
   ezExtractedRenderData m_Data[2];
   ezDynamicArray<const ezGameObject*> m_visibleObjects;
 
+  // Occlusion culling, the buffer is only created once occlusion culling is used
+  ezDynamicArray<const ezGameObject*> m_Occluders;
+  ezUniquePtr<ezOcclusionBuffer> m_pOcclusionBuffer;
+
 #if EZ_ENABLED(EZ_COMPILE_FOR_DEVELOPMENT)
   ezTime m_AverageCullingTime;
+  ezTime m_AverageOcclusionCullingTime;
 #endif
 
   ezHashedString m_sName;
@@ -132,5 +141,6 @@ private: // Member data
   // Data Providers
   mutable ezDynamicArray<ezUniquePtr<ezFrameDataProviderBase>> m_DataProviders;
   mutable ezHashTable<const ezRTTI*, ezUInt32> m_TypeToDataProviderIndex;
+  mutable ezMutex m_DataProviderMutex;
 };
 
@@ -66,12 +66,28 @@ public:
   void RenderDataWithCategory(const ezRenderViewContext& renderViewContext, ezRenderData::Category category,
     ezRenderDataBatch::Filter filter = ezRenderDataBatch::Filter());
 
+  /// \brief Same as RenderDataWithCategory but records the batches on several threads into deferred render contexts.
+  ///
+  /// The recorded commands are executed in batch order on the render context of \a renderViewContext afterwards.
+  /// Falls back to RenderDataWithCategory if the device doesn't support multithreaded command recording, if there are too few
+  /// batches or if any of the renderers doesn't support parallel recording.
+  /// Constant buffer storages that are shared between batches, e.g. material constants, must not change while recording
+  /// or earlier batches may see the new values only in the next frame.
+  void RenderDataWithCategoryParallel(const ezRenderViewContext& renderViewContext, ezRenderData::Category category,
+    ezRenderDataBatch::Filter filter = ezRenderDataBatch::Filter());
+
+  /// \brief Records the given batches like RenderDataWithCategoryParallel, e.g. for batches that don't come from the render pipeline.
+  void RenderBatchesParallel(const ezRenderViewContext& renderViewContext, ezRenderData::Category category, const ezRenderDataBatchList& batchList);
+
   EZ_ALWAYS_INLINE ezRenderPipeline* GetPipeline() { return m_pPipeline; }
   EZ_ALWAYS_INLINE const ezRenderPipeline* GetPipeline() const { return m_pPipeline; }
 
 private:
   friend class ezRenderPipeline;
 
+  void RenderBatches(const ezRenderViewContext& renderViewContext, ezRenderData::Category category, const ezRenderDataBatchList& batchList,
+    ezUInt32 uiFirstBatch, ezUInt32 uiBatchCount);
+
   bool m_bActive;
 
   const bool m_bIsStereoAware;
@@ -15,4 +15,15 @@ public:
 
   virtual void RenderBatch(
     const ezRenderViewContext& renderViewContext, const ezRenderPipelinePass* pPass, const ezRenderDataBatch& batch) const = 0;
+
+  /// \brief Returns whether RenderBatch can be called concurrently on several threads, each with its own deferred render context.
+  ///
+  /// Renderers that keep mutable state across batches have to protect it before returning true here.
+  virtual bool SupportsParallelRecording() const { return false; }
+
+  /// \brief Called on the main thread for every batch before the batches are recorded in parallel.
+  ///
+  /// The recorded commands are executed after everything that was submitted to the given render context so far. Shared resources that
+  /// RenderBatch would otherwise update during the recording, e.g. the constants of a material, have to be updated and uploaded here.
+  virtual void PrepareParallelRecording(const ezRenderViewContext& renderViewContext, const ezRenderDataBatch& batch) const {}
 };
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <Foundation/Containers/HashTable.h>
+#include <Foundation/Math/BoundingSphere.h>
 #include <Foundation/Strings/HashedString.h>
 #include <Foundation/Threading/DelegateTask.h>
 #include <Foundation/Types/TagSet.h>
@@ -101,6 +103,43 @@ public:
   /// \brief Returns the frustum that should be used for determine visible objects for this view.
   void ComputeCullingFrustum(ezFrustum& out_Frustum) const;
 
+  /// \brief Returns the view projection matrix of the culling camera, i.e. the matrix that the culling frustum is built from.
+  void ComputeCullingViewProjectionMatrix(ezMat4& out_ViewProjectionMatrix) const;
+
+  struct OcclusionCullingStats
+  {
+    ezUInt32 m_uiNumOccluders = 0;
+    ezUInt32 m_uiNumOccluderTriangles = 0;
+    ezUInt32 m_uiNumObjectsTested = 0;
+    ezUInt32 m_uiNumObjectsOccluded = 0;
+    ezTime m_TimeTaken;
+  };
+
+  /// \brief Returns the stats of the software occlusion culling during the last extraction of this view.
+  ///
+  /// All values are zero if occlusion culling is disabled, see the cvar 'r_OcclusionCulling'.
+  const OcclusionCullingStats& GetOcclusionCullingStats() const;
+
+  /// \brief Sets a bias for the LOD selection in this view. Positive values select less detailed LODs earlier, negative values later.
+  ///
+  /// The projected screen size of an object is divided by 2^bias before it is compared against the LOD thresholds.
+  void SetLodBias(float fBias);
+  float GetLodBias() const;
+
+  /// \brief Returns the fraction of the viewport height that the given world space sphere covers, as seen from the culling camera.
+  ///
+  /// The LOD bias of the view is already applied to the result.
+  float ComputeLodScreenSize(const ezBoundingSphere& globalSphere) const;
+
+  /// \brief Returns the LOD that was selected for the given component in a previous extraction of this view or ezInvalidIndex if there is
+  /// none.
+  ezUInt32 GetPreviousLod(const ezComponentHandle& hComponent) const;
+
+  /// \brief Remembers the LOD that was selected for the given component, so that the next selection can be done with hysteresis.
+  ///
+  /// Must only be called during the extraction of this view.
+  void StoreSelectedLod(const ezComponentHandle& hComponent, ezUInt32 uiLod) const;
+
   void SetRenderPassProperty(const char* szPassName, const char* szPropertyName, const ezVariant& value);
   void SetExtractorProperty(const char* szPassName, const char* szPropertyName, const ezVariant& value);
 
@@ -119,6 +158,7 @@ public:
 
 private:
   friend class ezRenderWorld;
+  friend class ezRenderPipeline;
   friend class ezMemoryUtils;
 
   ezViewId m_InternalId;
@@ -156,6 +196,23 @@ private:
 
   ezInternal::RenderDataCache* m_pRenderDataCache;
 
+  float m_fLodBias;
+  float m_fLodScreenSizeScale;
+
+  struct LodSelection
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiLod;
+    ezUInt64 m_uiLastFrame;
+  };
+
+  void RemoveOutdatedLodSelections();
+
+  mutable ezHashTable<ezComponentHandle, LodSelection> m_LodSelections;
+
+  mutable OcclusionCullingStats m_OcclusionCullingStats;
+
   struct PropertyValue
   {
     ezString m_sObjectName;
@@ -1,12 +1,14 @@
 #include <RendererCorePCH.h>
 
 #include <Foundation/Configuration/Startup.h>
+#include <Foundation/Threading/ConditionalLock.h>
 #include <Foundation/Types/ScopeExit.h>
 #include <RendererCore/Material/MaterialResource.h>
 #include <RendererCore/Meshes/MeshBufferResource.h>
 #include <RendererCore/RenderContext/RenderContext.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
 #include <RendererCore/Shader/ShaderPermutationResource.h>
+#include <RendererCore/Shader/ShaderResource.h>
 #include <RendererCore/ShaderCompiler/ShaderManager.h>
 #include <RendererCore/Textures/Texture2DResource.h>
 #include <RendererCore/Textures/TextureCubeResource.h>
@@ -15,7 +17,9 @@
 
 ezRenderContext* ezRenderContext::s_DefaultInstance = nullptr;
 ezHybridArray<ezRenderContext*, 4> ezRenderContext::s_Instances;
+ezHybridArray<ezRenderContext*, 8> ezRenderContext::s_DeferredInstances;
 
+ezMutex ezRenderContext::s_GALVertexDeclarationsMutex;
 ezMap<ezRenderContext::ShaderVertexDecl, ezGALVertexDeclarationHandle> ezRenderContext::s_GALVertexDeclarations;
 
 ezMutex ezRenderContext::s_ConstantBufferStorageMutex;
@@ -24,6 +28,17 @@ ezMap<ezUInt32, ezDynamicArray<ezConstantBufferStorageBase*>> ezRenderContext::s
 
 ezGALSamplerStateHandle ezRenderContext::s_hDefaultSamplerStates[4];
 
+ezAtomicInteger32 ezRenderContext::s_iShaderResourceGeneration;
+
+namespace
+{
+  EZ_ALWAYS_INLINE ezUInt64 GetPermutationVariableKey(const ezHashedString& sName, const ezHashedString& sValue)
+  {
+    const ezUInt32 hashes[] = {sName.GetHash(), sValue.GetHash()};
+    return ezHashingUtils::xxHash64(hashes, sizeof(hashes));
+  }
+} // namespace
+
 // clang-format off
 EZ_BEGIN_SUBSYSTEM_DECLARATION(RendererCore, RendererContext)
 
@@ -42,10 +57,16 @@ EZ_BEGIN_SUBSYSTEM_DECLARATION(RendererCore, RendererContext)
 
   ON_HIGHLEVELSYSTEMS_STARTUP
   {
+    ezResourceManager::GetResourceEvents().AddEventHandler(&ezRenderContext::OnResourceEvent);
+    ezRenderWorld::GetRenderEvent().AddEventHandler(&ezShaderManager::OnRenderEvent);
   }
 
   ON_HIGHLEVELSYSTEMS_SHUTDOWN
   {
+    ezResourceManager::GetResourceEvents().RemoveEventHandler(&ezRenderContext::OnResourceEvent);
+    ezRenderWorld::GetRenderEvent().RemoveEventHandler(&ezShaderManager::OnRenderEvent);
+
+    ezShaderManager::OnEngineShutdown();
     ezRenderContext::OnEngineShutdown();
   }
 
@@ -62,6 +83,69 @@ ezRenderContext::Statistics::Statistics()
 void ezRenderContext::Statistics::Reset()
 {
   m_uiFailedDrawcalls = 0;
+  m_uiSkippedBindings = 0;
+  m_uiPermutationCacheHits = 0;
+  m_uiPermutationCacheMisses = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template <typename T>
+ezUInt32 ezRenderContext::BoundResourceSlots<T>::FindOrAddSlot(ezUInt32 uiNameHash)
+{
+  // The number of distinct slot names is small, a linear search over the hashes is faster than a hash table lookup.
+  const ezUInt32 uiSlotCount = m_NameHashes.GetCount();
+  for (ezUInt32 i = 0; i < uiSlotCount; ++i)
+  {
+    if (m_NameHashes[i] == uiNameHash)
+      return i;
+  }
+
+  m_NameHashes.PushBack(uiNameHash);
+  m_Values.ExpandAndGetRef() = T();
+
+  return uiSlotCount;
+}
+
+template <typename T>
+bool ezRenderContext::BoundResourceSlots<T>::SetValue(ezUInt32 uiNameHash, const T& value)
+{
+  const ezUInt32 uiSlotIndex = FindOrAddSlot(uiNameHash);
+
+  T& oldValue = m_Values[uiSlotIndex];
+  if (oldValue == value)
+    return false;
+
+  oldValue = value;
+  m_uiDirtyMask |= GetDirtyBit(uiSlotIndex);
+
+  return true;
+}
+
+template <typename T>
+bool ezRenderContext::BoundResourceSlots<T>::CopyValues(const BoundResourceSlots<T>& other)
+{
+  bool bChanged = false;
+
+  const ezUInt32 uiSlotCount = other.m_NameHashes.GetCount();
+  for (ezUInt32 i = 0; i < uiSlotCount; ++i)
+  {
+    bChanged |= SetValue(other.m_NameHashes[i], other.m_Values[i]);
+  }
+
+  return bChanged;
+}
+
+template <typename T>
+void ezRenderContext::BoundResourceSlots<T>::Reset()
+{
+  // Keep the slot names so that the slot indices in the permutation cache stay valid.
+  for (T& value : m_Values)
+  {
+    value = T();
+  }
+
+  m_uiDirtyMask = 0xFFFFFFFFFFFFFFFFull;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -84,8 +168,36 @@ void ezRenderContext::DestroyInstance(ezRenderContext* pRenderer)
   EZ_DEFAULT_DELETE(pRenderer);
 }
 
+// static
+ezRenderContext* ezRenderContext::GetDeferredInstance(ezUInt32 uiIndex)
+{
+  EZ_ASSERT_DEV(ezThreadUtils::IsMainThread(), "Deferred render contexts must be created on the main thread.");
+
+  // The first instance is always set up with the primary context, so the default instance must exist before.
+  GetDefaultInstance();
+
+  while (s_DeferredInstances.GetCount() <= uiIndex)
+  {
+    ezGALContext* pGALContext = ezGALDevice::GetDefaultDevice()->CreateDeferredContext();
+    if (pGALContext == nullptr)
+      return nullptr;
+
+    ezRenderContext* pRenderContext = CreateInstance();
+    pRenderContext->SetGALContext(pGALContext);
+    pRenderContext->m_pOwnedDeferredGALContext = pGALContext;
+
+    s_DeferredInstances.PushBack(pRenderContext);
+  }
+
+  return s_DeferredInstances[uiIndex];
+}
+
 ezRenderContext::ezRenderContext()
 {
+  m_pGALContext = nullptr;
+  m_pOwnedDeferredGALContext = nullptr;
+  m_uiGALBindingGeneration = 0;
+
   if (s_DefaultInstance == nullptr)
   {
     SetGALContext(ezGALDevice::GetDefaultDevice()->GetPrimaryContext()); // set up with the default device
@@ -99,6 +211,9 @@ ezRenderContext::ezRenderContext()
   m_uiMeshBufferPrimitiveCount = 0;
   m_DefaultTextureFilter = ezTextureFilterSetting::FixedAnisotropic4x;
   m_bAllowAsyncShaderLoading = false;
+  m_uiPermutationVariablesKey = 0;
+  m_pActivePermutation = nullptr;
+  m_iPermutationCacheGeneration = s_iShaderResourceGeneration;
 
   m_hGlobalConstantBufferStorage = CreateConstantBufferStorage<ezGlobalConstants>();
 
@@ -113,6 +228,12 @@ ezRenderContext::~ezRenderContext()
 
   DeleteConstantBufferStorage(m_hGlobalConstantBufferStorage);
 
+  if (m_pOwnedDeferredGALContext != nullptr)
+  {
+    ezGALDevice::GetDefaultDevice()->DestroyDeferredContext(m_pOwnedDeferredGALContext);
+    s_DeferredInstances.RemoveAndCopy(this);
+  }
+
   if (s_DefaultInstance == this)
     s_DefaultInstance = nullptr;
 
@@ -122,12 +243,115 @@ ezRenderContext::~ezRenderContext()
 void ezRenderContext::SetGALContext(ezGALContext* pContext)
 {
   m_pGALContext = pContext;
+
+  // the new context doesn't have any of our bindings
+  MarkAllBindingsDirty();
+}
+
+void ezRenderContext::BeginRecording(ezRenderContext& sourceContext)
+{
+  EZ_ASSERT_DEV(IsDeferred(), "Only render contexts with a deferred GAL context can record commands.");
+  EZ_ASSERT_DEV(!sourceContext.IsDeferred(), "The source context must not be deferred.");
+
+  // The recorded commands are executed after everything that was submitted to the source context so far,
+  // so pending uploads of shared constant buffers have to be submitted there first.
+  sourceContext.UploadConstants();
+
+  ResetContextState();
+
+  m_PermutationVariables = sourceContext.m_PermutationVariables;
+  m_uiPermutationVariablesKey = sourceContext.m_uiPermutationVariablesKey;
+  m_DefaultTextureFilter = sourceContext.m_DefaultTextureFilter;
+  m_bAllowAsyncShaderLoading = sourceContext.m_bAllowAsyncShaderLoading;
+
+  m_hActiveShader = sourceContext.m_hActiveShader;
+  m_ShaderBindFlags = sourceContext.m_ShaderBindFlags;
+
+  m_hNewMaterial = sourceContext.m_hNewMaterial;
+  if (m_hNewMaterial.IsValid())
+  {
+    m_StateFlags.Add(ezRenderContextFlags::MaterialBindingChanged);
+  }
+
+  // All bindings are applied on the first draw call anyway, since the state was reset.
+  m_BoundTextures2D.CopyValues(sourceContext.m_BoundTextures2D);
+  m_BoundTexturesCube.CopyValues(sourceContext.m_BoundTexturesCube);
+  m_BoundUAVs.CopyValues(sourceContext.m_BoundUAVs);
+  m_BoundSamplers.CopyValues(sourceContext.m_BoundSamplers);
+  m_BoundBuffer.CopyValues(sourceContext.m_BoundBuffer);
+  m_BoundConstantBuffers.CopyValues(sourceContext.m_BoundConstantBuffers);
+
+  // The global constants are bound with the storage of this context again in UploadConstants.
+  WriteGlobalConstants() = sourceContext.ReadGlobalConstants();
+
+  m_pGALContext->BeginRecording(*sourceContext.m_pGALContext);
+}
+
+void ezRenderContext::ExecuteDeferredInstance(ezRenderContext* pDeferredContext)
+{
+  EZ_ASSERT_DEV(pDeferredContext->IsDeferred(), "The given render context is not deferred.");
+
+  m_pGALContext->ExecuteDeferredContext(pDeferredContext->m_pGALContext);
+
+  const Statistics& deferredStatistics = pDeferredContext->m_Statistics;
+  m_Statistics.m_uiFailedDrawcalls += deferredStatistics.m_uiFailedDrawcalls;
+  m_Statistics.m_uiSkippedBindings += deferredStatistics.m_uiSkippedBindings;
+  m_Statistics.m_uiPermutationCacheHits += deferredStatistics.m_uiPermutationCacheHits;
+  m_Statistics.m_uiPermutationCacheMisses += deferredStatistics.m_uiPermutationCacheMisses;
+
+  pDeferredContext->m_Statistics.Reset();
+}
+
+void ezRenderContext::UpdateMaterialConstants(const ezMaterialResourceHandle& hMaterial)
+{
+  EZ_ASSERT_DEV(!IsDeferred(), "Material constants must be updated on the source context of the deferred render contexts.");
+
+  if (!hMaterial.IsValid())
+    return;
+
+  ezResourceLock<ezMaterialResource> pMaterial(hMaterial, ezResourceAcquireMode::AllowLoadingFallback);
+  if (!pMaterial->AreContantsModified())
+    return;
+
+  auto pCachedValues = pMaterial->GetOrUpdateCachedValues();
+  if (!pCachedValues->m_hShader.IsValid())
+    return;
+
+  ezHashTable<ezHashedString, ezHashedString> permutationVariables = m_PermutationVariables;
+  for (auto it = pCachedValues->m_PermutationVars.GetIterator(); it.IsValid(); ++it)
+  {
+    permutationVariables.Insert(it.Key(), it.Value());
+  }
+
+  ezShaderPermutationResourceHandle hShaderPermutation =
+    ezShaderManager::PreloadSinglePermutation(pCachedValues->m_hShader, permutationVariables, m_bAllowAsyncShaderLoading);
+
+  // the batches are drawn with the fallback permutation until the requested one has been compiled, see ApplyShaderState
+  if (hShaderPermutation.IsValid() && ezShaderManager::IsPermutationCompilationQueued(hShaderPermutation))
+  {
+    hShaderPermutation = ezShaderManager::PreloadFallbackPermutation(pCachedValues->m_hShader, permutationVariables, pCachedValues->m_PermutationVars);
+  }
+
+  if (!hShaderPermutation.IsValid())
+    return;
+
+  ezResourceLock<ezShaderPermutationResource> pShaderPermutation(hShaderPermutation, ezResourceAcquireMode::BlockTillLoaded);
+  if (!pShaderPermutation->IsShaderValid())
+    return;
+
+  pMaterial->UpdateConstantBuffer(pShaderPermutation.GetPointer());
+
+  ezConstantBufferStorageBase* pStorage = nullptr;
+  if (TryGetConstantBufferStorage(pMaterial->m_hConstantBufferStorage, pStorage))
+  {
+    pStorage->UploadData(m_pGALContext);
+  }
 }
 
 ezRenderContext::Statistics ezRenderContext::GetAndResetStatistics()
 {
   ezRenderContext::Statistics ret = m_Statistics;
-  ret.Reset();
+  m_Statistics.Reset();
 
   return ret;
 }
@@ -192,56 +416,26 @@ void ezRenderContext::BindTextureCube(const ezTempHashedString& sSlotName, const
 
 void ezRenderContext::BindTexture2D(const ezTempHashedString& sSlotName, ezGALResourceViewHandle hResourceView)
 {
-  ezGALResourceViewHandle* pOldResourceView = nullptr;
-  if (m_BoundTextures2D.TryGetValue(sSlotName.GetHash(), pOldResourceView))
+  if (m_BoundTextures2D.SetValue(sSlotName.GetHash(), hResourceView))
   {
-    if (*pOldResourceView == hResourceView)
-      return;
-
-    *pOldResourceView = hResourceView;
+    m_StateFlags.Add(ezRenderContextFlags::TextureBindingChanged);
   }
-  else
-  {
-    m_BoundTextures2D.Insert(sSlotName.GetHash(), hResourceView);
-  }
-
-  m_StateFlags.Add(ezRenderContextFlags::TextureBindingChanged);
 }
 
 void ezRenderContext::BindTextureCube(const ezTempHashedString& sSlotName, ezGALResourceViewHandle hResourceView)
 {
-  ezGALResourceViewHandle* pOldResourceView = nullptr;
-  if (m_BoundTexturesCube.TryGetValue(sSlotName.GetHash(), pOldResourceView))
+  if (m_BoundTexturesCube.SetValue(sSlotName.GetHash(), hResourceView))
   {
-    if (*pOldResourceView == hResourceView)
-      return;
-
-    *pOldResourceView = hResourceView;
+    m_StateFlags.Add(ezRenderContextFlags::TextureBindingChanged);
   }
-  else
-  {
-    m_BoundTexturesCube.Insert(sSlotName.GetHash(), hResourceView);
-  }
-
-  m_StateFlags.Add(ezRenderContextFlags::TextureBindingChanged);
 }
 
 void ezRenderContext::BindUAV(const ezTempHashedString& sSlotName, ezGALUnorderedAccessViewHandle hUnorderedAccessView)
 {
-  ezGALUnorderedAccessViewHandle* pOldResourceView = nullptr;
-  if (m_BoundUAVs.TryGetValue(sSlotName.GetHash(), pOldResourceView))
-  {
-    if (*pOldResourceView == hUnorderedAccessView)
-      return;
-
-    *pOldResourceView = hUnorderedAccessView;
-  }
-  else
+  if (m_BoundUAVs.SetValue(sSlotName.GetHash(), hUnorderedAccessView))
   {
-    m_BoundUAVs.Insert(sSlotName.GetHash(), hUnorderedAccessView);
+    m_StateFlags.Add(ezRenderContextFlags::UAVBindingChanged);
   }
-
-  m_StateFlags.Add(ezRenderContextFlags::UAVBindingChanged);
 }
 
 
@@ -252,76 +446,34 @@ void ezRenderContext::BindSamplerState(const ezTempHashedString& sSlotName, ezGA
   EZ_ASSERT_DEBUG(sSlotName != "PointSampler", "'PointSampler' is a resevered sampler name and must not be set manually.");
   EZ_ASSERT_DEBUG(sSlotName != "PointClampSampler", "'PointClampSampler' is a resevered sampler name and must not be set manually.");
 
-  ezGALSamplerStateHandle* pOldSamplerState = nullptr;
-  if (m_BoundSamplers.TryGetValue(sSlotName.GetHash(), pOldSamplerState))
-  {
-    if (*pOldSamplerState == hSamplerSate)
-      return;
-
-    *pOldSamplerState = hSamplerSate;
-  }
-  else
+  if (m_BoundSamplers.SetValue(sSlotName.GetHash(), hSamplerSate))
   {
-    m_BoundSamplers.Insert(sSlotName.GetHash(), hSamplerSate);
+    m_StateFlags.Add(ezRenderContextFlags::SamplerBindingChanged);
   }
-
-  m_StateFlags.Add(ezRenderContextFlags::SamplerBindingChanged);
 }
 
 void ezRenderContext::BindBuffer(const ezTempHashedString& sSlotName, ezGALResourceViewHandle hResourceView)
 {
-  ezGALResourceViewHandle* pOldResourceView = nullptr;
-  if (m_BoundBuffer.TryGetValue(sSlotName.GetHash(), pOldResourceView))
-  {
-    if (*pOldResourceView == hResourceView)
-      return;
-
-    *pOldResourceView = hResourceView;
-  }
-  else
+  if (m_BoundBuffer.SetValue(sSlotName.GetHash(), hResourceView))
   {
-    m_BoundBuffer.Insert(sSlotName.GetHash(), hResourceView);
+    m_StateFlags.Add(ezRenderContextFlags::BufferBindingChanged);
   }
-
-  m_StateFlags.Add(ezRenderContextFlags::BufferBindingChanged);
 }
 
 void ezRenderContext::BindConstantBuffer(const ezTempHashedString& sSlotName, ezGALBufferHandle hConstantBuffer)
 {
-  BoundConstantBuffer* pBoundConstantBuffer = nullptr;
-  if (m_BoundConstantBuffers.TryGetValue(sSlotName.GetHash(), pBoundConstantBuffer))
+  if (m_BoundConstantBuffers.SetValue(sSlotName.GetHash(), BoundConstantBuffer(hConstantBuffer)))
   {
-    if (pBoundConstantBuffer->m_hConstantBuffer == hConstantBuffer)
-      return;
-
-    pBoundConstantBuffer->m_hConstantBuffer = hConstantBuffer;
-    pBoundConstantBuffer->m_hConstantBufferStorage.Invalidate();
-  }
-  else
-  {
-    m_BoundConstantBuffers.Insert(sSlotName.GetHash(), BoundConstantBuffer(hConstantBuffer));
+    m_StateFlags.Add(ezRenderContextFlags::ConstantBufferBindingChanged);
   }
-
-  m_StateFlags.Add(ezRenderContextFlags::ConstantBufferBindingChanged);
 }
 
 void ezRenderContext::BindConstantBuffer(const ezTempHashedString& sSlotName, ezConstantBufferStorageHandle hConstantBufferStorage)
 {
-  BoundConstantBuffer* pBoundConstantBuffer = nullptr;
-  if (m_BoundConstantBuffers.TryGetValue(sSlotName.GetHash(), pBoundConstantBuffer))
-  {
-    if (pBoundConstantBuffer->m_hConstantBufferStorage == hConstantBufferStorage)
-      return;
-
-    pBoundConstantBuffer->m_hConstantBuffer.Invalidate();
-    pBoundConstantBuffer->m_hConstantBufferStorage = hConstantBufferStorage;
-  }
-  else
+  if (m_BoundConstantBuffers.SetValue(sSlotName.GetHash(), BoundConstantBuffer(hConstantBufferStorage)))
   {
-    m_BoundConstantBuffers.Insert(sSlotName.GetHash(), BoundConstantBuffer(hConstantBufferStorage));
+    m_StateFlags.Add(ezRenderContextFlags::ConstantBufferBindingChanged);
   }
-
-  m_StateFlags.Add(ezRenderContextFlags::ConstantBufferBindingChanged);
 }
 
 void ezRenderContext::BindShader(const ezShaderResourceHandle& hShader, ezBitflags<ezShaderBindFlags> flags)
@@ -462,8 +614,12 @@ ezResult ezRenderContext::ApplyContextStates(bool bForce)
   bool bRebuildVertexDeclaration =
     m_StateFlags.IsAnySet(ezRenderContextFlags::ShaderStateChanged | ezRenderContextFlags::MeshBufferBindingChanged);
 
+  bool bApplyAllBindings = bForce;
+
   if (bForce || m_StateFlags.IsSet(ezRenderContextFlags::ShaderStateChanged))
   {
+    const ezGALShaderHandle hPreviousGALShader = m_hActiveGALShader;
+
     pShaderPermutation = ApplyShaderState();
 
     if (pShaderPermutation == nullptr)
@@ -472,93 +628,41 @@ ezResult ezRenderContext::ApplyContextStates(bool bForce)
     }
 
     m_StateFlags.Remove(ezRenderContextFlags::ShaderStateChanged);
+
+    // A different shader might use different slots, so all of its bindings need to be applied.
+    // If only the permutation variables changed and they resolved to the same shader, only changed bindings are applied.
+    bApplyAllBindings |= (m_hActiveGALShader != hPreviousGALShader);
   }
 
-  if (m_hActiveShaderPermutation.IsValid())
+  // The GAL context unbinds resource views when their resource is bound as render target or UAV, which the dirty masks don't know about.
+  bApplyAllBindings |= (m_pGALContext->GetBindingGeneration() != m_uiGALBindingGeneration);
+
+  if (m_pActivePermutation != nullptr)
   {
-    if ((bForce || m_StateFlags.IsAnySet(ezRenderContextFlags::TextureBindingChanged | ezRenderContextFlags::UAVBindingChanged |
-                                         ezRenderContextFlags::SamplerBindingChanged | ezRenderContextFlags::BufferBindingChanged |
-                                         ezRenderContextFlags::ConstantBufferBindingChanged)))
+    if (pMaterial != nullptr)
     {
       if (pShaderPermutation == nullptr)
         pShaderPermutation = ezResourceManager::BeginAcquireResource(m_hActiveShaderPermutation, ezResourceAcquireMode::BlockTillLoaded);
-    }
-
-
-    if (bForce || m_StateFlags.IsSet(ezRenderContextFlags::UAVBindingChanged))
-    {
-      // RWTextures/UAV are usually only suppoprted in compute and pixel shader.
-      if (auto pBin = pShaderPermutation->GetShaderStageBinary(ezGALShaderStage::ComputeShader))
-      {
-        ApplyUAVBindings(pBin);
-      }
-      if (auto pBin = pShaderPermutation->GetShaderStageBinary(ezGALShaderStage::PixelShader))
-      {
-        ApplyUAVBindings(pBin);
-      }
 
-      m_StateFlags.Remove(ezRenderContextFlags::UAVBindingChanged);
-    }
-
-    if (bForce || m_StateFlags.IsSet(ezRenderContextFlags::TextureBindingChanged))
-    {
-      for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
-      {
-        if (auto pBin = pShaderPermutation->GetShaderStageBinary((ezGALShaderStage::Enum)stage))
-        {
-          ApplyTextureBindings((ezGALShaderStage::Enum)stage, pBin);
-        }
-      }
-
-      m_StateFlags.Remove(ezRenderContextFlags::TextureBindingChanged);
-    }
-
-    if (bForce || m_StateFlags.IsSet(ezRenderContextFlags::SamplerBindingChanged))
-    {
-      for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
-      {
-        if (auto pBin = pShaderPermutation->GetShaderStageBinary((ezGALShaderStage::Enum)stage))
-        {
-          ApplySamplerBindings((ezGALShaderStage::Enum)stage, pBin);
-        }
-      }
-
-      m_StateFlags.Remove(ezRenderContextFlags::SamplerBindingChanged);
-    }
-
-    if (bForce || m_StateFlags.IsSet(ezRenderContextFlags::BufferBindingChanged))
-    {
-      for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
-      {
-        if (auto pBin = pShaderPermutation->GetShaderStageBinary((ezGALShaderStage::Enum)stage))
-        {
-          ApplyBufferBindings((ezGALShaderStage::Enum)stage, pBin);
-        }
-      }
-
-      m_StateFlags.Remove(ezRenderContextFlags::BufferBindingChanged);
-    }
-
-    if (pMaterial != nullptr)
-    {
       pMaterial->UpdateConstantBuffer(pShaderPermutation);
       BindConstantBuffer("ezMaterialConstants", pMaterial->m_hConstantBufferStorage);
     }
 
     UploadConstants();
 
-    if (bForce || m_StateFlags.IsSet(ezRenderContextFlags::ConstantBufferBindingChanged))
+    const ezBitflags<ezRenderContextFlags> bindingFlags = ezRenderContextFlags::TextureBindingChanged | ezRenderContextFlags::UAVBindingChanged |
+                                                          ezRenderContextFlags::SamplerBindingChanged | ezRenderContextFlags::BufferBindingChanged |
+                                                          ezRenderContextFlags::ConstantBufferBindingChanged;
+
+    if (bApplyAllBindings || m_StateFlags.IsAnySet(bindingFlags))
     {
-      for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
-      {
-        if (auto pBin = pShaderPermutation->GetShaderStageBinary((ezGALShaderStage::Enum)stage))
-        {
-          ApplyConstantBufferBindings(pBin);
-        }
-      }
+      ApplyBindings(bApplyAllBindings);
 
-      m_StateFlags.Remove(ezRenderContextFlags::ConstantBufferBindingChanged);
+      m_StateFlags.Remove(bindingFlags);
     }
+
+    // binding our own UAVs increments the generation as well
+    m_uiGALBindingGeneration = m_pGALContext->GetBindingGeneration();
   }
 
   if (bForce || bRebuildVertexDeclaration)
@@ -603,6 +707,7 @@ void ezRenderContext::ResetContextState()
   m_hMaterial.Invalidate();
 
   m_hActiveShaderPermutation.Invalidate();
+  m_pActivePermutation = nullptr;
 
   m_hVertexBuffer.Invalidate();
   m_hIndexBuffer.Invalidate();
@@ -610,20 +715,20 @@ void ezRenderContext::ResetContextState()
   m_Topology = ezGALPrimitiveTopology::ENUM_COUNT; // Set to something invalid
   m_uiMeshBufferPrimitiveCount = 0;
 
-  m_BoundTextures2D.Clear();
-  m_BoundTexturesCube.Clear();
-  m_BoundBuffer.Clear();
+  m_BoundTextures2D.Reset();
+  m_BoundTexturesCube.Reset();
+  m_BoundBuffer.Reset();
 
-  m_BoundSamplers.Clear();
-  m_BoundSamplers.Insert(ezTempHashedString::ComputeHash("LinearSampler"), GetDefaultSamplerState(ezDefaultSamplerFlags::LinearFiltering));
-  m_BoundSamplers.Insert(ezTempHashedString::ComputeHash("LinearClampSampler"),
+  m_BoundSamplers.Reset();
+  m_BoundSamplers.SetValue(ezTempHashedString::ComputeHash("LinearSampler"), GetDefaultSamplerState(ezDefaultSamplerFlags::LinearFiltering));
+  m_BoundSamplers.SetValue(ezTempHashedString::ComputeHash("LinearClampSampler"),
     GetDefaultSamplerState(ezDefaultSamplerFlags::LinearFiltering | ezDefaultSamplerFlags::Clamp));
-  m_BoundSamplers.Insert(ezTempHashedString::ComputeHash("PointSampler"), GetDefaultSamplerState(ezDefaultSamplerFlags::PointFiltering));
-  m_BoundSamplers.Insert(ezTempHashedString::ComputeHash("PointClampSampler"),
+  m_BoundSamplers.SetValue(ezTempHashedString::ComputeHash("PointSampler"), GetDefaultSamplerState(ezDefaultSamplerFlags::PointFiltering));
+  m_BoundSamplers.SetValue(ezTempHashedString::ComputeHash("PointClampSampler"),
     GetDefaultSamplerState(ezDefaultSamplerFlags::PointFiltering | ezDefaultSamplerFlags::Clamp));
 
-  m_BoundUAVs.Clear();
-  m_BoundConstantBuffers.Clear();
+  m_BoundUAVs.Reset();
+  m_BoundConstantBuffers.Reset();
 }
 
 ezGlobalConstants& ezRenderContext::WriteGlobalConstants()
@@ -763,10 +868,14 @@ void ezRenderContext::OnEngineShutdown()
 {
   ezShaderStageBinary::OnEngineShutdown();
 
-  for (auto rc : s_Instances)
-    EZ_DEFAULT_DELETE(rc);
+  // The destructor removes the instance from s_Instances, so it can't be iterated while deleting.
+  while (!s_Instances.IsEmpty())
+  {
+    ezRenderContext* pRenderContext = s_Instances.PeekBack();
+    EZ_DEFAULT_DELETE(pRenderContext);
+  }
 
-  s_Instances.Clear();
+  EZ_ASSERT_DEBUG(s_DeferredInstances.IsEmpty(), "All deferred instances should have been deleted.");
 
   // Cleanup sampler states
   for (ezUInt32 i = 0; i < EZ_ARRAY_SIZE(s_hDefaultSamplerStates); ++i)
@@ -811,6 +920,15 @@ void ezRenderContext::OnEngineShutdown()
   }
 }
 
+// static
+void ezRenderContext::OnResourceEvent(const ezResourceEvent& e)
+{
+  if (e.m_Type == ezResourceEvent::Type::ResourceContentUpdated && e.m_pResource->IsInstanceOf<ezShaderResource>())
+  {
+    s_iShaderResourceGeneration.Increment();
+  }
+}
+
 void ezRenderContext::OnRenderEvent(const ezRenderWorldRenderEvent& e)
 {
   if (e.m_Type == ezRenderWorldRenderEvent::Type::EndRender)
@@ -827,6 +945,8 @@ ezResult ezRenderContext::BuildVertexDeclaration(
   svd.m_hShader = hShader;
   svd.m_uiVertexDeclarationHash = decl.m_uiHash;
 
+  EZ_LOCK(s_GALVertexDeclarationsMutex);
+
   bool bExisted = false;
   auto it = s_GALVertexDeclarations.FindOrAdd(svd, &bExisted);
 
@@ -886,11 +1006,13 @@ void ezRenderContext::UploadConstants()
 {
   BindConstantBuffer("ezGlobalConstants", m_hGlobalConstantBufferStorage);
 
-  for (auto it = m_BoundConstantBuffers.GetIterator(); it.IsValid(); ++it)
+  // Deferred contexts record in parallel and can share constant buffer storages, e.g. the constants of a material.
+  ezConditionalLock<ezMutex> lock(s_ConstantBufferStorageMutex, m_pGALContext->IsDeferred());
+
+  for (const BoundConstantBuffer& boundConstantBuffer : m_BoundConstantBuffers.m_Values)
   {
-    ezConstantBufferStorageHandle hConstantBufferStorage = it.Value().m_hConstantBufferStorage;
     ezConstantBufferStorageBase* pConstantBufferStorage = nullptr;
-    if (TryGetConstantBufferStorage(hConstantBufferStorage, pConstantBufferStorage))
+    if (TryGetConstantBufferStorage(boundConstantBuffer.m_hConstantBufferStorage, pConstantBufferStorage))
     {
       pConstantBufferStorage->UploadData(m_pGALContext);
     }
@@ -904,6 +1026,12 @@ void ezRenderContext::SetShaderPermutationVariableInternal(const ezHashedString&
 
   if (pOldValue == nullptr || *pOldValue != sValue)
   {
+    // The key is order independent, so it can be updated without iterating over all variables.
+    if (pOldValue != nullptr)
+      m_uiPermutationVariablesKey ^= GetPermutationVariableKey(sName, *pOldValue);
+
+    m_uiPermutationVariablesKey ^= GetPermutationVariableKey(sName, sValue);
+
     m_PermutationVariables.Insert(sName, sValue);
     m_StateFlags.Add(ezRenderContextFlags::ShaderStateChanged);
   }
@@ -918,23 +1046,56 @@ void ezRenderContext::BindShaderInternal(const ezShaderResourceHandle& hShader,
 
     m_StateFlags.Add(ezRenderContextFlags::ShaderStateChanged);
   }
+
+  // the caller might have changed GAL state behind our back, so everything has to be bound again
+  if (flags.IsAnySet(ezShaderBindFlags::ForceRebind))
+  {
+    MarkAllBindingsDirty();
+  }
 }
 
 ezShaderPermutationResource* ezRenderContext::ApplyShaderState()
 {
   m_hActiveGALShader.Invalidate();
-
-  m_StateFlags.Add(ezRenderContextFlags::TextureBindingChanged | ezRenderContextFlags::SamplerBindingChanged |
-                   ezRenderContextFlags::BufferBindingChanged | ezRenderContextFlags::ConstantBufferBindingChanged);
+  m_pActivePermutation = nullptr;
 
   if (!m_hActiveShader.IsValid())
     return nullptr;
 
-  m_hActiveShaderPermutation =
-    ezShaderManager::PreloadSinglePermutation(m_hActiveShader, m_PermutationVariables, m_bAllowAsyncShaderLoading);
+  const ezInt32 iShaderResourceGeneration = s_iShaderResourceGeneration;
+  if (m_iPermutationCacheGeneration != iShaderResourceGeneration)
+  {
+    m_PermutationCache.Clear();
+    m_iPermutationCacheGeneration = iShaderResourceGeneration;
+  }
 
-  if (!m_hActiveShaderPermutation.IsValid())
-    return nullptr;
+  const ezUInt64 uiCacheKey = m_uiPermutationVariablesKey ^ (m_hActiveShader.GetResourceIDHash() * 0x9E3779B97F4A7C15ull);
+
+  CachedPermutation* pCachedPermutation = nullptr;
+  if (m_PermutationCache.TryGetValue(uiCacheKey, pCachedPermutation) && pCachedPermutation->m_hShader == m_hActiveShader &&
+      pCachedPermutation->m_uiPermutationVariablesKey == m_uiPermutationVariablesKey)
+  {
+    m_Statistics.m_uiPermutationCacheHits++;
+  }
+  else
+  {
+    ezShaderPermutationResourceHandle hShaderPermutation =
+      ezShaderManager::PreloadSinglePermutation(m_hActiveShader, m_PermutationVariables, m_bAllowAsyncShaderLoading);
+
+    if (!hShaderPermutation.IsValid())
+      return nullptr;
+
+    m_Statistics.m_uiPermutationCacheMisses++;
+
+    pCachedPermutation = &m_PermutationCache[uiCacheKey];
+    pCachedPermutation->m_hShader = m_hActiveShader;
+    pCachedPermutation->m_uiPermutationVariablesKey = m_uiPermutationVariablesKey;
+    pCachedPermutation->m_hShaderPermutation = hShaderPermutation;
+    pCachedPermutation->m_hFallbackPermutation.Invalidate();
+    pCachedPermutation->m_hGALShader.Invalidate();
+  }
+
+  m_hActiveShaderPermutation = pCachedPermutation->m_hShaderPermutation;
 
   ezShaderPermutationResource* pShaderPermutation = ezResourceManager::BeginAcquireResource(
     m_hActiveShaderPermutation, m_bAllowAsyncShaderLoading ? ezResourceAcquireMode::AllowLoadingFallback : ezResourceAcquireMode::BlockTillLoaded);
@@ -942,12 +1103,49 @@ ezShaderPermutationResource* ezRenderContext::ApplyShaderState()
   if (!pShaderPermutation->IsShaderValid())
   {
     ezResourceManager::EndAcquireResource(pShaderPermutation);
-    return nullptr;
+    pShaderPermutation = nullptr;
+
+    // Draw with a fallback permutation of the shader until the requested one has been compiled in the background and is reloaded.
+    // Only the material variables fall back to their defaults, the pass and system variables are kept. Without a material there is
+    // nothing to substitute and the draw is skipped. The bindings are resolved again once the GAL shader changes.
+    if (ezShaderManager::IsPermutationCompilationQueued(m_hActiveShaderPermutation))
+    {
+      if (!pCachedPermutation->m_hFallbackPermutation.IsValid() && m_hMaterial.IsValid())
+      {
+        ezResourceLock<ezMaterialResource> pMaterial(m_hMaterial, ezResourceAcquireMode::AllowLoadingFallback);
+        pCachedPermutation->m_hFallbackPermutation =
+          ezShaderManager::PreloadFallbackPermutation(m_hActiveShader, m_PermutationVariables, pMaterial->GetOrUpdateCachedValues()->m_PermutationVars);
+      }
+
+      if (pCachedPermutation->m_hFallbackPermutation.IsValid() && pCachedPermutation->m_hFallbackPermutation != m_hActiveShaderPermutation)
+      {
+        m_hActiveShaderPermutation = pCachedPermutation->m_hFallbackPermutation;
+
+        pShaderPermutation = ezResourceManager::BeginAcquireResource(m_hActiveShaderPermutation, ezResourceAcquireMode::AllowLoadingFallback);
+        if (!pShaderPermutation->IsShaderValid())
+        {
+          ezResourceManager::EndAcquireResource(pShaderPermutation);
+          pShaderPermutation = nullptr;
+        }
+      }
+    }
+
+    if (pShaderPermutation == nullptr)
+      return nullptr;
   }
 
   m_hActiveGALShader = pShaderPermutation->GetGALShader();
   EZ_ASSERT_DEV(!m_hActiveGALShader.IsInvalidated(), "Invalid GAL Shader handle.");
 
+  // The bindings need to be resolved again if the permutation was reloaded or a loading fallback was used before
+  if (pCachedPermutation->m_hGALShader != m_hActiveGALShader)
+  {
+    ResolveBindings(pShaderPermutation, *pCachedPermutation);
+    pCachedPermutation->m_hGALShader = m_hActiveGALShader;
+  }
+
+  m_pActivePermutation = pCachedPermutation;
+
   m_pGALContext->SetShader(m_hActiveGALShader);
 
   // Set render state from shader
@@ -1016,114 +1214,175 @@ ezMaterialResource* ezRenderContext::ApplyMaterialState()
   return nullptr;
 }
 
-void ezRenderContext::ApplyConstantBufferBindings(const ezShaderStageBinary* pBinary)
+void ezRenderContext::ResolveBindings(const ezShaderPermutationResource* pShaderPermutation, CachedPermutation& cachedPermutation)
 {
-  for (const auto& binding : pBinary->m_ShaderResourceBindings)
+  cachedPermutation.m_Bindings.Clear();
+
+  for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
   {
-    if (binding.m_Type != ezShaderResourceBinding::ConstantBuffer)
+    const ezShaderStageBinary* pBinary = pShaderPermutation->GetShaderStageBinary((ezGALShaderStage::Enum)stage);
+    if (pBinary == nullptr)
       continue;
 
-    const ezUInt32 uiResourceHash = binding.m_sName.GetHash();
-
-    BoundConstantBuffer boundConstantBuffer;
-    if (!m_BoundConstantBuffers.TryGetValue(uiResourceHash, boundConstantBuffer))
+    for (const auto& binding : pBinary->m_ShaderResourceBindings)
     {
-      ezLog::Error("No resource is bound for constant buffer slot '{0}'", binding.m_sName);
-      m_pGALContext->SetConstantBuffer(binding.m_iSlot, ezGALBufferHandle());
-      continue;
-    }
+      const ezUInt32 uiResourceHash = binding.m_sName.GetHash();
 
-    if (!boundConstantBuffer.m_hConstantBuffer.IsInvalidated())
-    {
-      m_pGALContext->SetConstantBuffer(binding.m_iSlot, boundConstantBuffer.m_hConstantBuffer);
-    }
-    else
-    {
-      ezConstantBufferStorageBase* pConstantBufferStorage = nullptr;
-      if (TryGetConstantBufferStorage(boundConstantBuffer.m_hConstantBufferStorage, pConstantBufferStorage))
+      BindingType::Enum type;
+      ezUInt32 uiSlotIndex = 0;
+
+      // we currently only support 2D and cube textures
+      if (binding.m_Type >= ezShaderResourceBinding::Texture2D && binding.m_Type <= ezShaderResourceBinding::Texture2DMSArray)
       {
-        m_pGALContext->SetConstantBuffer(binding.m_iSlot, pConstantBufferStorage->GetGALBufferHandle());
+        type = BindingType::Texture2D;
+        uiSlotIndex = m_BoundTextures2D.FindOrAddSlot(uiResourceHash);
+      }
+      else if (binding.m_Type >= ezShaderResourceBinding::TextureCube && binding.m_Type <= ezShaderResourceBinding::TextureCubeArray)
+      {
+        type = BindingType::TextureCube;
+        uiSlotIndex = m_BoundTexturesCube.FindOrAddSlot(uiResourceHash);
+      }
+      else if (binding.m_Type >= ezShaderResourceBinding::RWTexture1D && binding.m_Type <= ezShaderResourceBinding::RWStructuredBufferWithCounter)
+      {
+        // RWTextures/UAV are usually only suppoprted in compute and pixel shader.
+        if (stage != ezGALShaderStage::ComputeShader && stage != ezGALShaderStage::PixelShader)
+          continue;
+
+        type = BindingType::UAV;
+        uiSlotIndex = m_BoundUAVs.FindOrAddSlot(uiResourceHash);
+      }
+      else if (binding.m_Type == ezShaderResourceBinding::Sampler)
+      {
+        type = BindingType::Sampler;
+        uiSlotIndex = m_BoundSamplers.FindOrAddSlot(uiResourceHash);
+      }
+      else if (binding.m_Type == ezShaderResourceBinding::GenericBuffer)
+      {
+        type = BindingType::Buffer;
+        uiSlotIndex = m_BoundBuffer.FindOrAddSlot(uiResourceHash);
+      }
+      else if (binding.m_Type == ezShaderResourceBinding::ConstantBuffer)
+      {
+        type = BindingType::ConstantBuffer;
+        uiSlotIndex = m_BoundConstantBuffers.FindOrAddSlot(uiResourceHash);
       }
       else
       {
-        ezLog::Error("Invalid constant buffer storage is bound for slot '{0}'", binding.m_sName);
-        m_pGALContext->SetConstantBuffer(binding.m_iSlot, ezGALBufferHandle());
+        continue;
       }
+
+      EZ_ASSERT_DEV(uiSlotIndex <= 0xFFFF, "Too many distinct resource slot names");
+
+      ResolvedBinding& resolvedBinding = cachedPermutation.m_Bindings.ExpandAndGetRef();
+      resolvedBinding.m_sName = binding.m_sName;
+      resolvedBinding.m_uiGALSlot = binding.m_iSlot;
+      resolvedBinding.m_uiSlotIndex = static_cast<ezUInt16>(uiSlotIndex);
+      resolvedBinding.m_Type = type;
+      resolvedBinding.m_Stage = (ezGALShaderStage::Enum)stage;
     }
   }
 }
 
-void ezRenderContext::ApplyTextureBindings(ezGALShaderStage::Enum stage, const ezShaderStageBinary* pBinary)
+void ezRenderContext::ApplyBindings(bool bApplyAll)
 {
-  for (const auto& binding : pBinary->m_ShaderResourceBindings)
-  {
-    // we currently only support 2D and cube textures
+  // in the order of BindingType
+  const ezUInt64 dirtyMasks[] = {m_BoundTextures2D.m_uiDirtyMask, m_BoundTexturesCube.m_uiDirtyMask, m_BoundUAVs.m_uiDirtyMask,
+    m_BoundSamplers.m_uiDirtyMask, m_BoundBuffer.m_uiDirtyMask, m_BoundConstantBuffers.m_uiDirtyMask};
 
-    const ezUInt32 uiResourceHash = binding.m_sName.GetHash();
-    ezGALResourceViewHandle hResourceView;
+  for (const ResolvedBinding& binding : m_pActivePermutation->m_Bindings)
+  {
+    const ezUInt32 uiSlotIndex = binding.m_uiSlotIndex;
 
-    if (binding.m_Type >= ezShaderResourceBinding::Texture2D && binding.m_Type <= ezShaderResourceBinding::Texture2DMSArray)
+    if (!bApplyAll && (dirtyMasks[binding.m_Type] & BoundResourceSlots<ezUInt32>::GetDirtyBit(uiSlotIndex)) == 0)
     {
-      m_BoundTextures2D.TryGetValue(uiResourceHash, hResourceView);
-      m_pGALContext->SetResourceView(stage, binding.m_iSlot, hResourceView);
+      m_Statistics.m_uiSkippedBindings++;
+      continue;
     }
 
-    if (binding.m_Type >= ezShaderResourceBinding::TextureCube && binding.m_Type <= ezShaderResourceBinding::TextureCubeArray)
+    switch (binding.m_Type)
     {
-      m_BoundTexturesCube.TryGetValue(uiResourceHash, hResourceView);
-      m_pGALContext->SetResourceView(stage, binding.m_iSlot, hResourceView);
-    }
-  }
-}
-
-void ezRenderContext::ApplyUAVBindings(const ezShaderStageBinary* pBinary)
-{
-  for (const auto& binding : pBinary->m_ShaderResourceBindings)
-  {
-    if (binding.m_Type < ezShaderResourceBinding::RWTexture1D || binding.m_Type > ezShaderResourceBinding::RWStructuredBufferWithCounter)
-      continue;
+      case BindingType::Texture2D:
+        m_pGALContext->SetResourceView(binding.m_Stage, binding.m_uiGALSlot, m_BoundTextures2D.m_Values[uiSlotIndex]);
+        break;
 
-    const ezUInt32 uiResourceHash = binding.m_sName.GetHash();
+      case BindingType::TextureCube:
+        m_pGALContext->SetResourceView(binding.m_Stage, binding.m_uiGALSlot, m_BoundTexturesCube.m_Values[uiSlotIndex]);
+        break;
 
-    ezGALUnorderedAccessViewHandle hResourceView;
-    m_BoundUAVs.TryGetValue(uiResourceHash, hResourceView);
+      case BindingType::UAV:
+        m_pGALContext->SetUnorderedAccessView(binding.m_uiGALSlot, m_BoundUAVs.m_Values[uiSlotIndex]);
+        break;
 
-    m_pGALContext->SetUnorderedAccessView(binding.m_iSlot, hResourceView);
-  }
-}
+      case BindingType::Sampler:
+      {
+        ezGALSamplerStateHandle hSamplerState = m_BoundSamplers.m_Values[uiSlotIndex];
+        if (hSamplerState.IsInvalidated())
+        {
+          hSamplerState = GetDefaultSamplerState(ezDefaultSamplerFlags::LinearFiltering); // Bind a default state to avoid DX11 errors.
+        }
 
-void ezRenderContext::ApplySamplerBindings(ezGALShaderStage::Enum stage, const ezShaderStageBinary* pBinary)
-{
-  for (const auto& binding : pBinary->m_ShaderResourceBindings)
-  {
-    if (binding.m_Type != ezShaderResourceBinding::Sampler)
-      continue;
+        m_pGALContext->SetSamplerState(binding.m_Stage, binding.m_uiGALSlot, hSamplerState);
+      }
+      break;
 
-    const ezUInt32 uiResourceHash = binding.m_sName.GetHash();
+      case BindingType::Buffer:
+        m_pGALContext->SetResourceView(binding.m_Stage, binding.m_uiGALSlot, m_BoundBuffer.m_Values[uiSlotIndex]);
+        break;
 
-    ezGALSamplerStateHandle hSamplerState;
-    if (!m_BoundSamplers.TryGetValue(uiResourceHash, hSamplerState))
-    {
-      hSamplerState = GetDefaultSamplerState(ezDefaultSamplerFlags::LinearFiltering); // Bind a default state to avoid DX11 errors.
+      case BindingType::ConstantBuffer:
+        ApplyConstantBufferBinding(binding);
+        break;
     }
-
-    m_pGALContext->SetSamplerState(stage, binding.m_iSlot, hSamplerState);
   }
+
+  // All bindings of the active shader are up to date now. Changes to slots that it doesn't use don't matter either,
+  // since all bindings are applied when a different shader is activated.
+  m_BoundTextures2D.m_uiDirtyMask = 0;
+  m_BoundTexturesCube.m_uiDirtyMask = 0;
+  m_BoundUAVs.m_uiDirtyMask = 0;
+  m_BoundSamplers.m_uiDirtyMask = 0;
+  m_BoundBuffer.m_uiDirtyMask = 0;
+  m_BoundConstantBuffers.m_uiDirtyMask = 0;
 }
 
-void ezRenderContext::ApplyBufferBindings(ezGALShaderStage::Enum stage, const ezShaderStageBinary* pBinary)
+void ezRenderContext::MarkAllBindingsDirty()
 {
-  for (const auto& binding : pBinary->m_ShaderResourceBindings)
-  {
-    if (binding.m_Type != ezShaderResourceBinding::GenericBuffer)
-      continue;
-
-    const ezUInt32 uiResourceHash = binding.m_sName.GetHash();
+  m_BoundTextures2D.m_uiDirtyMask = 0xFFFFFFFFFFFFFFFFull;
+  m_BoundTexturesCube.m_uiDirtyMask = 0xFFFFFFFFFFFFFFFFull;
+  m_BoundUAVs.m_uiDirtyMask = 0xFFFFFFFFFFFFFFFFull;
+  m_BoundSamplers.m_uiDirtyMask = 0xFFFFFFFFFFFFFFFFull;
+  m_BoundBuffer.m_uiDirtyMask = 0xFFFFFFFFFFFFFFFFull;
+  m_BoundConstantBuffers.m_uiDirtyMask = 0xFFFFFFFFFFFFFFFFull;
+
+  m_StateFlags.Add(ezRenderContextFlags::TextureBindingChanged | ezRenderContextFlags::UAVBindingChanged | ezRenderContextFlags::SamplerBindingChanged |
+                   ezRenderContextFlags::BufferBindingChanged | ezRenderContextFlags::ConstantBufferBindingChanged);
+}
 
-    ezGALResourceViewHandle hResourceView;
-    m_BoundBuffer.TryGetValue(uiResourceHash, hResourceView);
+void ezRenderContext::ApplyConstantBufferBinding(const ResolvedBinding& binding)
+{
+  const BoundConstantBuffer& boundConstantBuffer = m_BoundConstantBuffers.m_Values[binding.m_uiSlotIndex];
 
-    m_pGALContext->SetResourceView(stage, binding.m_iSlot, hResourceView);
+  if (!boundConstantBuffer.m_hConstantBuffer.IsInvalidated())
+  {
+    m_pGALContext->SetConstantBuffer(binding.m_uiGALSlot, boundConstantBuffer.m_hConstantBuffer);
+  }
+  else if (boundConstantBuffer.m_hConstantBufferStorage.IsInvalidated())
+  {
+    ezLog::Error("No resource is bound for constant buffer slot '{0}'", binding.m_sName);
+    m_pGALContext->SetConstantBuffer(binding.m_uiGALSlot, ezGALBufferHandle());
+  }
+  else
+  {
+    ezConstantBufferStorageBase* pConstantBufferStorage = nullptr;
+    if (TryGetConstantBufferStorage(boundConstantBuffer.m_hConstantBufferStorage, pConstantBufferStorage))
+    {
+      m_pGALContext->SetConstantBuffer(binding.m_uiGALSlot, pConstantBufferStorage->GetGALBufferHandle());
+    }
+    else
+    {
+      ezLog::Error("Invalid constant buffer storage is bound for slot '{0}'", binding.m_sName);
+      m_pGALContext->SetConstantBuffer(binding.m_uiGALSlot, ezGALBufferHandle());
+    }
   }
 }
 
@@ -28,15 +28,44 @@ private:
 
   static ezRenderContext* s_DefaultInstance;
   static ezHybridArray<ezRenderContext*, 4> s_Instances;
+  static ezHybridArray<ezRenderContext*, 8> s_DeferredInstances;
 
 public:
   static ezRenderContext* GetDefaultInstance();
   static ezRenderContext* CreateInstance();
   static void DestroyInstance(ezRenderContext* pRenderer);
 
+  /// \brief Returns the render context with the given index that records into a deferred GAL context of the default device.
+  ///
+  /// The instances are created on first use and kept until engine shutdown.
+  /// Returns nullptr if the device doesn't support multithreaded command recording. Must be called on the main thread.
+  static ezRenderContext* GetDeferredInstance(ezUInt32 uiIndex);
+
   void SetGALContext(ezGALContext* pContext);
   ezGALContext* GetGALContext() const { return m_pGALContext; }
 
+  /// \brief Returns whether this render context records into a deferred GAL context.
+  bool IsDeferred() const { return m_pGALContext != nullptr && m_pGALContext->IsDeferred(); }
+
+  /// \brief Prepares this deferred render context to record commands that continue the state of the given source context.
+  ///
+  /// Copies the permutation variables, resource bindings, global constants and the render target setup of \a sourceContext.
+  /// Pending constant buffer uploads of \a sourceContext are done first, so they are executed before the recorded commands.
+  /// Must be called on the main thread before the recording starts.
+  void BeginRecording(ezRenderContext& sourceContext);
+
+  /// \brief Executes the commands that \a pDeferredContext recorded since BeginRecording() on this render context.
+  ///
+  /// The state of this render context is not affected. The statistics of \a pDeferredContext are added to the statistics of this context.
+  void ExecuteDeferredInstance(ezRenderContext* pDeferredContext);
+
+  /// \brief Updates the constants of the given material if they were modified and uploads them with this render context.
+  ///
+  /// Deferred render contexts share the constant buffer storage of a material, so this has to be done on the source context before
+  /// recording batches that use the material in parallel. The constant buffer layout is taken from the permutation that the material's
+  /// shader uses with the current permutation variables.
+  void UpdateMaterialConstants(const ezMaterialResourceHandle& hMaterial);
+
 public:
   struct Statistics
   {
@@ -44,6 +73,13 @@ public:
     void Reset();
 
     ezUInt32 m_uiFailedDrawcalls;
+
+    /// Number of resource bindings that were not re-applied to the GAL context because they did not change since the last draw call.
+    ezUInt32 m_uiSkippedBindings;
+
+    /// Number of shader permutation lookups that were resolved from the per context permutation cache.
+    ezUInt32 m_uiPermutationCacheHits;
+    ezUInt32 m_uiPermutationCacheMisses;
   };
 
   Statistics GetAndResetStatistics();
@@ -169,9 +205,12 @@ public:
 
 private:
   EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(RendererCore, RendererContext);
+  friend class ezShaderManager;
 
   static void OnEngineShutdown();
 
+  static void OnResourceEvent(const ezResourceEvent& e);
+
   void OnRenderEvent(const ezRenderWorldRenderEvent& e);
 
 private:
@@ -182,6 +221,7 @@ private:
   ezGALShaderHandle m_hActiveGALShader;
 
   ezHashTable<ezHashedString, ezHashedString> m_PermutationVariables;
+  ezUInt64 m_uiPermutationVariablesKey;
   ezMaterialResourceHandle m_hNewMaterial;
   ezMaterialResourceHandle m_hMaterial;
 
@@ -197,11 +237,33 @@ private:
   ezEnum<ezTextureFilterSetting> m_DefaultTextureFilter;
   bool m_bAllowAsyncShaderLoading;
 
-  ezHashTable<ezUInt32, ezGALResourceViewHandle> m_BoundTextures2D;
-  ezHashTable<ezUInt32, ezGALResourceViewHandle> m_BoundTexturesCube;
-  ezHashTable<ezUInt32, ezGALUnorderedAccessViewHandle> m_BoundUAVs;
-  ezHashTable<ezUInt32, ezGALSamplerStateHandle> m_BoundSamplers;
-  ezHashTable<ezUInt32, ezGALResourceViewHandle> m_BoundBuffer;
+  /// \brief Bound resources of one kind, indexed by a slot index that is assigned the first time a slot name is seen.
+  ///
+  /// Slot names are never removed, so slot indices stay valid for the lifetime of the render context.
+  /// Every slot whose value changed since the bindings were last applied has its bit set in the dirty mask.
+  /// Slot indices above 63 share the last bit.
+  template <typename T>
+  struct BoundResourceSlots
+  {
+    ezUInt32 FindOrAddSlot(ezUInt32 uiNameHash);
+    bool SetValue(ezUInt32 uiNameHash, const T& value);
+    void Reset();
+
+    /// \brief Sets all bound values of \a other. Returns whether any value changed.
+    bool CopyValues(const BoundResourceSlots<T>& other);
+
+    EZ_ALWAYS_INLINE static ezUInt64 GetDirtyBit(ezUInt32 uiSlotIndex) { return EZ_BIT(ezMath::Min(uiSlotIndex, 63u)); }
+
+    ezHybridArray<ezUInt32, 16> m_NameHashes;
+    ezHybridArray<T, 16> m_Values;
+    ezUInt64 m_uiDirtyMask = 0;
+  };
+
+  BoundResourceSlots<ezGALResourceViewHandle> m_BoundTextures2D;
+  BoundResourceSlots<ezGALResourceViewHandle> m_BoundTexturesCube;
+  BoundResourceSlots<ezGALUnorderedAccessViewHandle> m_BoundUAVs;
+  BoundResourceSlots<ezGALSamplerStateHandle> m_BoundSamplers;
+  BoundResourceSlots<ezGALResourceViewHandle> m_BoundBuffer;
 
   struct BoundConstantBuffer
   {
@@ -213,11 +275,61 @@ private:
     BoundConstantBuffer(ezConstantBufferStorageHandle hConstantBufferStorage)
       : m_hConstantBufferStorage(hConstantBufferStorage) {}
 
+    EZ_ALWAYS_INLINE bool operator==(const BoundConstantBuffer& rhs) const
+    {
+      return m_hConstantBuffer == rhs.m_hConstantBuffer && m_hConstantBufferStorage == rhs.m_hConstantBufferStorage;
+    }
+
+    EZ_ALWAYS_INLINE bool operator!=(const BoundConstantBuffer& rhs) const { return !(*this == rhs); }
+
     ezGALBufferHandle m_hConstantBuffer;
     ezConstantBufferStorageHandle m_hConstantBufferStorage;
   };
 
-  ezHashTable<ezUInt32, BoundConstantBuffer> m_BoundConstantBuffers;
+  BoundResourceSlots<BoundConstantBuffer> m_BoundConstantBuffers;
+
+  struct BindingType
+  {
+    enum Enum : ezUInt8
+    {
+      Texture2D,
+      TextureCube,
+      UAV,
+      Sampler,
+      Buffer,
+      ConstantBuffer
+    };
+  };
+
+  /// \brief A resource binding of a shader permutation, resolved to the slot index of the corresponding BoundResourceSlots.
+  struct ResolvedBinding
+  {
+    ezHashedString m_sName;
+    ezUInt32 m_uiGALSlot;
+    ezUInt16 m_uiSlotIndex;
+    BindingType::Enum m_Type;
+    ezGALShaderStage::Enum m_Stage;
+  };
+
+  /// \brief Caches the permutation that a combination of shader and permutation variables resolves to,
+  /// together with its bindings resolved to slot indices.
+  struct CachedPermutation
+  {
+    ezShaderResourceHandle m_hShader;
+    ezUInt64 m_uiPermutationVariablesKey; ///< Together with m_hShader this detects collisions of the cache key.
+    ezShaderPermutationResourceHandle m_hShaderPermutation;
+    ezShaderPermutationResourceHandle m_hFallbackPermutation; ///< Used while m_hShaderPermutation is compiled in the background.
+    ezGALShaderHandle m_hGALShader; ///< The GAL shader that m_Bindings were resolved for.
+    ezHybridArray<ResolvedBinding, 16> m_Bindings;
+  };
+
+  ezHashTable<ezUInt64, CachedPermutation> m_PermutationCache;
+  CachedPermutation* m_pActivePermutation;
+  ezInt32 m_iPermutationCacheGeneration;
+
+  /// Incremented whenever a shader resource is reloaded, since that can change which permutation a set of variables resolves to.
+  /// Also incremented when permutation recording starts, so that cached permutations are requested and recorded again.
+  static ezAtomicInteger32 s_iShaderResourceGeneration;
 
   ezConstantBufferStorageHandle m_hGlobalConstantBufferStorage;
 
@@ -243,6 +355,7 @@ private:
 
   static ezResult BuildVertexDeclaration(ezGALShaderHandle hShader, const ezVertexDeclarationInfo& decl, ezGALVertexDeclarationHandle& out_Declaration);
 
+  static ezMutex s_GALVertexDeclarationsMutex;
   static ezMap<ShaderVertexDecl, ezGALVertexDeclarationHandle> s_GALVertexDeclarations;
 
   static ezMutex s_ConstantBufferStorageMutex;
@@ -253,6 +366,8 @@ private:
 
 private: // Per Renderer States
   ezGALContext* m_pGALContext;
+  ezGALContext* m_pOwnedDeferredGALContext; ///< The deferred context that was created for this instance by GetDeferredInstance().
+  ezUInt32 m_uiGALBindingGeneration;         ///< The binding generation of the GAL context when the bindings were applied the last time.
 
   // Member Functions
   void UploadConstants();
@@ -261,10 +376,9 @@ private: // Per Renderer States
   void BindShaderInternal(const ezShaderResourceHandle& hShader, ezBitflags<ezShaderBindFlags> flags);
   ezShaderPermutationResource* ApplyShaderState();
   ezMaterialResource* ApplyMaterialState();
-  void ApplyConstantBufferBindings(const ezShaderStageBinary* pBinary);
-  void ApplyTextureBindings(ezGALShaderStage::Enum stage, const ezShaderStageBinary* pBinary);
-  void ApplyUAVBindings(const ezShaderStageBinary* pBinary);
-  void ApplySamplerBindings(ezGALShaderStage::Enum stage, const ezShaderStageBinary* pBinary);
-  void ApplyBufferBindings(ezGALShaderStage::Enum stage, const ezShaderStageBinary* pBinary);
+  void ResolveBindings(const ezShaderPermutationResource* pShaderPermutation, CachedPermutation& cachedPermutation);
+  void ApplyBindings(bool bApplyAll);
+  void MarkAllBindingsDirty();
+  void ApplyConstantBufferBinding(const ResolvedBinding& binding);
 };
 
@@ -3,6 +3,7 @@
 #include <Foundation/Configuration/CVar.h>
 #include <Foundation/Configuration/Startup.h>
 #include <Foundation/Memory/CommonAllocators.h>
+#include <Foundation/Utilities/Stats.h>
 #include <RendererCore/Pipeline/RenderPipeline.h>
 #include <RendererCore/Pipeline/View.h>
 #include <RendererCore/RenderWorld/RenderWorld.h>
@@ -53,9 +54,38 @@ namespace
   static ezDynamicArray<PipelineToRebuild> s_PipelinesToRebuild;
 
   static ezProxyAllocator* s_pCacheAllocator;
-  typedef ezHybridArray<const ezRenderData*, 4> CachedRenderDataPerComponent;
+
+  struct CachedRenderDataPerComponent
+  {
+    ezUInt32 m_uiGeneration = 0;
+    ezHybridArray<const ezRenderData*, 4> m_RenderData;
+  };
+
   static ezHashTable<ezComponentHandle, CachedRenderDataPerComponent> s_CachedRenderData;
   static ezDynamicArray<const ezRenderData*> s_DeletedRenderData;
+  static ezUInt32 s_uiNextRenderDataCacheId = 0;
+
+  // Cache generation per game object instance index. Invalidating the cache of an object only increments its generation, which turns
+  // all cached entries of that object stale in every view at once. The instance index is not unique across worlds, so an invalidation
+  // might cause an unnecessary cache miss for an object in another world, but never a wrong hit.
+  static ezMutex s_CacheInvalidationMutex;
+  static ezDynamicArray<ezUInt32> s_CacheGenerationPerObject;
+
+  struct PendingCacheInvalidation
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezGameObjectHandle m_hOwnerObject;
+    ezComponentHandle m_hOwnerComponent;
+  };
+
+  // The actual deletion of the cached render data is batched and done in BeginFrame
+  static ezDynamicArray<PendingCacheInvalidation> s_PendingCacheInvalidations;
+
+  EZ_ALWAYS_INLINE ezUInt32 GetCacheGeneration(ezUInt32 uiCacheIndex)
+  {
+    return uiCacheIndex < s_CacheGenerationPerObject.GetCount() ? s_CacheGenerationPerObject[uiCacheIndex] : 0;
+  }
 
   enum
   {
@@ -68,7 +98,7 @@ namespace ezInternal
   struct RenderDataCache
   {
     RenderDataCache(ezAllocatorBase* pAllocator)
-      : m_EntriesPerObject(pAllocator)
+      : m_Slots(pAllocator)
     {
       m_NewEntriesPerComponent.SetCount(m_NewEntriesPerComponent.GetCapacity());
       for (auto& newEntry : m_NewEntriesPerComponent)
@@ -79,17 +109,30 @@ namespace ezInternal
 
     typedef ezHybridArray<RenderDataCacheEntry, 4> CacheEntriesPerObject;
 
-    ezDynamicArray<CacheEntriesPerObject> m_EntriesPerObject;
+    /// One slot per game object instance index. A slot is only valid for the object and cache generation it was filled for,
+    /// so stale slots never have to be cleared explicitly and lookups don't need any lock.
+    struct ObjectSlot
+    {
+      ezGameObjectId m_OwnerId;
+      ezUInt32 m_uiGeneration = 0;
+      CacheEntriesPerObject m_CacheEntries;
+    };
+
+    ezDynamicArray<ObjectSlot> m_Slots;
 
     struct NewEntryPerComponent
     {
       ezGameObjectHandle m_hOwnerObject;
       ezComponentHandle m_hOwnerComponent;
+      ezUInt32 m_uiGeneration;
       CacheEntriesPerObject m_CacheEntries;
     };
 
     ezStaticArray<NewEntryPerComponent, MaxNumNewCacheEntries> m_NewEntriesPerComponent;
     ezAtomicInteger32 m_NewEntriesCount;
+
+    ezAtomicInteger32 m_NumCacheHits;
+    ezAtomicInteger32 m_NumCacheMisses;
   };
 
 #if EZ_ENABLED(EZ_PLATFORM_64BIT)
@@ -245,6 +288,7 @@ void ezRenderWorld::CacheRenderData(const ezView& view, const ezGameObjectHandle
       auto& newEntry = view.m_pRenderDataCache->m_NewEntriesPerComponent[uiNewEntriesCount - 1];
       newEntry.m_hOwnerObject = hOwnerObject;
       newEntry.m_hOwnerComponent = hOwnerComponent;
+      newEntry.m_uiGeneration = GetCacheGeneration(hOwnerObject.GetInternalID().m_InstanceIndex);
       newEntry.m_CacheEntries = cacheEntries;
     }
   }
@@ -260,55 +304,44 @@ void ezRenderWorld::DeleteAllCachedRenderData()
     for (auto it = s_Views.GetIterator(); it.IsValid(); ++it)
     {
       ezView* pView = it.Value();
-      pView->m_pRenderDataCache->m_EntriesPerObject.Clear();
+      pView->m_pRenderDataCache->m_Slots.Clear();
     }
   }
 
   for (auto it = s_CachedRenderData.GetIterator(); it.IsValid(); ++it)
   {
-    auto& cachedRenderDataPerComponent = it.Value();
-
-    for (auto pCachedRenderData : cachedRenderDataPerComponent)
+    for (auto pCachedRenderData : it.Value().m_RenderData)
     {
       s_DeletedRenderData.PushBack(pCachedRenderData);
     }
-
-    cachedRenderDataPerComponent.Clear();
   }
+
+  s_CachedRenderData.Clear();
+
+  EZ_LOCK(s_CacheInvalidationMutex);
+  s_PendingCacheInvalidations.Clear();
 }
 
 void ezRenderWorld::DeleteCachedRenderData(const ezGameObjectHandle& hOwnerObject, const ezComponentHandle& hOwnerComponent)
 {
   EZ_ASSERT_DEV(!s_bInExtract, "Cannot delete cached render data during extraction");
 
-  ezUInt32 uiCacheIndex = hOwnerObject.GetInternalID().m_InstanceIndex;
-
-  for (auto it = s_Views.GetIterator(); it.IsValid(); ++it)
-  {
-    ezView* pView = it.Value();
-    auto& entriesPerObject = pView->m_pRenderDataCache->m_EntriesPerObject;
+  const ezUInt32 uiCacheIndex = hOwnerObject.GetInternalID().m_InstanceIndex;
 
-    if (uiCacheIndex < entriesPerObject.GetCount())
-    {
-      entriesPerObject[uiCacheIndex].Clear();
-    }
-  }
+  EZ_LOCK(s_CacheInvalidationMutex);
 
-  CachedRenderDataPerComponent* pCachedRenderDataPerComponent = nullptr;
-  if (s_CachedRenderData.TryGetValue(hOwnerComponent, pCachedRenderDataPerComponent))
-  {
-    for (auto pCachedRenderData : *pCachedRenderDataPerComponent)
-    {
-      s_DeletedRenderData.PushBack(pCachedRenderData);
-    }
+  // makes the cached entries of this object stale in all views, the cached render data itself is deleted in the next BeginFrame
+  s_CacheGenerationPerObject.EnsureCount(uiCacheIndex + 1);
+  ++s_CacheGenerationPerObject[uiCacheIndex];
 
-    s_CachedRenderData.Remove(hOwnerComponent);
-  }
+  auto& pendingInvalidation = s_PendingCacheInvalidations.ExpandAndGetRef();
+  pendingInvalidation.m_hOwnerObject = hOwnerObject;
+  pendingInvalidation.m_hOwnerComponent = hOwnerComponent;
 }
 
 void ezRenderWorld::DeleteCachedRenderData(ezView& view)
 {
-  view.m_pRenderDataCache->m_EntriesPerObject.Clear();
+  view.m_pRenderDataCache->m_Slots.Clear();
   view.m_pRenderDataCache->m_NewEntriesCount = 0;
 }
 
@@ -330,12 +363,19 @@ ezArrayPtr<ezInternal::RenderDataCacheEntry> ezRenderWorld::GetCachedRenderData(
 {
   if (CVarCacheRenderData)
   {
-    auto& entriesPerObject = view.m_pRenderDataCache->m_EntriesPerObject;
-    ezUInt32 uiCacheIndex = hOwner.GetInternalID().m_InstanceIndex;
-    if (uiCacheIndex < entriesPerObject.GetCount())
+    auto pCache = view.m_pRenderDataCache;
+    const ezUInt32 uiCacheIndex = hOwner.GetInternalID().m_InstanceIndex;
+    if (uiCacheIndex < pCache->m_Slots.GetCount())
     {
-      return entriesPerObject[uiCacheIndex];
+      auto& slot = pCache->m_Slots[uiCacheIndex];
+      if (slot.m_OwnerId == hOwner.GetInternalID() && slot.m_uiGeneration == GetCacheGeneration(uiCacheIndex))
+      {
+        pCache->m_NumCacheHits.Increment();
+        return slot.m_CacheEntries;
+      }
     }
+
+    pCache->m_NumCacheMisses.Increment();
   }
 
   return ezArrayPtr<ezInternal::RenderDataCacheEntry>();
@@ -521,6 +561,9 @@ void ezRenderWorld::BeginFrame()
     pView->EnsureUpToDate();
   }
 
+  ApplyRenderDataCacheInvalidations();
+  UpdateRenderDataCacheStats();
+
   RebuildPipelines();
 }
 
@@ -569,6 +612,58 @@ void ezRenderWorld::ClearRenderDataCache()
   s_DeletedRenderData.Clear();
 }
 
+void ezRenderWorld::ApplyRenderDataCacheInvalidations()
+{
+  EZ_PROFILE_SCOPE("Apply Render Data Cache Invalidations");
+
+  EZ_LOCK(s_CacheInvalidationMutex);
+
+  for (const auto& pendingInvalidation : s_PendingCacheInvalidations)
+  {
+    CachedRenderDataPerComponent* pCachedRenderDataPerComponent = nullptr;
+    if (!s_CachedRenderData.TryGetValue(pendingInvalidation.m_hOwnerComponent, pCachedRenderDataPerComponent))
+      continue;
+
+    // the component might have been cached again in the meantime
+    const ezUInt32 uiCacheIndex = pendingInvalidation.m_hOwnerObject.GetInternalID().m_InstanceIndex;
+    if (pCachedRenderDataPerComponent->m_uiGeneration == GetCacheGeneration(uiCacheIndex))
+      continue;
+
+    for (auto pCachedRenderData : pCachedRenderDataPerComponent->m_RenderData)
+    {
+      s_DeletedRenderData.PushBack(pCachedRenderData);
+    }
+
+    s_CachedRenderData.Remove(pendingInvalidation.m_hOwnerComponent);
+  }
+
+  s_PendingCacheInvalidations.Clear();
+}
+
+void ezRenderWorld::UpdateRenderDataCacheStats()
+{
+  ezStringBuilder sStatName;
+
+  for (auto it = s_Views.GetIterator(); it.IsValid(); ++it)
+  {
+    ezView* pView = it.Value();
+    auto pCache = pView->m_pRenderDataCache;
+
+    const ezInt32 iNumHits = pCache->m_NumCacheHits.Set(0);
+    const ezInt32 iNumMisses = pCache->m_NumCacheMisses.Set(0);
+    const ezInt32 iNumLookups = iNumHits + iNumMisses;
+
+    if (iNumLookups == 0)
+      continue;
+
+    sStatName.Format("Render Data Cache/{0}/Hit Rate", pView->GetName());
+    ezStats::SetStat(sStatName, 100.0f * iNumHits / iNumLookups);
+
+    sStatName.Format("Render Data Cache/{0}/Misses", pView->GetName());
+    ezStats::SetStat(sStatName, iNumMisses);
+  }
+}
+
 void ezRenderWorld::UpdateRenderDataCache()
 {
   EZ_PROFILE_SCOPE("Update Render Data Cache");
@@ -579,22 +674,40 @@ void ezRenderWorld::UpdateRenderDataCache()
     ezUInt32 uiNumNewEntries = ezMath::Min<ezInt32>(pView->m_pRenderDataCache->m_NewEntriesCount, MaxNumNewCacheEntries);
     pView->m_pRenderDataCache->m_NewEntriesCount = 0;
 
-    auto& entriesPerObject = pView->m_pRenderDataCache->m_EntriesPerObject;
+    auto& slots = pView->m_pRenderDataCache->m_Slots;
 
     for (ezUInt32 uiNewEntryIndex = 0; uiNewEntryIndex < uiNumNewEntries; ++uiNewEntryIndex)
     {
       auto& newEntries = pView->m_pRenderDataCache->m_NewEntriesPerComponent[uiNewEntryIndex];
       EZ_ASSERT_DEV(!newEntries.m_hOwnerObject.IsInvalidated(), "Implementation error");
 
-      // find or create cached render data
-      auto& cachedRenderDataPerComponent = s_CachedRenderData[newEntries.m_hOwnerComponent];
+      // the object has been invalidated after it was extracted, the extracted data might be outdated already
+      const ezUInt32 uiCacheIndex = newEntries.m_hOwnerObject.GetInternalID().m_InstanceIndex;
+      if (newEntries.m_uiGeneration != GetCacheGeneration(uiCacheIndex))
+        continue;
 
-      const ezUInt32 uiNumCachedRenderData = cachedRenderDataPerComponent.GetCount();
-      if (uiNumCachedRenderData == 0) // Nothing cached yet
+      // find or create cached render data
+      CachedRenderDataPerComponent* pCachedRenderDataPerComponent = nullptr;
+      if (!s_CachedRenderData.TryGetValue(newEntries.m_hOwnerComponent, pCachedRenderDataPerComponent))
+      {
+        pCachedRenderDataPerComponent = &s_CachedRenderData[newEntries.m_hOwnerComponent];
+        pCachedRenderDataPerComponent->m_uiGeneration = newEntries.m_uiGeneration;
+        pCachedRenderDataPerComponent->m_RenderData = ezHybridArray<const ezRenderData*, 4>(s_pCacheAllocator);
+      }
+      else if (pCachedRenderDataPerComponent->m_uiGeneration != newEntries.m_uiGeneration)
       {
-        cachedRenderDataPerComponent = CachedRenderDataPerComponent(s_pCacheAllocator);
+        // cached for an older generation of the object, the pending invalidation hasn't been applied yet
+        for (auto pCachedRenderData : pCachedRenderDataPerComponent->m_RenderData)
+        {
+          s_DeletedRenderData.PushBack(pCachedRenderData);
+        }
+
+        pCachedRenderDataPerComponent->m_RenderData.Clear();
+        pCachedRenderDataPerComponent->m_uiGeneration = newEntries.m_uiGeneration;
       }
 
+      auto& cachedRenderDataPerComponent = pCachedRenderDataPerComponent->m_RenderData;
+
       ezUInt32 uiCachedRenderDataIndex = 0;
       for (auto& newEntry : newEntries.m_CacheEntries)
       {
@@ -603,7 +716,11 @@ void ezRenderWorld::UpdateRenderDataCache()
           if (uiCachedRenderDataIndex >= cachedRenderDataPerComponent.GetCount())
           {
             const ezRTTI* pRtti = newEntry.m_pRenderData->GetDynamicRTTI();
-            newEntry.m_pRenderData = pRtti->GetAllocator()->Clone<ezRenderData>(newEntry.m_pRenderData, s_pCacheAllocator);
+            ezRenderData* pCachedRenderData = pRtti->GetAllocator()->Clone<ezRenderData>(newEntry.m_pRenderData, s_pCacheAllocator);
+
+            // 0 is reserved for render data that isn't cached
+            pCachedRenderData->m_uiCacheId = ezMath::Max(++s_uiNextRenderDataCacheId, 1u);
+            newEntry.m_pRenderData = pCachedRenderData;
 
             cachedRenderDataPerComponent.PushBack(newEntry.m_pRenderData);
           }
@@ -618,10 +735,18 @@ void ezRenderWorld::UpdateRenderDataCache()
       }
 
       // add entry for this view
-      const ezUInt32 uiCacheIndex = newEntries.m_hOwnerObject.GetInternalID().m_InstanceIndex;
-      entriesPerObject.EnsureCount(uiCacheIndex + 1);
+      slots.EnsureCount(uiCacheIndex + 1);
 
-      auto& cacheEntries = entriesPerObject[uiCacheIndex];
+      auto& slot = slots[uiCacheIndex];
+      if (slot.m_OwnerId != newEntries.m_hOwnerObject.GetInternalID() || slot.m_uiGeneration != newEntries.m_uiGeneration)
+      {
+        // stale slot of a deleted or invalidated object
+        slot.m_OwnerId = newEntries.m_hOwnerObject.GetInternalID();
+        slot.m_uiGeneration = newEntries.m_uiGeneration;
+        slot.m_CacheEntries.Clear();
+      }
+
+      auto& cacheEntries = slot.m_CacheEntries;
 
       for (auto& newEntry : newEntries.m_CacheEntries)
       {
@@ -682,6 +807,11 @@ void ezRenderWorld::OnEngineShutdown()
 {
   ClearRenderDataCache();
 
+  s_CacheGenerationPerObject.Clear();
+  s_CacheGenerationPerObject.Compact();
+  s_PendingCacheInvalidations.Clear();
+  s_PendingCacheInvalidations.Compact();
+
   EZ_DEFAULT_DELETE(s_pCacheAllocator);
 
   s_FilteredRenderPipelines[0].Clear();
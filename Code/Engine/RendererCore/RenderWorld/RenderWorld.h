@@ -54,6 +54,9 @@ public:
     ezArrayPtr<ezInternal::RenderDataCacheEntry> cacheEntries);
 
   static void DeleteAllCachedRenderData();
+
+  /// \brief Invalidates the cached render data of the given object in all views. The object is extracted again from now on,
+  /// the memory of the old render data is released in the next BeginFrame().
   static void DeleteCachedRenderData(const ezGameObjectHandle& hOwnerObject, const ezComponentHandle& hOwnerComponent);
   static void DeleteCachedRenderDataRecursive(const ezGameObject* pOwnerObject);
   static void DeleteCachedRenderData(ezView& view);
@@ -113,6 +116,8 @@ private:
 
   static void ClearRenderDataCache();
   static void UpdateRenderDataCache();
+  static void ApplyRenderDataCacheInvalidations();
+  static void UpdateRenderDataCacheStats();
 
   static void AddRenderPipelineToRebuild(ezRenderPipeline* pRenderPipeline, const ezViewHandle& hView);
   static void RebuildPipelines();
@@ -7,7 +7,9 @@ EZ_STATICLINK_LIBRARY(RendererCore)
 
   EZ_STATICLINK_REFERENCE(RendererCore_AnimationSystem_AnimationGraph_Implementation_AnimationClipSampler);
   EZ_STATICLINK_REFERENCE(RendererCore_AnimationSystem_AnimationGraph_Implementation_AnimationGraphNode);
+  EZ_STATICLINK_REFERENCE(RendererCore_AnimationSystem_Implementation_AnimationClipCompression);
   EZ_STATICLINK_REFERENCE(RendererCore_AnimationSystem_Implementation_AnimationClipResource);
+  EZ_STATICLINK_REFERENCE(RendererCore_AnimationSystem_Implementation_AnimationLocalPose);
   EZ_STATICLINK_REFERENCE(RendererCore_AnimationSystem_Implementation_AnimationPose);
   EZ_STATICLINK_REFERENCE(RendererCore_AnimationSystem_Implementation_EditableSkeleton);
   EZ_STATICLINK_REFERENCE(RendererCore_AnimationSystem_Implementation_JointMapping);
@@ -18,6 +20,7 @@ EZ_STATICLINK_LIBRARY(RendererCore)
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_AlwaysVisibleComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_CameraComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_FogComponent);
+  EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_OccluderComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_RenderComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_RenderTargetActivatorComponent);
   EZ_STATICLINK_REFERENCE(RendererCore_Components_Implementation_SkyBoxComponent);
@@ -57,6 +60,7 @@ EZ_STATICLINK_LIBRARY(RendererCore)
   EZ_STATICLINK_REFERENCE(RendererCore_Pipeline_Implementation_Extractor);
   EZ_STATICLINK_REFERENCE(RendererCore_Pipeline_Implementation_FrameDataProvider);
   EZ_STATICLINK_REFERENCE(RendererCore_Pipeline_Implementation_InstanceDataProvider);
+  EZ_STATICLINK_REFERENCE(RendererCore_Pipeline_Implementation_OcclusionBuffer);
   EZ_STATICLINK_REFERENCE(RendererCore_Pipeline_Implementation_Passes_AOPass);
   EZ_STATICLINK_REFERENCE(RendererCore_Pipeline_Implementation_Passes_AntialiasingPass);
   EZ_STATICLINK_REFERENCE(RendererCore_Pipeline_Implementation_Passes_BloomPass);
@@ -3,7 +3,6 @@
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/OSFile.h>
 #include <RendererCore/Shader/ShaderPermutationResource.h>
-#include <RendererCore/ShaderCompiler/ShaderCompiler.h>
 #include <RendererCore/ShaderCompiler/ShaderManager.h>
 #include <RendererFoundation/Device/Device.h>
 #include <RendererFoundation/Shader/Shader.h>
@@ -81,7 +80,16 @@ ezResourceLoadDesc ezShaderPermutationResource::UpdateContent(ezStreamReader* St
 
   if (Stream == nullptr)
   {
-    ezLog::Error("Shader Permutation '{0}': Data is not available", GetResourceID());
+    if (ezShaderManager::IsPermutationCompilationQueued(ezShaderPermutationResourceHandle(this)))
+    {
+      // the render context draws with the default permutation until the background compilation is done and the resource gets reloaded
+      ezLog::Debug("Shader Permutation '{0}': Waiting for background compilation", GetResourceID());
+    }
+    else
+    {
+      ezLog::Error("Shader Permutation '{0}': Data is not available", GetResourceID());
+    }
+
     return res;
   }
 
@@ -184,6 +192,18 @@ struct ShaderPermutationResourceLoadData
   ezMemoryStreamReader m_Reader;
 };
 
+void ezShaderPermutationResourceLoader::GetShaderFile(const ezResource* pResource, ezStringBuilder& out_sShaderFile)
+{
+  out_sShaderFile = pResource->GetResourceID();
+
+  out_sShaderFile.ChangeFileExtension("");
+  out_sShaderFile.Shrink(
+      ezShaderManager::GetCacheDirectory().GetCharacterCount() + ezShaderManager::GetActivePlatform().GetCharacterCount() + 2, 1);
+
+  out_sShaderFile.Shrink(0, 9); // remove underscore and the hash at the end
+  out_sShaderFile.Append(".ezShader");
+}
+
 ezResult ezShaderPermutationResourceLoader::RunCompiler(const ezResource* pResource, ezShaderPermutationBinary& BinaryInfo, bool bForce)
 {
   if (ezShaderManager::IsRuntimeCompilationEnabled())
@@ -200,20 +220,12 @@ ezResult ezShaderPermutationResourceLoader::RunCompiler(const ezResource* pResou
     if (!bForce) // no recompilation necessary
       return EZ_SUCCESS;
 
-    ezStringBuilder sPermutationFile = pResource->GetResourceID();
-
-    sPermutationFile.ChangeFileExtension("");
-    sPermutationFile.Shrink(
-        ezShaderManager::GetCacheDirectory().GetCharacterCount() + ezShaderManager::GetActivePlatform().GetCharacterCount() + 2, 1);
-
-    sPermutationFile.Shrink(0, 9); // remove underscore and the hash at the end
-    sPermutationFile.Append(".ezShader");
+    ezStringBuilder sPermutationFile;
+    GetShaderFile(pResource, sPermutationFile);
 
     ezArrayPtr<const ezPermutationVar> permutationVars = static_cast<const ezShaderPermutationResource*>(pResource)->GetPermutationVars();
 
-    ezShaderCompiler sc;
-    return sc.CompileShaderPermutationForPlatforms(sPermutationFile, permutationVars, ezLog::GetThreadLocalLogSystem(),
-                                                   ezShaderManager::GetActivePlatform());
+    return ezShaderManager::CompilePermutation(sPermutationFile, permutationVars);
   }
   else
   {
@@ -269,6 +281,22 @@ ezResourceLoadData ezShaderPermutationResourceLoader::OpenDataStream(const ezRes
     {
       ezLog::Debug("Shader Permutation '{0}' does not exist, triggering recompile.", pResource->GetResourceID());
 
+      // compile in the background instead of stalling the loading thread, the resource is reloaded once the compilation is done
+      {
+        const ezShaderPermutationResource* pPermutation = static_cast<const ezShaderPermutationResource*>(pResource);
+
+        ezStringBuilder sShaderFile;
+        GetShaderFile(pResource, sShaderFile);
+
+        if (ezShaderManager::QueuePermutationCompilation(
+              ezShaderPermutationResourceHandle(const_cast<ezShaderPermutationResource*>(pPermutation)), sShaderFile,
+              pPermutation->GetPermutationVars()))
+        {
+          ezLog::Debug("Shader Permutation '{0}' was queued for background compilation.", pResource->GetResourceID());
+          return res;
+        }
+      }
+
       bNeedsCompilation = false;
       if (RunCompiler(pResource, permutationBinary, true).Failed())
         return res;
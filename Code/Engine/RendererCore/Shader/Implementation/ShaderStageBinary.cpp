@@ -1,7 +1,7 @@
 #include <RendererCorePCH.h>
 
+#include <Foundation/IO/FileSystem/DeferredFileWriter.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
-#include <Foundation/IO/FileSystem/FileWriter.h>
 #include <RendererCore/Shader/ShaderStageBinary.h>
 #include <RendererCore/Shader/Types.h>
 #include <RendererCore/ShaderCompiler/ShaderManager.h>
@@ -168,6 +168,7 @@ ezShaderResourceBinding::~ezShaderResourceBinding() {}
 
 //////////////////////////////////////////////////////////////////////////
 
+ezMutex ezShaderStageBinary::s_ShaderStageBinariesMutex;
 ezMap<ezUInt32, ezShaderStageBinary> ezShaderStageBinary::s_ShaderStageBinaries[ezGALShaderStage::ENUM_COUNT];
 
 ezShaderStageBinary::ezShaderStageBinary()
@@ -345,16 +346,19 @@ ezResult ezShaderStageBinary::WriteStageBinary(ezLogInterface* pLog) const
   sShaderStageFile.AppendPath(ezShaderManager::GetActivePlatform().GetData());
   sShaderStageFile.AppendFormat("/{0}_{1}.ezShaderStage", ezGALShaderStage::Names[m_Stage], ezArgU(m_uiSourceHash, 8, true, 16, true));
 
-  ezFileWriter StageFileOut;
-  if (StageFileOut.Open(sShaderStageFile.GetData()).Failed())
+  // the file is written in one go when it is closed, so that other compilers running in parallel don't read a partially written file
+  ezDeferredFileWriter StageFileOut;
+  StageFileOut.SetOutput(sShaderStageFile.GetData());
+
+  if (Write(StageFileOut).Failed())
   {
-    ezLog::Error(pLog, "Could not open shader stage file '{0}' for writing", sShaderStageFile);
+    ezLog::Error(pLog, "Could not write shader stage file '{0}'", sShaderStageFile);
     return EZ_FAILURE;
   }
 
-  if (Write(StageFileOut).Failed())
+  if (StageFileOut.Close().Failed())
   {
-    ezLog::Error(pLog, "Could not write shader stage file '{0}'", sShaderStageFile);
+    ezLog::Error(pLog, "Could not open shader stage file '{0}' for writing", sShaderStageFile);
     return EZ_FAILURE;
   }
 
@@ -364,6 +368,9 @@ ezResult ezShaderStageBinary::WriteStageBinary(ezLogInterface* pLog) const
 // static
 ezShaderStageBinary* ezShaderStageBinary::LoadStageBinary(ezGALShaderStage::Enum Stage, ezUInt32 uiHash)
 {
+  // the shader compiler can run on several threads at the same time as the resource loading
+  EZ_LOCK(s_ShaderStageBinariesMutex);
+
   auto itStage = s_ShaderStageBinaries[Stage].Find(uiHash);
 
   if (!itStage.IsValid())
@@ -408,6 +415,8 @@ ezShaderStageBinary* ezShaderStageBinary::LoadStageBinary(ezGALShaderStage::Enum
 // static
 void ezShaderStageBinary::OnEngineShutdown()
 {
+  EZ_LOCK(s_ShaderStageBinariesMutex);
+
   for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
   {
     s_ShaderStageBinaries[stage].Clear();
@@ -65,6 +65,7 @@ public:
   virtual bool IsResourceOutdated(const ezResource* pResource) const override;
 
 private:
+  static void GetShaderFile(const ezResource* pResource, ezStringBuilder& out_sShaderFile);
   ezResult RunCompiler(const ezResource* pResource, ezShaderPermutationBinary& BinaryInfo, bool bForce);
 };
 
@@ -6,6 +6,7 @@
 #include <Foundation/Containers/Map.h>
 #include <Foundation/IO/Stream.h>
 #include <Foundation/Strings/HashedString.h>
+#include <Foundation/Threading/Mutex.h>
 #include <Foundation/Types/Enum.h>
 
 class EZ_RENDERERCORE_DLL ezShaderConstantBufferLayout : public ezRefCounted
@@ -163,6 +164,7 @@ private:
 
   static void OnEngineShutdown();
 
+  static ezMutex s_ShaderStageBinariesMutex;
   static ezMap<ezUInt32, ezShaderStageBinary> s_ShaderStageBinaries[ezGALShaderStage::ENUM_COUNT];
 };
 
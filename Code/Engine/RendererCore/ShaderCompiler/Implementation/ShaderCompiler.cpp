@@ -3,6 +3,8 @@
 #include <Foundation/IO/FileSystem/DeferredFileWriter.h>
 #include <Foundation/IO/FileSystem/FileReader.h>
 #include <Foundation/IO/OSFile.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <RendererCore/ShaderCompiler/ShaderCompiler.h>
 #include <RendererCore/ShaderCompiler/ShaderManager.h>
 #include <RendererCore/ShaderCompiler/ShaderParser.h>
@@ -97,13 +99,53 @@ namespace
 
   static const char* s_szStageDefines[ezGALShaderStage::ENUM_COUNT] = {"VERTEX_SHADER",   "HULL_SHADER",  "DOMAIN_SHADER",
                                                                        "GEOMETRY_SHADER", "PIXEL_SHADER", "COMPUTE_SHADER"};
+
+  // Shared by all compilers in the process, so that include files are only tokenized once.
+  // Cached files are checked against their current timestamp whenever they are located, see ezShaderCompiler::FileLocator.
+  static ezTokenizedFileCache s_FileCache;
+
+  // the shader sections are not actual files, so they are stamped with the hash of their content instead
+  static ezTimestamp GetSectionTimestamp(const ezString& sContent)
+  {
+    const ezUInt64 uiHash = ezHashingUtils::xxHash64(sContent.GetData(), sContent.GetElementCount());
+    return ezTimestamp(static_cast<ezInt64>(uiHash >> 1), ezSIUnitOfTime::Microsecond);
+  }
+}
+
+ezShaderCompiler::ezShaderCompiler()
+{
+  m_pWrittenStageBinaries = nullptr;
+}
+
+// static
+void ezShaderCompiler::ClearFileCache()
+{
+  s_FileCache.Clear();
+}
+
+bool ezShaderCompiler::ClaimStageBinaryForWriting(ezUInt32 uiStage, ezUInt32 uiSourceHash)
+{
+  if (m_pWrittenStageBinaries == nullptr)
+    return true;
+
+  // permutations often share identical stages, e.g. the vertex shader does not depend on a pixel shader permutation variable
+  const ezUInt64 uiKey = (static_cast<ezUInt64>(uiStage) << 32) | uiSourceHash;
+
+  EZ_LOCK(m_pWrittenStageBinaries->m_Mutex);
+
+  if (m_pWrittenStageBinaries->m_Keys.Contains(uiKey))
+    return false;
+
+  m_pWrittenStageBinaries->m_Keys.Insert(uiKey);
+  return true;
 }
 
 ezResult ezShaderCompiler::FileOpen(const char* szAbsoluteFile, ezDynamicArray<ezUInt8>& FileContent, ezTimestamp& out_FileModification)
 {
-  if (ezStringUtils::IsEqual(szAbsoluteFile, "ShaderRenderState"))
+  if (m_StateSourceFile == szAbsoluteFile)
   {
     const ezString& sData = m_ShaderData.m_StateSource;
+    out_FileModification = GetSectionTimestamp(sData);
     const ezUInt32 uiCount = sData.GetElementCount();
     const char* szString = sData.GetData();
 
@@ -122,6 +164,7 @@ ezResult ezShaderCompiler::FileOpen(const char* szAbsoluteFile, ezDynamicArray<e
     if (m_StageSourceFile[stage] == szAbsoluteFile)
     {
       const ezString& sData = m_ShaderData.m_ShaderStageSource[stage];
+      out_FileModification = GetSectionTimestamp(sData);
       const ezUInt32 uiCount = sData.GetElementCount();
       const char* szString = sData.GetData();
 
@@ -136,8 +179,6 @@ ezResult ezShaderCompiler::FileOpen(const char* szAbsoluteFile, ezDynamicArray<e
     }
   }
 
-  m_IncludeFiles.Insert(szAbsoluteFile);
-
   ezFileReader r;
   if (r.Open(szAbsoluteFile).Failed())
   {
@@ -163,6 +204,51 @@ ezResult ezShaderCompiler::FileOpen(const char* szAbsoluteFile, ezDynamicArray<e
   return EZ_SUCCESS;
 }
 
+ezResult ezShaderCompiler::FileLocator(const char* szCurAbsoluteFile, const char* szIncludeFile, ezPreprocessor::IncludeType IncType,
+                                       ezStringBuilder& out_sAbsoluteFilePath)
+{
+  EZ_SUCCEED_OR_RETURN(ezPreprocessor::DefaultFileLocator(szCurAbsoluteFile, szIncludeFile, IncType, out_sAbsoluteFilePath));
+
+  // make sure the shared file cache doesn't return the content of a file that has changed since it was tokenized
+  ezTimestamp currentTimestamp;
+
+  if (m_StateSourceFile == out_sAbsoluteFilePath)
+  {
+    currentTimestamp = GetSectionTimestamp(m_ShaderData.m_StateSource);
+  }
+  else
+  {
+    bool bIsStageSource = false;
+    for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
+    {
+      if (m_StageSourceFile[stage] == out_sAbsoluteFilePath)
+      {
+        currentTimestamp = GetSectionTimestamp(m_ShaderData.m_ShaderStageSource[stage]);
+        bIsStageSource = true;
+        break;
+      }
+    }
+
+    if (!bIsStageSource)
+    {
+      // includes are tracked here and not in FileOpen, since files that are already in the file cache are not opened again
+      m_IncludeFiles.Insert(out_sAbsoluteFilePath);
+
+#if EZ_ENABLED(EZ_SUPPORTS_FILE_STATS)
+      ezFileStats stats;
+      if (ezFileSystem::GetFileStats(out_sAbsoluteFilePath, stats).Succeeded())
+      {
+        currentTimestamp = stats.m_LastModificationTime;
+      }
+#endif
+    }
+  }
+
+  s_FileCache.RemoveOutdated(out_sAbsoluteFilePath, currentTimestamp);
+
+  return EZ_SUCCESS;
+}
+
 ezResult ezShaderCompiler::CompileShaderPermutationForPlatforms(const char* szFile,
                                                                 const ezArrayPtr<const ezPermutationVar>& permutationVars,
                                                                 ezLogInterface* pLog, const char* szPlatform)
@@ -249,6 +335,10 @@ ezResult ezShaderCompiler::CompileShaderPermutationForPlatforms(const char* szFi
   ezStringBuilder tmp = szFile;
   tmp.MakeCleanPath();
 
+  // the sections of different shaders need unique names, since they end up in the shared file cache
+  m_StateSourceFile = tmp;
+  m_StateSourceFile.ChangeFileExtension("ShaderRenderState");
+
   m_StageSourceFile[ezGALShaderStage::VertexShader] = tmp;
   m_StageSourceFile[ezGALShaderStage::VertexShader].ChangeFileExtension("vs");
 
@@ -289,6 +379,43 @@ ezResult ezShaderCompiler::CompileShaderPermutationForPlatforms(const char* szFi
   return EZ_SUCCESS;
 }
 
+// static
+ezResult ezShaderCompiler::CompileShaderPermutationsForPlatforms(const char* szFile, const ezPermutationGenerator& permutationGenerator,
+                                                                 const char* szPlatform)
+{
+  WrittenStageBinaries writtenStageBinaries;
+  ezAtomicInteger32 iNumFailed;
+
+  ezTaskSystem::ParallelForParams params;
+  params.uiMaxTasksPerThread = 4; // permutations can take vastly different amounts of time
+
+  ezTaskSystem::ParallelForIndexed(0, permutationGenerator.GetPermutationCount(),
+    [&](ezUInt32 uiStartPermutation, ezUInt32 uiEndPermutation) {
+      ezHybridArray<ezPermutationVar, 16> permutationVars;
+
+      for (ezUInt32 uiPermutation = uiStartPermutation; uiPermutation < uiEndPermutation; ++uiPermutation)
+      {
+        if (iNumFailed > 0)
+          return;
+
+        EZ_LOG_BLOCK("Compiling Permutation");
+
+        permutationGenerator.GetPermutation(uiPermutation, permutationVars);
+
+        ezShaderCompiler sc;
+        sc.m_pWrittenStageBinaries = &writtenStageBinaries;
+
+        if (sc.CompileShaderPermutationForPlatforms(szFile, permutationVars, ezLog::GetThreadLocalLogSystem(), szPlatform).Failed())
+        {
+          iNumFailed.Increment();
+        }
+      }
+    },
+    "Shader Permutation Compilation", params);
+
+  return iNumFailed > 0 ? EZ_FAILURE : EZ_SUCCESS;
+}
+
 ezResult ezShaderCompiler::RunShaderCompiler(const char* szFile, const char* szPlatform, ezShaderProgramCompiler* pCompiler,
                                              ezLogInterface* pLog)
 {
@@ -336,9 +463,10 @@ ezResult ezShaderCompiler::RunShaderCompiler(const char* szFile, const char* szP
       EZ_LOG_BLOCK(pLog, "Preprocessing Shader State Source");
 
       ezPreprocessor pp;
-      pp.SetCustomFileCache(&m_FileCache);
+      pp.SetCustomFileCache(&s_FileCache);
       pp.SetLogInterface(ezLog::GetThreadLocalLogSystem());
       pp.SetFileOpenFunction(ezPreprocessor::FileOpenCB(&ezShaderCompiler::FileOpen, this));
+      pp.SetFileLocatorFunction(ezPreprocessor::FileLocatorCB(&ezShaderCompiler::FileLocator, this));
       pp.SetPassThroughPragma(false);
       pp.SetPassThroughLine(false);
 
@@ -359,7 +487,7 @@ ezResult ezShaderCompiler::RunShaderCompiler(const char* szFile, const char* szP
       });
 
       ezStringBuilder sOutput;
-      if (pp.Process("ShaderRenderState", sOutput, false).Failed() || bFoundUndefinedVars)
+      if (pp.Process(m_StateSourceFile, sOutput, false).Failed() || bFoundUndefinedVars)
       {
         ezLog::Error(pLog, "Preprocessing the Shader State block failed");
         return EZ_FAILURE;
@@ -385,9 +513,10 @@ ezResult ezShaderCompiler::RunShaderCompiler(const char* szFile, const char* szP
       bool bFoundUndefinedVars = false;
 
       ezPreprocessor pp;
-      pp.SetCustomFileCache(&m_FileCache);
+      pp.SetCustomFileCache(&s_FileCache);
       pp.SetLogInterface(ezLog::GetThreadLocalLogSystem());
       pp.SetFileOpenFunction(ezPreprocessor::FileOpenCB(&ezShaderCompiler::FileOpen, this));
+      pp.SetFileLocatorFunction(ezPreprocessor::FileLocatorCB(&ezShaderCompiler::FileLocator, this));
       pp.SetPassThroughPragma(true);
       pp.SetPassThroughUnknownCmdsCB(ezMakeDelegate(&ezShaderCompiler::PassThroughUnknownCommandCB, this));
       pp.SetPassThroughLine(false);
@@ -456,6 +585,9 @@ ezResult ezShaderCompiler::RunShaderCompiler(const char* szFile, const char* szP
     {
       if (spd.m_StageBinary[stage].m_uiSourceHash != 0 && spd.m_bWriteToDisk[stage])
       {
+        if (!ClaimStageBinaryForWriting(stage, spd.m_StageBinary[stage].m_uiSourceHash))
+          continue;
+
         if (spd.m_StageBinary[stage].WriteStageBinary(pLog).Failed())
         {
           ezLog::Error(pLog, "Writing stage {0} binary failed", stage);
@@ -1,12 +1,26 @@
 #include <RendererCorePCH.h>
 
 #include <Foundation/CodeUtils/Preprocessor.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
+#include <Foundation/IO/OpenDdlReader.h>
+#include <Foundation/IO/OpenDdlUtils.h>
+#include <Foundation/IO/OpenDdlWriter.h>
+#include <Foundation/Threading/DelegateTask.h>
+#include <Foundation/Utilities/Stats.h>
+#include <RendererCore/RenderContext/RenderContext.h>
+#include <RendererCore/RenderWorld/RenderWorld.h>
 #include <RendererCore/Shader/Implementation/Helper.h>
 #include <RendererCore/Shader/ShaderPermutationResource.h>
 #include <RendererCore/Shader/ShaderResource.h>
+#include <RendererCore/ShaderCompiler/ShaderCompiler.h>
 #include <RendererCore/ShaderCompiler/ShaderManager.h>
 #include <RendererCore/ShaderCompiler/ShaderParser.h>
 
+ezCVarBool CVarAsyncShaderCompilation("r_AsyncShaderCompilation", false, ezCVarFlags::Default,
+  "Compile missing shader permutations on a background task instead of blocking until they are available");
+
 bool ezShaderManager::s_bEnableRuntimeCompilation = false;
 ezString ezShaderManager::s_sPlatform;
 ezString ezShaderManager::s_sPermVarSubDir;
@@ -105,7 +119,34 @@ namespace
     return false;
   }
 
+  static ezMutex s_PermutationPathsMutex;
   static ezHashTable<ezUInt64, ezString> s_PermutationPaths;
+
+  struct RecordedPermutation
+  {
+    ezString m_sShaderFile;
+    ezHybridArray<ezPermutationVar, 16> m_PermutationVars;
+  };
+
+  // protected by s_PermutationPathsMutex
+  static bool s_bRecordPermutations = false;
+  static ezHashTable<ezUInt64, RecordedPermutation> s_RecordedPermutations;
+
+  struct QueuedCompilation
+  {
+    ezShaderPermutationResourceHandle m_hPermutation;
+    ezString m_sShaderFile;
+    ezHybridArray<ezPermutationVar, 16> m_PermutationVars;
+  };
+
+  static ezMutex s_CompilerMutex;
+
+  static ezMutex s_CompileQueueMutex;
+  static ezDeque<QueuedCompilation> s_CompileQueue;
+  static ezDynamicArray<ezShaderPermutationResourceHandle> s_CompiledPermutations;
+  static ezTaskGroupID s_CompileTaskGroup;
+  static bool s_bCompileTaskRunning = false;
+  static ezUInt32 s_uiHitchesAvoided = 0;
 } // namespace
 
 //////////////////////////////////////////////////////////////////////////
@@ -302,6 +343,23 @@ ezShaderPermutationResourceHandle ezShaderManager::PreloadSinglePermutation(ezSh
   return PreloadSinglePermutationInternal(pShader->GetResourceID(), pShader->GetResourceIDHash(), uiPermutationHash, filteredPermutationVariables);
 }
 
+ezShaderPermutationResourceHandle ezShaderManager::PreloadFallbackPermutation(ezShaderResourceHandle hShader,
+  const ezHashTable<ezHashedString, ezHashedString>& permVars, const ezHashTable<ezHashedString, ezHashedString>& replaceableVars)
+{
+  const ezTempHashedString sBlendMode("BLEND_MODE");
+  const ezTempHashedString sTwoSided("TWO_SIDED");
+
+  ezHashTable<ezHashedString, ezHashedString> fallbackPermVars = permVars;
+  for (auto it = replaceableVars.GetIterator(); it.IsValid(); ++it)
+  {
+    if (it.Key() == sBlendMode || it.Key() == sTwoSided)
+      continue;
+
+    fallbackPermVars.Remove(it.Key());
+  }
+
+  return PreloadSinglePermutation(hShader, fallbackPermVars, true);
+}
 
 ezUInt32 ezShaderManager::FilterPermutationVars(ezArrayPtr<const ezHashedString> usedVars, const ezHashTable<ezHashedString, ezHashedString>& permVars,
   ezDynamicArray<ezPermutationVar>& out_FilteredPermutationVariables)
@@ -340,22 +398,37 @@ ezShaderPermutationResourceHandle ezShaderManager::PreloadSinglePermutationInter
 {
   const ezUInt64 uiPermutationKey = (ezUInt64)uiResourceIdHash << 32 | uiPermutationHash;
 
-  ezString* pPermutationPath = &s_PermutationPaths[uiPermutationKey];
-  if (pPermutationPath->IsEmpty())
+  // Copy the path, the table can be modified by render contexts that record on other threads.
+  ezStringBuilder sPermutationPath;
   {
-    ezStringBuilder sShaderFile = GetCacheDirectory();
-    sShaderFile.AppendPath(GetActivePlatform().GetData());
-    sShaderFile.AppendPath(szResourceId);
-    sShaderFile.ChangeFileExtension("");
-    if (sShaderFile.EndsWith("."))
-      sShaderFile.Shrink(0, 1);
-    sShaderFile.AppendFormat("_{0}.ezPermutation", ezArgU(uiPermutationHash, 8, true, 16, true));
+    EZ_LOCK(s_PermutationPathsMutex);
+
+    ezString& sCachedPath = s_PermutationPaths[uiPermutationKey];
+    if (sCachedPath.IsEmpty())
+    {
+      ezStringBuilder sShaderFile = GetCacheDirectory();
+      sShaderFile.AppendPath(GetActivePlatform().GetData());
+      sShaderFile.AppendPath(szResourceId);
+      sShaderFile.ChangeFileExtension("");
+      if (sShaderFile.EndsWith("."))
+        sShaderFile.Shrink(0, 1);
+      sShaderFile.AppendFormat("_{0}.ezPermutation", ezArgU(uiPermutationHash, 8, true, 16, true));
+
+      sCachedPath = sShaderFile;
+    }
 
-    *pPermutationPath = sShaderFile;
+    sPermutationPath = sCachedPath;
+
+    if (s_bRecordPermutations && !s_RecordedPermutations.Contains(uiPermutationKey))
+    {
+      RecordedPermutation& recordedPermutation = s_RecordedPermutations[uiPermutationKey];
+      recordedPermutation.m_sShaderFile = szResourceId;
+      recordedPermutation.m_PermutationVars = filteredPermutationVariables;
+    }
   }
 
   ezShaderPermutationResourceHandle hShaderPermutation =
-    ezResourceManager::LoadResource<ezShaderPermutationResource>(pPermutationPath->GetData());
+    ezResourceManager::LoadResource<ezShaderPermutationResource>(sPermutationPath);
 
   {
     ezResourceLock<ezShaderPermutationResource> pShaderPermutation(hShaderPermutation, ezResourceAcquireMode::PointerOnly);
@@ -370,4 +443,289 @@ ezShaderPermutationResourceHandle ezShaderManager::PreloadSinglePermutationInter
   return hShaderPermutation;
 }
 
+void ezShaderManager::StartPermutationRecording()
+{
+  EZ_LOCK(s_PermutationPathsMutex);
+
+  s_RecordedPermutations.Clear();
+  s_bRecordPermutations = true;
+
+  // render contexts only request permutations that are not in their cache yet
+  ezRenderContext::s_iShaderResourceGeneration.Increment();
+}
+
+void ezShaderManager::StopPermutationRecording()
+{
+  EZ_LOCK(s_PermutationPathsMutex);
+
+  s_bRecordPermutations = false;
+}
+
+ezResult ezShaderManager::SavePermutationManifest(const char* szFile)
+{
+  ezFileWriter file;
+  if (file.Open(szFile).Failed())
+  {
+    ezLog::Error("Could not write shader permutation manifest '{0}'", szFile);
+    return EZ_FAILURE;
+  }
+
+  ezOpenDdlWriter writer;
+  writer.SetOutputStream(&file);
+  writer.SetCompactMode(false);
+  writer.SetPrimitiveTypeStringMode(ezOpenDdlWriter::TypeStringMode::Compliant);
+
+  EZ_LOCK(s_PermutationPathsMutex);
+
+  for (auto it = s_RecordedPermutations.GetIterator(); it.IsValid(); ++it)
+  {
+    const RecordedPermutation& recordedPermutation = it.Value();
+
+    writer.BeginObject("Permutation");
+
+    ezOpenDdlUtils::StoreString(writer, recordedPermutation.m_sShaderFile, "Shader");
+
+    // names and values alternate
+    writer.BeginPrimitiveList(ezOpenDdlPrimitiveType::String, "Vars");
+    for (const ezPermutationVar& var : recordedPermutation.m_PermutationVars)
+    {
+      writer.WriteString(var.m_sName.GetView());
+      writer.WriteString(var.m_sValue.GetView());
+    }
+    writer.EndPrimitiveList();
+
+    writer.EndObject();
+  }
+
+  ezLog::Dev("Saved {0} shader permutations to '{1}'", s_RecordedPermutations.GetCount(), szFile);
+  return EZ_SUCCESS;
+}
+
+ezUInt32 ezShaderManager::PreloadPermutationManifest(const char* szFile)
+{
+  EZ_LOG_BLOCK("PreloadPermutationManifest", szFile);
+
+  ezFileReader file;
+  if (file.Open(szFile).Failed())
+  {
+    ezLog::Warning("Could not open shader permutation manifest '{0}'", szFile);
+    return 0;
+  }
+
+  ezOpenDdlReader reader;
+  if (reader.ParseDocument(file, 0, ezLog::GetThreadLocalLogSystem()).Failed())
+  {
+    ezLog::Error("Failed to parse shader permutation manifest '{0}'", szFile);
+    return 0;
+  }
+
+  ezUInt32 uiNumPreloaded = 0;
+  ezHashTable<ezHashedString, ezHashedString> permVars;
+
+  for (const ezOpenDdlReaderElement* pPermutation = reader.GetRootElement()->GetFirstChild(); pPermutation != nullptr;
+       pPermutation = pPermutation->GetSibling())
+  {
+    if (!pPermutation->IsCustomType("Permutation"))
+      continue;
+
+    const ezOpenDdlReaderElement* pShader = pPermutation->FindChildOfType(ezOpenDdlPrimitiveType::String, "Shader");
+    const ezOpenDdlReaderElement* pVars = pPermutation->FindChildOfType(ezOpenDdlPrimitiveType::String, "Vars", 0);
+    if (pShader == nullptr)
+      continue;
+
+    permVars.Clear();
+
+    if (pVars != nullptr)
+    {
+      const ezStringView* pValues = pVars->GetPrimitivesString();
+      for (ezUInt32 i = 0; i + 1 < pVars->GetNumPrimitives(); i += 2)
+      {
+        ezStringBuilder sTemp;
+        ezHashedString sName;
+        ezHashedString sValue;
+        sTemp = pValues[i];
+        sName.Assign(sTemp.GetData());
+        sTemp = pValues[i + 1];
+        sValue.Assign(sTemp.GetData());
+
+        permVars.Insert(sName, sValue);
+      }
+    }
+
+    ezShaderResourceHandle hShader = ezResourceManager::LoadResource<ezShaderResource>(ezString(pShader->GetPrimitivesString()[0]));
+
+    if (PreloadSinglePermutation(hShader, permVars, false).IsValid())
+    {
+      ++uiNumPreloaded;
+    }
+  }
+
+  ezLog::Dev("Preloading {0} shader permutations", uiNumPreloaded);
+  return uiNumPreloaded;
+}
+
+ezShaderManager::AsyncCompilationStats ezShaderManager::GetAsyncCompilationStats()
+{
+  EZ_LOCK(s_CompileQueueMutex);
+
+  AsyncCompilationStats stats;
+  stats.m_uiQueueDepth = s_CompileQueue.GetCount();
+  stats.m_uiHitchesAvoided = s_uiHitchesAvoided;
+  return stats;
+}
+
+ezResult ezShaderManager::CompilePermutation(const char* szShaderFile, ezArrayPtr<const ezPermutationVar> permutationVars)
+{
+  EZ_LOCK(s_CompilerMutex);
+
+  ezShaderCompiler sc;
+  return sc.CompileShaderPermutationForPlatforms(szShaderFile, permutationVars, ezLog::GetThreadLocalLogSystem(), GetActivePlatform());
+}
+
+bool ezShaderManager::QueuePermutationCompilation(const ezShaderPermutationResourceHandle& hPermutation, const char* szShaderFile,
+  ezArrayPtr<const ezPermutationVar> permutationVars)
+{
+  if (!CVarAsyncShaderCompilation || !IsRuntimeCompilationEnabled())
+    return false;
+
+  EZ_LOCK(s_CompileQueueMutex);
+
+  if (!IsPermutationCompilationQueued(hPermutation))
+  {
+    QueuedCompilation& compilation = s_CompileQueue.ExpandAndGetRef();
+    compilation.m_hPermutation = hPermutation;
+    compilation.m_sShaderFile = szShaderFile;
+    compilation.m_PermutationVars = permutationVars;
+
+    ++s_uiHitchesAvoided;
+  }
+
+  if (!s_bCompileTaskRunning)
+  {
+    // a single task works through the queue, compilations are serialized anyway
+    ezDelegateTask<void>* pTask =
+      EZ_DEFAULT_NEW(ezDelegateTask<void>, "Shader Permutation Compilation", &ezShaderManager::CompileQueuedPermutations);
+    pTask->SetOnTaskFinished([](ezTask* pTask) { EZ_DEFAULT_DELETE(pTask); });
+
+    s_bCompileTaskRunning = true;
+    s_CompileTaskGroup = ezTaskSystem::StartSingleTask(pTask, ezTaskPriority::LongRunning);
+  }
+
+  return true;
+}
+
+bool ezShaderManager::IsPermutationCompilationQueued(const ezShaderPermutationResourceHandle& hPermutation)
+{
+  EZ_LOCK(s_CompileQueueMutex);
+
+  for (const QueuedCompilation& compilation : s_CompileQueue)
+  {
+    if (compilation.m_hPermutation == hPermutation)
+      return true;
+  }
+
+  return s_CompiledPermutations.Contains(hPermutation);
+}
+
+// static
+void ezShaderManager::CompileQueuedPermutations()
+{
+  while (true)
+  {
+    ezStringBuilder sShaderFile;
+    ezHybridArray<ezPermutationVar, 16> permutationVars;
+
+    {
+      EZ_LOCK(s_CompileQueueMutex);
+
+      if (s_CompileQueue.IsEmpty())
+      {
+        s_bCompileTaskRunning = false;
+        return;
+      }
+
+      // keep the entry in the queue while compiling, so that the permutation isn't queued again in the mean time
+      sShaderFile = s_CompileQueue.PeekFront().m_sShaderFile;
+      permutationVars = s_CompileQueue.PeekFront().m_PermutationVars;
+    }
+
+    const bool bSuccess = CompilePermutation(sShaderFile, permutationVars).Succeeded();
+    if (!bSuccess)
+    {
+      ezLog::Error("Failed to compile a permutation of shader '{0}' in the background", sShaderFile);
+    }
+
+    {
+      EZ_LOCK(s_CompileQueueMutex);
+
+      // The resource is reloaded on the main thread, since it might be in use right now.
+      // Failed permutations are not reloaded, otherwise they would be queued again right away.
+      if (bSuccess)
+      {
+        s_CompiledPermutations.PushBack(s_CompileQueue.PeekFront().m_hPermutation);
+      }
+
+      s_CompileQueue.PopFront();
+    }
+  }
+}
+
+// static
+void ezShaderManager::OnRenderEvent(const ezRenderWorldRenderEvent& e)
+{
+  if (e.m_Type != ezRenderWorldRenderEvent::Type::BeginRender)
+    return;
+
+  ezHybridArray<ezShaderPermutationResourceHandle, 16> compiledPermutations;
+  AsyncCompilationStats stats;
+
+  {
+    EZ_LOCK(s_CompileQueueMutex);
+
+    compiledPermutations = s_CompiledPermutations;
+    s_CompiledPermutations.Clear();
+
+    stats.m_uiQueueDepth = s_CompileQueue.GetCount();
+    stats.m_uiHitchesAvoided = s_uiHitchesAvoided;
+  }
+
+  for (const ezShaderPermutationResourceHandle& hPermutation : compiledPermutations)
+  {
+    ezResourceManager::ReloadResource(hPermutation, true);
+    ezResourceManager::PreloadResource(hPermutation);
+  }
+
+  if (stats.m_uiHitchesAvoided > 0)
+  {
+    ezStats::SetStat("Shaders/Compile Queue Depth", stats.m_uiQueueDepth);
+    ezStats::SetStat("Shaders/Hitches Avoided", stats.m_uiHitchesAvoided);
+  }
+}
+
+// static
+void ezShaderManager::OnEngineShutdown()
+{
+  {
+    EZ_LOCK(s_CompileQueueMutex);
+
+    // only finish the compilation that is in progress
+    while (s_CompileQueue.GetCount() > 1)
+    {
+      s_CompileQueue.PopBack();
+    }
+  }
+
+  ezTaskSystem::WaitForGroup(s_CompileTaskGroup);
+
+  s_CompileQueue.Clear();
+  s_CompiledPermutations.Clear();
+  s_bCompileTaskRunning = false;
+
+  ezShaderCompiler::ClearFileCache();
+
+  EZ_LOCK(s_PermutationPathsMutex);
+  s_RecordedPermutations.Clear();
+  s_bRecordPermutations = false;
+}
+
 EZ_STATICLINK_FILE(RendererCore, RendererCore_ShaderCompiler_Implementation_ShaderManager);
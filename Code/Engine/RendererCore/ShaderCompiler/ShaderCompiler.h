@@ -5,6 +5,7 @@
 #include <Foundation/Logging/Log.h>
 #include <Foundation/Reflection/Reflection.h>
 #include <Foundation/Strings/String.h>
+#include <Foundation/Threading/Mutex.h>
 #include <Foundation/Types/Bitflags.h>
 #include <RendererCore/Declarations.h>
 #include <RendererCore/Shader/Implementation/Helper.h>
@@ -64,9 +65,20 @@ public:
 class EZ_RENDERERCORE_DLL ezShaderCompiler
 {
 public:
+  ezShaderCompiler();
+
   ezResult CompileShaderPermutationForPlatforms(const char* szFile, const ezArrayPtr<const ezPermutationVar>& permutationVars,
                                                 ezLogInterface* pLog, const char* szPlatform = "ALL");
 
+  /// \brief Compiles all permutations of \a szFile that \a permutationGenerator yields in parallel on the task system.
+  ///
+  /// Every permutation is compiled by its own ezShaderCompiler. Stops compiling further permutations once one of them failed.
+  static ezResult CompileShaderPermutationsForPlatforms(const char* szFile, const ezPermutationGenerator& permutationGenerator,
+                                                        const char* szPlatform = "ALL");
+
+  /// \brief Releases all tokenized files that are shared between the compilers. Called at engine shutdown.
+  static void ClearFileCache();
+
 private:
   ezResult RunShaderCompiler(const char* szFile, const char* szPlatform, ezShaderProgramCompiler* pCompiler, ezLogInterface* pLog);
 
@@ -84,10 +96,22 @@ private:
   };
 
   ezResult FileOpen(const char* szAbsoluteFile, ezDynamicArray<ezUInt8>& FileContent, ezTimestamp& out_FileModification);
+  ezResult FileLocator(const char* szCurAbsoluteFile, const char* szIncludeFile, ezPreprocessor::IncludeType IncType,
+                       ezStringBuilder& out_sAbsoluteFilePath);
 
+  ezStringBuilder m_StateSourceFile;
   ezStringBuilder m_StageSourceFile[ezGALShaderStage::ENUM_COUNT];
 
-  ezTokenizedFileCache m_FileCache;
+  /// \brief Returns false if another compiler of the same batch already wrote the stage binary with the given hash.
+  bool ClaimStageBinaryForWriting(ezUInt32 uiStage, ezUInt32 uiSourceHash);
+
+  struct WrittenStageBinaries
+  {
+    ezMutex m_Mutex;
+    ezSet<ezUInt64> m_Keys;
+  };
+
+  WrittenStageBinaries* m_pWrittenStageBinaries;
   ezShaderData m_ShaderData;
 
   ezSet<ezString> m_IncludeFiles;
@@ -1,9 +1,12 @@
 #pragma once
 
+#include <Foundation/Configuration/StaticSubSystem.h>
 #include <Foundation/Containers/HashTable.h>
 #include <RendererCore/Declarations.h>
 #include <RendererCore/ShaderCompiler/PermutationGenerator.h>
 
+struct ezRenderWorldRenderEvent;
+
 class EZ_RENDERERCORE_DLL ezShaderManager
 {
 public:
@@ -32,7 +35,73 @@ public:
   static ezShaderPermutationResourceHandle PreloadSinglePermutation(
     ezShaderResourceHandle hShader, const ezHashTable<ezHashedString, ezHashedString>& permVars, bool bAllowFallback);
 
+  /// \brief Preloads the permutation of the given shader that the render context draws with while the requested one is compiled in the background.
+  ///
+  /// The variables in replaceableVars (usually the ones of the material) are removed from permVars and thus use their default values.
+  /// All other variables, e.g. RENDER_PASS or CAMERA_MODE, are kept, as are BLEND_MODE and TWO_SIDED since they define the render state.
+  static ezShaderPermutationResourceHandle PreloadFallbackPermutation(ezShaderResourceHandle hShader,
+    const ezHashTable<ezHashedString, ezHashedString>& permVars, const ezHashTable<ezHashedString, ezHashedString>& replaceableVars);
+
+  /// \name Permutation warm-up
+  ///@{
+
+  /// \brief Starts recording every permutation that is requested through PreloadSinglePermutation. Previously recorded permutations are discarded.
+  ///
+  /// The permutation caches of all render contexts are invalidated, so that permutations which are already in use get recorded as well.
+  static void StartPermutationRecording();
+
+  /// \brief Stops recording permutations. The recorded permutations are kept until the next call to StartPermutationRecording.
+  static void StopPermutationRecording();
+
+  /// \brief Writes all recorded permutations to the given file, e.g. at the end of a play session.
+  static ezResult SavePermutationManifest(const char* szFile);
+
+  /// \brief Preloads all permutations that are listed in the given manifest file, e.g. while a level is loading.
+  ///
+  /// The permutations are loaded or compiled in the background, so that they are available once they are needed.
+  /// Returns the number of permutations that were queued for preloading.
+  static ezUInt32 PreloadPermutationManifest(const char* szFile);
+
+  ///@}
+  /// \name Asynchronous compilation
+  ///@{
+
+  struct AsyncCompilationStats
+  {
+    ezUInt32 m_uiQueueDepth = 0;     ///< Number of permutations that are queued or currently being compiled.
+    ezUInt32 m_uiHitchesAvoided = 0; ///< Number of permutations that were compiled in the background instead of blocking the loading.
+  };
+
+  /// \brief Returns statistics about the background compilation of permutations, see r_AsyncShaderCompilation.
+  static AsyncCompilationStats GetAsyncCompilationStats();
+
+  /// \brief Compiles the given permutation of a shader file for the active platform.
+  ///
+  /// Compilations are serialized since permutations can share stage binaries.
+  static ezResult CompilePermutation(const char* szShaderFile, ezArrayPtr<const ezPermutationVar> permutationVars);
+
+  /// \brief Queues the compilation of a permutation that doesn't exist in the shader cache yet.
+  ///
+  /// Returns false if asynchronous compilation is disabled, in which case the permutation has to be compiled right away.
+  /// Otherwise the permutation is compiled on a long running task and the resource is reloaded once the compilation has finished.
+  /// Until then the permutation resource stays invalid and the render context draws with a fallback permutation of the shader instead,
+  /// see PreloadFallbackPermutation().
+  static bool QueuePermutationCompilation(const ezShaderPermutationResourceHandle& hPermutation, const char* szShaderFile,
+    ezArrayPtr<const ezPermutationVar> permutationVars);
+
+  /// \brief Returns whether the given permutation is currently queued for compilation or waiting to be reloaded after it was compiled.
+  static bool IsPermutationCompilationQueued(const ezShaderPermutationResourceHandle& hPermutation);
+
+  ///@}
+
 private:
+  EZ_MAKE_SUBSYSTEM_STARTUP_FRIEND(RendererCore, RendererContext);
+
+  static void OnEngineShutdown();
+  static void OnRenderEvent(const ezRenderWorldRenderEvent& e);
+
+  static void CompileQueuedPermutations();
+
   static ezUInt32 FilterPermutationVars(ezArrayPtr<const ezHashedString> usedVars, const ezHashTable<ezHashedString, ezHashedString>& permVars,
     ezDynamicArray<ezPermutationVar>& out_FilteredPermutationVariables);
   static ezShaderPermutationResourceHandle PreloadSinglePermutationInternal(const char* szResourceId, ezUInt32 uiResourceIdHash,
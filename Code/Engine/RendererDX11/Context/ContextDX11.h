@@ -144,6 +144,8 @@ protected:
 
   virtual void FlushPlatform() override;
 
+  virtual void ExecuteDeferredContextPlatform(ezGALContext* pDeferredContext) override;
+
   // Debug helper functions
 
   virtual void PushMarkerPlatform(const char* szMarker) override;
@@ -154,6 +156,10 @@ protected:
 
   void FlushDeferredStateChanges();
 
+  void ResetBoundObjects();
+
+  ID3D11Buffer* GetDeferredUploadBuffer(ezUInt32 uiSize);
+
 
   ID3D11DeviceContext* m_pDXContext;
   ID3DUserDefinedAnnotation* m_pDXAnnotation;
@@ -184,6 +190,10 @@ protected:
   ezGAL::ModifiedRange m_BoundSamplerStatesRange[ezGALShaderStage::ENUM_COUNT];
 
   ID3D11DeviceChild* m_pBoundShaders[ezGALShaderStage::ENUM_COUNT];
+
+  // Deferred contexts can't map the staging buffers of the device, so they stage buffer updates in their own dynamic buffer
+  ID3D11Buffer* m_pDeferredUploadBuffer;
+  ezUInt32 m_uiDeferredUploadBufferSize;
 };
 
 #include <RendererDX11/Context/Implementation/ContextDX11_inl.h>
@@ -18,11 +18,11 @@
 
 
 ezGALContextDX11::ezGALContextDX11(ezGALDevice* pDevice, ID3D11DeviceContext* pDXContext)
-    : ezGALContext(pDevice)
+    : ezGALContext(pDevice, pDXContext != nullptr && pDXContext->GetType() == D3D11_DEVICE_CONTEXT_DEFERRED)
     , m_pDXContext(pDXContext)
     , m_pDXAnnotation(nullptr)
-    , m_pBoundDepthStencilTarget(nullptr)
-    , m_uiBoundRenderTargetCount(0)
+    , m_pDeferredUploadBuffer(nullptr)
+    , m_uiDeferredUploadBufferSize(0)
 {
   EZ_ASSERT_RELEASE(m_pDXContext != nullptr, "Invalid DX context!");
 
@@ -31,43 +31,12 @@ ezGALContextDX11::ezGALContextDX11(ezGALDevice* pDevice, ID3D11DeviceContext* pD
     ezLog::Warning("Failed to get annotation interface. GALContext marker will not work");
   }
 
-  for (ezUInt32 i = 0; i < EZ_GAL_MAX_RENDERTARGET_COUNT; i++)
-  {
-    m_pBoundRenderTargets[i] = nullptr;
-  }
-
-  for (ezUInt32 i = 0; i < EZ_GAL_MAX_VERTEX_BUFFER_COUNT; i++)
-  {
-    m_pBoundVertexBuffers[i] = nullptr;
-    m_VertexBufferOffsets[i] = 0;
-    m_VertexBufferStrides[i] = 0;
-  }
-  m_BoundVertexBuffersRange.Reset();
-
-  for (ezUInt32 i = 0; i < EZ_GAL_MAX_CONSTANT_BUFFER_COUNT; i++)
-  {
-    m_pBoundConstantBuffers[i] = nullptr;
-  }
-
-  for (ezUInt32 s = 0; s < ezGALShaderStage::ENUM_COUNT; s++)
-  {
-    for (ezUInt32 i = 0; i < EZ_GAL_MAX_SAMPLER_COUNT; i++)
-    {
-      m_pBoundSamplerStates[s][i] = nullptr;
-    }
-
-    m_BoundShaderResourceViewsRange[s].Reset();
-    m_BoundSamplerStatesRange[s].Reset();
-    m_BoundConstantBuffersRange[s].Reset();
-
-    m_pBoundShaders[s] = nullptr;
-  }
-
-  m_pBoundUnoderedAccessViewsRange.Reset();
+  ResetBoundObjects();
 }
 
 ezGALContextDX11::~ezGALContextDX11()
 {
+  EZ_GAL_DX11_RELEASE(m_pDeferredUploadBuffer);
   EZ_GAL_DX11_RELEASE(m_pDXContext);
   EZ_GAL_DX11_RELEASE(m_pDXAnnotation);
 }
@@ -348,6 +317,77 @@ void ezGALContextDX11::FlushDeferredStateChanges()
   }
 }
 
+ID3D11Buffer* ezGALContextDX11::GetDeferredUploadBuffer(ezUInt32 uiSize)
+{
+  if (m_uiDeferredUploadBufferSize < uiSize)
+  {
+    EZ_GAL_DX11_RELEASE(m_pDeferredUploadBuffer);
+    m_uiDeferredUploadBufferSize = 0;
+
+    const ezUInt32 uiNewSize = ezMath::Max(ezMath::PowerOfTwo_Ceil(uiSize), 64u * 1024u);
+
+    D3D11_BUFFER_DESC desc;
+    desc.ByteWidth = uiNewSize;
+    desc.Usage = D3D11_USAGE_DYNAMIC;
+    desc.BindFlags = D3D11_BIND_VERTEX_BUFFER; // dynamic buffers need at least one bind flag
+    desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    desc.MiscFlags = 0;
+    desc.StructureByteStride = 0;
+
+    ID3D11Device* pDXDevice = static_cast<ezGALDeviceDX11*>(GetDevice())->GetDXDevice();
+    if (FAILED(pDXDevice->CreateBuffer(&desc, nullptr, &m_pDeferredUploadBuffer)))
+    {
+      m_pDeferredUploadBuffer = nullptr;
+      return nullptr;
+    }
+
+    m_uiDeferredUploadBufferSize = uiNewSize;
+  }
+
+  return m_pDeferredUploadBuffer;
+}
+
+void ezGALContextDX11::ResetBoundObjects()
+{
+  for (ezUInt32 i = 0; i < EZ_GAL_MAX_RENDERTARGET_COUNT; i++)
+  {
+    m_pBoundRenderTargets[i] = nullptr;
+  }
+  m_pBoundDepthStencilTarget = nullptr;
+  m_uiBoundRenderTargetCount = 0;
+
+  for (ezUInt32 i = 0; i < EZ_GAL_MAX_VERTEX_BUFFER_COUNT; i++)
+  {
+    m_pBoundVertexBuffers[i] = nullptr;
+    m_VertexBufferOffsets[i] = 0;
+    m_VertexBufferStrides[i] = 0;
+  }
+  m_BoundVertexBuffersRange.Reset();
+
+  for (ezUInt32 i = 0; i < EZ_GAL_MAX_CONSTANT_BUFFER_COUNT; i++)
+  {
+    m_pBoundConstantBuffers[i] = nullptr;
+  }
+
+  for (ezUInt32 s = 0; s < ezGALShaderStage::ENUM_COUNT; s++)
+  {
+    for (ezUInt32 i = 0; i < EZ_GAL_MAX_SAMPLER_COUNT; i++)
+    {
+      m_pBoundSamplerStates[s][i] = nullptr;
+    }
+
+    m_BoundShaderResourceViewsRange[s].Reset();
+    m_BoundSamplerStatesRange[s].Reset();
+    m_BoundConstantBuffersRange[s].Reset();
+
+    m_pBoundShaderResourceViews[s].Clear();
+    m_pBoundShaders[s] = nullptr;
+  }
+
+  m_pBoundUnoderedAccessViews.Clear();
+  m_pBoundUnoderedAccessViewsRange.Reset();
+}
+
 // Dispatch
 
 void ezGALContextDX11::DispatchPlatform(ezUInt32 uiThreadGroupCountX, ezUInt32 uiThreadGroupCountY, ezUInt32 uiThreadGroupCountZ)
@@ -686,7 +726,28 @@ void ezGALContextDX11::UpdateBufferPlatform(const ezGALBuffer* pDestination, ezU
   }
   else
   {
-    if (updateMode == ezGALUpdateMode::CopyToTempStorage)
+    if (updateMode == ezGALUpdateMode::CopyToTempStorage && IsDeferred())
+    {
+      if (ID3D11Buffer* pDXUploadBuffer = GetDeferredUploadBuffer(pSourceData.GetCount()))
+      {
+        // Every discard gives the command list its own copy of the upload buffer, so it can be reused for every update.
+        D3D11_MAPPED_SUBRESOURCE MapResult;
+        HRESULT hRes = m_pDXContext->Map(pDXUploadBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &MapResult);
+        EZ_ASSERT_DEV(SUCCEEDED(hRes), "Implementation error");
+
+        memcpy(MapResult.pData, pSourceData.GetPtr(), pSourceData.GetCount());
+
+        m_pDXContext->Unmap(pDXUploadBuffer, 0);
+
+        D3D11_BOX srcBox = {0, 0, 0, pSourceData.GetCount(), 1, 1};
+        m_pDXContext->CopySubresourceRegion(pDXDestination, 0, uiDestOffset, 0, 0, pDXUploadBuffer, 0, &srcBox);
+      }
+      else
+      {
+        EZ_REPORT_FAILURE("Could not create an upload buffer for a deferred update.");
+      }
+    }
+    else if (updateMode == ezGALUpdateMode::CopyToTempStorage)
     {
       if (ID3D11Resource* pDXTempBuffer = static_cast<ezGALDeviceDX11*>(GetDevice())->FindTempBuffer(pSourceData.GetCount()))
       {
@@ -870,6 +931,27 @@ void ezGALContextDX11::FlushPlatform()
   FlushDeferredStateChanges();
 }
 
+void ezGALContextDX11::ExecuteDeferredContextPlatform(ezGALContext* pDeferredContext)
+{
+  ezGALContextDX11* pDeferredContextDX11 = static_cast<ezGALContextDX11*>(pDeferredContext);
+
+  ID3D11CommandList* pCommandList = nullptr;
+  if (FAILED(pDeferredContextDX11->m_pDXContext->FinishCommandList(FALSE, &pCommandList)))
+  {
+    ezLog::Error("Failed to finish the command list of a deferred context.");
+  }
+  else
+  {
+    // Restore the state of the immediate context afterwards so the state tracking of this context stays valid.
+    m_pDXContext->ExecuteCommandList(pCommandList, TRUE);
+
+    EZ_GAL_DX11_RELEASE(pCommandList);
+  }
+
+  // Finishing the command list resets the deferred context to its default state.
+  pDeferredContextDX11->ResetBoundObjects();
+}
+
 // Debug helper functions
 
 void ezGALContextDX11::PushMarkerPlatform(const char* szMarker)
@@ -145,6 +145,10 @@ protected:
 
   virtual void SetPrimarySwapChainPlatform(ezGALSwapChain* pSwapChain) override;
 
+  virtual ezGALContext* CreateDeferredContextPlatform() override;
+
+  virtual void DestroyDeferredContextPlatform(ezGALContext* pDeferredContext) override;
+
   virtual void FillCapabilitiesPlatform() override;
 
   /// \endcond
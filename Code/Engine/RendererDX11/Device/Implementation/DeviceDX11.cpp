@@ -811,6 +811,23 @@ void ezGALDeviceDX11::SetPrimarySwapChainPlatform(ezGALSwapChain* pSwapChain)
 #endif
 }
 
+ezGALContext* ezGALDeviceDX11::CreateDeferredContextPlatform()
+{
+  ID3D11DeviceContext* pDeferredContext = nullptr;
+  if (FAILED(m_pDevice->CreateDeferredContext(0, &pDeferredContext)))
+  {
+    ezLog::Error("Creating a D3D11 deferred context failed.");
+    return nullptr;
+  }
+
+  return EZ_NEW(&m_Allocator, ezGALContextDX11, this, pDeferredContext);
+}
+
+void ezGALDeviceDX11::DestroyDeferredContextPlatform(ezGALContext* pDeferredContext)
+{
+  EZ_DELETE(&m_Allocator, pDeferredContext);
+}
+
 
 void ezGALDeviceDX11::FillCapabilitiesPlatform()
 {
@@ -826,6 +843,8 @@ void ezGALDeviceDX11::FillCapabilitiesPlatform()
   }
 
   m_Capabilities.m_bMultithreadedResourceCreation = true;
+  // If the driver doesn't support command lists natively, the D3D11 runtime emulates them.
+  m_Capabilities.m_bMultithreadedCommandRecording = true;
 
   switch (m_FeatureLevel)
   {
@@ -142,15 +142,48 @@ public:
 
   void InsertEventMarker(const char* Marker);
 
+  // Deferred command recording
+
+  /// \brief Returns whether this is a deferred context, i.e. one that records commands for later submission instead of executing them.
+  ///
+  /// Deferred contexts are created with ezGALDevice::CreateDeferredContext() and can be used on any thread, but only by one thread at a time.
+  /// Fences, queries, timestamps and texture readbacks are not available on deferred contexts.
+  bool IsDeferred() const { return m_bDeferred; }
+
+  /// \brief Prepares a deferred context for recording commands that continue the work of the given source context.
+  ///
+  /// A deferred context doesn't inherit any state, so this copies the render target setup, viewport, scissor rect and
+  /// the blend, depth stencil and rasterizer states of the source context. Everything else has to be set by the recording code.
+  /// The source context must not be modified while this function is running.
+  void BeginRecording(const ezGALContext& sourceContext);
+
+  /// \brief Submits all commands that have been recorded into the given deferred context since it was executed the last time.
+  ///
+  /// Can only be called on the immediate context. The state of this context is not changed by the recorded commands,
+  /// the deferred context is reset to an empty state and its statistics counters are added to the counters of this context.
+  void ExecuteDeferredContext(ezGALContext* pDeferredContext);
+
   void ClearStatisticsCounters();
 
+  /// \brief Returns the number of draw calls since the last call to ClearStatisticsCounters(), which happens at the start of every frame.
+  ezUInt32 GetDrawCallCount() const { return m_uiDrawCalls; }
+  ezUInt32 GetDispatchCallCount() const { return m_uiDispatchCalls; }
+  ezUInt32 GetStateChangeCount() const { return m_uiStateChanges; }
+  ezUInt32 GetRedundantStateChangeCount() const { return m_uiRedundantStateChanges; }
+
   ezGALDevice* GetDevice() const;
 
+  /// \brief Returns a counter that is incremented whenever the render target setup or an unordered access view changes or the state is invalidated.
+  ///
+  /// These changes can unbind resource views that are also used as render target or UAV, so code that skips redundant resource bindings
+  /// on its own, like ezRenderContext, has to bind everything again once this value changes.
+  ezUInt32 GetBindingGeneration() const { return m_uiBindingGeneration; }
+
 protected:
 
   friend class ezGALDevice;
 
-  ezGALContext(ezGALDevice* pDevice);
+  ezGALContext(ezGALDevice* pDevice, bool bDeferred = false);
 
   virtual ~ezGALContext();
 
@@ -267,6 +300,8 @@ protected:
 
   virtual void FlushPlatform() = 0;
 
+  virtual void ExecuteDeferredContextPlatform(ezGALContext* pDeferredContext) = 0;
+
   // Debug helper functions
 
   virtual void PushMarkerPlatform(const char* Marker) = 0;
@@ -297,12 +332,19 @@ private:
 
   void AssertRenderingThread();
 
+  void AssertImmediateContext();
+
   // Parent device
   ezGALDevice* m_pDevice;
 
+  // Whether this context records into a command list
+  bool m_bDeferred;
+
   // Used to track redundant state changes
   ezGALContextState m_State;
 
+  ezUInt32 m_uiBindingGeneration;
+
   // Statistic variables
   ezUInt32 m_uiDrawCalls;
 
@@ -9,8 +9,10 @@
 #include <RendererFoundation/Resources/Texture.h>
 #include <RendererFoundation/Resources/UnorderedAccesView.h>
 
-ezGALContext::ezGALContext(ezGALDevice* pDevice)
+ezGALContext::ezGALContext(ezGALDevice* pDevice, bool bDeferred)
   : m_pDevice(pDevice)
+  , m_bDeferred(bDeferred)
+  , m_uiBindingGeneration(0)
   , m_uiDrawCalls(0)
   , m_uiDispatchCalls(0)
   , m_uiStateChanges(0)
@@ -413,6 +415,7 @@ void ezGALContext::SetRenderTargetSetup(const ezGALRenderTargetSetup& RenderTarg
   SetRenderTargetSetupPlatform(ezMakeArrayPtr(pRenderTargetViews, uiRenderTargetCount), pDepthStencilView);
 
   m_State.m_RenderTargetSetup = RenderTargetSetup;
+  ++m_uiBindingGeneration;
 
   CountStateChange();
 }
@@ -446,6 +449,7 @@ void ezGALContext::SetUnorderedAccessView(ezUInt32 uiSlot, ezGALUnorderedAccessV
   m_State.m_pResourcesForUnorderedAccessViews.EnsureCount(uiSlot + 1);
   m_State.m_pResourcesForUnorderedAccessViews[uiSlot] =
     pUnorderedAccessView != nullptr ? pUnorderedAccessView->GetResource()->GetParentResource() : nullptr;
+  ++m_uiBindingGeneration;
 
   CountStateChange();
 }
@@ -562,6 +566,7 @@ void ezGALContext::InsertFence(ezGALFenceHandle hFence)
 bool ezGALContext::IsFenceReached(ezGALFenceHandle hFence)
 {
   AssertRenderingThread();
+  AssertImmediateContext();
 
   return IsFenceReachedPlatform(m_pDevice->GetFence(hFence));
 }
@@ -569,6 +574,7 @@ bool ezGALContext::IsFenceReached(ezGALFenceHandle hFence)
 void ezGALContext::WaitForFence(ezGALFenceHandle hFence)
 {
   AssertRenderingThread();
+  AssertImmediateContext();
 
   WaitForFencePlatform(m_pDevice->GetFence(hFence));
 }
@@ -596,6 +602,7 @@ void ezGALContext::EndQuery(ezGALQueryHandle hQuery)
 ezResult ezGALContext::GetQueryResult(ezGALQueryHandle hQuery, ezUInt64& uiQueryResult)
 {
   AssertRenderingThread();
+  AssertImmediateContext();
 
   auto query = m_pDevice->GetQuery(hQuery);
   EZ_ASSERT_DEV(!query->m_bStarted, "Can't retrieve data from ezGALQuery while query is still running.");
@@ -605,6 +612,8 @@ ezResult ezGALContext::GetQueryResult(ezGALQueryHandle hQuery, ezUInt64& uiQuery
 
 ezGALTimestampHandle ezGALContext::InsertTimestamp()
 {
+  AssertImmediateContext();
+
   ezGALTimestampHandle hTimestamp = m_pDevice->GetTimestamp();
 
   InsertTimestampPlatform(hTimestamp);
@@ -664,7 +673,8 @@ void ezGALContext::UpdateBuffer(
 
   if (pDest != nullptr)
   {
-    if (updateMode == ezGALUpdateMode::NoOverwrite && !(GetDevice()->GetCapabilities().m_bNoOverwriteBufferUpdate))
+    // Deferred contexts can't rely on the order in which their command lists are executed relative to other contexts
+    if (updateMode == ezGALUpdateMode::NoOverwrite && (m_bDeferred || !(GetDevice()->GetCapabilities().m_bNoOverwriteBufferUpdate)))
     {
       updateMode = ezGALUpdateMode::CopyToTempStorage;
     }
@@ -752,6 +762,7 @@ void ezGALContext::ResolveTexture(ezGALTextureHandle hDest, const ezGALTextureSu
 void ezGALContext::ReadbackTexture(ezGALTextureHandle hTexture)
 {
   AssertRenderingThread();
+  AssertImmediateContext();
 
   const ezGALTexture* pTexture = m_pDevice->GetTexture(hTexture);
 
@@ -767,6 +778,7 @@ void ezGALContext::ReadbackTexture(ezGALTextureHandle hTexture)
 void ezGALContext::CopyTextureReadbackResult(ezGALTextureHandle hTexture, const ezArrayPtr<ezGALSystemMemoryDescription>* pData)
 {
   AssertRenderingThread();
+  AssertImmediateContext();
 
   const ezGALTexture* pTexture = m_pDevice->GetTexture(hTexture);
 
@@ -829,6 +841,66 @@ void ezGALContext::InsertEventMarker(const char* Marker)
   InsertEventMarkerPlatform(Marker);
 }
 
+void ezGALContext::BeginRecording(const ezGALContext& sourceContext)
+{
+  AssertRenderingThread();
+
+  EZ_ASSERT_DEV(m_bDeferred, "BeginRecording can only be called on a deferred context.");
+  EZ_ASSERT_DEV(sourceContext.m_pDevice == m_pDevice, "The source context must belong to the same device.");
+
+  const ezGALContextState& sourceState = sourceContext.m_State;
+
+  SetRenderTargetSetup(sourceState.m_RenderTargetSetup);
+
+  if (sourceState.m_fViewPortMinDepth <= sourceState.m_fViewPortMaxDepth)
+  {
+    SetViewport(sourceState.m_ViewPortRect, sourceState.m_fViewPortMinDepth, sourceState.m_fViewPortMaxDepth);
+  }
+
+  if (sourceState.m_ScissorRect.x != 0xFFFFFFFF)
+  {
+    SetScissorRect(sourceState.m_ScissorRect);
+  }
+
+  if (!sourceState.m_hBlendState.IsInvalidated())
+  {
+    SetBlendState(sourceState.m_hBlendState, sourceState.m_BlendFactor, sourceState.m_uiSampleMask);
+  }
+
+  if (!sourceState.m_hDepthStencilState.IsInvalidated())
+  {
+    SetDepthStencilState(sourceState.m_hDepthStencilState, sourceState.m_uiStencilRefValue);
+  }
+
+  if (!sourceState.m_hRasterizerState.IsInvalidated())
+  {
+    SetRasterizerState(sourceState.m_hRasterizerState);
+  }
+}
+
+void ezGALContext::ExecuteDeferredContext(ezGALContext* pDeferredContext)
+{
+  AssertRenderingThread();
+  AssertImmediateContext();
+
+  EZ_ASSERT_DEV(pDeferredContext != nullptr && pDeferredContext->m_bDeferred, "Only deferred contexts can be executed.");
+  EZ_ASSERT_DEV(pDeferredContext->m_pDevice == m_pDevice, "The deferred context must belong to the same device.");
+
+  ExecuteDeferredContextPlatform(pDeferredContext);
+
+  m_uiDrawCalls += pDeferredContext->m_uiDrawCalls;
+  m_uiDispatchCalls += pDeferredContext->m_uiDispatchCalls;
+  m_uiStateChanges += pDeferredContext->m_uiStateChanges;
+  m_uiRedundantStateChanges += pDeferredContext->m_uiRedundantStateChanges;
+
+  pDeferredContext->ClearStatisticsCounters();
+
+  // The platform state of a deferred context is reset after its command list has been closed,
+  // so the whole tracked state has to be reset as well, not just the parts that InvalidateState handles.
+  pDeferredContext->m_State = ezGALContextState();
+  pDeferredContext->InvalidateState();
+}
+
 void ezGALContext::ClearStatisticsCounters()
 {
   // Reset counters for various statistics
@@ -841,6 +913,7 @@ void ezGALContext::ClearStatisticsCounters()
 void ezGALContext::InvalidateState()
 {
   m_State.Invalidate();
+  ++m_uiBindingGeneration;
 }
 
 bool ezGALContext::UnsetResourceViews(const ezGALResourceBase* pResource)
@@ -26,6 +26,11 @@ EZ_ALWAYS_INLINE void ezGALContext::CountRedundantStateChange()
 
 EZ_ALWAYS_INLINE void ezGALContext::AssertRenderingThread()
 {
-  EZ_ASSERT_DEV(ezThreadUtils::IsMainThread(), "This function can only be executed on the main thread.");
+  EZ_ASSERT_DEV(m_bDeferred || ezThreadUtils::IsMainThread(), "This function can only be executed on the main thread.");
+}
+
+EZ_ALWAYS_INLINE void ezGALContext::AssertImmediateContext()
+{
+  EZ_ASSERT_DEV(!m_bDeferred, "This function can't be used on a deferred context.");
 }
 
@@ -141,6 +141,13 @@ public:
   template<typename T>
   T* GetPrimaryContext() const;
 
+  /// \brief Creates a context that records commands on any thread, see ezGALContext::ExecuteDeferredContext().
+  ///
+  /// Returns nullptr if the device doesn't support multithreaded command recording.
+  ezGALContext* CreateDeferredContext();
+
+  void DestroyDeferredContext(ezGALContext* pDeferredContext);
+
   const ezGALDeviceCreationDescription* GetDescription() const;
 
 
@@ -377,6 +384,10 @@ protected:
 
   virtual void SetPrimarySwapChainPlatform(ezGALSwapChain* pSwapChain) = 0;
 
+  virtual ezGALContext* CreateDeferredContextPlatform() = 0;
+
+  virtual void DestroyDeferredContextPlatform(ezGALContext* pDeferredContext) = 0;
+
   virtual void FillCapabilitiesPlatform() = 0;
 
   /// \endcond
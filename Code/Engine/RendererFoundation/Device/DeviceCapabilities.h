@@ -19,6 +19,7 @@ struct EZ_RENDERERFOUNDATION_DLL ezGALDeviceCapabilities
   // General capabilities
   bool m_bMultithreadedResourceCreation; ///< whether creating resources is allowed on other threads than the main thread
   bool m_bNoOverwriteBufferUpdate;
+  bool m_bMultithreadedCommandRecording; ///< whether deferred contexts can be created to record commands on other threads than the main thread
 
   // Draw related capabilities
   bool m_bShaderStageSupported[ezGALShaderStage::ENUM_COUNT];
@@ -1242,6 +1242,37 @@ void ezGALDevice::SetPrimarySwapChain(ezGALSwapChainHandle hSwapChain)
   }
 }
 
+ezGALContext* ezGALDevice::CreateDeferredContext()
+{
+  EZ_ASSERT_DEV(ezThreadUtils::IsMainThread(), "Deferred contexts can only be created on the main thread.");
+
+  if (!m_Capabilities.m_bMultithreadedCommandRecording)
+  {
+    return nullptr;
+  }
+
+  EZ_LOCK(m_Mutex);
+
+  ezGALContext* pDeferredContext = CreateDeferredContextPlatform();
+  EZ_ASSERT_DEV(pDeferredContext == nullptr || pDeferredContext->IsDeferred(), "Implementation error");
+
+  return pDeferredContext;
+}
+
+void ezGALDevice::DestroyDeferredContext(ezGALContext* pDeferredContext)
+{
+  EZ_ASSERT_DEV(ezThreadUtils::IsMainThread(), "Deferred contexts can only be destroyed on the main thread.");
+
+  if (pDeferredContext == nullptr)
+    return;
+
+  EZ_ASSERT_DEV(pDeferredContext->IsDeferred() && pDeferredContext->GetDevice() == this, "Invalid deferred context");
+
+  EZ_LOCK(m_Mutex);
+
+  DestroyDeferredContextPlatform(pDeferredContext);
+}
+
 const ezGALDeviceCapabilities& ezGALDevice::GetCapabilities() const
 {
   return m_Capabilities;
@@ -8,6 +8,7 @@ ezGALDeviceCapabilities::ezGALDeviceCapabilities()
   // General capabilities
   m_bMultithreadedResourceCreation = false;
   m_bNoOverwriteBufferUpdate = false;
+  m_bMultithreadedCommandRecording = false;
 
   // Draw related capabilities
   for (int i = 0; i < ezGALShaderStage::ENUM_COUNT; ++i)
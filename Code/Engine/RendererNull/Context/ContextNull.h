@@ -0,0 +1,258 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <RendererFoundation/Context/Context.h>
+#include <RendererFoundation/Device/Device.h>
+#include <RendererNull/RendererNullDLL.h>
+
+class ezGALBufferNull;
+
+/// \brief All commands that the null context can record. Debug markers are not recorded.
+struct EZ_RENDERERNULL_DLL ezGALNullCommandType
+{
+  enum Enum : ezUInt8
+  {
+    Clear,
+    ClearUnorderedAccessView,
+    Draw,
+    DrawIndexed,
+    DrawIndexedInstanced,
+    DrawIndexedInstancedIndirect,
+    DrawInstanced,
+    DrawInstancedIndirect,
+    DrawAuto,
+    BeginStreamOut,
+    EndStreamOut,
+    Dispatch,
+    DispatchIndirect,
+    SetShader,
+    SetIndexBuffer,
+    SetVertexBuffer,
+    SetVertexDeclaration,
+    SetPrimitiveTopology,
+    SetConstantBuffer,
+    SetSamplerState,
+    SetResourceView,
+    SetRenderTargetSetup,
+    SetUnorderedAccessView,
+    SetBlendState,
+    SetDepthStencilState,
+    SetRasterizerState,
+    SetViewport,
+    SetScissorRect,
+    SetStreamOutBuffer,
+    InsertFence,
+    BeginQuery,
+    EndQuery,
+    InsertTimestamp,
+    CopyBuffer,
+    CopyBufferRegion,
+    UpdateBuffer,
+    CopyTexture,
+    CopyTextureRegion,
+    UpdateTexture,
+    ResolveTexture,
+    ReadbackTexture,
+    GenerateMipMaps,
+    Flush,
+
+    ENUM_COUNT
+  };
+
+  static const char* GetName(Enum type);
+};
+
+/// \brief A single recorded command of the null context.
+///
+/// m_pObject is the GAL object that the command refers to, e.g. the bound shader or the updated buffer, and may be nullptr.
+/// The meaning of m_uiArgs depends on the command type, e.g. slot, vertex or index count, start or byte offset.
+struct ezGALNullCommand
+{
+  EZ_DECLARE_POD_TYPE();
+
+  ezGALNullCommandType::Enum m_Type;
+  const void* m_pObject;
+  ezUInt32 m_uiArgs[3];
+};
+
+/// \brief The null implementation of the graphics context.
+///
+/// Nothing is executed, but every call is validated against the currently bound state and counted.
+/// Optionally all commands can be recorded, e.g. to compare the command streams of two renderer versions.
+/// Deferred contexts record their commands whenever the primary context does, executing them appends their commands and statistics
+/// to the immediate context, so a frame that was recorded in parallel can be compared to one that was recorded serially.
+/// Validation errors are always counted but only logged if the device was created as debug device.
+class EZ_RENDERERNULL_DLL ezGALContextNull : public ezGALContext
+{
+public:
+  struct Statistics
+  {
+    ezUInt32 m_uiCommandCounts[ezGALNullCommandType::ENUM_COUNT] = {};
+    ezUInt64 m_uiUpdatedBufferBytes = 0;
+    ezUInt32 m_uiValidationErrors = 0;
+  };
+
+  /// \brief Enables or disables recording of all commands. Recording is disabled by default.
+  void SetCommandRecording(bool bEnable) { m_bRecordCommands = bEnable; }
+  bool GetCommandRecording() const { return m_bRecordCommands; }
+
+  /// \brief Returns all commands that have been recorded since the last call to ClearRecordedCommands().
+  ezArrayPtr<const ezGALNullCommand> GetRecordedCommands() const { return m_RecordedCommands; }
+  void ClearRecordedCommands() { m_RecordedCommands.Clear(); }
+
+  /// \brief Returns the statistics since the last call to ResetStatistics(). Unlike the counters of ezGALContext these are not reset every frame.
+  const Statistics& GetStatistics() const { return m_Statistics; }
+  void ResetStatistics() { m_Statistics = Statistics(); }
+
+protected:
+  friend class ezGALDeviceNull;
+  friend class ezMemoryUtils;
+
+  ezGALContextNull(ezGALDevice* pDevice, bool bDeferred = false);
+
+  ~ezGALContextNull();
+
+  // Draw functions
+
+  virtual void ClearPlatform(const ezColor& ClearColor, ezUInt32 uiRenderTargetClearMask, bool bClearDepth, bool bClearStencil, float fDepthClear, ezUInt8 uiStencilClear) override;
+
+  virtual void ClearUnorderedAccessViewPlatform(const ezGALUnorderedAccessView* pUnorderedAccessView, ezVec4 clearValues) override;
+
+  virtual void ClearUnorderedAccessViewPlatform(const ezGALUnorderedAccessView* pUnorderedAccessView, ezVec4U32 clearValues) override;
+
+  virtual void DrawPlatform(ezUInt32 uiVertexCount, ezUInt32 uiStartVertex) override;
+
+  virtual void DrawIndexedPlatform(ezUInt32 uiIndexCount, ezUInt32 uiStartIndex) override;
+
+  virtual void DrawIndexedInstancedPlatform(ezUInt32 uiIndexCountPerInstance, ezUInt32 uiInstanceCount, ezUInt32 uiStartIndex) override;
+
+  virtual void DrawIndexedInstancedIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes) override;
+
+  virtual void DrawInstancedPlatform(ezUInt32 uiVertexCountPerInstance, ezUInt32 uiInstanceCount, ezUInt32 uiStartVertex) override;
+
+  virtual void DrawInstancedIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes) override;
+
+  virtual void DrawAutoPlatform() override;
+
+  virtual void BeginStreamOutPlatform() override;
+
+  virtual void EndStreamOutPlatform() override;
+
+  // Dispatch
+
+  virtual void DispatchPlatform(ezUInt32 uiThreadGroupCountX, ezUInt32 uiThreadGroupCountY, ezUInt32 uiThreadGroupCountZ) override;
+
+  virtual void DispatchIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes) override;
+
+
+  // State setting functions
+
+  virtual void SetShaderPlatform(const ezGALShader* pShader) override;
+
+  virtual void SetIndexBufferPlatform(const ezGALBuffer* pIndexBuffer) override;
+
+  virtual void SetVertexBufferPlatform(ezUInt32 uiSlot, const ezGALBuffer* pVertexBuffer) override;
+
+  virtual void SetVertexDeclarationPlatform(const ezGALVertexDeclaration* pVertexDeclaration) override;
+
+  virtual void SetPrimitiveTopologyPlatform(ezGALPrimitiveTopology::Enum Topology) override;
+
+  virtual void SetConstantBufferPlatform(ezUInt32 uiSlot, const ezGALBuffer* pBuffer) override;
+
+  virtual void SetSamplerStatePlatform(ezGALShaderStage::Enum Stage, ezUInt32 uiSlot, const ezGALSamplerState* pSamplerState) override;
+
+  virtual void SetResourceViewPlatform(ezGALShaderStage::Enum Stage, ezUInt32 uiSlot, const ezGALResourceView* pResourceView) override;
+
+  virtual void SetRenderTargetSetupPlatform(ezArrayPtr<const ezGALRenderTargetView*> pRenderTargetViews, const ezGALRenderTargetView* pDepthStencilView) override;
+
+  virtual void SetUnorderedAccessViewPlatform(ezUInt32 uiSlot, const ezGALUnorderedAccessView* pUnorderedAccessView) override;
+
+  virtual void SetBlendStatePlatform(const ezGALBlendState* pBlendState, const ezColor& BlendFactor, ezUInt32 uiSampleMask) override;
+
+  virtual void SetDepthStencilStatePlatform(const ezGALDepthStencilState* pDepthStencilState, ezUInt8 uiStencilRefValue) override;
+
+  virtual void SetRasterizerStatePlatform(const ezGALRasterizerState* pRasterizerState) override;
+
+  virtual void SetViewportPlatform(const ezRectFloat& rect, float fMinDepth, float fMaxDepth) override;
+
+  virtual void SetScissorRectPlatform(const ezRectU32& rect) override;
+
+  virtual void SetStreamOutBufferPlatform(ezUInt32 uiSlot, const ezGALBuffer* pBuffer, ezUInt32 uiOffset) override;
+
+  // Fence & Query functions
+
+  virtual void InsertFencePlatform(const ezGALFence* pFence) override;
+
+  virtual bool IsFenceReachedPlatform(const ezGALFence* pFence) override;
+
+  virtual void WaitForFencePlatform(const ezGALFence* pFence) override;
+
+  virtual void BeginQueryPlatform(const ezGALQuery* pQuery) override;
+
+  virtual void EndQueryPlatform(const ezGALQuery* pQuery) override;
+
+  virtual ezResult GetQueryResultPlatform(const ezGALQuery* pQuery, ezUInt64& uiQueryResult) override;
+
+  // Timestamp functions
+
+  virtual void InsertTimestampPlatform(ezGALTimestampHandle hTimestamp) override;
+
+  // Resource update functions
+
+  virtual void CopyBufferPlatform(const ezGALBuffer* pDestination, const ezGALBuffer* pSource) override;
+
+  virtual void CopyBufferRegionPlatform(const ezGALBuffer* pDestination, ezUInt32 uiDestOffset, const ezGALBuffer* pSource, ezUInt32 uiSourceOffset, ezUInt32 uiByteCount) override;
+
+  virtual void UpdateBufferPlatform(const ezGALBuffer* pDestination, ezUInt32 uiDestOffset, ezArrayPtr<const ezUInt8> pSourceData, ezGALUpdateMode::Enum updateMode) override;
+
+  virtual void CopyTexturePlatform(const ezGALTexture* pDestination, const ezGALTexture* pSource) override;
+
+  virtual void CopyTextureRegionPlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& DestinationSubResource, const ezVec3U32& DestinationPoint, const ezGALTexture* pSource, const ezGALTextureSubresource& SourceSubResource, const ezBoundingBoxu32& Box) override;
+
+  virtual void UpdateTexturePlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& DestinationSubResource, const ezBoundingBoxu32& DestinationBox, const ezGALSystemMemoryDescription& pSourceData) override;
+
+  virtual void ResolveTexturePlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& DestinationSubResource, const ezGALTexture* pSource, const ezGALTextureSubresource& SourceSubResource) override;
+
+  virtual void ReadbackTexturePlatform(const ezGALTexture* pTexture) override;
+
+  virtual void CopyTextureReadbackResultPlatform(const ezGALTexture* pTexture, const ezArrayPtr<ezGALSystemMemoryDescription>* pData) override;
+
+  virtual void GenerateMipMapsPlatform(const ezGALResourceView* pResourceView) override;
+
+  // Misc
+
+  virtual void FlushPlatform() override;
+
+  virtual void ExecuteDeferredContextPlatform(ezGALContext* pDeferredContext) override;
+
+  // Debug helper functions
+
+  virtual void PushMarkerPlatform(const char* Marker) override;
+
+  virtual void PopMarkerPlatform() override;
+
+  virtual void InsertEventMarkerPlatform(const char* Marker) override;
+
+private:
+  void AddCommand(ezGALNullCommandType::Enum type, const void* pObject = nullptr, ezUInt32 uiArg0 = 0, ezUInt32 uiArg1 = 0, ezUInt32 uiArg2 = 0);
+
+  void ReportError(ezGALNullCommandType::Enum type, const char* szMessage);
+
+  void ValidateDraw(ezGALNullCommandType::Enum type);
+  void ValidateIndexRange(ezGALNullCommandType::Enum type, ezUInt32 uiIndexCount, ezUInt32 uiStartIndex);
+  void ValidateDispatch(ezGALNullCommandType::Enum type);
+
+  bool m_bRecordCommands = false;
+  ezDynamicArray<ezGALNullCommand> m_RecordedCommands;
+
+  Statistics m_Statistics;
+
+  // Bound state that is needed for validation
+  const ezGALShader* m_pBoundShader = nullptr;
+  const ezGALBufferNull* m_pBoundIndexBuffer = nullptr;
+  const ezGALVertexDeclaration* m_pBoundVertexDeclaration = nullptr;
+  ezUInt32 m_uiBoundVertexBufferMask = 0;
+  ezUInt32 m_uiBoundRenderTargetCount = 0;
+  bool m_bDepthStencilBound = false;
+  ezUInt32 m_uiMarkerDepth = 0;
+};
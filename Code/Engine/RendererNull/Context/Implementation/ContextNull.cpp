@@ -0,0 +1,529 @@
+#include <RendererNullPCH.h>
+
+#include <RendererNull/Context/ContextNull.h>
+#include <RendererNull/Device/DeviceNull.h>
+#include <RendererNull/Resources/ResourcesNull.h>
+#include <RendererNull/Shader/ShaderNull.h>
+
+namespace
+{
+  static const char* s_szCommandNames[] = {
+    "Clear",
+    "ClearUnorderedAccessView",
+    "Draw",
+    "DrawIndexed",
+    "DrawIndexedInstanced",
+    "DrawIndexedInstancedIndirect",
+    "DrawInstanced",
+    "DrawInstancedIndirect",
+    "DrawAuto",
+    "BeginStreamOut",
+    "EndStreamOut",
+    "Dispatch",
+    "DispatchIndirect",
+    "SetShader",
+    "SetIndexBuffer",
+    "SetVertexBuffer",
+    "SetVertexDeclaration",
+    "SetPrimitiveTopology",
+    "SetConstantBuffer",
+    "SetSamplerState",
+    "SetResourceView",
+    "SetRenderTargetSetup",
+    "SetUnorderedAccessView",
+    "SetBlendState",
+    "SetDepthStencilState",
+    "SetRasterizerState",
+    "SetViewport",
+    "SetScissorRect",
+    "SetStreamOutBuffer",
+    "InsertFence",
+    "BeginQuery",
+    "EndQuery",
+    "InsertTimestamp",
+    "CopyBuffer",
+    "CopyBufferRegion",
+    "UpdateBuffer",
+    "CopyTexture",
+    "CopyTextureRegion",
+    "UpdateTexture",
+    "ResolveTexture",
+    "ReadbackTexture",
+    "GenerateMipMaps",
+    "Flush",
+  };
+
+  EZ_CHECK_AT_COMPILETIME_MSG(EZ_ARRAY_SIZE(s_szCommandNames) == ezGALNullCommandType::ENUM_COUNT, "Command names are out of sync");
+} // namespace
+
+// static
+const char* ezGALNullCommandType::GetName(Enum type)
+{
+  return type < ENUM_COUNT ? s_szCommandNames[type] : "Invalid";
+}
+
+ezGALContextNull::ezGALContextNull(ezGALDevice* pDevice, bool bDeferred)
+  : ezGALContext(pDevice, bDeferred)
+{
+}
+
+ezGALContextNull::~ezGALContextNull() = default;
+
+// Draw functions
+
+void ezGALContextNull::ClearPlatform(const ezColor& ClearColor, ezUInt32 uiRenderTargetClearMask, bool bClearDepth, bool bClearStencil,
+  float fDepthClear, ezUInt8 uiStencilClear)
+{
+  if (m_uiBoundRenderTargetCount == 0 && !m_bDepthStencilBound)
+  {
+    ReportError(ezGALNullCommandType::Clear, "No render target is bound");
+  }
+
+  AddCommand(ezGALNullCommandType::Clear, nullptr, uiRenderTargetClearMask, (bClearDepth ? 1u : 0u) | (bClearStencil ? 2u : 0u), uiStencilClear);
+}
+
+void ezGALContextNull::ClearUnorderedAccessViewPlatform(const ezGALUnorderedAccessView* pUnorderedAccessView, ezVec4 clearValues)
+{
+  AddCommand(ezGALNullCommandType::ClearUnorderedAccessView, pUnorderedAccessView);
+}
+
+void ezGALContextNull::ClearUnorderedAccessViewPlatform(const ezGALUnorderedAccessView* pUnorderedAccessView, ezVec4U32 clearValues)
+{
+  AddCommand(ezGALNullCommandType::ClearUnorderedAccessView, pUnorderedAccessView);
+}
+
+void ezGALContextNull::DrawPlatform(ezUInt32 uiVertexCount, ezUInt32 uiStartVertex)
+{
+  ValidateDraw(ezGALNullCommandType::Draw);
+  AddCommand(ezGALNullCommandType::Draw, nullptr, uiVertexCount, uiStartVertex);
+}
+
+void ezGALContextNull::DrawIndexedPlatform(ezUInt32 uiIndexCount, ezUInt32 uiStartIndex)
+{
+  ValidateDraw(ezGALNullCommandType::DrawIndexed);
+  ValidateIndexRange(ezGALNullCommandType::DrawIndexed, uiIndexCount, uiStartIndex);
+  AddCommand(ezGALNullCommandType::DrawIndexed, nullptr, uiIndexCount, uiStartIndex);
+}
+
+void ezGALContextNull::DrawIndexedInstancedPlatform(ezUInt32 uiIndexCountPerInstance, ezUInt32 uiInstanceCount, ezUInt32 uiStartIndex)
+{
+  ValidateDraw(ezGALNullCommandType::DrawIndexedInstanced);
+  ValidateIndexRange(ezGALNullCommandType::DrawIndexedInstanced, uiIndexCountPerInstance, uiStartIndex);
+  AddCommand(ezGALNullCommandType::DrawIndexedInstanced, nullptr, uiIndexCountPerInstance, uiInstanceCount, uiStartIndex);
+}
+
+void ezGALContextNull::DrawIndexedInstancedIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes)
+{
+  ValidateDraw(ezGALNullCommandType::DrawIndexedInstancedIndirect);
+  if (m_pBoundIndexBuffer == nullptr)
+  {
+    ReportError(ezGALNullCommandType::DrawIndexedInstancedIndirect, "No index buffer is bound");
+  }
+
+  AddCommand(ezGALNullCommandType::DrawIndexedInstancedIndirect, pIndirectArgumentBuffer, uiArgumentOffsetInBytes);
+}
+
+void ezGALContextNull::DrawInstancedPlatform(ezUInt32 uiVertexCountPerInstance, ezUInt32 uiInstanceCount, ezUInt32 uiStartVertex)
+{
+  ValidateDraw(ezGALNullCommandType::DrawInstanced);
+  AddCommand(ezGALNullCommandType::DrawInstanced, nullptr, uiVertexCountPerInstance, uiInstanceCount, uiStartVertex);
+}
+
+void ezGALContextNull::DrawInstancedIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes)
+{
+  ValidateDraw(ezGALNullCommandType::DrawInstancedIndirect);
+  AddCommand(ezGALNullCommandType::DrawInstancedIndirect, pIndirectArgumentBuffer, uiArgumentOffsetInBytes);
+}
+
+void ezGALContextNull::DrawAutoPlatform()
+{
+  ValidateDraw(ezGALNullCommandType::DrawAuto);
+  AddCommand(ezGALNullCommandType::DrawAuto);
+}
+
+void ezGALContextNull::BeginStreamOutPlatform()
+{
+  AddCommand(ezGALNullCommandType::BeginStreamOut);
+}
+
+void ezGALContextNull::EndStreamOutPlatform()
+{
+  AddCommand(ezGALNullCommandType::EndStreamOut);
+}
+
+// Dispatch
+
+void ezGALContextNull::DispatchPlatform(ezUInt32 uiThreadGroupCountX, ezUInt32 uiThreadGroupCountY, ezUInt32 uiThreadGroupCountZ)
+{
+  ValidateDispatch(ezGALNullCommandType::Dispatch);
+  AddCommand(ezGALNullCommandType::Dispatch, nullptr, uiThreadGroupCountX, uiThreadGroupCountY, uiThreadGroupCountZ);
+}
+
+void ezGALContextNull::DispatchIndirectPlatform(const ezGALBuffer* pIndirectArgumentBuffer, ezUInt32 uiArgumentOffsetInBytes)
+{
+  ValidateDispatch(ezGALNullCommandType::DispatchIndirect);
+  AddCommand(ezGALNullCommandType::DispatchIndirect, pIndirectArgumentBuffer, uiArgumentOffsetInBytes);
+}
+
+// State setting functions
+
+void ezGALContextNull::SetShaderPlatform(const ezGALShader* pShader)
+{
+  m_pBoundShader = pShader;
+  AddCommand(ezGALNullCommandType::SetShader, pShader);
+}
+
+void ezGALContextNull::SetIndexBufferPlatform(const ezGALBuffer* pIndexBuffer)
+{
+  m_pBoundIndexBuffer = static_cast<const ezGALBufferNull*>(pIndexBuffer);
+  AddCommand(ezGALNullCommandType::SetIndexBuffer, pIndexBuffer);
+}
+
+void ezGALContextNull::SetVertexBufferPlatform(ezUInt32 uiSlot, const ezGALBuffer* pVertexBuffer)
+{
+  if (pVertexBuffer != nullptr)
+    m_uiBoundVertexBufferMask |= EZ_BIT(uiSlot);
+  else
+    m_uiBoundVertexBufferMask &= ~EZ_BIT(uiSlot);
+
+  AddCommand(ezGALNullCommandType::SetVertexBuffer, pVertexBuffer, uiSlot);
+}
+
+void ezGALContextNull::SetVertexDeclarationPlatform(const ezGALVertexDeclaration* pVertexDeclaration)
+{
+  m_pBoundVertexDeclaration = pVertexDeclaration;
+  AddCommand(ezGALNullCommandType::SetVertexDeclaration, pVertexDeclaration);
+}
+
+void ezGALContextNull::SetPrimitiveTopologyPlatform(ezGALPrimitiveTopology::Enum Topology)
+{
+  AddCommand(ezGALNullCommandType::SetPrimitiveTopology, nullptr, Topology);
+}
+
+void ezGALContextNull::SetConstantBufferPlatform(ezUInt32 uiSlot, const ezGALBuffer* pBuffer)
+{
+  AddCommand(ezGALNullCommandType::SetConstantBuffer, pBuffer, uiSlot);
+}
+
+void ezGALContextNull::SetSamplerStatePlatform(ezGALShaderStage::Enum Stage, ezUInt32 uiSlot, const ezGALSamplerState* pSamplerState)
+{
+  AddCommand(ezGALNullCommandType::SetSamplerState, pSamplerState, Stage, uiSlot);
+}
+
+void ezGALContextNull::SetResourceViewPlatform(ezGALShaderStage::Enum Stage, ezUInt32 uiSlot, const ezGALResourceView* pResourceView)
+{
+  AddCommand(ezGALNullCommandType::SetResourceView, pResourceView, Stage, uiSlot);
+}
+
+void ezGALContextNull::SetRenderTargetSetupPlatform(
+  ezArrayPtr<const ezGALRenderTargetView*> pRenderTargetViews, const ezGALRenderTargetView* pDepthStencilView)
+{
+  m_uiBoundRenderTargetCount = 0;
+  for (const ezGALRenderTargetView* pView : pRenderTargetViews)
+  {
+    if (pView != nullptr)
+      ++m_uiBoundRenderTargetCount;
+  }
+
+  m_bDepthStencilBound = pDepthStencilView != nullptr;
+
+  AddCommand(ezGALNullCommandType::SetRenderTargetSetup, pDepthStencilView, pRenderTargetViews.GetCount());
+}
+
+void ezGALContextNull::SetUnorderedAccessViewPlatform(ezUInt32 uiSlot, const ezGALUnorderedAccessView* pUnorderedAccessView)
+{
+  AddCommand(ezGALNullCommandType::SetUnorderedAccessView, pUnorderedAccessView, uiSlot);
+}
+
+void ezGALContextNull::SetBlendStatePlatform(const ezGALBlendState* pBlendState, const ezColor& BlendFactor, ezUInt32 uiSampleMask)
+{
+  AddCommand(ezGALNullCommandType::SetBlendState, pBlendState, uiSampleMask);
+}
+
+void ezGALContextNull::SetDepthStencilStatePlatform(const ezGALDepthStencilState* pDepthStencilState, ezUInt8 uiStencilRefValue)
+{
+  AddCommand(ezGALNullCommandType::SetDepthStencilState, pDepthStencilState, uiStencilRefValue);
+}
+
+void ezGALContextNull::SetRasterizerStatePlatform(const ezGALRasterizerState* pRasterizerState)
+{
+  AddCommand(ezGALNullCommandType::SetRasterizerState, pRasterizerState);
+}
+
+void ezGALContextNull::SetViewportPlatform(const ezRectFloat& rect, float fMinDepth, float fMaxDepth)
+{
+  if (rect.width <= 0.0f || rect.height <= 0.0f)
+  {
+    ReportError(ezGALNullCommandType::SetViewport, "Viewport is empty");
+  }
+
+  AddCommand(ezGALNullCommandType::SetViewport, nullptr, static_cast<ezUInt32>(rect.width), static_cast<ezUInt32>(rect.height));
+}
+
+void ezGALContextNull::SetScissorRectPlatform(const ezRectU32& rect)
+{
+  AddCommand(ezGALNullCommandType::SetScissorRect, nullptr, rect.width, rect.height);
+}
+
+void ezGALContextNull::SetStreamOutBufferPlatform(ezUInt32 uiSlot, const ezGALBuffer* pBuffer, ezUInt32 uiOffset)
+{
+  AddCommand(ezGALNullCommandType::SetStreamOutBuffer, pBuffer, uiSlot, uiOffset);
+}
+
+// Fence & Query functions
+
+void ezGALContextNull::InsertFencePlatform(const ezGALFence* pFence)
+{
+  AddCommand(ezGALNullCommandType::InsertFence, pFence);
+}
+
+bool ezGALContextNull::IsFenceReachedPlatform(const ezGALFence* pFence)
+{
+  return true;
+}
+
+void ezGALContextNull::WaitForFencePlatform(const ezGALFence* pFence) {}
+
+void ezGALContextNull::BeginQueryPlatform(const ezGALQuery* pQuery)
+{
+  AddCommand(ezGALNullCommandType::BeginQuery, pQuery);
+}
+
+void ezGALContextNull::EndQueryPlatform(const ezGALQuery* pQuery)
+{
+  AddCommand(ezGALNullCommandType::EndQuery, pQuery);
+}
+
+ezResult ezGALContextNull::GetQueryResultPlatform(const ezGALQuery* pQuery, ezUInt64& uiQueryResult)
+{
+  uiQueryResult = 0;
+  return EZ_SUCCESS;
+}
+
+// Timestamp functions
+
+void ezGALContextNull::InsertTimestampPlatform(ezGALTimestampHandle hTimestamp)
+{
+  static_cast<ezGALDeviceNull*>(GetDevice())->SetTimestamp(hTimestamp, ezTime::Now());
+
+  AddCommand(ezGALNullCommandType::InsertTimestamp, nullptr, static_cast<ezUInt32>(hTimestamp.m_uiIndex));
+}
+
+// Resource update functions
+
+void ezGALContextNull::CopyBufferPlatform(const ezGALBuffer* pDestination, const ezGALBuffer* pSource)
+{
+  if (pDestination->GetSize() != pSource->GetSize())
+  {
+    ReportError(ezGALNullCommandType::CopyBuffer, "Source and destination buffer have different sizes");
+  }
+
+  AddCommand(ezGALNullCommandType::CopyBuffer, pDestination, pSource->GetSize());
+}
+
+void ezGALContextNull::CopyBufferRegionPlatform(
+  const ezGALBuffer* pDestination, ezUInt32 uiDestOffset, const ezGALBuffer* pSource, ezUInt32 uiSourceOffset, ezUInt32 uiByteCount)
+{
+  if (uiDestOffset + uiByteCount > pDestination->GetSize() || uiSourceOffset + uiByteCount > pSource->GetSize())
+  {
+    ReportError(ezGALNullCommandType::CopyBufferRegion, "Region is out of bounds");
+  }
+
+  AddCommand(ezGALNullCommandType::CopyBufferRegion, pDestination, uiDestOffset, uiSourceOffset, uiByteCount);
+}
+
+void ezGALContextNull::UpdateBufferPlatform(
+  const ezGALBuffer* pDestination, ezUInt32 uiDestOffset, ezArrayPtr<const ezUInt8> pSourceData, ezGALUpdateMode::Enum updateMode)
+{
+  if (pDestination->GetDescription().m_ResourceAccess.IsImmutable())
+  {
+    ReportError(ezGALNullCommandType::UpdateBuffer, "Buffer is immutable");
+  }
+
+  m_Statistics.m_uiUpdatedBufferBytes += pSourceData.GetCount();
+
+  AddCommand(ezGALNullCommandType::UpdateBuffer, pDestination, uiDestOffset, pSourceData.GetCount(), updateMode);
+}
+
+void ezGALContextNull::CopyTexturePlatform(const ezGALTexture* pDestination, const ezGALTexture* pSource)
+{
+  AddCommand(ezGALNullCommandType::CopyTexture, pDestination);
+}
+
+void ezGALContextNull::CopyTextureRegionPlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& DestinationSubResource,
+  const ezVec3U32& DestinationPoint, const ezGALTexture* pSource, const ezGALTextureSubresource& SourceSubResource, const ezBoundingBoxu32& Box)
+{
+  AddCommand(ezGALNullCommandType::CopyTextureRegion, pDestination);
+}
+
+void ezGALContextNull::UpdateTexturePlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& DestinationSubResource,
+  const ezBoundingBoxu32& DestinationBox, const ezGALSystemMemoryDescription& pSourceData)
+{
+  AddCommand(ezGALNullCommandType::UpdateTexture, pDestination);
+}
+
+void ezGALContextNull::ResolveTexturePlatform(const ezGALTexture* pDestination, const ezGALTextureSubresource& DestinationSubResource,
+  const ezGALTexture* pSource, const ezGALTextureSubresource& SourceSubResource)
+{
+  AddCommand(ezGALNullCommandType::ResolveTexture, pDestination);
+}
+
+void ezGALContextNull::ReadbackTexturePlatform(const ezGALTexture* pTexture)
+{
+  if (!pTexture->GetDescription().m_ResourceAccess.m_bReadBack)
+  {
+    ReportError(ezGALNullCommandType::ReadbackTexture, "Texture was not created with read back access");
+  }
+
+  AddCommand(ezGALNullCommandType::ReadbackTexture, pTexture);
+}
+
+void ezGALContextNull::CopyTextureReadbackResultPlatform(const ezGALTexture* pTexture, const ezArrayPtr<ezGALSystemMemoryDescription>* pData)
+{
+  const ezGALTextureCreationDescription& desc = pTexture->GetDescription();
+  const ezUInt32 uiRowSize = ezGALResourceFormat::GetBitsPerElement(desc.m_Format) * desc.m_uiWidth / 8;
+
+  for (ezUInt32 y = 0; y < desc.m_uiHeight; ++y)
+  {
+    void* pDest = ezMemoryUtils::AddByteOffset((*pData)[0].m_pData, y * (*pData)[0].m_uiRowPitch);
+    ezMemoryUtils::ZeroFill(static_cast<ezUInt8*>(pDest), uiRowSize);
+  }
+}
+
+void ezGALContextNull::GenerateMipMapsPlatform(const ezGALResourceView* pResourceView)
+{
+  AddCommand(ezGALNullCommandType::GenerateMipMaps, pResourceView);
+}
+
+// Misc
+
+void ezGALContextNull::FlushPlatform()
+{
+  AddCommand(ezGALNullCommandType::Flush);
+}
+
+void ezGALContextNull::ExecuteDeferredContextPlatform(ezGALContext* pDeferredContext)
+{
+  ezGALContextNull* pDeferredContextNull = static_cast<ezGALContextNull*>(pDeferredContext);
+
+  if (pDeferredContextNull->m_uiMarkerDepth != 0)
+  {
+    ezLog::Error("ezGALContextNull: A deferred context was executed with {0} unmatched PushMarker calls", pDeferredContextNull->m_uiMarkerDepth);
+    ++m_Statistics.m_uiValidationErrors;
+  }
+
+  const Statistics& deferredStats = pDeferredContextNull->m_Statistics;
+  for (ezUInt32 i = 0; i < ezGALNullCommandType::ENUM_COUNT; ++i)
+  {
+    m_Statistics.m_uiCommandCounts[i] += deferredStats.m_uiCommandCounts[i];
+  }
+  m_Statistics.m_uiUpdatedBufferBytes += deferredStats.m_uiUpdatedBufferBytes;
+  m_Statistics.m_uiValidationErrors += deferredStats.m_uiValidationErrors;
+
+  if (m_bRecordCommands)
+  {
+    m_RecordedCommands.PushBackRange(pDeferredContextNull->m_RecordedCommands);
+  }
+
+  // A deferred context starts without any bound state after it has been executed
+  pDeferredContextNull->m_RecordedCommands.Clear();
+  pDeferredContextNull->m_Statistics = Statistics();
+  pDeferredContextNull->m_pBoundShader = nullptr;
+  pDeferredContextNull->m_pBoundIndexBuffer = nullptr;
+  pDeferredContextNull->m_pBoundVertexDeclaration = nullptr;
+  pDeferredContextNull->m_uiBoundVertexBufferMask = 0;
+  pDeferredContextNull->m_uiBoundRenderTargetCount = 0;
+  pDeferredContextNull->m_bDepthStencilBound = false;
+  pDeferredContextNull->m_uiMarkerDepth = 0;
+}
+
+// Debug helper functions
+
+void ezGALContextNull::PushMarkerPlatform(const char* Marker)
+{
+  ++m_uiMarkerDepth;
+}
+
+void ezGALContextNull::PopMarkerPlatform()
+{
+  if (m_uiMarkerDepth == 0)
+  {
+    ezLog::Error("ezGALContextNull: PopMarker was called without a matching PushMarker");
+    ++m_Statistics.m_uiValidationErrors;
+    return;
+  }
+
+  --m_uiMarkerDepth;
+}
+
+void ezGALContextNull::InsertEventMarkerPlatform(const char* Marker) {}
+
+void ezGALContextNull::AddCommand(ezGALNullCommandType::Enum type, const void* pObject, ezUInt32 uiArg0, ezUInt32 uiArg1, ezUInt32 uiArg2)
+{
+  ++m_Statistics.m_uiCommandCounts[type];
+
+  if (m_bRecordCommands || (IsDeferred() && GetDevice()->GetPrimaryContext<ezGALContextNull>()->m_bRecordCommands))
+  {
+    ezGALNullCommand& command = m_RecordedCommands.ExpandAndGetRef();
+    command.m_Type = type;
+    command.m_pObject = pObject;
+    command.m_uiArgs[0] = uiArg0;
+    command.m_uiArgs[1] = uiArg1;
+    command.m_uiArgs[2] = uiArg2;
+  }
+}
+
+void ezGALContextNull::ReportError(ezGALNullCommandType::Enum type, const char* szMessage)
+{
+  ++m_Statistics.m_uiValidationErrors;
+
+  if (GetDevice()->GetDescription()->m_bDebugDevice)
+  {
+    ezLog::Error("ezGALContextNull: {0} failed validation: {1}", ezGALNullCommandType::GetName(type), szMessage);
+  }
+}
+
+void ezGALContextNull::ValidateDraw(ezGALNullCommandType::Enum type)
+{
+  if (m_pBoundShader == nullptr || !m_pBoundShader->GetDescription().HasByteCodeForStage(ezGALShaderStage::VertexShader))
+  {
+    ReportError(type, "No shader with a vertex stage is bound");
+  }
+
+  if (GetPrimitiveTopology() == ezGALPrimitiveTopology::ENUM_COUNT)
+  {
+    ReportError(type, "No primitive topology is set");
+  }
+
+  if (m_uiBoundVertexBufferMask != 0 && m_pBoundVertexDeclaration == nullptr)
+  {
+    ReportError(type, "Vertex buffers are bound without a vertex declaration");
+  }
+
+  if (m_uiBoundRenderTargetCount == 0 && !m_bDepthStencilBound)
+  {
+    ReportError(type, "No render target is bound");
+  }
+}
+
+void ezGALContextNull::ValidateIndexRange(ezGALNullCommandType::Enum type, ezUInt32 uiIndexCount, ezUInt32 uiStartIndex)
+{
+  if (m_pBoundIndexBuffer == nullptr)
+  {
+    ReportError(type, "No index buffer is bound");
+  }
+  else if (uiStartIndex + uiIndexCount > m_pBoundIndexBuffer->GetElementCount())
+  {
+    ReportError(type, "Index range is out of bounds of the bound index buffer");
+  }
+}
+
+void ezGALContextNull::ValidateDispatch(ezGALNullCommandType::Enum type)
+{
+  if (m_pBoundShader == nullptr || !m_pBoundShader->GetDescription().HasByteCodeForStage(ezGALShaderStage::ComputeShader))
+  {
+    ReportError(type, "No shader with a compute stage is bound");
+  }
+}
+
+EZ_STATICLINK_FILE(RendererNull, RendererNull_Context_Implementation_ContextNull);
@@ -0,0 +1,417 @@
+#include <RendererNullPCH.h>
+
+#include <RendererNull/Context/ContextNull.h>
+#include <RendererNull/Device/DeviceNull.h>
+#include <RendererNull/Device/SwapChainNull.h>
+#include <RendererNull/Resources/ResourcesNull.h>
+#include <RendererNull/Shader/ShaderNull.h>
+#include <RendererNull/State/StateNull.h>
+
+ezGALDeviceNull::ezGALDeviceNull(const ezGALDeviceCreationDescription& Description)
+  : ezGALDevice(Description)
+{
+}
+
+ezGALDeviceNull::~ezGALDeviceNull() = default;
+
+// Init & shutdown functions
+
+ezResult ezGALDeviceNull::InitPlatform()
+{
+  EZ_LOG_BLOCK("ezGALDeviceNull::InitPlatform");
+
+  m_pPrimaryContext = EZ_NEW(&m_Allocator, ezGALContextNull, this);
+  EZ_ASSERT_RELEASE(m_pPrimaryContext != nullptr, "Couldn't create primary context!");
+
+  // Use the same conventions as DX11 since the shaders are precompiled for it
+  ezClipSpaceDepthRange::Default = ezClipSpaceDepthRange::ZeroToOne;
+
+  m_Timestamps.SetCount(1024);
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALDeviceNull::ShutdownPlatform()
+{
+  m_Timestamps.Clear();
+
+  EZ_DELETE(&m_Allocator, m_pPrimaryContext);
+
+  return EZ_SUCCESS;
+}
+
+
+// State creation functions
+
+ezGALBlendState* ezGALDeviceNull::CreateBlendStatePlatform(const ezGALBlendStateCreationDescription& Description)
+{
+  ezGALBlendStateNull* pBlendStateNull = EZ_NEW(&m_Allocator, ezGALBlendStateNull, Description);
+
+  if (pBlendStateNull->InitPlatform(this).Failed())
+  {
+    EZ_DELETE(&m_Allocator, pBlendStateNull);
+    return nullptr;
+  }
+
+  return pBlendStateNull;
+}
+
+void ezGALDeviceNull::DestroyBlendStatePlatform(ezGALBlendState* pBlendState)
+{
+  ezGALBlendStateNull* pBlendStateNull = static_cast<ezGALBlendStateNull*>(pBlendState);
+  pBlendStateNull->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pBlendStateNull);
+}
+
+ezGALDepthStencilState* ezGALDeviceNull::CreateDepthStencilStatePlatform(const ezGALDepthStencilStateCreationDescription& Description)
+{
+  ezGALDepthStencilStateNull* pDepthStencilStateNull = EZ_NEW(&m_Allocator, ezGALDepthStencilStateNull, Description);
+
+  if (pDepthStencilStateNull->InitPlatform(this).Failed())
+  {
+    EZ_DELETE(&m_Allocator, pDepthStencilStateNull);
+    return nullptr;
+  }
+
+  return pDepthStencilStateNull;
+}
+
+void ezGALDeviceNull::DestroyDepthStencilStatePlatform(ezGALDepthStencilState* pDepthStencilState)
+{
+  ezGALDepthStencilStateNull* pDepthStencilStateNull = static_cast<ezGALDepthStencilStateNull*>(pDepthStencilState);
+  pDepthStencilStateNull->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pDepthStencilStateNull);
+}
+
+ezGALRasterizerState* ezGALDeviceNull::CreateRasterizerStatePlatform(const ezGALRasterizerStateCreationDescription& Description)
+{
+  ezGALRasterizerStateNull* pRasterizerStateNull = EZ_NEW(&m_Allocator, ezGALRasterizerStateNull, Description);
+
+  if (pRasterizerStateNull->InitPlatform(this).Failed())
+  {
+    EZ_DELETE(&m_Allocator, pRasterizerStateNull);
+    return nullptr;
+  }
+
+  return pRasterizerStateNull;
+}
+
+void ezGALDeviceNull::DestroyRasterizerStatePlatform(ezGALRasterizerState* pRasterizerState)
+{
+  ezGALRasterizerStateNull* pRasterizerStateNull = static_cast<ezGALRasterizerStateNull*>(pRasterizerState);
+  pRasterizerStateNull->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pRasterizerStateNull);
+}
+
+ezGALSamplerState* ezGALDeviceNull::CreateSamplerStatePlatform(const ezGALSamplerStateCreationDescription& Description)
+{
+  ezGALSamplerStateNull* pSamplerStateNull = EZ_NEW(&m_Allocator, ezGALSamplerStateNull, Description);
+
+  if (pSamplerStateNull->InitPlatform(this).Failed())
+  {
+    EZ_DELETE(&m_Allocator, pSamplerStateNull);
+    return nullptr;
+  }
+
+  return pSamplerStateNull;
+}
+
+void ezGALDeviceNull::DestroySamplerStatePlatform(ezGALSamplerState* pSamplerState)
+{
+  ezGALSamplerStateNull* pSamplerStateNull = static_cast<ezGALSamplerStateNull*>(pSamplerState);
+  pSamplerStateNull->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pSamplerStateNull);
+}
+
+// Resource creation functions
+
+ezGALShader* ezGALDeviceNull::CreateShaderPlatform(const ezGALShaderCreationDescription& Description)
+{
+  ezGALShaderNull* pShaderNull = EZ_NEW(&m_Allocator, ezGALShaderNull, Description);
+
+  if (pShaderNull->InitPlatform(this).Failed())
+  {
+    EZ_DELETE(&m_Allocator, pShaderNull);
+    return nullptr;
+  }
+
+  return pShaderNull;
+}
+
+void ezGALDeviceNull::DestroyShaderPlatform(ezGALShader* pShader)
+{
+  ezGALShaderNull* pShaderNull = static_cast<ezGALShaderNull*>(pShader);
+  pShaderNull->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pShaderNull);
+}
+
+ezGALBuffer* ezGALDeviceNull::CreateBufferPlatform(const ezGALBufferCreationDescription& Description, ezArrayPtr<const ezUInt8> pInitialData)
+{
+  ezGALBufferNull* pBufferNull = EZ_NEW(&m_Allocator, ezGALBufferNull, Description);
+
+  if (pBufferNull->InitPlatform(this, pInitialData).Failed())
+  {
+    EZ_DELETE(&m_Allocator, pBufferNull);
+    return nullptr;
+  }
+
+  return pBufferNull;
+}
+
+void ezGALDeviceNull::DestroyBufferPlatform(ezGALBuffer* pBuffer)
+{
+  ezGALBufferNull* pBufferNull = static_cast<ezGALBufferNull*>(pBuffer);
+  pBufferNull->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pBufferNull);
+}
+
+ezGALTexture* ezGALDeviceNull::CreateTexturePlatform(const ezGALTextureCreationDescription& Description, ezArrayPtr<ezGALSystemMemoryDescription> pInitialData)
+{
+  ezGALTextureNull* pTextureNull = EZ_NEW(&m_Allocator, ezGALTextureNull, Description);
+
+  if (pTextureNull->InitPlatform(this, pInitialData).Failed())
+  {
+    EZ_DELETE(&m_Allocator, pTextureNull);
+    return nullptr;
+  }
+
+  return pTextureNull;
+}
+
+void ezGALDeviceNull::DestroyTexturePlatform(ezGALTexture* pTexture)
+{
+  ezGALTextureNull* pTextureNull = static_cast<ezGALTextureNull*>(pTexture);
+  pTextureNull->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pTextureNull);
+}
+
+ezGALResourceView* ezGALDeviceNull::CreateResourceViewPlatform(ezGALResourceBase* pResource, const ezGALResourceViewCreationDescription& Description)
+{
+  ezGALResourceViewNull* pResourceViewNull = EZ_NEW(&m_Allocator, ezGALResourceViewNull, pResource, Description);
+
+  if (pResourceViewNull->InitPlatform(this).Failed())
+  {
+    EZ_DELETE(&m_Allocator, pResourceViewNull);
+    return nullptr;
+  }
+
+  return pResourceViewNull;
+}
+
+void ezGALDeviceNull::DestroyResourceViewPlatform(ezGALResourceView* pResourceView)
+{
+  ezGALResourceViewNull* pResourceViewNull = static_cast<ezGALResourceViewNull*>(pResourceView);
+  pResourceViewNull->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pResourceViewNull);
+}
+
+ezGALRenderTargetView* ezGALDeviceNull::CreateRenderTargetViewPlatform(ezGALTexture* pTexture, const ezGALRenderTargetViewCreationDescription& Description)
+{
+  ezGALRenderTargetViewNull* pRenderTargetViewNull = EZ_NEW(&m_Allocator, ezGALRenderTargetViewNull, pTexture, Description);
+
+  if (pRenderTargetViewNull->InitPlatform(this).Failed())
+  {
+    EZ_DELETE(&m_Allocator, pRenderTargetViewNull);
+    return nullptr;
+  }
+
+  return pRenderTargetViewNull;
+}
+
+void ezGALDeviceNull::DestroyRenderTargetViewPlatform(ezGALRenderTargetView* pRenderTargetView)
+{
+  ezGALRenderTargetViewNull* pRenderTargetViewNull = static_cast<ezGALRenderTargetViewNull*>(pRenderTargetView);
+  pRenderTargetViewNull->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pRenderTargetViewNull);
+}
+
+ezGALUnorderedAccessView* ezGALDeviceNull::CreateUnorderedAccessViewPlatform(ezGALResourceBase* pResource, const ezGALUnorderedAccessViewCreationDescription& Description)
+{
+  ezGALUnorderedAccessViewNull* pUnorderedAccessViewNull = EZ_NEW(&m_Allocator, ezGALUnorderedAccessViewNull, pResource, Description);
+
+  if (pUnorderedAccessViewNull->InitPlatform(this).Failed())
+  {
+    EZ_DELETE(&m_Allocator, pUnorderedAccessViewNull);
+    return nullptr;
+  }
+
+  return pUnorderedAccessViewNull;
+}
+
+void ezGALDeviceNull::DestroyUnorderedAccessViewPlatform(ezGALUnorderedAccessView* pUnorderedAccessView)
+{
+  ezGALUnorderedAccessViewNull* pUnorderedAccessViewNull = static_cast<ezGALUnorderedAccessViewNull*>(pUnorderedAccessView);
+  pUnorderedAccessViewNull->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pUnorderedAccessViewNull);
+}
+
+// Other rendering creation functions
+
+ezGALSwapChain* ezGALDeviceNull::CreateSwapChainPlatform(const ezGALSwapChainCreationDescription& Description)
+{
+  ezGALSwapChainNull* pSwapChainNull = EZ_NEW(&m_Allocator, ezGALSwapChainNull, Description);
+
+  if (pSwapChainNull->InitPlatform(this).Failed())
+  {
+    EZ_DELETE(&m_Allocator, pSwapChainNull);
+    return nullptr;
+  }
+
+  return pSwapChainNull;
+}
+
+void ezGALDeviceNull::DestroySwapChainPlatform(ezGALSwapChain* pSwapChain)
+{
+  ezGALSwapChainNull* pSwapChainNull = static_cast<ezGALSwapChainNull*>(pSwapChain);
+  pSwapChainNull->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pSwapChainNull);
+}
+
+ezGALFence* ezGALDeviceNull::CreateFencePlatform()
+{
+  ezGALFenceNull* pFenceNull = EZ_NEW(&m_Allocator, ezGALFenceNull);
+
+  if (pFenceNull->InitPlatform(this).Failed())
+  {
+    EZ_DELETE(&m_Allocator, pFenceNull);
+    return nullptr;
+  }
+
+  return pFenceNull;
+}
+
+void ezGALDeviceNull::DestroyFencePlatform(ezGALFence* pFence)
+{
+  ezGALFenceNull* pFenceNull = static_cast<ezGALFenceNull*>(pFence);
+  pFenceNull->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pFenceNull);
+}
+
+ezGALQuery* ezGALDeviceNull::CreateQueryPlatform(const ezGALQueryCreationDescription& Description)
+{
+  ezGALQueryNull* pQueryNull = EZ_NEW(&m_Allocator, ezGALQueryNull, Description);
+
+  if (pQueryNull->InitPlatform(this).Failed())
+  {
+    EZ_DELETE(&m_Allocator, pQueryNull);
+    return nullptr;
+  }
+
+  return pQueryNull;
+}
+
+void ezGALDeviceNull::DestroyQueryPlatform(ezGALQuery* pQuery)
+{
+  ezGALQueryNull* pQueryNull = static_cast<ezGALQueryNull*>(pQuery);
+  pQueryNull->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pQueryNull);
+}
+
+ezGALVertexDeclaration* ezGALDeviceNull::CreateVertexDeclarationPlatform(const ezGALVertexDeclarationCreationDescription& Description)
+{
+  ezGALVertexDeclarationNull* pVertexDeclarationNull = EZ_NEW(&m_Allocator, ezGALVertexDeclarationNull, Description);
+
+  if (pVertexDeclarationNull->InitPlatform(this).Failed())
+  {
+    EZ_DELETE(&m_Allocator, pVertexDeclarationNull);
+    return nullptr;
+  }
+
+  return pVertexDeclarationNull;
+}
+
+void ezGALDeviceNull::DestroyVertexDeclarationPlatform(ezGALVertexDeclaration* pVertexDeclaration)
+{
+  ezGALVertexDeclarationNull* pVertexDeclarationNull = static_cast<ezGALVertexDeclarationNull*>(pVertexDeclaration);
+  pVertexDeclarationNull->DeInitPlatform(this);
+  EZ_DELETE(&m_Allocator, pVertexDeclarationNull);
+}
+
+// Timestamp functions
+
+ezGALTimestampHandle ezGALDeviceNull::GetTimestampPlatform()
+{
+  ezUInt32 uiIndex = m_uiNextTimestamp;
+  m_uiNextTimestamp = (m_uiNextTimestamp + 1) % m_Timestamps.GetCount();
+  return {uiIndex, m_uiFrameCounter};
+}
+
+ezResult ezGALDeviceNull::GetTimestampResultPlatform(ezGALTimestampHandle hTimestamp, ezTime& result)
+{
+  const Timestamp& timestamp = m_Timestamps[static_cast<ezUInt32>(hTimestamp.m_uiIndex)];
+
+  // The slot has been re-used in the meantime
+  if (timestamp.m_uiFrame != hTimestamp.m_uiFrameCounter)
+  {
+    return EZ_FAILURE;
+  }
+
+  result = timestamp.m_Time;
+  return EZ_SUCCESS;
+}
+
+void ezGALDeviceNull::SetTimestamp(ezGALTimestampHandle hTimestamp, ezTime time)
+{
+  Timestamp& timestamp = m_Timestamps[static_cast<ezUInt32>(hTimestamp.m_uiIndex)];
+  timestamp.m_Time = time;
+  timestamp.m_uiFrame = hTimestamp.m_uiFrameCounter;
+}
+
+// Swap chain functions
+
+void ezGALDeviceNull::PresentPlatform(ezGALSwapChain* pSwapChain, bool bVSync) {}
+
+// Misc functions
+
+void ezGALDeviceNull::BeginFramePlatform() {}
+
+void ezGALDeviceNull::EndFramePlatform()
+{
+  ++m_uiFrameCounter;
+}
+
+void ezGALDeviceNull::SetPrimarySwapChainPlatform(ezGALSwapChain* pSwapChain) {}
+
+ezGALContext* ezGALDeviceNull::CreateDeferredContextPlatform()
+{
+  return EZ_NEW(&m_Allocator, ezGALContextNull, this, true);
+}
+
+void ezGALDeviceNull::DestroyDeferredContextPlatform(ezGALContext* pDeferredContext)
+{
+  EZ_DELETE(&m_Allocator, pDeferredContext);
+}
+
+void ezGALDeviceNull::FillCapabilitiesPlatform()
+{
+  // Report the capabilities of a DX11.1 device, so the renderer takes the same code paths as on the GPU
+  m_Capabilities.m_sAdapterName = "Null Device";
+  m_Capabilities.m_bHardwareAccelerated = false;
+  m_Capabilities.m_bMultithreadedResourceCreation = true;
+  m_Capabilities.m_bB5G6R5Textures = true;
+  m_Capabilities.m_bNoOverwriteBufferUpdate = true;
+  m_Capabilities.m_bMultithreadedCommandRecording = true;
+
+  for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
+  {
+    m_Capabilities.m_bShaderStageSupported[stage] = true;
+  }
+
+  m_Capabilities.m_bInstancing = true;
+  m_Capabilities.m_b32BitIndices = true;
+  m_Capabilities.m_bIndirectDraw = true;
+  m_Capabilities.m_bStreamOut = true;
+  m_Capabilities.m_uiMaxConstantBuffers = EZ_GAL_MAX_CONSTANT_BUFFER_COUNT;
+  m_Capabilities.m_bTextureArrays = true;
+  m_Capabilities.m_bCubemapArrays = true;
+  m_Capabilities.m_uiMaxTextureDimension = 16384;
+  m_Capabilities.m_uiMaxCubemapDimension = 16384;
+  m_Capabilities.m_uiMax3DTextureDimension = 2048;
+  m_Capabilities.m_uiMaxAnisotropy = 16;
+  m_Capabilities.m_uiMaxRendertargets = EZ_GAL_MAX_RENDERTARGET_COUNT;
+  m_Capabilities.m_uiUAVCount = 64;
+  m_Capabilities.m_bAlphaToCoverage = true;
+  m_Capabilities.m_bConservativeRasterization = false;
+}
+
+EZ_STATICLINK_FILE(RendererNull, RendererNull_Device_Implementation_DeviceNull);
@@ -0,0 +1,178 @@
+#include <RendererNullPCH.h>
+
+#include <RendererNull/Resources/ResourcesNull.h>
+
+ezGALBufferNull::ezGALBufferNull(const ezGALBufferCreationDescription& Description)
+  : ezGALBuffer(Description)
+{
+}
+
+ezGALBufferNull::~ezGALBufferNull() = default;
+
+ezResult ezGALBufferNull::InitPlatform(ezGALDevice* pDevice, ezArrayPtr<const ezUInt8> pInitialData)
+{
+  if (m_Description.m_uiTotalSize == 0)
+  {
+    ezLog::Error("Trying to create a buffer with a size of zero.");
+    return EZ_FAILURE;
+  }
+
+  if (m_Description.m_ResourceAccess.IsImmutable() && pInitialData.IsEmpty())
+  {
+    ezLog::Error("Trying to create an immutable buffer without initial data.");
+    return EZ_FAILURE;
+  }
+
+  if (!pInitialData.IsEmpty() && pInitialData.GetCount() < m_Description.m_uiTotalSize)
+  {
+    ezLog::Error("The initial data of a buffer is too small, expected {0} bytes but got {1} bytes.", m_Description.m_uiTotalSize,
+      pInitialData.GetCount());
+    return EZ_FAILURE;
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALBufferNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+void ezGALBufferNull::SetDebugNamePlatform(const char* szName) const {}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezGALTextureNull::ezGALTextureNull(const ezGALTextureCreationDescription& Description)
+  : ezGALTexture(Description)
+{
+}
+
+ezGALTextureNull::~ezGALTextureNull() = default;
+
+ezResult ezGALTextureNull::InitPlatform(ezGALDevice* pDevice, ezArrayPtr<ezGALSystemMemoryDescription> pInitialData)
+{
+  if (m_Description.m_uiWidth == 0 || m_Description.m_uiHeight == 0 || m_Description.m_uiDepth == 0 || m_Description.m_uiMipLevelCount == 0 ||
+      m_Description.m_uiArraySize == 0)
+  {
+    ezLog::Error("Trying to create a texture with a dimension of zero.");
+    return EZ_FAILURE;
+  }
+
+  if (m_Description.m_Format == ezGALResourceFormat::Invalid)
+  {
+    ezLog::Error("Trying to create a texture with an invalid format.");
+    return EZ_FAILURE;
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALTextureNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+void ezGALTextureNull::SetDebugNamePlatform(const char* szName) const {}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezGALResourceViewNull::ezGALResourceViewNull(ezGALResourceBase* pResource, const ezGALResourceViewCreationDescription& Description)
+  : ezGALResourceView(pResource, Description)
+{
+}
+
+ezGALResourceViewNull::~ezGALResourceViewNull() = default;
+
+ezResult ezGALResourceViewNull::InitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALResourceViewNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezGALRenderTargetViewNull::ezGALRenderTargetViewNull(ezGALTexture* pTexture, const ezGALRenderTargetViewCreationDescription& Description)
+  : ezGALRenderTargetView(pTexture, Description)
+{
+}
+
+ezGALRenderTargetViewNull::~ezGALRenderTargetViewNull() = default;
+
+ezResult ezGALRenderTargetViewNull::InitPlatform(ezGALDevice* pDevice)
+{
+  if (!m_pTexture->GetDescription().m_bCreateRenderTarget)
+  {
+    ezLog::Error("Trying to create a render target view for a texture that was not created as render target.");
+    return EZ_FAILURE;
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALRenderTargetViewNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezGALUnorderedAccessViewNull::ezGALUnorderedAccessViewNull(
+  ezGALResourceBase* pResource, const ezGALUnorderedAccessViewCreationDescription& Description)
+  : ezGALUnorderedAccessView(pResource, Description)
+{
+}
+
+ezGALUnorderedAccessViewNull::~ezGALUnorderedAccessViewNull() = default;
+
+ezResult ezGALUnorderedAccessViewNull::InitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALUnorderedAccessViewNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezGALFenceNull::ezGALFenceNull() = default;
+
+ezGALFenceNull::~ezGALFenceNull() = default;
+
+ezResult ezGALFenceNull::InitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALFenceNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezGALQueryNull::ezGALQueryNull(const ezGALQueryCreationDescription& Description)
+  : ezGALQuery(Description)
+{
+}
+
+ezGALQueryNull::~ezGALQueryNull() = default;
+
+ezResult ezGALQueryNull::InitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALQueryNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+void ezGALQueryNull::SetDebugNamePlatform(const char* szName) const {}
+
+EZ_STATICLINK_FILE(RendererNull, RendererNull_Resources_Implementation_ResourcesNull);
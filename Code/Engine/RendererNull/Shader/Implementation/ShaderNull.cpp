@@ -0,0 +1,72 @@
+#include <RendererNullPCH.h>
+
+#include <RendererFoundation/Device/Device.h>
+#include <RendererNull/Shader/ShaderNull.h>
+
+ezGALShaderNull::ezGALShaderNull(const ezGALShaderCreationDescription& Description)
+  : ezGALShader(Description)
+{
+}
+
+ezGALShaderNull::~ezGALShaderNull() = default;
+
+void ezGALShaderNull::SetDebugName(const char* szName) const {}
+
+ezResult ezGALShaderNull::InitPlatform(ezGALDevice* pDevice)
+{
+  bool bHasByteCode = false;
+  for (ezUInt32 stage = 0; stage < ezGALShaderStage::ENUM_COUNT; ++stage)
+  {
+    bHasByteCode |= m_Description.HasByteCodeForStage((ezGALShaderStage::Enum)stage);
+  }
+
+  if (!bHasByteCode)
+  {
+    ezLog::Error("Trying to create a shader without byte code for any stage.");
+    return EZ_FAILURE;
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALShaderNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezGALVertexDeclarationNull::ezGALVertexDeclarationNull(const ezGALVertexDeclarationCreationDescription& Description)
+  : ezGALVertexDeclaration(Description)
+{
+}
+
+ezGALVertexDeclarationNull::~ezGALVertexDeclarationNull() = default;
+
+ezResult ezGALVertexDeclarationNull::InitPlatform(ezGALDevice* pDevice)
+{
+  const ezGALShader* pShader = pDevice->GetShader(m_Description.m_hShader);
+  if (pShader == nullptr || !pShader->GetDescription().HasByteCodeForStage(ezGALShaderStage::VertexShader))
+  {
+    ezLog::Error("Trying to create a vertex declaration for a shader without a vertex shader.");
+    return EZ_FAILURE;
+  }
+
+  for (const ezGALVertexAttribute& attribute : m_Description.m_VertexAttributes)
+  {
+    if (attribute.m_uiVertexBufferSlot >= EZ_GAL_MAX_VERTEX_BUFFER_COUNT)
+    {
+      ezLog::Error("Vertex attribute uses an invalid vertex buffer slot {0}.", attribute.m_uiVertexBufferSlot);
+      return EZ_FAILURE;
+    }
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezGALVertexDeclarationNull::DeInitPlatform(ezGALDevice* pDevice)
+{
+  return EZ_SUCCESS;
+}
+
+EZ_STATICLINK_FILE(RendererNull, RendererNull_Shader_Implementation_ShaderNull);
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <RendererFoundation/State/State.h>
+#include <RendererNull/RendererNullDLL.h>
+
+class EZ_RENDERERNULL_DLL ezGALBlendStateNull : public ezGALBlendState
+{
+protected:
+  friend class ezGALDeviceNull;
+  friend class ezMemoryUtils;
+
+  ezGALBlendStateNull(const ezGALBlendStateCreationDescription& Description);
+
+  ~ezGALBlendStateNull();
+
+  virtual ezResult InitPlatform(ezGALDevice* pDevice) override;
+
+  virtual ezResult DeInitPlatform(ezGALDevice* pDevice) override;
+};
+
+class EZ_RENDERERNULL_DLL ezGALDepthStencilStateNull : public ezGALDepthStencilState
+{
+protected:
+  friend class ezGALDeviceNull;
+  friend class ezMemoryUtils;
+
+  ezGALDepthStencilStateNull(const ezGALDepthStencilStateCreationDescription& Description);
+
+  ~ezGALDepthStencilStateNull();
+
+  virtual ezResult InitPlatform(ezGALDevice* pDevice) override;
+
+  virtual ezResult DeInitPlatform(ezGALDevice* pDevice) override;
+};
+
+class EZ_RENDERERNULL_DLL ezGALRasterizerStateNull : public ezGALRasterizerState
+{
+protected:
+  friend class ezGALDeviceNull;
+  friend class ezMemoryUtils;
+
+  ezGALRasterizerStateNull(const ezGALRasterizerStateCreationDescription& Description);
+
+  ~ezGALRasterizerStateNull();
+
+  virtual ezResult InitPlatform(ezGALDevice* pDevice) override;
+
+  virtual ezResult DeInitPlatform(ezGALDevice* pDevice) override;
+};
+
+class EZ_RENDERERNULL_DLL ezGALSamplerStateNull : public ezGALSamplerState
+{
+protected:
+  friend class ezGALDeviceNull;
+  friend class ezMemoryUtils;
+
+  ezGALSamplerStateNull(const ezGALSamplerStateCreationDescription& Description);
+
+  ~ezGALSamplerStateNull();
+
+  virtual ezResult InitPlatform(ezGALDevice* pDevice) override;
+
+  virtual ezResult DeInitPlatform(ezGALDevice* pDevice) override;
+};
@@ -1,5 +1,8 @@
 #pragma once
 
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Containers/HashTable.h>
 #include <Foundation/Math/Math.h>
 #include <Utilities/UtilitiesDLL.h>
 #include <Utilities/PathFinding/PathState.h>
@@ -11,6 +14,14 @@
 ///
 /// PathStateType must be derived from ezPathState and can be used for keeping track of certain state along a path and to modify
 /// the path search dynamically.
+///
+/// The open list is an indexed binary heap (ordered by ezPathState::m_fEstimatedCostToTarget) that supports decreasing the key of
+/// nodes that are still open, so each expansion costs O(log n) instead of a linear scan over all open nodes.
+/// All visited nodes are stored in an internal node pool that keeps its memory between searches. Reusing the same ezPathSearch
+/// object for many searches therefore avoids all allocations once the pool has grown large enough. An ezPathSearch object is not
+/// thread-safe, each thread that runs path searches should use its own instance.
+///
+/// The pointers in the PathResultData array point into that node pool and stay valid until the next search is started.
 template <typename PathStateType>
 class ezPathSearch
 {
@@ -57,21 +68,42 @@ public:
   void AddPathNode(ezInt64 iNodeIndex, const PathStateType& NewState);
 
 private:
+  static constexpr ezUInt32 NotInHeap = 0xFFFFFFFF;
+
+  /// \brief An entry in the node pool. Stores the graph node index, its path state and its position in the open list heap.
+  struct PathNode
+  {
+    ezInt64 m_iNodeIndex;
+    PathStateType m_State;
+    ezUInt32 m_uiHeapIndex;
+  };
+
   void ClearPathStates();
+  PathStateType& AddStartNode(ezInt64 iStartNodeIndex);
   ezInt64 FindBestNodeToExpand(PathStateType*& out_pPathState);
   void FillOutPathResult(ezInt64 iEndNodeIndex, ezDeque<PathResultData>& out_Path);
 
-  ezPathStateGenerator<PathStateType>* m_pStateGenerator;
+  bool IsHeapOrdered(ezUInt32 uiParent, ezUInt32 uiChild) const;
+  void HeapSwap(ezUInt32 uiHeapIndexA, ezUInt32 uiHeapIndexB);
+  void HeapPush(ezUInt32 uiPoolIndex);
+  ezUInt32 HeapPop();
+  void HeapSiftUp(ezUInt32 uiHeapIndex);
+  void HeapSiftDown(ezUInt32 uiHeapIndex);
+
+  ezPathStateGenerator<PathStateType>* m_pStateGenerator = nullptr;
+
+  /// \brief All nodes that were reached during the current search. Only cleared between searches, so the memory is reused.
+  ezDynamicArray<PathNode> m_NodePool;
 
-  ezHashTable<ezInt64, PathStateType> m_PathStates;
+  /// \brief Maps graph node indices to indices into m_NodePool.
+  ezHashTable<ezInt64, ezUInt32> m_NodeLookup;
 
-  ezDeque<ezInt64> m_StateQueue;
+  /// \brief The open list, a binary min-heap of indices into m_NodePool.
+  ezDynamicArray<ezUInt32> m_OpenHeap;
 
   ezInt64 m_iCurNodeIndex;
   PathStateType m_CurState;
 };
 
-
-
 #include <Utilities/PathFinding/Implementation/GraphSearch_inl.h>
 
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Foundation/Math/Vec2.h>
+#include <Utilities/PathFinding/GraphSearch.h>
+#include <Utilities/PathFinding/GridNavmesh.h>
+
+/// \brief A path state generator that searches through the convex areas of an ezGridNavmesh instead of through individual grid cells.
+///
+/// The node indices used with this generator are the indices of the convex areas (see ezGridNavmesh::GetAreaAt()).
+/// Since a single convex area typically covers many cells, a search on this level needs to expand far fewer nodes than a search on the
+/// grid itself. This can be used as the abstract level of a hierarchical path search: First find the sequence of areas from the start
+/// to the target area, then only refine the path on cell level through the areas of that corridor (see ezGridNavmeshAreaCorridor).
+class EZ_UTILITIES_DLL ezGridNavmeshAreaStateGenerator : public ezPathStateGenerator<ezPathState>
+{
+public:
+  /// \brief Sets the navmesh through which to search. Must be set before a search is started.
+  void SetNavmesh(const ezGridNavmesh* pNavmesh) { m_pNavmesh = pNavmesh; }
+
+  /// \brief Returns the center of the given convex area in cell coordinates.
+  static ezVec2 GetAreaCenter(const ezGridNavmesh& navmesh, ezInt32 iArea);
+
+  virtual void StartSearch(ezInt64 iStartNodeIndex, const ezPathState* pStartState, ezInt64 iTargetNodeIndex) override;
+  virtual void StartSearchForClosest(ezInt64 iStartNodeIndex, const ezPathState* pStartState) override;
+  virtual void GenerateAdjacentStates(ezInt64 iNodeIndex, const ezPathState& StartState, ezPathSearch<ezPathState>* pPathSearch) override;
+
+private:
+  const ezGridNavmesh* m_pNavmesh = nullptr;
+  bool m_bHasTarget = false;
+  ezVec2 m_vTargetCenter = ezVec2::ZeroVector();
+};
+
+/// \brief Stores which convex areas of an ezGridNavmesh are part of an area path, to restrict a cell level search to those areas.
+class EZ_UTILITIES_DLL ezGridNavmeshAreaCorridor
+{
+public:
+  /// \brief Marks all areas along the given area path as part of the corridor.
+  void SetFromAreaPath(const ezGridNavmesh& navmesh, const ezDeque<ezPathSearch<ezPathState>::PathResultData>& areaPath);
+
+  /// \brief Returns whether the given area is part of the corridor.
+  bool IsAreaInCorridor(ezInt32 iArea) const { return iArea >= 0 && (ezUInt32)iArea < m_AreaInCorridor.GetCount() && m_AreaInCorridor[iArea]; }
+
+  /// \brief Returns whether the cell at the given coordinate lies inside an area that is part of the corridor.
+  bool IsCellInCorridor(const ezGridNavmesh& navmesh, const ezVec2I32& Coord) const { return IsAreaInCorridor(navmesh.GetAreaAt(Coord)); }
+
+private:
+  ezDynamicArray<bool> m_AreaInCorridor;
+};
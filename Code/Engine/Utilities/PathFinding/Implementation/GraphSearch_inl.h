@@ -3,37 +3,122 @@
 template <typename PathStateType>
 void ezPathSearch<PathStateType>::ClearPathStates()
 {
-  m_PathStates.Clear();
-  m_StateQueue.Clear();
+  // all containers keep their memory, so repeated searches don't need to allocate anything
+  m_NodePool.Clear();
+  m_NodeLookup.Clear();
+  m_OpenHeap.Clear();
 }
 
 template <typename PathStateType>
-ezInt64 ezPathSearch<PathStateType>::FindBestNodeToExpand(PathStateType*& out_pPathState)
+PathStateType& ezPathSearch<PathStateType>::AddStartNode(ezInt64 iStartNodeIndex)
+{
+  const ezUInt32 uiPoolIndex = m_NodePool.GetCount();
+
+  PathNode& node = m_NodePool.ExpandAndGetRef();
+  node.m_iNodeIndex = iStartNodeIndex;
+  node.m_uiHeapIndex = NotInHeap;
+
+  m_NodeLookup.Insert(iStartNodeIndex, uiPoolIndex);
+
+  return node.m_State;
+}
+
+template <typename PathStateType>
+EZ_ALWAYS_INLINE bool ezPathSearch<PathStateType>::IsHeapOrdered(ezUInt32 uiParent, ezUInt32 uiChild) const
+{
+  return m_NodePool[m_OpenHeap[uiParent]].m_State.m_fEstimatedCostToTarget <= m_NodePool[m_OpenHeap[uiChild]].m_State.m_fEstimatedCostToTarget;
+}
+
+template <typename PathStateType>
+EZ_ALWAYS_INLINE void ezPathSearch<PathStateType>::HeapSwap(ezUInt32 uiHeapIndexA, ezUInt32 uiHeapIndexB)
+{
+  ezMath::Swap(m_OpenHeap[uiHeapIndexA], m_OpenHeap[uiHeapIndexB]);
+  m_NodePool[m_OpenHeap[uiHeapIndexA]].m_uiHeapIndex = uiHeapIndexA;
+  m_NodePool[m_OpenHeap[uiHeapIndexB]].m_uiHeapIndex = uiHeapIndexB;
+}
+
+template <typename PathStateType>
+void ezPathSearch<PathStateType>::HeapPush(ezUInt32 uiPoolIndex)
 {
-  float fLowestEstimation = ezMath::Infinity<float>();
-  out_pPathState = nullptr;
-  ezUInt32 iBestInQueue = 0;
+  const ezUInt32 uiHeapIndex = m_OpenHeap.GetCount();
 
-  for (ezUInt32 i = 0; i < m_StateQueue.GetCount(); ++i)
+  m_OpenHeap.PushBack(uiPoolIndex);
+  m_NodePool[uiPoolIndex].m_uiHeapIndex = uiHeapIndex;
+
+  HeapSiftUp(uiHeapIndex);
+}
+
+template <typename PathStateType>
+ezUInt32 ezPathSearch<PathStateType>::HeapPop()
+{
+  const ezUInt32 uiPoolIndex = m_OpenHeap[0];
+
+  const ezUInt32 uiLast = m_OpenHeap.GetCount() - 1;
+  if (uiLast > 0)
   {
-    const ezInt64 iNodeIndex = m_StateQueue[i];
+    HeapSwap(0, uiLast);
+  }
 
-    PathStateType* pState = &m_PathStates[iNodeIndex];
+  m_OpenHeap.PopBack();
+  m_NodePool[uiPoolIndex].m_uiHeapIndex = NotInHeap;
 
-    if (pState->m_fEstimatedCostToTarget < fLowestEstimation)
-    {
-      fLowestEstimation = pState->m_fEstimatedCostToTarget;
-      out_pPathState = pState;
-      iBestInQueue = i;
-    }
+  if (!m_OpenHeap.IsEmpty())
+  {
+    HeapSiftDown(0);
   }
 
-  EZ_ASSERT_DEV(out_pPathState != nullptr, "Implementation Error");
+  return uiPoolIndex;
+}
 
-  const ezInt64 iBestNodeIndex = m_StateQueue[iBestInQueue];
-  m_StateQueue.RemoveAtAndSwap(iBestInQueue);
+template <typename PathStateType>
+void ezPathSearch<PathStateType>::HeapSiftUp(ezUInt32 uiHeapIndex)
+{
+  while (uiHeapIndex > 0)
+  {
+    const ezUInt32 uiParent = (uiHeapIndex - 1) / 2;
 
-  return iBestNodeIndex;
+    if (IsHeapOrdered(uiParent, uiHeapIndex))
+      return;
+
+    HeapSwap(uiParent, uiHeapIndex);
+    uiHeapIndex = uiParent;
+  }
+}
+
+template <typename PathStateType>
+void ezPathSearch<PathStateType>::HeapSiftDown(ezUInt32 uiHeapIndex)
+{
+  const ezUInt32 uiCount = m_OpenHeap.GetCount();
+
+  while (true)
+  {
+    const ezUInt32 uiLeft = uiHeapIndex * 2 + 1;
+    const ezUInt32 uiRight = uiLeft + 1;
+    ezUInt32 uiSmallest = uiHeapIndex;
+
+    if (uiLeft < uiCount && !IsHeapOrdered(uiSmallest, uiLeft))
+      uiSmallest = uiLeft;
+
+    if (uiRight < uiCount && !IsHeapOrdered(uiSmallest, uiRight))
+      uiSmallest = uiRight;
+
+    if (uiSmallest == uiHeapIndex)
+      return;
+
+    HeapSwap(uiHeapIndex, uiSmallest);
+    uiHeapIndex = uiSmallest;
+  }
+}
+
+template <typename PathStateType>
+ezInt64 ezPathSearch<PathStateType>::FindBestNodeToExpand(PathStateType*& out_pPathState)
+{
+  EZ_ASSERT_DEV(!m_OpenHeap.IsEmpty(), "Implementation Error");
+
+  PathNode& node = m_NodePool[HeapPop()];
+  out_pPathState = &node.m_State;
+
+  return node.m_iNodeIndex;
 }
 
 template <typename PathStateType>
@@ -43,7 +128,10 @@ void ezPathSearch<PathStateType>::FillOutPathResult(ezInt64 iEndNodeIndex, ezDeq
 
   while (true)
   {
-    const PathStateType* pCurState = &m_PathStates[iEndNodeIndex];
+    ezUInt32 uiPoolIndex = 0;
+    EZ_VERIFY(m_NodeLookup.TryGetValue(iEndNodeIndex, uiPoolIndex), "Implementation Error");
+
+    const PathStateType* pCurState = &m_NodePool[uiPoolIndex].m_State;
 
     PathResultData r;
     r.m_iNodeIndex = iEndNodeIndex;
@@ -69,28 +157,45 @@ void ezPathSearch<PathStateType>::AddPathNode(ezInt64 iNodeIndex, const PathStat
   // ezArgF(m_pCurPathState->m_fEstimatedCostToTarget, 2), ezArgF(NewState.m_fEstimatedCostToTarget, 2));
   EZ_ASSERT_DEV(NewState.m_fEstimatedCostToTarget >= NewState.m_fCostToNode, "Unrealistic expectations will get you nowhere.");
 
-  PathStateType* pExistingState;
+  ezUInt32 uiPoolIndex = 0;
 
-  if (m_PathStates.TryGetValue(iNodeIndex, pExistingState))
+  if (m_NodeLookup.TryGetValue(iNodeIndex, uiPoolIndex))
   {
-    // state already exists in the hash table, and has a lower cost -> ignore the new state
-    if (pExistingState->m_fCostToNode <= NewState.m_fCostToNode)
+    PathNode& existing = m_NodePool[uiPoolIndex];
+
+    // state already exists in the pool, and has a lower cost -> ignore the new state
+    if (existing.m_State.m_fCostToNode <= NewState.m_fCostToNode)
       return;
 
     // incoming state is better than the existing state -> update existing state
-    *pExistingState = NewState;
-    pExistingState->m_iReachedThroughNode = m_iCurNodeIndex;
+    existing.m_State = NewState;
+    existing.m_State.m_iReachedThroughNode = m_iCurNodeIndex;
+
+    // if the node is still waiting to be expanded, restore the heap order
+    // the generator may compute the estimation arbitrarily, so the key is not guaranteed to decrease
+    if (existing.m_uiHeapIndex != NotInHeap)
+    {
+      const ezUInt32 uiHeapIndex = existing.m_uiHeapIndex;
+      HeapSiftUp(uiHeapIndex);
+      HeapSiftDown(m_NodePool[uiPoolIndex].m_uiHeapIndex);
+    }
+
     return;
   }
 
   // the state has not been reached before -> insert it
-  pExistingState = &m_PathStates[iNodeIndex];
+  uiPoolIndex = m_NodePool.GetCount();
+
+  PathNode& node = m_NodePool.ExpandAndGetRef();
+  node.m_iNodeIndex = iNodeIndex;
+  node.m_State = NewState;
+  node.m_State.m_iReachedThroughNode = m_iCurNodeIndex;
+  node.m_uiHeapIndex = NotInHeap;
 
-  *pExistingState = NewState;
-  pExistingState->m_iReachedThroughNode = m_iCurNodeIndex;
+  m_NodeLookup.Insert(iNodeIndex, uiPoolIndex);
 
   // put it into the queue of states that still need to be expanded
-  m_StateQueue.PushBack(iNodeIndex);
+  HeapPush(uiPoolIndex);
 }
 
 template <typename PathStateType>
@@ -103,13 +208,12 @@ ezResult ezPathSearch<PathStateType>::FindPath(ezInt64 iStartNodeIndex, const Pa
 
   if (iStartNodeIndex == iTargetNodeIndex)
   {
-    m_PathStates.Reserve(1);
-
-    m_PathStates[iTargetNodeIndex] = StartState;
+    PathStateType& TargetState = AddStartNode(iTargetNodeIndex);
+    TargetState = StartState;
 
     PathResultData r;
     r.m_iNodeIndex = iTargetNodeIndex;
-    r.m_pPathState = &m_PathStates[iTargetNodeIndex];
+    r.m_pPathState = &TargetState;
 
     out_Path.Clear();
     out_Path.PushBack(r);
@@ -117,9 +221,12 @@ ezResult ezPathSearch<PathStateType>::FindPath(ezInt64 iStartNodeIndex, const Pa
     return EZ_SUCCESS;
   }
 
-  m_PathStates.Reserve(10000);
+  // only allocates the first time, afterwards the memory is kept between searches
+  m_NodePool.Reserve(10000);
+  m_NodeLookup.Reserve(10000);
+  m_OpenHeap.Reserve(1000);
 
-  PathStateType& FirstState = m_PathStates[iStartNodeIndex];
+  PathStateType& FirstState = AddStartNode(iStartNodeIndex);
 
   m_pStateGenerator->StartSearch(iStartNodeIndex, &FirstState, iTargetNodeIndex);
 
@@ -128,10 +235,10 @@ ezResult ezPathSearch<PathStateType>::FindPath(ezInt64 iStartNodeIndex, const Pa
   FirstState.m_iReachedThroughNode = iStartNodeIndex;
 
   // put the start state into the to-be-expanded queue
-  m_StateQueue.PushBack(iStartNodeIndex);
+  HeapPush(0);
 
   // while the queue is not empty, expand the next node and see where that gets us
-  while (!m_StateQueue.IsEmpty())
+  while (!m_OpenHeap.IsEmpty())
   {
     PathStateType* pCurState;
     m_iCurNodeIndex = FindBestNodeToExpand(pCurState);
@@ -172,9 +279,12 @@ ezResult ezPathSearch<PathStateType>::FindClosest(ezInt64 iStartNodeIndex, const
 
   ClearPathStates();
 
-  m_PathStates.Reserve(10000);
+  // only allocates the first time, afterwards the memory is kept between searches
+  m_NodePool.Reserve(10000);
+  m_NodeLookup.Reserve(10000);
+  m_OpenHeap.Reserve(1000);
 
-  PathStateType& FirstState = m_PathStates[iStartNodeIndex];
+  PathStateType& FirstState = AddStartNode(iStartNodeIndex);
 
   m_pStateGenerator->StartSearchForClosest(iStartNodeIndex, &FirstState);
 
@@ -183,10 +293,10 @@ ezResult ezPathSearch<PathStateType>::FindClosest(ezInt64 iStartNodeIndex, const
   FirstState.m_iReachedThroughNode = iStartNodeIndex;
 
   // put the start state into the to-be-expanded queue
-  m_StateQueue.PushBack(iStartNodeIndex);
+  HeapPush(0);
 
   // while the queue is not empty, expand the next node and see where that gets us
-  while (!m_StateQueue.IsEmpty())
+  while (!m_OpenHeap.IsEmpty())
   {
     PathStateType* pCurState;
     m_iCurNodeIndex = FindBestNodeToExpand(pCurState);
@@ -0,0 +1,62 @@
+#include <UtilitiesPCH.h>
+
+#include <Utilities/PathFinding/GridNavmeshAreaSearch.h>
+
+ezVec2 ezGridNavmeshAreaStateGenerator::GetAreaCenter(const ezGridNavmesh& navmesh, ezInt32 iArea)
+{
+  const ezRectU32& r = navmesh.GetConvexArea(iArea).m_Rect;
+  return ezVec2(r.x + r.width * 0.5f, r.y + r.height * 0.5f);
+}
+
+void ezGridNavmeshAreaStateGenerator::StartSearch(ezInt64 iStartNodeIndex, const ezPathState* pStartState, ezInt64 iTargetNodeIndex)
+{
+  EZ_ASSERT_DEV(m_pNavmesh != nullptr, "No navmesh has been set.");
+
+  m_bHasTarget = true;
+  m_vTargetCenter = GetAreaCenter(*m_pNavmesh, (ezInt32)iTargetNodeIndex);
+}
+
+void ezGridNavmeshAreaStateGenerator::StartSearchForClosest(ezInt64 iStartNodeIndex, const ezPathState* pStartState)
+{
+  EZ_ASSERT_DEV(m_pNavmesh != nullptr, "No navmesh has been set.");
+
+  m_bHasTarget = false;
+}
+
+void ezGridNavmeshAreaStateGenerator::GenerateAdjacentStates(ezInt64 iNodeIndex, const ezPathState& StartState,
+                                                             ezPathSearch<ezPathState>* pPathSearch)
+{
+  const ezGridNavmesh::ConvexArea& area = m_pNavmesh->GetConvexArea((ezInt32)iNodeIndex);
+  const ezVec2 vCenter = GetAreaCenter(*m_pNavmesh, (ezInt32)iNodeIndex);
+
+  for (ezUInt32 e = 0; e < area.m_uiNumEdges; ++e)
+  {
+    const ezGridNavmesh::AreaEdge& edge = m_pNavmesh->GetAreaEdge(area.m_uiFirstEdge + e);
+    const ezVec2 vNeighborCenter = GetAreaCenter(*m_pNavmesh, edge.m_iNeighborArea);
+
+    // the centers of two distinct areas never coincide, but the costs must strictly grow, so enforce a minimum step
+    const float fStepCost = ezMath::Max((vNeighborCenter - vCenter).GetLength(), 0.01f);
+
+    ezPathState NewState;
+    NewState.m_fCostToNode = StartState.m_fCostToNode + fStepCost;
+    NewState.m_fEstimatedCostToTarget = NewState.m_fCostToNode;
+
+    if (m_bHasTarget)
+      NewState.m_fEstimatedCostToTarget += (m_vTargetCenter - vNeighborCenter).GetLength();
+
+    pPathSearch->AddPathNode(edge.m_iNeighborArea, NewState);
+  }
+}
+
+void ezGridNavmeshAreaCorridor::SetFromAreaPath(const ezGridNavmesh& navmesh, const ezDeque<ezPathSearch<ezPathState>::PathResultData>& areaPath)
+{
+  m_AreaInCorridor.Clear();
+  m_AreaInCorridor.SetCount(navmesh.GetNumConvexAreas());
+
+  for (ezUInt32 i = 0; i < areaPath.GetCount(); ++i)
+  {
+    m_AreaInCorridor[(ezUInt32)areaPath[i].m_iNodeIndex] = true;
+  }
+}
+
+EZ_STATICLINK_FILE(Utilities, Utilities_PathFinding_Implementation_GridNavmeshAreaSearch);
@@ -12,5 +12,6 @@ EZ_STATICLINK_LIBRARY(Utilities)
   EZ_STATICLINK_REFERENCE(Utilities_FileFormats_Implementation_OBJLoader);
   EZ_STATICLINK_REFERENCE(Utilities_GridAlgorithms_Implementation_Rasterization);
   EZ_STATICLINK_REFERENCE(Utilities_PathFinding_Implementation_GridNavmesh);
+  EZ_STATICLINK_REFERENCE(Utilities_PathFinding_Implementation_GridNavmeshAreaSearch);
 }
 
@@ -22,6 +22,11 @@ EZ_BEGIN_COMPONENT_TYPE(ezRcAgentComponent, 2, ezComponentMode::Dynamic)
     EZ_MEMBER_PROPERTY("WalkSpeed",m_fWalkSpeed)->AddAttributes(new ezDefaultValueAttribute(4.0f)),
   }
   EZ_END_PROPERTIES;
+  EZ_BEGIN_MESSAGEHANDLERS
+  {
+    EZ_MESSAGE_HANDLER(ezMsgRecastPathSearchResult, OnMsgPathSearchResult),
+  }
+  EZ_END_MESSAGEHANDLERS;
 }
 EZ_END_COMPONENT_TYPE
 // clang-format on
@@ -88,6 +93,7 @@ void ezRcAgentComponent::ClearTargetPosition()
   m_iFirstNextStep = 0;
   m_PathCorridor.Clear();
   m_vCurrentSteeringDirection.SetZero();
+  m_uiPathSearchRequestID = 0;
 
   if (m_PathToTargetState != ezAgentPathFindingState::HasNoTarget)
   {
@@ -122,103 +128,65 @@ ezVec3 ezRcAgentComponent::GetTargetPosition() const
 ezResult ezRcAgentComponent::FindNavMeshPolyAt(const ezVec3& vPosition, dtPolyRef& out_PolyRef, ezVec3* out_vAdjustedPosition /*= nullptr*/,
   float fPlaneEpsilon /*= 0.01f*/, float fHeightEpsilon /*= 1.0f*/) const
 {
-  ezRcPos rcPos = vPosition;
-  ezVec3 vSize(fPlaneEpsilon, fHeightEpsilon, fPlaneEpsilon);
-
-  ezRcPos resultPos;
-  dtQueryFilter filter; /// \todo Hard-coded filter
-  if (dtStatusFailed(m_pQuery->findNearestPoly(rcPos, &vSize.x, &m_QueryFilter, &out_PolyRef, resultPos)))
-    return EZ_FAILURE;
-
-  if (!ezMath::IsEqual(vPosition.x, resultPos.m_Pos[0], fPlaneEpsilon) ||
-      !ezMath::IsEqual(vPosition.y, resultPos.m_Pos[2], fPlaneEpsilon) || !ezMath::IsEqual(vPosition.z, resultPos.m_Pos[1], fHeightEpsilon))
-    return EZ_FAILURE;
-
-  if (out_vAdjustedPosition != nullptr)
-  {
-    *out_vAdjustedPosition = resultPos;
-  }
-
-  return EZ_SUCCESS;
+  return ezRecastWorldModule::FindNavMeshPolyAt(*m_pQuery, m_QueryFilter, vPosition, out_PolyRef, out_vAdjustedPosition, fPlaneEpsilon, fHeightEpsilon);
 }
 
-ezResult ezRcAgentComponent::ComputePathCorridor(dtPolyRef startPoly, dtPolyRef endPoly, bool& bFoundPartialPath)
+void ezRcAgentComponent::RequestPathToTarget()
 {
-  bFoundPartialPath = false;
-
-  ezRcPos rcStart = m_vCurrentPositionOnNavmesh;
-  ezRcPos rcEnd = m_vTargetPosition;
-
-  ezInt32 iPathCorridorLength = 0;
-
-  // make enough room
-  m_PathCorridor.SetCountUninitialized(256);
-  if (dtStatusFailed(m_pQuery->findPath(startPoly, endPoly, rcStart, rcEnd, &m_QueryFilter, m_PathCorridor.GetData(), &iPathCorridorLength,
-        (int)m_PathCorridor.GetCount())) ||
-      iPathCorridorLength <= 0)
-  {
-    m_PathCorridor.Clear();
-    return EZ_FAILURE;
-  }
-
-  // reduce to actual length
-  m_PathCorridor.SetCountUninitialized(iPathCorridorLength);
-
-  if (m_PathCorridor[iPathCorridorLength - 1] != endPoly)
-  {
-    // if this is the case, the target position cannot be reached, but we can walk close to it
-    bFoundPartialPath = true;
-  }
-
-  m_pCorridor->reset(startPoly, rcStart);
-  m_pCorridor->setCorridor(rcEnd, m_PathCorridor.GetData(), iPathCorridorLength);
+  if (m_uiPathSearchRequestID != 0)
+    return;
 
-  return EZ_SUCCESS;
+  ezRecastWorldModule* pWorldModule = static_cast<ezRcAgentComponentManager*>(GetOwningManager())->GetRecastWorldModule();
+  m_uiPathSearchRequestID = pWorldModule->RequestPathSearch(GetHandle(), GetOwner()->GetGlobalPosition(), m_vTargetPosition);
 }
 
-ezResult ezRcAgentComponent::ComputePathToTarget()
+void ezRcAgentComponent::OnMsgPathSearchResult(ezMsgRecastPathSearchResult& msg)
 {
-  const ezVec3 vStartPos = GetOwner()->GetGlobalPosition();
+  // ignore results of outdated requests
+  if (msg.m_uiRequestID != m_uiPathSearchRequestID || !m_bRecastInitialized)
+    return;
 
-  dtPolyRef startPoly;
-  if (FindNavMeshPolyAt(vStartPos, startPoly, &m_vCurrentPositionOnNavmesh).Failed())
-  {
-    m_PathToTargetState = ezAgentPathFindingState::HasTargetPathFindingFailed;
+  m_uiPathSearchRequestID = 0;
 
-    ezAgentSteeringEvent e;
-    e.m_pComponent = this;
-    e.m_Type = ezAgentSteeringEvent::ErrorOutsideNavArea;
-    m_SteeringEvents.Broadcast(e);
-    return EZ_FAILURE;
-  }
+  if (GetPathToTargetState() != ezAgentPathFindingState::HasTargetWaitingForPath)
+    return;
 
-  dtPolyRef endPoly;
-  if (FindNavMeshPolyAt(m_vTargetPosition, endPoly).Failed())
+  if (msg.m_Result != ezRecastPathSearchResult::Success)
   {
     m_PathToTargetState = ezAgentPathFindingState::HasTargetPathFindingFailed;
 
     ezAgentSteeringEvent e;
     e.m_pComponent = this;
-    e.m_Type = ezAgentSteeringEvent::ErrorInvalidTargetPosition;
+
+    switch (msg.m_Result)
+    {
+      case ezRecastPathSearchResult::ErrorStartOutsideNavMesh:
+        e.m_Type = ezAgentSteeringEvent::ErrorOutsideNavArea;
+        break;
+      case ezRecastPathSearchResult::ErrorTargetOutsideNavMesh:
+        e.m_Type = ezAgentSteeringEvent::ErrorInvalidTargetPosition;
+        break;
+      case ezRecastPathSearchResult::PartialPath:
+        /// \todo For now a partial path is considered an error
+        e.m_Type = ezAgentSteeringEvent::WarningNoFullPathToTarget;
+        break;
+      default:
+        e.m_Type = ezAgentSteeringEvent::ErrorNoPathToTarget;
+        break;
+    }
+
     m_SteeringEvents.Broadcast(e);
-    return EZ_FAILURE;
+    return;
   }
 
-  /// \todo Optimize case when endPoly is same as previously ?
-
-  bool bFoundPartialPath = false;
-  if (ComputePathCorridor(startPoly, endPoly, bFoundPartialPath).Failed() || bFoundPartialPath)
-  {
-    m_PathToTargetState = ezAgentPathFindingState::HasTargetPathFindingFailed;
+  m_vCurrentPositionOnNavmesh = msg.m_vStartPosition;
+  m_PathCorridor = msg.m_PathCorridor;
 
-    /// \todo For now a partial path is considered an error
+  ezRcPos rcStart = m_vCurrentPositionOnNavmesh;
+  ezRcPos rcEnd = m_vTargetPosition;
 
-    ezAgentSteeringEvent e;
-    e.m_pComponent = this;
-    e.m_Type = bFoundPartialPath ? ezAgentSteeringEvent::WarningNoFullPathToTarget : ezAgentSteeringEvent::ErrorNoPathToTarget;
-    m_SteeringEvents.Broadcast(e);
-    return EZ_FAILURE;
-  }
+  m_pCorridor->reset(m_PathCorridor[0], rcStart);
+  m_pCorridor->setCorridor(rcEnd, m_PathCorridor.GetData(), (int)m_PathCorridor.GetCount());
 
   m_PathToTargetState = ezAgentPathFindingState::HasTargetAndValidPath;
 
@@ -226,7 +194,8 @@ ezResult ezRcAgentComponent::ComputePathToTarget()
   e.m_pComponent = this;
   e.m_Type = ezAgentSteeringEvent::PathToTargetFound;
   m_SteeringEvents.Broadcast(e);
-  return EZ_SUCCESS;
+
+  PlanNextSteps();
 }
 
 bool ezRcAgentComponent::HasReachedPosition(const ezVec3& pos, float fMaxDistance) const
@@ -376,10 +345,9 @@ void ezRcAgentComponent::Update()
   // target is set, but no path is computed yet
   if (GetPathToTargetState() == ezAgentPathFindingState::HasTargetWaitingForPath)
   {
-    if (ComputePathToTarget().Failed())
-      return;
-
-    PlanNextSteps();
+    // the path search runs asynchronously, the result arrives through OnMsgPathSearchResult()
+    RequestPathToTarget();
+    return;
   }
 
   // from here on down, everything has to do with following a valid path
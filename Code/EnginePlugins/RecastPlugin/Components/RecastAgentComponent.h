@@ -12,6 +12,7 @@
 class ezRecastWorldModule;
 class ezPhysicsWorldModuleInterface;
 struct ezResourceEvent;
+struct ezMsgRecastPathSearchResult;
 
 //////////////////////////////////////////////////////////////////////////
 
@@ -83,9 +84,11 @@ private:
   //////////////////////////////////////////////////////////////////////////
   // Path Finding and Steering
 
+protected:
+  void OnMsgPathSearchResult(ezMsgRecastPathSearchResult& msg);
+
 private:
-  ezResult ComputePathToTarget();
-  ezResult ComputePathCorridor(dtPolyRef startPoly, dtPolyRef endPoly, bool& bFoundPartialPath);
+  void RequestPathToTarget();
   void ComputeSteeringDirection(float fMaxDistance);
   void ApplySteering(const ezVec3& vDirection, float fSpeed);
   void SyncSteeringWithReality();
@@ -98,6 +101,7 @@ private:
   ezUniquePtr<dtPathCorridor> m_pCorridor; // careful, dtPathCorridor is not moveble
   dtQueryFilter m_QueryFilter;             /// \todo hard-coded filter
   ezDynamicArray<dtPolyRef> m_PathCorridor;
+  ezUInt32 m_uiPathSearchRequestID = 0; // zero if no path search is pending
   // path following
   ezInt32 m_iFirstNextStep = 0;
   ezInt32 m_iNumNextSteps = 0;
@@ -2,6 +2,8 @@
 
 #include <Core/Utils/WorldGeoExtractionUtil.h>
 #include <Core/World/World.h>
+#include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <Foundation/Time/Stopwatch.h>
 #include <Foundation/Types/ScopeExit.h>
 #include <Foundation/Utilities/Progress.h>
@@ -28,6 +30,7 @@ EZ_BEGIN_STATIC_REFLECTED_TYPE(ezRecastConfig, ezNoBase, 1, ezRTTIDefaultAllocat
     EZ_MEMBER_PROPERTY("SampleErrorFactor", m_fDetailMeshSampleErrorFactor)->AddAttributes(new ezDefaultValueAttribute(1.0f)),
     EZ_MEMBER_PROPERTY("MaxSimplification", m_fMaxSimplificationError)->AddAttributes(new ezDefaultValueAttribute(1.3f)),
     EZ_MEMBER_PROPERTY("MaxEdgeLength", m_fMaxEdgeLength)->AddAttributes(new ezDefaultValueAttribute(4.0f)),
+    EZ_MEMBER_PROPERTY("TileSize", m_fTileSize)->AddAttributes(new ezClampValueAttribute(0.0f, ezVariant())),
   }
   EZ_END_PROPERTIES;
 }
@@ -61,6 +64,21 @@ protected:
   }
 };
 
+struct ezRecastNavMeshBuilder::TileBuildData
+{
+  ezInt32 m_iTileX = 0;
+  ezInt32 m_iTileY = 0;
+  ezDynamicArray<Triangle> m_Triangles;
+  bool m_bRebuild = true;
+  ezResult m_BuildResult = EZ_SUCCESS;
+  ezRecastNavMeshTile m_Tile;
+
+  /// The unchanged tile of the previous build. It stays in the descriptor until the whole build has succeeded.
+  ezRecastNavMeshTile* m_pPreviousTile = nullptr;
+
+  ezRecastNavMeshTile& GetResultTile() { return m_pPreviousTile != nullptr ? *m_pPreviousTile : m_Tile; }
+};
+
 ezRecastNavMeshBuilder::ezRecastNavMeshBuilder() = default;
 ezRecastNavMeshBuilder::~ezRecastNavMeshBuilder() = default;
 
@@ -83,6 +101,12 @@ ezResult ezRecastNavMeshBuilder::ExtractWorldGeometry(const ezWorld& world, ezWo
 ezResult ezRecastNavMeshBuilder::Build(const ezRecastConfig& config, const ezWorldGeoExtractionUtil::Geometry& geo,
   ezRecastNavMeshResourceDescriptor& out_NavMeshDesc, ezProgress& progress)
 {
+  if (config.m_fTileSize > 0.0f)
+  {
+    // keeps the tiles of a previous build in the descriptor, so that they can be reused
+    return BuildTiled(config, geo, out_NavMeshDesc, progress);
+  }
+
   EZ_LOG_BLOCK("ezRecastNavMeshBuilder::Build");
 
   ezProgressRange pg("Generating NavMesh", 4, true, &progress);
@@ -118,8 +142,16 @@ ezResult ezRecastNavMeshBuilder::Build(const ezRecastConfig& config, const ezWor
 
   out_NavMeshDesc.m_pNavMeshPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
 
-  if (BuildRecastPolyMesh(config, *out_NavMeshDesc.m_pNavMeshPolygons, progress).Failed())
-    return EZ_FAILURE;
+  {
+    rcConfig cfg;
+    FillOutConfig(cfg, config, m_BoundingBox);
+
+    ezProgressRange pgRange("Build Poly Mesh", 13, true, &progress);
+
+    if (BuildRecastPolyMesh(m_pRecastContext, cfg, m_Vertices, m_Triangles, m_TriangleAreaIDs, *out_NavMeshDesc.m_pNavMeshPolygons, &pgRange)
+          .Failed())
+      return EZ_FAILURE;
+  }
 
   if (!pg.BeginNextStep("Build NavMesh"))
     return EZ_FAILURE;
@@ -130,6 +162,317 @@ ezResult ezRecastNavMeshBuilder::Build(const ezRecastConfig& config, const ezWor
   return EZ_SUCCESS;
 }
 
+ezResult ezRecastNavMeshBuilder::BuildTiled(const ezRecastConfig& config, const ezWorldGeoExtractionUtil::Geometry& geo,
+  ezRecastNavMeshResourceDescriptor& inout_NavMeshDesc, ezProgress& progress)
+{
+  EZ_LOG_BLOCK("ezRecastNavMeshBuilder::BuildTiled");
+  EZ_ASSERT_DEV(config.m_fTileSize > 0.0f, "Tiled navmesh generation requires a tile size larger than zero");
+
+  ezProgressRange pg("Generating Tiled NavMesh", 4, true, &progress);
+  pg.SetStepWeighting(0, 0.05f);
+  pg.SetStepWeighting(1, 0.05f);
+  pg.SetStepWeighting(2, 0.8f);
+  pg.SetStepWeighting(3, 0.1f);
+
+  Clear();
+
+  ezUniquePtr<ezRcBuildContext> recastContext = EZ_DEFAULT_NEW(ezRcBuildContext);
+  m_pRecastContext = recastContext.Borrow();
+
+  if (!pg.BeginNextStep("Triangulate Mesh"))
+    return EZ_FAILURE;
+
+  GenerateTriangleMeshFromDescription(geo);
+
+  if (m_Vertices.IsEmpty())
+  {
+    ezLog::Debug("Navmesh is empty");
+    inout_NavMeshDesc.Clear();
+    return EZ_SUCCESS;
+  }
+
+  ComputeBoundingBox();
+
+  if (!pg.BeginNextStep("Assign Triangles to Tiles"))
+    return EZ_FAILURE;
+
+  rcConfig tileCfg;
+  FillOutConfig(tileCfg, config, m_BoundingBox);
+
+  // tiles have to be a multiple of the cell size, to line up exactly with their neighbors
+  tileCfg.tileSize = ezMath::Max(1, (int)ceilf(config.m_fTileSize / tileCfg.cs));
+  tileCfg.borderSize = tileCfg.walkableRadius + 3;
+  tileCfg.width = tileCfg.tileSize + tileCfg.borderSize * 2;
+  tileCfg.height = tileCfg.tileSize + tileCfg.borderSize * 2;
+
+  const float fTileWorldSize = tileCfg.tileSize * tileCfg.cs;
+
+  ezDynamicArray<TileBuildData> tiles;
+  CollectTiles(tileCfg, fTileWorldSize, tiles);
+
+  ezUInt32 uiMaxTiles = 0;
+  if (!tiles.IsEmpty())
+  {
+    // the navmesh has to be able to hold every tile within the bounds of the input, even those that are currently empty
+    ezInt32 iMinTileX = ezMath::MaxValue<ezInt32>();
+    ezInt32 iMinTileY = ezMath::MaxValue<ezInt32>();
+    ezInt32 iMaxTileX = ezMath::MinValue<ezInt32>();
+    ezInt32 iMaxTileY = ezMath::MinValue<ezInt32>();
+
+    for (const auto& tile : tiles)
+    {
+      iMinTileX = ezMath::Min(iMinTileX, tile.m_iTileX);
+      iMinTileY = ezMath::Min(iMinTileY, tile.m_iTileY);
+      iMaxTileX = ezMath::Max(iMaxTileX, tile.m_iTileX);
+      iMaxTileY = ezMath::Max(iMaxTileY, tile.m_iTileY);
+    }
+
+    uiMaxTiles = (ezUInt32)(iMaxTileX - iMinTileX + 1) * (ezUInt32)(iMaxTileY - iMinTileY + 1);
+  }
+
+  // All tiles share the vertical range of the whole mesh (required by rcMergePolyMeshes), so it is part of the input hash as well.
+  ezUInt64 uiSettingsHash = ezHashingUtils::xxHash64(&config, sizeof(ezRecastConfig));
+  uiSettingsHash = ezHashingUtils::xxHash64(&tileCfg.bmin[1], sizeof(float), uiSettingsHash);
+  uiSettingsHash = ezHashingUtils::xxHash64(&tileCfg.bmax[1], sizeof(float), uiSettingsHash);
+
+  // reuse all tiles from the previous build whose input did not change
+  {
+    ezHashTable<ezUInt64, ezRecastNavMeshTile*> previousTiles;
+
+    if (inout_NavMeshDesc.m_fTileSize == fTileWorldSize)
+    {
+      for (auto& prevTile : inout_NavMeshDesc.m_Tiles)
+      {
+        previousTiles.Insert(ezRecastNavMeshTile::GetTileKey(prevTile.m_iTileX, prevTile.m_iTileY), &prevTile);
+      }
+    }
+
+    ezUInt32 uiReusedTiles = 0;
+
+    for (auto& tile : tiles)
+    {
+      ezUInt64 uiHash = uiSettingsHash;
+      for (const auto& tri : tile.m_Triangles)
+      {
+        for (ezUInt32 i = 0; i < 3; ++i)
+        {
+          uiHash = ezHashingUtils::xxHash64(&m_Vertices[tri.m_VertexIdx[i]], sizeof(ezVec3), uiHash);
+        }
+      }
+
+      tile.m_Tile.m_iTileX = tile.m_iTileX;
+      tile.m_Tile.m_iTileY = tile.m_iTileY;
+      tile.m_Tile.m_uiInputHash = uiHash;
+
+      ezRecastNavMeshTile* pPrevTile = nullptr;
+      if (previousTiles.TryGetValue(ezRecastNavMeshTile::GetTileKey(tile.m_iTileX, tile.m_iTileY), pPrevTile) &&
+          pPrevTile->m_uiInputHash == uiHash && pPrevTile->m_pTilePolygons != nullptr)
+      {
+        tile.m_pPreviousTile = pPrevTile;
+        tile.m_bRebuild = false;
+        ++uiReusedTiles;
+      }
+    }
+
+    ezLog::Debug("Tiles: {0}, rebuilding: {1}", tiles.GetCount(), tiles.GetCount() - uiReusedTiles);
+  }
+
+  if (!pg.BeginNextStep("Build Tiles"))
+    return EZ_FAILURE;
+
+  {
+    ezDynamicArray<TileBuildData*> tilesToBuild;
+    for (auto& tile : tiles)
+    {
+      if (tile.m_bRebuild)
+      {
+        tilesToBuild.PushBack(&tile);
+      }
+    }
+
+    const ezArrayPtr<const ezVec3> vertices = m_Vertices;
+
+    ezTaskSystem::ParallelForParams params;
+    // tiles differ vastly in their amount of geometry, so give the scheduler some leeway to balance the work
+    params.uiMaxTasksPerThread = 4;
+
+    ezTaskSystem::ParallelForSingle(tilesToBuild.GetArrayPtr(),
+      [&](TileBuildData* pTile) {
+        if (progress.WasCanceled())
+        {
+          pTile->m_BuildResult = EZ_FAILURE;
+          return;
+        }
+
+        pTile->m_BuildResult = BuildTile(config, tileCfg, vertices, *pTile);
+      },
+      "BuildNavMeshTiles", params);
+
+    if (progress.WasCanceled())
+      return EZ_FAILURE;
+
+    for (const TileBuildData* pTile : tilesToBuild)
+    {
+      if (pTile->m_BuildResult.Failed())
+      {
+        ezLog::Error("Building navmesh tile ({0}, {1}) failed", pTile->m_iTileX, pTile->m_iTileY);
+        return EZ_FAILURE;
+      }
+    }
+  }
+
+  if (!pg.BeginNextStep("Merge Tile Polygons"))
+    return EZ_FAILURE;
+
+  ezDynamicArray<rcPolyMesh*> tilePolygons;
+  tilePolygons.Reserve(tiles.GetCount());
+
+  ezUInt32 uiTotalVertices = 0;
+  ezUInt32 uiMaxTilePolygons = 0;
+
+  for (auto& tile : tiles)
+  {
+    ezRecastNavMeshTile& resultTile = tile.GetResultTile();
+
+    // tiles without any walkable area are not stored at all
+    if (resultTile.m_DetourTileData.IsEmpty())
+      continue;
+
+    tilePolygons.PushBack(resultTile.m_pTilePolygons);
+    uiTotalVertices += resultTile.m_pTilePolygons->nverts;
+    uiMaxTilePolygons = ezMath::Max(uiMaxTilePolygons, (ezUInt32)resultTile.m_pTilePolygons->npolys);
+  }
+
+  // the merged mesh is only used for visualization and points of interest, pathfinding works directly on the Detour tiles
+  ezUniquePtr<rcPolyMesh> pMergedPolygons;
+
+  if (!tilePolygons.IsEmpty())
+  {
+    // rcMergePolyMeshes stores vertex indices with 16 bits and doesn't check for overflows
+    if (uiTotalVertices >= 0xFFFE)
+    {
+      ezLog::Error("The navmesh tiles have {0} vertices in total, at most 65533 are supported. Reduce the navmesh area or detail.",
+        uiTotalVertices);
+      return EZ_FAILURE;
+    }
+
+    pMergedPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
+
+    if (!rcMergePolyMeshes(m_pRecastContext, tilePolygons.GetData(), tilePolygons.GetCount(), *pMergedPolygons))
+    {
+      m_pRecastContext->log(RC_LOG_ERROR, "Could not merge tile poly meshes");
+      return EZ_FAILURE;
+    }
+  }
+
+  // everything succeeded, only now the tiles of the previous build can be replaced
+  ezDynamicArray<ezRecastNavMeshTile> resultTiles;
+  resultTiles.Reserve(tilePolygons.GetCount());
+
+  for (auto& tile : tiles)
+  {
+    ezRecastNavMeshTile& resultTile = tile.GetResultTile();
+
+    if (!resultTile.m_DetourTileData.IsEmpty())
+    {
+      resultTiles.PushBack(std::move(resultTile));
+    }
+  }
+
+  inout_NavMeshDesc.Clear();
+  inout_NavMeshDesc.m_fTileSize = fTileWorldSize;
+  inout_NavMeshDesc.m_uiMaxTiles = uiMaxTiles;
+  inout_NavMeshDesc.m_uiMaxTilePolygons = uiMaxTilePolygons;
+  inout_NavMeshDesc.m_Tiles = std::move(resultTiles);
+  inout_NavMeshDesc.m_pNavMeshPolygons = pMergedPolygons.Release();
+
+  return EZ_SUCCESS;
+}
+
+void ezRecastNavMeshBuilder::CollectTiles(const rcConfig& cfg, float fTileWorldSize, ezDynamicArray<TileBuildData>& out_Tiles) const
+{
+  EZ_LOG_BLOCK("ezRecastNavMeshBuilder::CollectTiles");
+
+  // Tile coordinates are absolute (the navmesh origin is always zero), so that a tile keeps its coordinates
+  // when the rest of the world changes. This is what allows to reuse tiles across builds.
+  const float fBorder = cfg.borderSize * cfg.cs;
+  const float fInvTileSize = 1.0f / fTileWorldSize;
+
+  ezHashTable<ezUInt64, ezUInt32> tileLookup;
+
+  for (const Triangle& tri : m_Triangles)
+  {
+    const ezVec3& v0 = m_Vertices[tri.m_VertexIdx[0]];
+    const ezVec3& v1 = m_Vertices[tri.m_VertexIdx[1]];
+    const ezVec3& v2 = m_Vertices[tri.m_VertexIdx[2]];
+
+    // recast convention: y is up, tiles lie in the xz plane
+    const float fMinX = ezMath::Min(v0.x, v1.x, v2.x) - fBorder;
+    const float fMaxX = ezMath::Max(v0.x, v1.x, v2.x) + fBorder;
+    const float fMinZ = ezMath::Min(v0.z, v1.z, v2.z) - fBorder;
+    const float fMaxZ = ezMath::Max(v0.z, v1.z, v2.z) + fBorder;
+
+    const ezInt32 iMinTileX = (ezInt32)ezMath::Floor(fMinX * fInvTileSize);
+    const ezInt32 iMaxTileX = (ezInt32)ezMath::Floor(fMaxX * fInvTileSize);
+    const ezInt32 iMinTileY = (ezInt32)ezMath::Floor(fMinZ * fInvTileSize);
+    const ezInt32 iMaxTileY = (ezInt32)ezMath::Floor(fMaxZ * fInvTileSize);
+
+    for (ezInt32 y = iMinTileY; y <= iMaxTileY; ++y)
+    {
+      for (ezInt32 x = iMinTileX; x <= iMaxTileX; ++x)
+      {
+        const ezUInt64 uiKey = ezRecastNavMeshTile::GetTileKey(x, y);
+
+        ezUInt32 uiTileIdx = 0;
+        if (!tileLookup.TryGetValue(uiKey, uiTileIdx))
+        {
+          uiTileIdx = out_Tiles.GetCount();
+          tileLookup.Insert(uiKey, uiTileIdx);
+
+          auto& tile = out_Tiles.ExpandAndGetRef();
+          tile.m_iTileX = x;
+          tile.m_iTileY = y;
+        }
+
+        out_Tiles[uiTileIdx].m_Triangles.PushBack(tri);
+      }
+    }
+  }
+}
+
+ezResult ezRecastNavMeshBuilder::BuildTile(
+  const ezRecastConfig& config, const rcConfig& tileCfg, ezArrayPtr<const ezVec3> vertices, TileBuildData& tile)
+{
+  rcConfig cfg = tileCfg;
+
+  const float fTileWorldSize = cfg.tileSize * cfg.cs;
+  const float fBorder = cfg.borderSize * cfg.cs;
+
+  cfg.bmin[0] = tile.m_iTileX * fTileWorldSize - fBorder;
+  cfg.bmin[2] = tile.m_iTileY * fTileWorldSize - fBorder;
+  cfg.bmax[0] = (tile.m_iTileX + 1) * fTileWorldSize + fBorder;
+  cfg.bmax[2] = (tile.m_iTileY + 1) * fTileWorldSize + fBorder;
+
+  // every tile runs on its own thread, so it needs its own context
+  ezRcBuildContext context;
+
+  ezDynamicArray<ezUInt8> triangleAreaIDs;
+  triangleAreaIDs.SetCount(tile.m_Triangles.GetCount());
+
+  tile.m_Tile.m_pTilePolygons = EZ_DEFAULT_NEW(rcPolyMesh);
+
+  EZ_SUCCEED_OR_RETURN(
+    BuildRecastPolyMesh(&context, cfg, vertices, tile.m_Triangles, triangleAreaIDs, *tile.m_Tile.m_pTilePolygons, nullptr));
+
+  if (tile.m_Tile.m_pTilePolygons->npolys == 0)
+  {
+    // nothing walkable in this tile
+    return EZ_SUCCESS;
+  }
+
+  return BuildDetourNavMeshData(config, *tile.m_Tile.m_pTilePolygons, tile.m_Tile.m_DetourTileData, tile.m_iTileX, tile.m_iTileY);
+}
+
 void ezRecastNavMeshBuilder::ReserveMemory(const ezWorldGeoExtractionUtil::Geometry& desc)
 {
   const ezUInt32 uiBoxes = desc.m_BoxShapes.GetCount();
@@ -261,21 +604,21 @@ void ezRecastNavMeshBuilder::FillOutConfig(rcConfig& cfg, const ezRecastConfig&
   rcCalcGridSize(cfg.bmin, cfg.bmax, cfg.cs, &cfg.width, &cfg.height);
 }
 
-ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& config, rcPolyMesh& out_PolyMesh, ezProgress& progress)
+static bool BeginNextStep(ezProgressRange* pProgressRange, const char* szStepName)
 {
-  ezProgressRange pgRange("Build Poly Mesh", 13, true, &progress);
-
-  rcConfig cfg;
-  FillOutConfig(cfg, config, m_BoundingBox);
+  return pProgressRange == nullptr || pProgressRange->BeginNextStep(szStepName);
+}
 
-  ezRcBuildContext* pContext = m_pRecastContext;
-  const float* pVertices = &m_Vertices[0].x;
-  const ezInt32* pTriangles = &m_Triangles[0].m_VertexIdx[0];
+ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(ezRcBuildContext* pContext, const rcConfig& cfg, ezArrayPtr<const ezVec3> vertices,
+  ezArrayPtr<const Triangle> triangles, ezArrayPtr<ezUInt8> triangleAreaIDs, rcPolyMesh& out_PolyMesh, ezProgressRange* pProgressRange)
+{
+  const float* pVertices = &vertices[0].x;
+  const ezInt32* pTriangles = &triangles[0].m_VertexIdx[0];
 
   rcHeightfield* heightfield = rcAllocHeightfield();
   EZ_SCOPE_EXIT(rcFreeHeightField(heightfield));
 
-  if (!pgRange.BeginNextStep("Creating Heightfield"))
+  if (!BeginNextStep(pProgressRange, "Creating Heightfield"))
     return EZ_FAILURE;
 
   if (!rcCreateHeightfield(pContext, *heightfield, cfg.width, cfg.height, cfg.bmin, cfg.bmax, cfg.cs, cfg.ch))
@@ -284,17 +627,17 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     return EZ_FAILURE;
   }
 
-  if (!pgRange.BeginNextStep("Mark Walkable Area"))
+  if (!BeginNextStep(pProgressRange, "Mark Walkable Area"))
     return EZ_FAILURE;
 
   // TODO Instead of this, it should use area IDs and then clear the non-walkable triangles
   rcMarkWalkableTriangles(
-    pContext, cfg.walkableSlopeAngle, pVertices, m_Vertices.GetCount(), pTriangles, m_Triangles.GetCount(), m_TriangleAreaIDs.GetData());
+    pContext, cfg.walkableSlopeAngle, pVertices, vertices.GetCount(), pTriangles, triangles.GetCount(), triangleAreaIDs.GetPtr());
 
-  if (!pgRange.BeginNextStep("Rasterize Triangles"))
+  if (!BeginNextStep(pProgressRange, "Rasterize Triangles"))
     return EZ_FAILURE;
 
-  if (!rcRasterizeTriangles(pContext, pVertices, m_Vertices.GetCount(), pTriangles, m_TriangleAreaIDs.GetData(), m_Triangles.GetCount(),
+  if (!rcRasterizeTriangles(pContext, pVertices, vertices.GetCount(), pTriangles, triangleAreaIDs.GetPtr(), triangles.GetCount(),
         *heightfield, cfg.walkableClimb))
   {
     pContext->log(RC_LOG_ERROR, "Could not rasterize triangles");
@@ -303,26 +646,26 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
 
   // Optional stuff
   {
-    if (!pgRange.BeginNextStep("Filter Low Hanging Obstacles"))
+    if (!BeginNextStep(pProgressRange, "Filter Low Hanging Obstacles"))
       return EZ_FAILURE;
 
     // if (m_filterLowHangingObstacles)
     rcFilterLowHangingWalkableObstacles(pContext, cfg.walkableClimb, *heightfield);
 
-    if (!pgRange.BeginNextStep("Filter Ledge Spans"))
+    if (!BeginNextStep(pProgressRange, "Filter Ledge Spans"))
       return EZ_FAILURE;
 
     // if (m_filterLedgeSpans)
     rcFilterLedgeSpans(pContext, cfg.walkableHeight, cfg.walkableClimb, *heightfield);
 
-    if (!pgRange.BeginNextStep("Filter Low Height Spans"))
+    if (!BeginNextStep(pProgressRange, "Filter Low Height Spans"))
       return EZ_FAILURE;
 
     // if (m_filterWalkableLowHeightSpans)
     rcFilterWalkableLowHeightSpans(pContext, cfg.walkableHeight, *heightfield);
   }
 
-  if (!pgRange.BeginNextStep("Build Compact Heightfield"))
+  if (!BeginNextStep(pProgressRange, "Build Compact Heightfield"))
     return EZ_FAILURE;
 
   rcCompactHeightfield* compactHeightfield = rcAllocCompactHeightfield();
@@ -334,7 +677,7 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     return EZ_FAILURE;
   }
 
-  if (!pgRange.BeginNextStep("Erode Walkable Area"))
+  if (!BeginNextStep(pProgressRange, "Erode Walkable Area"))
     return EZ_FAILURE;
 
   if (!rcErodeWalkableArea(pContext, cfg.walkableRadius, *compactHeightfield))
@@ -357,7 +700,7 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
   {
     // PARTITION_WATERSHED
     {
-      if (!pgRange.BeginNextStep("Build Distance Field"))
+      if (!BeginNextStep(pProgressRange, "Build Distance Field"))
         return EZ_FAILURE;
 
       // Prepare for region partitioning, by calculating distance field along the walkable surface.
@@ -367,11 +710,11 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
         return EZ_FAILURE;
       }
 
-      if (!pgRange.BeginNextStep("Build Regions"))
+      if (!BeginNextStep(pProgressRange, "Build Regions"))
         return EZ_FAILURE;
 
       // Partition the walkable surface into simple regions without holes.
-      if (!rcBuildRegions(pContext, *compactHeightfield, 0, cfg.minRegionArea, cfg.mergeRegionArea))
+      if (!rcBuildRegions(pContext, *compactHeightfield, cfg.borderSize, cfg.minRegionArea, cfg.mergeRegionArea))
       {
         pContext->log(RC_LOG_ERROR, "Could not build watershed regions.");
         return EZ_FAILURE;
@@ -400,7 +743,7 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     //}
   }
 
-  if (!pgRange.BeginNextStep("Build Contours"))
+  if (!BeginNextStep(pProgressRange, "Build Contours"))
     return EZ_FAILURE;
 
   rcContourSet* contourSet = rcAllocContourSet();
@@ -412,7 +755,7 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
     return EZ_FAILURE;
   }
 
-  if (!pgRange.BeginNextStep("Build Poly Mesh"))
+  if (!BeginNextStep(pProgressRange, "Build Poly Mesh"))
     return EZ_FAILURE;
 
   if (!rcBuildPolyMesh(pContext, *contourSet, cfg.maxVertsPerPoly, out_PolyMesh))
@@ -424,7 +767,7 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
   //////////////////////////////////////////////////////////////////////////
   // Detour Navmesh
 
-  if (!pgRange.BeginNextStep("Set Area Flags"))
+  if (!BeginNextStep(pProgressRange, "Set Area Flags"))
     return EZ_FAILURE;
 
   // TODO modify area IDs and flags
@@ -440,7 +783,8 @@ ezResult ezRecastNavMeshBuilder::BuildRecastPolyMesh(const ezRecastConfig& confi
   return EZ_SUCCESS;
 }
 
-ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezDataBuffer& NavmeshData)
+ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(
+  const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezDataBuffer& NavmeshData, ezInt32 iTileX, ezInt32 iTileY)
 {
   dtNavMeshCreateParams params;
   ezMemoryUtils::ZeroFill(&params, 1);
@@ -460,6 +804,9 @@ ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(const ezRecastConfig& co
   params.cs = config.m_fCellSize;
   params.ch = config.m_fCellHeight;
   params.buildBvTree = true;
+  params.tileX = iTileX;
+  params.tileY = iTileY;
+  params.tileLayer = 0;
 
   ezUInt8* navData = nullptr;
   ezInt32 navDataSize = 0;
@@ -479,7 +826,7 @@ ezResult ezRecastNavMeshBuilder::BuildDetourNavMeshData(const ezRecastConfig& co
 
 ezResult ezRecastConfig::Serialize(ezStreamWriter& stream) const
 {
-  stream.WriteVersion(1);
+  stream.WriteVersion(2);
 
   stream << m_fAgentHeight;
   stream << m_fAgentRadius;
@@ -493,13 +840,14 @@ ezResult ezRecastConfig::Serialize(ezStreamWriter& stream) const
   stream << m_fRegionMergeSize;
   stream << m_fDetailMeshSampleDistanceFactor;
   stream << m_fDetailMeshSampleErrorFactor;
+  stream << m_fTileSize;
 
   return EZ_SUCCESS;
 }
 
 ezResult ezRecastConfig::Deserialize(ezStreamReader& stream)
 {
-  stream.ReadVersion(1);
+  const ezTypeVersion version = stream.ReadVersion(2);
 
   stream >> m_fAgentHeight;
   stream >> m_fAgentRadius;
@@ -514,5 +862,10 @@ ezResult ezRecastConfig::Deserialize(ezStreamReader& stream)
   stream >> m_fDetailMeshSampleDistanceFactor;
   stream >> m_fDetailMeshSampleErrorFactor;
 
+  if (version >= 2)
+  {
+    stream >> m_fTileSize;
+  }
+
   return EZ_SUCCESS;
 }
@@ -6,12 +6,14 @@
 #include <RecastPlugin/RecastPluginDLL.h>
 
 class ezRcBuildContext;
+struct rcConfig;
 struct rcPolyMesh;
 struct rcPolyMeshDetail;
 class ezWorld;
 class dtNavMesh;
 struct ezRecastNavMeshResourceDescriptor;
 class ezProgress;
+class ezProgressRange;
 class ezStreamWriter;
 class ezStreamReader;
 
@@ -30,6 +32,12 @@ struct EZ_RECASTPLUGIN_DLL ezRecastConfig
   float m_fDetailMeshSampleDistanceFactor = 1.0f;
   float m_fDetailMeshSampleErrorFactor = 1.0f;
 
+  /// \brief Edge length of a navmesh tile in world units.
+  ///
+  /// If zero, the navmesh is built as one monolithic mesh. Otherwise the world is split into tiles which are built in parallel
+  /// and can be rebuilt individually when their geometry changes.
+  float m_fTileSize = 0.0f;
+
   ezResult Serialize(ezStreamWriter& stream) const;
   ezResult Deserialize(ezStreamReader& stream);
 };
@@ -49,15 +57,30 @@ public:
   ezResult Build(const ezRecastConfig& config, const ezWorldGeoExtractionUtil::Geometry& worldGeo,
     ezRecastNavMeshResourceDescriptor& out_NavMeshDesc, ezProgress& progress);
 
+  /// \brief Builds a tiled navmesh. config.m_fTileSize must be larger than zero.
+  ///
+  /// All tiles are rasterized and built in parallel. If inout_NavMeshDesc already contains tiles from a previous build with the same
+  /// configuration, only the tiles whose input geometry has changed are rebuilt, all other tiles are kept as they are.
+  /// If the build fails, inout_NavMeshDesc is not modified.
+  ezResult BuildTiled(const ezRecastConfig& config, const ezWorldGeoExtractionUtil::Geometry& worldGeo,
+    ezRecastNavMeshResourceDescriptor& inout_NavMeshDesc, ezProgress& progress);
+
 private:
-  static void FillOutConfig(struct rcConfig& cfg, const ezRecastConfig& config, const ezBoundingBox& bbox);
+  struct Triangle;
+  struct TileBuildData;
+
+  static void FillOutConfig(rcConfig& cfg, const ezRecastConfig& config, const ezBoundingBox& bbox);
 
   void Clear();
   void ReserveMemory(const ezWorldGeoExtractionUtil::Geometry& desc);
   void GenerateTriangleMeshFromDescription(const ezWorldGeoExtractionUtil::Geometry& desc);
   void ComputeBoundingBox();
-  ezResult BuildRecastPolyMesh(const ezRecastConfig& config, rcPolyMesh& out_PolyMesh, ezProgress& progress);
-  static ezResult BuildDetourNavMeshData(const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezDataBuffer& NavmeshData);
+  void CollectTiles(const rcConfig& cfg, float fTileWorldSize, ezDynamicArray<TileBuildData>& out_Tiles) const;
+  static ezResult BuildTile(const ezRecastConfig& config, const rcConfig& tileCfg, ezArrayPtr<const ezVec3> vertices, TileBuildData& tile);
+  static ezResult BuildRecastPolyMesh(ezRcBuildContext* pContext, const rcConfig& cfg, ezArrayPtr<const ezVec3> vertices,
+    ezArrayPtr<const Triangle> triangles, ezArrayPtr<ezUInt8> triangleAreaIDs, rcPolyMesh& out_PolyMesh, ezProgressRange* pProgressRange);
+  static ezResult BuildDetourNavMeshData(const ezRecastConfig& config, const rcPolyMesh& polyMesh, ezDataBuffer& NavmeshData,
+    ezInt32 iTileX = 0, ezInt32 iTileY = 0);
 
   struct Triangle
   {
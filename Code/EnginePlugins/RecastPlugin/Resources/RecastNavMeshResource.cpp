@@ -16,6 +16,149 @@ EZ_RESOURCE_IMPLEMENT_COMMON_CODE(ezRecastNavMeshResource);
 
 //////////////////////////////////////////////////////////////////////////
 
+static ezResult SerializePolyMesh(ezStreamWriter& stream, const rcPolyMesh& mesh)
+{
+  EZ_CHECK_AT_COMPILETIME_MSG(sizeof(rcPolyMesh) == sizeof(void*) * 5 + sizeof(int) * 14, "rcPolyMesh data structure has changed");
+
+  stream << (int)mesh.nverts;
+  stream << (int)mesh.npolys;
+  stream << (int)mesh.npolys; // do not use mesh.maxpolys
+  stream << (int)mesh.nvp;
+  stream << (float)mesh.bmin[0];
+  stream << (float)mesh.bmin[1];
+  stream << (float)mesh.bmin[2];
+  stream << (float)mesh.bmax[0];
+  stream << (float)mesh.bmax[1];
+  stream << (float)mesh.bmax[2];
+  stream << (float)mesh.cs;
+  stream << (float)mesh.ch;
+  stream << (int)mesh.borderSize;
+  stream << (float)mesh.maxEdgeError;
+
+  EZ_ASSERT_DEBUG(mesh.maxpolys >= mesh.npolys, "Invalid navmesh polygon count");
+
+  EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.verts, sizeof(ezUInt16) * mesh.nverts * 3));
+  EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.polys, sizeof(ezUInt16) * mesh.npolys * mesh.nvp * 2));
+  EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.regs, sizeof(ezUInt16) * mesh.npolys));
+  EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.flags, sizeof(ezUInt16) * mesh.npolys));
+  EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.areas, sizeof(ezUInt8) * mesh.npolys));
+
+  return EZ_SUCCESS;
+}
+
+static ezResult DeserializePolyMesh(ezStreamReader& stream, rcPolyMesh& mesh)
+{
+  EZ_CHECK_AT_COMPILETIME_MSG(sizeof(rcPolyMesh) == sizeof(void*) * 5 + sizeof(int) * 14, "rcPolyMesh data structure has changed");
+
+  stream >> mesh.nverts;
+  stream >> mesh.npolys;
+  stream >> mesh.maxpolys;
+  stream >> mesh.nvp;
+  stream >> mesh.bmin[0];
+  stream >> mesh.bmin[1];
+  stream >> mesh.bmin[2];
+  stream >> mesh.bmax[0];
+  stream >> mesh.bmax[1];
+  stream >> mesh.bmax[2];
+  stream >> mesh.cs;
+  stream >> mesh.ch;
+  stream >> mesh.borderSize;
+  stream >> mesh.maxEdgeError;
+
+  EZ_ASSERT_DEBUG(mesh.maxpolys >= mesh.npolys, "Invalid navmesh polygon count");
+
+  mesh.verts = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.nverts * 3, RC_ALLOC_PERM);
+  mesh.polys = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys * mesh.nvp * 2, RC_ALLOC_PERM);
+  mesh.regs = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys, RC_ALLOC_PERM);
+  mesh.flags = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys, RC_ALLOC_PERM);
+  mesh.areas = (ezUInt8*)rcAlloc(sizeof(ezUInt8) * mesh.maxpolys, RC_ALLOC_PERM);
+
+  stream.ReadBytes(mesh.verts, sizeof(ezUInt16) * mesh.nverts * 3);
+  stream.ReadBytes(mesh.polys, sizeof(ezUInt16) * mesh.maxpolys * mesh.nvp * 2);
+  stream.ReadBytes(mesh.regs, sizeof(ezUInt16) * mesh.maxpolys);
+  stream.ReadBytes(mesh.flags, sizeof(ezUInt16) * mesh.maxpolys);
+  stream.ReadBytes(mesh.areas, sizeof(ezUInt8) * mesh.maxpolys);
+
+  return EZ_SUCCESS;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ezRecastNavMeshTile::ezRecastNavMeshTile() = default;
+ezRecastNavMeshTile::ezRecastNavMeshTile(ezRecastNavMeshTile&& rhs)
+{
+  *this = std::move(rhs);
+}
+
+ezRecastNavMeshTile::~ezRecastNavMeshTile()
+{
+  Clear();
+}
+
+void ezRecastNavMeshTile::operator=(ezRecastNavMeshTile&& rhs)
+{
+  Clear();
+
+  m_iTileX = rhs.m_iTileX;
+  m_iTileY = rhs.m_iTileY;
+  m_uiInputHash = rhs.m_uiInputHash;
+  m_DetourTileData = std::move(rhs.m_DetourTileData);
+
+  m_pTilePolygons = rhs.m_pTilePolygons;
+  rhs.m_pTilePolygons = nullptr;
+}
+
+void ezRecastNavMeshTile::Clear()
+{
+  m_DetourTileData.Clear();
+  EZ_DEFAULT_DELETE(m_pTilePolygons);
+}
+
+ezResult ezRecastNavMeshTile::Serialize(ezStreamWriter& stream) const
+{
+  stream.WriteVersion(1);
+
+  stream << m_iTileX;
+  stream << m_iTileY;
+  stream << m_uiInputHash;
+  EZ_SUCCEED_OR_RETURN(stream.WriteArray(m_DetourTileData));
+
+  const bool hasPolygons = m_pTilePolygons != nullptr;
+  stream << hasPolygons;
+
+  if (hasPolygons)
+  {
+    EZ_SUCCEED_OR_RETURN(SerializePolyMesh(stream, *m_pTilePolygons));
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezRecastNavMeshTile::Deserialize(ezStreamReader& stream)
+{
+  Clear();
+
+  stream.ReadVersion(1);
+
+  stream >> m_iTileX;
+  stream >> m_iTileY;
+  stream >> m_uiInputHash;
+  EZ_SUCCEED_OR_RETURN(stream.ReadArray(m_DetourTileData));
+
+  bool hasPolygons = false;
+  stream >> hasPolygons;
+
+  if (hasPolygons)
+  {
+    m_pTilePolygons = EZ_DEFAULT_NEW(rcPolyMesh);
+    EZ_SUCCEED_OR_RETURN(DeserializePolyMesh(stream, *m_pTilePolygons));
+  }
+
+  return EZ_SUCCESS;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 ezRecastNavMeshResourceDescriptor::ezRecastNavMeshResourceDescriptor() = default;
 ezRecastNavMeshResourceDescriptor::ezRecastNavMeshResourceDescriptor(ezRecastNavMeshResourceDescriptor&& rhs)
 {
@@ -33,19 +176,28 @@ void ezRecastNavMeshResourceDescriptor::operator=(ezRecastNavMeshResourceDescrip
 
   m_pNavMeshPolygons = rhs.m_pNavMeshPolygons;
   rhs.m_pNavMeshPolygons = nullptr;
+
+  m_fTileSize = rhs.m_fTileSize;
+  m_Tiles = std::move(rhs.m_Tiles);
+  m_uiMaxTiles = rhs.m_uiMaxTiles;
+  m_uiMaxTilePolygons = rhs.m_uiMaxTilePolygons;
 }
 
 void ezRecastNavMeshResourceDescriptor::Clear()
 {
   m_DetourNavmeshData.Clear();
   EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
+  m_fTileSize = 0.0f;
+  m_Tiles.Clear();
+  m_uiMaxTiles = 0;
+  m_uiMaxTilePolygons = 0;
 }
 
 //////////////////////////////////////////////////////////////////////////
 
 ezResult ezRecastNavMeshResourceDescriptor::Serialize(ezStreamWriter& stream) const
 {
-  stream.WriteVersion(1);
+  stream.WriteVersion(3);
   EZ_SUCCEED_OR_RETURN(stream.WriteArray(m_DetourNavmeshData));
 
   const bool hasPolygons = m_pNavMeshPolygons != nullptr;
@@ -53,34 +205,20 @@ ezResult ezRecastNavMeshResourceDescriptor::Serialize(ezStreamWriter& stream) co
 
   if (hasPolygons)
   {
-    EZ_CHECK_AT_COMPILETIME_MSG(sizeof(rcPolyMesh) == sizeof(void*) * 5 + sizeof(int) * 14, "rcPolyMesh data structure has changed");
-
-    const auto& mesh = *m_pNavMeshPolygons;
-
-    stream << (int)mesh.nverts;
-    stream << (int)mesh.npolys;
-    stream << (int)mesh.npolys; // do not use mesh.maxpolys
-    stream << (int)mesh.nvp;
-    stream << (float)mesh.bmin[0];
-    stream << (float)mesh.bmin[1];
-    stream << (float)mesh.bmin[2];
-    stream << (float)mesh.bmax[0];
-    stream << (float)mesh.bmax[1];
-    stream << (float)mesh.bmax[2];
-    stream << (float)mesh.cs;
-    stream << (float)mesh.ch;
-    stream << (int)mesh.borderSize;
-    stream << (float)mesh.maxEdgeError;
-
-    EZ_ASSERT_DEBUG(mesh.maxpolys >= mesh.npolys, "Invalid navmesh polygon count");
-
-    EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.verts, sizeof(ezUInt16) * mesh.nverts * 3));
-    EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.polys, sizeof(ezUInt16) * mesh.npolys * mesh.nvp * 2));
-    EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.regs, sizeof(ezUInt16) * mesh.npolys));
-    EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.flags, sizeof(ezUInt16) * mesh.npolys));
-    EZ_SUCCEED_OR_RETURN(stream.WriteBytes(mesh.areas, sizeof(ezUInt8) * mesh.npolys));
+    EZ_SUCCEED_OR_RETURN(SerializePolyMesh(stream, *m_pNavMeshPolygons));
   }
 
+  stream << m_fTileSize;
+  stream << m_Tiles.GetCount();
+
+  for (const auto& tile : m_Tiles)
+  {
+    EZ_SUCCEED_OR_RETURN(tile.Serialize(stream));
+  }
+
+  stream << m_uiMaxTiles;
+  stream << m_uiMaxTilePolygons;
+
   return EZ_SUCCESS;
 }
 
@@ -88,7 +226,7 @@ ezResult ezRecastNavMeshResourceDescriptor::Deserialize(ezStreamReader& stream)
 {
   Clear();
 
-  const ezTypeVersion version = stream.ReadVersion(1);
+  const ezTypeVersion version = stream.ReadVersion(3);
   EZ_SUCCEED_OR_RETURN(stream.ReadArray(m_DetourNavmeshData));
 
   bool hasPolygons = false;
@@ -96,39 +234,28 @@ ezResult ezRecastNavMeshResourceDescriptor::Deserialize(ezStreamReader& stream)
 
   if (hasPolygons)
   {
-    EZ_CHECK_AT_COMPILETIME_MSG(sizeof(rcPolyMesh) == sizeof(void*) * 5 + sizeof(int) * 14, "rcPolyMesh data structure has changed");
-
     m_pNavMeshPolygons = EZ_DEFAULT_NEW(rcPolyMesh);
+    EZ_SUCCEED_OR_RETURN(DeserializePolyMesh(stream, *m_pNavMeshPolygons));
+  }
+
+  if (version >= 2)
+  {
+    stream >> m_fTileSize;
+
+    ezUInt32 uiNumTiles = 0;
+    stream >> uiNumTiles;
+
+    m_Tiles.SetCount(uiNumTiles);
+    for (auto& tile : m_Tiles)
+    {
+      EZ_SUCCEED_OR_RETURN(tile.Deserialize(stream));
+    }
+  }
 
-    auto& mesh = *m_pNavMeshPolygons;
-
-    stream >> mesh.nverts;
-    stream >> mesh.npolys;
-    stream >> mesh.maxpolys;
-    stream >> mesh.nvp;
-    stream >> mesh.bmin[0];
-    stream >> mesh.bmin[1];
-    stream >> mesh.bmin[2];
-    stream >> mesh.bmax[0];
-    stream >> mesh.bmax[1];
-    stream >> mesh.bmax[2];
-    stream >> mesh.cs;
-    stream >> mesh.ch;
-    stream >> mesh.borderSize;
-    stream >> mesh.maxEdgeError;
-
-    EZ_ASSERT_DEBUG(mesh.maxpolys >= mesh.npolys, "Invalid navmesh polygon count");
-
-    mesh.verts = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.nverts * 3, RC_ALLOC_PERM);
-    mesh.polys = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys * mesh.nvp * 2, RC_ALLOC_PERM);
-    mesh.regs = (ezUInt16*)rcAlloc(sizeof(ezUInt16) * mesh.maxpolys, RC_ALLOC_PERM);
-    mesh.areas = (ezUInt8*)rcAlloc(sizeof(ezUInt8) * mesh.maxpolys, RC_ALLOC_PERM);
-
-    stream.ReadBytes(mesh.verts, sizeof(ezUInt16) * mesh.nverts * 3);
-    stream.ReadBytes(mesh.polys, sizeof(ezUInt16) * mesh.maxpolys * mesh.nvp * 2);
-    stream.ReadBytes(mesh.regs, sizeof(ezUInt16) * mesh.maxpolys);
-    stream.ReadBytes(mesh.flags, sizeof(ezUInt16) * mesh.maxpolys);
-    stream.ReadBytes(mesh.areas, sizeof(ezUInt8) * mesh.maxpolys);
+  if (version >= 3)
+  {
+    stream >> m_uiMaxTiles;
+    stream >> m_uiMaxTilePolygons;
   }
 
   return EZ_SUCCESS;
@@ -158,6 +285,8 @@ ezResourceLoadDesc ezRecastNavMeshResource::UnloadData(Unload WhatToUnload)
   m_DetourNavmeshData.Clear();
   EZ_DEFAULT_DELETE(m_pNavMesh);
   EZ_DEFAULT_DELETE(m_pNavMeshPolygons);
+  m_TileData.Clear();
+  m_fTileSize = 0.0f;
 
   return res;
 }
@@ -197,6 +326,12 @@ void ezRecastNavMeshResource::UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage)
   out_NewMemoryUsage.m_uiMemoryCPU += m_DetourNavmeshData.GetHeapMemoryUsage();
   out_NewMemoryUsage.m_uiMemoryCPU += m_pNavMesh != nullptr ? sizeof(dtNavMesh) : 0;
   out_NewMemoryUsage.m_uiMemoryCPU += m_pNavMeshPolygons != nullptr ? sizeof(rcPolyMesh) : 0;
+  out_NewMemoryUsage.m_uiMemoryCPU += m_TileData.GetHeapMemoryUsage();
+
+  for (auto it = m_TileData.GetIterator(); it.IsValid(); ++it)
+  {
+    out_NewMemoryUsage.m_uiMemoryCPU += it.Value().GetHeapMemoryUsage();
+  }
   out_NewMemoryUsage.m_uiMemoryGPU = 0;
 }
 
@@ -211,12 +346,88 @@ ezResourceLoadDesc ezRecastNavMeshResource::CreateResource(ezRecastNavMeshResour
   descriptor.m_pNavMeshPolygons = nullptr;
 
   m_DetourNavmeshData = std::move(descriptor.m_DetourNavmeshData);
+  m_fTileSize = descriptor.m_fTileSize;
 
   m_pNavMesh = EZ_DEFAULT_NEW(dtNavMesh);
 
-  // the dtNavMesh does not need to free the data, the resource owns it
-  const int dtMeshFlags = 0;
-  m_pNavMesh->init(m_DetourNavmeshData.GetData(), m_DetourNavmeshData.GetCount(), dtMeshFlags);
+  if (IsTiled())
+  {
+    // older data does not know its bounds, it can only hold the tiles it was created with
+    const ezUInt32 uiMaxTiles = ezMath::Max(descriptor.m_uiMaxTiles, descriptor.m_Tiles.GetCount(), 1u);
+
+    // polygon references use 22 bits for the tile and polygon index, the rest is needed for the salt
+    const ezUInt32 uiTileBits = ezMath::Log2i(ezMath::PowerOfTwo_Ceil(uiMaxTiles));
+
+    if (uiTileBits > 22 || (1u << (22 - uiTileBits)) < descriptor.m_uiMaxTilePolygons)
+    {
+      ezLog::Error("Navmesh with {0} tiles and up to {1} polygons per tile is too large, use a larger tile size", uiMaxTiles,
+        descriptor.m_uiMaxTilePolygons);
+      res.m_State = ezResourceState::LoadedResourceMissing;
+      return res;
+    }
+
+    dtNavMeshParams params;
+    ezMemoryUtils::ZeroFill(&params, 1);
+    params.tileWidth = m_fTileSize;
+    params.tileHeight = m_fTileSize;
+    params.maxTiles = 1 << uiTileBits;
+    params.maxPolys = 1 << (22 - uiTileBits);
+
+    if (dtStatusFailed(m_pNavMesh->init(&params)))
+    {
+      ezLog::Error("Failed to initialize tiled navmesh");
+      res.m_State = ezResourceState::LoadedResourceMissing;
+      return res;
+    }
+
+    for (auto& tile : descriptor.m_Tiles)
+    {
+      AddTile(std::move(tile));
+    }
+  }
+  else
+  {
+    // the dtNavMesh does not need to free the data, the resource owns it
+    const int dtMeshFlags = 0;
+    m_pNavMesh->init(m_DetourNavmeshData.GetData(), m_DetourNavmeshData.GetCount(), dtMeshFlags);
+  }
 
   return res;
 }
+
+ezResult ezRecastNavMeshResource::AddTile(ezRecastNavMeshTile&& tile)
+{
+  EZ_ASSERT_DEV(IsTiled(), "Tiles can only be added to tiled navmeshes");
+
+  RemoveTile(tile.m_iTileX, tile.m_iTileY);
+
+  ezDataBuffer& tileData = m_TileData[ezRecastNavMeshTile::GetTileKey(tile.m_iTileX, tile.m_iTileY)];
+  tileData = std::move(tile.m_DetourTileData);
+  tile.Clear();
+
+  // the dtNavMesh does not need to free the data, the resource owns it
+  const int dtTileFlags = 0;
+  if (dtStatusFailed(m_pNavMesh->addTile(tileData.GetData(), tileData.GetCount(), dtTileFlags, 0, nullptr)))
+  {
+    ezLog::Error("Failed to add navmesh tile ({0}, {1})", tile.m_iTileX, tile.m_iTileY);
+    m_TileData.Remove(ezRecastNavMeshTile::GetTileKey(tile.m_iTileX, tile.m_iTileY));
+    return EZ_FAILURE;
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezResult ezRecastNavMeshResource::RemoveTile(ezInt32 iTileX, ezInt32 iTileY)
+{
+  EZ_ASSERT_DEV(IsTiled(), "Tiles can only be removed from tiled navmeshes");
+
+  const ezUInt64 uiTileKey = ezRecastNavMeshTile::GetTileKey(iTileX, iTileY);
+
+  if (!m_TileData.Contains(uiTileKey))
+    return EZ_FAILURE;
+
+  // the tile data is owned by the resource, so it must only be freed after the dtNavMesh is done with it
+  m_pNavMesh->removeTile(m_pNavMesh->getTileRefAt(iTileX, iTileY, 0), nullptr, nullptr);
+  m_TileData.Remove(uiTileKey);
+  return EZ_SUCCESS;
+}
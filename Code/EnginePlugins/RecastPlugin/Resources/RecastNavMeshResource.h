@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Core/ResourceManager/Resource.h>
+#include <Foundation/Containers/HashTable.h>
 #include <RecastPlugin/RecastPluginDLL.h>
 
 struct rcPolyMesh;
@@ -8,6 +9,40 @@ class dtNavMesh;
 
 typedef ezTypedResourceHandle<class ezRecastNavMeshResource> ezRecastNavMeshResourceHandle;
 
+/// \brief A single tile of a tiled navmesh.
+///
+/// Tiles can be serialized individually, which allows to stream them in and out through ezRecastWorldModule::AddNavMeshTile() and
+/// ezRecastWorldModule::RemoveNavMeshTile().
+struct EZ_RECASTPLUGIN_DLL ezRecastNavMeshTile
+{
+  ezRecastNavMeshTile();
+  ezRecastNavMeshTile(const ezRecastNavMeshTile& rhs) = delete;
+  ezRecastNavMeshTile(ezRecastNavMeshTile&& rhs);
+  ~ezRecastNavMeshTile();
+  void operator=(ezRecastNavMeshTile&& rhs);
+  void operator=(const ezRecastNavMeshTile& rhs) = delete;
+
+  /// \brief Tile coordinates are absolute, tile (x, y) covers the area [x * tileSize; (x + 1) * tileSize] (in Recast convention).
+  ezInt32 m_iTileX = 0;
+  ezInt32 m_iTileY = 0;
+
+  /// \brief Hash of the input geometry and build settings. Used to skip tiles whose input did not change, when rebuilding a navmesh.
+  ezUInt64 m_uiInputHash = 0;
+
+  /// \brief Data that was created by dtCreateNavMeshData() and will be used for dtNavMesh::addTile()
+  ezDataBuffer m_DetourTileData;
+
+  /// \brief Optional, the polygons of this tile. Only needed to rebuild a navmesh incrementally.
+  rcPolyMesh* m_pTilePolygons = nullptr;
+
+  void Clear();
+
+  ezResult Serialize(ezStreamWriter& stream) const;
+  ezResult Deserialize(ezStreamReader& stream);
+
+  static ezUInt64 GetTileKey(ezInt32 iTileX, ezInt32 iTileY) { return (static_cast<ezUInt64>(static_cast<ezUInt32>(iTileX)) << 32) | static_cast<ezUInt32>(iTileY); }
+};
+
 struct EZ_RECASTPLUGIN_DLL ezRecastNavMeshResourceDescriptor
 {
   ezRecastNavMeshResourceDescriptor();
@@ -23,6 +58,20 @@ struct EZ_RECASTPLUGIN_DLL ezRecastNavMeshResourceDescriptor
   /// \brief Optional, if available the navmesh can be visualized at runtime
   rcPolyMesh* m_pNavMeshPolygons = nullptr;
 
+  /// \brief For tiled navmeshes this is the edge length of each tile, zero for monolithic navmeshes.
+  float m_fTileSize = 0.0f;
+
+  /// \brief For tiled navmeshes the data of each tile. m_DetourNavmeshData is empty in this case.
+  ezDynamicArray<ezRecastNavMeshTile> m_Tiles;
+
+  /// \brief For tiled navmeshes the number of tiles within the bounds that the navmesh was built for, including empty tiles.
+  ///
+  /// The navmesh is sized to hold this many tiles, so that tiles can be added at runtime. Zero if unknown.
+  ezUInt32 m_uiMaxTiles = 0;
+
+  /// \brief For tiled navmeshes the largest number of polygons in a single tile. Zero if unknown.
+  ezUInt32 m_uiMaxTilePolygons = 0;
+
   void Clear();
 
   ezResult Serialize(ezStreamWriter& stream) const;
@@ -42,7 +91,24 @@ public:
   const dtNavMesh* GetNavMesh() const { return m_pNavMesh; }
   const rcPolyMesh* GetNavMeshPolygons() const { return m_pNavMeshPolygons; }
 
+  /// \brief Whether the navmesh consists of individual tiles, which can be added and removed at runtime.
+  bool IsTiled() const { return m_fTileSize > 0.0f; }
+
 private:
+  friend class ezRecastWorldModule;
+
+  /// \brief Adds a tile to a tiled navmesh. If a tile with the same coordinates is already present, it gets replaced.
+  ///
+  /// The tile polygons are not used at runtime and are discarded.
+  /// The dtNavMesh is modified in place, so no query must run on it at the same time. Outside of resource creation this is only
+  /// called through ezRecastWorldModule::AddNavMeshTile(), which waits for the path searches of its world first.
+  ezResult AddTile(ezRecastNavMeshTile&& tile);
+
+  /// \brief Removes a tile from a tiled navmesh and frees its data.
+  ///
+  /// Same threading rules as AddTile(), see ezRecastWorldModule::RemoveNavMeshTile().
+  ezResult RemoveTile(ezInt32 iTileX, ezInt32 iTileY);
+
   virtual ezResourceLoadDesc UnloadData(Unload WhatToUnload) override;
   virtual ezResourceLoadDesc UpdateContent(ezStreamReader* Stream) override;
   virtual void UpdateMemoryUsage(MemoryUsage& out_NewMemoryUsage) override;
@@ -50,4 +116,7 @@ private:
   ezDataBuffer m_DetourNavmeshData;
   dtNavMesh* m_pNavMesh = nullptr;
   rcPolyMesh* m_pNavMeshPolygons = nullptr;
+
+  float m_fTileSize = 0.0f;
+  ezHashTable<ezUInt64, ezDataBuffer> m_TileData;
 };
@@ -1,16 +1,40 @@
 #include <RecastPluginPCH.h>
 
 #include <Core/World/World.h>
+#include <Foundation/Utilities/Stats.h>
 #include <Recast/DetourCrowd.h>
 #include <RecastPlugin/Resources/RecastNavMeshResource.h>
+#include <RecastPlugin/Utils/RcMath.h>
 #include <RecastPlugin/WorldModule/RecastWorldModule.h>
 
 // clang-format off
+EZ_IMPLEMENT_MESSAGE_TYPE(ezMsgRecastPathSearchResult);
+EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezMsgRecastPathSearchResult, 1, ezRTTIDefaultAllocator<ezMsgRecastPathSearchResult>)
+EZ_END_DYNAMIC_REFLECTED_TYPE;
+
 EZ_IMPLEMENT_WORLD_MODULE(ezRecastWorldModule);
 EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezRecastWorldModule, 1, ezRTTINoAllocator)
 EZ_END_DYNAMIC_REFLECTED_TYPE;
 // clang-format on
 
+/// \brief Executes all path searches of one frame. Each invocation works on its own dtNavMeshQuery.
+class ezRecastWorldModule::PathSearchTask : public ezTask
+{
+public:
+  PathSearchTask(ezRecastWorldModule* pModule)
+    : ezTask("Recast Path Searches")
+    , m_pModule(pModule)
+  {
+  }
+
+private:
+  virtual void ExecuteWithMultiplicity(ezUInt32 uiInvocation) const override { m_pModule->ExecutePathSearches(uiInvocation); }
+
+  virtual void Execute() override { m_pModule->ExecutePathSearches(0); }
+
+  ezRecastWorldModule* m_pModule;
+};
+
 ezRecastWorldModule::ezRecastWorldModule(ezWorld* pWorld)
   : ezWorldModule(pWorld)
 {
@@ -31,6 +55,26 @@ void ezRecastWorldModule::Initialize()
     RegisterUpdateFunction(updateDesc);
   }
 
+  {
+    auto startDesc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ezRecastWorldModule::StartPathSearches, this);
+    startDesc.m_Phase = ezWorldModule::UpdateFunctionDesc::Phase::PreAsync;
+    startDesc.m_bOnlyUpdateWhenSimulating = true;
+    startDesc.m_fPriority = -1000.0f; // kick off the searches after all agents had a chance to request paths
+
+    RegisterUpdateFunction(startDesc);
+  }
+
+  {
+    auto finishDesc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ezRecastWorldModule::FinishPathSearches, this);
+    finishDesc.m_Phase = ezWorldModule::UpdateFunctionDesc::Phase::PostTransform;
+    finishDesc.m_bOnlyUpdateWhenSimulating = true;
+    finishDesc.m_fPriority = -1000.0f; // sync with the path search tasks as late as possible
+
+    RegisterUpdateFunction(finishDesc);
+  }
+
+  m_pPathSearchTask = EZ_DEFAULT_NEW(PathSearchTask, this);
+
   ezResourceManager::GetResourceEvents().AddEventHandler(ezMakeDelegate(&ezRecastWorldModule::ResourceEventHandler, this));
 }
 
@@ -38,11 +82,18 @@ void ezRecastWorldModule::Deinitialize()
 {
   ezResourceManager::GetResourceEvents().RemoveEventHandler(ezMakeDelegate(&ezRecastWorldModule::ResourceEventHandler, this));
 
+  ezTaskSystem::WaitForGroup(m_PathSearchTaskGroup);
+  m_PathRequests.Clear();
+  m_PathSearches.Clear();
+  m_QueryPool.Clear();
+
   SUPER::Deinitialize();
 }
 
 void ezRecastWorldModule::SetNavMeshResource(const ezRecastNavMeshResourceHandle& hNavMesh)
 {
+  CancelPathSearches();
+
   m_hNavMesh = hNavMesh;
   m_pDetourNavMesh = nullptr;
   m_pNavMeshPointsOfInterest.Clear();
@@ -50,6 +101,8 @@ void ezRecastWorldModule::SetNavMeshResource(const ezRecastNavMeshResourceHandle
 
 void ezRecastWorldModule::UpdateNavMesh(const UpdateContext& ctxt)
 {
+  HandleNavMeshUnloading();
+
   if (m_pDetourNavMesh == nullptr && m_hNavMesh.IsValid())
   {
     ezResourceLock<ezRecastNavMeshResource> pNavMesh(m_hNavMesh, ezResourceAcquireMode::BlockTillLoaded_NeverFail);
@@ -74,7 +127,225 @@ void ezRecastWorldModule::ResourceEventHandler(const ezResourceEvent& e)
   if (e.m_Type == ezResourceEvent::Type::ResourceContentUnloading &&
       e.m_pResource->GetDynamicRTTI()->IsDerivedFrom<ezRecastNavMeshResource>())
   {
-    // triggers a recreation in the next update
-    m_pDetourNavMesh = nullptr;
+    // the event may come from any thread, the path searches are cancelled in the next update
+    m_iNavMeshUnloading.Set(1);
+  }
+}
+
+void ezRecastWorldModule::HandleNavMeshUnloading()
+{
+  if (m_iNavMeshUnloading.Set(0) == 0)
+    return;
+
+  // the navmesh must not be accessed by any path search anymore
+  CancelPathSearches();
+
+  // triggers a recreation in UpdateNavMesh()
+  m_pDetourNavMesh = nullptr;
+}
+
+ezResult ezRecastWorldModule::AddNavMeshTile(ezRecastNavMeshTile&& tile)
+{
+  EZ_ASSERT_DEV(m_hNavMesh.IsValid(), "No navmesh has been set");
+
+  // the worker threads must not query the navmesh while the tile is added
+  CancelPathSearches();
+
+  ezResourceLock<ezRecastNavMeshResource> pNavMesh(m_hNavMesh, ezResourceAcquireMode::BlockTillLoaded);
+  return pNavMesh->AddTile(std::move(tile));
+}
+
+ezResult ezRecastWorldModule::RemoveNavMeshTile(ezInt32 iTileX, ezInt32 iTileY)
+{
+  EZ_ASSERT_DEV(m_hNavMesh.IsValid(), "No navmesh has been set");
+
+  // the worker threads must not query the navmesh while the tile is removed
+  CancelPathSearches();
+
+  ezResourceLock<ezRecastNavMeshResource> pNavMesh(m_hNavMesh, ezResourceAcquireMode::BlockTillLoaded);
+  return pNavMesh->RemoveTile(iTileX, iTileY);
+}
+
+ezResult ezRecastWorldModule::FindNavMeshPolyAt(const dtNavMeshQuery& query, const dtQueryFilter& filter, const ezVec3& vPosition,
+  dtPolyRef& out_PolyRef, ezVec3* out_vAdjustedPosition /*= nullptr*/, float fPlaneEpsilon /*= 0.01f*/, float fHeightEpsilon /*= 1.0f*/)
+{
+  ezRcPos rcPos = vPosition;
+  ezVec3 vSize(fPlaneEpsilon, fHeightEpsilon, fPlaneEpsilon);
+
+  ezRcPos resultPos;
+  if (dtStatusFailed(query.findNearestPoly(rcPos, &vSize.x, &filter, &out_PolyRef, resultPos)))
+    return EZ_FAILURE;
+
+  if (!ezMath::IsEqual(vPosition.x, resultPos.m_Pos[0], fPlaneEpsilon) ||
+      !ezMath::IsEqual(vPosition.y, resultPos.m_Pos[2], fPlaneEpsilon) || !ezMath::IsEqual(vPosition.z, resultPos.m_Pos[1], fHeightEpsilon))
+    return EZ_FAILURE;
+
+  if (out_vAdjustedPosition != nullptr)
+  {
+    *out_vAdjustedPosition = resultPos;
+  }
+
+  return EZ_SUCCESS;
+}
+
+ezUInt32 ezRecastWorldModule::RequestPathSearch(const ezComponentHandle& hReceiver, const ezVec3& vStart, const ezVec3& vTarget)
+{
+  auto& request = m_PathRequests.ExpandAndGetRef();
+  request.m_uiRequestID = m_uiNextPathRequestID;
+  request.m_hReceiver = hReceiver;
+  request.m_vStart = vStart;
+  request.m_vTarget = vTarget;
+  request.m_RequestTime = ezTime::Now();
+
+  // zero is never a valid ID
+  m_uiNextPathRequestID = ezMath::Max(m_uiNextPathRequestID + 1, 1u);
+
+  return request.m_uiRequestID;
+}
+
+void ezRecastWorldModule::StartPathSearches(const UpdateContext& ctxt)
+{
+  EZ_ASSERT_DEV(m_PathSearches.IsEmpty(), "Path searches of the previous frame have not been finished");
+
+  HandleNavMeshUnloading();
+
+  if (m_pDetourNavMesh == nullptr || m_PathRequests.IsEmpty())
+    return;
+
+  const ezUInt32 uiNumSearches = ezMath::Min(m_PathRequests.GetCount(), m_uiMaxPathSearchesPerFrame);
+
+  m_PathSearches.SetCount(uiNumSearches);
+  for (ezUInt32 i = 0; i < uiNumSearches; ++i)
+  {
+    m_PathSearches[i].m_Request = m_PathRequests.PeekFront();
+    m_PathRequests.PopFront();
+  }
+
+  // one query object per invocation, so that the searches do not need to synchronize with each other
+  const ezUInt32 uiNumWorkers = ezMath::Max(ezTaskSystem::GetWorkerThreadCount(ezWorkerThreadType::ShortTasks), 1u);
+  m_uiPathSearchInvocations = ezMath::Min(uiNumSearches, uiNumWorkers);
+
+  while (m_QueryPool.GetCount() < m_uiPathSearchInvocations)
+  {
+    auto& pQuery = m_QueryPool.ExpandAndGetRef();
+    pQuery = EZ_DEFAULT_NEW(dtNavMeshQuery);
+
+    /// \todo Hard-coded limits
+    pQuery->init(m_pDetourNavMesh, 512);
   }
+
+  m_pPathSearchTask->SetMultiplicity(m_uiPathSearchInvocations);
+  m_PathSearchTaskGroup = ezTaskSystem::StartSingleTask(m_pPathSearchTask.Borrow(), ezTaskPriority::EarlyThisFrame);
+}
+
+void ezRecastWorldModule::FinishPathSearches(const UpdateContext& ctxt)
+{
+  ezTaskSystem::WaitForGroup(m_PathSearchTaskGroup);
+
+  m_PathSearchStats.m_uiQueuedRequests = m_PathRequests.GetCount();
+  m_PathSearchStats.m_uiSearchesLastFrame = m_PathSearches.GetCount();
+  m_PathSearchStats.m_AverageLatencyLastFrame.SetZero();
+  m_PathSearchStats.m_MaxLatencyLastFrame.SetZero();
+
+  const ezTime tNow = ezTime::Now();
+
+  for (const PathSearch& search : m_PathSearches)
+  {
+    const ezTime latency = tNow - search.m_Request.m_RequestTime;
+    m_PathSearchStats.m_AverageLatencyLastFrame += latency;
+    m_PathSearchStats.m_MaxLatencyLastFrame = ezMath::Max(m_PathSearchStats.m_MaxLatencyLastFrame, latency);
+
+    ezMsgRecastPathSearchResult msg;
+    msg.m_uiRequestID = search.m_Request.m_uiRequestID;
+    msg.m_Result = search.m_Result;
+    msg.m_vStartPosition = search.m_vStartOnNavMesh;
+    msg.m_vTargetPosition = search.m_Request.m_vTarget;
+    msg.m_PathCorridor = search.m_PathCorridor;
+
+    GetWorld()->SendMessage(search.m_Request.m_hReceiver, msg);
+  }
+
+  if (!m_PathSearches.IsEmpty())
+  {
+    m_PathSearchStats.m_AverageLatencyLastFrame = m_PathSearchStats.m_AverageLatencyLastFrame / (double)m_PathSearches.GetCount();
+  }
+
+  m_PathSearches.Clear();
+
+  {
+    ezStringBuilder sStatName;
+    sStatName.Format("World Update/{0}/Recast Path Searches", GetWorld()->GetName());
+    ezStats::SetStat(sStatName, m_PathSearchStats.m_uiSearchesLastFrame);
+
+    sStatName.Format("World Update/{0}/Recast Path Requests Queued", GetWorld()->GetName());
+    ezStats::SetStat(sStatName, m_PathSearchStats.m_uiQueuedRequests);
+
+    sStatName.Format("World Update/{0}/Recast Path Latency (ms)", GetWorld()->GetName());
+    ezStats::SetStat(sStatName, m_PathSearchStats.m_MaxLatencyLastFrame.GetMilliseconds());
+  }
+}
+
+void ezRecastWorldModule::CancelPathSearches()
+{
+  ezTaskSystem::WaitForGroup(m_PathSearchTaskGroup);
+
+  // the results may reference the old navmesh, so execute those searches again later
+  for (ezUInt32 i = m_PathSearches.GetCount(); i > 0; --i)
+  {
+    m_PathRequests.PushFront(m_PathSearches[i - 1].m_Request);
+  }
+
+  m_PathSearches.Clear();
+  m_QueryPool.Clear();
+}
+
+void ezRecastWorldModule::ExecutePathSearches(ezUInt32 uiInvocation)
+{
+  dtNavMeshQuery& query = *m_QueryPool[uiInvocation];
+
+  for (ezUInt32 i = uiInvocation; i < m_PathSearches.GetCount(); i += m_uiPathSearchInvocations)
+  {
+    ExecutePathSearch(query, m_PathSearches[i]);
+  }
+}
+
+void ezRecastWorldModule::ExecutePathSearch(dtNavMeshQuery& query, PathSearch& search) const
+{
+  search.m_vStartOnNavMesh = search.m_Request.m_vStart;
+
+  dtPolyRef startPoly;
+  if (FindNavMeshPolyAt(query, m_QueryFilter, search.m_Request.m_vStart, startPoly, &search.m_vStartOnNavMesh).Failed())
+  {
+    search.m_Result = ezRecastPathSearchResult::ErrorStartOutsideNavMesh;
+    return;
+  }
+
+  dtPolyRef endPoly;
+  if (FindNavMeshPolyAt(query, m_QueryFilter, search.m_Request.m_vTarget, endPoly).Failed())
+  {
+    search.m_Result = ezRecastPathSearchResult::ErrorTargetOutsideNavMesh;
+    return;
+  }
+
+  ezRcPos rcStart = search.m_vStartOnNavMesh;
+  ezRcPos rcEnd = search.m_Request.m_vTarget;
+
+  ezInt32 iPathCorridorLength = 0;
+
+  // make enough room
+  search.m_PathCorridor.SetCountUninitialized(256);
+  if (dtStatusFailed(query.findPath(startPoly, endPoly, rcStart, rcEnd, &m_QueryFilter, search.m_PathCorridor.GetData(), &iPathCorridorLength,
+        (int)search.m_PathCorridor.GetCount())) ||
+      iPathCorridorLength <= 0)
+  {
+    search.m_PathCorridor.Clear();
+    search.m_Result = ezRecastPathSearchResult::ErrorNoPath;
+    return;
+  }
+
+  // reduce to actual length
+  search.m_PathCorridor.SetCountUninitialized(iPathCorridorLength);
+
+  // if the path does not end in the target polygon, the target cannot be reached, but we can walk close to it
+  search.m_Result = search.m_PathCorridor[iPathCorridorLength - 1] == endPoly ? ezRecastPathSearchResult::Success : ezRecastPathSearchResult::PartialPath;
 }
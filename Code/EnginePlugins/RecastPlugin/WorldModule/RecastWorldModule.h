@@ -4,14 +4,49 @@
 
 #include <Core/ResourceManager/ResourceHandle.h>
 #include <Core/World/WorldModule.h>
+#include <Foundation/Communication/Message.h>
+#include <Foundation/Containers/Deque.h>
+#include <Foundation/Threading/AtomicInteger.h>
+#include <Foundation/Threading/TaskSystem.h>
 #include <NavMeshBuilder/NavMeshPointsOfInterest.h>
+#include <Recast/DetourNavMeshQuery.h>
 
 class dtCrowd;
 class dtNavMesh;
 struct ezResourceEvent;
+struct ezRecastNavMeshTile;
 
 typedef ezTypedResourceHandle<class ezRecastNavMeshResource> ezRecastNavMeshResourceHandle;
 
+struct ezRecastPathSearchResult
+{
+  enum Enum
+  {
+    Success,                   ///< A full path to the target was found
+    PartialPath,               ///< The target cannot be reached, the path only leads as close to it as possible
+    ErrorStartOutsideNavMesh,  ///< The start position is not on the navmesh
+    ErrorTargetOutsideNavMesh, ///< The target position is not on the navmesh
+    ErrorNoPath,               ///< No path could be found
+  };
+};
+
+/// \brief Sent by ezRecastWorldModule to the component that requested a path search, once the search has finished.
+struct EZ_RECASTPLUGIN_DLL ezMsgRecastPathSearchResult : public ezMessage
+{
+  EZ_DECLARE_MESSAGE_TYPE(ezMsgRecastPathSearchResult, ezMessage);
+
+  /// \brief The ID that was returned by ezRecastWorldModule::RequestPathSearch()
+  ezUInt32 m_uiRequestID = 0;
+  ezRecastPathSearchResult::Enum m_Result = ezRecastPathSearchResult::ErrorNoPath;
+
+  /// \brief The start position projected onto the navmesh
+  ezVec3 m_vStartPosition;
+  ezVec3 m_vTargetPosition;
+
+  /// \brief The polygons of the path corridor. Only valid while the message is being handled.
+  ezArrayPtr<const dtPolyRef> m_PathCorridor;
+};
+
 class EZ_RECASTPLUGIN_DLL ezRecastWorldModule : public ezWorldModule
 {
   EZ_DECLARE_WORLD_MODULE();
@@ -31,11 +66,89 @@ public:
   const ezNavMeshPointOfInterestGraph* GetNavMeshPointsOfInterestGraph() const { return m_pNavMeshPointsOfInterest.Borrow(); }
   ezNavMeshPointOfInterestGraph* AccessNavMeshPointsOfInterestGraph() const { return m_pNavMeshPointsOfInterest.Borrow(); }
 
+  /// \brief Adds a tile to the tiled navmesh of this world. If a tile with the same coordinates is already present, it gets replaced.
+  ///
+  /// Must be called on the thread that updates the world, while the world is locked for writing.
+  /// Running path searches are cancelled and executed again once the tile is in place.
+  /// If several worlds share the navmesh, none of the other worlds may be updated at the same time.
+  ezResult AddNavMeshTile(ezRecastNavMeshTile&& tile);
+
+  /// \brief Removes a tile from the tiled navmesh of this world. The same threading rules as for AddNavMeshTile() apply.
+  ezResult RemoveNavMeshTile(ezInt32 iTileX, ezInt32 iTileY);
+
+  /// \brief Finds the navmesh polygon at the given position (in ez convention).
+  static ezResult FindNavMeshPolyAt(const dtNavMeshQuery& query, const dtQueryFilter& filter, const ezVec3& vPosition, dtPolyRef& out_PolyRef,
+    ezVec3* out_vAdjustedPosition = nullptr, float fPlaneEpsilon = 0.01f, float fHeightEpsilon = 1.0f);
+
+  //////////////////////////////////////////////////////////////////////////
+  // Path Searches
+
+public:
+  /// \brief Queues a path search from vStart to vTarget.
+  ///
+  /// Path searches are executed in parallel on worker threads. Once a search has finished, the result is sent to hReceiver
+  /// as an ezMsgRecastPathSearchResult, during the PostTransform update phase.
+  /// Returns an ID (never zero) that is passed along with the result, to identify which request it belongs to.
+  ezUInt32 RequestPathSearch(const ezComponentHandle& hReceiver, const ezVec3& vStart, const ezVec3& vTarget);
+
+  /// \brief Sets how many path searches are executed per frame at most. Remaining requests are delayed to the following frames.
+  void SetMaxPathSearchesPerFrame(ezUInt32 uiMaxSearches) { m_uiMaxPathSearchesPerFrame = ezMath::Max(uiMaxSearches, 1u); }
+  ezUInt32 GetMaxPathSearchesPerFrame() const { return m_uiMaxPathSearchesPerFrame; }
+
+  struct PathSearchStats
+  {
+    ezUInt32 m_uiQueuedRequests = 0;     ///< Number of requests that are still waiting to be executed
+    ezUInt32 m_uiSearchesLastFrame = 0;  ///< Number of searches that were executed in the last frame
+    ezTime m_AverageLatencyLastFrame;    ///< Average time from request to result, of all results delivered in the last frame
+    ezTime m_MaxLatencyLastFrame;        ///< Maximum time from request to result, of all results delivered in the last frame
+  };
+
+  const PathSearchStats& GetPathSearchStats() const { return m_PathSearchStats; }
+
+private:
+  class PathSearchTask;
+
+  struct PathRequest
+  {
+    ezUInt32 m_uiRequestID = 0;
+    ezComponentHandle m_hReceiver;
+    ezVec3 m_vStart;
+    ezVec3 m_vTarget;
+    ezTime m_RequestTime;
+  };
+
+  struct PathSearch
+  {
+    PathRequest m_Request;
+    ezRecastPathSearchResult::Enum m_Result;
+    ezVec3 m_vStartOnNavMesh;
+    ezDynamicArray<dtPolyRef> m_PathCorridor;
+  };
+
+  void StartPathSearches(const UpdateContext& ctxt);
+  void FinishPathSearches(const UpdateContext& ctxt);
+  void CancelPathSearches();
+  void ExecutePathSearches(ezUInt32 uiInvocation);
+  void ExecutePathSearch(dtNavMeshQuery& query, PathSearch& search) const;
+
+  ezDeque<PathRequest> m_PathRequests;
+  ezDynamicArray<PathSearch> m_PathSearches;
+  ezDynamicArray<ezUniquePtr<dtNavMeshQuery>> m_QueryPool;
+  dtQueryFilter m_QueryFilter; /// \todo hard-coded filter
+  ezUniquePtr<PathSearchTask> m_pPathSearchTask;
+  ezTaskGroupID m_PathSearchTaskGroup;
+  ezUInt32 m_uiPathSearchInvocations = 0;
+  ezUInt32 m_uiNextPathRequestID = 1;
+  ezUInt32 m_uiMaxPathSearchesPerFrame = 64;
+  PathSearchStats m_PathSearchStats;
+
 private:
   void UpdateNavMesh(const UpdateContext& ctxt);
   void ResourceEventHandler(const ezResourceEvent& e);
+  void HandleNavMeshUnloading();
 
   const dtNavMesh* m_pDetourNavMesh = nullptr;
+  ezAtomicInteger32 m_iNavMeshUnloading; // set by ResourceEventHandler, which may be called from any thread
   ezRecastNavMeshResourceHandle m_hNavMesh;
   ezUniquePtr<ezNavMeshPointOfInterestGraph> m_pNavMeshPointsOfInterest;
 };
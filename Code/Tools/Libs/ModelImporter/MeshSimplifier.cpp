@@ -0,0 +1,344 @@
+#include <ModelImporterPCH.h>
+
+#include <Foundation/Containers/HashTable.h>
+#include <ModelImporter/MeshSimplifier.h>
+
+namespace ezModelImporter
+{
+  namespace
+  {
+    struct PositionHashHelper
+    {
+      EZ_ALWAYS_INLINE static ezUInt32 Hash(const ezVec3& value) { return ezHashingUtils::xxHash32(&value, sizeof(ezVec3)); }
+
+      EZ_ALWAYS_INLINE static bool Equal(const ezVec3& a, const ezVec3& b) { return a == b; }
+    };
+
+    /// Symmetric 4x4 matrix that sums up the squared distances of a point to a set of planes.
+    struct Quadric
+    {
+      void AddPlane(const ezVec3& vNormal, float fDistance)
+      {
+        const double a = vNormal.x;
+        const double b = vNormal.y;
+        const double c = vNormal.z;
+        const double d = fDistance;
+
+        m_aa += a * a;
+        m_ab += a * b;
+        m_ac += a * c;
+        m_ad += a * d;
+        m_bb += b * b;
+        m_bc += b * c;
+        m_bd += b * d;
+        m_cc += c * c;
+        m_cd += c * d;
+        m_dd += d * d;
+      }
+
+      void operator+=(const Quadric& rhs)
+      {
+        m_aa += rhs.m_aa;
+        m_ab += rhs.m_ab;
+        m_ac += rhs.m_ac;
+        m_ad += rhs.m_ad;
+        m_bb += rhs.m_bb;
+        m_bc += rhs.m_bc;
+        m_bd += rhs.m_bd;
+        m_cc += rhs.m_cc;
+        m_cd += rhs.m_cd;
+        m_dd += rhs.m_dd;
+      }
+
+      double Evaluate(const ezVec3& vPos) const
+      {
+        const double x = vPos.x;
+        const double y = vPos.y;
+        const double z = vPos.z;
+
+        return x * x * m_aa + 2.0 * x * y * m_ab + 2.0 * x * z * m_ac + 2.0 * x * m_ad + y * y * m_bb + 2.0 * y * z * m_bc + 2.0 * y * m_bd +
+               z * z * m_cc + 2.0 * z * m_cd + m_dd;
+      }
+
+      double m_aa = 0.0, m_ab = 0.0, m_ac = 0.0, m_ad = 0.0;
+      double m_bb = 0.0, m_bc = 0.0, m_bd = 0.0;
+      double m_cc = 0.0, m_cd = 0.0;
+      double m_dd = 0.0;
+    };
+
+    struct Collapse
+    {
+      EZ_DECLARE_POD_TYPE();
+
+      ezUInt32 m_uiFrom;
+      ezUInt32 m_uiTo;
+      float m_fError;
+
+      EZ_ALWAYS_INLINE bool operator<(const Collapse& rhs) const { return m_fError < rhs.m_fError; }
+    };
+
+    EZ_ALWAYS_INLINE ezUInt64 GetEdgeKey(ezUInt32 a, ezUInt32 b)
+    {
+      return a < b ? (static_cast<ezUInt64>(a) << 32) | b : (static_cast<ezUInt64>(b) << 32) | a;
+    }
+  } // namespace
+
+  void MeshSimplifier::Simplify(ezArrayPtr<const ezVec3> positions, ezArrayPtr<const ezUInt32> indices, ezUInt32 uiTargetTriangleCount,
+    float fMaxError, ezDynamicArray<ezUInt32>& out_Indices)
+  {
+    EZ_ASSERT_DEV(indices.GetCount() % 3 == 0, "Index count must be a multiple of 3");
+
+    out_Indices = indices;
+
+    const ezUInt32 uiVertexCount = positions.GetCount();
+
+    // Vertices that share their position with other vertices lie on an attribute seam and are locked.
+    // All other vertices are welded to themselves, so the welded index identifies the position.
+    ezDynamicArray<ezUInt32> weldedVertices;
+    ezDynamicArray<bool> lockedVertices;
+    weldedVertices.SetCountUninitialized(uiVertexCount);
+    lockedVertices.SetCount(uiVertexCount);
+    {
+      ezHashTable<ezVec3, ezUInt32, PositionHashHelper> positionToVertex;
+      positionToVertex.Reserve(uiVertexCount);
+
+      for (ezUInt32 v = 0; v < uiVertexCount; ++v)
+      {
+        ezUInt32 uiWelded = v;
+        if (positionToVertex.TryGetValue(positions[v], uiWelded))
+        {
+          lockedVertices[v] = true;
+          lockedVertices[uiWelded] = true;
+        }
+        else
+        {
+          positionToVertex.Insert(positions[v], v);
+        }
+
+        weldedVertices[v] = uiWelded;
+      }
+    }
+
+    // Vertices on open borders or non-manifold edges are locked as well, otherwise the silhouette would erode.
+    {
+      ezHashTable<ezUInt64, ezUInt32> edgeUseCount;
+      edgeUseCount.Reserve(indices.GetCount());
+
+      for (ezUInt32 i = 0; i < indices.GetCount(); i += 3)
+      {
+        for (ezUInt32 e = 0; e < 3; ++e)
+        {
+          const ezUInt64 uiKey = GetEdgeKey(weldedVertices[indices[i + e]], weldedVertices[indices[i + (e + 1) % 3]]);
+
+          ezUInt32* pCount = nullptr;
+          if (edgeUseCount.TryGetValue(uiKey, pCount))
+            ++(*pCount);
+          else
+            edgeUseCount.Insert(uiKey, 1);
+        }
+      }
+
+      for (auto it = edgeUseCount.GetIterator(); it.IsValid(); ++it)
+      {
+        if (it.Value() != 2)
+        {
+          lockedVertices[static_cast<ezUInt32>(it.Key() >> 32)] = true;
+          lockedVertices[static_cast<ezUInt32>(it.Key() & 0xFFFFFFFFu)] = true;
+        }
+      }
+    }
+
+    ezDynamicArray<Quadric> quadrics;
+    quadrics.SetCount(uiVertexCount);
+
+    for (ezUInt32 i = 0; i < indices.GetCount(); i += 3)
+    {
+      const ezVec3& p0 = positions[indices[i + 0]];
+      const ezVec3& p1 = positions[indices[i + 1]];
+      const ezVec3& p2 = positions[indices[i + 2]];
+
+      ezVec3 vNormal = (p1 - p0).CrossRH(p2 - p0);
+      if (vNormal.NormalizeIfNotZero(ezVec3::ZeroVector()).Failed())
+        continue;
+
+      Quadric q;
+      q.AddPlane(vNormal, -vNormal.Dot(p0));
+
+      quadrics[indices[i + 0]] += q;
+      quadrics[indices[i + 1]] += q;
+      quadrics[indices[i + 2]] += q;
+    }
+
+    ezDynamicArray<ezUInt32> adjacencyOffsets;
+    ezDynamicArray<ezUInt32> adjacency;
+    ezDynamicArray<Collapse> collapses;
+    ezDynamicArray<ezUInt32> remap;
+    ezDynamicArray<bool> touchedVertices;
+
+    ezUInt32 uiTriangleCount = out_Indices.GetCount() / 3;
+
+    // Every pass collapses as many independent edges as possible, cheapest first, and then rebuilds the triangle list.
+    while (uiTriangleCount > uiTargetTriangleCount)
+    {
+      // vertex to triangle adjacency
+      adjacencyOffsets.Clear();
+      adjacencyOffsets.SetCount(uiVertexCount + 1);
+      for (ezUInt32 uiIndex : out_Indices)
+      {
+        ++adjacencyOffsets[uiIndex + 1];
+      }
+
+      for (ezUInt32 v = 0; v < uiVertexCount; ++v)
+      {
+        adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+      }
+
+      adjacency.SetCountUninitialized(out_Indices.GetCount());
+      for (ezUInt32 i = 0; i < out_Indices.GetCount(); ++i)
+      {
+        const ezUInt32 uiVertex = out_Indices[i];
+        adjacency[adjacencyOffsets[uiVertex]++] = i / 3;
+      }
+
+      // the fill loop shifted all offsets by one vertex
+      for (ezUInt32 v = uiVertexCount; v > 0; --v)
+      {
+        adjacencyOffsets[v] = adjacencyOffsets[v - 1];
+      }
+      adjacencyOffsets[0] = 0;
+
+      collapses.Clear();
+      for (ezUInt32 i = 0; i < out_Indices.GetCount(); i += 3)
+      {
+        for (ezUInt32 e = 0; e < 3; ++e)
+        {
+          const ezUInt32 a = out_Indices[i + e];
+          const ezUInt32 b = out_Indices[i + (e + 1) % 3];
+
+          for (ezUInt32 uiDir = 0; uiDir < 2; ++uiDir)
+          {
+            const ezUInt32 uiFrom = uiDir == 0 ? a : b;
+            const ezUInt32 uiTo = uiDir == 0 ? b : a;
+
+            if (lockedVertices[uiFrom])
+              continue;
+
+            Quadric q = quadrics[uiFrom];
+            q += quadrics[uiTo];
+
+            const float fError = static_cast<float>(ezMath::Max(q.Evaluate(positions[uiTo]), 0.0));
+            if (fError > fMaxError)
+              continue;
+
+            Collapse& collapse = collapses.ExpandAndGetRef();
+            collapse.m_uiFrom = uiFrom;
+            collapse.m_uiTo = uiTo;
+            collapse.m_fError = fError;
+          }
+        }
+      }
+
+      if (collapses.IsEmpty())
+        break;
+
+      collapses.Sort();
+
+      remap.SetCountUninitialized(uiVertexCount);
+      for (ezUInt32 v = 0; v < uiVertexCount; ++v)
+      {
+        remap[v] = v;
+      }
+
+      touchedVertices.Clear();
+      touchedVertices.SetCount(uiVertexCount);
+
+      ezUInt32 uiRemainingTriangles = uiTriangleCount;
+      bool bAnyCollapse = false;
+
+      for (const Collapse& collapse : collapses)
+      {
+        if (uiRemainingTriangles <= uiTargetTriangleCount)
+          break;
+
+        // Vertices around a collapse are not touched again in the same pass, which keeps the adjacency and the flip test valid.
+        if (touchedVertices[collapse.m_uiFrom] || touchedVertices[collapse.m_uiTo])
+          continue;
+
+        const ezUInt32 uiFirstTriangle = adjacencyOffsets[collapse.m_uiFrom];
+        const ezUInt32 uiLastTriangle = adjacencyOffsets[collapse.m_uiFrom + 1];
+
+        // reject the collapse if any of the remaining triangles around the vertex would flip over
+        bool bFlips = false;
+        ezUInt32 uiRemovedTriangles = 0;
+        for (ezUInt32 t = uiFirstTriangle; t < uiLastTriangle && !bFlips; ++t)
+        {
+          const ezUInt32* pTriangle = out_Indices.GetData() + adjacency[t] * 3;
+
+          if (pTriangle[0] == collapse.m_uiTo || pTriangle[1] == collapse.m_uiTo || pTriangle[2] == collapse.m_uiTo)
+          {
+            ++uiRemovedTriangles;
+            continue;
+          }
+
+          ezVec3 p[3];
+          for (ezUInt32 k = 0; k < 3; ++k)
+          {
+            p[k] = positions[pTriangle[k]];
+          }
+
+          const ezVec3 vNormalBefore = (p[1] - p[0]).CrossRH(p[2] - p[0]);
+
+          for (ezUInt32 k = 0; k < 3; ++k)
+          {
+            if (pTriangle[k] == collapse.m_uiFrom)
+              p[k] = positions[collapse.m_uiTo];
+          }
+
+          const ezVec3 vNormalAfter = (p[1] - p[0]).CrossRH(p[2] - p[0]);
+
+          bFlips = vNormalBefore.Dot(vNormalAfter) <= 0.0f;
+        }
+
+        if (bFlips)
+          continue;
+
+        remap[collapse.m_uiFrom] = collapse.m_uiTo;
+        quadrics[collapse.m_uiTo] += quadrics[collapse.m_uiFrom];
+
+        for (ezUInt32 t = uiFirstTriangle; t < uiLastTriangle; ++t)
+        {
+          const ezUInt32* pTriangle = out_Indices.GetData() + adjacency[t] * 3;
+          touchedVertices[pTriangle[0]] = true;
+          touchedVertices[pTriangle[1]] = true;
+          touchedVertices[pTriangle[2]] = true;
+        }
+
+        uiRemainingTriangles -= ezMath::Min(uiRemovedTriangles, uiRemainingTriangles);
+        bAnyCollapse = true;
+      }
+
+      if (!bAnyCollapse)
+        break;
+
+      // apply the collapses and remove the triangles that became degenerate
+      ezUInt32 uiWriteIndex = 0;
+      for (ezUInt32 i = 0; i < out_Indices.GetCount(); i += 3)
+      {
+        const ezUInt32 i0 = remap[out_Indices[i + 0]];
+        const ezUInt32 i1 = remap[out_Indices[i + 1]];
+        const ezUInt32 i2 = remap[out_Indices[i + 2]];
+
+        if (i0 == i1 || i1 == i2 || i0 == i2)
+          continue;
+
+        out_Indices[uiWriteIndex + 0] = i0;
+        out_Indices[uiWriteIndex + 1] = i1;
+        out_Indices[uiWriteIndex + 2] = i2;
+        uiWriteIndex += 3;
+      }
+
+      out_Indices.SetCount(uiWriteIndex);
+      uiTriangleCount = uiWriteIndex / 3;
+    }
+  }
+} // namespace ezModelImporter
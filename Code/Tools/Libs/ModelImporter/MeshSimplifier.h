@@ -0,0 +1,26 @@
+#pragma once
+
+#include <Foundation/Containers/DynamicArray.h>
+#include <Foundation/Math/Vec3.h>
+#include <ModelImporter/ModelImporterDLL.h>
+
+namespace ezModelImporter
+{
+  /// Reduces the number of triangles of an indexed triangle list through quadric error metric edge collapses.
+  ///
+  /// Vertices are only ever collapsed onto other existing vertices (half edge collapses), so the simplified triangles reference a subset of
+  /// the original vertices and can share the vertex buffer of the source mesh, e.g. to store several levels of detail in one mesh buffer.
+  /// Vertices on open borders and on attribute seams (several vertices with the same position) are never removed, which keeps the silhouette
+  /// and texture seams intact at the cost of a lower reduction for meshes with many seams.
+  class EZ_MODELIMPORTER_DLL MeshSimplifier
+  {
+  public:
+    /// Simplifies the triangles given by \a indices until at most \a uiTargetTriangleCount triangles are left or no collapse is possible
+    /// anymore without exceeding \a fMaxError.
+    ///
+    /// \a fMaxError is the maximum squared distance of a removed vertex to the surface of the simplified mesh.
+    /// The simplified triangles are written to \a out_Indices, which may not be the same array as \a indices.
+    static void Simplify(ezArrayPtr<const ezVec3> positions, ezArrayPtr<const ezUInt32> indices, ezUInt32 uiTargetTriangleCount,
+      float fMaxError, ezDynamicArray<ezUInt32>& out_Indices);
+  };
+} // namespace ezModelImporter
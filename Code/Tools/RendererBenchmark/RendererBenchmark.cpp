@@ -0,0 +1,640 @@
+#include <Core/Graphics/Camera.h>
+#include <Core/Graphics/Geometry.h>
+#include <Core/ResourceManager/ResourceManager.h>
+#include <Core/World/World.h>
+#include <Foundation/Application/Application.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/Configuration/Startup.h>
+#include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/Logging/ConsoleWriter.h>
+#include <Foundation/Logging/Log.h>
+#include <Foundation/Logging/VisualStudioWriter.h>
+#include <Foundation/Profiling/Profiling.h>
+#include <Foundation/Reflection/ReflectionUtils.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Clock.h>
+#include <Foundation/Utilities/CommandLineUtils.h>
+#include <RendererCore/GPUResourcePool/GPUResourcePool.h>
+#include <RendererCore/Lights/AmbientLightComponent.h>
+#include <RendererCore/Lights/ClusteredDataExtractor.h>
+#include <RendererCore/Lights/DirectionalLightComponent.h>
+#include <RendererCore/Lights/PointLightComponent.h>
+#include <RendererCore/Lights/SpotLightComponent.h>
+#include <RendererCore/Material/MaterialResource.h>
+#include <RendererCore/Meshes/MeshComponent.h>
+#include <RendererCore/Meshes/MeshResourceDescriptor.h>
+#include <RendererCore/Pipeline/Extractor.h>
+#include <RendererCore/Pipeline/Implementation/RenderPipelineResourceLoader.h>
+#include <RendererCore/Pipeline/Passes/OpaqueForwardRenderPass.h>
+#include <RendererCore/Pipeline/Passes/SourcePass.h>
+#include <RendererCore/Pipeline/Passes/TargetPass.h>
+#include <RendererCore/Pipeline/RenderPipeline.h>
+#include <RendererCore/Pipeline/RenderPipelineResource.h>
+#include <RendererCore/Pipeline/View.h>
+#include <RendererCore/RenderContext/RenderContext.h>
+#include <RendererCore/RenderWorld/RenderWorld.h>
+#include <RendererCore/Shader/ShaderResource.h>
+#include <RendererCore/ShaderCompiler/ShaderManager.h>
+#include <RendererNull/Context/ContextNull.h>
+#include <RendererNull/Device/DeviceNull.h>
+
+/* ezRendererBenchmark command line options:
+
+-frames <count>          Number of measured frames. Default is 500.
+-warmup <count>          Number of frames that are rendered before the measurement starts. Default is 50.
+-objects <count>         Number of mesh objects, placed on a grid. Default is 10000.
+-lights <count>          Number of point lights. Default is 64.
+-spotLights <count>      Number of spot lights with random directions and angles. Default is 0.
+-seed <value>            Seed for the random light positions, colors and ranges. Default is 42.
+-width <pixels>          Width of the render target. Default is 1920.
+-height <pixels>         Height of the render target. Default is 1080.
+-shaderPlatform <name>   Platform of the precompiled shaders in the shader cache. Default is DX11_SM50.
+
+The benchmark renders a synthetic scene through a forward render pipeline on the null graphics device,
+so only the CPU side of the renderer is measured and no GPU is needed.
+Shaders are never compiled, so the shader cache must contain precompiled permutations for the given platform.
+Otherwise shaders fail to load and nothing is drawn, which is reported as zero draw calls.
+
+Example:
+
+ezRendererBenchmark -frames 1000 -objects 50000 -lights 256
+ezRendererBenchmark -objects 1000 -lights 768 -spotLights 250 -seed 7
+
+*/
+
+class ezRendererBenchmark : public ezApplication
+{
+public:
+  typedef ezApplication SUPER;
+
+  ezRendererBenchmark()
+    : ezApplication("RendererBenchmark")
+  {
+  }
+
+  virtual void AfterCoreSystemsStartup() override
+  {
+    ezGlobalLog::AddLogWriter(ezLogWriter::Console::LogMessageHandler);
+    ezGlobalLog::AddLogWriter(ezLogWriter::VisualStudio::LogMessageHandler);
+
+    ezFileSystem::AddDataDirectory("", "", ":", ezFileSystem::AllowWrites);
+    ezFileSystem::AddDataDirectory(">appdir/", "ShaderCache", "shadercache");
+    ezFileSystem::AddDataDirectory(">sdk/Data/Base", "Base", "base");
+
+    ezCommandLineUtils& cmd = *ezCommandLineUtils::GetGlobalInstance();
+    m_uiNumFrames = ezMath::Max(cmd.GetUIntOption("-frames", 500), 1u);
+    m_uiNumWarmupFrames = cmd.GetUIntOption("-warmup", 50);
+    m_uiNumObjects = cmd.GetUIntOption("-objects", 10000);
+    m_uiNumLights = cmd.GetUIntOption("-lights", 64);
+    m_uiNumSpotLights = cmd.GetUIntOption("-spotLights", 0);
+    m_uiSeed = cmd.GetUIntOption("-seed", 42);
+    m_uiWidth = ezMath::Max(cmd.GetUIntOption("-width", 1920), 1u);
+    m_uiHeight = ezMath::Max(cmd.GetUIntOption("-height", 1080), 1u);
+    m_sShaderPlatform = cmd.GetStringOption("-shaderPlatform", 0, "DX11_SM50");
+
+    // Update, extraction and rendering are timed separately, so they must not overlap
+    if (ezCVar* pCVar = ezCVar::FindCVarByName("r_Multithreading"))
+    {
+      *static_cast<ezCVarBool*>(pCVar) = false;
+    }
+
+    {
+      ezGALDeviceCreationDescription deviceDesc;
+      deviceDesc.m_bCreatePrimarySwapChain = false;
+
+      m_pDevice = EZ_DEFAULT_NEW(ezGALDeviceNull, deviceDesc);
+      EZ_VERIFY(m_pDevice->Init() == EZ_SUCCESS, "Device init failed!");
+
+      ezGALDevice::SetDefaultDevice(m_pDevice);
+    }
+
+    ezStartup::StartupHighLevelSystems();
+
+    ezGPUResourcePool::SetDefaultInstance(EZ_DEFAULT_NEW(ezGPUResourcePool));
+
+    ezShaderManager::Configure(m_sShaderPlatform, false);
+
+    CreateRenderTargets();
+    CreateWorld();
+    CreateView();
+  }
+
+  virtual void BeforeHighLevelSystemsShutdown() override
+  {
+    ezRenderWorld::DeleteView(m_hView);
+    m_hView.Invalidate();
+
+    m_pWorld.Clear();
+
+    m_hMesh.Invalidate();
+    m_hMaterial.Invalidate();
+
+    m_pDevice->DestroyTexture(m_hColorTexture);
+    m_pDevice->DestroyTexture(m_hDepthTexture);
+
+    ezGPUResourcePool* pResourcePool = ezGPUResourcePool::GetDefaultInstance();
+    ezGPUResourcePool::SetDefaultInstance(nullptr);
+    EZ_DEFAULT_DELETE(pResourcePool);
+
+    ezResourceManager::FreeAllUnusedResources();
+
+    ezStartup::ShutdownHighLevelSystems();
+
+    m_pDevice->Shutdown();
+    EZ_DEFAULT_DELETE(m_pDevice);
+  }
+
+  virtual void BeforeCoreSystemsShutdown() override
+  {
+    // prevent further output during shutdown
+    ezGlobalLog::RemoveLogWriter(ezLogWriter::Console::LogMessageHandler);
+    ezGlobalLog::RemoveLogWriter(ezLogWriter::VisualStudio::LogMessageHandler);
+
+    SUPER::BeforeCoreSystemsShutdown();
+  }
+
+  virtual ezApplication::ApplicationExecution Run() override
+  {
+    ezLog::Info("Rendering {0} objects, {1} point lights and {2} spot lights at {3}x{4}", m_uiNumObjects, m_uiNumLights, m_uiNumSpotLights,
+      m_uiWidth, m_uiHeight);
+
+    for (ezUInt32 i = 0; i < m_uiNumWarmupFrames; ++i)
+    {
+      RenderFrame(nullptr);
+    }
+
+    ezGALContextNull* pContext = m_pDevice->GetPrimaryContext<ezGALContextNull>();
+    pContext->ResetStatistics();
+
+    m_MeasurementStartTime = ezTime::Now();
+
+    for (ezUInt32 i = 0; i < m_uiNumFrames; ++i)
+    {
+      RenderFrame(&m_Stages);
+    }
+
+    const ezTime measurementEndTime = ezTime::Now();
+
+    PrintStageTimings(measurementEndTime - m_MeasurementStartTime);
+    PrintDeviceStatistics();
+    PrintProfilingScopes(measurementEndTime);
+
+    return ezApplication::Quit;
+  }
+
+private:
+  struct Stage
+  {
+    enum Enum
+    {
+      WorldUpdate,
+      Extraction,
+      Render,
+      FinishFrame,
+
+      ENUM_COUNT
+    };
+
+    static const char* GetName(Enum stage)
+    {
+      static const char* s_szNames[] = {"World Update", "Extraction", "Render", "Finish Frame"};
+      return s_szNames[stage];
+    }
+  };
+
+  struct StageTimings
+  {
+    ezTime m_Total[Stage::ENUM_COUNT];
+    ezTime m_Min[Stage::ENUM_COUNT];
+    ezTime m_Max[Stage::ENUM_COUNT];
+
+    ezUInt64 m_uiDrawCalls = 0;
+    ezUInt64 m_uiStateChanges = 0;
+    ezUInt64 m_uiRedundantStateChanges = 0;
+
+    ezUInt64 m_uiSkippedBindings = 0;
+    ezUInt64 m_uiPermutationCacheHits = 0;
+    ezUInt64 m_uiPermutationCacheMisses = 0;
+
+    StageTimings()
+    {
+      for (ezUInt32 i = 0; i < Stage::ENUM_COUNT; ++i)
+      {
+        m_Min[i] = ezTime::Seconds(1000.0);
+      }
+    }
+
+    void Add(Stage::Enum stage, ezTime duration)
+    {
+      m_Total[stage] += duration;
+      m_Min[stage] = ezMath::Min(m_Min[stage], duration);
+      m_Max[stage] = ezMath::Max(m_Max[stage], duration);
+    }
+  };
+
+  void CreateRenderTargets()
+  {
+    ezGALTextureCreationDescription texDesc;
+    texDesc.m_uiWidth = m_uiWidth;
+    texDesc.m_uiHeight = m_uiHeight;
+    texDesc.m_Format = ezGALResourceFormat::RGBAUByteNormalizedsRGB;
+    texDesc.m_bCreateRenderTarget = true;
+    m_hColorTexture = m_pDevice->CreateTexture(texDesc);
+
+    texDesc.m_Format = ezGALResourceFormat::D24S8;
+    m_hDepthTexture = m_pDevice->CreateTexture(texDesc);
+  }
+
+  void CreateWorld()
+  {
+    ezWorldDesc worldDesc("RendererBenchmark");
+    m_pWorld = EZ_DEFAULT_NEW(ezWorld, worldDesc);
+
+    EZ_LOCK(m_pWorld->GetWriteMarker());
+
+    CreateMeshAndMaterial();
+
+    // all objects are static, so the render data cache is used like in a typical level
+    const ezUInt32 uiGridSize = ezMath::Max((ezUInt32)ezMath::Ceil(ezMath::Sqrt((float)m_uiNumObjects)), 1u);
+    const float fSpacing = 3.0f;
+    const float fHalfExtent = uiGridSize * fSpacing * 0.5f;
+
+    for (ezUInt32 i = 0; i < m_uiNumObjects; ++i)
+    {
+      ezGameObjectDesc obj;
+      obj.m_LocalPosition.Set((i % uiGridSize) * fSpacing - fHalfExtent, (i / uiGridSize) * fSpacing - fHalfExtent, 0.0f);
+
+      ezGameObject* pObj = nullptr;
+      m_pWorld->CreateObject(obj, pObj);
+
+      ezMeshComponent* pMesh = nullptr;
+      ezMeshComponent::CreateComponent(pObj, pMesh);
+      pMesh->SetMesh(m_hMesh);
+    }
+
+    ezRandom rng;
+    rng.Initialize(m_uiSeed);
+
+    for (ezUInt32 i = 0; i < m_uiNumLights; ++i)
+    {
+      ezGameObjectDesc obj;
+      obj.m_LocalPosition.Set(
+        (float)rng.DoubleMinMax(-fHalfExtent, fHalfExtent), (float)rng.DoubleMinMax(-fHalfExtent, fHalfExtent), (float)rng.DoubleMinMax(1.0, 5.0));
+
+      ezGameObject* pObj = nullptr;
+      m_pWorld->CreateObject(obj, pObj);
+
+      ezPointLightComponent* pLight = nullptr;
+      ezPointLightComponent::CreateComponent(pObj, pLight);
+      pLight->SetRange(fSpacing * (float)rng.DoubleMinMax(1.0, 8.0));
+      pLight->SetLightColor(ezColorGammaUB(rng.UIntInRange(256), rng.UIntInRange(256), rng.UIntInRange(256)));
+    }
+
+    for (ezUInt32 i = 0; i < m_uiNumSpotLights; ++i)
+    {
+      ezGameObjectDesc obj;
+      obj.m_LocalPosition.Set(
+        (float)rng.DoubleMinMax(-fHalfExtent, fHalfExtent), (float)rng.DoubleMinMax(-fHalfExtent, fHalfExtent), (float)rng.DoubleMinMax(2.0, 8.0));
+
+      // point downwards with a random tilt and heading
+      ezQuat tilt;
+      tilt.SetFromAxisAndAngle(ezVec3(0.0f, 1.0f, 0.0f), ezAngle::Degree((float)rng.DoubleMinMax(30.0, 150.0)));
+      ezQuat heading;
+      heading.SetFromAxisAndAngle(ezVec3(0.0f, 0.0f, 1.0f), ezAngle::Degree((float)rng.DoubleMinMax(0.0, 360.0)));
+      obj.m_LocalRotation = heading * tilt;
+
+      ezGameObject* pObj = nullptr;
+      m_pWorld->CreateObject(obj, pObj);
+
+      const float fOuterAngle = (float)rng.DoubleMinMax(10.0, 120.0);
+
+      ezSpotLightComponent* pLight = nullptr;
+      ezSpotLightComponent::CreateComponent(pObj, pLight);
+      pLight->SetRange(fSpacing * (float)rng.DoubleMinMax(2.0, 12.0));
+      pLight->SetOuterSpotAngle(ezAngle::Degree(fOuterAngle));
+      pLight->SetInnerSpotAngle(ezAngle::Degree(fOuterAngle * 0.5f));
+      pLight->SetLightColor(ezColorGammaUB(rng.UIntInRange(256), rng.UIntInRange(256), rng.UIntInRange(256)));
+    }
+
+    {
+      ezGameObjectDesc obj;
+      obj.m_LocalRotation.SetFromAxisAndAngle(ezVec3(0.0f, 1.0f, 0.0f), ezAngle::Degree(60.0f));
+
+      ezGameObject* pObj = nullptr;
+      m_pWorld->CreateObject(obj, pObj);
+
+      ezDirectionalLightComponent* pDirLight = nullptr;
+      ezDirectionalLightComponent::CreateComponent(pObj, pDirLight);
+
+      ezAmbientLightComponent* pAmbLight = nullptr;
+      ezAmbientLightComponent::CreateComponent(pObj, pAmbLight);
+    }
+
+    // look at the grid from above, so that most objects are visible
+    m_Camera.LookAt(ezVec3(-fHalfExtent, 0.0f, fHalfExtent * 0.5f), ezVec3(0.0f, 0.0f, 0.0f), ezVec3(0.0f, 0.0f, 1.0f));
+    m_Camera.SetCameraMode(ezCameraMode::PerspectiveFixedFovX, 90.0f, 0.1f, fHalfExtent * 4.0f);
+  }
+
+  void CreateMeshAndMaterial()
+  {
+    {
+      ezMaterialResourceDescriptor desc;
+      desc.m_hShader = ezResourceManager::LoadResource<ezShaderResource>("Shaders/Materials/DefaultMaterial.ezShader");
+
+      m_hMaterial = ezResourceManager::CreateResource<ezMaterialResource>("RendererBenchmarkMaterial", std::move(desc));
+    }
+
+    ezGeometry geom;
+    geom.AddGeodesicSphere(1.0f, 2, ezColor::White);
+    geom.ComputeTangents();
+
+    ezMeshBufferResourceDescriptor bufferDesc;
+    bufferDesc.AddStream(ezGALVertexAttributeSemantic::Position, ezGALResourceFormat::XYZFloat);
+    bufferDesc.AddStream(ezGALVertexAttributeSemantic::TexCoord0, ezGALResourceFormat::XYFloat);
+    bufferDesc.AddStream(ezGALVertexAttributeSemantic::Normal, ezGALResourceFormat::XYZFloat);
+    bufferDesc.AddStream(ezGALVertexAttributeSemantic::Tangent, ezGALResourceFormat::XYZFloat);
+    bufferDesc.AllocateStreamsFromGeometry(geom, ezGALPrimitiveTopology::Triangles);
+
+    ezMeshBufferResourceHandle hMeshBuffer =
+      ezResourceManager::CreateResource<ezMeshBufferResource>("RendererBenchmarkMeshBuffer", std::move(bufferDesc));
+
+    ezResourceLock<ezMeshBufferResource> pMeshBuffer(hMeshBuffer, ezResourceAcquireMode::BlockTillLoaded);
+
+    ezMeshResourceDescriptor meshDesc;
+    meshDesc.UseExistingMeshBuffer(hMeshBuffer);
+    meshDesc.AddSubMesh(pMeshBuffer->GetPrimitiveCount(), 0, 0);
+    meshDesc.SetMaterial(0, "RendererBenchmarkMaterial");
+    meshDesc.ComputeBounds();
+
+    m_hMesh = ezResourceManager::CreateResource<ezMeshResource>("RendererBenchmarkMesh", std::move(meshDesc));
+  }
+
+  ezRenderPipelineResourceHandle CreateRenderPipeline()
+  {
+    ezUniquePtr<ezRenderPipeline> pRenderPipeline = EZ_DEFAULT_NEW(ezRenderPipeline);
+
+    ezSourcePass* pColorSourcePass = nullptr;
+    {
+      ezUniquePtr<ezSourcePass> pPass = EZ_DEFAULT_NEW(ezSourcePass, "ColorSource");
+      pColorSourcePass = pPass.Borrow();
+      pRenderPipeline->AddPass(std::move(pPass));
+    }
+
+    ezSourcePass* pDepthSourcePass = nullptr;
+    {
+      ezUniquePtr<ezSourcePass> pPass = EZ_DEFAULT_NEW(ezSourcePass, "DepthStencil");
+      pDepthSourcePass = pPass.Borrow();
+
+      ezAbstractMemberProperty* pFormatProp =
+        static_cast<ezAbstractMemberProperty*>(pDepthSourcePass->GetDynamicRTTI()->FindPropertyByName("Format"));
+      ezReflectionUtils::SetMemberPropertyValue(pFormatProp, pDepthSourcePass, (ezInt64)ezGALResourceFormat::D24S8);
+
+      pRenderPipeline->AddPass(std::move(pPass));
+    }
+
+    ezOpaqueForwardRenderPass* pOpaquePass = nullptr;
+    {
+      ezUniquePtr<ezOpaqueForwardRenderPass> pPass = EZ_DEFAULT_NEW(ezOpaqueForwardRenderPass);
+      pOpaquePass = pPass.Borrow();
+      pRenderPipeline->AddPass(std::move(pPass));
+    }
+
+    ezTargetPass* pTargetPass = nullptr;
+    {
+      ezUniquePtr<ezTargetPass> pPass = EZ_DEFAULT_NEW(ezTargetPass);
+      pTargetPass = pPass.Borrow();
+      pRenderPipeline->AddPass(std::move(pPass));
+    }
+
+    EZ_VERIFY(pRenderPipeline->Connect(pColorSourcePass, "Output", pOpaquePass, "Color"), "Connect failed!");
+    EZ_VERIFY(pRenderPipeline->Connect(pDepthSourcePass, "Output", pOpaquePass, "DepthStencil"), "Connect failed!");
+    EZ_VERIFY(pRenderPipeline->Connect(pOpaquePass, "Color", pTargetPass, "Color0"), "Connect failed!");
+    EZ_VERIFY(pRenderPipeline->Connect(pOpaquePass, "DepthStencil", pTargetPass, "DepthStencil"), "Connect failed!");
+
+    pRenderPipeline->AddExtractor(EZ_DEFAULT_NEW(ezVisibleObjectsExtractor));
+    pRenderPipeline->AddExtractor(EZ_DEFAULT_NEW(ezClusteredDataExtractor));
+
+    ezRenderPipelineResourceDescriptor desc;
+    ezRenderPipelineResourceLoader::CreateRenderPipelineResourceDescriptor(pRenderPipeline.Borrow(), desc);
+
+    return ezResourceManager::CreateResource<ezRenderPipelineResource>("RendererBenchmarkPipeline", std::move(desc), "RendererBenchmarkPipeline");
+  }
+
+  void CreateView()
+  {
+    ezView* pView = nullptr;
+    m_hView = ezRenderWorld::CreateView("RendererBenchmark", pView);
+    pView->SetCameraUsageHint(ezCameraUsageHint::MainView);
+
+    ezGALRenderTargetSetup renderTargetSetup;
+    renderTargetSetup.SetRenderTarget(0, m_pDevice->GetDefaultRenderTargetView(m_hColorTexture));
+    renderTargetSetup.SetDepthStencilTarget(m_pDevice->GetDefaultRenderTargetView(m_hDepthTexture));
+    pView->SetRenderTargetSetup(renderTargetSetup);
+    pView->SetRenderPipelineResource(CreateRenderPipeline());
+    pView->SetViewport(ezRectFloat(0.0f, 0.0f, (float)m_uiWidth, (float)m_uiHeight));
+    pView->SetWorld(m_pWorld.Borrow());
+    pView->SetCamera(&m_Camera);
+
+    ezRenderWorld::AddMainView(m_hView);
+  }
+
+  void RenderFrame(StageTimings* pTimings)
+  {
+    ezTime stageStart = ezTime::Now();
+    auto EndStage = [&](Stage::Enum stage) {
+      const ezTime now = ezTime::Now();
+      if (pTimings != nullptr)
+      {
+        pTimings->Add(stage, now - stageStart);
+      }
+      stageStart = now;
+    };
+
+    ezClock::GetGlobalClock()->Update();
+
+    ezRenderWorld::BeginFrame();
+    m_pDevice->BeginFrame();
+
+    {
+      EZ_LOCK(m_pWorld->GetWriteMarker());
+      m_pWorld->Update();
+    }
+    EndStage(Stage::WorldUpdate);
+
+    ezRenderWorld::ExtractMainViews();
+    EndStage(Stage::Extraction);
+
+    ezRenderWorld::Render(ezRenderContext::GetDefaultInstance());
+    EndStage(Stage::Render);
+
+    const ezRenderContext::Statistics renderContextStats = ezRenderContext::GetDefaultInstance()->GetAndResetStatistics();
+
+    if (pTimings != nullptr)
+    {
+      // the counters are cleared in ezGALDevice::BeginFrame
+      const ezGALContext* pContext = m_pDevice->GetPrimaryContext();
+      pTimings->m_uiDrawCalls += pContext->GetDrawCallCount();
+      pTimings->m_uiStateChanges += pContext->GetStateChangeCount();
+      pTimings->m_uiRedundantStateChanges += pContext->GetRedundantStateChangeCount();
+
+      pTimings->m_uiSkippedBindings += renderContextStats.m_uiSkippedBindings;
+      pTimings->m_uiPermutationCacheHits += renderContextStats.m_uiPermutationCacheHits;
+      pTimings->m_uiPermutationCacheMisses += renderContextStats.m_uiPermutationCacheMisses;
+    }
+
+    m_pDevice->EndFrame();
+    ezRenderWorld::EndFrame();
+
+    ezResourceManager::PerFrameUpdate();
+    ezTaskSystem::FinishFrameTasks();
+    EndStage(Stage::FinishFrame);
+  }
+
+  void PrintStageTimings(ezTime totalTime)
+  {
+    const double fInvNumFrames = 1.0 / m_uiNumFrames;
+
+    ezLog::Info("");
+    ezLog::Info("{0} frames in {1} s, {2} ms per frame", m_uiNumFrames, ezArgF(totalTime.GetSeconds(), 3),
+      ezArgF(totalTime.GetMilliseconds() * fInvNumFrames, 3));
+    ezLog::Info("");
+    ezStringBuilder sLine;
+    sLine.Printf("%-16s %10s %10s %10s", "Stage", "avg ms", "min ms", "max ms");
+    ezLog::Info(sLine);
+
+    for (ezUInt32 i = 0; i < Stage::ENUM_COUNT; ++i)
+    {
+      sLine.Printf("%-16s %10.3f %10.3f %10.3f", Stage::GetName((Stage::Enum)i), m_Stages.m_Total[i].GetMilliseconds() * fInvNumFrames,
+        m_Stages.m_Min[i].GetMilliseconds(), m_Stages.m_Max[i].GetMilliseconds());
+      ezLog::Info(sLine);
+    }
+  }
+
+  void PrintDeviceStatistics()
+  {
+    const double fInvNumFrames = 1.0 / m_uiNumFrames;
+
+    ezLog::Info("");
+    ezLog::Info("Per frame: {0} draw calls, {1} state changes, {2} redundant state changes", ezArgF(m_Stages.m_uiDrawCalls * fInvNumFrames, 1),
+      ezArgF(m_Stages.m_uiStateChanges * fInvNumFrames, 1), ezArgF(m_Stages.m_uiRedundantStateChanges * fInvNumFrames, 1));
+
+    ezLog::Info("Per frame: {0} skipped bindings, {1} permutation cache hits, {2} permutation cache misses",
+      ezArgF(m_Stages.m_uiSkippedBindings * fInvNumFrames, 1), ezArgF(m_Stages.m_uiPermutationCacheHits * fInvNumFrames, 1),
+      ezArgF(m_Stages.m_uiPermutationCacheMisses * fInvNumFrames, 1));
+
+    const ezGALContextNull::Statistics& stats = m_pDevice->GetPrimaryContext<ezGALContextNull>()->GetStatistics();
+
+    ezLog::Info("Per frame: {0} KB buffer updates, {1} validation errors", ezArgF(stats.m_uiUpdatedBufferBytes * fInvNumFrames / 1024.0, 1),
+      ezArgF(stats.m_uiValidationErrors * fInvNumFrames, 1));
+
+    ezLog::Info("");
+    ezStringBuilder sLine;
+    sLine.Printf("%-32s %10s", "Command", "per frame");
+    ezLog::Info(sLine);
+
+    for (ezUInt32 i = 0; i < ezGALNullCommandType::ENUM_COUNT; ++i)
+    {
+      if (stats.m_uiCommandCounts[i] == 0)
+        continue;
+
+      sLine.Printf("%-32s %10.1f", ezGALNullCommandType::GetName((ezGALNullCommandType::Enum)i), stats.m_uiCommandCounts[i] * fInvNumFrames);
+      ezLog::Info(sLine);
+    }
+
+    if (m_Stages.m_uiDrawCalls == 0)
+    {
+      ezLog::Warning("Nothing was drawn. Make sure that the shader cache contains precompiled shaders for '{0}'.", m_sShaderPlatform);
+    }
+  }
+
+  void PrintProfilingScopes(ezTime measurementEndTime)
+  {
+#if EZ_ENABLED(EZ_USE_PROFILING)
+    struct ScopeTiming
+    {
+      ezTime m_Total;
+      ezUInt32 m_uiCount = 0;
+    };
+
+    ezMap<ezString, ScopeTiming> scopes;
+
+    ezProfilingSystem::ProfilingData profilingData = ezProfilingSystem::Capture();
+    for (const auto& eventBuffer : profilingData.m_AllEventBuffers)
+    {
+      ezHybridArray<const ezProfilingSystem::Event*, 32> stack;
+
+      for (const auto& event : eventBuffer.m_Data)
+      {
+        if (event.m_Type == ezProfilingSystem::Event::Begin)
+        {
+          stack.PushBack(&event);
+          continue;
+        }
+
+        // the ring buffer might have dropped the begin event
+        if (stack.IsEmpty())
+          continue;
+
+        const ezProfilingSystem::Event* pBegin = stack.PeekBack();
+        stack.PopBack();
+
+        if (pBegin->m_TimeStamp < m_MeasurementStartTime || event.m_TimeStamp > measurementEndTime)
+          continue;
+
+        ScopeTiming& timing = scopes[pBegin->m_szName];
+        timing.m_Total += event.m_TimeStamp - pBegin->m_TimeStamp;
+        ++timing.m_uiCount;
+      }
+    }
+
+    ezDynamicArray<ezMap<ezString, ScopeTiming>::ConstIterator> sortedScopes;
+    for (auto it = scopes.GetIterator(); it.IsValid(); ++it)
+    {
+      sortedScopes.PushBack(it);
+    }
+
+    sortedScopes.Sort([](const auto& a, const auto& b) { return a.Value().m_Total > b.Value().m_Total; });
+
+    const double fInvNumFrames = 1.0 / m_uiNumFrames;
+
+    ezLog::Info("");
+    ezStringBuilder sLine;
+    sLine.Printf("%-48s %10s %10s", "Profiling Scope", "avg ms", "per frame");
+    ezLog::Info(sLine);
+
+    for (ezUInt32 i = 0; i < ezMath::Min(sortedScopes.GetCount(), 40u); ++i)
+    {
+      const ScopeTiming& timing = sortedScopes[i].Value();
+      sLine.Printf("%-48s %10.3f %10.1f", sortedScopes[i].Key().GetData(), timing.m_Total.GetMilliseconds() * fInvNumFrames,
+        timing.m_uiCount * fInvNumFrames);
+      ezLog::Info(sLine);
+    }
+#endif
+  }
+
+  ezUInt32 m_uiNumFrames = 0;
+  ezUInt32 m_uiNumWarmupFrames = 0;
+  ezUInt32 m_uiNumObjects = 0;
+  ezUInt32 m_uiNumLights = 0;
+  ezUInt32 m_uiNumSpotLights = 0;
+  ezUInt32 m_uiSeed = 0;
+  ezUInt32 m_uiWidth = 0;
+  ezUInt32 m_uiHeight = 0;
+  ezString m_sShaderPlatform;
+
+  ezGALDeviceNull* m_pDevice = nullptr;
+  ezGALTextureHandle m_hColorTexture;
+  ezGALTextureHandle m_hDepthTexture;
+
+  ezUniquePtr<ezWorld> m_pWorld;
+  ezMeshResourceHandle m_hMesh;
+  ezMaterialResourceHandle m_hMaterial;
+
+  ezCamera m_Camera;
+  ezViewHandle m_hView;
+
+  ezTime m_MeasurementStartTime;
+  StageTimings m_Stages;
+};
+
+EZ_CONSOLEAPP_ENTRY_POINT(ezRendererBenchmark);
@@ -0,0 +1,353 @@
+#include <CoreTestPCH.h>
+
+#include <Foundation/Time/Stopwatch.h>
+#include <Utilities/DataStructures/GameGrid.h>
+#include <Utilities/PathFinding/GraphSearch.h>
+#include <Utilities/PathFinding/GridNavmeshAreaSearch.h>
+
+namespace GraphSearchTestDetail
+{
+  typedef ezGameGrid<ezUInt8> TestGrid;
+  typedef ezDeque<ezPathSearch<ezPathState>::PathResultData> TestPath;
+
+  /// Searches through the cells of a grid, cells with a value != 0 are blocked.
+  /// Optionally only allows to enter cells that lie inside a navmesh area corridor.
+  class GridStateGenerator : public ezPathStateGenerator<ezPathState>
+  {
+  public:
+    const TestGrid* m_pGrid = nullptr;
+    const ezGridNavmesh* m_pNavmesh = nullptr;
+    const ezGridNavmeshAreaCorridor* m_pCorridor = nullptr;
+    ezVec2I32 m_vTarget = ezVec2I32(0, 0);
+    bool m_bHasTarget = false;
+    ezUInt32 m_uiExpandedNodes = 0;
+
+    virtual void StartSearch(ezInt64 iStartNodeIndex, const ezPathState* pStartState, ezInt64 iTargetNodeIndex) override
+    {
+      m_vTarget = m_pGrid->ConvertCellIndexToCoordinate((ezUInt32)iTargetNodeIndex);
+      m_bHasTarget = true;
+      m_uiExpandedNodes = 0;
+    }
+
+    virtual void StartSearchForClosest(ezInt64 iStartNodeIndex, const ezPathState* pStartState) override
+    {
+      m_bHasTarget = false;
+      m_uiExpandedNodes = 0;
+    }
+
+    virtual void GenerateAdjacentStates(ezInt64 iNodeIndex, const ezPathState& StartState, ezPathSearch<ezPathState>* pPathSearch) override
+    {
+      ++m_uiExpandedNodes;
+
+      const ezVec2I32 vCoord = m_pGrid->ConvertCellIndexToCoordinate((ezUInt32)iNodeIndex);
+      const ezVec2I32 vOffsets[4] = {ezVec2I32(1, 0), ezVec2I32(-1, 0), ezVec2I32(0, 1), ezVec2I32(0, -1)};
+
+      for (ezUInt32 i = 0; i < 4; ++i)
+      {
+        const ezVec2I32 vNeighbor = vCoord + vOffsets[i];
+
+        if (!m_pGrid->IsValidCellCoordinate(vNeighbor) || m_pGrid->GetCell(vNeighbor) != 0)
+          continue;
+
+        if (m_pCorridor != nullptr && !m_pCorridor->IsCellInCorridor(*m_pNavmesh, vNeighbor))
+          continue;
+
+        ezPathState NewState;
+        NewState.m_fCostToNode = StartState.m_fCostToNode + 1.0f;
+        NewState.m_fEstimatedCostToTarget = NewState.m_fCostToNode;
+
+        if (m_bHasTarget)
+          NewState.m_fEstimatedCostToTarget += (float)(ezMath::Abs(m_vTarget.x - vNeighbor.x) + ezMath::Abs(m_vTarget.y - vNeighbor.y));
+
+        pPathSearch->AddPathNode(m_pGrid->ConvertCellCoordinateToIndex(vNeighbor), NewState);
+      }
+    }
+  };
+
+  /// Fills the grid with vertical walls every \a uiWallSpacing columns, each wall has a single gap at a varying height.
+  static void CreateWallGrid(TestGrid& grid, ezUInt16 uiSizeX, ezUInt16 uiSizeY, ezUInt32 uiWallSpacing)
+  {
+    grid.CreateGrid(uiSizeX, uiSizeY);
+
+    for (ezUInt32 i = 0; i < grid.GetNumCells(); ++i)
+      grid.GetCell(i) = 0;
+
+    ezUInt32 uiWall = 0;
+    for (ezInt32 x = uiWallSpacing; x < uiSizeX; x += uiWallSpacing, ++uiWall)
+    {
+      const ezInt32 iGap = (uiWall % 2 == 0) ? (uiSizeY - 2) : 1;
+
+      for (ezInt32 y = 0; y < uiSizeY; ++y)
+      {
+        if (y != iGap)
+          grid.GetCell(ezVec2I32(x, y)) = 1;
+      }
+    }
+  }
+
+  static bool IsSameCellType(ezUInt32 uiCell1, ezUInt32 uiCell2, void* pPassThrough)
+  {
+    const TestGrid* pGrid = static_cast<const TestGrid*>(pPassThrough);
+    return pGrid->GetCell(uiCell1) == pGrid->GetCell(uiCell2);
+  }
+
+  static bool IsCellBlocked(ezUInt32 uiCell, void* pPassThrough)
+  {
+    const TestGrid* pGrid = static_cast<const TestGrid*>(pPassThrough);
+    return pGrid->GetCell(uiCell) != 0;
+  }
+
+  static ezInt64 g_iClosestSearchTarget = 0;
+
+  static bool IsClosestSearchTarget(ezInt64 iNodeIndex, const ezPathState& State) { return iNodeIndex == g_iClosestSearchTarget; }
+} // namespace GraphSearchTestDetail
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+static const ezTestBlock::Enum EnableInRelease = ezTestBlock::DisabledNoWarning;
+#else
+static const ezTestBlock::Enum EnableInRelease = ezTestBlock::Enabled;
+#endif
+
+EZ_CREATE_SIMPLE_TEST(PathFinding, GraphSearch)
+{
+  using namespace GraphSearchTestDetail;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindPath (open grid)")
+  {
+    TestGrid grid;
+    CreateWallGrid(grid, 64, 64, 1000);
+
+    GridStateGenerator gen;
+    gen.m_pGrid = &grid;
+
+    ezPathSearch<ezPathState> search;
+    search.SetPathStateGenerator(&gen);
+
+    TestPath path;
+    EZ_TEST_BOOL(search.FindPath(0, ezPathState(), grid.ConvertCellCoordinateToIndex(ezVec2I32(63, 63)), path).Succeeded());
+
+    EZ_TEST_INT(path.GetCount(), 127);
+    EZ_TEST_INT(path[0].m_iNodeIndex, 0);
+    EZ_TEST_INT(path.PeekBack().m_iNodeIndex, grid.ConvertCellCoordinateToIndex(ezVec2I32(63, 63)));
+    EZ_TEST_FLOAT(path.PeekBack().m_pPathState->m_fCostToNode, 126.0f, 0.001f);
+
+    // the costs must grow monotonically along the path
+    for (ezUInt32 i = 1; i < path.GetCount(); ++i)
+    {
+      EZ_TEST_FLOAT(path[i].m_pPathState->m_fCostToNode, path[i - 1].m_pPathState->m_fCostToNode + 1.0f, 0.001f);
+    }
+
+    // start == target
+    EZ_TEST_BOOL(search.FindPath(5, ezPathState(), 5, path).Succeeded());
+    EZ_TEST_INT(path.GetCount(), 1);
+    EZ_TEST_INT(path[0].m_iNodeIndex, 5);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindPath (walls)")
+  {
+    TestGrid grid;
+    CreateWallGrid(grid, 32, 32, 8);
+
+    GridStateGenerator gen;
+    gen.m_pGrid = &grid;
+
+    ezPathSearch<ezPathState> search;
+    search.SetPathStateGenerator(&gen);
+
+    const ezInt64 iTarget = grid.ConvertCellCoordinateToIndex(ezVec2I32(31, 0));
+
+    TestPath path;
+    EZ_TEST_BOOL(search.FindPath(0, ezPathState(), iTarget, path).Succeeded());
+
+    // the path has to go through every gap
+    for (ezUInt32 i = 0; i < path.GetCount(); ++i)
+    {
+      EZ_TEST_INT(grid.GetCell((ezUInt32)path[i].m_iNodeIndex), 0);
+    }
+
+    // 31 steps to the right, 3 walls with alternating gaps at the top and bottom: 30 + 29 + 29 + 30 steps up and down
+    EZ_TEST_FLOAT(path.PeekBack().m_pPathState->m_fCostToNode, 31.0f + 118.0f, 0.001f);
+
+    // too expensive
+    EZ_TEST_BOOL(search.FindPath(0, ezPathState(), iTarget, path, 100.0f).Failed());
+
+    // close the first gap
+    grid.GetCell(ezVec2I32(8, 30)) = 1;
+    EZ_TEST_BOOL(search.FindPath(0, ezPathState(), iTarget, path).Failed());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "FindClosest")
+  {
+    TestGrid grid;
+    CreateWallGrid(grid, 32, 32, 8);
+
+    GridStateGenerator gen;
+    gen.m_pGrid = &grid;
+
+    ezPathSearch<ezPathState> search;
+    search.SetPathStateGenerator(&gen);
+
+    g_iClosestSearchTarget = grid.ConvertCellCoordinateToIndex(ezVec2I32(9, 0));
+
+    TestPath path;
+    EZ_TEST_BOOL(search.FindClosest(0, ezPathState(), IsClosestSearchTarget, path).Succeeded());
+    EZ_TEST_INT(path.PeekBack().m_iNodeIndex, g_iClosestSearchTarget);
+    EZ_TEST_FLOAT(path.PeekBack().m_pPathState->m_fCostToNode, 9.0f + 60.0f, 0.001f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Reuse search object")
+  {
+    TestGrid grid;
+    CreateWallGrid(grid, 64, 64, 10);
+
+    GridStateGenerator gen;
+    gen.m_pGrid = &grid;
+
+    ezPathSearch<ezPathState> search;
+    search.SetPathStateGenerator(&gen);
+
+    const ezInt64 iTarget = grid.ConvertCellCoordinateToIndex(ezVec2I32(63, 0));
+
+    TestPath path1, path2;
+    EZ_TEST_BOOL(search.FindPath(0, ezPathState(), iTarget, path1).Succeeded());
+    const float fCost1 = path1.PeekBack().m_pPathState->m_fCostToNode;
+    const ezUInt32 uiCount1 = path1.GetCount();
+
+    EZ_TEST_BOOL(search.FindPath(iTarget, ezPathState(), 0, path2).Succeeded());
+    EZ_TEST_BOOL(search.FindPath(0, ezPathState(), iTarget, path2).Succeeded());
+
+    EZ_TEST_INT(path2.GetCount(), uiCount1);
+    EZ_TEST_FLOAT(path2.PeekBack().m_pPathState->m_fCostToNode, fCost1, 0.001f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Navmesh area search")
+  {
+    TestGrid grid;
+    CreateWallGrid(grid, 64, 64, 8);
+
+    ezGridNavmesh navmesh;
+    navmesh.CreateFromGrid(grid, IsSameCellType, &grid, IsCellBlocked, &grid);
+
+    const ezVec2I32 vStart(0, 0);
+    const ezVec2I32 vTarget(63, 0);
+
+    const ezInt32 iStartArea = navmesh.GetAreaAt(vStart);
+    const ezInt32 iTargetArea = navmesh.GetAreaAt(vTarget);
+    EZ_TEST_BOOL(iStartArea >= 0);
+    EZ_TEST_BOOL(iTargetArea >= 0);
+
+    ezGridNavmeshAreaStateGenerator areaGen;
+    areaGen.SetNavmesh(&navmesh);
+
+    ezPathSearch<ezPathState> areaSearch;
+    areaSearch.SetPathStateGenerator(&areaGen);
+
+    TestPath areaPath;
+    EZ_TEST_BOOL(areaSearch.FindPath(iStartArea, ezPathState(), iTargetArea, areaPath).Succeeded());
+    EZ_TEST_INT(areaPath[0].m_iNodeIndex, iStartArea);
+    EZ_TEST_INT(areaPath.PeekBack().m_iNodeIndex, iTargetArea);
+
+    ezGridNavmeshAreaCorridor corridor;
+    corridor.SetFromAreaPath(navmesh, areaPath);
+
+    // refine the area path on cell level, restricted to the corridor
+    GridStateGenerator gen;
+    gen.m_pGrid = &grid;
+    gen.m_pNavmesh = &navmesh;
+    gen.m_pCorridor = &corridor;
+
+    ezPathSearch<ezPathState> cellSearch;
+    cellSearch.SetPathStateGenerator(&gen);
+
+    TestPath path;
+    EZ_TEST_BOOL(cellSearch.FindPath(grid.ConvertCellCoordinateToIndex(vStart), ezPathState(), grid.ConvertCellCoordinateToIndex(vTarget), path)
+                   .Succeeded());
+
+    for (ezUInt32 i = 0; i < path.GetCount(); ++i)
+    {
+      EZ_TEST_BOOL(corridor.IsCellInCorridor(navmesh, grid.ConvertCellIndexToCoordinate((ezUInt32)path[i].m_iNodeIndex)));
+    }
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(PathFinding, Profile_GraphSearch)
+{
+  using namespace GraphSearchTestDetail;
+
+  TestGrid grid;
+  CreateWallGrid(grid, 1024, 1024, 64);
+
+  const ezInt64 iStart = grid.ConvertCellCoordinateToIndex(ezVec2I32(0, 512));
+  const ezInt64 iTarget = grid.ConvertCellCoordinateToIndex(ezVec2I32(1023, 512));
+
+  EZ_TEST_BLOCK(EnableInRelease, "Cell search on 1024x1024 grid")
+  {
+    GridStateGenerator gen;
+    gen.m_pGrid = &grid;
+
+    ezPathSearch<ezPathState> search;
+    search.SetPathStateGenerator(&gen);
+
+    TestPath path;
+
+    // the first search grows the node pool, the following ones reuse its memory
+    for (ezUInt32 i = 0; i < 3; ++i)
+    {
+      ezStopwatch sw;
+      EZ_TEST_BOOL(search.FindPath(iStart, ezPathState(), iTarget, path).Succeeded());
+      const ezTime tDiff = sw.Checkpoint();
+
+      ezTestFramework::Output(ezTestOutput::Duration, "Cell search #%u: %u expanded nodes, path length %u: %.2fms", i, gen.m_uiExpandedNodes,
+                              path.GetCount(), tDiff.GetMilliseconds());
+    }
+  }
+
+  EZ_TEST_BLOCK(EnableInRelease, "Hierarchical search on 1024x1024 grid")
+  {
+    ezStopwatch sw;
+
+    ezGridNavmesh navmesh;
+    navmesh.CreateFromGrid(grid, IsSameCellType, &grid, IsCellBlocked, &grid);
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Creating navmesh with %u areas: %.2fms", navmesh.GetNumConvexAreas(),
+                            sw.Checkpoint().GetMilliseconds());
+
+    ezGridNavmeshAreaStateGenerator areaGen;
+    areaGen.SetNavmesh(&navmesh);
+
+    ezPathSearch<ezPathState> areaSearch;
+    areaSearch.SetPathStateGenerator(&areaGen);
+
+    GridStateGenerator gen;
+    gen.m_pGrid = &grid;
+    gen.m_pNavmesh = &navmesh;
+
+    ezPathSearch<ezPathState> cellSearch;
+    cellSearch.SetPathStateGenerator(&gen);
+
+    ezGridNavmeshAreaCorridor corridor;
+    TestPath areaPath;
+    TestPath path;
+
+    for (ezUInt32 i = 0; i < 3; ++i)
+    {
+      sw.Checkpoint();
+
+      const ezInt32 iStartArea = navmesh.GetAreaAt(grid.ConvertCellIndexToCoordinate((ezUInt32)iStart));
+      const ezInt32 iTargetArea = navmesh.GetAreaAt(grid.ConvertCellIndexToCoordinate((ezUInt32)iTarget));
+      EZ_TEST_BOOL(areaSearch.FindPath(iStartArea, ezPathState(), iTargetArea, areaPath).Succeeded());
+
+      const ezTime tArea = sw.Checkpoint();
+
+      corridor.SetFromAreaPath(navmesh, areaPath);
+      gen.m_pCorridor = &corridor;
+
+      EZ_TEST_BOOL(cellSearch.FindPath(iStart, ezPathState(), iTarget, path).Succeeded());
+
+      const ezTime tRefine = sw.Checkpoint();
+
+      ezTestFramework::Output(ezTestOutput::Duration, "Hierarchical search #%u: %u areas (%.2fms), %u expanded cells (%.2fms)", i,
+                              areaPath.GetCount(), tArea.GetMilliseconds(), gen.m_uiExpandedNodes, tRefine.GetMilliseconds());
+    }
+  }
+}
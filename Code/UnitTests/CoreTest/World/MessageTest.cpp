@@ -33,6 +33,13 @@ namespace
     int m_iValue;
   };
 
+  struct TestMessageParallel : public ezMsgTest
+  {
+    EZ_DECLARE_MESSAGE_TYPE(TestMessageParallel, ezMsgTest);
+
+    int m_iValue;
+  };
+
   // clang-format off
   EZ_IMPLEMENT_MESSAGE_TYPE(TestMessage1);
   EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(TestMessage1, 1, ezRTTIDefaultAllocator<TestMessage1>)
@@ -41,6 +48,17 @@ namespace
   EZ_IMPLEMENT_MESSAGE_TYPE(TestMessage2);
   EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(TestMessage2, 1, ezRTTIDefaultAllocator<TestMessage2>)
   EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+  EZ_IMPLEMENT_MESSAGE_TYPE(TestMessageParallel);
+  EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(TestMessageParallel, 1, ezRTTIDefaultAllocator<TestMessageParallel>)
+  {
+    EZ_BEGIN_ATTRIBUTES
+    {
+      new ezParallelMessageDispatchAttribute()
+    }
+    EZ_END_ATTRIBUTES;
+  }
+  EZ_END_DYNAMIC_REFLECTED_TYPE;
   // clang-format on
 
   class TestComponentMsg;
@@ -65,8 +83,12 @@ namespace
 
     void OnTestMessage2(TestMessage2& msg) { m_iSomeData2 += 2 * msg.m_iValue; }
 
+    // the result depends on the order in which the messages are delivered
+    void OnTestMessageParallel(TestMessageParallel& msg) { m_uiOrderHash = m_uiOrderHash * 31 + msg.m_iValue; }
+
     ezInt32 m_iSomeData;
     ezInt32 m_iSomeData2;
+    ezUInt32 m_uiOrderHash = 0;
   };
 
   // clang-format off
@@ -76,6 +98,7 @@ namespace
     {
       EZ_MESSAGE_HANDLER(TestMessage1, OnTestMessage),
       EZ_MESSAGE_HANDLER(TestMessage2, OnTestMessage2),
+      EZ_MESSAGE_HANDLER(TestMessageParallel, OnTestMessageParallel),
     }
     EZ_END_MESSAGEHANDLERS;
   }
@@ -235,4 +258,125 @@ EZ_CREATE_SIMPLE_TEST(World, Messaging)
 
     ezFrameAllocator::Reset();
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Queuing with delay, posted out of order")
+  {
+    ResetComponents(*pRoot);
+
+    // post the messages in an order that is unrelated to their due time
+    const ezUInt32 uiNumMessages = 100;
+    for (ezUInt32 i = 0; i < uiNumMessages; ++i)
+    {
+      const ezUInt32 j = (i * 37) % uiNumMessages;
+
+      TestMessage1 msg;
+      msg.m_iValue = j;
+      pRoot->PostMessage(msg, ezObjectMsgQueueType::NextFrame, ezTime::Seconds((j % 10) + 1));
+    }
+
+    world.GetClock().SetFixedTimeStep(ezTime::Seconds(1.001f));
+
+    for (ezUInt32 uiUpdate = 1; uiUpdate <= 10; ++uiUpdate)
+    {
+      world.Update();
+
+      int iDesiredValue = 1;
+      for (ezUInt32 j = 0; j < uiNumMessages; ++j)
+      {
+        if ((j % 10) + 1 <= uiUpdate)
+          iDesiredValue += j;
+      }
+
+      TestComponentMsg* pComponent = nullptr;
+      pRoot->TryGetComponentOfBaseType(pComponent);
+      EZ_TEST_INT(pComponent->m_iSomeData, iDesiredValue);
+    }
+
+    ezFrameAllocator::Reset();
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(World, ParallelMessaging)
+{
+  const ezUInt32 uiNumObjects = 200;
+  const ezUInt32 uiNumMessagesPerObject = 8;
+
+  ezWorldDesc serialDesc("Serial");
+  ezWorld serialWorld(serialDesc);
+
+  ezWorldDesc parallelDesc("Parallel");
+  parallelDesc.m_bParallelMessageDispatch = true;
+  ezWorld parallelWorld(parallelDesc);
+
+  ezWorld* worlds[] = {&serialWorld, &parallelWorld};
+  ezDynamicArray<TestComponentMsg*> components[2];
+
+  for (ezUInt32 w = 0; w < 2; ++w)
+  {
+    ezWorld& world = *worlds[w];
+    EZ_LOCK(world.GetWriteMarker());
+
+    TestComponentMsgManager* pManager = world.GetOrCreateComponentManager<TestComponentMsgManager>();
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      ezGameObjectDesc desc;
+      ezGameObject* pObject = nullptr;
+      world.CreateObject(desc, pObject);
+
+      TestComponentMsg* pComponent = nullptr;
+      pManager->CreateComponent(pObject, pComponent);
+      components[w].PushBack(pComponent);
+    }
+
+    // one update step so components are initialized
+    world.Update();
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Same order as serial dispatch")
+  {
+    for (ezUInt32 w = 0; w < 2; ++w)
+    {
+      ezWorld& world = *worlds[w];
+      EZ_LOCK(world.GetWriteMarker());
+
+      for (ezUInt32 m = 0; m < uiNumMessagesPerObject; ++m)
+      {
+        for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+        {
+          TestComponentMsg* pComponent = components[w][i];
+
+          TestMessageParallel msg;
+          msg.m_iValue = (i * 13 + m * 7) % 101;
+
+          // mix messages that are sent to the component and to the owner object
+          if (m % 2 == 0)
+            pComponent->PostMessage(msg, ezObjectMsgQueueType::NextFrame);
+          else
+            pComponent->GetOwner()->PostMessage(msg, ezObjectMsgQueueType::NextFrame);
+
+          // messages of other types are still dispatched serially in between
+          if (m == 3 && i % 10 == 0)
+          {
+            TestMessage1 msg1;
+            msg1.m_iValue = 1;
+            pComponent->PostMessage(msg1, ezObjectMsgQueueType::NextFrame);
+          }
+        }
+      }
+
+      world.Update();
+    }
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      EZ_TEST_INT(components[0][i]->m_uiOrderHash, components[1][i]->m_uiOrderHash);
+      EZ_TEST_INT(components[0][i]->m_iSomeData, components[1][i]->m_iSomeData);
+    }
+
+    EZ_TEST_BOOL(components[1][0]->m_uiOrderHash != 0);
+    EZ_TEST_INT(components[1][0]->m_iSomeData, 2);
+
+    ezFrameAllocator::Reset();
+  }
 }
@@ -0,0 +1,180 @@
+#include <CoreTestPCH.h>
+
+#include <Core/World/World.h>
+
+namespace
+{
+  static ezAtomicInteger32 s_iExecutionCounter;
+
+  static ezInt32 s_iWriteXStamp = 0;
+  static ezInt32 s_iReadYStamp = 0;
+  static ezInt32 s_iWriteXAgainStamp = 0;
+  static ezInt32 s_iExclusiveStamp = 0;
+  static ezInt32 s_iReadYLateStamp = 0;
+
+  class ScheduleTestComponentA;
+  class ScheduleTestManagerA : public ezComponentManager<ScheduleTestComponentA, ezBlockStorageType::FreeList>
+  {
+  public:
+    ScheduleTestManagerA(ezWorld* pWorld)
+      : ezComponentManager<ScheduleTestComponentA, ezBlockStorageType::FreeList>(pWorld)
+    {
+    }
+
+    virtual void Initialize() override
+    {
+      auto desc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ScheduleTestManagerA::WriteX, this);
+      desc.m_bConcurrent = true;
+      desc.m_WriteAccess.PushBack(ezMakeHashedString("X"));
+      desc.m_fPriority = 10.0f;
+
+      this->RegisterUpdateFunction(desc);
+    }
+
+    void WriteX(const ezWorldModule::UpdateContext& context)
+    {
+      GetWorld()->CheckForDataAccess(ezTempHashedString("X"), true);
+      s_iWriteXStamp = s_iExecutionCounter.Increment();
+    }
+  };
+
+  class ScheduleTestComponentB;
+  class ScheduleTestManagerB : public ezComponentManager<ScheduleTestComponentB, ezBlockStorageType::FreeList>
+  {
+  public:
+    ScheduleTestManagerB(ezWorld* pWorld)
+      : ezComponentManager<ScheduleTestComponentB, ezBlockStorageType::FreeList>(pWorld)
+    {
+    }
+
+    virtual void Initialize() override
+    {
+      auto desc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ScheduleTestManagerB::ReadY, this);
+      desc.m_bConcurrent = true;
+      desc.m_ReadAccess.PushBack(ezMakeHashedString("Y"));
+      desc.m_fPriority = 10.0f;
+
+      // not flagged as concurrent, thus it runs exclusively
+      auto desc2 = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ScheduleTestManagerB::Exclusive, this);
+
+      this->RegisterUpdateFunction(desc);
+      this->RegisterUpdateFunction(desc2);
+    }
+
+    void ReadY(const ezWorldModule::UpdateContext& context)
+    {
+      GetWorld()->CheckForDataAccess(ezTempHashedString("Y"), false);
+      s_iReadYStamp = s_iExecutionCounter.Increment();
+    }
+
+    void Exclusive(const ezWorldModule::UpdateContext& context) { s_iExclusiveStamp = s_iExecutionCounter.Increment(); }
+  };
+
+  class ScheduleTestComponentC;
+  class ScheduleTestManagerC : public ezComponentManager<ScheduleTestComponentC, ezBlockStorageType::FreeList>
+  {
+  public:
+    ScheduleTestManagerC(ezWorld* pWorld)
+      : ezComponentManager<ScheduleTestComponentC, ezBlockStorageType::FreeList>(pWorld)
+    {
+    }
+
+    virtual void Initialize() override
+    {
+      auto desc = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ScheduleTestManagerC::WriteXAgain, this);
+      desc.m_bConcurrent = true;
+      desc.m_WriteAccess.PushBack(ezMakeHashedString("X"));
+      desc.m_fPriority = 5.0f;
+
+      auto desc2 = EZ_CREATE_MODULE_UPDATE_FUNCTION_DESC(ScheduleTestManagerC::ReadYLate, this);
+      desc2.m_bConcurrent = true;
+      desc2.m_ReadAccess.PushBack(ezMakeHashedString("Y"));
+      desc2.m_fPriority = -10.0f;
+
+      this->RegisterUpdateFunction(desc);
+      this->RegisterUpdateFunction(desc2);
+    }
+
+    void WriteXAgain(const ezWorldModule::UpdateContext& context)
+    {
+      GetWorld()->CheckForDataAccess(ezTempHashedString("X"), false);
+      s_iWriteXAgainStamp = s_iExecutionCounter.Increment();
+    }
+
+    void ReadYLate(const ezWorldModule::UpdateContext& context) { s_iReadYLateStamp = s_iExecutionCounter.Increment(); }
+  };
+
+  class ScheduleTestComponentA : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ScheduleTestComponentA, ezComponent, ScheduleTestManagerA);
+  };
+
+  class ScheduleTestComponentB : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ScheduleTestComponentB, ezComponent, ScheduleTestManagerB);
+  };
+
+  class ScheduleTestComponentC : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ScheduleTestComponentC, ezComponent, ScheduleTestManagerC);
+  };
+
+  EZ_BEGIN_COMPONENT_TYPE(ScheduleTestComponentA, 1, ezComponentMode::Static)
+  EZ_END_COMPONENT_TYPE
+
+  EZ_BEGIN_COMPONENT_TYPE(ScheduleTestComponentB, 1, ezComponentMode::Static)
+  EZ_END_COMPONENT_TYPE
+
+  EZ_BEGIN_COMPONENT_TYPE(ScheduleTestComponentC, 1, ezComponentMode::Static)
+  EZ_END_COMPONENT_TYPE
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(World, UpdateSchedule)
+{
+  ezWorldDesc worldDesc("Test");
+  worldDesc.m_bValidateUpdateFunctionAccess = true;
+
+  ezWorld world(worldDesc);
+  EZ_LOCK(world.GetWriteMarker());
+
+  world.GetOrCreateComponentManager<ScheduleTestManagerA>();
+  world.GetOrCreateComponentManager<ScheduleTestManagerB>();
+  world.GetOrCreateComponentManager<ScheduleTestManagerC>();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Execution Order")
+  {
+    for (ezUInt32 i = 0; i < 10; ++i)
+    {
+      s_iExecutionCounter = 0;
+
+      world.Update();
+
+      EZ_TEST_INT(s_iExecutionCounter, 5);
+
+      // both write X, so the registered order has to be kept
+      EZ_TEST_BOOL(s_iWriteXAgainStamp > s_iWriteXStamp);
+
+      // exclusive functions run after all functions with higher priority and before all functions with lower priority
+      EZ_TEST_BOOL(s_iExclusiveStamp > s_iWriteXStamp);
+      EZ_TEST_BOOL(s_iExclusiveStamp > s_iReadYStamp);
+      EZ_TEST_BOOL(s_iExclusiveStamp > s_iWriteXAgainStamp);
+      EZ_TEST_INT(s_iReadYLateStamp, 5);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Deregister")
+  {
+    world.DeleteComponentManager<ScheduleTestManagerB>();
+
+    s_iExecutionCounter = 0;
+    s_iWriteXStamp = 0;
+    s_iWriteXAgainStamp = 0;
+    s_iReadYLateStamp = 0;
+
+    world.Update();
+
+    EZ_TEST_INT(s_iExecutionCounter, 3);
+    EZ_TEST_BOOL(s_iWriteXAgainStamp > s_iWriteXStamp);
+    EZ_TEST_BOOL(s_iReadYLateStamp > 0);
+  }
+}
@@ -1,6 +1,9 @@
 #include <CoreTestPCH.h>
 
+#include <Core/World/TransformHierarchySoA.h>
 #include <Core/World/World.h>
+#include <Core/World/WorldGroup.h>
+#include <Core/WorldSerializer/WorldSnapshot.h>
 #include <Foundation/Time/Clock.h>
 #include <Foundation/Time/Stopwatch.h>
 
@@ -51,9 +54,69 @@ namespace
     ezQuat m_qRotation;
   };
 
+  class ezSnapshotProfileComponentRaw;
+  typedef ezComponentManager<ezSnapshotProfileComponentRaw, ezBlockStorageType::FreeList> ezSnapshotProfileComponentRawManager;
+
+  class ezSnapshotProfileComponentRaw : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ezSnapshotProfileComponentRaw, ezComponent, ezSnapshotProfileComponentRawManager);
+
+  public:
+    ezVec3 m_vPosition = ezVec3::ZeroVector();
+    ezVec3 m_vVelocity = ezVec3::ZeroVector();
+    ezGameObjectHandle m_hTarget;
+  };
+
+  class ezSnapshotProfileComponentSerialized;
+  typedef ezComponentManager<ezSnapshotProfileComponentSerialized, ezBlockStorageType::FreeList> ezSnapshotProfileComponentSerializedManager;
+
+  class ezSnapshotProfileComponentSerialized : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(ezSnapshotProfileComponentSerialized, ezComponent, ezSnapshotProfileComponentSerializedManager);
+
+  public:
+    virtual void SerializeComponent(ezWorldWriter& stream) const override
+    {
+      stream.GetStream() << m_vPosition;
+      stream.GetStream() << m_vVelocity;
+      stream.WriteGameObjectHandle(m_hTarget);
+    }
+
+    virtual void DeserializeComponent(ezWorldReader& stream) override
+    {
+      stream.GetStream() >> m_vPosition;
+      stream.GetStream() >> m_vVelocity;
+      m_hTarget = stream.ReadGameObjectHandle();
+    }
+
+    ezVec3 m_vPosition = ezVec3::ZeroVector();
+    ezVec3 m_vVelocity = ezVec3::ZeroVector();
+    ezGameObjectHandle m_hTarget;
+  };
+
   // clang-format off
   EZ_BEGIN_COMPONENT_TYPE(ezTestComponent, 1, ezComponentMode::Dynamic);
   EZ_END_COMPONENT_TYPE;
+
+  EZ_BEGIN_COMPONENT_TYPE(ezSnapshotProfileComponentRaw, 1, ezComponentMode::Static)
+  {
+    EZ_BEGIN_ATTRIBUTES
+    {
+      new ezComponentSnapshotAttribute(true)
+    }
+    EZ_END_ATTRIBUTES;
+  }
+  EZ_END_COMPONENT_TYPE
+
+  EZ_BEGIN_COMPONENT_TYPE(ezSnapshotProfileComponentSerialized, 1, ezComponentMode::Static)
+  {
+    EZ_BEGIN_ATTRIBUTES
+    {
+      new ezComponentSnapshotAttribute()
+    }
+    EZ_END_ATTRIBUTES;
+  }
+  EZ_END_COMPONENT_TYPE
   // clang-format on
 
   void AddObjectsToWorld(ezWorld& world, bool bDynamic, ezUInt32 uiNumObjects, ezUInt32 uiTreeLevelNumNodeDiv, ezUInt32 uiTreeDepth, ezInt32 iAttachCompsDepth,
@@ -114,6 +177,105 @@ namespace
     }
   }
 
+  void MeasureBulkCreationTime(bool bDynamic, ezUInt32 uiNumRootObjects, ezUInt32 uiNumChildrenPerObject)
+  {
+    const ezUInt32 uiNumObjects = uiNumRootObjects * (1 + uiNumChildrenPerObject);
+
+    ezDynamicArray<ezGameObjectDesc> descs;
+    descs.SetCount(uiNumObjects);
+
+    ezDynamicArray<ezUInt32> parentIndices;
+    parentIndices.SetCountUninitialized(uiNumObjects);
+
+    ezUInt32 uiIndex = 0;
+    for (ezUInt32 r = 0; r < uiNumRootObjects; ++r)
+    {
+      const ezUInt32 uiRootIndex = uiIndex;
+
+      descs[uiIndex].m_bDynamic = bDynamic;
+      descs[uiIndex].m_LocalPosition.Set(r * 5.0f, 0, 0);
+      parentIndices[uiIndex] = ezInvalidIndex;
+      ++uiIndex;
+
+      for (ezUInt32 c = 0; c < uiNumChildrenPerObject; ++c)
+      {
+        descs[uiIndex].m_bDynamic = bDynamic;
+        descs[uiIndex].m_LocalPosition.Set(0, c * 5.0f, 0);
+        parentIndices[uiIndex] = uiRootIndex;
+        ++uiIndex;
+      }
+    }
+
+    ezDynamicArray<ezGameObject*> objects;
+    objects.SetCountUninitialized(uiNumObjects);
+
+    ezTime tSingle;
+    ezTime tBulk;
+
+    {
+      ezWorldDesc worldDesc("Test");
+      ezWorld world(worldDesc);
+      EZ_LOCK(world.GetWriteMarker());
+
+      ezStopwatch sw;
+
+      for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+      {
+        ezGameObjectDesc desc = descs[i];
+        if (parentIndices[i] != ezInvalidIndex)
+        {
+          desc.m_hParent = objects[parentIndices[i]]->GetHandle();
+        }
+
+        world.CreateObject(desc, objects[i]);
+      }
+
+      tSingle = sw.Checkpoint();
+    }
+
+    {
+      ezWorldDesc worldDesc("Test");
+      ezWorld world(worldDesc);
+      EZ_LOCK(world.GetWriteMarker());
+
+      ezStopwatch sw;
+
+      world.CreateObjects(descs, parentIndices, objects);
+
+      tBulk = sw.Checkpoint();
+
+      EZ_TEST_INT(world.GetObjectCount(), uiNumObjects);
+    }
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Creating %u %s objects: %.2fms one by one, %.2fms in bulk", uiNumObjects,
+                            bDynamic ? "dynamic" : "static", tSingle.GetMilliseconds(), tBulk.GetMilliseconds());
+  }
+
+  struct SoAObjectMapping
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    const ezGameObject* m_pObject;
+    ezUInt32 m_uiHierarchyLevel;
+    ezUInt32 m_uiIndex;
+  };
+
+  void AddObjectToHierarchySoA(ezTransformHierarchySoA& hierarchy, const ezGameObject* pObject, ezUInt32 uiHierarchyLevel, ezUInt32 uiParentIndex,
+                               ezDynamicArray<SoAObjectMapping>& out_Mapping)
+  {
+    const ezSimdVec4f vScaling = pObject->GetLocalScalingSimd();
+    ezSimdVec4f vScalingAndUniform = vScaling;
+    vScalingAndUniform.SetW(pObject->GetLocalUniformScalingSimd());
+
+    const ezUInt32 uiIndex = hierarchy.AddObject(uiHierarchyLevel, uiParentIndex, pObject->GetLocalPositionSimd(), pObject->GetLocalRotationSimd(), vScalingAndUniform);
+    out_Mapping.PushBack({pObject, uiHierarchyLevel, uiIndex});
+
+    for (auto it = pObject->GetChildren(); it.IsValid(); ++it)
+    {
+      AddObjectToHierarchySoA(hierarchy, it, uiHierarchyLevel + 1, uiIndex, out_Mapping);
+    }
+  }
+
 } // namespace
 
 
@@ -143,6 +305,17 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Creation)
   }
 }
 
+EZ_CREATE_SIMPLE_TEST(World, Profile_BulkCreation)
+{
+  EZ_TEST_BLOCK(EnableInRelease, "Create many objects in bulk")
+  {
+    MeasureBulkCreationTime(false, 50000, 0);
+    MeasureBulkCreationTime(true, 50000, 0);
+    MeasureBulkCreationTime(true, 10000, 4);
+    MeasureBulkCreationTime(true, 1000, 49);
+  }
+}
+
 EZ_CREATE_SIMPLE_TEST(World, Profile_Deletion)
 {
   EZ_TEST_BLOCK(EnableInRelease, "Delete many objects")
@@ -288,3 +461,212 @@ EZ_CREATE_SIMPLE_TEST(World, Profile_Update)
     }
   }
 }
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_TransformHierarchySoA)
+{
+  EZ_TEST_BLOCK(EnableInRelease, "Update transforms of 111,110 dynamic objects")
+  {
+    ezWorldDesc worldDesc("Test");
+    worldDesc.m_bAutoCreateSpatialSystem = false;
+    ezWorld world(worldDesc);
+    MeasureCreationTime(true, 10, 1, 5, 0, &world);
+
+    EZ_LOCK(world.GetWriteMarker());
+
+    // give every object a rotation and scale, otherwise the comparison below only covers translations
+    ezUInt32 uiObject = 0;
+    for (auto it = world.GetObjects(); it.IsValid(); ++it, ++uiObject)
+    {
+      ezQuat qRot;
+      qRot.SetFromAxisAndAngle(ezVec3(0, 0, 1), ezAngle::Degree((float)(uiObject % 360)));
+      it->SetLocalRotation(qRot);
+      it->SetLocalUniformScaling(1.0f + (uiObject % 3) * 0.1f);
+    }
+
+    world.Update();
+
+    ezTransformHierarchySoA hierarchy;
+    ezDynamicArray<SoAObjectMapping> mapping;
+    mapping.Reserve(world.GetObjectCount());
+
+    for (auto it = world.GetObjects(); it.IsValid(); ++it)
+    {
+      if (it->GetParent() == nullptr)
+      {
+        AddObjectToHierarchySoA(hierarchy, it, 0, 0, mapping);
+      }
+    }
+
+    EZ_TEST_INT(hierarchy.GetObjectCount(), world.GetObjectCount());
+
+    const ezUInt32 uiNumObjects = hierarchy.GetObjectCount();
+    const ezUInt32 uiNumIterations = 10;
+
+    ezStopwatch sw;
+
+    for (ezUInt32 i = 0; i < uiNumIterations; ++i)
+    {
+      world.Update();
+    }
+
+    const ezTime tWorld = sw.Checkpoint();
+
+    for (ezUInt32 i = 0; i < uiNumIterations; ++i)
+    {
+      hierarchy.UpdateGlobalTransformsScalar();
+    }
+
+    const ezTime tScalar = sw.Checkpoint();
+
+    for (ezUInt32 i = 0; i < uiNumIterations; ++i)
+    {
+      hierarchy.UpdateGlobalTransforms();
+    }
+
+    const ezTime tSimd = sw.Checkpoint();
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Updating %u objects: ezWorld %.0f objects/ms, SoA scalar %.0f objects/ms, SoA SIMD %.0f objects/ms",
+                            uiNumObjects, uiNumObjects * uiNumIterations / tWorld.GetMilliseconds(),
+                            uiNumObjects * uiNumIterations / tScalar.GetMilliseconds(), uiNumObjects * uiNumIterations / tSimd.GetMilliseconds());
+
+    for (const SoAObjectMapping& m : mapping)
+    {
+      const ezSimdTransform t = hierarchy.GetGlobalTransform(m.m_uiHierarchyLevel, m.m_uiIndex);
+      if (EZ_TEST_BOOL(t.IsEqual(m.m_pObject->GetGlobalTransformSimd(), 0.01f)).Failed())
+        break;
+    }
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_WorldGroup)
+{
+  EZ_TEST_BLOCK(EnableInRelease, "Update 64 worlds with 1,110 objects each")
+  {
+    // object handles can only address 64 worlds, use whatever is left of that
+    ezUInt32 uiNumWorlds = 64 - ezWorld::GetWorldCount();
+    for (ezUInt32 i = 0; i < ezWorld::GetWorldCount(); ++i)
+    {
+      if (ezWorld::GetWorld(i) == nullptr)
+        ++uiNumWorlds;
+    }
+
+    ezDynamicArray<ezUniquePtr<ezWorld>> worlds;
+    ezWorldGroup group;
+
+    for (ezUInt32 i = 0; i < uiNumWorlds; ++i)
+    {
+      ezStringBuilder sName;
+      sName.Format("Test{0}", i);
+
+      ezWorldDesc worldDesc(sName);
+      worlds.PushBack(EZ_DEFAULT_NEW(ezWorld, worldDesc));
+
+      ezWorld* pWorld = worlds.PeekBack().Borrow();
+      {
+        EZ_LOCK(pWorld->GetWriteMarker());
+        AddObjectsToWorld(*pWorld, true, 10, 1, 3, 3);
+      }
+
+      group.AddWorld(pWorld);
+    }
+
+    // first round always has some overhead
+    group.Update();
+
+    const ezUInt32 uiNumIterations = 10;
+    ezStopwatch sw;
+
+    for (ezUInt32 i = 0; i < uiNumIterations; ++i)
+    {
+      for (auto& pWorld : worlds)
+      {
+        EZ_LOCK(pWorld->GetWriteMarker());
+        pWorld->Update();
+      }
+    }
+
+    const ezTime tSequential = sw.Checkpoint();
+
+    for (ezUInt32 i = 0; i < uiNumIterations; ++i)
+    {
+      group.Update();
+    }
+
+    const ezTime tParallel = sw.Checkpoint();
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Updating %u worlds: %.2fms sequential, %.2fms as world group", uiNumWorlds,
+                            tSequential.GetMilliseconds() / uiNumIterations, tParallel.GetMilliseconds() / uiNumIterations);
+
+    group.Clear();
+  }
+}
+
+namespace
+{
+  template <typename ComponentType>
+  void ProfileWorldSnapshot(const char* szMode)
+  {
+    const ezUInt32 uiNumComponents = 10000;
+
+    ezWorldDesc worldDesc("Test");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    for (ezUInt32 i = 0; i < uiNumComponents; ++i)
+    {
+      ezGameObjectDesc desc;
+      ezGameObject* pObject = nullptr;
+      ezGameObjectHandle hObject = world.CreateObject(desc, pObject);
+
+      ComponentType* pComponent = nullptr;
+      ComponentType::CreateComponent(pObject, pComponent);
+      pComponent->m_vPosition.Set((float)i, 0, 0);
+      pComponent->m_vVelocity.Set(0, 1, 0);
+      pComponent->m_hTarget = hObject;
+    }
+
+    world.Update();
+
+    ezWorldSnapshot snapshot;
+
+    // first round always has some overhead
+    snapshot.Capture(world);
+    EZ_TEST_BOOL(snapshot.Restore(world).Succeeded());
+
+    const ezUInt32 uiNumIterations = 100;
+    ezStopwatch sw;
+
+    for (ezUInt32 i = 0; i < uiNumIterations; ++i)
+    {
+      snapshot.Capture(world);
+    }
+
+    const ezTime tCapture = sw.Checkpoint();
+
+    for (ezUInt32 i = 0; i < uiNumIterations; ++i)
+    {
+      EZ_TEST_BOOL(snapshot.Restore(world).Succeeded());
+    }
+
+    const ezTime tRestore = sw.Checkpoint();
+
+    EZ_TEST_INT(snapshot.GetComponentCount(), uiNumComponents);
+
+    ezTestFramework::Output(ezTestOutput::Duration, "%s snapshot of %u components: %.3fms capture, %.3fms restore, %u KB", szMode,
+                            uiNumComponents, tCapture.GetMilliseconds() / uiNumIterations, tRestore.GetMilliseconds() / uiNumIterations,
+                            (ezUInt32)(snapshot.GetHeapMemoryUsage() / 1024));
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(World, Profile_Snapshot)
+{
+  EZ_TEST_BLOCK(EnableInRelease, "Snapshot 10,000 components with memory copies")
+  {
+    ProfileWorldSnapshot<ezSnapshotProfileComponentRaw>("Memcpy");
+  }
+
+  EZ_TEST_BLOCK(EnableInRelease, "Snapshot 10,000 serialized components")
+  {
+    ProfileWorldSnapshot<ezSnapshotProfileComponentSerialized>("Serialized");
+  }
+}
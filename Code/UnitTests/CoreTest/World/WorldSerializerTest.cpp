@@ -0,0 +1,423 @@
+#include <CoreTestPCH.h>
+
+#include <Core/World/World.h>
+#include <Core/WorldSerializer/WorldReader.h>
+#include <Core/WorldSerializer/WorldWriter.h>
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/Threading/ThreadUtils.h>
+
+namespace
+{
+  class SerializerTestComponentParallel;
+  typedef ezComponentManager<SerializerTestComponentParallel, ezBlockStorageType::Compact> SerializerTestComponentParallelManager;
+
+  /// Flagged with ezParallelDeserializationAttribute, thus deserialized on multiple threads
+  class SerializerTestComponentParallel : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(SerializerTestComponentParallel, ezComponent, SerializerTestComponentParallelManager);
+
+  public:
+    virtual void SerializeComponent(ezWorldWriter& stream) const override
+    {
+      stream.GetStream() << m_iValue;
+      stream.WriteGameObjectHandle(m_hTarget);
+      stream.WriteComponentHandle(m_hOther);
+    }
+
+    virtual void DeserializeComponent(ezWorldReader& stream) override
+    {
+      stream.GetStream() >> m_iValue;
+      m_hTarget = stream.ReadGameObjectHandle();
+      stream.ReadComponentHandle(&m_hOther);
+    }
+
+    ezInt32 m_iValue = 0;
+    ezGameObjectHandle m_hTarget;
+    ezComponentHandle m_hOther;
+  };
+
+  class SerializerTestComponentSerial;
+  typedef ezComponentManager<SerializerTestComponentSerial, ezBlockStorageType::Compact> SerializerTestComponentSerialManager;
+
+  class SerializerTestComponentSerial : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(SerializerTestComponentSerial, ezComponent, SerializerTestComponentSerialManager);
+
+  public:
+    virtual void SerializeComponent(ezWorldWriter& stream) const override
+    {
+      stream.GetStream() << m_sText;
+      stream.WriteComponentHandle(m_hOther);
+    }
+
+    virtual void DeserializeComponent(ezWorldReader& stream) override
+    {
+      stream.GetStream() >> m_sText;
+      stream.ReadComponentHandle(&m_hOther);
+    }
+
+    ezString m_sText;
+    ezComponentHandle m_hOther;
+  };
+
+  class SerializerTestComponentDerived;
+  typedef ezComponentManager<SerializerTestComponentDerived, ezBlockStorageType::Compact> SerializerTestComponentDerivedManager;
+
+  /// Derives from a parallel type without being flagged itself, thus deserialized on the main thread
+  class SerializerTestComponentDerived : public SerializerTestComponentParallel
+  {
+    EZ_DECLARE_COMPONENT_TYPE(SerializerTestComponentDerived, SerializerTestComponentParallel, SerializerTestComponentDerivedManager);
+
+  public:
+    virtual void DeserializeComponent(ezWorldReader& stream) override
+    {
+      SUPER::DeserializeComponent(stream);
+
+      m_bDeserializedOnMainThread = ezThreadUtils::IsMainThread();
+    }
+
+    bool m_bDeserializedOnMainThread = false;
+  };
+
+  // clang-format off
+  EZ_BEGIN_COMPONENT_TYPE(SerializerTestComponentParallel, 1, ezComponentMode::Static)
+  {
+    EZ_BEGIN_ATTRIBUTES
+    {
+      new ezParallelDeserializationAttribute()
+    }
+    EZ_END_ATTRIBUTES;
+  }
+  EZ_END_COMPONENT_TYPE
+
+  EZ_BEGIN_COMPONENT_TYPE(SerializerTestComponentSerial, 1, ezComponentMode::Static)
+  EZ_END_COMPONENT_TYPE
+
+  EZ_BEGIN_COMPONENT_TYPE(SerializerTestComponentDerived, 1, ezComponentMode::Static)
+  EZ_END_COMPONENT_TYPE
+  // clang-format on
+
+  static void GetGlobalKey(ezUInt32 uiIndex, ezStringBuilder& out_sKey) { out_sKey.Format("Object{0}", uiIndex); }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(World, WorldSerializer)
+{
+  const ezUInt32 uiNumObjects = 500;
+
+  ezMemoryStreamStorage storage;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Write")
+  {
+    ezWorldDesc worldDesc("Source");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    auto pParallelManager = world.GetOrCreateComponentManager<SerializerTestComponentParallelManager>();
+    auto pSerialManager = world.GetOrCreateComponentManager<SerializerTestComponentSerialManager>();
+
+    ezDynamicArray<ezGameObject*> objects;
+    ezDynamicArray<SerializerTestComponentParallel*> parallelComponents;
+    ezDynamicArray<SerializerTestComponentSerial*> serialComponents;
+
+    ezStringBuilder sKey;
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      ezGameObject* pObject = nullptr;
+      world.CreateObject(ezGameObjectDesc(), pObject);
+
+      GetGlobalKey(i, sKey);
+      pObject->SetGlobalKey(sKey);
+
+      SerializerTestComponentParallel* pParallel = nullptr;
+      pParallelManager->CreateComponent(pObject, pParallel);
+      pParallel->m_iValue = i;
+
+      SerializerTestComponentSerial* pSerial = nullptr;
+      pSerialManager->CreateComponent(pObject, pSerial);
+      pSerial->m_sText = sKey;
+
+      objects.PushBack(pObject);
+      parallelComponents.PushBack(pParallel);
+      serialComponents.PushBack(pSerial);
+    }
+
+    // reference the next object and the components of the other type, so that handles need to be resolved across types
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      const ezUInt32 uiNext = (i + 1) % uiNumObjects;
+
+      parallelComponents[i]->m_hTarget = objects[uiNext]->GetHandle();
+      parallelComponents[i]->m_hOther = serialComponents[i]->GetHandle();
+      serialComponents[i]->m_hOther = parallelComponents[uiNext]->GetHandle();
+    }
+
+    ezMemoryStreamWriter writer(&storage);
+
+    ezWorldWriter worldWriter;
+    worldWriter.WriteWorld(writer, world);
+
+    EZ_TEST_BOOL(storage.GetStorageSize() > 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Read and Instantiate")
+  {
+    ezMemoryStreamReader reader(&storage);
+
+    ezWorldReader worldReader;
+    worldReader.ReadWorldDescription(reader);
+
+    // instantiate twice to make sure that no state of the first instantiation leaks into the second one
+    for (ezUInt32 uiInstance = 0; uiInstance < 2; ++uiInstance)
+    {
+      ezWorldDesc worldDesc("Target");
+      ezWorld world(worldDesc);
+
+      worldReader.InstantiateWorld(world);
+
+      EZ_LOCK(world.GetWriteMarker());
+      EZ_TEST_INT(world.GetObjectCount(), uiNumObjects);
+
+      ezStringBuilder sKey;
+      for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+      {
+        const ezUInt32 uiNext = (i + 1) % uiNumObjects;
+
+        ezGameObject* pObject = nullptr;
+        GetGlobalKey(i, sKey);
+        if (EZ_TEST_BOOL(world.TryGetObjectWithGlobalKey(ezTempHashedString(sKey.GetData()), pObject)).Failed())
+          continue;
+
+        ezGameObject* pNextObject = nullptr;
+        GetGlobalKey(uiNext, sKey);
+        EZ_TEST_BOOL(world.TryGetObjectWithGlobalKey(ezTempHashedString(sKey.GetData()), pNextObject));
+
+        SerializerTestComponentParallel* pParallel = nullptr;
+        SerializerTestComponentSerial* pSerial = nullptr;
+        if (EZ_TEST_BOOL(pObject->TryGetComponentOfBaseType(pParallel) && pObject->TryGetComponentOfBaseType(pSerial)).Failed())
+          continue;
+
+        SerializerTestComponentParallel* pNextParallel = nullptr;
+        pNextObject->TryGetComponentOfBaseType(pNextParallel);
+
+        GetGlobalKey(i, sKey);
+        EZ_TEST_INT(pParallel->m_iValue, i);
+        EZ_TEST_STRING(pSerial->m_sText, sKey);
+
+        EZ_TEST_BOOL(pParallel->m_hTarget == pNextObject->GetHandle());
+        EZ_TEST_BOOL(pParallel->m_hOther == pSerial->GetHandle());
+        EZ_TEST_BOOL(pSerial->m_hOther == pNextParallel->GetHandle());
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Derived Types")
+  {
+    ezMemoryStreamStorage derivedStorage;
+
+    {
+      ezWorldDesc worldDesc("Source");
+      ezWorld world(worldDesc);
+      EZ_LOCK(world.GetWriteMarker());
+
+      auto pDerivedManager = world.GetOrCreateComponentManager<SerializerTestComponentDerivedManager>();
+
+      for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+      {
+        ezGameObject* pObject = nullptr;
+        world.CreateObject(ezGameObjectDesc(), pObject);
+
+        SerializerTestComponentDerived* pDerived = nullptr;
+        pDerivedManager->CreateComponent(pObject, pDerived);
+        pDerived->m_iValue = i;
+      }
+
+      ezMemoryStreamWriter writer(&derivedStorage);
+
+      ezWorldWriter worldWriter;
+      worldWriter.WriteWorld(writer, world);
+    }
+
+    ezMemoryStreamReader reader(&derivedStorage);
+
+    ezWorldReader worldReader;
+    worldReader.ReadWorldDescription(reader);
+
+    ezWorldDesc worldDesc("Target");
+    ezWorld world(worldDesc);
+
+    worldReader.InstantiateWorld(world);
+
+    EZ_LOCK(world.GetWriteMarker());
+
+    auto pDerivedManager = world.GetOrCreateComponentManager<SerializerTestComponentDerivedManager>();
+    EZ_TEST_INT(pDerivedManager->GetComponentCount(), uiNumObjects);
+
+    // the attribute of the base type must not be used for the derived type
+    for (auto it = pDerivedManager->GetComponents(); it.IsValid(); ++it)
+    {
+      EZ_TEST_BOOL(it->m_bDeserializedOnMainThread);
+    }
+  }
+}
+
+EZ_CREATE_SIMPLE_TEST(World, TimeSlicedInstantiation)
+{
+  const ezUInt32 uiNumChildren = 2000;
+  const ezTime budget = ezTime::Milliseconds(2);
+
+  ezWorldReader worldReader;
+
+  {
+    ezWorldDesc worldDesc("Source");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    auto pParallelManager = world.GetOrCreateComponentManager<SerializerTestComponentParallelManager>();
+    auto pSerialManager = world.GetOrCreateComponentManager<SerializerTestComponentSerialManager>();
+
+    ezGameObjectDesc rootDesc;
+    rootDesc.m_sName.Assign("Root");
+
+    ezGameObject* pRoot = nullptr;
+    world.CreateObject(rootDesc, pRoot);
+
+    ezStringBuilder sKey;
+    for (ezUInt32 i = 0; i < uiNumChildren; ++i)
+    {
+      ezGameObjectDesc desc;
+      desc.m_hParent = pRoot->GetHandle();
+
+      ezGameObject* pObject = nullptr;
+      world.CreateObject(desc, pObject);
+
+      GetGlobalKey(i, sKey);
+      pObject->SetGlobalKey(sKey);
+
+      SerializerTestComponentParallel* pParallel = nullptr;
+      pParallelManager->CreateComponent(pObject, pParallel);
+      pParallel->m_iValue = i;
+      pParallel->m_hTarget = pRoot->GetHandle();
+
+      SerializerTestComponentSerial* pSerial = nullptr;
+      pSerialManager->CreateComponent(pObject, pSerial);
+      pSerial->m_sText = sKey;
+      pSerial->m_hOther = pParallel->GetHandle();
+    }
+
+    ezMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    ezMemoryStreamReader reader(&storage);
+
+    ezWorldWriter worldWriter;
+    worldWriter.WriteWorld(writer, world);
+
+    worldReader.ReadWorldDescription(reader);
+  }
+
+  ezWorldDesc worldDesc("Target");
+  ezWorld world(worldDesc);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "One chunk per step")
+  {
+    // the budget is always exceeded, so every step processes exactly one chunk of work, independent of the machine
+    auto pContext = worldReader.InstantiateWorldTimeSliced(world, nullptr, ezTime::Nanoseconds(1));
+
+    ezUInt32 uiNumSteps = 0;
+    ezUInt32 uiMaxObjectsPerStep = 0;
+    ezTime maxStepTime;
+    float fLastProgress = 0.0f;
+
+    while (true)
+    {
+      ezUInt32 uiObjectsBefore = 0;
+      {
+        EZ_LOCK(world.GetReadMarker());
+        uiObjectsBefore = world.GetObjectCount();
+      }
+
+      const ezTime startTime = ezTime::Now();
+      const bool bFinished = pContext->Step();
+      maxStepTime = ezMath::Max(maxStepTime, ezTime::Now() - startTime);
+
+      ++uiNumSteps;
+
+      EZ_TEST_BOOL(pContext->GetProgress() >= fLastProgress);
+      fLastProgress = pContext->GetProgress();
+
+      EZ_LOCK(world.GetWriteMarker());
+      uiMaxObjectsPerStep = ezMath::Max(uiMaxObjectsPerStep, world.GetObjectCount() - uiObjectsBefore);
+
+      if (bFinished)
+        break;
+
+      // nothing may become active before the instantiation is finished
+      for (const ezGameObjectHandle& hRoot : pContext->GetCreatedRootObjects())
+      {
+        ezGameObject* pRoot = nullptr;
+        EZ_TEST_BOOL(world.TryGetObject(hRoot, pRoot) && !pRoot->IsActive());
+      }
+
+      world.Update();
+    }
+
+    EZ_TEST_BOOL(pContext->IsFinished());
+    EZ_TEST_FLOAT(pContext->GetProgress(), 1.0f, 0.0f);
+
+    // at most 32 child objects are created per chunk
+    EZ_TEST_INT(uiMaxObjectsPerStep, 32);
+
+    // 1 chunk for the root, 32 children per chunk, and 8 components per chunk which are created, deserialized and initialized separately
+    const ezUInt32 uiNumComponents = uiNumChildren * 2;
+    const ezUInt32 uiMinSteps = 1 + (uiNumChildren + 31) / 32 + 3 * ((uiNumComponents + 7) / 8);
+    EZ_TEST_BOOL_MSG(uiNumSteps >= uiMinSteps, "%u steps, expected at least %u", uiNumSteps, uiMinSteps);
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Time sliced instantiation: %u steps, longest step: %.2fms", uiNumSteps, maxStepTime.GetMilliseconds());
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Verify")
+  {
+    EZ_LOCK(world.GetWriteMarker());
+    EZ_TEST_INT(world.GetObjectCount(), uiNumChildren + 1);
+
+    ezStringBuilder sKey;
+    for (ezUInt32 i = 0; i < uiNumChildren; ++i)
+    {
+      ezGameObject* pObject = nullptr;
+      GetGlobalKey(i, sKey);
+      if (EZ_TEST_BOOL(world.TryGetObjectWithGlobalKey(ezTempHashedString(sKey.GetData()), pObject)).Failed())
+        continue;
+
+      SerializerTestComponentParallel* pParallel = nullptr;
+      SerializerTestComponentSerial* pSerial = nullptr;
+      if (EZ_TEST_BOOL(pObject->TryGetComponentOfBaseType(pParallel) && pObject->TryGetComponentOfBaseType(pSerial)).Failed())
+        continue;
+
+      EZ_TEST_BOOL(pObject->IsActive());
+      EZ_TEST_BOOL(pParallel->IsActiveAndInitialized());
+      EZ_TEST_BOOL(pSerial->IsActiveAndInitialized());
+
+      EZ_TEST_INT(pParallel->m_iValue, i);
+      EZ_TEST_STRING(pSerial->m_sText, sKey);
+      EZ_TEST_BOOL(pParallel->m_hTarget == pObject->GetParent()->GetHandle());
+      EZ_TEST_BOOL(pSerial->m_hOther == pParallel->GetHandle());
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Cancel")
+  {
+    auto pContext = worldReader.InstantiatePrefabTimeSliced(world, ezTransform::IdentityTransform(), ezGameObjectHandle(), nullptr, false, budget);
+
+    pContext->Step();
+    pContext->Cancel();
+
+    EZ_TEST_BOOL(pContext->IsFinished());
+
+    EZ_LOCK(world.GetWriteMarker());
+
+    // deleting objects is delayed until the next update
+    world.Update();
+    world.Update();
+
+    EZ_TEST_INT(world.GetObjectCount(), uiNumChildren + 1);
+  }
+}
@@ -0,0 +1,272 @@
+#include <CoreTestPCH.h>
+
+#include <Core/World/World.h>
+#include <Core/WorldSerializer/WorldSnapshot.h>
+
+namespace
+{
+  class SnapshotTestComponentRaw;
+  typedef ezComponentManagerSimple<SnapshotTestComponentRaw, ezComponentUpdateType::Always, ezBlockStorageType::FreeList>
+    SnapshotTestComponentRawManager;
+
+  /// Only holds trivially copyable data and is therefore stored with plain memory copies
+  class SnapshotTestComponentRaw : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(SnapshotTestComponentRaw, ezComponent, SnapshotTestComponentRawManager);
+
+  public:
+    void Update()
+    {
+      ++m_iCounter;
+      m_fValue += GetWorld()->GetClock().GetTimeDiff().AsFloatInSeconds() * GetWorld()->GetRandomNumberGenerator().FloatMinMax(0.0f, 1.0f);
+    }
+
+    ezInt32 m_iCounter = 0;
+    float m_fValue = 0.0f;
+  };
+
+  class SnapshotTestComponentSerialized;
+  typedef ezComponentManagerSimple<SnapshotTestComponentSerialized, ezComponentUpdateType::Always> SnapshotTestComponentSerializedManager;
+
+  /// Owns memory, thus it has to be stored through SerializeComponent()
+  class SnapshotTestComponentSerialized : public ezComponent
+  {
+    EZ_DECLARE_COMPONENT_TYPE(SnapshotTestComponentSerialized, ezComponent, SnapshotTestComponentSerializedManager);
+
+  public:
+    virtual void SerializeComponent(ezWorldWriter& stream) const override
+    {
+      stream.GetStream() << m_sText;
+      stream.GetStream() << m_iCounter;
+      stream.WriteComponentHandle(m_hOther);
+    }
+
+    virtual void DeserializeComponent(ezWorldReader& stream) override
+    {
+      stream.GetStream() >> m_sText;
+      stream.GetStream() >> m_iCounter;
+      stream.ReadComponentHandle(&m_hOther);
+    }
+
+    void Update()
+    {
+      ++m_iCounter;
+
+      ezStringBuilder sText;
+      sText.Format("Step {0}", m_iCounter);
+      m_sText = sText;
+    }
+
+    ezString m_sText;
+    ezInt32 m_iCounter = 0;
+    ezComponentHandle m_hOther;
+  };
+
+  // clang-format off
+  EZ_BEGIN_COMPONENT_TYPE(SnapshotTestComponentRaw, 1, ezComponentMode::Static)
+  {
+    EZ_BEGIN_ATTRIBUTES
+    {
+      new ezComponentSnapshotAttribute(true)
+    }
+    EZ_END_ATTRIBUTES;
+  }
+  EZ_END_COMPONENT_TYPE
+
+  EZ_BEGIN_COMPONENT_TYPE(SnapshotTestComponentSerialized, 1, ezComponentMode::Static)
+  {
+    EZ_BEGIN_ATTRIBUTES
+    {
+      new ezComponentSnapshotAttribute()
+    }
+    EZ_END_ATTRIBUTES;
+  }
+  EZ_END_COMPONENT_TYPE
+  // clang-format on
+
+  struct SnapshotTestState
+  {
+    ezDynamicArray<ezInt32> m_RawCounters;
+    ezDynamicArray<float> m_RawValues;
+    ezDynamicArray<ezString> m_Texts;
+    ezDynamicArray<ezComponentHandle> m_OtherHandles;
+    ezTime m_AccumulatedTime;
+
+    void Gather(ezWorld& world)
+    {
+      m_RawCounters.Clear();
+      m_RawValues.Clear();
+      m_Texts.Clear();
+      m_OtherHandles.Clear();
+
+      for (auto it = world.GetComponentManager<SnapshotTestComponentRawManager>()->GetComponents(); it.IsValid(); ++it)
+      {
+        m_RawCounters.PushBack(it->m_iCounter);
+        m_RawValues.PushBack(it->m_fValue);
+      }
+
+      for (auto it = world.GetComponentManager<SnapshotTestComponentSerializedManager>()->GetComponents(); it.IsValid(); ++it)
+      {
+        m_Texts.PushBack(it->m_sText);
+        m_OtherHandles.PushBack(it->m_hOther);
+      }
+
+      m_AccumulatedTime = world.GetClock().GetAccumulatedTime();
+    }
+
+    bool operator==(const SnapshotTestState& other) const
+    {
+      return m_RawCounters == other.m_RawCounters && m_RawValues == other.m_RawValues && m_Texts == other.m_Texts &&
+             m_OtherHandles == other.m_OtherHandles && m_AccumulatedTime == other.m_AccumulatedTime;
+    }
+  };
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(World, WorldSnapshot)
+{
+  const ezTime tStep = ezTime::Seconds(1.0 / 60.0);
+
+  ezWorldDesc worldDesc("Test");
+  worldDesc.m_FixedTimeStep = tStep;
+
+  ezWorld world(worldDesc);
+  EZ_LOCK(world.GetWriteMarker());
+
+  world.GetOrCreateComponentManager<SnapshotTestComponentRawManager>();
+  world.GetOrCreateComponentManager<SnapshotTestComponentSerializedManager>();
+
+  ezComponentHandle hPrevious;
+  for (ezUInt32 i = 0; i < 100; ++i)
+  {
+    ezGameObjectDesc desc;
+    ezGameObject* pObject = nullptr;
+    world.CreateObject(desc, pObject);
+
+    SnapshotTestComponentRaw* pRaw = nullptr;
+    SnapshotTestComponentRaw::CreateComponent(pObject, pRaw);
+
+    SnapshotTestComponentSerialized* pSerialized = nullptr;
+    SnapshotTestComponentSerialized::CreateComponent(pObject, pSerialized);
+    pSerialized->m_hOther = hPrevious;
+    hPrevious = pSerialized->GetHandle();
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Fixed Time Step")
+  {
+    EZ_TEST_BOOL(world.GetFixedTimeStep() == tStep);
+
+    // the first update always runs exactly one step
+    world.Update();
+    EZ_TEST_BOOL(world.GetClock().GetTimeDiff() == tStep);
+    EZ_TEST_BOOL(world.GetClock().GetAccumulatedTime() == tStep);
+    EZ_TEST_INT(world.GetComponentManager<SnapshotTestComponentRawManager>()->GetComponents()->m_iCounter, 1);
+
+    world.UpdateFixedSteps(3);
+    EZ_TEST_BOOL(world.GetClock().GetTimeDiff() == tStep);
+    EZ_TEST_DOUBLE(world.GetClock().GetAccumulatedTime().GetSeconds(), tStep.GetSeconds() * 4, 0.0001);
+    EZ_TEST_INT(world.GetComponentManager<SnapshotTestComponentRawManager>()->GetComponents()->m_iCounter, 4);
+
+    const float fInterpolation = world.GetFixedStepInterpolation();
+    EZ_TEST_BOOL(fInterpolation >= 0.0f && fInterpolation < 1.0f);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Capture and Restore")
+  {
+    ezWorldSnapshot snapshot;
+    EZ_TEST_BOOL(snapshot.IsEmpty());
+    EZ_TEST_BOOL(snapshot.Restore(world).Failed());
+
+    SnapshotTestState capturedState;
+    capturedState.Gather(world);
+
+    snapshot.Capture(world);
+    EZ_TEST_BOOL(!snapshot.IsEmpty());
+    EZ_TEST_INT(snapshot.GetComponentCount(), 200);
+
+    world.UpdateFixedSteps(10);
+
+    SnapshotTestState simulatedState;
+    simulatedState.Gather(world);
+    EZ_TEST_BOOL(!(simulatedState == capturedState));
+
+    EZ_TEST_BOOL(snapshot.Restore(world).Succeeded());
+
+    SnapshotTestState restoredState;
+    restoredState.Gather(world);
+    EZ_TEST_BOOL(restoredState == capturedState);
+
+    // the simulation has to be deterministic after a restore, including the random numbers
+    world.UpdateFixedSteps(10);
+
+    SnapshotTestState resimulatedState;
+    resimulatedState.Gather(world);
+    EZ_TEST_BOOL(resimulatedState == simulatedState);
+
+    // the snapshot can be restored multiple times
+    EZ_TEST_BOOL(snapshot.Restore(world).Succeeded());
+    restoredState.Gather(world);
+    EZ_TEST_BOOL(restoredState == capturedState);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Restore after components changed")
+  {
+    ezWorldSnapshot snapshot;
+    snapshot.Capture(world);
+
+    world.UpdateFixedSteps(1);
+
+    auto it = world.GetComponentManager<SnapshotTestComponentRawManager>()->GetComponents();
+    world.GetComponentManager<SnapshotTestComponentRawManager>()->DeleteComponent(it->GetHandle());
+    world.UpdateFixedSteps(1);
+
+    SnapshotTestState stateBefore;
+    stateBefore.Gather(world);
+
+    EZ_TEST_BOOL(snapshot.Restore(world).Failed());
+
+    SnapshotTestState stateAfter;
+    stateAfter.Gather(world);
+    EZ_TEST_BOOL(stateAfter == stateBefore);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Restore after game objects moved")
+  {
+    ezGameObjectDesc desc;
+    ezGameObjectHandle hEmptyObject = world.CreateObject(desc);
+
+    // created last, so it is moved into the slot of the empty object once that is deleted
+    ezGameObject* pObject = nullptr;
+    world.CreateObject(desc, pObject);
+
+    SnapshotTestComponentRaw* pRaw = nullptr;
+    const ezComponentHandle hRaw = SnapshotTestComponentRaw::CreateComponent(pObject, pRaw);
+    world.UpdateFixedSteps(1);
+
+    ezWorldSnapshot snapshot;
+    snapshot.Capture(world);
+
+    SnapshotTestState capturedState;
+    capturedState.Gather(world);
+
+    world.DeleteObjectNow(hEmptyObject);
+    pRaw->SetActiveFlag(false);
+    world.UpdateFixedSteps(1);
+
+    EZ_TEST_BOOL(snapshot.Restore(world).Succeeded());
+
+    SnapshotTestState restoredState;
+    restoredState.Gather(world);
+    EZ_TEST_BOOL(restoredState == capturedState);
+
+    // the owner pointer and the active state are not part of the snapshot
+    EZ_TEST_BOOL(world.TryGetComponent(hRaw, pRaw));
+    EZ_TEST_BOOL(world.TryGetObject(pRaw->GetOwner()->GetHandle(), pObject));
+    EZ_TEST_BOOL(pObject == pRaw->GetOwner());
+    EZ_TEST_BOOL(!pRaw->IsActive());
+
+    for (auto it = world.GetComponentManager<SnapshotTestComponentRawManager>()->GetComponents(); it.IsValid(); ++it)
+    {
+      EZ_TEST_BOOL(it->GetOwner()->TryGetComponentOfBaseType(pRaw) && pRaw == &(*it));
+    }
+  }
+}
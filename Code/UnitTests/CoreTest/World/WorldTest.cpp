@@ -1,6 +1,7 @@
 #include <CoreTestPCH.h>
 
 #include <Core/World/World.h>
+#include <Core/World/WorldGroup.h>
 #include <Foundation/Time/Clock.h>
 #include <Foundation/Utilities/GraphicsUtils.h>
 
@@ -623,4 +624,136 @@ EZ_CREATE_SIMPLE_TEST(World, World)
       EZ_TEST_BOOL(pObjects[i]->IsActive() == (i < iTopDisabled));
     }
   }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Create objects in bulk")
+  {
+    ezWorldDesc worldDesc("Test");
+    ezWorld world(worldDesc);
+    EZ_LOCK(world.GetWriteMarker());
+
+    ezGameObjectDesc existingDesc;
+    existingDesc.m_LocalPosition.Set(0, 0, 10);
+    existingDesc.m_bDynamic = true;
+    ezGameObject* pExisting = nullptr;
+    world.CreateObject(existingDesc, pExisting);
+
+    // 0: root, 1: child of existing object, 2-4: children of 0, 5: child of 2, 6: child of 1
+    const ezUInt32 parentIndices[] = {ezInvalidIndex, ezInvalidIndex, 0, 0, 0, 2, 1};
+    const ezUInt32 uiNumObjects = EZ_ARRAY_SIZE(parentIndices);
+
+    ezGameObjectDesc descs[uiNumObjects];
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      ezStringBuilder sb;
+      sb.Format("Object_{0}", i);
+      descs[i].m_sName.Assign(sb.GetData());
+      descs[i].m_LocalPosition.Set((float)i, 0, 0);
+    }
+
+    descs[1].m_hParent = pExisting->GetHandle();
+    descs[4].m_bActiveFlag = false;
+
+    ezGameObject* pObjects[uiNumObjects] = {};
+    world.CreateObjects(ezMakeArrayPtr(descs), ezMakeArrayPtr(parentIndices), ezMakeArrayPtr(pObjects));
+
+    EZ_TEST_INT(world.GetObjectCount(), uiNumObjects + 1);
+
+    EZ_TEST_BOOL(pObjects[0]->GetParent() == nullptr);
+    EZ_TEST_BOOL(pObjects[1]->GetParent() == pExisting);
+    EZ_TEST_BOOL(pObjects[2]->GetParent() == pObjects[0]);
+    EZ_TEST_BOOL(pObjects[5]->GetParent() == pObjects[2]);
+    EZ_TEST_BOOL(pObjects[6]->GetParent() == pObjects[1]);
+    EZ_TEST_INT(pObjects[0]->GetChildCount(), 3);
+
+    ezUInt32 uiChild = 2;
+    for (auto it = pObjects[0]->GetChildren(); it.IsValid(); ++it, ++uiChild)
+    {
+      EZ_TEST_BOOL(&(*it) == pObjects[uiChild]);
+    }
+
+    // children of dynamic objects become dynamic
+    EZ_TEST_BOOL(!pObjects[0]->IsDynamic());
+    EZ_TEST_BOOL(pObjects[1]->IsDynamic());
+    EZ_TEST_BOOL(pObjects[6]->IsDynamic());
+
+    EZ_TEST_BOOL(pObjects[3]->IsActive());
+    EZ_TEST_BOOL(!pObjects[4]->IsActive());
+
+    EZ_TEST_STRING(pObjects[5]->GetName(), "Object_5");
+    EZ_TEST_VEC3(pObjects[5]->GetGlobalPosition(), ezVec3(7, 0, 0), 0);
+    EZ_TEST_VEC3(pObjects[6]->GetGlobalPosition(), ezVec3(7, 0, 10), 0);
+
+    for (ezUInt32 i = 0; i < uiNumObjects; ++i)
+    {
+      ezGameObject* pObject = nullptr;
+      EZ_TEST_BOOL(world.TryGetObject(pObjects[i]->GetHandle(), pObject));
+      EZ_TEST_BOOL(pObject == pObjects[i]);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "World Group")
+  {
+    const ezUInt32 uiNumWorlds = 4;
+
+    ezUniquePtr<ezWorld> worlds[uiNumWorlds];
+    ezGameObject* pParents[uiNumWorlds];
+    ezGameObject* pChildren[uiNumWorlds];
+
+    ezWorldGroup group;
+
+    for (ezUInt32 i = 0; i < uiNumWorlds; ++i)
+    {
+      ezStringBuilder sName;
+      sName.Format("Group{0}", i);
+
+      ezWorldDesc worldDesc(sName);
+      worlds[i] = EZ_DEFAULT_NEW(ezWorld, worldDesc);
+
+      EZ_LOCK(worlds[i]->GetWriteMarker());
+
+      ezGameObjectDesc desc;
+      desc.m_bDynamic = true;
+      worlds[i]->CreateObject(desc, pParents[i]);
+
+      desc.m_hParent = pParents[i]->GetHandle();
+      desc.m_LocalPosition.Set(1, 0, 0);
+      worlds[i]->CreateObject(desc, pChildren[i]);
+
+      pParents[i]->SetLocalPosition(ezVec3((float)i, 0, 0));
+
+      group.AddWorld(worlds[i].Borrow());
+      group.AddWorld(worlds[i].Borrow());
+    }
+
+    EZ_TEST_INT(group.GetWorldCount(), uiNumWorlds);
+
+    group.StartUpdate();
+    EZ_TEST_BOOL(group.IsUpdateInProgress());
+    group.WaitForUpdate();
+    EZ_TEST_BOOL(!group.IsUpdateInProgress());
+
+    for (ezUInt32 i = 0; i < uiNumWorlds; ++i)
+    {
+      EZ_LOCK(worlds[i]->GetReadMarker());
+      EZ_TEST_VEC3(pChildren[i]->GetGlobalPosition(), ezVec3(i + 1.0f, 0, 0), 0);
+    }
+
+    group.RemoveWorld(worlds[0].Borrow());
+    EZ_TEST_INT(group.GetWorldCount(), uiNumWorlds - 1);
+
+    {
+      EZ_LOCK(worlds[0]->GetWriteMarker());
+      pParents[0]->SetLocalPosition(ezVec3(10, 0, 0));
+    }
+
+    group.Update();
+
+    {
+      // not part of the group anymore
+      EZ_LOCK(worlds[0]->GetReadMarker());
+      EZ_TEST_VEC3(pChildren[0]->GetGlobalPosition(), ezVec3(1, 0, 0), 0);
+    }
+
+    group.Clear();
+  }
 }
@@ -267,6 +267,51 @@ EZ_CREATE_SIMPLE_TEST(CodeUtils, Preprocessor)
     }
   }
 
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Colliding Macro Names")
+  {
+    // these two names have the same 32 bit hash, macros are keyed by that hash
+    EZ_TEST_INT(ezTempHashedString("MACRO_56363").GetHash(), ezTempHashedString("MACRO_116528").GetHash());
+
+    const char* szSource = "#define MACRO_56363 first\n"
+                           "MACRO_116528\n"
+                           "#ifdef MACRO_116528\n"
+                           "wrong\n"
+                           "#endif\n"
+                           "#define MACRO_116528 second\n"
+                           "MACRO_56363 MACRO_116528\n"
+                           "#undef MACRO_116528\n"
+                           "MACRO_56363 MACRO_116528\n";
+
+    Logger log;
+
+    ezPreprocessor pp;
+    pp.SetLogInterface(&log);
+    pp.SetFileLocatorFunction(FileLocator);
+    pp.SetFileOpenFunction([szSource](const char* szAbsoluteFile, ezDynamicArray<ezUInt8>& FileContent, ezTimestamp& out_FileModification) -> ezResult {
+      FileContent.PushBackRange(ezArrayPtr<const ezUInt8>(reinterpret_cast<const ezUInt8*>(szSource), ezStringUtils::GetStringElementCount(szSource)));
+      out_FileModification = ezTimestamp();
+      return EZ_SUCCESS;
+    });
+
+    ezStringBuilder sOutput;
+    EZ_TEST_BOOL(pp.Process("Collision.txt", sOutput, false, true).Succeeded());
+
+    EZ_TEST_BOOL(sOutput.FindSubString("wrong") == nullptr);
+
+    const char* szUndefined = sOutput.FindSubString("MACRO_116528");
+    const char* szBoth = sOutput.FindSubString("first second");
+    const char* szAfterUndef = sOutput.FindSubString("first MACRO_116528");
+    EZ_TEST_BOOL(szUndefined != nullptr && szBoth != nullptr && szAfterUndef != nullptr);
+    EZ_TEST_BOOL(szUndefined < szBoth && szBoth < szAfterUndef);
+
+    // nothing is redefined
+    EZ_TEST_BOOL(log.m_sOutput.IsEmpty());
+
+    // processing again starts from scratch, otherwise MACRO_56363 would be redefined
+    EZ_TEST_BOOL(pp.Process("Collision.txt", sOutput, false, true).Succeeded());
+    EZ_TEST_BOOL(sOutput.FindSubString("first second") != nullptr);
+    EZ_TEST_BOOL(log.m_sOutput.IsEmpty());
+  }
 
   ezFileSystem::RemoveDataDirectoryGroup("PreprocessorTest");
 }
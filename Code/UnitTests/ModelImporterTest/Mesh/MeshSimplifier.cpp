@@ -0,0 +1,175 @@
+#include <ModelImporterTestPCH.h>
+
+#include <ModelImporter/MeshSimplifier.h>
+
+namespace MeshSimplifierTestDetail
+{
+  /// Creates a flat grid of uiSize x uiSize quads in the xy plane.
+  ///
+  /// If uiSeamColumn is not zero, the quads right of that column use their own copies of the vertices on it, like a texture seam would.
+  static void CreateGrid(ezUInt32 uiSize, ezUInt32 uiSeamColumn, ezDynamicArray<ezVec3>& out_Positions, ezDynamicArray<ezUInt32>& out_Indices)
+  {
+    for (ezUInt32 y = 0; y <= uiSize; ++y)
+    {
+      for (ezUInt32 x = 0; x <= uiSize; ++x)
+      {
+        out_Positions.PushBack(ezVec3(static_cast<float>(x), static_cast<float>(y), 0.0f));
+      }
+    }
+
+    const ezUInt32 uiFirstSeamVertex = out_Positions.GetCount();
+    if (uiSeamColumn > 0)
+    {
+      for (ezUInt32 y = 0; y <= uiSize; ++y)
+      {
+        out_Positions.PushBack(ezVec3(static_cast<float>(uiSeamColumn), static_cast<float>(y), 0.0f));
+      }
+    }
+
+    auto GetVertex = [&](ezUInt32 x, ezUInt32 y, bool bRightOfSeam) -> ezUInt32 {
+      if (bRightOfSeam && x == uiSeamColumn)
+        return uiFirstSeamVertex + y;
+
+      return y * (uiSize + 1) + x;
+    };
+
+    for (ezUInt32 y = 0; y < uiSize; ++y)
+    {
+      for (ezUInt32 x = 0; x < uiSize; ++x)
+      {
+        const bool bRightOfSeam = uiSeamColumn > 0 && x >= uiSeamColumn;
+
+        const ezUInt32 v0 = GetVertex(x, y, bRightOfSeam);
+        const ezUInt32 v1 = GetVertex(x + 1, y, bRightOfSeam);
+        const ezUInt32 v2 = GetVertex(x, y + 1, bRightOfSeam);
+        const ezUInt32 v3 = GetVertex(x + 1, y + 1, bRightOfSeam);
+
+        out_Indices.PushBack(v0);
+        out_Indices.PushBack(v1);
+        out_Indices.PushBack(v3);
+
+        out_Indices.PushBack(v0);
+        out_Indices.PushBack(v3);
+        out_Indices.PushBack(v2);
+      }
+    }
+  }
+
+  static void GetUsedVertices(ezUInt32 uiVertexCount, ezArrayPtr<const ezUInt32> indices, ezDynamicArray<bool>& out_UsedVertices)
+  {
+    out_UsedVertices.Clear();
+    out_UsedVertices.SetCount(uiVertexCount);
+
+    for (ezUInt32 uiIndex : indices)
+    {
+      out_UsedVertices[uiIndex] = true;
+    }
+  }
+} // namespace MeshSimplifierTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Mesh, MeshSimplifier)
+{
+  using namespace MeshSimplifierTestDetail;
+
+  const ezUInt32 uiGridSize = 16;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Triangle Ratio")
+  {
+    ezDynamicArray<ezVec3> positions;
+    ezDynamicArray<ezUInt32> indices;
+    CreateGrid(uiGridSize, 0, positions, indices);
+
+    const ezUInt32 uiTriangleCount = indices.GetCount() / 3;
+    EZ_TEST_INT(uiTriangleCount, 512);
+
+    // same target computation as the mesh asset LOD generation
+    const float ratios[] = {0.9f, 0.75f, 0.5f, 0.25f};
+
+    ezDynamicArray<ezUInt32> simplifiedIndices;
+    for (float fRatio : ratios)
+    {
+      const ezUInt32 uiTargetCount = static_cast<ezUInt32>(uiTriangleCount * fRatio);
+
+      ezModelImporter::MeshSimplifier::Simplify(positions, indices, uiTargetCount, ezMath::MaxValue<float>(), simplifiedIndices);
+
+      // every collapse in the interior of the grid removes two triangles, so the target may be undershot by one
+      const ezUInt32 uiSimplifiedCount = simplifiedIndices.GetCount() / 3;
+      EZ_TEST_BOOL(uiSimplifiedCount <= uiTargetCount);
+      EZ_TEST_BOOL(uiSimplifiedCount + 1 >= uiTargetCount);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Max Error")
+  {
+    ezDynamicArray<ezVec3> positions;
+    ezDynamicArray<ezUInt32> indices;
+    CreateGrid(uiGridSize, 0, positions, indices);
+
+    // bend the grid into a paraboloid, removing any interior vertex moves the surface
+    const float fCenter = uiGridSize * 0.5f;
+    for (ezVec3& vPos : positions)
+    {
+      vPos.z = 0.25f * (ezMath::Square(vPos.x - fCenter) + ezMath::Square(vPos.y - fCenter));
+    }
+
+    ezDynamicArray<ezUInt32> simplifiedIndices;
+    ezModelImporter::MeshSimplifier::Simplify(positions, indices, 0, 0.001f, simplifiedIndices);
+
+    EZ_TEST_BOOL(simplifiedIndices == indices);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Locked Border Vertices")
+  {
+    ezDynamicArray<ezVec3> positions;
+    ezDynamicArray<ezUInt32> indices;
+    CreateGrid(uiGridSize, 0, positions, indices);
+
+    ezDynamicArray<ezUInt32> simplifiedIndices;
+    ezModelImporter::MeshSimplifier::Simplify(positions, indices, 0, ezMath::MaxValue<float>(), simplifiedIndices);
+
+    EZ_TEST_BOOL(simplifiedIndices.GetCount() < indices.GetCount() / 2);
+
+    ezDynamicArray<bool> usedVertices;
+    GetUsedVertices(positions.GetCount(), simplifiedIndices, usedVertices);
+
+    for (ezUInt32 v = 0; v < positions.GetCount(); ++v)
+    {
+      const ezVec3& vPos = positions[v];
+      const bool bBorder = vPos.x == 0.0f || vPos.y == 0.0f || vPos.x == uiGridSize || vPos.y == uiGridSize;
+
+      if (bBorder)
+      {
+        EZ_TEST_BOOL(usedVertices[v]);
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Locked Seam Vertices")
+  {
+    const ezUInt32 uiSeamColumn = uiGridSize / 2;
+
+    ezDynamicArray<ezVec3> positions;
+    ezDynamicArray<ezUInt32> indices;
+    CreateGrid(uiGridSize, uiSeamColumn, positions, indices);
+
+    ezDynamicArray<ezUInt32> simplifiedIndices;
+    ezModelImporter::MeshSimplifier::Simplify(positions, indices, 0, ezMath::MaxValue<float>(), simplifiedIndices);
+
+    EZ_TEST_BOOL(simplifiedIndices.GetCount() < indices.GetCount() / 2);
+
+    ezDynamicArray<bool> usedVertices;
+    GetUsedVertices(positions.GetCount(), simplifiedIndices, usedVertices);
+
+    // both copies of the seam vertices have to stay, otherwise the halves would tear apart
+    ezUInt32 uiUsedSeamVertices = 0;
+    for (ezUInt32 v = 0; v < positions.GetCount(); ++v)
+    {
+      if (positions[v].x == uiSeamColumn && usedVertices[v])
+      {
+        ++uiUsedSeamVertices;
+      }
+    }
+
+    EZ_TEST_INT(uiUsedSeamVertices, (uiGridSize + 1) * 2);
+  }
+}
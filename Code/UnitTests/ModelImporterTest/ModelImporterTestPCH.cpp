@@ -0,0 +1 @@
+#include <ModelImporterTestPCH.h>
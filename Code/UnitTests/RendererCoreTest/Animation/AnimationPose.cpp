@@ -0,0 +1,331 @@
+#include <RendererCoreTestPCH.h>
+
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Threading/TaskSystem.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <RendererCore/AnimationSystem/AnimationClipResource.h>
+#include <RendererCore/AnimationSystem/AnimationLocalPose.h>
+#include <RendererCore/AnimationSystem/AnimationPose.h>
+#include <RendererCore/AnimationSystem/SkeletonBuilder.h>
+
+namespace AnimationPoseTestDetail
+{
+  static const ezUInt16 s_uiNumJoints = 64;
+
+  static ezTransform GetJointTransform(ezUInt32 uiJoint, float fVariation)
+  {
+    const ezVec3 vAxis = ezVec3(1.0f, (float)(uiJoint % 3), (float)(uiJoint % 5)).GetNormalized();
+
+    ezTransform t;
+    t.m_vPosition.Set(0.1f * (uiJoint % 4), 0.25f + fVariation, -0.05f * (uiJoint % 7));
+    t.m_qRotation.SetFromAxisAndAngle(vAxis, ezAngle::Degree(15.0f + 5.0f * (uiJoint % 6) + 90.0f * fVariation));
+    t.m_vScale.Set(1.0f + 0.1f * fVariation);
+    return t;
+  }
+
+  static float GetRotationError(const ezQuat& q0, const ezQuat& q1)
+  {
+    const float fDot = ezMath::Min(ezMath::Abs(q0.v.Dot(q1.v) + q0.w * q1.w), 1.0f);
+    return 2.0f * ezMath::ACos(fDot).GetRadian();
+  }
+
+  /// Builds a binary tree of joints, so that every joint except the root has a parent.
+  static void CreateTestSkeleton(ezSkeleton& skeleton)
+  {
+    ezSkeletonBuilder builder;
+
+    for (ezUInt32 uiJoint = 0; uiJoint < s_uiNumJoints; ++uiJoint)
+    {
+      ezStringBuilder sName;
+      sName.Format("Joint{0}", uiJoint);
+
+      builder.AddJoint(sName, GetJointTransform(uiJoint, 0.0f), uiJoint == 0 ? 0xFFFFFFFFu : (uiJoint - 1) / 2);
+    }
+
+    builder.BuildSkeleton(skeleton);
+  }
+
+  /// The straight forward scalar implementation, used as a reference.
+  static void ComputeObjectSpaceReference(const ezSkeleton& skeleton, ezArrayPtr<const ezTransform> localTransforms, ezDynamicArray<ezMat4>& out_Result)
+  {
+    out_Result.SetCount(skeleton.GetJointCount());
+
+    for (ezUInt16 i = 0; i < skeleton.GetJointCount(); ++i)
+    {
+      out_Result[i] = localTransforms[i].GetAsMat4();
+
+      const ezSkeletonJoint& joint = skeleton.GetJointByIndex(i);
+      if (!joint.IsRootJoint())
+      {
+        out_Result[i] = out_Result[joint.GetParentIndex()] * out_Result[i];
+      }
+    }
+  }
+} // namespace AnimationPoseTestDetail
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+static const ezTestBlock::Enum EnableInRelease = ezTestBlock::DisabledNoWarning;
+#else
+static const ezTestBlock::Enum EnableInRelease = ezTestBlock::Enabled;
+#endif
+
+EZ_CREATE_SIMPLE_TEST(Animation, AnimationPose)
+{
+  using namespace AnimationPoseTestDetail;
+
+  ezSkeleton skeleton;
+  CreateTestSkeleton(skeleton);
+
+  EZ_TEST_INT(skeleton.GetInverseBindPoseMatrices().GetCount(), s_uiNumJoints);
+
+  ezDynamicArray<ezTransform> localTransforms;
+  for (ezUInt32 uiJoint = 0; uiJoint < s_uiNumJoints; ++uiJoint)
+  {
+    localTransforms.PushBack(GetJointTransform(uiJoint, 0.3f));
+  }
+
+  ezDynamicArray<ezMat4> reference;
+  ComputeObjectSpaceReference(skeleton, localTransforms, reference);
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ConvertFromLocalSpaceToObjectSpace")
+  {
+    ezAnimationPose pose;
+    pose.Configure(skeleton);
+
+    for (ezUInt16 i = 0; i < s_uiNumJoints; ++i)
+    {
+      pose.SetTransform(i, localTransforms[i].GetAsMat4());
+    }
+
+    pose.ConvertFromLocalSpaceToObjectSpace(skeleton);
+
+    for (ezUInt16 i = 0; i < s_uiNumJoints; ++i)
+    {
+      EZ_TEST_BOOL(pose.GetTransform(i).IsEqual(reference[i], 0.0001f));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ConvertFromObjectSpaceToSkinningSpace")
+  {
+    ezAnimationPose pose;
+    pose.Configure(skeleton);
+    pose.ConvertFromLocalSpaceToObjectSpace(skeleton);
+
+    ezDynamicArray<ezMat4> skinningMatrices;
+    skinningMatrices.SetCount(s_uiNumJoints);
+    pose.ConvertFromObjectSpaceToSkinningSpace(skeleton, skinningMatrices);
+
+    // in the bind pose all skinning matrices are the identity
+    for (ezUInt16 i = 0; i < s_uiNumJoints; ++i)
+    {
+      EZ_TEST_BOOL(skinningMatrices[i].IsIdentity(0.0001f));
+    }
+
+    // the output version leaves the pose in object space, the in-place version must produce the same result
+    pose.ConvertFromObjectSpaceToSkinningSpace(skeleton);
+
+    for (ezUInt16 i = 0; i < s_uiNumJoints; ++i)
+    {
+      EZ_TEST_BOOL(pose.GetTransform(i).IsEqual(skinningMatrices[i], 0.0f));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ezAnimationLocalPose::ConvertToObjectSpace")
+  {
+    ezAnimationLocalPose localPose;
+    localPose.Configure(skeleton);
+
+    for (ezUInt16 i = 0; i < s_uiNumJoints; ++i)
+    {
+      localPose.SetTransform(i, ezSimdConversion::ToTransform(localTransforms[i]));
+    }
+
+    ezAnimationPose pose;
+    pose.Configure(skeleton);
+    pose.SetValidityOfAllTransforms(false);
+
+    localPose.ConvertToObjectSpace(skeleton, pose);
+
+    for (ezUInt16 i = 0; i < s_uiNumJoints; ++i)
+    {
+      EZ_TEST_BOOL(pose.IsTransformValid(i));
+      EZ_TEST_BOOL(pose.GetTransform(i).IsEqual(reference[i], 0.0001f));
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "ezAnimationLocalPose::SetToBlendedPoses")
+  {
+    ezAnimationLocalPose pose0, pose1, result;
+    pose0.Configure(skeleton);
+    pose1.Configure(skeleton);
+
+    for (ezUInt16 i = 0; i < s_uiNumJoints; ++i)
+    {
+      ezSimdTransform t = ezSimdConversion::ToTransform(localTransforms[i]);
+
+      // q and -q are the same rotation, blending must not be affected by the sign
+      if (i % 2 == 0)
+        t.m_Rotation = -t.m_Rotation;
+
+      pose1.SetTransform(i, t);
+    }
+
+    const ezAnimationLocalPose* poses[] = {&pose0, &pose1};
+
+    {
+      // only the second pose has any weight
+      const float weights[] = {0.0f, 2.0f};
+      result.SetToBlendedPoses(ezMakeArrayPtr(poses), ezMakeArrayPtr(weights));
+
+      for (ezUInt16 i = 0; i < s_uiNumJoints; ++i)
+      {
+        const ezTransform t = ezSimdConversion::ToTransform(result.GetTransform(i));
+        EZ_TEST_BOOL(GetRotationError(t.m_qRotation, localTransforms[i].m_qRotation) < 0.001f);
+        EZ_TEST_VEC3(t.m_vPosition, localTransforms[i].m_vPosition, 0.0001f);
+        EZ_TEST_VEC3(t.m_vScale, localTransforms[i].m_vScale, 0.0001f);
+      }
+    }
+
+    {
+      const float weights[] = {0.75f, 0.25f};
+      result.SetToBlendedPoses(ezMakeArrayPtr(poses), ezMakeArrayPtr(weights));
+
+      for (ezUInt16 i = 0; i < s_uiNumJoints; ++i)
+      {
+        const ezTransform bind = skeleton.GetJointByIndex(i).GetBindPoseLocalTransform();
+        const ezTransform t = ezSimdConversion::ToTransform(result.GetTransform(i));
+
+        ezQuat qExpected;
+        qExpected.SetSlerp(bind.m_qRotation, localTransforms[i].m_qRotation, 0.25f);
+
+        EZ_TEST_BOOL(GetRotationError(t.m_qRotation, qExpected) < 0.01f);
+        EZ_TEST_VEC3(t.m_vPosition, ezMath::Lerp(bind.m_vPosition, localTransforms[i].m_vPosition, 0.25f), 0.0001f);
+        EZ_TEST_VEC3(t.m_vScale, ezMath::Lerp(bind.m_vScale, localTransforms[i].m_vScale, 0.25f), 0.0001f);
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "SetLocalPoseToBlendedKeyframe")
+  {
+    // a clip that moves every joint from its bind pose to the test transform, sampled halfway
+    ezAnimationClipResourceDescriptor anim;
+    anim.Configure(s_uiNumJoints, 2, 30, false);
+
+    for (ezUInt16 uiJoint = 0; uiJoint < s_uiNumJoints; ++uiJoint)
+    {
+      ezStringBuilder sName;
+      sName.Format("Joint{0}", uiJoint);
+
+      ezHashedString hs;
+      hs.Assign(sName.GetData());
+      anim.AddJointName(hs);
+
+      ezArrayPtr<ezTransform> keyframes = anim.GetJointKeyframes(uiJoint);
+      keyframes[0] = skeleton.GetJointByIndex(uiJoint).GetBindPoseLocalTransform();
+      keyframes[1] = localTransforms[uiJoint];
+    }
+
+    // the matrix pose is the path that was used before the local pose, both have to agree
+    ezAnimationPose expectedPose;
+    expectedPose.Configure(skeleton);
+    anim.SetPoseToBlendedKeyframe(expectedPose, skeleton, 0, 0.5f);
+    expectedPose.ConvertFromLocalSpaceToObjectSpace(skeleton);
+
+    ezAnimationLocalPose localPose;
+    localPose.Configure(skeleton);
+    anim.SetLocalPoseToBlendedKeyframe(localPose, skeleton, 0, 0.5f);
+
+    ezAnimationPose pose;
+    pose.Configure(skeleton);
+    localPose.ConvertToObjectSpace(skeleton, pose);
+
+    for (ezUInt16 i = 0; i < s_uiNumJoints; ++i)
+    {
+      EZ_TEST_BOOL(pose.GetTransform(i).IsEqual(expectedPose.GetTransform(i), 0.001f));
+    }
+  }
+
+  EZ_TEST_BLOCK(EnableInRelease, "Performance")
+  {
+    const ezUInt32 uiNumPoses = 512;
+
+    ezAnimationLocalPose pose0, pose1;
+    pose0.Configure(skeleton);
+    pose1.Configure(skeleton);
+
+    for (ezUInt16 i = 0; i < s_uiNumJoints; ++i)
+    {
+      pose1.SetTransform(i, ezSimdConversion::ToTransform(localTransforms[i]));
+    }
+
+    struct Instance
+    {
+      ezAnimationLocalPose m_LocalPose;
+      ezAnimationPose m_Pose;
+      ezDynamicArray<ezMat4> m_SkinningMatrices;
+      float m_fWeight = 0.0f;
+    };
+
+    ezDynamicArray<Instance> instances;
+    instances.SetCount(uiNumPoses);
+
+    for (ezUInt32 i = 0; i < uiNumPoses; ++i)
+    {
+      instances[i].m_Pose.Configure(skeleton);
+      instances[i].m_SkinningMatrices.SetCount(s_uiNumJoints);
+      instances[i].m_fWeight = (float)i / uiNumPoses;
+    }
+
+    auto EvaluateInstance = [&](Instance& instance) {
+      const ezAnimationLocalPose* poses[] = {&pose0, &pose1};
+      const float weights[] = {1.0f - instance.m_fWeight, instance.m_fWeight};
+
+      instance.m_LocalPose.SetToBlendedPoses(ezMakeArrayPtr(poses), ezMakeArrayPtr(weights));
+      instance.m_LocalPose.ConvertToObjectSpace(skeleton, instance.m_Pose);
+      instance.m_Pose.ConvertFromObjectSpaceToSkinningSpace(skeleton, instance.m_SkinningMatrices);
+    };
+
+    {
+      ezDynamicArray<ezMat4> objectSpace;
+
+      ezStopwatch sw;
+
+      for (ezUInt32 i = 0; i < uiNumPoses; ++i)
+      {
+        ComputeObjectSpaceReference(skeleton, localTransforms, objectSpace);
+
+        for (ezUInt16 j = 0; j < s_uiNumJoints; ++j)
+        {
+          instances[i].m_SkinningMatrices[j] = objectSpace[j] * skeleton.GetJointByIndex(j).GetInverseBindPoseGlobalTransform().GetAsMat4();
+        }
+      }
+
+      const ezTime tDiff = sw.Checkpoint();
+      ezTestFramework::Output(ezTestOutput::Duration, "Scalar skinning matrices (%u poses): %.3fms", uiNumPoses, tDiff.GetMilliseconds());
+    }
+
+    {
+      ezStopwatch sw;
+
+      for (Instance& instance : instances)
+      {
+        EvaluateInstance(instance);
+      }
+
+      const ezTime tDiff = sw.Checkpoint();
+      ezTestFramework::Output(ezTestOutput::Duration, "SIMD blend + skinning matrices (%u poses): %.3fms", uiNumPoses, tDiff.GetMilliseconds());
+    }
+
+    {
+      ezStopwatch sw;
+
+      ezTaskSystem::ParallelForSingle(instances.GetArrayPtr(), EvaluateInstance, "EvaluateAnimationPoses");
+
+      const ezTime tDiff = sw.Checkpoint();
+      ezTestFramework::Output(
+        ezTestOutput::Duration, "Parallel SIMD blend + skinning matrices (%u poses): %.3fms", uiNumPoses, tDiff.GetMilliseconds());
+    }
+
+    EZ_TEST_BOOL(instances.PeekBack().m_SkinningMatrices[s_uiNumJoints - 1].IsValid());
+  }
+}
@@ -0,0 +1,104 @@
+#include <RendererCoreTestPCH.h>
+
+#include <Foundation/Utilities/GraphicsUtils.h>
+#include <RendererCore/Pipeline/OcclusionBuffer.h>
+
+namespace OcclusionBufferTestDetail
+{
+  static ezBoundingBox CreateBox(const ezVec3& vCenter, const ezVec3& vHalfExtents)
+  {
+    return ezBoundingBox(vCenter - vHalfExtents, vCenter + vHalfExtents);
+  }
+} // namespace OcclusionBufferTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Culling, OcclusionBuffer)
+{
+  using namespace OcclusionBufferTestDetail;
+
+  // camera at the origin looking along +x with z up
+  const ezMat4 viewMatrix = ezGraphicsUtils::CreateLookAtViewMatrix(ezVec3::ZeroVector(), ezVec3(1, 0, 0), ezVec3(0, 0, 1));
+  const ezMat4 projectionMatrix = ezGraphicsUtils::CreatePerspectiveProjectionMatrixFromFovY(ezAngle::Degree(90.0f), 2.0f, 0.1f, 100.0f);
+  const ezMat4 viewProjectionMatrix = projectionMatrix * viewMatrix;
+
+  ezOcclusionBuffer buffer;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Empty")
+  {
+    buffer.Begin(viewProjectionMatrix, 125, 60);
+    buffer.Rasterize();
+
+    EZ_TEST_INT(buffer.GetWidth(), 128);
+    EZ_TEST_INT(buffer.GetHeight(), 64);
+    EZ_TEST_INT(buffer.GetNumOccluderTriangles(), 0);
+    EZ_TEST_FLOAT(buffer.GetDepth(64, 32), 0.0f, 0.0f);
+
+    EZ_TEST_BOOL(buffer.IsVisible(CreateBox(ezVec3(20, 0, 0), ezVec3(0.5f))));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Wall")
+  {
+    buffer.Begin(viewProjectionMatrix, 128, 64);
+
+    // front face at x = 9.5
+    ezTransform wallTransform = ezTransform::IdentityTransform();
+    wallTransform.m_vPosition.Set(10, 0, 0);
+    buffer.AddOccluderBox(CreateBox(ezVec3::ZeroVector(), ezVec3(0.5f, 4.0f, 4.0f)), wallTransform);
+    buffer.Rasterize();
+
+    EZ_TEST_INT(buffer.GetNumOccluderTriangles(), 12);
+    EZ_TEST_FLOAT(buffer.GetDepth(64, 32), 1.0f / 9.5f, 0.0001f);
+    EZ_TEST_FLOAT(buffer.GetDepth(0, 0), 0.0f, 0.0f);
+    EZ_TEST_FLOAT(buffer.GetTileDepth(8, 4), 1.0f / 9.5f, 0.0001f);
+
+    // hidden behind the wall
+    EZ_TEST_BOOL(!buffer.IsVisible(CreateBox(ezVec3(20, 0, 0), ezVec3(0.5f))));
+    EZ_TEST_BOOL(!buffer.IsVisible(CreateBox(ezVec3(50, 2, -2), ezVec3(2.0f))));
+
+    // in front of the wall
+    EZ_TEST_BOOL(buffer.IsVisible(CreateBox(ezVec3(5, 0, 0), ezVec3(0.5f))));
+
+    // touching the front face of the wall
+    EZ_TEST_BOOL(buffer.IsVisible(CreateBox(ezVec3(10, 0, 0), ezVec3(0.5f))));
+
+    // behind the wall, but next to it on screen
+    EZ_TEST_BOOL(buffer.IsVisible(CreateBox(ezVec3(20, 12, 0), ezVec3(0.5f))));
+
+    // partially hidden
+    EZ_TEST_BOOL(buffer.IsVisible(CreateBox(ezVec3(20, 8, 0), ezVec3(1.0f))));
+
+    // hidden, but too small to cover a pixel center, the center of the screen is the corner of four pixels
+    EZ_TEST_BOOL(buffer.IsVisible(CreateBox(ezVec3(50, 0, 0), ezVec3(0.1f))));
+
+    // intersects the near plane
+    EZ_TEST_BOOL(buffer.IsVisible(CreateBox(ezVec3::ZeroVector(), ezVec3(0.5f))));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Near Plane Clipping")
+  {
+    buffer.Begin(viewProjectionMatrix, 128, 64);
+
+    // a floor below the camera that starts behind it
+    buffer.AddOccluderBox(CreateBox(ezVec3(14, 0, -2.5f), ezVec3(16.0f, 8.0f, 0.5f)), ezTransform::IdentityTransform());
+    buffer.Rasterize();
+
+    EZ_TEST_BOOL(buffer.GetNumOccluderTriangles() > 0);
+
+    EZ_TEST_BOOL(!buffer.IsVisible(CreateBox(ezVec3(10, 0, -10), ezVec3(0.5f))));
+    EZ_TEST_BOOL(buffer.IsVisible(CreateBox(ezVec3(10, 0, 5), ezVec3(0.5f))));
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Triangles")
+  {
+    buffer.Begin(viewProjectionMatrix, 128, 64);
+
+    // a single quad, both windings must occlude
+    const ezVec3 positions[] = {ezVec3(10, -3, -3), ezVec3(10, 3, -3), ezVec3(10, 3, 3), ezVec3(10, -3, 3)};
+    const ezUInt32 indices[] = {0, 1, 2, 0, 3, 2};
+    buffer.AddOccluder(ezMakeArrayPtr(positions), ezMakeArrayPtr(indices), ezTransform::IdentityTransform());
+    buffer.Rasterize();
+
+    EZ_TEST_INT(buffer.GetNumOccluderTriangles(), 2);
+    EZ_TEST_FLOAT(buffer.GetDepth(64, 32), 1.0f / 10.0f, 0.0001f);
+    EZ_TEST_BOOL(!buffer.IsVisible(CreateBox(ezVec3(30, 0, 0), ezVec3(2.0f))));
+  }
+}
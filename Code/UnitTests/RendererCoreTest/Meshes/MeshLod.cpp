@@ -0,0 +1,213 @@
+#include <RendererCoreTestPCH.h>
+
+#include <Core/Graphics/Geometry.h>
+#include <Foundation/Configuration/Startup.h>
+#include <Core/World/World.h>
+#include <RendererCore/Meshes/MeshComponent.h>
+#include <RendererCore/Meshes/MeshResource.h>
+#include <RendererCore/Pipeline/ExtractedRenderData.h>
+#include <RendererCore/Pipeline/Extractor.h>
+#include <RendererCore/Pipeline/View.h>
+#include <RendererCore/RenderWorld/RenderWorld.h>
+#include <RendererNull/Device/DeviceNull.h>
+
+namespace MeshLodTestDetail
+{
+  static ezMeshResourceHandle CreateMesh(const char* szName, ezArrayPtr<const float> lodScreenSizes)
+  {
+    ezGeometry geom;
+    geom.AddBox(ezVec3(1.0f), ezColor::White);
+
+    ezMeshBufferResourceDescriptor desc;
+    desc.AddStream(ezGALVertexAttributeSemantic::Position, ezGALResourceFormat::XYZFloat);
+    desc.AllocateStreamsFromGeometry(geom, ezGALPrimitiveTopology::Triangles);
+
+    ezStringBuilder sMeshBufferName(szName, "_MeshBuffer");
+    ezMeshBufferResourceHandle hMeshBuffer = ezResourceManager::CreateResource<ezMeshBufferResource>(sMeshBufferName, std::move(desc));
+
+    ezResourceLock<ezMeshBufferResource> pMeshBuffer(hMeshBuffer, ezResourceAcquireMode::BlockTillLoaded);
+
+    // all LODs use the same triangles, only the selection is tested
+    ezMeshResourceDescriptor md;
+    md.UseExistingMeshBuffer(hMeshBuffer);
+    md.AddSubMesh(pMeshBuffer->GetPrimitiveCount(), 0, 0);
+    md.SetMaterial(0, "");
+
+    for (float fMaxScreenSize : lodScreenSizes)
+    {
+      md.AddLod(fMaxScreenSize);
+      md.AddSubMesh(pMeshBuffer->GetPrimitiveCount(), 0, 0);
+    }
+
+    md.ComputeBounds();
+
+    return ezResourceManager::CreateResource<ezMeshResource>(szName, std::move(md));
+  }
+} // namespace MeshLodTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Meshes, MeshLod)
+{
+  using namespace MeshLodTestDetail;
+
+  ezGALDeviceCreationDescription deviceDesc;
+  deviceDesc.m_bCreatePrimarySwapChain = false;
+
+  ezGALDeviceNull* pDevice = EZ_DEFAULT_NEW(ezGALDeviceNull, deviceDesc);
+  EZ_TEST_BOOL(pDevice->Init().Succeeded());
+  ezGALDevice::SetDefaultDevice(pDevice);
+
+  ezStartup::StartupHighLevelSystems();
+
+  {
+    const float lodScreenSizes[] = {0.5f, 0.25f};
+    ezMeshResourceHandle hMesh = CreateMesh("MeshLodTest_ThreeLods", ezMakeArrayPtr(lodScreenSizes));
+    ezMeshResourceHandle hSingleLodMesh = CreateMesh("MeshLodTest_SingleLod", ezArrayPtr<const float>());
+
+    ezResourceLock<ezMeshResource> pMesh(hMesh, ezResourceAcquireMode::BlockTillLoaded);
+    ezResourceLock<ezMeshResource> pSingleLodMesh(hSingleLodMesh, ezResourceAcquireMode::BlockTillLoaded);
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Single LOD")
+    {
+      EZ_TEST_INT(pSingleLodMesh->GetLodCount(), 1);
+      EZ_TEST_INT(pSingleLodMesh->SelectLod(0.01f, 0, 0.1f), 0);
+      EZ_TEST_INT(pSingleLodMesh->SelectLod(10.0f, 3, 0.1f), 0);
+    }
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Without Hysteresis")
+    {
+      EZ_TEST_INT(pMesh->GetLodCount(), 3);
+
+      EZ_TEST_INT(pMesh->SelectLod(1.0f, 0, 0.0f), 0);
+      EZ_TEST_INT(pMesh->SelectLod(0.5f, 0, 0.0f), 0);
+      EZ_TEST_INT(pMesh->SelectLod(0.49f, 0, 0.0f), 1);
+      EZ_TEST_INT(pMesh->SelectLod(0.25f, 0, 0.0f), 1);
+      EZ_TEST_INT(pMesh->SelectLod(0.24f, 0, 0.0f), 2);
+      EZ_TEST_INT(pMesh->SelectLod(0.0f, 0, 0.0f), 2);
+
+      // the result doesn't depend on the previous LOD
+      EZ_TEST_INT(pMesh->SelectLod(0.49f, 2, 0.0f), 1);
+      EZ_TEST_INT(pMesh->SelectLod(1.0f, 2, 0.0f), 0);
+
+      // invalid previous LODs are clamped
+      EZ_TEST_INT(pMesh->SelectLod(0.49f, 7, 0.0f), 1);
+    }
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "With Hysteresis")
+    {
+      const float fHysteresis = 0.1f;
+
+      // LOD 0 switches to LOD 1 below 0.5 * 0.9
+      EZ_TEST_INT(pMesh->SelectLod(0.46f, 0, fHysteresis), 0);
+      EZ_TEST_INT(pMesh->SelectLod(0.44f, 0, fHysteresis), 1);
+
+      // LOD 1 switches back above 0.5 * 1.1 and to LOD 2 below 0.25 * 0.9
+      EZ_TEST_INT(pMesh->SelectLod(0.54f, 1, fHysteresis), 1);
+      EZ_TEST_INT(pMesh->SelectLod(0.56f, 1, fHysteresis), 0);
+      EZ_TEST_INT(pMesh->SelectLod(0.23f, 1, fHysteresis), 1);
+      EZ_TEST_INT(pMesh->SelectLod(0.22f, 1, fHysteresis), 2);
+
+      // LOD 2 switches back above 0.25 * 1.1
+      EZ_TEST_INT(pMesh->SelectLod(0.27f, 2, fHysteresis), 2);
+      EZ_TEST_INT(pMesh->SelectLod(0.28f, 2, fHysteresis), 1);
+
+      // large changes skip LODs
+      EZ_TEST_INT(pMesh->SelectLod(0.1f, 0, fHysteresis), 2);
+      EZ_TEST_INT(pMesh->SelectLod(1.0f, 2, fHysteresis), 0);
+    }
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Two Views")
+    {
+      ezWorldDesc worldDesc("MeshLodTest");
+      ezWorld world(worldDesc);
+
+      ezDynamicArray<const ezGameObject*> visibleObjects;
+
+      {
+        EZ_LOCK(world.GetWriteMarker());
+
+        ezGameObjectDesc desc;
+        desc.m_bDynamic = false;
+
+        ezGameObject* pObject = nullptr;
+        world.CreateObject(desc, pObject);
+
+        ezMeshComponent* pMeshComponent = nullptr;
+        ezMeshComponent::CreateComponent(pObject, pMeshComponent);
+        pMeshComponent->SetMesh(hMesh);
+
+        world.Update();
+
+        visibleObjects.PushBack(pObject);
+      }
+
+      // the box has a radius of ~0.87, so the near view selects LOD 0 and the far view LOD 2
+      ezCamera nearCamera;
+      nearCamera.SetCameraMode(ezCameraMode::PerspectiveFixedFovY, 60.0f, 0.1f, 100.0f);
+      nearCamera.LookAt(ezVec3(-2, 0, 0), ezVec3::ZeroVector(), ezVec3(0, 0, 1));
+
+      ezCamera farCamera;
+      farCamera.SetCameraMode(ezCameraMode::PerspectiveFixedFovY, 60.0f, 0.1f, 100.0f);
+      farCamera.LookAt(ezVec3(-20, 0, 0), ezVec3::ZeroVector(), ezVec3(0, 0, 1));
+
+      ezView* pNearView = nullptr;
+      ezViewHandle hNearView = ezRenderWorld::CreateView("MeshLodTest_Near", pNearView);
+      ezView* pFarView = nullptr;
+      ezViewHandle hFarView = ezRenderWorld::CreateView("MeshLodTest_Far", pFarView);
+
+      ezView* views[] = {pNearView, pFarView};
+      ezCamera* cameras[] = {&nearCamera, &farCamera};
+      const ezUInt32 expectedLods[] = {0, 2};
+
+      for (ezUInt32 i = 0; i < 2; ++i)
+      {
+        views[i]->SetWorld(&world);
+        views[i]->SetCamera(cameras[i]);
+        views[i]->SetViewport(ezRectFloat(0, 0, 256, 256));
+      }
+
+      ezVisibleObjectsExtractor extractor;
+
+      // the selection of one view must neither leak into the other view nor into later frames
+      for (ezUInt32 uiFrame = 0; uiFrame < 3; ++uiFrame)
+      {
+        ezRenderWorld::BeginFrame();
+
+        for (ezUInt32 i = 0; i < 2; ++i)
+        {
+          ezExtractedRenderData extractedRenderData;
+          extractedRenderData.SetCamera(*cameras[i]);
+
+          extractor.Extract(*views[i], visibleObjects, extractedRenderData);
+          extractedRenderData.SortAndBatch();
+
+          ezUInt32 uiNumRenderData = 0;
+          ezRenderDataBatchList batchList = extractedRenderData.GetRenderDataBatchesWithCategory(ezDefaultRenderDataCategories::LitOpaque);
+          for (ezUInt32 uiBatch = 0; uiBatch < batchList.GetBatchCount(); ++uiBatch)
+          {
+            const ezRenderDataBatch& batch = batchList.GetBatch(uiBatch);
+            for (auto it = batch.GetIterator<ezMeshRenderData>(); it.IsValid(); ++it)
+            {
+              const ezMeshRenderData* pRenderData = it;
+              EZ_TEST_INT(pRenderData->m_uiSubMeshIndex, expectedLods[i]);
+              ++uiNumRenderData;
+            }
+          }
+
+          EZ_TEST_INT(uiNumRenderData, 1);
+        }
+
+        ezRenderWorld::EndFrame();
+      }
+
+      ezRenderWorld::DeleteView(hNearView);
+      ezRenderWorld::DeleteView(hFarView);
+    }
+  }
+
+  ezResourceManager::FreeAllUnusedResources();
+
+  ezStartup::ShutdownHighLevelSystems();
+
+  pDevice->Shutdown();
+  EZ_DEFAULT_DELETE(pDevice);
+}
@@ -0,0 +1,298 @@
+#include <RendererCoreTestPCH.h>
+
+#include <Core/Graphics/Camera.h>
+#include <Foundation/Configuration/CVar.h>
+#include <Foundation/Configuration/Startup.h>
+#include <RendererCore/Pipeline/ExtractedRenderData.h>
+#include <RendererCore/Pipeline/RenderPipelinePass.h>
+#include <RendererCore/Pipeline/Renderer.h>
+#include <RendererCore/RenderContext/RenderContext.h>
+#include <RendererNull/Context/ContextNull.h>
+#include <RendererNull/Device/DeviceNull.h>
+
+namespace
+{
+  // every render data sets a scissor rect with this height and its index + 1 as width, so its commands can be found in the recording
+  static const ezUInt32 s_uiMarkerHeight = 7;
+
+  // every batch that is prepared for parallel recording sets a scissor rect with this height on the source context
+  static const ezUInt32 s_uiPrepareMarkerHeight = 9;
+
+  static ezDynamicArray<ezRenderContext*> s_RecordingContexts;
+
+  class ezParallelRecordingTestRenderData : public ezRenderData
+  {
+    EZ_ADD_DYNAMIC_REFLECTION(ezParallelRecordingTestRenderData, ezRenderData);
+
+  public:
+    ezUInt32 m_uiIndex = 0;
+  };
+
+  class ezParallelRecordingTestRenderer : public ezRenderer
+  {
+    EZ_ADD_DYNAMIC_REFLECTION(ezParallelRecordingTestRenderer, ezRenderer);
+
+  public:
+    virtual void GetSupportedRenderDataTypes(ezHybridArray<const ezRTTI*, 8>& types) const override
+    {
+      types.PushBack(ezGetStaticRTTI<ezParallelRecordingTestRenderData>());
+    }
+
+    virtual void GetSupportedRenderDataCategories(ezHybridArray<ezRenderData::Category, 8>& categories) const override
+    {
+      categories.PushBack(ezRenderData::FindCategory("ParallelRecordingTest"));
+    }
+
+    virtual void RenderBatch(
+      const ezRenderViewContext& renderViewContext, const ezRenderPipelinePass* pPass, const ezRenderDataBatch& batch) const override
+    {
+      for (auto it = batch.GetIterator<ezParallelRecordingTestRenderData>(); it.IsValid(); ++it)
+      {
+        const ezParallelRecordingTestRenderData* pRenderData = it;
+
+        // every render data is recorded by exactly one chunk, so this doesn't need to be locked
+        s_RecordingContexts[pRenderData->m_uiIndex] = renderViewContext.m_pRenderContext;
+
+        renderViewContext.m_pRenderContext->GetGALContext()->SetScissorRect(ezRectU32(0, 0, pRenderData->m_uiIndex + 1, s_uiMarkerHeight));
+      }
+    }
+
+    virtual bool SupportsParallelRecording() const override { return true; }
+
+    virtual void PrepareParallelRecording(const ezRenderViewContext& renderViewContext, const ezRenderDataBatch& batch) const override
+    {
+      EZ_TEST_BOOL(!renderViewContext.m_pRenderContext->IsDeferred());
+
+      const ezUInt32 uiBatchId = batch.GetFirstData<ezRenderData>()->m_uiBatchId;
+      renderViewContext.m_pRenderContext->GetGALContext()->SetScissorRect(ezRectU32(0, 0, uiBatchId + 1, s_uiPrepareMarkerHeight));
+    }
+  };
+
+  // clang-format off
+  EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezParallelRecordingTestRenderData, 1, ezRTTINoAllocator)
+  EZ_END_DYNAMIC_REFLECTED_TYPE;
+
+  EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezParallelRecordingTestRenderer, 1, ezRTTIDefaultAllocator<ezParallelRecordingTestRenderer>)
+  EZ_END_DYNAMIC_REFLECTED_TYPE;
+  // clang-format on
+
+  class ezParallelRecordingTestPass : public ezRenderPipelinePass
+  {
+  public:
+    ezParallelRecordingTestPass()
+      : ezRenderPipelinePass("ParallelRecordingTestPass")
+    {
+    }
+
+    virtual bool GetRenderTargetDescriptions(const ezView& view, const ezArrayPtr<ezGALTextureCreationDescription* const> inputs,
+      ezArrayPtr<ezGALTextureCreationDescription> outputs) override
+    {
+      return true;
+    }
+
+    virtual void Execute(const ezRenderViewContext& renderViewContext, const ezArrayPtr<ezRenderPipelinePassConnection* const> inputs,
+      const ezArrayPtr<ezRenderPipelinePassConnection* const> outputs) override
+    {
+    }
+  };
+
+  static ezUInt64 SortByIndex(const ezRenderData* pRenderData, ezUInt32 uiRenderDataSortingKey, const ezCamera& camera)
+  {
+    return uiRenderDataSortingKey;
+  }
+
+  /// Renders all batches and returns the render data indices in the order in which their commands reached the primary context,
+  /// as well as the number of batches that were prepared for parallel recording before the first render data was drawn.
+  static void RecordBatches(ezParallelRecordingTestPass& pass, ezRenderData::Category category, const ezRenderDataBatchList& batchList,
+    ezDynamicArray<ezUInt32>& out_Indices, ezUInt32& out_uiPreparedBatches)
+  {
+    ezRenderContext* pRenderContext = ezRenderContext::GetDefaultInstance();
+    ezGALContextNull* pPrimaryContext = static_cast<ezGALContextNull*>(pRenderContext->GetGALContext());
+
+    for (ezRenderContext*& pContext : s_RecordingContexts)
+    {
+      pContext = nullptr;
+    }
+
+    pRenderContext->GetGALContext()->SetScissorRect(ezRectU32(0, 0, 1, 1));
+    pPrimaryContext->ClearRecordedCommands();
+
+    ezRenderViewContext renderViewContext;
+    renderViewContext.m_pCamera = nullptr;
+    renderViewContext.m_pViewData = nullptr;
+    renderViewContext.m_pRenderContext = pRenderContext;
+    renderViewContext.m_pWorldDebugContext = nullptr;
+    renderViewContext.m_pViewDebugContext = nullptr;
+
+    pass.RenderBatchesParallel(renderViewContext, category, batchList);
+
+    out_Indices.Clear();
+    out_uiPreparedBatches = 0;
+    for (const ezGALNullCommand& command : pPrimaryContext->GetRecordedCommands())
+    {
+      if (command.m_Type != ezGALNullCommandType::SetScissorRect)
+        continue;
+
+      if (command.m_uiArgs[1] == s_uiMarkerHeight)
+      {
+        out_Indices.PushBack(command.m_uiArgs[0] - 1);
+      }
+      else if (command.m_uiArgs[1] == s_uiPrepareMarkerHeight && out_Indices.IsEmpty())
+      {
+        ++out_uiPreparedBatches;
+      }
+    }
+  }
+
+  /// Returns the number of consecutive ranges of render data that were recorded by the same context, or 0 if a context recorded
+  /// more than one range or if a range wasn't recorded by the expected context.
+  static ezUInt32 CountChunks(bool bParallel)
+  {
+    ezUInt32 uiChunkCount = 0;
+    ezRenderContext* pPreviousContext = nullptr;
+
+    for (ezRenderContext* pContext : s_RecordingContexts)
+    {
+      if (pContext == pPreviousContext)
+        continue;
+
+      ezRenderContext* pExpectedContext = bParallel ? ezRenderContext::GetDeferredInstance(uiChunkCount) : ezRenderContext::GetDefaultInstance();
+      if (pContext != pExpectedContext)
+        return 0;
+
+      pPreviousContext = pContext;
+      ++uiChunkCount;
+    }
+
+    return uiChunkCount;
+  }
+} // namespace
+
+EZ_CREATE_SIMPLE_TEST(Pipeline, ParallelRecording)
+{
+  const ezRenderData::Category category = ezRenderData::RegisterCategory("ParallelRecordingTest", &SortByIndex);
+
+  ezGALDeviceCreationDescription deviceDesc;
+  deviceDesc.m_bCreatePrimarySwapChain = false;
+
+  ezGALDeviceNull* pDevice = EZ_DEFAULT_NEW(ezGALDeviceNull, deviceDesc);
+  EZ_TEST_BOOL(pDevice->Init().Succeeded());
+  ezGALDevice::SetDefaultDevice(pDevice);
+
+  ezStartup::StartupHighLevelSystems();
+
+  // deferred null contexts record their commands whenever the primary context does
+  static_cast<ezGALContextNull*>(pDevice->GetPrimaryContext())->SetCommandRecording(true);
+
+  ezCVarBool* pParallelRecording = static_cast<ezCVarBool*>(ezCVar::FindCVarByName("r_ParallelRecording"));
+  ezCVarInt* pParallelRecordingChunks = static_cast<ezCVarInt*>(ezCVar::FindCVarByName("r_ParallelRecordingChunks"));
+  ezCVarInt* pParallelRecordingMinBatches = static_cast<ezCVarInt*>(ezCVar::FindCVarByName("r_ParallelRecordingMinBatches"));
+
+  const bool bOldParallelRecording = *pParallelRecording;
+  const int iOldChunks = *pParallelRecordingChunks;
+  const int iOldMinBatches = *pParallelRecordingMinBatches;
+
+  // 40 batches with 1 to 4 render data each, so that the chunks have to be balanced by the amount of render data
+  const ezUInt32 uiNumBatches = 40;
+
+  ezDynamicArray<ezParallelRecordingTestRenderData> renderData;
+  for (ezUInt32 uiBatch = 0; uiBatch < uiNumBatches; ++uiBatch)
+  {
+    for (ezUInt32 i = 0; i <= uiBatch % 4; ++i)
+    {
+      ezParallelRecordingTestRenderData& data = renderData.ExpandAndGetRef();
+      data.m_uiIndex = renderData.GetCount() - 1;
+      data.m_uiSortingKey = data.m_uiIndex;
+      data.m_uiBatchId = uiBatch;
+    }
+  }
+
+  ezExtractedRenderData extractedData;
+  for (const ezParallelRecordingTestRenderData& data : renderData)
+  {
+    extractedData.AddRenderData(&data, category);
+  }
+  extractedData.SortAndBatch();
+
+  const ezRenderDataBatchList batchList = extractedData.GetRenderDataBatchesWithCategory(category);
+  EZ_TEST_INT(batchList.GetBatchCount(), uiNumBatches);
+
+  s_RecordingContexts.SetCount(renderData.GetCount());
+
+  ezParallelRecordingTestPass pass;
+  ezDynamicArray<ezUInt32> serialIndices;
+  ezDynamicArray<ezUInt32> indices;
+  ezUInt32 uiPreparedBatches = 0;
+
+  pDevice->BeginFrame();
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Serial")
+  {
+    *pParallelRecording = false;
+
+    RecordBatches(pass, category, batchList, serialIndices, uiPreparedBatches);
+
+    EZ_TEST_INT(serialIndices.GetCount(), renderData.GetCount());
+    for (ezUInt32 i = 0; i < serialIndices.GetCount(); ++i)
+    {
+      EZ_TEST_INT(serialIndices[i], i);
+    }
+
+    EZ_TEST_INT(CountChunks(false), 1);
+    EZ_TEST_INT(uiPreparedBatches, 0);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Deferred Contexts")
+  {
+    *pParallelRecording = true;
+    *pParallelRecordingMinBatches = 4;
+
+    struct TestCase
+    {
+      int m_iMaxChunks;
+      ezUInt32 m_uiExpectedChunks;
+    };
+
+    // at most 40 / 4 = 10 chunks, a single chunk is rendered serially
+    const TestCase testCases[] = {{1, 1}, {2, 2}, {3, 3}, {8, 8}, {16, 10}};
+
+    for (const TestCase& testCase : testCases)
+    {
+      *pParallelRecordingChunks = testCase.m_iMaxChunks;
+
+      RecordBatches(pass, category, batchList, indices, uiPreparedBatches);
+
+      EZ_TEST_BOOL(indices == serialIndices);
+      EZ_TEST_INT(CountChunks(testCase.m_uiExpectedChunks > 1), testCase.m_uiExpectedChunks);
+
+      // all batches have to be prepared on the source context before any chunk is executed
+      EZ_TEST_INT(uiPreparedBatches, testCase.m_uiExpectedChunks > 1 ? uiNumBatches : 0);
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Too Few Batches")
+  {
+    *pParallelRecordingChunks = 8;
+    *pParallelRecordingMinBatches = 32;
+
+    RecordBatches(pass, category, batchList, indices, uiPreparedBatches);
+
+    EZ_TEST_BOOL(indices == serialIndices);
+    EZ_TEST_INT(CountChunks(false), 1);
+    EZ_TEST_INT(uiPreparedBatches, 0);
+  }
+
+  pDevice->EndFrame();
+
+  *pParallelRecording = bOldParallelRecording;
+  *pParallelRecordingChunks = iOldChunks;
+  *pParallelRecordingMinBatches = iOldMinBatches;
+
+  s_RecordingContexts.Clear();
+  s_RecordingContexts.Compact();
+
+  ezStartup::ShutdownHighLevelSystems();
+
+  pDevice->Shutdown();
+  EZ_DEFAULT_DELETE(pDevice);
+}
@@ -0,0 +1,248 @@
+#include <RendererCoreTestPCH.h>
+
+#include <Foundation/Configuration/Startup.h>
+#include <RendererCore/Pipeline/ExtractedRenderData.h>
+#include <RendererCore/Pipeline/InstanceDataProvider.h>
+#include <RendererCore/RenderContext/RenderContext.h>
+#include <RendererCore/RenderWorld/RenderWorld.h>
+#include <RendererNull/Context/ContextNull.h>
+#include <RendererNull/Device/DeviceNull.h>
+
+#include <RendererCore/../../../Data/Base/Shaders/Common/ObjectConstants.h>
+
+namespace StaticInstanceDataTestDetail
+{
+  class ezStaticInstanceDataTestRenderData : public ezRenderData
+  {
+    EZ_ADD_DYNAMIC_REFLECTION(ezStaticInstanceDataTestRenderData, ezRenderData);
+  };
+
+  // clang-format off
+  EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezStaticInstanceDataTestRenderData, 1, ezRTTINoAllocator)
+  EZ_END_DYNAMIC_REFLECTED_TYPE;
+  // clang-format on
+
+  static ezUInt64 SortByIndex(const ezRenderData* pRenderData, ezUInt32 uiRenderDataSortingKey, const ezCamera& camera)
+  {
+    return uiRenderDataSortingKey;
+  }
+
+  /// A single batch whose render data has the given cache ids.
+  struct TestBatch
+  {
+    TestBatch(ezRenderData::Category category, std::initializer_list<ezUInt32> cacheIds)
+    {
+      m_RenderData.SetCount((ezUInt32)cacheIds.size());
+
+      ezUInt32 uiIndex = 0;
+      for (ezUInt32 uiCacheId : cacheIds)
+      {
+        ezStaticInstanceDataTestRenderData& data = m_RenderData[uiIndex];
+        data.m_uiSortingKey = uiIndex;
+        data.m_uiCacheId = uiCacheId;
+
+        m_ExtractedData.AddRenderData(&data, category);
+        ++uiIndex;
+      }
+
+      m_ExtractedData.SortAndBatch();
+
+      const ezRenderDataBatchList batchList = m_ExtractedData.GetRenderDataBatchesWithCategory(category);
+      EZ_TEST_INT(batchList.GetBatchCount(), 1);
+
+      m_Batch = batchList.GetBatch(0);
+    }
+
+    ezDynamicArray<ezStaticInstanceDataTestRenderData> m_RenderData;
+    ezExtractedRenderData m_ExtractedData;
+    ezRenderDataBatch m_Batch;
+  };
+
+  struct Upload
+  {
+    EZ_DECLARE_POD_TYPE();
+
+    ezUInt32 m_uiOffset;
+    ezUInt32 m_uiCount;
+  };
+
+  /// Runs a batch through the static instance data like ezMeshRenderer does and records which instance ranges were uploaded.
+  /// Returns the number of instances to draw or 0 if the batch can't use the static instance data.
+  static ezUInt32 RenderBatch(ezStaticInstanceData& staticData, ezUInt64 uiBatchKey, const TestBatch& batch, ezDynamicArray<Upload>& out_Uploads)
+  {
+    ezRenderContext* pRenderContext = ezRenderContext::GetDefaultInstance();
+    ezGALContextNull* pGALContext = static_cast<ezGALContextNull*>(pRenderContext->GetGALContext());
+    pGALContext->ClearRecordedCommands();
+
+    out_Uploads.Clear();
+
+    ezArrayPtr<ezPerInstanceData> instanceData;
+    if (staticData.BeginBatch(uiBatchKey, batch.m_Batch, instanceData).Failed())
+      return 0;
+
+    if (!instanceData.IsEmpty())
+    {
+      ezMemoryUtils::ZeroFill(instanceData.GetPtr(), instanceData.GetCount());
+
+      if (staticData.UpdateInstanceData(pRenderContext, batch.m_Batch.GetCount()).Failed())
+        return 0;
+    }
+
+    for (const ezGALNullCommand& command : pGALContext->GetRecordedCommands())
+    {
+      if (command.m_Type == ezGALNullCommandType::UpdateBuffer)
+      {
+        Upload& upload = out_Uploads.ExpandAndGetRef();
+        upload.m_uiOffset = command.m_uiArgs[0] / sizeof(ezPerInstanceData);
+        upload.m_uiCount = command.m_uiArgs[1] / sizeof(ezPerInstanceData);
+      }
+    }
+
+    return staticData.BindBatch(pRenderContext);
+  }
+
+  static void TestUploads(const ezDynamicArray<Upload>& uploads, std::initializer_list<Upload> expectedUploads)
+  {
+    EZ_TEST_INT(uploads.GetCount(), (ezUInt32)expectedUploads.size());
+
+    ezUInt32 uiIndex = 0;
+    for (const Upload& expected : expectedUploads)
+    {
+      if (uiIndex >= uploads.GetCount())
+        break;
+
+      EZ_TEST_INT(uploads[uiIndex].m_uiOffset, expected.m_uiOffset);
+      EZ_TEST_INT(uploads[uiIndex].m_uiCount, expected.m_uiCount);
+      ++uiIndex;
+    }
+  }
+} // namespace StaticInstanceDataTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Pipeline, StaticInstanceData)
+{
+  using namespace StaticInstanceDataTestDetail;
+
+  const ezRenderData::Category category = ezRenderData::RegisterCategory("StaticInstanceDataTest", &SortByIndex);
+
+  ezGALDeviceCreationDescription deviceDesc;
+  deviceDesc.m_bCreatePrimarySwapChain = false;
+
+  ezGALDeviceNull* pDevice = EZ_DEFAULT_NEW(ezGALDeviceNull, deviceDesc);
+  EZ_TEST_BOOL(pDevice->Init().Succeeded());
+  ezGALDevice::SetDefaultDevice(pDevice);
+
+  ezStartup::StartupHighLevelSystems();
+
+  static_cast<ezGALContextNull*>(pDevice->GetPrimaryContext())->SetCommandRecording(true);
+
+  {
+    // batches get 50% more space than they need, as long as it is available
+    ezStaticInstanceData staticData(16);
+    ezDynamicArray<Upload> uploads;
+
+    const ezUInt64 uiKeyA = 1;
+    const ezUInt64 uiKeyB = 2;
+    const ezUInt64 uiKeyC = 3;
+    const ezUInt64 uiKeyD = 4;
+
+    ezRenderWorld::BeginFrame();
+    pDevice->BeginFrame();
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Range Allocation")
+    {
+      TestBatch batchA(category, {1, 2, 3, 4});
+      TestBatch batchB(category, {5, 6, 7, 8});
+
+      EZ_TEST_INT(RenderBatch(staticData, uiKeyA, batchA, uploads), 4);
+      TestUploads(uploads, {{0, 4}});
+
+      EZ_TEST_INT(RenderBatch(staticData, uiKeyB, batchB, uploads), 4);
+      TestUploads(uploads, {{6, 4}});
+
+      // unchanged batches are not uploaded again
+      EZ_TEST_INT(RenderBatch(staticData, uiKeyA, batchA, uploads), 4);
+      TestUploads(uploads, {});
+    }
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Unsupported Batches")
+    {
+      TestBatch uncachedBatch(category, {10, 0, 11});
+      EZ_TEST_INT(RenderBatch(staticData, uiKeyC, uncachedBatch, uploads), 0);
+
+      TestBatch tooLargeBatch(category, {20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36});
+      EZ_TEST_INT(RenderBatch(staticData, uiKeyC, tooLargeBatch, uploads), 0);
+      TestUploads(uploads, {});
+    }
+
+    pDevice->EndFrame();
+    ezRenderWorld::EndFrame();
+
+    ezRenderWorld::BeginFrame();
+    pDevice->BeginFrame();
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Partial Update")
+    {
+      // only the instance that changed is uploaded
+      TestBatch changedBatchA(category, {1, 2, 9, 4});
+      EZ_TEST_INT(RenderBatch(staticData, uiKeyA, changedBatchA, uploads), 4);
+      TestUploads(uploads, {{2, 1}});
+
+      // growing within the range keeps the range
+      TestBatch grownBatchA(category, {1, 2, 9, 4, 10});
+      EZ_TEST_INT(RenderBatch(staticData, uiKeyA, grownBatchA, uploads), 5);
+      TestUploads(uploads, {{4, 1}});
+    }
+
+    pDevice->EndFrame();
+    ezRenderWorld::EndFrame();
+
+    ezRenderWorld::BeginFrame();
+    pDevice->BeginFrame();
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Eviction")
+    {
+      TestBatch batchA(category, {1, 2, 9, 4, 10});
+      EZ_TEST_INT(RenderBatch(staticData, uiKeyA, batchA, uploads), 5);
+      TestUploads(uploads, {});
+
+      // only [12, 16) is free, so B, which wasn't rendered in the previous frame, is evicted and its range reused
+      TestBatch batchC(category, {11, 12, 13, 14, 15});
+      EZ_TEST_INT(RenderBatch(staticData, uiKeyC, batchC, uploads), 5);
+      TestUploads(uploads, {{6, 5}});
+
+      // B gets a new range and has to be uploaded completely
+      TestBatch batchB(category, {5, 6, 7, 8});
+      EZ_TEST_INT(RenderBatch(staticData, uiKeyB, batchB, uploads), 4);
+      TestUploads(uploads, {{11, 4}});
+    }
+
+    pDevice->EndFrame();
+    ezRenderWorld::EndFrame();
+
+    ezRenderWorld::BeginFrame();
+    pDevice->BeginFrame();
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Merging")
+    {
+      // the whole buffer is only available if the freed ranges of all evicted batches are merged again
+      TestBatch batchD(category, {30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, 44, 45});
+      EZ_TEST_INT(RenderBatch(staticData, uiKeyD, batchD, uploads), 16);
+      TestUploads(uploads, {{0, 16}});
+
+      // A was evicted as well and D, which was rendered in this frame, leaves no room for it
+      TestBatch batchA(category, {1, 2, 9, 4, 10});
+      EZ_TEST_INT(RenderBatch(staticData, uiKeyA, batchA, uploads), 0);
+    }
+
+    pDevice->EndFrame();
+    ezRenderWorld::EndFrame();
+  }
+
+  static_cast<ezGALContextNull*>(pDevice->GetPrimaryContext())->SetCommandRecording(false);
+  static_cast<ezGALContextNull*>(pDevice->GetPrimaryContext())->ClearRecordedCommands();
+
+  ezStartup::ShutdownHighLevelSystems();
+
+  pDevice->Shutdown();
+  EZ_DEFAULT_DELETE(pDevice);
+}
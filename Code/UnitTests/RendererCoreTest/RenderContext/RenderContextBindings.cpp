@@ -0,0 +1,208 @@
+#include <RendererCoreTestPCH.h>
+
+#include <Foundation/Algorithm/HashingUtils.h>
+#include <Foundation/Configuration/Startup.h>
+#include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
+#include <RendererCore/RenderContext/RenderContext.h>
+#include <RendererCore/Shader/ShaderPermutationBinary.h>
+#include <RendererCore/Shader/ShaderResource.h>
+#include <RendererCore/ShaderCompiler/ShaderManager.h>
+#include <RendererNull/Context/ContextNull.h>
+#include <RendererNull/Device/DeviceNull.h>
+
+namespace RenderContextBindingsTestDetail
+{
+  static const ezUInt32 s_uiStageHash = 0x52434254;
+
+  /// Writes a shader without permutation variables whose vertex stage reads the texture "TestTexture" into the shader cache,
+  /// so the render context can resolve its bindings without compiling anything.
+  static ezResult WriteShader()
+  {
+    {
+      ezFileWriter file;
+      if (file.Open(":output/RenderContextBindingsTest/Test.ezShader").Failed())
+        return EZ_FAILURE;
+
+      const char* szShader = "[PLATFORMS]\nALL\n\n[PERMUTATIONS]\n";
+      file.WriteBytes(szShader, ezStringUtils::GetStringElementCount(szShader));
+    }
+
+    {
+      ezStringBuilder sStageFile;
+      sStageFile.Format(":output/RenderContextBindingsTest/ShaderCache/DX11_SM50/{0}_{1}.ezShaderStage",
+        ezGALShaderStage::Names[ezGALShaderStage::VertexShader], ezArgU(s_uiStageHash, 8, true, 16, true));
+
+      ezFileWriter file;
+      if (file.Open(sStageFile).Failed())
+        return EZ_FAILURE;
+
+      // see ezShaderStageBinary::Write
+      const ezUInt8 uiVersion = ezShaderStageBinary::VersionCurrent;
+      const ezUInt8 uiStage = ezGALShaderStage::VertexShader;
+      const ezUInt32 uiByteCode = 0xDEADBEEF;
+      const ezUInt32 uiByteCodeSize = sizeof(uiByteCode);
+      const ezUInt16 uiResources = 1;
+
+      file << uiVersion;
+      file << s_uiStageHash;
+      file << uiStage;
+      file << uiByteCodeSize;
+      file.WriteBytes(&uiByteCode, uiByteCodeSize);
+      file << uiResources;
+      file << "TestTexture";
+      file << ezInt32(0);
+      file << (ezUInt8)ezShaderResourceBinding::Texture2D;
+    }
+
+    {
+      // the permutation of a shader without permutation variables, see ezShaderManager::PreloadSinglePermutationInternal
+      ezStringBuilder sPermutationFile;
+      sPermutationFile.Format(":output/RenderContextBindingsTest/ShaderCache/DX11_SM50/RenderContextBindingsTest/Test_{0}.ezPermutation",
+        ezArgU(ezHashingUtils::xxHash32(nullptr, 0), 8, true, 16, true));
+
+      ezShaderPermutationBinary permutationBinary;
+      permutationBinary.m_uiShaderStageHashes[ezGALShaderStage::VertexShader] = s_uiStageHash;
+
+      ezFileWriter file;
+      if (file.Open(sPermutationFile).Failed())
+        return EZ_FAILURE;
+
+      return permutationBinary.Write(file);
+    }
+  }
+
+  static ezUInt32 DrawAndCountBindings(ezRenderContext* pRenderContext, ezGALResourceViewHandle hResourceView)
+  {
+    ezGALContextNull* pGALContext = static_cast<ezGALContextNull*>(pRenderContext->GetGALContext());
+    pGALContext->ClearRecordedCommands();
+
+    EZ_TEST_BOOL(pRenderContext->DrawMeshBuffer(1).Succeeded());
+
+    const ezGALResourceView* pResourceView = ezGALDevice::GetDefaultDevice()->GetResourceView(hResourceView);
+
+    ezUInt32 uiBindings = 0;
+    for (const ezGALNullCommand& command : pGALContext->GetRecordedCommands())
+    {
+      if (command.m_Type == ezGALNullCommandType::SetResourceView && command.m_pObject == pResourceView)
+      {
+        ++uiBindings;
+      }
+    }
+
+    return uiBindings;
+  }
+} // namespace RenderContextBindingsTestDetail
+
+EZ_CREATE_SIMPLE_TEST(RenderContext, Bindings)
+{
+  using namespace RenderContextBindingsTestDetail;
+
+  ezGALDeviceCreationDescription deviceDesc;
+  deviceDesc.m_bCreatePrimarySwapChain = false;
+
+  ezGALDeviceNull* pDevice = EZ_DEFAULT_NEW(ezGALDeviceNull, deviceDesc);
+  EZ_TEST_BOOL(pDevice->Init().Succeeded());
+  ezGALDevice::SetDefaultDevice(pDevice);
+
+  ezStartup::StartupHighLevelSystems();
+
+  ezStringBuilder sOutputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sOutputPath.GetData(), "RenderContextBindingsTest", "output", ezFileSystem::AllowWrites).Succeeded());
+
+  ezShaderManager::Configure("DX11_SM50", false, ":output/RenderContextBindingsTest/ShaderCache", "RenderContextBindingsTest/PermutationVars");
+  EZ_TEST_BOOL(WriteShader().Succeeded());
+
+  ezGALTextureCreationDescription textureDesc;
+  textureDesc.SetAsRenderTarget(64, 64, ezGALResourceFormat::RGBAUByteNormalized);
+  textureDesc.m_bAllowUAV = true;
+
+  ezGALTextureHandle hTexture = pDevice->CreateTexture(textureDesc);
+  ezGALTextureHandle hOtherTexture = pDevice->CreateTexture(textureDesc);
+
+  ezGALResourceViewHandle hResourceView = pDevice->GetDefaultResourceView(hTexture);
+
+  ezGALUnorderedAccessViewCreationDescription uavDesc;
+  uavDesc.m_hTexture = hTexture;
+  ezGALUnorderedAccessViewHandle hUAV = pDevice->CreateUnorderedAccessView(uavDesc);
+
+  ezGALRenderTargetSetup otherRenderTargetSetup;
+  otherRenderTargetSetup.SetRenderTarget(0, pDevice->GetDefaultRenderTargetView(hOtherTexture));
+
+  ezGALRenderTargetSetup textureRenderTargetSetup;
+  textureRenderTargetSetup.SetRenderTarget(0, pDevice->GetDefaultRenderTargetView(hTexture));
+
+  {
+    ezRenderContext* pRenderContext = ezRenderContext::GetDefaultInstance();
+    ezGALContextNull* pGALContext = static_cast<ezGALContextNull*>(pRenderContext->GetGALContext());
+    pGALContext->SetCommandRecording(true);
+
+    pGALContext->SetRenderTargetSetup(otherRenderTargetSetup);
+
+    ezShaderResourceHandle hShader = ezResourceManager::LoadResource<ezShaderResource>("RenderContextBindingsTest/Test.ezShader");
+    pRenderContext->BindShader(hShader);
+    pRenderContext->BindTexture2D("TestTexture", hResourceView);
+    pRenderContext->BindMeshBuffer(ezGALBufferHandle(), ezGALBufferHandle(), nullptr, ezGALPrimitiveTopology::Triangles, 1);
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Unchanged Bindings")
+    {
+      EZ_TEST_INT(DrawAndCountBindings(pRenderContext, hResourceView), 1);
+      EZ_TEST_INT(DrawAndCountBindings(pRenderContext, hResourceView), 0);
+    }
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Render Target Change")
+    {
+      // binding the texture as render target unbinds its resource view
+      pGALContext->SetRenderTargetSetup(textureRenderTargetSetup);
+      pGALContext->SetRenderTargetSetup(otherRenderTargetSetup);
+
+      EZ_TEST_INT(DrawAndCountBindings(pRenderContext, hResourceView), 1);
+      EZ_TEST_INT(DrawAndCountBindings(pRenderContext, hResourceView), 0);
+    }
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "UAV Change")
+    {
+      // binding the texture as UAV unbinds its resource view
+      pGALContext->SetUnorderedAccessView(0, hUAV);
+      pGALContext->SetUnorderedAccessView(0, ezGALUnorderedAccessViewHandle());
+
+      EZ_TEST_INT(DrawAndCountBindings(pRenderContext, hResourceView), 1);
+      EZ_TEST_INT(DrawAndCountBindings(pRenderContext, hResourceView), 0);
+    }
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Force Rebind")
+    {
+      pRenderContext->GetAndResetStatistics();
+
+      // a binding that the shader doesn't use, so only the unchanged one is skipped
+      pRenderContext->BindTexture2D("UnusedTexture", hResourceView);
+      DrawAndCountBindings(pRenderContext, hResourceView);
+      EZ_TEST_INT(pRenderContext->GetAndResetStatistics().m_uiSkippedBindings, 1);
+
+      // the GAL context filters the redundant binding, but the render context has to apply it
+      pRenderContext->BindTexture2D("UnusedTexture", ezGALResourceViewHandle());
+      pRenderContext->BindShader(hShader, ezShaderBindFlags::ForceRebind);
+      DrawAndCountBindings(pRenderContext, hResourceView);
+      EZ_TEST_INT(pRenderContext->GetAndResetStatistics().m_uiSkippedBindings, 0);
+    }
+
+    pGALContext->SetCommandRecording(false);
+    pGALContext->ClearRecordedCommands();
+
+    pRenderContext->ResetContextState();
+    pGALContext->SetRenderTargetSetup(ezGALRenderTargetSetup());
+  }
+
+  pDevice->DestroyUnorderedAccessView(hUAV);
+  pDevice->DestroyTexture(hTexture);
+  pDevice->DestroyTexture(hOtherTexture);
+
+  ezResourceManager::FreeAllUnusedResources();
+
+  ezFileSystem::RemoveDataDirectoryGroup("RenderContextBindingsTest");
+
+  ezStartup::ShutdownHighLevelSystems();
+
+  pDevice->Shutdown();
+  EZ_DEFAULT_DELETE(pDevice);
+}
@@ -0,0 +1,150 @@
+#include <RendererCoreTestPCH.h>
+
+#include <Foundation/Configuration/Startup.h>
+#include <RendererCore/Pipeline/RenderData.h>
+#include <RendererCore/Pipeline/View.h>
+#include <RendererCore/RenderWorld/RenderWorld.h>
+#include <RendererNull/Device/DeviceNull.h>
+
+namespace RenderDataCacheTestDetail
+{
+  class ezRenderDataCacheTestRenderData : public ezRenderData
+  {
+    EZ_ADD_DYNAMIC_REFLECTION(ezRenderDataCacheTestRenderData, ezRenderData);
+  };
+
+  // clang-format off
+  EZ_BEGIN_DYNAMIC_REFLECTED_TYPE(ezRenderDataCacheTestRenderData, 1, ezRTTIDefaultAllocator<ezRenderDataCacheTestRenderData>)
+  EZ_END_DYNAMIC_REFLECTED_TYPE;
+  // clang-format on
+
+  static ezUInt64 SortByIndex(const ezRenderData* pRenderData, ezUInt32 uiRenderDataSortingKey, const ezCamera& camera)
+  {
+    return uiRenderDataSortingKey;
+  }
+
+  /// Passes one render data of the given object to the cache like the extraction does, the cache is updated in the next EndFrame.
+  static void CacheRenderData(const ezView& view, ezRenderData::Category category, const ezGameObjectHandle& hObject,
+    const ezComponentHandle& hComponent, const ezRenderData* pRenderData)
+  {
+    ezInternal::RenderDataCacheEntry entry;
+    ezMemoryUtils::ZeroFill(&entry, 1);
+    entry.m_pRenderData = pRenderData;
+    entry.m_uiCategory = category.m_uiValue;
+
+    ezRenderWorld::CacheRenderData(view, hObject, hComponent, ezMakeArrayPtr(&entry, 1));
+  }
+
+  /// Returns the cache id of the cached render data of the given object or 0 if there is no valid cache entry.
+  static ezUInt32 GetCachedRenderDataId(const ezView& view, const ezGameObjectHandle& hObject)
+  {
+    ezArrayPtr<ezInternal::RenderDataCacheEntry> entries = ezRenderWorld::GetCachedRenderData(view, hObject);
+    if (entries.GetCount() != 1)
+      return 0;
+
+    return entries[0].m_pRenderData->m_uiCacheId;
+  }
+
+  static void NextFrame(ezGALDevice* pDevice)
+  {
+    pDevice->EndFrame();
+    ezRenderWorld::EndFrame();
+
+    ezRenderWorld::BeginFrame();
+    pDevice->BeginFrame();
+  }
+} // namespace RenderDataCacheTestDetail
+
+EZ_CREATE_SIMPLE_TEST(RenderWorld, RenderDataCache)
+{
+  using namespace RenderDataCacheTestDetail;
+
+  const ezRenderData::Category category = ezRenderData::RegisterCategory("RenderDataCacheTest", &SortByIndex);
+
+  ezGALDeviceCreationDescription deviceDesc;
+  deviceDesc.m_bCreatePrimarySwapChain = false;
+
+  ezGALDeviceNull* pDevice = EZ_DEFAULT_NEW(ezGALDeviceNull, deviceDesc);
+  EZ_TEST_BOOL(pDevice->Init().Succeeded());
+  ezGALDevice::SetDefaultDevice(pDevice);
+
+  ezStartup::StartupHighLevelSystems();
+
+  {
+    ezView* pView = nullptr;
+    ezViewHandle hView = ezRenderWorld::CreateView("RenderDataCacheTest", pView);
+
+    // both objects share the instance index, the second one reuses the slot of the first one after it has been deleted
+    const ezGameObjectHandle hObjectA(ezGameObjectId(5, 1));
+    const ezComponentHandle hComponentA(ezComponentId(3, 1));
+    const ezGameObjectHandle hObjectB(ezGameObjectId(5, 2));
+    const ezComponentHandle hComponentB(ezComponentId(3, 2));
+
+    ezRenderDataCacheTestRenderData renderData;
+
+    ezRenderWorld::BeginFrame();
+    pDevice->BeginFrame();
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Cache Hit")
+    {
+      EZ_TEST_INT(GetCachedRenderDataId(*pView, hObjectA), 0);
+
+      CacheRenderData(*pView, category, hObjectA, hComponentA, &renderData);
+      NextFrame(pDevice);
+
+      EZ_TEST_BOOL(GetCachedRenderDataId(*pView, hObjectA) != 0);
+
+      // a recycled handle must not see the data of the previous object in the slot
+      EZ_TEST_INT(GetCachedRenderDataId(*pView, hObjectB), 0);
+    }
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Slot Reuse")
+    {
+      ezRenderWorld::DeleteCachedRenderData(hObjectA, hComponentA);
+      NextFrame(pDevice);
+
+      CacheRenderData(*pView, category, hObjectB, hComponentB, &renderData);
+      NextFrame(pDevice);
+
+      EZ_TEST_BOOL(GetCachedRenderDataId(*pView, hObjectB) != 0);
+      EZ_TEST_INT(GetCachedRenderDataId(*pView, hObjectA), 0);
+    }
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Generation Invalidation")
+    {
+      const ezUInt32 uiCacheId = GetCachedRenderDataId(*pView, hObjectB);
+      EZ_TEST_BOOL(uiCacheId != 0);
+
+      // the entry is stale right away, not only after the invalidation has been applied in the next BeginFrame
+      ezRenderWorld::DeleteCachedRenderData(hObjectB, hComponentB);
+      EZ_TEST_INT(GetCachedRenderDataId(*pView, hObjectB), 0);
+
+      // caching again before the invalidation has been applied has to replace the outdated render data
+      CacheRenderData(*pView, category, hObjectB, hComponentB, &renderData);
+      NextFrame(pDevice);
+
+      const ezUInt32 uiNewCacheId = GetCachedRenderDataId(*pView, hObjectB);
+      EZ_TEST_BOOL(uiNewCacheId != 0);
+      EZ_TEST_BOOL(uiNewCacheId != uiCacheId);
+
+      // data extracted before an invalidation is dropped when the cache is updated
+      CacheRenderData(*pView, category, hObjectA, hComponentA, &renderData);
+      ezRenderWorld::DeleteCachedRenderData(hObjectB, hComponentB);
+      NextFrame(pDevice);
+
+      EZ_TEST_INT(GetCachedRenderDataId(*pView, hObjectA), 0);
+      EZ_TEST_INT(GetCachedRenderDataId(*pView, hObjectB), 0);
+    }
+
+    ezRenderWorld::DeleteAllCachedRenderData();
+    ezRenderWorld::DeleteView(hView);
+
+    pDevice->EndFrame();
+    ezRenderWorld::EndFrame();
+  }
+
+  ezStartup::ShutdownHighLevelSystems();
+
+  pDevice->Shutdown();
+  EZ_DEFAULT_DELETE(pDevice);
+}
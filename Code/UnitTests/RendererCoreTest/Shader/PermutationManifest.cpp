@@ -0,0 +1,152 @@
+#include <RendererCoreTestPCH.h>
+
+#include <Foundation/Configuration/Startup.h>
+#include <Foundation/IO/FileSystem/FileReader.h>
+#include <Foundation/IO/FileSystem/FileSystem.h>
+#include <Foundation/IO/FileSystem/FileWriter.h>
+#include <RendererCore/Shader/ShaderResource.h>
+#include <RendererCore/ShaderCompiler/ShaderManager.h>
+#include <RendererNull/Device/DeviceNull.h>
+
+namespace PermutationManifestTestDetail
+{
+  static ezResult WriteTextFile(const char* szFile, const char* szContent)
+  {
+    ezFileWriter file;
+    if (file.Open(szFile).Failed())
+      return EZ_FAILURE;
+
+    return file.WriteBytes(szContent, ezStringUtils::GetStringElementCount(szContent));
+  }
+
+  static void ReadTextFile(const char* szFile, ezStringBuilder& out_sContent)
+  {
+    out_sContent.Clear();
+
+    ezFileReader file;
+    EZ_TEST_BOOL(file.Open(szFile).Succeeded());
+    out_sContent.ReadAll(file);
+  }
+
+  static void SetVar(ezHashTable<ezHashedString, ezHashedString>& permVars, const char* szName, const char* szValue)
+  {
+    ezHashedString sName, sValue;
+    sName.Assign(szName);
+    sValue.Assign(szValue);
+
+    permVars.Insert(sName, sValue);
+  }
+} // namespace PermutationManifestTestDetail
+
+EZ_CREATE_SIMPLE_TEST(Shader, PermutationManifest)
+{
+  using namespace PermutationManifestTestDetail;
+
+  ezGALDeviceCreationDescription deviceDesc;
+  deviceDesc.m_bCreatePrimarySwapChain = false;
+
+  ezGALDeviceNull* pDevice = EZ_DEFAULT_NEW(ezGALDeviceNull, deviceDesc);
+  EZ_TEST_BOOL(pDevice->Init().Succeeded());
+  ezGALDevice::SetDefaultDevice(pDevice);
+
+  ezStartup::StartupHighLevelSystems();
+
+  ezStringBuilder sOutputPath = ezTestFramework::GetInstance()->GetAbsOutputPath();
+  EZ_TEST_BOOL(ezFileSystem::AddDataDirectory(sOutputPath.GetData(), "PermutationManifestTest", "output", ezFileSystem::AllowWrites).Succeeded());
+
+  // the permutations are never compiled, only the requested variables are of interest
+  ezShaderManager::Configure("DX11_SM50", false, ":output/PermutationManifestTest/ShaderCache", "PermutationManifestTest/PermutationVars");
+
+  EZ_TEST_BOOL(WriteTextFile(":output/PermutationManifestTest/PermutationVars/RENDER_PASS.ezPermVar",
+                 "enum RENDER_PASS\n{\n  RENDER_PASS_FORWARD,\n  RENDER_PASS_DEPTH_ONLY\n};\n")
+                 .Succeeded());
+  EZ_TEST_BOOL(WriteTextFile(":output/PermutationManifestTest/PermutationVars/BLEND_MODE.ezPermVar",
+                 "enum BLEND_MODE\n{\n  BLEND_MODE_OPAQUE,\n  BLEND_MODE_MASKED\n};\n")
+                 .Succeeded());
+  EZ_TEST_BOOL(WriteTextFile(":output/PermutationManifestTest/PermutationVars/CAMERA_MODE.ezPermVar",
+                 "enum CAMERA_MODE\n{\n  CAMERA_MODE_PERSPECTIVE,\n  CAMERA_MODE_ORTHO\n};\n")
+                 .Succeeded());
+  EZ_TEST_BOOL(
+    WriteTextFile(":output/PermutationManifestTest/PermutationVars/PERMUTATION_TEST_DETAIL.ezPermVar", "bool PERMUTATION_TEST_DETAIL;\n")
+      .Succeeded());
+  EZ_TEST_BOOL(WriteTextFile(":output/PermutationManifestTest/Test.ezShader",
+                 "[PLATFORMS]\nALL\n\n[PERMUTATIONS]\n\nRENDER_PASS\nBLEND_MODE\nCAMERA_MODE\nPERMUTATION_TEST_DETAIL\n")
+                 .Succeeded());
+
+  {
+    ezShaderResourceHandle hShader = ezResourceManager::LoadResource<ezShaderResource>("PermutationManifestTest/Test.ezShader");
+    {
+      ezResourceLock<ezShaderResource> pShader(hShader, ezResourceAcquireMode::BlockTillLoaded);
+      EZ_TEST_BOOL(pShader->IsShaderValid());
+    }
+
+    ezHashTable<ezHashedString, ezHashedString> materialVars;
+    SetVar(materialVars, "BLEND_MODE", "BLEND_MODE_MASKED");
+    SetVar(materialVars, "PERMUTATION_TEST_DETAIL", "TRUE");
+
+    ezHashTable<ezHashedString, ezHashedString> permVars = materialVars;
+    SetVar(permVars, "RENDER_PASS", "RENDER_PASS_DEPTH_ONLY");
+    SetVar(permVars, "CAMERA_MODE", "CAMERA_MODE_ORTHO");
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Fallback Permutation")
+    {
+      ezShaderPermutationResourceHandle hRequested = ezShaderManager::PreloadSinglePermutation(hShader, permVars, false);
+      ezShaderPermutationResourceHandle hFallback = ezShaderManager::PreloadFallbackPermutation(hShader, permVars, materialVars);
+
+      // only the material variable without render state falls back to its default value
+      ezHashTable<ezHashedString, ezHashedString> expectedVars;
+      SetVar(expectedVars, "RENDER_PASS", "RENDER_PASS_DEPTH_ONLY");
+      SetVar(expectedVars, "CAMERA_MODE", "CAMERA_MODE_ORTHO");
+      SetVar(expectedVars, "BLEND_MODE", "BLEND_MODE_MASKED");
+      SetVar(expectedVars, "PERMUTATION_TEST_DETAIL", "FALSE");
+
+      EZ_TEST_BOOL(hRequested.IsValid());
+      EZ_TEST_BOOL(hFallback.IsValid());
+      EZ_TEST_BOOL(hFallback != hRequested);
+      EZ_TEST_BOOL(hFallback == ezShaderManager::PreloadSinglePermutation(hShader, expectedVars, false));
+
+      // without material variables there is nothing to fall back to
+      ezHashTable<ezHashedString, ezHashedString> noMaterialVars;
+      EZ_TEST_BOOL(ezShaderManager::PreloadFallbackPermutation(hShader, permVars, noMaterialVars) == hRequested);
+    }
+
+    EZ_TEST_BLOCK(ezTestBlock::Enabled, "Manifest Round Trip")
+    {
+      ezShaderManager::StartPermutationRecording();
+      ezShaderManager::PreloadSinglePermutation(hShader, permVars, false);
+      ezShaderManager::PreloadFallbackPermutation(hShader, permVars, materialVars);
+      ezShaderManager::StopPermutationRecording();
+
+      EZ_TEST_BOOL(ezShaderManager::SavePermutationManifest(":output/PermutationManifestTest/Recorded.ezPermutationManifest").Succeeded());
+
+      // warm-up records the permutations it preloads, so saving again has to produce the same manifest
+      ezShaderManager::StartPermutationRecording();
+      EZ_TEST_INT(ezShaderManager::PreloadPermutationManifest(":output/PermutationManifestTest/Recorded.ezPermutationManifest"), 2);
+      ezShaderManager::StopPermutationRecording();
+
+      EZ_TEST_BOOL(ezShaderManager::SavePermutationManifest(":output/PermutationManifestTest/WarmUp.ezPermutationManifest").Succeeded());
+      EZ_TEST_INT(ezShaderManager::PreloadPermutationManifest(":output/PermutationManifestTest/WarmUp.ezPermutationManifest"), 2);
+
+      ezStringBuilder sRecorded, sWarmUp;
+      ReadTextFile(":output/PermutationManifestTest/Recorded.ezPermutationManifest", sRecorded);
+      ReadTextFile(":output/PermutationManifestTest/WarmUp.ezPermutationManifest", sWarmUp);
+
+      EZ_TEST_INT(sWarmUp.GetElementCount(), sRecorded.GetElementCount());
+      EZ_TEST_BOOL(sWarmUp.FindSubString("PermutationManifestTest/Test.ezShader") != nullptr);
+      EZ_TEST_BOOL(sWarmUp.FindSubString("RENDER_PASS_DEPTH_ONLY") != nullptr);
+      EZ_TEST_BOOL(sWarmUp.FindSubString("CAMERA_MODE_ORTHO") != nullptr);
+      EZ_TEST_BOOL(sWarmUp.FindSubString("BLEND_MODE_MASKED") != nullptr);
+      EZ_TEST_BOOL(sWarmUp.FindSubString("\"TRUE\"") != nullptr);
+      EZ_TEST_BOOL(sWarmUp.FindSubString("\"FALSE\"") != nullptr);
+    }
+  }
+
+  ezResourceManager::FreeAllUnusedResources();
+
+  ezFileSystem::RemoveDataDirectoryGroup("PermutationManifestTest");
+
+  ezStartup::ShutdownHighLevelSystems();
+
+  pDevice->Shutdown();
+  EZ_DEFAULT_DELETE(pDevice);
+}
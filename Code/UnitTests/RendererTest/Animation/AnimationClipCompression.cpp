@@ -0,0 +1,254 @@
+#include <RendererTestPCH.h>
+
+#include <Foundation/IO/MemoryStream.h>
+#include <Foundation/SimdMath/SimdConversion.h>
+#include <Foundation/Time/Stopwatch.h>
+#include <RendererCore/AnimationSystem/AnimationClipResource.h>
+#include <TestFramework/Utilities/TestLogInterface.h>
+
+namespace AnimationClipCompressionTestDetail
+{
+  static const ezUInt16 s_uiNumJoints = 64;
+  static const ezUInt16 s_uiNumFrames = 300;
+
+  /// Creates a clip with a mix of constant, linear and curved tracks, similar to what a typical character animation looks like.
+  static void CreateTestClip(ezAnimationClipResourceDescriptor& anim)
+  {
+    anim.Configure(s_uiNumJoints, s_uiNumFrames, 30, false);
+
+    for (ezUInt16 uiJoint = 0; uiJoint < s_uiNumJoints; ++uiJoint)
+    {
+      ezStringBuilder sName;
+      sName.Format("Joint{0}", uiJoint);
+
+      ezHashedString hs;
+      hs.Assign(sName.GetData());
+      anim.AddJointName(hs);
+
+      ezArrayPtr<ezTransform> keyframes = anim.GetJointKeyframes(uiJoint);
+
+      const ezVec3 vAxis = ezVec3(1.0f, (float)(uiJoint % 3), (float)(uiJoint % 5)).GetNormalized();
+      const ezVec3 vBindPosition(0.1f * uiJoint, 0.2f, -0.05f * (uiJoint % 7));
+
+      for (ezUInt16 uiFrame = 0; uiFrame < s_uiNumFrames; ++uiFrame)
+      {
+        const float t = (float)uiFrame / (s_uiNumFrames - 1);
+
+        ezTransform& key = keyframes[uiFrame];
+        key.m_qRotation.SetFromAxisAndAngle(vAxis, ezAngle::Degree(90.0f * ezMath::Sin(ezAngle::Radian(t * 6.0f + uiJoint))));
+        key.m_vScale.Set(1.0f);
+
+        // only the first few joints move, all others only rotate
+        if (uiJoint < 4)
+          key.m_vPosition = vBindPosition + ezVec3(t * 3.0f, 0.5f * ezMath::Sin(ezAngle::Radian(t * 10.0f)), 0);
+        else
+          key.m_vPosition = vBindPosition;
+      }
+    }
+  }
+
+  /// The uncompressed keyframes are stored joint by joint in one array.
+  static ezArrayPtr<const ezTransform> GetAllKeyframes(const ezAnimationClipResourceDescriptor& anim)
+  {
+    return ezArrayPtr<const ezTransform>(anim.GetJointKeyframes(0).GetPtr(), s_uiNumJoints * s_uiNumFrames);
+  }
+
+  static ezTransform LerpTransforms(const ezTransform& t0, const ezTransform& t1, float fLerp)
+  {
+    ezTransform res;
+    res.m_vPosition = ezMath::Lerp(t0.m_vPosition, t1.m_vPosition, fLerp);
+    res.m_qRotation.SetSlerp(t0.m_qRotation, t1.m_qRotation, fLerp);
+    res.m_vScale = ezMath::Lerp(t0.m_vScale, t1.m_vScale, fLerp);
+    return res;
+  }
+
+  static float GetRotationError(const ezQuat& q0, const ezQuat& q1)
+  {
+    const float fDot = ezMath::Min(ezMath::Abs(q0.v.Dot(q1.v) + q0.w * q1.w), 1.0f);
+    return 2.0f * ezMath::ACos(fDot).GetRadian();
+  }
+} // namespace AnimationClipCompressionTestDetail
+
+#if EZ_ENABLED(EZ_COMPILE_FOR_DEBUG)
+static const ezTestBlock::Enum EnableInRelease = ezTestBlock::DisabledNoWarning;
+#else
+static const ezTestBlock::Enum EnableInRelease = ezTestBlock::Enabled;
+#endif
+
+EZ_CREATE_SIMPLE_TEST(Animation, AnimationClipCompression)
+{
+  using namespace AnimationClipCompressionTestDetail;
+
+  ezAnimationClipResourceDescriptor source;
+  CreateTestClip(source);
+
+  const ezAnimationClipCompressionSettings settings;
+
+  // the sampler interpolates between the quantized keys, allow for a little quantization error on top of the tolerances
+  const float fPositionTolerance = settings.m_fMaxPositionError + 0.0005f;
+  const float fRotationTolerance = settings.m_fMaxRotationError + 0.0005f;
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Compress")
+  {
+    ezAnimationClipResourceDescriptor anim = source;
+    EZ_TEST_BOOL(!anim.IsCompressed());
+
+    const ezUInt64 uiUncompressedSize = anim.GetHeapMemoryUsage();
+
+    anim.Compress(settings);
+
+    EZ_TEST_BOOL(anim.IsCompressed());
+    EZ_TEST_INT(anim.GetNumFrames(), s_uiNumFrames);
+    EZ_TEST_BOOL(anim.GetHeapMemoryUsage() * 4 < uiUncompressedSize);
+
+    float fMaxPosError = 0.0f;
+    float fMaxRotError = 0.0f;
+    float fMaxScaleError = 0.0f;
+
+    for (ezUInt16 uiJoint = 0; uiJoint < s_uiNumJoints; ++uiJoint)
+    {
+      ezArrayPtr<const ezTransform> keyframes = source.GetJointKeyframes(uiJoint);
+
+      for (ezUInt16 uiFrame = 0; uiFrame < s_uiNumFrames; ++uiFrame)
+      {
+        const ezTransform res = anim.GetJointKeyframe(uiJoint, uiFrame);
+
+        fMaxPosError = ezMath::Max(fMaxPosError, (res.m_vPosition - keyframes[uiFrame].m_vPosition).GetLength());
+        fMaxRotError = ezMath::Max(fMaxRotError, GetRotationError(res.m_qRotation, keyframes[uiFrame].m_qRotation));
+        fMaxScaleError = ezMath::Max(fMaxScaleError, (res.m_vScale - keyframes[uiFrame].m_vScale).GetLength());
+      }
+    }
+
+    EZ_TEST_BOOL(fMaxPosError <= fPositionTolerance);
+    EZ_TEST_BOOL(fMaxRotError <= fRotationTolerance);
+    EZ_TEST_BOOL(fMaxScaleError <= settings.m_fMaxScaleError);
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Sample between keyframes")
+  {
+    ezCompressedAnimationClip clip;
+    clip.Compress(s_uiNumFrames, GetAllKeyframes(source), settings);
+
+    EZ_TEST_INT(clip.GetNumJoints(), s_uiNumJoints);
+    EZ_TEST_BOOL(clip.GetNumKeys() < (ezUInt32)s_uiNumJoints * s_uiNumFrames * 3);
+
+    for (ezUInt16 uiJoint = 0; uiJoint < s_uiNumJoints; uiJoint += 7)
+    {
+      ezArrayPtr<const ezTransform> keyframes = source.GetJointKeyframes(uiJoint);
+
+      for (ezUInt16 uiFrame = 0; uiFrame + 1 < s_uiNumFrames; uiFrame += 13)
+      {
+        const ezTransform expected = LerpTransforms(keyframes[uiFrame], keyframes[uiFrame + 1], 0.3f);
+        const ezTransform res = ezSimdConversion::ToTransform(clip.SampleJoint(uiJoint, uiFrame, 0.3f));
+
+        EZ_TEST_VEC3(res.m_vPosition, expected.m_vPosition, fPositionTolerance);
+        EZ_TEST_BOOL(GetRotationError(res.m_qRotation, expected.m_qRotation) <= fRotationTolerance);
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Save / Load")
+  {
+    ezAnimationClipResourceDescriptor anim = source;
+    anim.Compress(settings);
+
+    ezMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    ezMemoryStreamReader reader(&storage);
+
+    anim.Save(writer);
+
+    ezAnimationClipResourceDescriptor loaded;
+    EZ_TEST_BOOL(loaded.Load(reader).Succeeded());
+
+    EZ_TEST_BOOL(loaded.IsCompressed());
+    EZ_TEST_INT(loaded.GetNumFrames(), anim.GetNumFrames());
+    EZ_TEST_INT(loaded.GetHeapMemoryUsage(), anim.GetHeapMemoryUsage());
+
+    for (ezUInt16 uiJoint = 0; uiJoint < s_uiNumJoints; uiJoint += 5)
+    {
+      for (ezUInt16 uiFrame = 0; uiFrame < s_uiNumFrames; uiFrame += 11)
+      {
+        const ezTransform t0 = anim.GetJointKeyframe(uiJoint, uiFrame);
+        const ezTransform t1 = loaded.GetJointKeyframe(uiJoint, uiFrame);
+
+        EZ_TEST_BOOL(t0.IsEqual(t1, 0.0f));
+      }
+    }
+  }
+
+  EZ_TEST_BLOCK(ezTestBlock::Enabled, "Load unknown version")
+  {
+    ezCompressedAnimationClip clip;
+    clip.Compress(s_uiNumFrames, GetAllKeyframes(source), settings);
+
+    ezMemoryStreamStorage storage;
+    ezMemoryStreamWriter writer(&storage);
+    ezMemoryStreamReader reader(&storage);
+
+    // data written by a newer version
+    const ezUInt8 uiVersion = 2;
+    writer << uiVersion;
+
+    ezTestLogInterface log;
+    ezTestLogSystemScope logSystemScope(&log);
+    log.ExpectMessage("Invalid compressed animation clip version 2", ezLogMsgType::ErrorMsg);
+
+    EZ_TEST_BOOL(clip.Load(reader).Failed());
+    EZ_TEST_BOOL(clip.IsEmpty());
+  }
+
+  EZ_TEST_BLOCK(EnableInRelease, "Memory and sampling performance")
+  {
+    const ezUInt64 uiUncompressedSize = source.GetHeapMemoryUsage();
+
+    ezCompressedAnimationClip clip;
+    clip.Compress(s_uiNumFrames, GetAllKeyframes(source), settings);
+
+    ezTestFramework::Output(ezTestOutput::Duration, "Clip memory: %u joints, %u frames: %llu bytes uncompressed, %llu bytes compressed (%u keys)",
+                            s_uiNumJoints, s_uiNumFrames, uiUncompressedSize, clip.GetHeapMemoryUsage(), clip.GetNumKeys());
+
+    const ezUInt32 uiNumSamples = 200;
+    const ezUInt32 uiNumJointSamples = uiNumSamples * s_uiNumJoints;
+
+    // accumulate the results, so that the compiler cannot optimize the sampling away
+    ezVec3 vSum(0.0f);
+
+    {
+      ezStopwatch sw;
+
+      for (ezUInt32 s = 0; s < uiNumSamples; ++s)
+      {
+        const ezUInt16 uiFrame = (ezUInt16)((s * 7) % (s_uiNumFrames - 1));
+
+        for (ezUInt16 uiJoint = 0; uiJoint < s_uiNumJoints; ++uiJoint)
+        {
+          ezArrayPtr<const ezTransform> keyframes = source.GetJointKeyframes(uiJoint);
+          vSum += LerpTransforms(keyframes[uiFrame], keyframes[uiFrame + 1], 0.5f).m_vPosition;
+        }
+      }
+
+      const ezTime tDiff = sw.Checkpoint();
+      ezTestFramework::Output(ezTestOutput::Duration, "Uncompressed sampling: %.2fns per joint", tDiff.GetNanoseconds() / uiNumJointSamples);
+    }
+
+    {
+      ezStopwatch sw;
+
+      for (ezUInt32 s = 0; s < uiNumSamples; ++s)
+      {
+        const ezUInt16 uiFrame = (ezUInt16)((s * 7) % (s_uiNumFrames - 1));
+
+        for (ezUInt16 uiJoint = 0; uiJoint < s_uiNumJoints; ++uiJoint)
+        {
+          vSum += ezSimdConversion::ToVec3(clip.SampleJoint(uiJoint, uiFrame, 0.5f).m_Position);
+        }
+      }
+
+      const ezTime tDiff = sw.Checkpoint();
+      ezTestFramework::Output(ezTestOutput::Duration, "Compressed sampling: %.2fns per joint", tDiff.GetNanoseconds() / uiNumJointSamples);
+    }
+
+    EZ_TEST_BOOL(vSum.IsValid());
+  }
+}